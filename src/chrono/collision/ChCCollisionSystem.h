@@ -15,6 +15,8 @@
 #ifndef CHC_COLLISIONSYSTEM_H
 #define CHC_COLLISIONSYSTEM_H
 
+#include <vector>
+
 #include "chrono/collision/ChCCollisionInfo.h"
 #include "chrono/core/ChFrame.h"
 #include "chrono/core/ChApiCE.h"
@@ -38,6 +40,7 @@ class ChApi ChCollisionSystem {
     ChCollisionSystem(unsigned int max_objects = 16000, double scene_size = 500) {
         narrow_callback = 0;
         broad_callback = 0;
+        broad_batch_callback = 0;
     };
 
     virtual ~ChCollisionSystem(){};
@@ -54,6 +57,15 @@ class ChApi ChCollisionSystem {
     /// engine (custom data may be deallocated).
     virtual void Remove(ChCollisionModel* model) = 0;
 
+    /// Start a batch of additions and removals of collision models. Until EndBatch()
+    /// is called, the collision engine may defer the removals, to process them at once.
+    /// The removed models must stay alive until EndBatch() returns.
+    /// By default, models are added and removed immediately.
+    virtual void BeginBatch() {}
+
+    /// Complete a batch of additions and removals started with BeginBatch().
+    virtual void EndBatch() {}
+
     /// Removes all collision models from the collision
     /// engine (custom data may be deallocated).
     // virtual void RemoveAll() = 0;
@@ -110,8 +122,34 @@ class ChApi ChCollisionSystem {
     /// Specify a callback object to be used each time a pair of 'near enough' collision shapes
     /// is found by the broad-phase collision step. The OnBroadphase() method of the provided
     /// callback object will be called for each pair of 'near enough' shapes.
+    /// The Bullet collision system invokes the callback before the narrow phase, so that no
+    /// contact generation work is done for the rejected pairs.
     void RegisterBroadphaseCallback(BroadphaseCallback* callback) { broad_callback = callback; }
 
+    /// Class to be used as a callback interface for user-defined filtering of all the 'near enough'
+    /// pairs of collision models found by the broad-phase collision step, processed in a single call.
+    /// The pairs are provided as arrays, so that application-level rules (e.g. based on identifiers
+    /// gathered from the models) can be evaluated in a tight loop.
+    class ChApi BroadphaseBatchCallback {
+      public:
+        virtual ~BroadphaseBatchCallback() {}
+
+        /// Callback used to filter the pairs (modelsA[i], modelsB[i]), i = 0..num_pairs-1, found by the
+        /// broad-phase collision algorithm. The flags in 'keep' are initially set to 1; set keep[i] to 0 to
+        /// skip narrow-phase contact generation for the i-th pair.
+        virtual void OnBroadphase(int num_pairs,                     ///< number of pairs
+                                  ChCollisionModel* const* modelsA,  ///< 1st model of each pair
+                                  ChCollisionModel* const* modelsB,  ///< 2nd model of each pair
+                                  char* keep                         ///< filter flags
+                                  ) = 0;
+    };
+
+    /// Specify a callback object to be used to filter all the pairs found by the broad-phase collision
+    /// step, before the narrow phase. If a BroadphaseCallback is also registered, it is invoked only for
+    /// the pairs accepted by the batch callback.
+    /// Currently supported only by the Bullet collision system (ChCollisionSystemBullet).
+    void RegisterBroadphaseBatchCallback(BroadphaseBatchCallback* callback) { broad_batch_callback = callback; }
+
     /// Class to be used as a callback interface for user-defined actions to be performed
     /// at each collision pair found during the narrow-phase collision step.
     /// It can be used to override the geometric information.
@@ -143,6 +181,23 @@ class ChApi ChCollisionSystem {
     /// Perform a ray-hit test with the specified collision model.
     virtual bool RayHit(const ChVector<>& from, const ChVector<>& to, ChCollisionModel* model, ChRayhitResult& mresult) const = 0;
 
+    /// Perform a batch of ray-hit tests with the collision models.
+    /// The i-th ray goes from 'from[i]' to 'to[i]' and its result is returned in 'results[i]'.
+    /// The default implementation performs the tests sequentially; derived classes may process the rays
+    /// concurrently, using up to 'nthreads' threads. Returns the number of rays that hit a collision model.
+    virtual int RayHitBatch(const std::vector<ChVector<>>& from,
+                            const std::vector<ChVector<>>& to,
+                            std::vector<ChRayhitResult>& results,
+                            int nthreads = 1) const {
+        results.resize(from.size());
+        int nhits = 0;
+        for (size_t i = 0; i < from.size(); ++i) {
+            if (RayHit(from[i], to[i], results[i]))
+                nhits++;
+        }
+        return nhits;
+    }
+
     // SERIALIZATION
 
     virtual void ArchiveOUT(ChArchiveOut& marchive) {
@@ -155,8 +210,9 @@ class ChApi ChCollisionSystem {
     }
 
   protected:
-    BroadphaseCallback* broad_callback;    ///< user callback for each near-enough pair of shapes
-    NarrowphaseCallback* narrow_callback;  ///< user callback for each collision pair
+    BroadphaseCallback* broad_callback;             ///< user callback for each near-enough pair of shapes
+    BroadphaseBatchCallback* broad_batch_callback;  ///< user callback for all near-enough pairs of shapes
+    NarrowphaseCallback* narrow_callback;           ///< user callback for each collision pair
 };
 
 }  // end namespace collision
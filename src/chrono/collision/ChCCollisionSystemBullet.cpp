@@ -12,6 +12,8 @@
 // Authors: Alessandro Tasora
 // =============================================================================
 
+#include <algorithm>
+
 #include "chrono/collision/ChCCollisionSystemBullet.h"
 #include "chrono/collision/ChCModelBullet.h"
 #include "chrono/collision/gimpact/GIMPACT/Bullet/btGImpactCollisionAlgorithm.h"
@@ -20,11 +22,13 @@
 #include "chrono/physics/ChContactContainer.h"
 #include "chrono/physics/ChProximityContainer.h"
 #include "chrono/collision/bullet/LinearMath/btPoolAllocator.h"
+#include "chrono/collision/bullet/BulletCollision/CollisionShapes/btCompoundShape.h"
 #include "chrono/collision/bullet/BulletCollision/CollisionShapes/btSphereShape.h"
 #include "chrono/collision/bullet/BulletCollision/CollisionShapes/btCylinderShape.h"
 #include "chrono/collision/bullet/BulletCollision/CollisionShapes/bt2DShape.h"
 #include "chrono/collision/bullet/BulletCollision/CollisionShapes/btCEtriangleShape.h"
 #include "chrono/collision/bullet/BulletCollision/CollisionDispatch/btEmptyCollisionAlgorithm.h"
+#include "chrono/utils/ChProfiler.h"
 
 extern btScalar gContactBreakingThreshold;
 
@@ -1167,11 +1171,46 @@ private:
 ////////////////////////////////////
 
 
-ChCollisionSystemBullet::ChCollisionSystemBullet(unsigned int max_objects, double scene_size) {
+// Collision dispatcher which skips the narrow phase for the overlapping pairs
+// rejected by the user broadphase callbacks (see FilterBroadphasePairs).
+// If a rejected pair has a collision algorithm from a previous step, the algorithm
+// and its contact manifolds are deleted, so that no contacts are reported for it.
+class ChCollisionDispatcherBullet : public btCollisionDispatcher {
+  public:
+    ChCollisionDispatcherBullet(btCollisionConfiguration* configuration)
+        : btCollisionDispatcher(configuration), filter_pairs(nullptr), filter_keep(nullptr), filter_num_pairs(0) {
+        setNearCallback(FilteredNearCallback);
+    }
+
+    static void FilteredNearCallback(btBroadphasePair& pair,
+                                     btCollisionDispatcher& dispatcher,
+                                     const btDispatcherInfo& dispatchInfo) {
+        ChCollisionDispatcherBullet& mdispatcher = static_cast<ChCollisionDispatcherBullet&>(dispatcher);
+        if (mdispatcher.filter_pairs) {
+            // The pairs are processed in place, in the overlapping pair array
+            ptrdiff_t index = &pair - mdispatcher.filter_pairs;
+            if (index >= 0 && index < mdispatcher.filter_num_pairs && !mdispatcher.filter_keep[index]) {
+                if (pair.m_algorithm) {
+                    pair.m_algorithm->~btCollisionAlgorithm();
+                    dispatcher.freeCollisionAlgorithm(pair.m_algorithm);
+                    pair.m_algorithm = 0;
+                }
+                return;
+            }
+        }
+        defaultNearCallback(pair, dispatcher, dispatchInfo);
+    }
+
+    const btBroadphasePair* filter_pairs;  ///< overlapping pair array (nullptr if no filtering)
+    const char* filter_keep;               ///< filter results, for each overlapping pair
+    int filter_num_pairs;                  ///< number of overlapping pairs
+};
+
+ChCollisionSystemBullet::ChCollisionSystemBullet(unsigned int max_objects, double scene_size) : in_batch(false) {
     // btDefaultCollisionConstructionInfo conf_info(...); ***TODO***
     bt_collision_configuration = new btDefaultCollisionConfiguration();
 
-    bt_dispatcher = new btCollisionDispatcher(bt_collision_configuration);
+    bt_dispatcher = new ChCollisionDispatcherBullet(bt_collision_configuration);
     //((btDefaultCollisionConfiguration*)bt_collision_configuration)->setConvexConvexMultipointIterations(4,4);
 
     //***OLD***
@@ -1246,6 +1285,9 @@ void ChCollisionSystemBullet::Clear(void) {
 }
 
 void ChCollisionSystemBullet::Add(ChCollisionModel* model) {
+    // The model may be among the deferred removals (removed and added again)
+    FlushRemovals();
+
     if (((ChModelBullet*)model)->GetBulletModel()->getCollisionShape()) {
         model->SyncPosition();
         bt_collision_world->addCollisionObject(((ChModelBullet*)model)->GetBulletModel(),
@@ -1256,14 +1298,93 @@ void ChCollisionSystemBullet::Add(ChCollisionModel* model) {
 
 void ChCollisionSystemBullet::Remove(ChCollisionModel* model) {
     if (((ChModelBullet*)model)->GetBulletModel()->getCollisionShape()) {
-        bt_collision_world->removeCollisionObject(((ChModelBullet*)model)->GetBulletModel());
+        if (in_batch)
+            removal_batch.push_back(((ChModelBullet*)model)->GetBulletModel());
+        else
+            bt_collision_world->removeCollisionObject(((ChModelBullet*)model)->GetBulletModel());
     }
 }
 
+void ChCollisionSystemBullet::BeginBatch() {
+    in_batch = true;
+}
+
+void ChCollisionSystemBullet::EndBatch() {
+    FlushRemovals();
+    in_batch = false;
+}
+
+// Removing objects one at a time costs a scan of all overlapping pairs (and of the object array) per object.
+// Here, all deferred objects are removed with a single scan.
+void ChCollisionSystemBullet::FlushRemovals() {
+    if (removal_batch.empty())
+        return;
+    bt_collision_world->removeCollisionObjects(removal_batch.data(), (int)removal_batch.size());
+    removal_batch.clear();
+}
+
 void ChCollisionSystemBullet::Run() {
-    if (bt_collision_world) {
+    if (!bt_collision_world)
+        return;
+
+    FlushRemovals();
+
+    // Without user broadphase callbacks, let Bullet perform both broad phase and narrow phase.
+    if (!broad_callback && !broad_batch_callback) {
         bt_collision_world->performDiscreteCollisionDetection();
+        return;
     }
+
+    // Otherwise, filter the overlapping pairs before the narrow phase
+    // (same steps as in btCollisionWorld::performDiscreteCollisionDetection).
+    bt_collision_world->updateAabbs();
+    {
+        CH_PROFILE("Broad-phase");
+        bt_broadphase->calculateOverlappingPairs(bt_dispatcher);
+    }
+    {
+        CH_PROFILE("Pair filter");
+        FilterBroadphasePairs();
+    }
+    {
+        CH_PROFILE("Narrow-phase");
+        bt_dispatcher->dispatchAllCollisionPairs(bt_broadphase->getOverlappingPairCache(),
+                                                 bt_collision_world->getDispatchInfo(), bt_dispatcher);
+    }
+
+    static_cast<ChCollisionDispatcherBullet*>(bt_dispatcher)->filter_pairs = nullptr;
+}
+
+void ChCollisionSystemBullet::FilterBroadphasePairs() {
+    btOverlappingPairCache* pair_cache = bt_broadphase->getOverlappingPairCache();
+    int num_pairs = pair_cache->getNumOverlappingPairs();
+    btBroadphasePair* pairs = pair_cache->getOverlappingPairArrayPtr();
+
+    filter_modelsA.resize(num_pairs);
+    filter_modelsB.resize(num_pairs);
+    filter_keep.assign(num_pairs, 1);
+
+    for (int i = 0; i < num_pairs; i++) {
+        btCollisionObject* obA = static_cast<btCollisionObject*>(pairs[i].m_pProxy0->m_clientObject);
+        btCollisionObject* obB = static_cast<btCollisionObject*>(pairs[i].m_pProxy1->m_clientObject);
+        filter_modelsA[i] = (ChCollisionModel*)obA->getUserPointer();
+        filter_modelsB[i] = (ChCollisionModel*)obB->getUserPointer();
+    }
+
+    if (broad_batch_callback && num_pairs > 0)
+        broad_batch_callback->OnBroadphase(num_pairs, filter_modelsA.data(), filter_modelsB.data(), filter_keep.data());
+
+    if (broad_callback) {
+        for (int i = 0; i < num_pairs; i++) {
+            if (filter_keep[i])
+                filter_keep[i] = broad_callback->OnBroadphase(filter_modelsA[i], filter_modelsB[i]);
+        }
+    }
+
+    ChCollisionDispatcherBullet* dispatcher = static_cast<ChCollisionDispatcherBullet*>(bt_dispatcher);
+    dispatcher->filter_pairs = pairs;
+    dispatcher->filter_keep = filter_keep.data();
+    dispatcher->filter_num_pairs = num_pairs;
 }
 
 void ChCollisionSystemBullet::ReportContacts(ChContactContainer* mcontactcontainer) {
@@ -1288,44 +1409,38 @@ void ChCollisionSystemBullet::ReportContacts(ChContactContainer* mcontactcontain
         double marginA = icontact.modelA->GetSafeMargin();
         double marginB = icontact.modelB->GetSafeMargin();
 
-        // Execute custom broadphase callback, if any
-        bool do_narrow_contactgeneration = true;
-        if (this->broad_callback)
-            do_narrow_contactgeneration = this->broad_callback->OnBroadphase(icontact.modelA, icontact.modelB);
+        // The custom broadphase callbacks, if any, were executed in Run(), before the narrow phase.
+        int numContacts = contactManifold->getNumContacts();
+        //GetLog() << "numContacts=" << numContacts << "\n";
+        for (int j = 0; j < numContacts; j++) {
+            btManifoldPoint& pt = contactManifold->getContactPoint(j);
 
-        if (do_narrow_contactgeneration) {
-            int numContacts = contactManifold->getNumContacts();
-            //GetLog() << "numContacts=" << numContacts << "\n";
-            for (int j = 0; j < numContacts; j++) {
-                btManifoldPoint& pt = contactManifold->getContactPoint(j);
+            // Discard "too far" constraints (the Bullet engine also has its threshold)
+            if (pt.getDistance() < marginA + marginB) {
+                btVector3 ptA = pt.getPositionWorldOnA();
+                btVector3 ptB = pt.getPositionWorldOnB();
 
-                // Discard "too far" constraints (the Bullet engine also has its threshold)
-                if (pt.getDistance() < marginA + marginB) {
-                    btVector3 ptA = pt.getPositionWorldOnA();
-                    btVector3 ptB = pt.getPositionWorldOnB();
+                icontact.vpA.Set(ptA.getX(), ptA.getY(), ptA.getZ());
+                icontact.vpB.Set(ptB.getX(), ptB.getY(), ptB.getZ());
 
-                    icontact.vpA.Set(ptA.getX(), ptA.getY(), ptA.getZ());
-                    icontact.vpB.Set(ptB.getX(), ptB.getY(), ptB.getZ());
+                icontact.vN.Set(-pt.m_normalWorldOnB.getX(), -pt.m_normalWorldOnB.getY(),
+                                -pt.m_normalWorldOnB.getZ());
+                icontact.vN.Normalize();
 
-                    icontact.vN.Set(-pt.m_normalWorldOnB.getX(), -pt.m_normalWorldOnB.getY(),
-                                    -pt.m_normalWorldOnB.getZ());
-                    icontact.vN.Normalize();
+                double ptdist = pt.getDistance();
 
-                    double ptdist = pt.getDistance();
+                icontact.vpA = icontact.vpA - icontact.vN * envelopeA;
+                icontact.vpB = icontact.vpB + icontact.vN * envelopeB;
+                icontact.distance = ptdist + envelopeA + envelopeB;
 
-                    icontact.vpA = icontact.vpA - icontact.vN * envelopeA;
-                    icontact.vpB = icontact.vpB + icontact.vN * envelopeB;
-                    icontact.distance = ptdist + envelopeA + envelopeB;
+                icontact.reaction_cache = pt.reactions_cache;
 
-                    icontact.reaction_cache = pt.reactions_cache;
+                // Execute some user custom callback, if any
+                if (this->narrow_callback)
+                    this->narrow_callback->OnNarrowphase(icontact);
 
-                    // Execute some user custom callback, if any
-                    if (this->narrow_callback)
-                        this->narrow_callback->OnNarrowphase(icontact);
-
-                    // Add to contact container
-                    mcontactcontainer->AddContact(icontact);
-                }
+                // Add to contact container
+                mcontactcontainer->AddContact(icontact);
             }
         }
 
@@ -1368,14 +1483,9 @@ void ChCollisionSystemBullet::ReportProximities(ChProximityContainer* mproximity
     mproximitycontainer->EndAddProximities();
 }
 
-bool ChCollisionSystemBullet::RayHit(const ChVector<>& from, const ChVector<>& to, ChRayhitResult& mresult) const {
-    btVector3 btfrom((btScalar)from.x(), (btScalar)from.y(), (btScalar)from.z());
-    btVector3 btto((btScalar)to.x(), (btScalar)to.y(), (btScalar)to.z());
-
-    btCollisionWorld::ClosestRayResultCallback rayCallback(btfrom, btto);
-
-    this->bt_collision_world->rayTest(btfrom, btto, rayCallback);
-
+// Set the ray-hit result from the closest hit found by a ray test.
+static bool GetRayHitResult(const btCollisionWorld::ClosestRayResultCallback& rayCallback,
+                            ChCollisionSystem::ChRayhitResult& mresult) {
     if (rayCallback.hasHit()) {
         mresult.hitModel = (ChCollisionModel*)(rayCallback.m_collisionObject->getUserPointer());
         if (mresult.hitModel) {
@@ -1385,7 +1495,6 @@ bool ChCollisionSystemBullet::RayHit(const ChVector<>& from, const ChVector<>& t
             mresult.abs_hitNormal.Set(rayCallback.m_hitNormalWorld.x(), rayCallback.m_hitNormalWorld.y(),
                                       rayCallback.m_hitNormalWorld.z());
             mresult.abs_hitNormal.Normalize();
-            mresult.hit = true;
             mresult.dist_factor = rayCallback.m_closestHitFraction;
             return true;
         }
@@ -1394,6 +1503,17 @@ bool ChCollisionSystemBullet::RayHit(const ChVector<>& from, const ChVector<>& t
     return false;
 }
 
+bool ChCollisionSystemBullet::RayHit(const ChVector<>& from, const ChVector<>& to, ChRayhitResult& mresult) const {
+    btVector3 btfrom((btScalar)from.x(), (btScalar)from.y(), (btScalar)from.z());
+    btVector3 btto((btScalar)to.x(), (btScalar)to.y(), (btScalar)to.z());
+
+    btCollisionWorld::ClosestRayResultCallback rayCallback(btfrom, btto);
+
+    this->bt_collision_world->rayTest(btfrom, btto, rayCallback);
+
+    return GetRayHitResult(rayCallback, mresult);
+}
+
 bool ChCollisionSystemBullet::RayHit(const ChVector<>& from,
                                      const ChVector<>& to,
                                      ChCollisionModel* model,
@@ -1433,6 +1553,107 @@ bool ChCollisionSystemBullet::RayHit(const ChVector<>& from,
     return true;
 }
 
+// Check whether concurrent ray tests are supported by the given collision shape.
+static bool IsRayTestThreadSafe(const btCollisionShape* shape) {
+    return shape->getShapeType() != GIMPACT_SHAPE_PROXYTYPE && !shape->isCompound();
+}
+
+// Closest-hit ray callback that skips the specified collision objects (sorted).
+class SkipRayResultCallback : public btCollisionWorld::ClosestRayResultCallback {
+  public:
+    SkipRayResultCallback(const btVector3& from, const btVector3& to, const std::vector<btCollisionObject*>& skip)
+        : btCollisionWorld::ClosestRayResultCallback(from, to), m_skip(skip) {}
+
+    virtual bool needsCollision(btBroadphaseProxy* proxy0) const override {
+        return btCollisionWorld::ClosestRayResultCallback::needsCollision(proxy0) &&
+               !std::binary_search(m_skip.begin(), m_skip.end(), (btCollisionObject*)proxy0->m_clientObject);
+    }
+
+  private:
+    const std::vector<btCollisionObject*>& m_skip;
+};
+
+int ChCollisionSystemBullet::RayHitBatch(const std::vector<ChVector<>>& from,
+                                         const std::vector<ChVector<>>& to,
+                                         std::vector<ChRayhitResult>& results,
+                                         int nthreads) const {
+    assert(from.size() == to.size());
+    int nrays = (int)from.size();
+    results.resize(nrays);
+
+    // Ray tests on GIMPACT shapes lock/unlock the mesh data, and those on compound shapes swap the shape
+    // of the collision object, so they cannot run concurrently.
+    std::vector<btCollisionObject*> unsafe;
+    if (nthreads > 1) {
+        const btCollisionObjectArray& objects = bt_collision_world->getCollisionObjectArray();
+        for (int j = 0; j < objects.size(); ++j) {
+            if (!IsRayTestThreadSafe(objects[j]->getCollisionShape()))
+                unsafe.push_back(objects[j]);
+        }
+        std::sort(unsafe.begin(), unsafe.end());
+    }
+
+    if (unsafe.empty()) {
+        int nhits = 0;
+#pragma omp parallel for num_threads(nthreads) schedule(dynamic, 256) reduction(+ : nhits) if (nthreads > 1)
+        for (int i = 0; i < nrays; ++i) {
+            if (RayHit(from[i], to[i], results[i]))
+                nhits++;
+        }
+        return nhits;
+    }
+
+    // Test all rays concurrently against the other objects, and flag the rays whose segment (up to the closest
+    // hit found) crosses the bounding box of an object that cannot be tested concurrently.
+    std::vector<char> retest(nrays, 0);
+#pragma omp parallel for num_threads(nthreads) schedule(dynamic, 256)
+    for (int i = 0; i < nrays; ++i) {
+        btVector3 btfrom((btScalar)from[i].x(), (btScalar)from[i].y(), (btScalar)from[i].z());
+        btVector3 btto((btScalar)to[i].x(), (btScalar)to[i].y(), (btScalar)to[i].z());
+        SkipRayResultCallback rayCallback(btfrom, btto, unsafe);
+        bt_collision_world->rayTest(btfrom, btto, rayCallback);
+        GetRayHitResult(rayCallback, results[i]);
+
+        for (auto object : unsafe) {
+            btScalar param = results[i].hit ? (btScalar)results[i].dist_factor : btScalar(1);
+            btVector3 normal;
+            const btBroadphaseProxy* proxy = object->getBroadphaseHandle();
+            if (btRayAabb(btfrom, btto, proxy->m_aabbMin, proxy->m_aabbMax, param, normal)) {
+                retest[i] = 1;
+                break;
+            }
+        }
+    }
+
+    // Test the flagged rays sequentially against the remaining objects, keeping the closest hit.
+    for (int i = 0; i < nrays; ++i) {
+        if (!retest[i])
+            continue;
+        btVector3 btfrom((btScalar)from[i].x(), (btScalar)from[i].y(), (btScalar)from[i].z());
+        btVector3 btto((btScalar)to[i].x(), (btScalar)to[i].y(), (btScalar)to[i].z());
+        btTransform rayFromTrans(btQuaternion::getIdentity(), btfrom);
+        btTransform rayToTrans(btQuaternion::getIdentity(), btto);
+        btCollisionWorld::ClosestRayResultCallback rayCallback(btfrom, btto);
+        if (results[i].hit)
+            rayCallback.m_closestHitFraction = (btScalar)results[i].dist_factor;
+        for (auto object : unsafe) {
+            if (rayCallback.needsCollision(object->getBroadphaseHandle()))
+                btCollisionWorld::rayTestSingle(rayFromTrans, rayToTrans, object, object->getCollisionShape(),
+                                                object->getWorldTransform(), rayCallback);
+        }
+        if (rayCallback.hasHit())
+            GetRayHitResult(rayCallback, results[i]);
+    }
+
+    int nhits = 0;
+    for (int i = 0; i < nrays; ++i) {
+        if (results[i].hit)
+            nhits++;
+    }
+
+    return nhits;
+}
+
 void ChCollisionSystemBullet::SetContactBreakingThreshold(double threshold) {
     gContactBreakingThreshold = (btScalar)threshold;
 }
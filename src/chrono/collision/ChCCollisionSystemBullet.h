@@ -15,6 +15,8 @@
 #ifndef CHC_COLLISIONSYSTEMBULLET_H
 #define CHC_COLLISIONSYSTEMBULLET_H
 
+#include <vector>
+
 #include "chrono/core/ChApiCE.h"
 #include "chrono/collision/ChCCollisionSystem.h"
 #include "chrono/collision/bullet/btBulletCollisionCommon.h"
@@ -46,6 +48,13 @@ class ChApi ChCollisionSystemBullet : public ChCollisionSystem {
     /// engine (custom data may be deallocated).
     virtual void Remove(ChCollisionModel* model);
 
+    /// Start a batch of additions and removals: the removals are deferred
+    /// until EndBatch() (or until the next addition), and processed at once.
+    virtual void BeginBatch() override;
+
+    /// Process the removals deferred since BeginBatch().
+    virtual void EndBatch() override;
+
     /// Removes all collision models from the collision
     /// engine (custom data may be deallocated).
     // virtual void RemoveAll();
@@ -81,6 +90,15 @@ class ChApi ChCollisionSystemBullet : public ChCollisionSystem {
                         ChCollisionModel* model,
                         ChRayhitResult& mresult) const override;
 
+    /// Perform a batch of ray-hit tests with all collision models, using up to 'nthreads' threads.
+    /// Bullet does not support concurrent ray tests on GIMPACT meshes (i.e. non-static concave triangle meshes)
+    /// and compound shapes (models with more than one shape, including connected triangle meshes). Such shapes
+    /// are tested sequentially, and only by the rays that cross their bounding box.
+    virtual int RayHitBatch(const std::vector<ChVector<>>& from,
+                            const std::vector<ChVector<>>& to,
+                            std::vector<ChRayhitResult>& results,
+                            int nthreads = 1) const override;
+
     // For Bullet related stuff
     btCollisionWorld* GetBulletCollisionWorld() { return bt_collision_world; }
 
@@ -90,10 +108,23 @@ class ChApi ChCollisionSystemBullet : public ChCollisionSystem {
     static void SetContactBreakingThreshold(double threshold);
 
   private:
+    /// Evaluate the user broadphase callbacks on all overlapping pairs, before the narrow phase.
+    void FilterBroadphasePairs();
+
+    /// Remove from the Bullet world all objects deferred during a batch.
+    void FlushRemovals();
+
     btCollisionConfiguration* bt_collision_configuration;
     btCollisionDispatcher* bt_dispatcher;
     btBroadphaseInterface* bt_broadphase;
     btCollisionWorld* bt_collision_world;
+
+    bool in_batch;                                  ///< removals are deferred
+    std::vector<btCollisionObject*> removal_batch;  ///< objects to remove at the end of the batch
+
+    std::vector<ChCollisionModel*> filter_modelsA;  ///< 1st model of each overlapping pair
+    std::vector<ChCollisionModel*> filter_modelsB;  ///< 2nd model of each overlapping pair
+    std::vector<char> filter_keep;                  ///< filter results for the overlapping pairs
 };
 
 }  // end namespace collision
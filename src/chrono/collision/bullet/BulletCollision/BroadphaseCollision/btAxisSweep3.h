@@ -629,7 +629,7 @@ void btAxisSweep3Internal<BP_FP_INT_TYPE>::resetPool(btDispatcher* dispatcher)
 }       
 
 
-extern int gOverlappingPairs;
+extern thread_local int gOverlappingPairs;
 //#include <stdio.h>
 
 template <typename BP_FP_INT_TYPE>
@@ -203,6 +203,69 @@ void							btDbvtBroadphase::destroyProxy(	btBroadphaseProxy* absproxy,
 	m_needcleanup=true;
 }
 
+//
+struct	btProxyPointerLess
+{
+	bool operator() (const btBroadphaseProxy* a,const btBroadphaseProxy* b) const
+	{
+		return a<b;
+	}
+};
+
+//
+struct	btRemovePairsContainingProxiesCallback : public btOverlapCallback
+{
+	const btAlignedObjectArray<btBroadphaseProxy*>&	m_proxies;  // sorted
+
+	btRemovePairsContainingProxiesCallback(const btAlignedObjectArray<btBroadphaseProxy*>& proxies) : m_proxies(proxies) {}
+
+	bool	contains(const btBroadphaseProxy* proxy) const
+	{
+		int lo=0,hi=m_proxies.size()-1;
+		while(lo<=hi)
+		{
+			int mid=(lo+hi)/2;
+			if(m_proxies[mid]<proxy) lo=mid+1;
+			else if(proxy<m_proxies[mid]) hi=mid-1;
+			else return true;
+		}
+		return false;
+	}
+
+	virtual bool	processOverlap(btBroadphasePair& pair)
+	{
+		return contains(pair.m_pProxy0) || contains(pair.m_pProxy1);
+	}
+};
+
+//
+void							btDbvtBroadphase::destroyProxies(	btBroadphaseProxy** proxies,
+																int numProxies,
+																btDispatcher* dispatcher)
+{
+	if(numProxies<=0) return;
+
+	// Remove the pairs of all proxies with a single scan of the pair cache
+	btAlignedObjectArray<btBroadphaseProxy*>	sorted;
+	sorted.resize(numProxies);
+	for(int i=0;i<numProxies;++i) sorted[i]=proxies[i];
+	sorted.quickSort(btProxyPointerLess());
+	btRemovePairsContainingProxiesCallback	removeCallback(sorted);
+	m_paircache->processAllOverlappingPairs(&removeCallback,dispatcher);
+
+	for(int i=0;i<numProxies;++i)
+	{
+		btDbvtProxy*	proxy=(btDbvtProxy*)proxies[i];
+		if(proxy->stage==STAGECOUNT)
+			m_sets[1].remove(proxy->leaf);
+		else
+			m_sets[0].remove(proxy->leaf);
+		listremove(proxy,m_stageRoots[proxy->stage]);
+		btAlignedFree(proxy);
+	}
+	m_needcleanup=true;
+}
+
 void	btDbvtBroadphase::getAabb(btBroadphaseProxy* absproxy,btVector3& aabbMin, btVector3& aabbMax ) const
 {
 	btDbvtProxy*						proxy=(btDbvtProxy*)absproxy;
@@ -23,11 +23,11 @@ subject to the following restrictions:
 
 #include <stdio.h>
 
-int	gOverlappingPairs = 0;
+thread_local int	gOverlappingPairs = 0;
 
-int gRemovePairs =0;
-int gAddedPairs =0;
-int gFindPairs =0;
+thread_local int gRemovePairs =0;
+thread_local int gAddedPairs =0;
+thread_local int gFindPairs =0;
 
 
 
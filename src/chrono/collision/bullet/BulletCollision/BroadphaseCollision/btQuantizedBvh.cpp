@@ -107,8 +107,8 @@ btQuantizedBvh::~btQuantizedBvh()
 }
 
 #ifdef DEBUG_TREE_BUILDING
-int gStackDepth = 0;
-int gMaxStackDepth = 0;
+thread_local int gStackDepth = 0;
+thread_local int gMaxStackDepth = 0;
 #endif //DEBUG_TREE_BUILDING
 
 void	btQuantizedBvh::buildTree	(int startIndex,int endIndex)
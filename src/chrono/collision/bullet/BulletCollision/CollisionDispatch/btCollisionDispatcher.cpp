@@ -26,7 +26,7 @@ subject to the following restrictions:
 #include "LinearMath/btPoolAllocator.h"
 #include "BulletCollision/CollisionDispatch/btCollisionConfiguration.h"
 
-int gNumManifold = 0;
+thread_local int gNumManifold = 0;
 
 #ifdef BT_DEBUG
 #include <stdio.h>
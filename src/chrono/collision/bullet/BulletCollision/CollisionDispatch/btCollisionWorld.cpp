@@ -248,6 +248,36 @@ void	btCollisionWorld::removeCollisionObject(btCollisionObject* collisionObject)
 
 }
 
+void	btCollisionWorld::removeCollisionObjects(btCollisionObject** collisionObjects,int numObjects)
+{
+	btAlignedObjectArray<btBroadphaseProxy*> proxies;
+	proxies.reserve(numObjects);
+	for (int i=0;i<numObjects;i++)
+	{
+		btBroadphaseProxy* bp = collisionObjects[i]->getBroadphaseHandle();
+		if (bp)
+		{
+			proxies.push_back(bp);
+			collisionObjects[i]->setBroadphaseHandle(0);
+		}
+	}
+
+	if (proxies.size())
+	{
+		// the pairs are cleaned (cached algorithms released) as they are removed
+		getBroadphase()->destroyProxies(&proxies[0],proxies.size(),m_dispatcher1);
+	}
+
+	// all objects in the world have a broadphase handle, except the ones just removed
+	int numKept = 0;
+	for (int i=0;i<m_collisionObjects.size();i++)
+	{
+		if (m_collisionObjects[i]->getBroadphaseHandle())
+			m_collisionObjects[numKept++] = m_collisionObjects[i];
+	}
+	m_collisionObjects.resize(numKept);
+}
+
 
 
 void	btCollisionWorld::rayTestSingle(const btTransform& rayFromTrans,const btTransform& rayToTrans,
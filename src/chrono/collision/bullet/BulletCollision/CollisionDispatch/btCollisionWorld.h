@@ -479,6 +479,10 @@ public:
 
 	virtual void	removeCollisionObject(btCollisionObject* collisionObject);
 
+	///removeCollisionObjects removes a set of objects at once, with a single scan of the overlapping pairs
+	///and of the object array (instead of one scan per object as in removeCollisionObject).
+	virtual void	removeCollisionObjects(btCollisionObject** collisionObjects,int numObjects);
+
 	virtual void	performDiscreteCollisionDetection();
 
 	btDispatcherInfo& getDispatchInfo()
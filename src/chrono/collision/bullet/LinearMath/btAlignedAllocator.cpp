@@ -16,9 +16,9 @@ subject to the following restrictions:
 #include "btAlignedAllocator.h"
 #include <stdint.h>
 
-int gNumAlignedAllocs = 0;
-int gNumAlignedFree = 0;
-int gTotalBytesAlignedAllocs = 0;//detect memory leaks
+thread_local int gNumAlignedAllocs = 0;
+thread_local int gNumAlignedFree = 0;
+thread_local int gTotalBytesAlignedAllocs = 0;//detect memory leaks
 
 static void *btAllocDefault(size_t size)
 {
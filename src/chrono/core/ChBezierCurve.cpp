@@ -26,6 +26,8 @@
 //    Bezier curves). In addition, it provides a method for calculating the
 //    closest point on a specified interval of the curve to a specified
 //    location.
+//    For queries on the entire curve, this class also maintains a table of
+//    arc lengths and a bounding box tree of the curve intervals.
 //
 // ChBezierCurveTracker
 //    This utility class implements a tracker for a given path. It uses time
@@ -35,7 +37,9 @@
 // =============================================================================
 
 #include <algorithm>
+#include <cmath>
 #include <iostream>
+#include <limits>
 #include <sstream>
 #include <fstream>
 
@@ -52,6 +56,15 @@ const double ChBezierCurve::m_sqrDistTol = 1e-4;
 const double ChBezierCurve::m_cosAngleTol = 1e-4;
 const double ChBezierCurve::m_paramTol = 1e-4;
 
+const size_t ChBezierCurve::m_numSamples = 16;
+const int ChBezierCurve::m_leafSize = 4;
+
+// Nodes and weights of the 5-point Gauss-Legendre quadrature on [-1,1]
+static const double gl_nodes[5] = {-0.9061798459386640, -0.5384693101056831, 0.0, 0.5384693101056831,
+                                   0.9061798459386640};
+static const double gl_weights[5] = {0.2369268850561891, 0.4786286704993665, 0.5688888888888889,
+                                     0.4786286704993665, 0.2369268850561891};
+
 // -----------------------------------------------------------------------------
 // ChBezierCurve::ChBezierCurve()
 //
@@ -67,6 +80,7 @@ ChBezierCurve::ChBezierCurve(const std::vector<ChVector<> >& points,
     assert(points.size() > 1);
     assert(points.size() == inCV.size());
     assert(points.size() == outCV.size());
+    buildSearchData();
 }
 
 ChBezierCurve::ChBezierCurve(const std::vector<ChVector<> >& points) : m_points(points) {
@@ -84,6 +98,7 @@ ChBezierCurve::ChBezierCurve(const std::vector<ChVector<> >& points) : m_points(
     if (numPoints == 2) {
         m_outCV[0] = (2.0 * points[0] + points[1]) / 3.0;
         m_inCV[1] = (points[0] + 2.0 * points[1]) / 3.0;
+        buildSearchData();
         return;
     }
 
@@ -129,6 +144,8 @@ ChBezierCurve::ChBezierCurve(const std::vector<ChVector<> >& points) : m_points(
     delete[] x;
     delete[] y;
     delete[] z;
+
+    buildSearchData();
 }
 
 void ChBezierCurve::setPoints(const std::vector<ChVector<> >& points,
@@ -140,6 +157,7 @@ void ChBezierCurve::setPoints(const std::vector<ChVector<> >& points,
     m_points = points;
     m_inCV = inCV;
     m_outCV = outCV;
+    buildSearchData();
 }
 
 // Utility function for solving the tridiagonal system for one of the
@@ -400,54 +418,306 @@ ChVector<> ChBezierCurve::calcClosestPoint(const ChVector<>& loc, size_t i, doub
     return Q;
 }
 
+// Point on an interval, from its power basis coefficients (Horner scheme)
+static inline ChVector<> EvalCoefs(const double* c, double t) {
+    return ChVector<>(((c[9] * t + c[6]) * t + c[3]) * t + c[0],  //
+                      ((c[10] * t + c[7]) * t + c[4]) * t + c[1],  //
+                      ((c[11] * t + c[8]) * t + c[5]) * t + c[2]);
+}
+
+// Norm of the tangent vector on an interval, from its power basis coefficients
+static inline double TangentNorm(const double* c, double t) {
+    double dx = (3 * c[9] * t + 2 * c[6]) * t + c[3];
+    double dy = (3 * c[10] * t + 2 * c[7]) * t + c[4];
+    double dz = (3 * c[11] * t + 2 * c[8]) * t + c[5];
+    return std::sqrt(dx * dx + dy * dy + dz * dz);
+}
+
+// Component-wise minimum and maximum of two vectors
+static inline ChVector<> MinVec(const ChVector<>& a, const ChVector<>& b) {
+    return ChVector<>(std::min(a.x(), b.x()), std::min(a.y(), b.y()), std::min(a.z(), b.z()));
+}
+
+static inline ChVector<> MaxVec(const ChVector<>& a, const ChVector<>& b) {
+    return ChVector<>(std::max(a.x(), b.x()), std::max(a.y(), b.y()), std::max(a.z(), b.z()));
+}
+
+// Squared distance from a location to an axis-aligned box (0 if inside)
+static inline double BoxDistance2(const ChVector<>& min, const ChVector<>& max, const ChVector<>& loc) {
+    ChVector<> d = MaxVec(MaxVec(min - loc, loc - max), VNULL);
+    return d.Length2();
+}
+
 // -----------------------------------------------------------------------------
-// ChBezierCurveTracker::reset()
+// ChBezierCurve::buildSearchData()
 //
-// This function reinitializes the pathTracker at the specified location. It
-// calculates an appropriate initial guess for the curve segment and sets the
-// curve parameter to 0.5.
+// This function precomputes the data used by the queries on the entire curve:
+//  - the power basis coefficients of each interval, Q(t) = a + b*t + c*t^2 + d*t^3,
+//    stored contiguously (a, b, c, d) for each interval;
+//  - the arc length at m_numSamples equally spaced parameter values in each
+//    interval (plus the total length);
+//  - a bounding box tree of the curve intervals, obtained by recursively halving
+//    the sequence of intervals. The bounding box of an interval is the bounding
+//    box of its control polygon, which contains the curve (convex hull property).
 // -----------------------------------------------------------------------------
-class PointSpec {
-  public:
-    PointSpec() {}
-    PointSpec(size_t index, double dist2) : m_index(index), m_dist2(dist2) {}
+void ChBezierCurve::buildSearchData() {
+    m_coefs.clear();
+    m_arcLengths.clear();
+    m_tree.clear();
+
+    if (m_points.size() < 2)
+        return;
 
-    size_t m_index;
-    double m_dist2;
-};
+    size_t n = m_points.size() - 1;
+
+    m_coefs.resize(12 * n);
+    for (size_t i = 0; i < n; i++) {
+        const ChVector<>& P0 = m_points[i];
+        const ChVector<>& P1 = m_outCV[i];
+        const ChVector<>& P2 = m_inCV[i + 1];
+        const ChVector<>& P3 = m_points[i + 1];
+        ChVector<> coefs[4] = {P0, 3.0 * (P1 - P0), 3.0 * (P0 - 2.0 * P1 + P2), P3 - P0 + 3.0 * (P1 - P2)};
+        for (int k = 0; k < 4; k++) {
+            m_coefs[12 * i + 3 * k + 0] = coefs[k].x();
+            m_coefs[12 * i + 3 * k + 1] = coefs[k].y();
+            m_coefs[12 * i + 3 * k + 2] = coefs[k].z();
+        }
+    }
 
-static bool comparePoints(const PointSpec& p1, const PointSpec& p2) {
-    return p1.m_dist2 < p2.m_dist2;
+    m_arcLengths.resize(n * m_numSamples + 1);
+    m_arcLengths[0] = 0;
+    for (size_t i = 0; i < n; i++) {
+        for (size_t k = 0; k < m_numSamples; k++) {
+            size_t j = i * m_numSamples + k;
+            m_arcLengths[j + 1] =
+                m_arcLengths[j] + integrateLength(i, double(k) / m_numSamples, double(k + 1) / m_numSamples);
+        }
+    }
+
+    // Create the tree nodes (children are always created after their parent)
+    BoxNode root;
+    root.first = 0;
+    root.last = (int)n;
+    root.left = -1;
+    m_tree.push_back(root);
+    for (size_t k = 0; k < m_tree.size(); k++) {
+        int first = m_tree[k].first;
+        int last = m_tree[k].last;
+        if (last - first <= m_leafSize)
+            continue;
+        BoxNode child;
+        child.left = -1;
+        child.first = first;
+        child.last = (first + last) / 2;
+        m_tree[k].left = (int)m_tree.size();
+        m_tree.push_back(child);
+        child.first = child.last;
+        child.last = last;
+        m_tree.push_back(child);
+    }
+
+    // Calculate the bounding boxes, from the leaves up
+    for (size_t k = m_tree.size(); k-- > 0;) {
+        BoxNode& node = m_tree[k];
+        if (node.left < 0) {
+            node.min = m_points[node.first];
+            node.max = m_points[node.first];
+            for (int i = node.first; i < node.last; i++) {
+                const ChVector<>* cp[3] = {&m_outCV[i], &m_inCV[i + 1], &m_points[i + 1]};
+                for (int j = 0; j < 3; j++) {
+                    node.min = MinVec(node.min, *cp[j]);
+                    node.max = MaxVec(node.max, *cp[j]);
+                }
+            }
+        } else {
+            node.min = MinVec(m_tree[node.left].min, m_tree[node.left + 1].min);
+            node.max = MaxVec(m_tree[node.left].max, m_tree[node.left + 1].max);
+        }
+    }
 }
 
-void ChBezierCurveTracker::reset(const ChVector<>& loc) {
-    // Walk all curve points and calculate the distance to the specified reset
-    // location, then sort them in increasing order.
-    std::vector<PointSpec> points;
+double ChBezierCurve::integrateLength(size_t i, double t1, double t2) const {
+    const double* c = &m_coefs[12 * i];
+    double half = 0.5 * (t2 - t1);
+    double mid = 0.5 * (t1 + t2);
+    double sum = 0;
+    for (int k = 0; k < 5; k++)
+        sum += gl_weights[k] * TangentNorm(c, mid + half * gl_nodes[k]);
+    return half * sum;
+}
 
-    for (size_t i = 0; i < m_path->getNumPoints(); i++)
-        points.push_back(PointSpec(i, (loc - m_path->m_points[i]).Length2()));
+// -----------------------------------------------------------------------------
+// ChBezierCurve::calcArcLength()
+// ChBezierCurve::evalArcLength()
+//
+// The arc length at a curve parameter is obtained from the table entry at the
+// previous sample, plus the integral of the tangent norm from that sample.
+// Conversely, the point at a given arc length is found by locating the pair of
+// samples which bracket it (binary search in the table), then by a few Newton
+// iterations on the curve parameter, starting from a linear interpolation
+// between the two samples.
+// -----------------------------------------------------------------------------
+double ChBezierCurve::calcArcLength(size_t i, double t) const {
+    assert(i >= 0 && i < getNumPoints() - 1);
 
-    std::sort(points.begin(), points.end(), comparePoints);
+    ChClampValue(t, 0.0, 1.0);
+    size_t k = std::min(static_cast<size_t>(t * m_numSamples), m_numSamples - 1);
 
-    // Set the initial guess to be at t=0.5 in either the interval starting at
-    // the point with minimum distance or in the previous interval.
-    m_curParam = 0.5f;
-    m_curInterval = points[0].m_index;
+    return m_arcLengths[i * m_numSamples + k] + integrateLength(i, double(k) / m_numSamples, t);
+}
 
-    if (m_curInterval == 0)
-        return;
+ChVector<> ChBezierCurve::evalArcLength(double s, size_t& i, double& t) const {
+    assert(getNumPoints() > 1);
 
-    if (m_curInterval == m_path->getNumPoints() - 1) {
-        m_curInterval--;
-        return;
+    size_t num_samples = m_arcLengths.size() - 1;
+    ChClampValue(s, 0.0, getLength());
+
+    // Samples j and j+1 such that m_arcLengths[j] <= s <= m_arcLengths[j+1]
+    size_t j = std::upper_bound(m_arcLengths.begin(), m_arcLengths.end(), s) - m_arcLengths.begin();
+    j = ChClamp(j, size_t(1), num_samples) - 1;
+
+    i = j / m_numSamples;
+    double dt = 1.0 / m_numSamples;
+    double t0 = (j % m_numSamples) * dt;
+    double ds = m_arcLengths[j + 1] - m_arcLengths[j];
+    t = ds > 0 ? t0 + dt * (s - m_arcLengths[j]) / ds : t0;
+
+    const double* c = &m_coefs[12 * i];
+    for (int iter = 0; iter < 3; iter++) {
+        double v = TangentNorm(c, t);
+        if (v < std::numeric_limits<double>::min())
+            break;
+        t -= (m_arcLengths[j] + integrateLength(i, t0, t) - s) / v;
+        ChClampValue(t, t0, t0 + dt);
+    }
+
+    return EvalCoefs(c, t);
+}
+
+ChVector<> ChBezierCurve::evalArcLength(double s) const {
+    size_t i;
+    double t;
+    return evalArcLength(s, i, t);
+}
+
+void ChBezierCurve::evalArcLengths(const std::vector<double>& s, std::vector<ChVector<> >& points, int nthreads) const {
+    int nqueries = (int)s.size();
+    points.resize(nqueries);
+
+#pragma omp parallel for num_threads(nthreads) schedule(static) if (nthreads > 1)
+    for (int k = 0; k < nqueries; ++k) {
+        points[k] = evalArcLength(s[k]);
+    }
+}
+
+// -----------------------------------------------------------------------------
+// ChBezierCurve::findClosestPoint()
+//
+// This function calculates the closest point on the entire curve to the given
+// location. The bounding box tree is traversed depth-first, visiting the closer
+// child first, and skipping the nodes and intervals whose bounding box is
+// farther than the closest point found so far. In each of the remaining
+// intervals, the Newton iterations start from the closest sample point.
+// -----------------------------------------------------------------------------
+ChVector<> ChBezierCurve::calcClosestPointInterval(const ChVector<>& loc, size_t i, double& t) const {
+    const double* c = &m_coefs[12 * i];
+
+    double best_t = 0;
+    double best_d2 = std::numeric_limits<double>::max();
+    for (size_t k = 0; k <= m_numSamples; k++) {
+        double tk = double(k) / m_numSamples;
+        double d2 = (EvalCoefs(c, tk) - loc).Length2();
+        if (d2 < best_d2) {
+            best_d2 = d2;
+            best_t = tk;
+        }
     }
 
-    ChVector<> loc2cur = m_path->m_points[m_curInterval] - loc;
-    ChVector<> loc2prev = m_path->m_points[m_curInterval - 1] - loc;
+    // Keep the sample if the Newton iterations left the interval
+    t = best_t;
+    ChVector<> Q = calcClosestPoint(loc, i, t);
+    if ((Q - loc).Length2() > best_d2) {
+        t = best_t;
+        Q = EvalCoefs(c, t);
+    }
 
-    if (Vdot(loc2cur, loc2prev) < 0)
-        m_curInterval--;
+    return Q;
+}
+
+ChVector<> ChBezierCurve::findClosestPoint(const ChVector<>& loc, size_t& i, double& t) const {
+    assert(getNumPoints() > 1);
+
+    ChVector<> point;
+    double best_d2 = std::numeric_limits<double>::max();
+
+    // The stack holds at most one node per tree level, plus the two children of the current node
+    int stack[64];
+    int top = 0;
+    stack[top++] = 0;
+
+    while (top > 0) {
+        const BoxNode& node = m_tree[stack[--top]];
+        if (BoxDistance2(node.min, node.max, loc) >= best_d2)
+            continue;
+
+        if (node.left < 0) {
+            for (int k = node.first; k < node.last; k++) {
+                ChVector<> min = MinVec(MinVec(m_points[k], m_outCV[k]), MinVec(m_inCV[k + 1], m_points[k + 1]));
+                ChVector<> max = MaxVec(MaxVec(m_points[k], m_outCV[k]), MaxVec(m_inCV[k + 1], m_points[k + 1]));
+                if (BoxDistance2(min, max, loc) >= best_d2)
+                    continue;
+                double tk;
+                ChVector<> Q = calcClosestPointInterval(loc, k, tk);
+                double d2 = (Q - loc).Length2();
+                if (d2 < best_d2) {
+                    best_d2 = d2;
+                    point = Q;
+                    i = k;
+                    t = tk;
+                }
+            }
+            continue;
+        }
+
+        const BoxNode& left = m_tree[node.left];
+        const BoxNode& right = m_tree[node.left + 1];
+        if (BoxDistance2(left.min, left.max, loc) < BoxDistance2(right.min, right.max, loc)) {
+            stack[top++] = node.left + 1;
+            stack[top++] = node.left;
+        } else {
+            stack[top++] = node.left;
+            stack[top++] = node.left + 1;
+        }
+    }
+
+    return point;
+}
+
+void ChBezierCurve::findClosestPoints(const std::vector<ChVector<> >& locs,
+                                      std::vector<ChVector<> >& points,
+                                      std::vector<size_t>& intervals,
+                                      std::vector<double>& params,
+                                      int nthreads) const {
+    int nqueries = (int)locs.size();
+    points.resize(nqueries);
+    intervals.resize(nqueries);
+    params.resize(nqueries);
+
+#pragma omp parallel for num_threads(nthreads) schedule(dynamic, 16) if (nthreads > 1)
+    for (int k = 0; k < nqueries; ++k) {
+        points[k] = findClosestPoint(locs[k], intervals[k], params[k]);
+    }
+}
+
+// -----------------------------------------------------------------------------
+// ChBezierCurveTracker::reset()
+//
+// This function reinitializes the pathTracker at the specified location. The
+// initial guess for the curve segment and the curve parameter is the closest
+// point on the entire path (found with the bounding box tree of the path).
+// -----------------------------------------------------------------------------
+void ChBezierCurveTracker::reset(const ChVector<>& loc) {
+    m_path->findClosestPoint(loc, m_curInterval, m_curParam);
 }
 
 // -----------------------------------------------------------------------------
@@ -517,6 +787,25 @@ int ChBezierCurveTracker::calcClosestPoint(const ChVector<>& loc, ChVector<>& po
 }
 
 
+// -----------------------------------------------------------------------------
+// ChBezierCurveTracker::calcLookAheadPoint()
+//
+// This function returns the point on the path at the specified arc length from
+// the last closest point. For a closed path, the arc length wraps around.
+// -----------------------------------------------------------------------------
+ChVector<> ChBezierCurveTracker::calcLookAheadPoint(double distance) const {
+    double s = getArcLength() + distance;
+
+    if (m_isClosedPath) {
+        double length = m_path->getLength();
+        s = std::fmod(s, length);
+        if (s < 0)
+            s += length;
+    }
+
+    return m_path->evalArcLength(s);
+}
+
 // -----------------------------------------------------------------------------
 // ChBezierCurveTracker::setIsClosedPath()
 //
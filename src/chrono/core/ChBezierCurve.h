@@ -27,6 +27,9 @@
 //    closest point on a specified interval of the curve to a specified
 //    location.
 //
+//    For queries on the entire curve, this class also maintains a table of
+//    arc lengths and a bounding box tree of the curve intervals.
+//
 // ChBezierCurveTracker
 //    This utility class implements a tracker for a given path. It uses time
 //    coherence in order to provide an appropriate initial guess for the
@@ -60,6 +63,11 @@ namespace chrono {
 /// Bezier curves). In addition, it provides a method for calculating the
 /// closest point on a specified interval of the curve to a specified
 /// location.
+/// For queries on the entire curve, it maintains a table of arc lengths and
+/// a bounding box tree of the curve intervals, which provide the closest
+/// point to a location and the point at a given arc length without relying
+/// on an initial guess. Batched versions of these queries are provided for
+/// the case of many objects (e.g. vehicles) following the same path.
 // -----------------------------------------------------------------------------
 class ChApi ChBezierCurve {
   public:
@@ -127,6 +135,40 @@ class ChApi ChBezierCurve {
     /// to the closest point.
     ChVector<> calcClosestPoint(const ChVector<>& loc, size_t i, double& t) const;
 
+    /// Calculate the closest point on the entire curve to the given location.
+    /// This function uses the bounding box tree of the curve intervals to discard
+    /// the intervals which cannot contain the closest point, and does not require
+    /// an initial guess. On return, 'i' and 't' contain the interval and the curve
+    /// parameter corresponding to the closest point.
+    ChVector<> findClosestPoint(const ChVector<>& loc, size_t& i, double& t) const;
+
+    /// Calculate the closest points on the curve to a batch of locations, using up to
+    /// 'nthreads' threads. Equivalent to calling findClosestPoint for each location.
+    void findClosestPoints(const std::vector<ChVector<> >& locs,
+                           std::vector<ChVector<> >& points,
+                           std::vector<size_t>& intervals,
+                           std::vector<double>& params,
+                           int nthreads = 1) const;
+
+    /// Return the arc length of the curve.
+    double getLength() const { return m_arcLengths.empty() ? 0 : m_arcLengths.back(); }
+
+    /// Return the arc length from the first point of the curve to the point in the
+    /// specified interval and at the given curve parameter (assumed to be in [0,1]).
+    double calcArcLength(size_t i, double t) const;
+
+    /// Evaluate the point on the curve at the given arc length from its first point
+    /// (clamped to [0, getLength()]). On return, 'i' and 't' contain the interval and
+    /// the curve parameter corresponding to this point.
+    ChVector<> evalArcLength(double s, size_t& i, double& t) const;
+
+    /// Evaluate the point on the curve at the given arc length from its first point.
+    ChVector<> evalArcLength(double s) const;
+
+    /// Evaluate the points on the curve at a batch of arc lengths, using up to
+    /// 'nthreads' threads. Equivalent to calling evalArcLength for each value.
+    void evalArcLengths(const std::vector<double>& s, std::vector<ChVector<> >& points, int nthreads = 1) const;
+
     /// Write the knots and control points to the specified file.
     void write(const std::string& filename);
 
@@ -176,6 +218,8 @@ class ChApi ChBezierCurve {
         marchive >> CHNVP(m_sqrDistTol);
         marchive >> CHNVP(m_cosAngleTol);
         marchive >> CHNVP(m_paramTol);
+
+        buildSearchData();
     }
 
   private:
@@ -185,10 +229,39 @@ class ChApi ChBezierCurve {
     /// resulting Bezier curve is a spline interpolant of the knots.
     static void solveTriDiag(size_t n, double* rhs, double* x);
 
+    /// Build the arc length table, the polynomial coefficients and the bounding box
+    /// tree of the curve intervals. Called whenever the curve points are set.
+    void buildSearchData();
+
+    /// Arc length of the specified interval between the curve parameters t1 and t2
+    /// (Gauss-Legendre quadrature of the tangent norm).
+    double integrateLength(size_t i, double t1, double t2) const;
+
+    /// Closest point to the given location in the specified interval, starting the
+    /// Newton iterations from the closest of the arc length table samples.
+    ChVector<> calcClosestPointInterval(const ChVector<>& loc, size_t i, double& t) const;
+
+    /// Node of the bounding box tree of the curve intervals. A node covers the
+    /// intervals [first, last). Its children (if any) are the nodes left and left+1.
+    struct BoxNode {
+        ChVector<> min;
+        ChVector<> max;
+        int first;
+        int last;
+        int left;  ///< index of the first child (-1 for a leaf)
+    };
+
     std::vector<ChVector<> > m_points;  ///< set of knot points
     std::vector<ChVector<> > m_inCV;    ///< set on "incident" control points
     std::vector<ChVector<> > m_outCV;   ///< set of "outgoing" control points
 
+    std::vector<double> m_arcLengths;  ///< arc length at the samples of each interval (m_numSamples per interval)
+    std::vector<double> m_coefs;       ///< power basis coefficients of each interval (12 per interval)
+    std::vector<BoxNode> m_tree;       ///< bounding box tree of the curve intervals (root first)
+
+    static const size_t m_numSamples;   ///< number of arc length table samples per interval
+    static const int m_leafSize;        ///< maximum number of intervals in a leaf of the tree
+
     static const size_t m_maxNumIters;  ///< maximum number of Newton iterations
     static const double m_sqrDistTol;   ///< tolerance on squared distance
     static const double m_cosAngleTol;  ///< tolerance for orthogonality test
@@ -229,6 +302,15 @@ class ChApi ChBezierCurveTracker {
     /// such, this function should be called with a continuous sequence of locations.
     int calcClosestPoint(const ChVector<>& loc, ChVector<>& point);
 
+    /// Return the arc length along the path of the last closest point.
+    double getArcLength() const { return m_path->calcArcLength(m_curInterval, m_curParam); }
+
+    /// Return the point on the path at the specified arc length ahead of the last
+    /// closest point (behind it, if negative). For a closed path, the arc length
+    /// wraps around the path; otherwise, the first or last point of the path is
+    /// returned if the arc length goes past the path ends.
+    ChVector<> calcLookAheadPoint(double distance) const;
+
     /// Set if the path is treated as an open loop or a closed loop for tracking
     void setIsClosedPath(bool isClosedPath);
 
@@ -34,9 +34,15 @@ namespace chrono {
 
 static ChLog* GlobalLog = NULL;
 
+// The pointer to the logger of the calling thread, if any (overrides the global logger)
+
+static thread_local ChLog* ThreadLog = NULL;
+
 // Functions to set/get the global logger
 
 ChLog& GetLog() {
+    if (ThreadLog != NULL)
+        return (*ThreadLog);
     if (GlobalLog != NULL)
         return (*GlobalLog);
     else {
@@ -53,6 +59,10 @@ void SetLogDefault() {
     GlobalLog = NULL;
 }
 
+void SetThreadLog(ChLog* new_logobject) {
+    ThreadLog = new_logobject;
+}
+
 //
 // Logger class
 //
@@ -114,6 +114,12 @@ ChApi void SetLog(ChLog& new_logobject);
 /// Global function to set the default ChLogConsole output to std::output.
 ChApi void SetLogDefault();
 
+/// Set a ChLog object to be returned by GetLog() on the calling thread only, in place
+/// of the global one (pass NULL to revert to the global logging system).
+/// This allows collecting the messages of systems simulated concurrently on different
+/// threads, without sharing the global ChLog (see ChSystemEnsemble).
+ChApi void SetThreadLog(ChLog* new_logobject);
+
 }  // end namespace chrono
 
 #endif
@@ -12,6 +12,7 @@
 // Authors: Alessandro Tasora, Radu Serban
 // =============================================================================
 
+#include <algorithm>
 #include <cmath>
 
 #include "chrono/motion_functions/ChFunction_Recorder.h"
@@ -23,7 +24,8 @@ CH_FACTORY_REGISTER(ChFunction_Recorder)
 
 ChFunction_Recorder::ChFunction_Recorder(const ChFunction_Recorder& other) {
     m_points = other.m_points;
-    m_last = m_points.end();
+    m_uniform = other.m_uniform;
+    m_inv_dx = other.m_inv_dx;
 }
 
 void ChFunction_Recorder::Estimate_x_range(double& xmin, double& xmax) const {
@@ -39,29 +41,78 @@ void ChFunction_Recorder::Estimate_x_range(double& xmin, double& xmax) const {
         xmax = xmin + 0.5;
 }
 
+// Relative tolerance on the spacing of uniform points. This only decides whether
+// the interval search starts from a direct guess; results do not depend on it.
+static const double uniform_tol = 1e-6;
+
 void ChFunction_Recorder::AddPoint(double mx, double my, double mw) {
-    for (auto iter = m_points.rbegin(); iter != m_points.rend(); ++iter) {
-        double dist = mx - iter->x;
-        if (std::abs(dist) < CH_MICROTOL) {
-            // Overwrite current iterator
-            iter->x = mx;
-            iter->y = my;
-            iter->w = mw;
-            return;
-        } else if (dist > 0) {
-            // Insert before current iterator
-            ChRecPoint rec(mx, my, mw);
-            m_points.insert(iter.base(), rec);
-            return;
+    // Append (most common case: points recorded in increasing order of x)
+    if (m_points.empty() || mx - m_points.back().x >= CH_MICROTOL) {
+        m_points.push_back(ChRecPoint(mx, my, mw));
+        size_t n = m_points.size();
+        if (n == 2) {
+            m_uniform = true;
+            m_inv_dx = 1 / (m_points[1].x - m_points[0].x);
+        } else if (n > 2 && m_uniform) {
+            double dx = m_points[n - 1].x - m_points[n - 2].x;
+            if (std::abs(dx * m_inv_dx - 1) < uniform_tol)
+                m_inv_dx = (n - 1) / (m_points[n - 1].x - m_points[0].x);
+            else
+                m_uniform = false;
         }
+        return;
     }
 
-    // Insert in front of list
-    m_points.push_front(ChRecPoint(mx, my, mw));
+    // Find the first point with x not smaller than mx (within tolerance)
+    auto iter = std::lower_bound(m_points.begin(), m_points.end(), mx - CH_MICROTOL,
+                                 [](const ChRecPoint& p, double x) { return p.x < x; });
+
+    if (iter != m_points.end() && std::abs(iter->x - mx) < CH_MICROTOL) {
+        // Overwrite existing point
+        iter->x = mx;
+        iter->y = my;
+        iter->w = mw;
+    } else {
+        // Insert before existing point
+        m_points.insert(iter, ChRecPoint(mx, my, mw));
+        UpdateUniform();
+    }
 }
 
-double Interpolate_y(double x, const ChRecPoint& p1, const ChRecPoint& p2) {
-    return ((x - p1.x) * p2.y + (p2.x - x) * p1.y) / (p2.x - p1.x);
+void ChFunction_Recorder::UpdateUniform() {
+    size_t n = m_points.size();
+    m_uniform = false;
+    if (n < 2)
+        return;
+
+    double x0 = m_points.front().x;
+    double dx = (m_points.back().x - x0) / (n - 1);
+    for (size_t i = 1; i < n; i++) {
+        if (std::abs(m_points[i].x - m_points[i - 1].x - dx) > uniform_tol * dx)
+            return;
+    }
+    m_uniform = true;
+    m_inv_dx = 1 / dx;
+}
+
+size_t ChFunction_Recorder::FindInterval(double x) const {
+    size_t last = m_points.size() - 2;
+
+    if (m_uniform) {
+        // Guess from the spacing of the points, then correct for round-off
+        double s = (x - m_points.front().x) * m_inv_dx;
+        size_t i = (s <= 0) ? 0 : std::min(static_cast<size_t>(s), last);
+        while (i > 0 && x < m_points[i].x)
+            --i;
+        while (i < last && x >= m_points[i + 1].x)
+            ++i;
+        return i;
+    }
+
+    auto iter = std::upper_bound(m_points.begin(), m_points.end(), x,
+                                 [](double x, const ChRecPoint& p) { return x < p.x; });
+    size_t i = static_cast<size_t>(iter - m_points.begin());
+    return (i == 0) ? 0 : std::min(i - 1, last);
 }
 
 double ChFunction_Recorder::Get_y(double x) const {
@@ -78,41 +129,28 @@ double ChFunction_Recorder::Get_y(double x) const {
     }
 
     // At this point we are guaranteed that there are at least two records.
-
-    if (m_last == m_points.end()) {
-        m_last = m_points.begin();
-    }
-
-    if (x > m_last->x) {
-        // Search to the right
-        for (auto iter = m_last; iter != m_points.end(); ++iter) {
-            if (x <= iter->x) {
-                return Interpolate_y(x, *m_last, *iter);
-            }
-            m_last = iter;
-        }
-    } else {
-        // Search to the left
-        for (auto iter = m_last; iter != m_points.begin();) {
-            --iter;
-            if (x >= iter->x) {
-                return Interpolate_y(x, *iter, *m_last);
-            }
-            m_last = iter;
-        }
-    }
-
-    return 0;
+    size_t i = FindInterval(x);
+    const ChRecPoint& p1 = m_points[i];
+    const ChRecPoint& p2 = m_points[i + 1];
+    return ((x - p1.x) * p2.y + (p2.x - x) * p1.y) / (p2.x - p1.x);
 }
 
 double ChFunction_Recorder::Get_y_dx(double x) const {
-    //// TODO:  can we do better?
-    return ChFunction::Get_y_dx(x);
+    // Constant extrapolation outside the range of the points
+    if (m_points.size() < 2 || x < m_points.front().x || x > m_points.back().x) {
+        return 0;
+    }
+
+    // Slope of the linear interpolation (right slope at the points)
+    size_t i = FindInterval(x);
+    const ChRecPoint& p1 = m_points[i];
+    const ChRecPoint& p2 = m_points[i + 1];
+    return (p2.y - p1.y) / (p2.x - p1.x);
 }
 
 double ChFunction_Recorder::Get_y_dxdx(double x) const {
-    //// TODO: can we do better?
-    return ChFunction::Get_y_dxdx(x);
+    // Piecewise linear interpolation
+    return 0;
 }
 
 }  // end namespace chrono
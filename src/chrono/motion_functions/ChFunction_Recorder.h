@@ -15,8 +15,7 @@
 #ifndef CHFUNCT_RECORDER_H
 #define CHFUNCT_RECORDER_H
 
-#include <list>
-#include <iterator>
+#include <vector>
 
 #include "chrono/motion_functions/ChFunction_Base.h"
 
@@ -48,15 +47,20 @@ class ChApi ChRecPoint {
 ///
 /// y = interpolation of array of (x,y) data,
 ///     where (x,y) points can be inserted randomly.
+///
+/// Points are kept in a contiguous array sorted by x. Intervals are found by
+/// binary search or, if the points are equally spaced, directly from x.
+/// Evaluation does not modify the function and can be done concurrently.
 
 class ChApi ChFunction_Recorder : public ChFunction {
 
   private:
-    std::list<ChRecPoint> m_points;  ///< the list of points
-    mutable std::list<ChRecPoint>::const_iterator m_last;
+    std::vector<ChRecPoint> m_points;  ///< the points, sorted by x
+    bool m_uniform;                    ///< true if the points are equally spaced
+    double m_inv_dx;                   ///< inverse of the spacing of the points, if uniform
 
   public:
-    ChFunction_Recorder() : m_last(m_points.end()) {}
+    ChFunction_Recorder() : m_uniform(false), m_inv_dx(0) {}
     ChFunction_Recorder(const ChFunction_Recorder& other);
     ~ChFunction_Recorder() {}
 
@@ -69,14 +73,22 @@ class ChApi ChFunction_Recorder : public ChFunction {
     virtual double Get_y_dx(double x) const override;
     virtual double Get_y_dxdx(double x) const override;
 
+    /// Add a point. A point with the same x (within CH_MICROTOL) is overwritten.
+    /// Points added in increasing order of x are appended in constant time.
     void AddPoint(double mx, double my, double mw = 1);
 
+    /// Reserve storage for the given number of points.
+    void Reserve(size_t num_points) { m_points.reserve(num_points); }
+
     void Reset() {
         m_points.clear();
-        m_last = m_points.end();
+        m_uniform = false;
     }
 
-    const std::list<ChRecPoint>& GetPoints() { return m_points; }
+    const std::vector<ChRecPoint>& GetPoints() const { return m_points; }
+
+    /// Return true if the points are equally spaced in x (intervals then found in constant time).
+    bool IsUniform() const { return m_uniform; }
 
     virtual void Estimate_x_range(double& xmin, double& xmax) const override;
 
@@ -86,8 +98,8 @@ class ChApi ChFunction_Recorder : public ChFunction {
         marchive.VersionWrite<ChFunction_Recorder>();
         // serialize parent class
         ChFunction::ArchiveOUT(marchive);
-        // serialize all member data: copy to vector and store
-        std::vector<ChRecPoint> tmpvect{std::begin(m_points), std::end(m_points)};
+        // serialize all member data
+        std::vector<ChRecPoint> tmpvect = m_points;
         marchive << CHNVP(tmpvect);
     }
 
@@ -97,12 +109,19 @@ class ChApi ChFunction_Recorder : public ChFunction {
         int version = marchive.VersionRead<ChFunction_Recorder>();
         // deserialize parent class
         ChFunction::ArchiveIN(marchive);
-        // stream in all member data: load vector of points and copy to list
+        // stream in all member data
         std::vector<ChRecPoint> tmpvect;
         marchive >> CHNVP(tmpvect);
-        m_points.clear();
-        std::copy(tmpvect.begin(), tmpvect.end(), std::back_inserter(m_points));
+        m_points = tmpvect;
+        UpdateUniform();
     }
+
+  private:
+    /// Index i of the interval [x_i, x_(i+1)] containing x, for x_0 < x < x_(n-1).
+    size_t FindInterval(double x) const;
+
+    /// Check if the points are equally spaced.
+    void UpdateUniform();
 };
 
 CH_CLASS_VERSION(ChFunction_Recorder,0)
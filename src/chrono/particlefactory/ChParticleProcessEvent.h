@@ -71,10 +71,12 @@ class ChParticleProcessEventRemove : public ChParticleProcessEvent {
 
     virtual void SetupPreProcess(ChSystem& msystem) { to_delete.clear(); }
 
+    /// The particles are queued for removal, and removed all at once at the next Setup()
+    /// of the system (see ChAssembly::RemoveBatch()).
     virtual void SetupPostProcess(ChSystem& msystem) {
         std::list<std::shared_ptr<ChBody> >::iterator ibody = to_delete.begin();
         while (ibody != to_delete.end()) {
-            msystem.Remove((*ibody));
+            msystem.RemoveBatch((*ibody));
             ++ibody;
         }
     }
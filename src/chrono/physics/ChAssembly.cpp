@@ -44,7 +44,8 @@ ChAssembly::ChAssembly()
       nsysvars(0),
       nsysvars_w(0),
       nbodies_sleep(0),
-      nbodies_fixed(0) {}
+      nbodies_fixed(0),
+      use_parallel_update(false) {}
 
 ChAssembly::ChAssembly(const ChAssembly& other) : ChPhysicsItem(other) {
     nbodies = other.nbodies;
@@ -61,6 +62,7 @@ ChAssembly::ChAssembly(const ChAssembly& other) : ChPhysicsItem(other) {
     nsysvars_w = other.nsysvars_w;
     nbodies_sleep = other.nbodies_sleep;
     nbodies_fixed = other.nbodies_fixed;
+    use_parallel_update = other.use_parallel_update;
 
     //// RADU
     //// TODO:  deep copy of the object lists (bodylist, linklist, otherphysicslist)
@@ -101,18 +103,21 @@ void ChAssembly::AddBody(std::shared_ptr<ChBody> newbody) {
 
     // set system and also add collision models to system
     newbody->SetSystem(this->GetSystem());
-    bodylist.push_back(newbody);
+    AppendItem(bodylist, newbody);
+    if (system)
+        system->SetTopologyChanged();
 }
 
 void ChAssembly::RemoveBody(std::shared_ptr<ChBody> mbody) {
-    assert(std::find<std::vector<std::shared_ptr<ChBody>>::iterator>(bodylist.begin(), bodylist.end(), mbody) !=
-           bodylist.end());
-
-    // warning! linear time search, to erase pointer from container.
-    bodylist.erase(std::find<std::vector<std::shared_ptr<ChBody>>::iterator>(bodylist.begin(), bodylist.end(), mbody));
+    if (!EraseItem(bodylist, mbody))
+        return;
+    if (system == this)
+        system->EraseSleepingBody(mbody->assembly_index);
 
     // nullify backward link to system and also remove from collision system
     mbody->SetSystem(0);
+    if (system)
+        system->SetTopologyChanged();
 }
 
 void ChAssembly::AddLink(std::shared_ptr<ChLink> newlink) {
@@ -120,18 +125,19 @@ void ChAssembly::AddLink(std::shared_ptr<ChLink> newlink) {
            linklist.end());
 
     newlink->SetSystem(this->GetSystem());
-    linklist.push_back(newlink);
+    AppendItem(linklist, newlink);
+    if (system)
+        system->SetTopologyChanged();
 }
 
 void ChAssembly::RemoveLink(std::shared_ptr<ChLink> mlink) {
-    assert(std::find<std::vector<std::shared_ptr<ChLink>>::iterator>(linklist.begin(), linklist.end(), mlink) !=
-           linklist.end());
-
-    // warning! linear time search, to erase pointer from container!
-    linklist.erase(std::find<std::vector<std::shared_ptr<ChLink>>::iterator>(linklist.begin(), linklist.end(), mlink));
+    if (!EraseItem(linklist, mlink))
+        return;
 
     // nullify backward link to system
     mlink->SetSystem(0);
+    if (system)
+        system->SetTopologyChanged();
 }
 
 void ChAssembly::AddOtherPhysicsItem(std::shared_ptr<ChPhysicsItem> newitem) {
@@ -141,19 +147,19 @@ void ChAssembly::AddOtherPhysicsItem(std::shared_ptr<ChPhysicsItem> newitem) {
 
     // set system and also add collision models to system
     newitem->SetSystem(this->GetSystem());
-    otherphysicslist.push_back(newitem);
+    AppendItem(otherphysicslist, newitem);
+    if (system)
+        system->SetTopologyChanged();
 }
 
 void ChAssembly::RemoveOtherPhysicsItem(std::shared_ptr<ChPhysicsItem> mitem) {
-    assert(std::find<std::vector<std::shared_ptr<ChPhysicsItem>>::iterator>(
-               otherphysicslist.begin(), otherphysicslist.end(), mitem) != otherphysicslist.end());
-
-    // warning! linear time search, to erase pointer from container.
-    otherphysicslist.erase(std::find<std::vector<std::shared_ptr<ChPhysicsItem>>::iterator>(
-        otherphysicslist.begin(), otherphysicslist.end(), mitem));
+    if (!EraseItem(otherphysicslist, mitem))
+        return;
 
     // nullify backward link to system and also remove from collision system
     mitem->SetSystem(0);
+    if (system)
+        system->SetTopologyChanged();
 }
 
 void ChAssembly::Add(std::shared_ptr<ChPhysicsItem> newitem) {
@@ -174,7 +180,50 @@ void ChAssembly::AddBatch(std::shared_ptr<ChPhysicsItem> newitem) {
     this->batch_to_insert.push_back(newitem);
 }
 
+void ChAssembly::RemoveBatch(std::shared_ptr<ChPhysicsItem> item) {
+    this->batch_to_remove.push_back(item);
+}
+
 void ChAssembly::FlushBatch() {
+    if (!batch_to_remove.empty()) {
+        // Let the collision system process all removals at once
+        auto collision_system = system ? system->GetCollisionSystem() : nullptr;
+        if (collision_system)
+            collision_system->BeginBatch();
+
+        bool removed = false;
+        for (int i = 0; i < this->batch_to_remove.size(); ++i) {
+            auto& item = batch_to_remove[i];
+            bool found;
+            if (auto body = std::dynamic_pointer_cast<ChBody>(item)) {
+                found = ClearItem(bodylist, body);
+            } else if (auto link = std::dynamic_pointer_cast<ChLink>(item))
+                found = ClearItem(linklist, link);
+            else
+                found = ClearItem(otherphysicslist, item);
+            if (!found)
+                continue;
+
+            // nullify backward link to system and also remove from collision system
+            item->SetSystem(0);
+            removed = true;
+        }
+
+        if (collision_system)
+            collision_system->EndBatch();
+
+        if (removed) {
+            if (system == this)
+                system->CompactSleepingBodies();
+            CompactItems(bodylist);
+            CompactItems(linklist);
+            CompactItems(otherphysicslist);
+            if (system)
+                system->SetTopologyChanged();
+        }
+        batch_to_remove.clear();
+    }
+
     for (int i = 0; i < this->batch_to_insert.size(); ++i) {
         this->Add(batch_to_insert[i]);
     }
@@ -201,6 +250,10 @@ void ChAssembly::RemoveAllBodies() {
         bodylist[ip]->SetSystem(0);
     }
     bodylist.clear();
+    if (system == this)
+        system->CompactSleepingBodies();
+    if (system)
+        system->SetTopologyChanged();
 }
 
 void ChAssembly::RemoveAllLinks() {
@@ -209,6 +262,8 @@ void ChAssembly::RemoveAllLinks() {
         linklist[ip]->SetSystem(0);
     }
     linklist.clear();
+    if (system)
+        system->SetTopologyChanged();
 }
 
 void ChAssembly::RemoveAllOtherPhysicsItems() {
@@ -217,6 +272,8 @@ void ChAssembly::RemoveAllOtherPhysicsItems() {
         otherphysicslist[ip]->SetSystem(0);
     }
     otherphysicslist.clear();
+    if (system)
+        system->SetTopologyChanged();
 }
 
 std::shared_ptr<ChBody> ChAssembly::SearchBody(const char* m_name) {
@@ -623,20 +680,48 @@ void ChAssembly::Update(double mytime, bool update_assets) {
     Update(update_assets);
 }
 
+// Number of threads used for processing the items of this assembly.
+int ChAssembly::GetParallelUpdateThreads() const {
+    if (!use_parallel_update || !system)
+        return 1;
+    return system->GetParallelThreadNumber();
+}
+
+// Apply 'func' to all items in the list. With more than one thread, the items which allow it are processed
+// concurrently, then the other ones serially.
+template <class T, typename Func>
+static void ApplyToItems(const std::vector<std::shared_ptr<T>>& list, int nthreads, Func func) {
+    int nitems = (int)list.size();
+
+    if (nthreads <= 1 || nitems < 2 * nthreads) {
+        for (int ip = 0; ip < nitems; ++ip)
+            func(list[ip].get());
+        return;
+    }
+
+#pragma omp parallel for num_threads(nthreads) schedule(static)
+    for (int ip = 0; ip < nitems; ++ip) {
+        if (list[ip]->GetAllowParallelUpdate())
+            func(list[ip].get());
+    }
+    for (int ip = 0; ip < nitems; ++ip) {
+        if (!list[ip]->GetAllowParallelUpdate())
+            func(list[ip].get());
+    }
+}
+
 // - ALL PHYSICAL ITEMS (BODIES, LINKS,ETC.) ARE UPDATED,
 //   ALSO UPDATING THEIR AUXILIARY VARIABLES (ROT.MATRICES, ETC.).
 // - UPDATES ALL FORCES  (AUTOMATIC, AS CHILDREN OF BODIES)
 // - UPDATES ALL MARKERS (AUTOMATIC, AS CHILDREN OF BODIES).
 void ChAssembly::Update(bool update_assets) {
-    for (int ip = 0; ip < bodylist.size(); ++ip) {
-        bodylist[ip]->Update(ChTime, update_assets);
-    }
+    int nthreads = GetParallelUpdateThreads();
+
+    ApplyToItems(bodylist, nthreads, [&](ChBody* body) { body->Update(ChTime, update_assets); });
     for (unsigned int ip = 0; ip < otherphysicslist.size(); ++ip) {
         otherphysicslist[ip]->Update(ChTime, update_assets);
     }
-    for (unsigned int ip = 0; ip < linklist.size(); ++ip) {
-        linklist[ip]->Update(ChTime, update_assets);
-    }
+    ApplyToItems(linklist, nthreads, [&](ChLink* link) { link->Update(ChTime, update_assets); });
 }
 
 void ChAssembly::SetNoSpeedNoAcceleration() {
@@ -651,6 +736,11 @@ void ChAssembly::SetNoSpeedNoAcceleration() {
     }
 }
 
+// Note: in the Int* functions below, bodies and links write to their own rows of the state vectors, so they can be
+// processed concurrently (see SetUseParallelUpdate). The exceptions are the links in the functions which load the R
+// residual, since a link adds to the rows of the bodies it connects. The other physics items are always processed
+// serially, since they can be containers of loads acting on other items.
+
 void ChAssembly::IntStateGather(const unsigned int off_x,
                                 ChState& x,
                                 const unsigned int off_v,
@@ -658,17 +748,19 @@ void ChAssembly::IntStateGather(const unsigned int off_x,
                                 double& T) {
     unsigned int displ_x = off_x - this->offset_x;
     unsigned int displ_v = off_v - this->offset_w;
-
-    for (unsigned int ip = 0; ip < bodylist.size(); ++ip) {
-        std::shared_ptr<ChBody> Bpointer = bodylist[ip];
-        if (Bpointer->IsActive())
-            Bpointer->IntStateGather(displ_x + Bpointer->GetOffset_x(), x, displ_v + Bpointer->GetOffset_w(), v, T);
-    }
-    for (unsigned int ip = 0; ip < linklist.size(); ++ip) {
-        std::shared_ptr<ChLink> Lpointer = linklist[ip];
-        if (Lpointer->IsActive())
-            Lpointer->IntStateGather(displ_x + Lpointer->GetOffset_x(), x, displ_v + Lpointer->GetOffset_w(), v, T);
-    }
+    int nthreads = GetParallelUpdateThreads();
+
+    // T is set at the end; do not let concurrent items write it.
+    ApplyToItems(bodylist, nthreads, [&](ChBody* body) {
+        double item_T;
+        if (body->IsActive())
+            body->IntStateGather(displ_x + body->GetOffset_x(), x, displ_v + body->GetOffset_w(), v, item_T);
+    });
+    ApplyToItems(linklist, nthreads, [&](ChLink* link) {
+        double item_T;
+        if (link->IsActive())
+            link->IntStateGather(displ_x + link->GetOffset_x(), x, displ_v + link->GetOffset_w(), v, item_T);
+    });
     for (unsigned int ip = 0; ip < otherphysicslist.size(); ++ip) {
         std::shared_ptr<ChPhysicsItem> Ppointer = otherphysicslist[ip];
         Ppointer->IntStateGather(displ_x + Ppointer->GetOffset_x(), x, displ_v + Ppointer->GetOffset_w(), v, T);
@@ -683,17 +775,16 @@ void ChAssembly::IntStateScatter(const unsigned int off_x,
                                  const double T) {
     unsigned int displ_x = off_x - this->offset_x;
     unsigned int displ_v = off_v - this->offset_w;
-
-    for (unsigned int ip = 0; ip < bodylist.size(); ++ip) {
-        std::shared_ptr<ChBody> Bpointer = bodylist[ip];
-        if (Bpointer->IsActive())
-            Bpointer->IntStateScatter(displ_x + Bpointer->GetOffset_x(), x, displ_v + Bpointer->GetOffset_w(), v, T);
-    }
-    for (unsigned int ip = 0; ip < linklist.size(); ++ip) {
-        std::shared_ptr<ChLink> Lpointer = linklist[ip];
-        if (Lpointer->IsActive())
-            Lpointer->IntStateScatter(displ_x + Lpointer->GetOffset_x(), x, displ_v + Lpointer->GetOffset_w(), v, T);
-    }
+    int nthreads = GetParallelUpdateThreads();
+
+    ApplyToItems(bodylist, nthreads, [&](ChBody* body) {
+        if (body->IsActive())
+            body->IntStateScatter(displ_x + body->GetOffset_x(), x, displ_v + body->GetOffset_w(), v, T);
+    });
+    ApplyToItems(linklist, nthreads, [&](ChLink* link) {
+        if (link->IsActive())
+            link->IntStateScatter(displ_x + link->GetOffset_x(), x, displ_v + link->GetOffset_w(), v, T);
+    });
     for (unsigned int ip = 0; ip < otherphysicslist.size(); ++ip) {
         std::shared_ptr<ChPhysicsItem> Ppointer = otherphysicslist[ip];
         Ppointer->IntStateScatter(displ_x + Ppointer->GetOffset_x(), x, displ_v + Ppointer->GetOffset_w(), v, T);
@@ -709,17 +800,16 @@ void ChAssembly::IntStateScatter(const unsigned int off_x,
 
 void ChAssembly::IntStateGatherAcceleration(const unsigned int off_a, ChStateDelta& a) {
     unsigned int displ_a = off_a - this->offset_w;
-
-    for (unsigned int ip = 0; ip < bodylist.size(); ++ip) {
-        std::shared_ptr<ChBody> Bpointer = bodylist[ip];
-        if (Bpointer->IsActive())
-            Bpointer->IntStateGatherAcceleration(displ_a + Bpointer->GetOffset_w(), a);
-    }
-    for (unsigned int ip = 0; ip < linklist.size(); ++ip) {
-        std::shared_ptr<ChLink> Lpointer = linklist[ip];
-        if (Lpointer->IsActive())
-            Lpointer->IntStateGatherAcceleration(displ_a + Lpointer->GetOffset_w(), a);
-    }
+    int nthreads = GetParallelUpdateThreads();
+
+    ApplyToItems(bodylist, nthreads, [&](ChBody* body) {
+        if (body->IsActive())
+            body->IntStateGatherAcceleration(displ_a + body->GetOffset_w(), a);
+    });
+    ApplyToItems(linklist, nthreads, [&](ChLink* link) {
+        if (link->IsActive())
+            link->IntStateGatherAcceleration(displ_a + link->GetOffset_w(), a);
+    });
     for (unsigned int ip = 0; ip < otherphysicslist.size(); ++ip) {
         std::shared_ptr<ChPhysicsItem> Ppointer = otherphysicslist[ip];
         Ppointer->IntStateGatherAcceleration(displ_a + Ppointer->GetOffset_w(), a);
@@ -729,17 +819,16 @@ void ChAssembly::IntStateGatherAcceleration(const unsigned int off_a, ChStateDel
 // From state derivative (acceleration) to system, sometimes might be needed
 void ChAssembly::IntStateScatterAcceleration(const unsigned int off_a, const ChStateDelta& a) {
     unsigned int displ_a = off_a - this->offset_w;
-
-    for (unsigned int ip = 0; ip < bodylist.size(); ++ip) {
-        std::shared_ptr<ChBody> Bpointer = bodylist[ip];
-        if (Bpointer->IsActive())
-            Bpointer->IntStateScatterAcceleration(displ_a + Bpointer->GetOffset_w(), a);
-    }
-    for (unsigned int ip = 0; ip < linklist.size(); ++ip) {
-        std::shared_ptr<ChLink> Lpointer = linklist[ip];
-        if (Lpointer->IsActive())
-            Lpointer->IntStateScatterAcceleration(displ_a + Lpointer->GetOffset_w(), a);
-    }
+    int nthreads = GetParallelUpdateThreads();
+
+    ApplyToItems(bodylist, nthreads, [&](ChBody* body) {
+        if (body->IsActive())
+            body->IntStateScatterAcceleration(displ_a + body->GetOffset_w(), a);
+    });
+    ApplyToItems(linklist, nthreads, [&](ChLink* link) {
+        if (link->IsActive())
+            link->IntStateScatterAcceleration(displ_a + link->GetOffset_w(), a);
+    });
     for (unsigned int ip = 0; ip < otherphysicslist.size(); ++ip) {
         std::shared_ptr<ChPhysicsItem> Ppointer = otherphysicslist[ip];
         Ppointer->IntStateScatterAcceleration(displ_a + Ppointer->GetOffset_w(), a);
@@ -749,17 +838,16 @@ void ChAssembly::IntStateScatterAcceleration(const unsigned int off_a, const ChS
 // From system to reaction forces (last computed) - some timestepper might need this
 void ChAssembly::IntStateGatherReactions(const unsigned int off_L, ChVectorDynamic<>& L) {
     unsigned int displ_L = off_L - this->offset_L;
-
-    for (unsigned int ip = 0; ip < bodylist.size(); ++ip) {
-        std::shared_ptr<ChBody> Bpointer = bodylist[ip];
-        if (Bpointer->IsActive())
-            Bpointer->IntStateGatherReactions(displ_L + Bpointer->GetOffset_L(), L);
-    }
-    for (unsigned int ip = 0; ip < linklist.size(); ++ip) {
-        std::shared_ptr<ChLink> Lpointer = linklist[ip];
-        if (Lpointer->IsActive())
-            Lpointer->IntStateGatherReactions(displ_L + Lpointer->GetOffset_L(), L);
-    }
+    int nthreads = GetParallelUpdateThreads();
+
+    ApplyToItems(bodylist, nthreads, [&](ChBody* body) {
+        if (body->IsActive())
+            body->IntStateGatherReactions(displ_L + body->GetOffset_L(), L);
+    });
+    ApplyToItems(linklist, nthreads, [&](ChLink* link) {
+        if (link->IsActive())
+            link->IntStateGatherReactions(displ_L + link->GetOffset_L(), L);
+    });
     for (unsigned int ip = 0; ip < otherphysicslist.size(); ++ip) {
         std::shared_ptr<ChPhysicsItem> Ppointer = otherphysicslist[ip];
         Ppointer->IntStateGatherReactions(displ_L + Ppointer->GetOffset_L(), L);
@@ -769,17 +857,16 @@ void ChAssembly::IntStateGatherReactions(const unsigned int off_L, ChVectorDynam
 // From reaction forces to system, ex. store last computed reactions in ChLink objects for plotting etc.
 void ChAssembly::IntStateScatterReactions(const unsigned int off_L, const ChVectorDynamic<>& L) {
     unsigned int displ_L = off_L - this->offset_L;
-
-    for (unsigned int ip = 0; ip < bodylist.size(); ++ip) {
-        std::shared_ptr<ChBody> Bpointer = bodylist[ip];
-        if (Bpointer->IsActive())
-            Bpointer->IntStateScatterReactions(displ_L + Bpointer->GetOffset_L(), L);
-    }
-    for (unsigned int ip = 0; ip < linklist.size(); ++ip) {
-        std::shared_ptr<ChLink> Lpointer = linklist[ip];
-        if (Lpointer->IsActive())
-            Lpointer->IntStateScatterReactions(displ_L + Lpointer->GetOffset_L(), L);
-    }
+    int nthreads = GetParallelUpdateThreads();
+
+    ApplyToItems(bodylist, nthreads, [&](ChBody* body) {
+        if (body->IsActive())
+            body->IntStateScatterReactions(displ_L + body->GetOffset_L(), L);
+    });
+    ApplyToItems(linklist, nthreads, [&](ChLink* link) {
+        if (link->IsActive())
+            link->IntStateScatterReactions(displ_L + link->GetOffset_L(), L);
+    });
     for (unsigned int ip = 0; ip < otherphysicslist.size(); ++ip) {
         std::shared_ptr<ChPhysicsItem> Ppointer = otherphysicslist[ip];
         Ppointer->IntStateScatterReactions(displ_L + Ppointer->GetOffset_L(), L);
@@ -793,20 +880,17 @@ void ChAssembly::IntStateIncrement(const unsigned int off_x,
                                    const ChStateDelta& Dv) {
     unsigned int displ_x = off_x - this->offset_x;
     unsigned int displ_v = off_v - this->offset_w;
+    int nthreads = GetParallelUpdateThreads();
 
-    for (int ip = 0; ip < bodylist.size(); ++ip) {
-        std::shared_ptr<ChBody> Bpointer = bodylist[ip];
-        if (Bpointer->IsActive())
-            Bpointer->IntStateIncrement(displ_x + Bpointer->GetOffset_x(), x_new, x, displ_v + Bpointer->GetOffset_w(),
-                                        Dv);
-    }
+    ApplyToItems(bodylist, nthreads, [&](ChBody* body) {
+        if (body->IsActive())
+            body->IntStateIncrement(displ_x + body->GetOffset_x(), x_new, x, displ_v + body->GetOffset_w(), Dv);
+    });
 
-    for (int ip = 0; ip < linklist.size(); ++ip) {
-        std::shared_ptr<ChLink> Lpointer = linklist[ip];
-        if (Lpointer->IsActive())
-            Lpointer->IntStateIncrement(displ_x + Lpointer->GetOffset_x(), x_new, x, displ_v + Lpointer->GetOffset_w(),
-                                        Dv);
-    }
+    ApplyToItems(linklist, nthreads, [&](ChLink* link) {
+        if (link->IsActive())
+            link->IntStateIncrement(displ_x + link->GetOffset_x(), x_new, x, displ_v + link->GetOffset_w(), Dv);
+    });
 
     for (int ip = 0; ip < otherphysicslist.size(); ++ip) {
         std::shared_ptr<ChPhysicsItem> Ppointer = otherphysicslist[ip];
@@ -820,11 +904,10 @@ void ChAssembly::IntLoadResidual_F(const unsigned int off,  ///< offset in R res
 {
     unsigned int displ_v = off - this->offset_w;
 
-    for (unsigned int ip = 0; ip < bodylist.size(); ++ip) {
-        std::shared_ptr<ChBody> Bpointer = bodylist[ip];
-        if (Bpointer->IsActive())
-            Bpointer->IntLoadResidual_F(displ_v + Bpointer->GetOffset_w(), R, c);
-    }
+    ApplyToItems(bodylist, GetParallelUpdateThreads(), [&](ChBody* body) {
+        if (body->IsActive())
+            body->IntLoadResidual_F(displ_v + body->GetOffset_w(), R, c);
+    });
     for (unsigned int ip = 0; ip < linklist.size(); ++ip) {
         std::shared_ptr<ChLink> Lpointer = linklist[ip];
         if (Lpointer->IsActive())
@@ -843,11 +926,10 @@ void ChAssembly::IntLoadResidual_Mv(const unsigned int off,      ///< offset in
 ) {
     unsigned int displ_v = off - this->offset_w;
 
-    for (unsigned int ip = 0; ip < bodylist.size(); ++ip) {
-        std::shared_ptr<ChBody> Bpointer = bodylist[ip];
-        if (Bpointer->IsActive())
-            Bpointer->IntLoadResidual_Mv(displ_v + Bpointer->GetOffset_w(), R, w, c);
-    }
+    ApplyToItems(bodylist, GetParallelUpdateThreads(), [&](ChBody* body) {
+        if (body->IsActive())
+            body->IntLoadResidual_Mv(displ_v + body->GetOffset_w(), R, w, c);
+    });
     for (unsigned int ip = 0; ip < linklist.size(); ++ip) {
         std::shared_ptr<ChLink> Lpointer = linklist[ip];
         if (Lpointer->IsActive())
@@ -889,17 +971,16 @@ void ChAssembly::IntLoadConstraint_C(const unsigned int off_L,  ///< offset in Q
                                      double recovery_clamp      ///< value for min/max clamping of c*C
 ) {
     unsigned int displ_L = off_L - this->offset_L;
-
-    for (unsigned int ip = 0; ip < bodylist.size(); ++ip) {
-        std::shared_ptr<ChBody> Bpointer = bodylist[ip];
-        if (Bpointer->IsActive())
-            Bpointer->IntLoadConstraint_C(displ_L + Bpointer->GetOffset_L(), Qc, c, do_clamp, recovery_clamp);
-    }
-    for (unsigned int ip = 0; ip < linklist.size(); ++ip) {
-        std::shared_ptr<ChLink> Lpointer = linklist[ip];
-        if (Lpointer->IsActive())
-            Lpointer->IntLoadConstraint_C(displ_L + Lpointer->GetOffset_L(), Qc, c, do_clamp, recovery_clamp);
-    }
+    int nthreads = GetParallelUpdateThreads();
+
+    ApplyToItems(bodylist, nthreads, [&](ChBody* body) {
+        if (body->IsActive())
+            body->IntLoadConstraint_C(displ_L + body->GetOffset_L(), Qc, c, do_clamp, recovery_clamp);
+    });
+    ApplyToItems(linklist, nthreads, [&](ChLink* link) {
+        if (link->IsActive())
+            link->IntLoadConstraint_C(displ_L + link->GetOffset_L(), Qc, c, do_clamp, recovery_clamp);
+    });
     for (unsigned int ip = 0; ip < otherphysicslist.size(); ++ip) {
         std::shared_ptr<ChPhysicsItem> Ppointer = otherphysicslist[ip];
         Ppointer->IntLoadConstraint_C(displ_L + Ppointer->GetOffset_L(), Qc, c, do_clamp, recovery_clamp);
@@ -911,17 +992,16 @@ void ChAssembly::IntLoadConstraint_Ct(const unsigned int off_L,  ///< offset in
                                       const double c             ///< a scaling factor
 ) {
     unsigned int displ_L = off_L - this->offset_L;
-
-    for (unsigned int ip = 0; ip < bodylist.size(); ++ip) {
-        std::shared_ptr<ChBody> Bpointer = bodylist[ip];
-        if (Bpointer->IsActive())
-            Bpointer->IntLoadConstraint_Ct(displ_L + Bpointer->GetOffset_L(), Qc, c);
-    }
-    for (unsigned int ip = 0; ip < linklist.size(); ++ip) {
-        std::shared_ptr<ChLink> Lpointer = linklist[ip];
-        if (Lpointer->IsActive())
-            Lpointer->IntLoadConstraint_Ct(displ_L + Lpointer->GetOffset_L(), Qc, c);
-    }
+    int nthreads = GetParallelUpdateThreads();
+
+    ApplyToItems(bodylist, nthreads, [&](ChBody* body) {
+        if (body->IsActive())
+            body->IntLoadConstraint_Ct(displ_L + body->GetOffset_L(), Qc, c);
+    });
+    ApplyToItems(linklist, nthreads, [&](ChLink* link) {
+        if (link->IsActive())
+            link->IntLoadConstraint_Ct(displ_L + link->GetOffset_L(), Qc, c);
+    });
     for (unsigned int ip = 0; ip < otherphysicslist.size(); ++ip) {
         std::shared_ptr<ChPhysicsItem> Ppointer = otherphysicslist[ip];
         Ppointer->IntLoadConstraint_Ct(displ_L + Ppointer->GetOffset_L(), Qc, c);
@@ -936,20 +1016,17 @@ void ChAssembly::IntToDescriptor(const unsigned int off_v,
                                  const ChVectorDynamic<>& Qc) {
     unsigned int displ_L = off_L - this->offset_L;
     unsigned int displ_v = off_v - this->offset_w;
+    int nthreads = GetParallelUpdateThreads();
 
-    for (int ip = 0; ip < bodylist.size(); ++ip) {
-        std::shared_ptr<ChBody> Bpointer = bodylist[ip];
-        if (Bpointer->IsActive())
-            Bpointer->IntToDescriptor(displ_v + Bpointer->GetOffset_w(), v, R, displ_L + Bpointer->GetOffset_L(), L,
-                                      Qc);
-    }
+    ApplyToItems(bodylist, nthreads, [&](ChBody* body) {
+        if (body->IsActive())
+            body->IntToDescriptor(displ_v + body->GetOffset_w(), v, R, displ_L + body->GetOffset_L(), L, Qc);
+    });
 
-    for (int ip = 0; ip < linklist.size(); ++ip) {
-        std::shared_ptr<ChLink> Lpointer = linklist[ip];
-        if (Lpointer->IsActive())
-            Lpointer->IntToDescriptor(displ_v + Lpointer->GetOffset_w(), v, R, displ_L + Lpointer->GetOffset_L(), L,
-                                      Qc);
-    }
+    ApplyToItems(linklist, nthreads, [&](ChLink* link) {
+        if (link->IsActive())
+            link->IntToDescriptor(displ_v + link->GetOffset_w(), v, R, displ_L + link->GetOffset_L(), L, Qc);
+    });
 
     for (int ip = 0; ip < otherphysicslist.size(); ++ip) {
         std::shared_ptr<ChPhysicsItem> Ppointer = otherphysicslist[ip];
@@ -963,18 +1040,17 @@ void ChAssembly::IntFromDescriptor(const unsigned int off_v,
                                    ChVectorDynamic<>& L) {
     unsigned int displ_L = off_L - this->offset_L;
     unsigned int displ_v = off_v - this->offset_w;
+    int nthreads = GetParallelUpdateThreads();
 
-    for (int ip = 0; ip < bodylist.size(); ++ip) {
-        std::shared_ptr<ChBody> Bpointer = bodylist[ip];
-        if (Bpointer->IsActive())
-            Bpointer->IntFromDescriptor(displ_v + Bpointer->GetOffset_w(), v, displ_L + Bpointer->GetOffset_L(), L);
-    }
+    ApplyToItems(bodylist, nthreads, [&](ChBody* body) {
+        if (body->IsActive())
+            body->IntFromDescriptor(displ_v + body->GetOffset_w(), v, displ_L + body->GetOffset_L(), L);
+    });
 
-    for (int ip = 0; ip < linklist.size(); ++ip) {
-        std::shared_ptr<ChLink> Lpointer = linklist[ip];
-        if (Lpointer->IsActive())
-            Lpointer->IntFromDescriptor(displ_v + Lpointer->GetOffset_w(), v, displ_L + Lpointer->GetOffset_L(), L);
-    }
+    ApplyToItems(linklist, nthreads, [&](ChLink* link) {
+        if (link->IsActive())
+            link->IntFromDescriptor(displ_v + link->GetOffset_w(), v, displ_L + link->GetOffset_L(), L);
+    });
 
     for (int ip = 0; ip < otherphysicslist.size(); ++ip) {
         std::shared_ptr<ChPhysicsItem> Ppointer = otherphysicslist[ip];
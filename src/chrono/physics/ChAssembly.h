@@ -73,15 +73,32 @@ class ChApi ChAssembly : public ChPhysicsItem {
     /// at the first Setup() call. This is thread safe.
     void AddBatch(std::shared_ptr<ChPhysicsItem> newitem);
 
-    /// If some items are queued for addition in system, using AddBatch(), this will
-    /// effectively add them and clean the batch. Called automatically at each Setup().
-    void FlushBatch();
-
-    /// Remove a body from this system.
+    /// Items removed in this way are removed like in the Remove() method, but not instantly,
+    /// they are simply queued in a batch of 'to remove' items, that are removed automatically
+    /// at the first Setup() call, with a single compaction of the item lists (the order of the
+    /// remaining items is preserved) and a single update of the collision system.
+    /// Items which are not in this assembly when the batch is flushed are ignored.
+    void RemoveBatch(std::shared_ptr<ChPhysicsItem> item);
+
+    /// If some items are queued for removal or addition in system, using RemoveBatch() or AddBatch(),
+    /// this will effectively remove and add them (in this order) and clean the batches.
+    /// Called automatically at each Setup().
+    virtual void FlushBatch();
+
+    /// Remove a body from this system, in constant time.
+    /// Note: the last body of the list is moved in place of the removed one, so the order of the
+    /// remaining bodies changes (use RemoveBatch() to preserve it). Removing a body that is not in
+    /// this assembly is silently ignored (it used to trigger an assertion).
     virtual void RemoveBody(std::shared_ptr<ChBody> mbody);
-    /// Remove a link from this system.
+    /// Remove a link from this system, in constant time.
+    /// Note: the last link of the list is moved in place of the removed one, so the order of the
+    /// remaining links changes (use RemoveBatch() to preserve it). Removing a link that is not in
+    /// this assembly is silently ignored (it used to trigger an assertion).
     virtual void RemoveLink(std::shared_ptr<ChLink> mlink);
-    /// Remove a ChPhysicsItem object that is not a body or a link
+    /// Remove a ChPhysicsItem object that is not a body or a link, in constant time.
+    /// Note: the last item of the list is moved in place of the removed one, so the order of the
+    /// remaining items changes (use RemoveBatch() to preserve it). Removing an item that is not in
+    /// this assembly is silently ignored (it used to trigger an assertion).
     virtual void RemoveOtherPhysicsItem(std::shared_ptr<ChPhysicsItem> mitem);
     /// Remove whatever type of ChPhysicsItem that was added to the system.
     /// (suggestion: use this instead of old RemoveBody(), RemoveLink, etc.)
@@ -266,6 +283,17 @@ class ChApi ChAssembly : public ChPhysicsItem {
     /// as starting point for offsetting all the contained sub objects.
     virtual void Setup() override;
 
+    /// Enable or disable the multithreaded processing of the bodies and links of this assembly
+    /// in Update() and in the functions for the global state vectors (IntStateGather(), etc.).
+    /// The number of threads is the one of the parent system (see ChSystem::SetParallelThreadNumber()).
+    /// Items that are not thread safe can opt out with ChPhysicsItem::SetAllowParallelUpdate().
+    /// Links that load the residual of the bodies, and the other physics items, are always processed serially.
+    /// Default: false.
+    void SetUseParallelUpdate(bool val) { use_parallel_update = val; }
+
+    /// Tell if the multithreaded processing of bodies and links is enabled.
+    bool GetUseParallelUpdate() const { return use_parallel_update; }
+
     /// Updates all the auxiliary data and children of
     /// bodies, forces, links, given their current state.
     virtual void Update(double mytime, bool update_assets = true) override;
@@ -377,6 +405,8 @@ class ChApi ChAssembly : public ChPhysicsItem {
         otherphysicslist;  ///< list of other physic objects that are not bodies or links
     std::vector<std::shared_ptr<ChPhysicsItem>>
         batch_to_insert;  ///< list of items to insert when doing Setup() or Flush.
+    std::vector<std::shared_ptr<ChPhysicsItem>>
+        batch_to_remove;  ///< list of items to remove when doing Setup() or Flush.
 
     // Statistics:
     int nbodies;        ///< number of bodies (currently active)
@@ -393,6 +423,62 @@ class ChApi ChAssembly : public ChPhysicsItem {
     int ndoc_w_D;       ///< number of scalar constraints D, when using 3 rot. dof. per body (only unilaterals)
     int nbodies_sleep;  ///< number of bodies that are sleeping
     int nbodies_fixed;  ///< number of bodies that are fixed
+
+    bool use_parallel_update;  ///< process bodies and links with multiple threads
+
+    /// Append an item to one of the lists of this assembly, recording its position in the list.
+    template <class T>
+    static void AppendItem(std::vector<std::shared_ptr<T>>& list, std::shared_ptr<T> item) {
+        item->assembly_index = (unsigned int)list.size();
+        list.push_back(item);
+    }
+
+    /// Erase an item from one of the lists of this assembly, in constant time: the last item
+    /// of the list is moved in its place.
+    /// Return false if the item is not in the list.
+    template <class T>
+    static bool EraseItem(std::vector<std::shared_ptr<T>>& list, std::shared_ptr<T> item) {
+        unsigned int index = item->assembly_index;
+        if (index >= list.size() || list[index] != item)
+            return false;
+        if (index + 1 < list.size()) {
+            list[index] = list.back();
+            list[index]->assembly_index = index;
+        }
+        list.pop_back();
+        return true;
+    }
+
+    /// Clear the entry of an item in one of the lists of this assembly (if there).
+    /// Return false if the item is not in the list.
+    template <class T>
+    static bool ClearItem(std::vector<std::shared_ptr<T>>& list, std::shared_ptr<T> item) {
+        unsigned int index = item->assembly_index;
+        if (index >= list.size() || list[index] != item)
+            return false;
+        list[index].reset();
+        return true;
+    }
+
+    /// Remove the cleared entries of one of the lists of this assembly, preserving the order of the other items.
+    template <class T>
+    static void CompactItems(std::vector<std::shared_ptr<T>>& list) {
+        unsigned int count = 0;
+        for (unsigned int ip = 0; ip < list.size(); ++ip) {
+            if (!list[ip])
+                continue;
+            if (count != ip) {
+                list[count] = std::move(list[ip]);
+                list[count]->assembly_index = count;
+            }
+            count++;
+        }
+        list.resize(count);
+    }
+
+  private:
+    /// Number of threads for processing bodies and links (1 if parallel update is disabled).
+    int GetParallelUpdateThreads() const;
 };
 
 
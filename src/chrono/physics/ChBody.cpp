@@ -274,6 +274,10 @@ void ChBody::IntFromDescriptor(const unsigned int off_v,  // offset in v
 void ChBody::InjectVariables(ChSystemDescriptor& mdescriptor) {
     this->variables.SetDisabled(!this->IsActive());
 
+    // Sleeping bodies are left out of the problem until their island wakes up
+    if (this->GetSleeping())
+        return;
+
     mdescriptor.InsertVariables(&this->variables);
 }
 
@@ -701,6 +705,8 @@ void ChBody::SetBodyFixed(bool state) {
     if (state == BFlagGet(BodyFlag::FIXED))
         return;
     BFlagSet(BodyFlag::FIXED, state);
+    if (system)
+        system->SetTopologyChanged();
     // RecomputeCollisionModel(); // because one may use different model types for static or dynamic coll.shapes
 }
 
@@ -771,7 +777,11 @@ bool ChBody::GetUseSleeping() const {
 }
 
 void ChBody::SetSleeping(bool state) {
+    if (state == BFlagGet(BodyFlag::SLEEPING))
+        return;
     BFlagSet(BodyFlag::SLEEPING, state);
+    if (system)
+        system->SetTopologyChanged();
 }
 
 bool ChBody::GetSleeping() const {
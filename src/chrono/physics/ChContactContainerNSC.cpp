@@ -35,7 +35,8 @@ ChContactContainerNSC::ChContactContainerNSC()
       n_added_666_6(0),
       n_added_666_333(0),
       n_added_666_666(0),
-      n_added_6_6_rolling(0) {}
+      n_added_6_6_rolling(0),
+      custom_storage(false) {}
 
 ChContactContainerNSC::ChContactContainerNSC(const ChContactContainerNSC& other) : ChContactContainer(other) {
     n_added_6_6 = 0;
@@ -49,6 +50,7 @@ ChContactContainerNSC::ChContactContainerNSC(const ChContactContainerNSC& other)
     n_added_666_333 = 0;
     n_added_666_666 = 0;
     n_added_6_6_rolling = 0;
+    custom_storage = other.custom_storage;
 }
 
 ChContactContainerNSC::~ChContactContainerNSC() {
@@ -227,260 +229,260 @@ void ChContactContainerNSC::AddContact(const collision::ChCollisionInfo& mcontac
     // These cases are made distinct to exploit the optimization coming from templates and static data sizes
     // in contact types.
 
-    /*
-    if (ChContactable_1vars<6>* mmboA = dynamic_cast<ChContactable_1vars<6>*>(mcontact.modelA->GetContactable())) {
-        // 6_6
-        if (ChContactable_1vars<6>* mmboB = dynamic_cast<ChContactable_1vars<6>*>(mcontact.modelB->GetContactable())) {
-            if ((mmatA->rolling_friction && mmatB->rolling_friction) ||
-                (mmatA->spinning_friction && mmatB->spinning_friction)) {
-                _OptimalContactInsert(contactlist_6_6_rolling, lastcontact_6_6_rolling, n_added_6_6_rolling, this,
-                                      mmboA, mmboB, mcontact);
-            } else {
-                _OptimalContactInsert(contactlist_6_6, lastcontact_6_6, n_added_6_6, this, mmboA, mmboB, mcontact);
-            }
-            return;
-        }
-        // 6_3
-        if (ChContactable_1vars<3>* mmboB = dynamic_cast<ChContactable_1vars<3>*>(mcontact.modelB->GetContactable())) {
-            _OptimalContactInsert(contactlist_6_3, lastcontact_6_3, n_added_6_3, this, mmboA, mmboB, mcontact);
-            return;
-        }
-    }
-
-    if (ChContactable_1vars<3>* mmboA = dynamic_cast<ChContactable_1vars<3>*>(mcontact.modelA->GetContactable())) {
-        // 3_6 -> 6_3
-        if (ChContactable_1vars<6>* mmboB = dynamic_cast<ChContactable_1vars<6>*>(mcontact.modelB->GetContactable())) {
-            collision::ChCollisionInfo swapped_contact(mcontact, true);
-            _OptimalContactInsert(contactlist_6_3, lastcontact_6_3, n_added_6_3, this, mmboB, mmboA, swapped_contact);
-            return;
-        }
-        // 3_3
-        if (ChContactable_1vars<3>* mmboB = dynamic_cast<ChContactable_1vars<3>*>(mcontact.modelB->GetContactable())) {
-            _OptimalContactInsert(contactlist_3_3, lastcontact_3_3, n_added_3_3, this, mmboA, mmboB, mcontact);
-            return;
-        }
-    }
-    */
     if (auto mmboA = dynamic_cast<ChContactable_1vars<3>*>(contactableA)) {
         if (auto mmboB = dynamic_cast<ChContactable_1vars<3>*>(contactableB)) {
             // 3_3
-            _OptimalContactInsert(contactlist_3_3, lastcontact_3_3, n_added_3_3, this, mmboA, mmboB, mcontact);
+            InsertContact(mmboA, mmboB, mcontact);
         } else if (auto mmboB = dynamic_cast<ChContactable_1vars<6>*>(contactableB)) {
             // 3_6 -> 6_3
             collision::ChCollisionInfo swapped_contact(mcontact, true);
-            _OptimalContactInsert(contactlist_6_3, lastcontact_6_3, n_added_6_3, this, mmboB, mmboA, swapped_contact);
+            InsertContact(mmboB, mmboA, swapped_contact);
         } else if (auto mmboB = dynamic_cast<ChContactable_3vars<3, 3, 3>*>(contactableB)) {
             // 3_333 -> 333_3
             collision::ChCollisionInfo swapped_contact(mcontact, true);
-            _OptimalContactInsert(contactlist_333_3, lastcontact_333_3, n_added_333_3, this, mmboB, mmboA,
-                                  swapped_contact);
+            InsertContact(mmboB, mmboA, swapped_contact);
         } else if (auto mmboB = dynamic_cast<ChContactable_3vars<6, 6, 6>*>(contactableB)) {
             // 3_666 -> 666_3
             collision::ChCollisionInfo swapped_contact(mcontact, true);
-            _OptimalContactInsert(contactlist_666_3, lastcontact_666_3, n_added_666_3, this, mmboB, mmboA,
-                                  swapped_contact);
+            InsertContact(mmboB, mmboA, swapped_contact);
         }
     }
 
     else if (auto mmboA = dynamic_cast<ChContactable_1vars<6>*>(contactableA)) {
         if (auto mmboB = dynamic_cast<ChContactable_1vars<3>*>(contactableB)) {
             // 6_3
-            _OptimalContactInsert(contactlist_6_3, lastcontact_6_3, n_added_6_3, this, mmboA, mmboB, mcontact);
+            InsertContact(mmboA, mmboB, mcontact);
         } else if (auto mmboB = dynamic_cast<ChContactable_1vars<6>*>(contactableB)) {
             // 6_6    ***NOTE: for body-body one could have rolling friction: ***
             if ((mmatA->rolling_friction && mmatB->rolling_friction) ||
                 (mmatA->spinning_friction && mmatB->spinning_friction)) {
-                _OptimalContactInsert(contactlist_6_6_rolling, lastcontact_6_6_rolling, n_added_6_6_rolling, this,
-                                      mmboA, mmboB, mcontact);
+                InsertContactRolling(mmboA, mmboB, mcontact);
             } else {
-                _OptimalContactInsert(contactlist_6_6, lastcontact_6_6, n_added_6_6, this, mmboA, mmboB, mcontact);
+                InsertContact(mmboA, mmboB, mcontact);
             }
         } else if (auto mmboB = dynamic_cast<ChContactable_3vars<3, 3, 3>*>(contactableB)) {
             // 6_333 -> 333_6
             collision::ChCollisionInfo swapped_contact(mcontact, true);
-            _OptimalContactInsert(contactlist_333_6, lastcontact_333_6, n_added_333_6, this, mmboB, mmboA,
-                                  swapped_contact);
+            InsertContact(mmboB, mmboA, swapped_contact);
         } else if (auto mmboB = dynamic_cast<ChContactable_3vars<6, 6, 6>*>(contactableB)) {
             // 6_666 -> 666_6
             collision::ChCollisionInfo swapped_contact(mcontact, true);
-            _OptimalContactInsert(contactlist_666_6, lastcontact_666_6, n_added_666_6, this, mmboB, mmboA,
-                                  swapped_contact);
+            InsertContact(mmboB, mmboA, swapped_contact);
         }
     }
 
     else if (auto mmboA = dynamic_cast<ChContactable_3vars<3, 3, 3>*>(contactableA)) {
         if (auto mmboB = dynamic_cast<ChContactable_1vars<3>*>(contactableB)) {
             // 333_3
-            _OptimalContactInsert(contactlist_333_3, lastcontact_333_3, n_added_333_3, this, mmboA, mmboB, mcontact);
+            InsertContact(mmboA, mmboB, mcontact);
         } else if (auto mmboB = dynamic_cast<ChContactable_1vars<6>*>(contactableB)) {
             // 333_6
-            _OptimalContactInsert(contactlist_333_6, lastcontact_333_6, n_added_333_6, this, mmboA, mmboB, mcontact);
+            InsertContact(mmboA, mmboB, mcontact);
         } else if (auto mmboB = dynamic_cast<ChContactable_3vars<3, 3, 3>*>(contactableB)) {
             // 333_333
-            _OptimalContactInsert(contactlist_333_333, lastcontact_333_333, n_added_333_333, this, mmboA, mmboB,
-                                  mcontact);
+            InsertContact(mmboA, mmboB, mcontact);
         } else if (auto mmboB = dynamic_cast<ChContactable_3vars<6, 6, 6>*>(contactableB)) {
             // 333_666 -> 666_333
             collision::ChCollisionInfo swapped_contact(mcontact, true);
-            _OptimalContactInsert(contactlist_666_333, lastcontact_666_333, n_added_666_333, this, mmboB, mmboA,
-                                  swapped_contact);
+            InsertContact(mmboB, mmboA, swapped_contact);
         }
     }
 
     else if (auto mmboA = dynamic_cast<ChContactable_3vars<6, 6, 6>*>(contactableA)) {
         if (auto mmboB = dynamic_cast<ChContactable_1vars<3>*>(contactableB)) {
             // 666_3
-            _OptimalContactInsert(contactlist_666_3, lastcontact_666_3, n_added_666_3, this, mmboA, mmboB, mcontact);
+            InsertContact(mmboA, mmboB, mcontact);
         } else if (auto mmboB = dynamic_cast<ChContactable_1vars<6>*>(contactableB)) {
             // 666_6
-            _OptimalContactInsert(contactlist_666_6, lastcontact_666_6, n_added_666_6, this, mmboA, mmboB, mcontact);
+            InsertContact(mmboA, mmboB, mcontact);
         } else if (auto mmboB = dynamic_cast<ChContactable_3vars<3, 3, 3>*>(contactableB)) {
             // 666_333
-            _OptimalContactInsert(contactlist_666_333, lastcontact_666_333, n_added_666_333, this, mmboA, mmboB,
-                                  mcontact);
+            InsertContact(mmboA, mmboB, mcontact);
         } else if (auto mmboB = dynamic_cast<ChContactable_3vars<6, 6, 6>*>(contactableB)) {
             // 666_666
-            _OptimalContactInsert(contactlist_666_666, lastcontact_666_666, n_added_666_666, this, mmboA, mmboB,
-                                  mcontact);
+            InsertContact(mmboA, mmboB, mcontact);
         }
     }
 
     // ***TODO*** Fallback to some dynamic-size allocated constraint for cases that were not trapped by the switch
 }
 
-void ChContactContainerNSC::ComputeContactForces() {
-    contact_forces.clear();
-    SumAllContactForces(contactlist_3_3, contact_forces);
-    SumAllContactForces(contactlist_6_3, contact_forces);
-    SumAllContactForces(contactlist_6_6, contact_forces);
-    SumAllContactForces(contactlist_333_3, contact_forces);
-    SumAllContactForces(contactlist_333_6, contact_forces);
-    SumAllContactForces(contactlist_333_333, contact_forces);
-    SumAllContactForces(contactlist_666_3, contact_forces);
-    SumAllContactForces(contactlist_666_6, contact_forces);
-    SumAllContactForces(contactlist_666_333, contact_forces);
-    SumAllContactForces(contactlist_666_666, contact_forces);
-    SumAllContactForces(contactlist_6_6_rolling, contact_forces);
+void ChContactContainerNSC::InsertContact(ChContactable_1vars<6>* objA,
+                                          ChContactable_1vars<6>* objB,
+                                          const collision::ChCollisionInfo& cinfo) {
+    _OptimalContactInsert(contactlist_6_6, lastcontact_6_6, n_added_6_6, this, objA, objB, cinfo);
 }
 
-template <class Tcont>
-void _ReportAllContacts(std::list<Tcont*>& contactlist, ChContactContainer::ReportContactCallback* mcallback) {
-    typename std::list<Tcont*>::iterator itercontact = contactlist.begin();
-    while (itercontact != contactlist.end()) {
-        bool proceed = mcallback->OnReportContact(
-            (*itercontact)->GetContactP1(), (*itercontact)->GetContactP2(), (*itercontact)->GetContactPlane(),
-            (*itercontact)->GetContactDistance(), (*itercontact)->GetContactForce(),
-            VNULL,  // no react torques
-            (*itercontact)->GetObjA(), (*itercontact)->GetObjB());
-        if (!proceed)
-            break;
-        ++itercontact;
-    }
+void ChContactContainerNSC::InsertContact(ChContactable_1vars<6>* objA,
+                                          ChContactable_1vars<3>* objB,
+                                          const collision::ChCollisionInfo& cinfo) {
+    _OptimalContactInsert(contactlist_6_3, lastcontact_6_3, n_added_6_3, this, objA, objB, cinfo);
 }
 
-template <class Tcont>
-void _ReportAllContactsRolling(std::list<Tcont*>& contactlist, ChContactContainer::ReportContactCallback* mcallback) {
-    typename std::list<Tcont*>::iterator itercontact = contactlist.begin();
-    while (itercontact != contactlist.end()) {
-        bool proceed = mcallback->OnReportContact(
-            (*itercontact)->GetContactP1(), (*itercontact)->GetContactP2(), (*itercontact)->GetContactPlane(),
-            (*itercontact)->GetContactDistance(), (*itercontact)->GetContactForce(), (*itercontact)->GetContactTorque(),
-            (*itercontact)->GetObjA(), (*itercontact)->GetObjB());
-        if (!proceed)
-            break;
-        ++itercontact;
-    }
+void ChContactContainerNSC::InsertContact(ChContactable_1vars<3>* objA,
+                                          ChContactable_1vars<3>* objB,
+                                          const collision::ChCollisionInfo& cinfo) {
+    _OptimalContactInsert(contactlist_3_3, lastcontact_3_3, n_added_3_3, this, objA, objB, cinfo);
 }
 
-void ChContactContainerNSC::ReportAllContacts(ReportContactCallback* mcallback) {
-    _ReportAllContacts(contactlist_6_6, mcallback);
-    _ReportAllContacts(contactlist_6_3, mcallback);
-    _ReportAllContacts(contactlist_3_3, mcallback);
-    _ReportAllContacts(contactlist_333_3, mcallback);
-    _ReportAllContacts(contactlist_333_6, mcallback);
-    _ReportAllContacts(contactlist_333_333, mcallback);
-    _ReportAllContacts(contactlist_666_3, mcallback);
-    _ReportAllContacts(contactlist_666_6, mcallback);
-    _ReportAllContacts(contactlist_666_333, mcallback);
-    _ReportAllContacts(contactlist_666_666, mcallback);
-    _ReportAllContactsRolling(contactlist_6_6_rolling, mcallback);
+void ChContactContainerNSC::InsertContact(ChContactable_3vars<3, 3, 3>* objA,
+                                          ChContactable_1vars<3>* objB,
+                                          const collision::ChCollisionInfo& cinfo) {
+    _OptimalContactInsert(contactlist_333_3, lastcontact_333_3, n_added_333_3, this, objA, objB, cinfo);
 }
 
-////////// STATE INTERFACE ////
+void ChContactContainerNSC::InsertContact(ChContactable_3vars<3, 3, 3>* objA,
+                                          ChContactable_1vars<6>* objB,
+                                          const collision::ChCollisionInfo& cinfo) {
+    _OptimalContactInsert(contactlist_333_6, lastcontact_333_6, n_added_333_6, this, objA, objB, cinfo);
+}
+
+void ChContactContainerNSC::InsertContact(ChContactable_3vars<3, 3, 3>* objA,
+                                          ChContactable_3vars<3, 3, 3>* objB,
+                                          const collision::ChCollisionInfo& cinfo) {
+    _OptimalContactInsert(contactlist_333_333, lastcontact_333_333, n_added_333_333, this, objA, objB, cinfo);
+}
+
+void ChContactContainerNSC::InsertContact(ChContactable_3vars<6, 6, 6>* objA,
+                                          ChContactable_1vars<3>* objB,
+                                          const collision::ChCollisionInfo& cinfo) {
+    _OptimalContactInsert(contactlist_666_3, lastcontact_666_3, n_added_666_3, this, objA, objB, cinfo);
+}
+
+void ChContactContainerNSC::InsertContact(ChContactable_3vars<6, 6, 6>* objA,
+                                          ChContactable_1vars<6>* objB,
+                                          const collision::ChCollisionInfo& cinfo) {
+    _OptimalContactInsert(contactlist_666_6, lastcontact_666_6, n_added_666_6, this, objA, objB, cinfo);
+}
+
+void ChContactContainerNSC::InsertContact(ChContactable_3vars<6, 6, 6>* objA,
+                                          ChContactable_3vars<3, 3, 3>* objB,
+                                          const collision::ChCollisionInfo& cinfo) {
+    _OptimalContactInsert(contactlist_666_333, lastcontact_666_333, n_added_666_333, this, objA, objB, cinfo);
+}
+
+void ChContactContainerNSC::InsertContact(ChContactable_3vars<6, 6, 6>* objA,
+                                          ChContactable_3vars<6, 6, 6>* objB,
+                                          const collision::ChCollisionInfo& cinfo) {
+    _OptimalContactInsert(contactlist_666_666, lastcontact_666_666, n_added_666_666, this, objA, objB, cinfo);
+}
+
+void ChContactContainerNSC::InsertContactRolling(ChContactable_1vars<6>* objA,
+                                                 ChContactable_1vars<6>* objB,
+                                                 const collision::ChCollisionInfo& cinfo) {
+    _OptimalContactInsert(contactlist_6_6_rolling, lastcontact_6_6_rolling, n_added_6_6_rolling, this, objA, objB,
+                          cinfo);
+}
 
 template <class Tcont>
-void _IntStateGatherReactions(unsigned int& coffset,
-                              std::list<Tcont*>& contactlist,
-                              const unsigned int off_L,
-                              ChVectorDynamic<>& L,
-                              const int stride) {
-    typename std::list<Tcont*>::iterator itercontact = contactlist.begin();
-    while (itercontact != contactlist.end()) {
-        (*itercontact)->ContIntStateGatherReactions(off_L + coffset, L);
-        coffset += stride;
-        ++itercontact;
+void _VisitContacts(std::list<Tcont*>& contactlist, ChContactContainerNSC::ContactVisitor& visitor, int stride) {
+    for (auto contact : contactlist)
+        visitor.Visit(*contact, stride);
+}
+
+void ChContactContainerNSC::VisitContacts(ContactVisitor& visitor) {
+    _VisitContacts(contactlist_6_6, visitor, 3);
+    _VisitContacts(contactlist_6_3, visitor, 3);
+    _VisitContacts(contactlist_3_3, visitor, 3);
+    _VisitContacts(contactlist_333_3, visitor, 3);
+    _VisitContacts(contactlist_333_6, visitor, 3);
+    _VisitContacts(contactlist_333_333, visitor, 3);
+    _VisitContacts(contactlist_666_3, visitor, 3);
+    _VisitContacts(contactlist_666_6, visitor, 3);
+    _VisitContacts(contactlist_666_333, visitor, 3);
+    _VisitContacts(contactlist_666_666, visitor, 3);
+    _VisitContacts(contactlist_6_6_rolling, visitor, 6);
+}
+
+template <class Tcont, class F>
+void _ForEachContact(std::list<Tcont*>& contactlist, F& f, int stride) {
+    for (auto contact : contactlist)
+        f(*contact, stride);
+}
+
+template <class F>
+void ChContactContainerNSC::ForEachContact(F f) {
+    if (!custom_storage) {
+        _ForEachContact(contactlist_6_6, f, 3);
+        _ForEachContact(contactlist_6_3, f, 3);
+        _ForEachContact(contactlist_3_3, f, 3);
+        _ForEachContact(contactlist_333_3, f, 3);
+        _ForEachContact(contactlist_333_6, f, 3);
+        _ForEachContact(contactlist_333_333, f, 3);
+        _ForEachContact(contactlist_666_3, f, 3);
+        _ForEachContact(contactlist_666_6, f, 3);
+        _ForEachContact(contactlist_666_333, f, 3);
+        _ForEachContact(contactlist_666_666, f, 3);
+        _ForEachContact(contactlist_6_6_rolling, f, 6);
+        return;
     }
+
+    class Visitor : public ContactVisitor {
+      public:
+        Visitor(F& f) : m_f(f) {}
+        virtual void Visit(ChContactNSC_6_6& contact, int stride) override { m_f(contact, stride); }
+        virtual void Visit(ChContactNSC_6_3& contact, int stride) override { m_f(contact, stride); }
+        virtual void Visit(ChContactNSC_3_3& contact, int stride) override { m_f(contact, stride); }
+        virtual void Visit(ChContactNSC_333_3& contact, int stride) override { m_f(contact, stride); }
+        virtual void Visit(ChContactNSC_333_6& contact, int stride) override { m_f(contact, stride); }
+        virtual void Visit(ChContactNSC_333_333& contact, int stride) override { m_f(contact, stride); }
+        virtual void Visit(ChContactNSC_666_3& contact, int stride) override { m_f(contact, stride); }
+        virtual void Visit(ChContactNSC_666_6& contact, int stride) override { m_f(contact, stride); }
+        virtual void Visit(ChContactNSC_666_333& contact, int stride) override { m_f(contact, stride); }
+        virtual void Visit(ChContactNSC_666_666& contact, int stride) override { m_f(contact, stride); }
+        virtual void Visit(ChContactNSCrolling_6_6& contact, int stride) override { m_f(contact, stride); }
+
+      private:
+        F& m_f;
+    };
+
+    Visitor visitor(f);
+    VisitContacts(visitor);
 }
 
-void ChContactContainerNSC::IntStateGatherReactions(const unsigned int off_L, ChVectorDynamic<>& L) {
-    unsigned int coffset = 0;
-    _IntStateGatherReactions(coffset, contactlist_6_6, off_L, L, 3);
-    _IntStateGatherReactions(coffset, contactlist_6_3, off_L, L, 3);
-    _IntStateGatherReactions(coffset, contactlist_3_3, off_L, L, 3);
-    _IntStateGatherReactions(coffset, contactlist_333_3, off_L, L, 3);
-    _IntStateGatherReactions(coffset, contactlist_333_6, off_L, L, 3);
-    _IntStateGatherReactions(coffset, contactlist_333_333, off_L, L, 3);
-    _IntStateGatherReactions(coffset, contactlist_666_3, off_L, L, 3);
-    _IntStateGatherReactions(coffset, contactlist_666_6, off_L, L, 3);
-    _IntStateGatherReactions(coffset, contactlist_666_333, off_L, L, 3);
-    _IntStateGatherReactions(coffset, contactlist_666_666, off_L, L, 3);
-    _IntStateGatherReactions(coffset, contactlist_6_6_rolling, off_L, L, 6);
+void ChContactContainerNSC::ComputeContactForces() {
+    contact_forces.clear();
+    ForEachContact([this](auto& contact, int stride) { AccumulateContactForce(contact, contact_forces); });
 }
 
+// React torques are only available for contacts with rolling friction.
 template <class Tcont>
-void _IntStateScatterReactions(unsigned int& coffset,
-                               std::list<Tcont*>& contactlist,
-                               const unsigned int off_L,
-                               const ChVectorDynamic<>& L,
-                               const int stride) {
-    typename std::list<Tcont*>::iterator itercontact = contactlist.begin();
-    while (itercontact != contactlist.end()) {
-        (*itercontact)->ContIntStateScatterReactions(off_L + coffset, L);
-        coffset += stride;
-        ++itercontact;
-    }
+ChVector<> _GetContactTorque(Tcont& contact) {
+    return VNULL;
 }
 
-void ChContactContainerNSC::IntStateScatterReactions(const unsigned int off_L, const ChVectorDynamic<>& L) {
+ChVector<> _GetContactTorque(ChContactContainerNSC::ChContactNSCrolling_6_6& contact) {
+    return contact.GetContactTorque();
+}
+
+void ChContactContainerNSC::ReportAllContacts(ReportContactCallback* mcallback) {
+    bool proceed = true;
+    ForEachContact([&](auto& contact, int stride) {
+        if (proceed) {
+            proceed = mcallback->OnReportContact(contact.GetContactP1(), contact.GetContactP2(),
+                                                 contact.GetContactPlane(), contact.GetContactDistance(),
+                                                 contact.GetContactForce(), _GetContactTorque(contact),
+                                                 contact.GetObjA(), contact.GetObjB());
+        }
+    });
+}
+
+////////// STATE INTERFACE ////
+
+void ChContactContainerNSC::IntStateGatherReactions(const unsigned int off_L, ChVectorDynamic<>& L) {
     unsigned int coffset = 0;
-    _IntStateScatterReactions(coffset, contactlist_6_6, off_L, L, 3);
-    _IntStateScatterReactions(coffset, contactlist_6_3, off_L, L, 3);
-    _IntStateScatterReactions(coffset, contactlist_3_3, off_L, L, 3);
-    _IntStateScatterReactions(coffset, contactlist_333_3, off_L, L, 3);
-    _IntStateScatterReactions(coffset, contactlist_333_6, off_L, L, 3);
-    _IntStateScatterReactions(coffset, contactlist_333_333, off_L, L, 3);
-    _IntStateScatterReactions(coffset, contactlist_666_3, off_L, L, 3);
-    _IntStateScatterReactions(coffset, contactlist_666_6, off_L, L, 3);
-    _IntStateScatterReactions(coffset, contactlist_666_333, off_L, L, 3);
-    _IntStateScatterReactions(coffset, contactlist_666_666, off_L, L, 3);
-    _IntStateScatterReactions(coffset, contactlist_6_6_rolling, off_L, L, 6);
+    ForEachContact([&](auto& contact, int stride) {
+        contact.ContIntStateGatherReactions(off_L + coffset, L);
+        coffset += stride;
+    });
 }
 
-template <class Tcont>
-void _IntLoadResidual_CqL(unsigned int& coffset,           ///< offset of the contacts
-                          std::list<Tcont*>& contactlist,  ///< list of contacts
-                          const unsigned int off_L,        ///< offset in L multipliers
-                          ChVectorDynamic<>& R,            ///< result: the R residual, R += c*Cq'*L
-                          const ChVectorDynamic<>& L,      ///< the L vector
-                          const double c,                  ///< a scaling factor
-                          const int stride                 ///< stride
-) {
-    typename std::list<Tcont*>::iterator itercontact = contactlist.begin();
-    while (itercontact != contactlist.end()) {
-        (*itercontact)->ContIntLoadResidual_CqL(off_L + coffset, R, L, c);
+void ChContactContainerNSC::IntStateScatterReactions(const unsigned int off_L, const ChVectorDynamic<>& L) {
+    unsigned int coffset = 0;
+    ForEachContact([&](auto& contact, int stride) {
+        contact.ContIntStateScatterReactions(off_L + coffset, L);
         coffset += stride;
-        ++itercontact;
-    }
+    });
 }
 
 void ChContactContainerNSC::IntLoadResidual_CqL(const unsigned int off_L,
@@ -488,35 +490,10 @@ void ChContactContainerNSC::IntLoadResidual_CqL(const unsigned int off_L,
                                                 const ChVectorDynamic<>& L,
                                                 const double c) {
     unsigned int coffset = 0;
-    _IntLoadResidual_CqL(coffset, contactlist_6_6, off_L, R, L, c, 3);
-    _IntLoadResidual_CqL(coffset, contactlist_6_3, off_L, R, L, c, 3);
-    _IntLoadResidual_CqL(coffset, contactlist_3_3, off_L, R, L, c, 3);
-    _IntLoadResidual_CqL(coffset, contactlist_333_3, off_L, R, L, c, 3);
-    _IntLoadResidual_CqL(coffset, contactlist_333_6, off_L, R, L, c, 3);
-    _IntLoadResidual_CqL(coffset, contactlist_333_333, off_L, R, L, c, 3);
-    _IntLoadResidual_CqL(coffset, contactlist_666_3, off_L, R, L, c, 3);
-    _IntLoadResidual_CqL(coffset, contactlist_666_6, off_L, R, L, c, 3);
-    _IntLoadResidual_CqL(coffset, contactlist_666_333, off_L, R, L, c, 3);
-    _IntLoadResidual_CqL(coffset, contactlist_666_666, off_L, R, L, c, 3);
-    _IntLoadResidual_CqL(coffset, contactlist_6_6_rolling, off_L, R, L, c, 6);
-}
-
-template <class Tcont>
-void _IntLoadConstraint_C(unsigned int& coffset,           ///< contact offset
-                          std::list<Tcont*>& contactlist,  ///< contact list
-                          const unsigned int off,          ///< offset in Qc residual
-                          ChVectorDynamic<>& Qc,           ///< result: the Qc residual, Qc += c*C
-                          const double c,                  ///< a scaling factor
-                          bool do_clamp,                   ///< apply clamping to c*C?
-                          double recovery_clamp,           ///< value for min/max clamping of c*C
-                          const int stride                 ///< stride
-) {
-    typename std::list<Tcont*>::iterator itercontact = contactlist.begin();
-    while (itercontact != contactlist.end()) {
-        (*itercontact)->ContIntLoadConstraint_C(off + coffset, Qc, c, do_clamp, recovery_clamp);
+    ForEachContact([&](auto& contact, int stride) {
+        contact.ContIntLoadResidual_CqL(off_L + coffset, R, L, c);
         coffset += stride;
-        ++itercontact;
-    }
+    });
 }
 
 void ChContactContainerNSC::IntLoadConstraint_C(const unsigned int off,
@@ -525,35 +502,10 @@ void ChContactContainerNSC::IntLoadConstraint_C(const unsigned int off,
                                                 bool do_clamp,
                                                 double recovery_clamp) {
     unsigned int coffset = 0;
-    _IntLoadConstraint_C(coffset, contactlist_6_6, off, Qc, c, do_clamp, recovery_clamp, 3);
-    _IntLoadConstraint_C(coffset, contactlist_6_3, off, Qc, c, do_clamp, recovery_clamp, 3);
-    _IntLoadConstraint_C(coffset, contactlist_3_3, off, Qc, c, do_clamp, recovery_clamp, 3);
-    _IntLoadConstraint_C(coffset, contactlist_333_3, off, Qc, c, do_clamp, recovery_clamp, 3);
-    _IntLoadConstraint_C(coffset, contactlist_333_6, off, Qc, c, do_clamp, recovery_clamp, 3);
-    _IntLoadConstraint_C(coffset, contactlist_333_333, off, Qc, c, do_clamp, recovery_clamp, 3);
-    _IntLoadConstraint_C(coffset, contactlist_666_3, off, Qc, c, do_clamp, recovery_clamp, 3);
-    _IntLoadConstraint_C(coffset, contactlist_666_6, off, Qc, c, do_clamp, recovery_clamp, 3);
-    _IntLoadConstraint_C(coffset, contactlist_666_333, off, Qc, c, do_clamp, recovery_clamp, 3);
-    _IntLoadConstraint_C(coffset, contactlist_666_666, off, Qc, c, do_clamp, recovery_clamp, 3);
-    _IntLoadConstraint_C(coffset, contactlist_6_6_rolling, off, Qc, c, do_clamp, recovery_clamp, 6);
-}
-
-template <class Tcont>
-void _IntToDescriptor(unsigned int& coffset,
-                      std::list<Tcont*>& contactlist,
-                      const unsigned int off_v,
-                      const ChStateDelta& v,
-                      const ChVectorDynamic<>& R,
-                      const unsigned int off_L,
-                      const ChVectorDynamic<>& L,
-                      const ChVectorDynamic<>& Qc,
-                      const int stride) {
-    typename std::list<Tcont*>::iterator itercontact = contactlist.begin();
-    while (itercontact != contactlist.end()) {
-        (*itercontact)->ContIntToDescriptor(off_L + coffset, L, Qc);
+    ForEachContact([&](auto& contact, int stride) {
+        contact.ContIntLoadConstraint_C(off + coffset, Qc, c, do_clamp, recovery_clamp);
         coffset += stride;
-        ++itercontact;
-    }
+    });
 }
 
 void ChContactContainerNSC::IntToDescriptor(const unsigned int off_v,
@@ -563,33 +515,10 @@ void ChContactContainerNSC::IntToDescriptor(const unsigned int off_v,
                                             const ChVectorDynamic<>& L,
                                             const ChVectorDynamic<>& Qc) {
     unsigned int coffset = 0;
-    _IntToDescriptor(coffset, contactlist_6_6, off_v, v, R, off_L, L, Qc, 3);
-    _IntToDescriptor(coffset, contactlist_6_3, off_v, v, R, off_L, L, Qc, 3);
-    _IntToDescriptor(coffset, contactlist_3_3, off_v, v, R, off_L, L, Qc, 3);
-    _IntToDescriptor(coffset, contactlist_333_3, off_v, v, R, off_L, L, Qc, 3);
-    _IntToDescriptor(coffset, contactlist_333_6, off_v, v, R, off_L, L, Qc, 3);
-    _IntToDescriptor(coffset, contactlist_333_333, off_v, v, R, off_L, L, Qc, 3);
-    _IntToDescriptor(coffset, contactlist_666_3, off_v, v, R, off_L, L, Qc, 3);
-    _IntToDescriptor(coffset, contactlist_666_6, off_v, v, R, off_L, L, Qc, 3);
-    _IntToDescriptor(coffset, contactlist_666_333, off_v, v, R, off_L, L, Qc, 3);
-    _IntToDescriptor(coffset, contactlist_666_666, off_v, v, R, off_L, L, Qc, 3);
-    _IntToDescriptor(coffset, contactlist_6_6_rolling, off_v, v, R, off_L, L, Qc, 6);
-}
-
-template <class Tcont>
-void _IntFromDescriptor(unsigned int& coffset,
-                        std::list<Tcont*>& contactlist,
-                        const unsigned int off_v,
-                        ChStateDelta& v,
-                        const unsigned int off_L,
-                        ChVectorDynamic<>& L,
-                        const int stride) {
-    typename std::list<Tcont*>::iterator itercontact = contactlist.begin();
-    while (itercontact != contactlist.end()) {
-        (*itercontact)->ContIntFromDescriptor(off_L + coffset, L);
+    ForEachContact([&](auto& contact, int stride) {
+        contact.ContIntToDescriptor(off_L + coffset, L, Qc);
         coffset += stride;
-        ++itercontact;
-    }
+    });
 }
 
 void ChContactContainerNSC::IntFromDescriptor(const unsigned int off_v,
@@ -597,116 +526,34 @@ void ChContactContainerNSC::IntFromDescriptor(const unsigned int off_v,
                                               const unsigned int off_L,
                                               ChVectorDynamic<>& L) {
     unsigned int coffset = 0;
-    _IntFromDescriptor(coffset, contactlist_6_6, off_v, v, off_L, L, 3);
-    _IntFromDescriptor(coffset, contactlist_6_3, off_v, v, off_L, L, 3);
-    _IntFromDescriptor(coffset, contactlist_3_3, off_v, v, off_L, L, 3);
-    _IntFromDescriptor(coffset, contactlist_333_3, off_v, v, off_L, L, 3);
-    _IntFromDescriptor(coffset, contactlist_333_6, off_v, v, off_L, L, 3);
-    _IntFromDescriptor(coffset, contactlist_333_333, off_v, v, off_L, L, 3);
-    _IntFromDescriptor(coffset, contactlist_666_3, off_v, v, off_L, L, 3);
-    _IntFromDescriptor(coffset, contactlist_666_6, off_v, v, off_L, L, 3);
-    _IntFromDescriptor(coffset, contactlist_666_333, off_v, v, off_L, L, 3);
-    _IntFromDescriptor(coffset, contactlist_666_666, off_v, v, off_L, L, 3);
-    _IntFromDescriptor(coffset, contactlist_6_6_rolling, off_v, v, off_L, L, 6);
+    ForEachContact([&](auto& contact, int stride) {
+        contact.ContIntFromDescriptor(off_L + coffset, L);
+        coffset += stride;
+    });
 }
 
 // SOLVER INTERFACES
 
-template <class Tcont>
-void _InjectConstraints(std::list<Tcont*>& contactlist, ChSystemDescriptor& mdescriptor) {
-    typename std::list<Tcont*>::iterator itercontact = contactlist.begin();
-    while (itercontact != contactlist.end()) {
-        (*itercontact)->InjectConstraints(mdescriptor);
-        ++itercontact;
-    }
-}
-
 void ChContactContainerNSC::InjectConstraints(ChSystemDescriptor& mdescriptor) {
-    _InjectConstraints(contactlist_6_6, mdescriptor);
-    _InjectConstraints(contactlist_6_3, mdescriptor);
-    _InjectConstraints(contactlist_3_3, mdescriptor);
-    _InjectConstraints(contactlist_333_3, mdescriptor);
-    _InjectConstraints(contactlist_333_6, mdescriptor);
-    _InjectConstraints(contactlist_333_333, mdescriptor);
-    _InjectConstraints(contactlist_666_3, mdescriptor);
-    _InjectConstraints(contactlist_666_6, mdescriptor);
-    _InjectConstraints(contactlist_666_333, mdescriptor);
-    _InjectConstraints(contactlist_666_666, mdescriptor);
-    _InjectConstraints(contactlist_6_6_rolling, mdescriptor);
-}
-
-template <class Tcont>
-void _ConstraintsBiReset(std::list<Tcont*>& contactlist) {
-    typename std::list<Tcont*>::iterator itercontact = contactlist.begin();
-    while (itercontact != contactlist.end()) {
-        (*itercontact)->ConstraintsBiReset();
-        ++itercontact;
-    }
+    ForEachContact([&](auto& contact, int stride) { contact.InjectConstraints(mdescriptor); });
 }
 
 void ChContactContainerNSC::ConstraintsBiReset() {
-    _ConstraintsBiReset(contactlist_6_6);
-    _ConstraintsBiReset(contactlist_6_3);
-    _ConstraintsBiReset(contactlist_3_3);
-    _ConstraintsBiReset(contactlist_333_3);
-    _ConstraintsBiReset(contactlist_333_6);
-    _ConstraintsBiReset(contactlist_333_333);
-    _ConstraintsBiReset(contactlist_666_3);
-    _ConstraintsBiReset(contactlist_666_6);
-    _ConstraintsBiReset(contactlist_666_333);
-    _ConstraintsBiReset(contactlist_666_666);
-    _ConstraintsBiReset(contactlist_6_6_rolling);
-}
-
-template <class Tcont>
-void _ConstraintsBiLoad_C(std::list<Tcont*>& contactlist, double factor, double recovery_clamp, bool do_clamp) {
-    typename std::list<Tcont*>::iterator itercontact = contactlist.begin();
-    while (itercontact != contactlist.end()) {
-        (*itercontact)->ConstraintsBiLoad_C(factor, recovery_clamp, do_clamp);
-        ++itercontact;
-    }
+    ForEachContact([](auto& contact, int stride) { contact.ConstraintsBiReset(); });
 }
 
 void ChContactContainerNSC::ConstraintsBiLoad_C(double factor, double recovery_clamp, bool do_clamp) {
-    _ConstraintsBiLoad_C(contactlist_6_6, factor, recovery_clamp, do_clamp);
-    _ConstraintsBiLoad_C(contactlist_6_3, factor, recovery_clamp, do_clamp);
-    _ConstraintsBiLoad_C(contactlist_3_3, factor, recovery_clamp, do_clamp);
-    _ConstraintsBiLoad_C(contactlist_333_3, factor, recovery_clamp, do_clamp);
-    _ConstraintsBiLoad_C(contactlist_333_6, factor, recovery_clamp, do_clamp);
-    _ConstraintsBiLoad_C(contactlist_333_333, factor, recovery_clamp, do_clamp);
-    _ConstraintsBiLoad_C(contactlist_666_3, factor, recovery_clamp, do_clamp);
-    _ConstraintsBiLoad_C(contactlist_666_6, factor, recovery_clamp, do_clamp);
-    _ConstraintsBiLoad_C(contactlist_666_333, factor, recovery_clamp, do_clamp);
-    _ConstraintsBiLoad_C(contactlist_666_666, factor, recovery_clamp, do_clamp);
-    _ConstraintsBiLoad_C(contactlist_6_6_rolling, factor, recovery_clamp, do_clamp);
+    ForEachContact(
+        [&](auto& contact, int stride) { contact.ConstraintsBiLoad_C(factor, recovery_clamp, do_clamp); });
 }
 
 void ChContactContainerNSC::ConstraintsLoadJacobians() {
     // already loaded when contact objects are created
 }
 
-template <class Tcont>
-void _ConstraintsFetch_react(std::list<Tcont*>& contactlist, double factor) {
-    // From constraints to react vector:
-    typename std::list<Tcont*>::iterator itercontact = contactlist.begin();
-    while (itercontact != contactlist.end()) {
-        (*itercontact)->ConstraintsFetch_react(factor);
-        ++itercontact;
-    }
-}
-
 void ChContactContainerNSC::ConstraintsFetch_react(double factor) {
-    _ConstraintsFetch_react(contactlist_6_6, factor);
-    _ConstraintsFetch_react(contactlist_6_3, factor);
-    _ConstraintsFetch_react(contactlist_3_3, factor);
-    _ConstraintsFetch_react(contactlist_333_3, factor);
-    _ConstraintsFetch_react(contactlist_333_6, factor);
-    _ConstraintsFetch_react(contactlist_333_333, factor);
-    _ConstraintsFetch_react(contactlist_666_3, factor);
-    _ConstraintsFetch_react(contactlist_666_6, factor);
-    _ConstraintsFetch_react(contactlist_666_333, factor);
-    _ConstraintsFetch_react(contactlist_666_666, factor);
-    _ConstraintsFetch_react(contactlist_6_6_rolling, factor);
+    // From constraints to react vector:
+    ForEachContact([&](auto& contact, int stride) { contact.ConstraintsFetch_react(factor); });
 }
 
 void ChContactContainerNSC::ArchiveOUT(ChArchiveOut& marchive) {
@@ -46,6 +46,25 @@ class ChApi ChContactContainerNSC : public ChContactContainer {
 
     typedef ChContactNSCrolling<ChContactable_1vars<6>, ChContactable_1vars<6> > ChContactNSCrolling_6_6;
 
+    /// Interface for an operation applied to each contact of the container (see VisitContacts()),
+    /// with one function per contact type. The stride is the number of constraints of the contact.
+    class ChApi ContactVisitor {
+      public:
+        virtual ~ContactVisitor() {}
+
+        virtual void Visit(ChContactNSC_6_6& contact, int stride) = 0;
+        virtual void Visit(ChContactNSC_6_3& contact, int stride) = 0;
+        virtual void Visit(ChContactNSC_3_3& contact, int stride) = 0;
+        virtual void Visit(ChContactNSC_333_3& contact, int stride) = 0;
+        virtual void Visit(ChContactNSC_333_6& contact, int stride) = 0;
+        virtual void Visit(ChContactNSC_333_333& contact, int stride) = 0;
+        virtual void Visit(ChContactNSC_666_3& contact, int stride) = 0;
+        virtual void Visit(ChContactNSC_666_6& contact, int stride) = 0;
+        virtual void Visit(ChContactNSC_666_333& contact, int stride) = 0;
+        virtual void Visit(ChContactNSC_666_666& contact, int stride) = 0;
+        virtual void Visit(ChContactNSCrolling_6_6& contact, int stride) = 0;
+    };
+
   protected:
     std::list<ChContactNSC_6_6*> contactlist_6_6;
     std::list<ChContactNSC_6_3*> contactlist_6_3;
@@ -85,6 +104,8 @@ class ChApi ChContactContainerNSC : public ChContactContainer {
 
     std::list<ChContactNSCrolling_6_6*>::iterator lastcontact_6_6_rolling;
 
+    bool custom_storage;  ///< contacts are stored by a derived class and reached only through VisitContacts()
+
   public:
     ChContactContainerNSC();
     ChContactContainerNSC(const ChContactContainerNSC& other);
@@ -181,6 +202,60 @@ class ChApi ChContactContainerNSC : public ChContactContainer {
 
     /// Method to allow de-serialization of transient data from archives.
     virtual void ArchiveIN(ChArchiveIn& marchive) override;
+
+  protected:
+    //
+    // CONTACT STORAGE
+    //
+    // AddContact() selects the contact type and calls the InsertContact() function for that type, with the
+    // contactable objects in the order of the contact type. The state and solver functions loop directly over
+    // the contact lists of this class. Derived classes that store contacts differently override InsertContact()
+    // and VisitContacts() (and BeginAddContact(), EndAddContact(), RemoveAllContacts()) and set custom_storage,
+    // so that these functions traverse the contacts with VisitContacts() instead.
+
+    virtual void InsertContact(ChContactable_1vars<6>* objA,
+                               ChContactable_1vars<6>* objB,
+                               const collision::ChCollisionInfo& cinfo);
+    virtual void InsertContact(ChContactable_1vars<6>* objA,
+                               ChContactable_1vars<3>* objB,
+                               const collision::ChCollisionInfo& cinfo);
+    virtual void InsertContact(ChContactable_1vars<3>* objA,
+                               ChContactable_1vars<3>* objB,
+                               const collision::ChCollisionInfo& cinfo);
+    virtual void InsertContact(ChContactable_3vars<3, 3, 3>* objA,
+                               ChContactable_1vars<3>* objB,
+                               const collision::ChCollisionInfo& cinfo);
+    virtual void InsertContact(ChContactable_3vars<3, 3, 3>* objA,
+                               ChContactable_1vars<6>* objB,
+                               const collision::ChCollisionInfo& cinfo);
+    virtual void InsertContact(ChContactable_3vars<3, 3, 3>* objA,
+                               ChContactable_3vars<3, 3, 3>* objB,
+                               const collision::ChCollisionInfo& cinfo);
+    virtual void InsertContact(ChContactable_3vars<6, 6, 6>* objA,
+                               ChContactable_1vars<3>* objB,
+                               const collision::ChCollisionInfo& cinfo);
+    virtual void InsertContact(ChContactable_3vars<6, 6, 6>* objA,
+                               ChContactable_1vars<6>* objB,
+                               const collision::ChCollisionInfo& cinfo);
+    virtual void InsertContact(ChContactable_3vars<6, 6, 6>* objA,
+                               ChContactable_3vars<3, 3, 3>* objB,
+                               const collision::ChCollisionInfo& cinfo);
+    virtual void InsertContact(ChContactable_3vars<6, 6, 6>* objA,
+                               ChContactable_3vars<6, 6, 6>* objB,
+                               const collision::ChCollisionInfo& cinfo);
+
+    /// Insert a 6_6 contact with rolling and/or spinning friction.
+    virtual void InsertContactRolling(ChContactable_1vars<6>* objA,
+                                      ChContactable_1vars<6>* objB,
+                                      const collision::ChCollisionInfo& cinfo);
+
+    /// Apply the visitor to all contacts, in the order in which their constraints are stored.
+    virtual void VisitContacts(ContactVisitor& visitor);
+
+  private:
+    /// Call f(contact, stride) for each contact, through VisitContacts() only if custom_storage is set.
+    template <class F>
+    void ForEachContact(F f);
 };
 
 CH_CLASS_VERSION(ChContactContainerNSC, 0)
@@ -0,0 +1,177 @@
+// =============================================================================
+// PROJECT CHRONO - http://projectchrono.org
+//
+// Copyright (c) 2014 projectchrono.org
+// All rights reserved.
+//
+// Use of this source code is governed by a BSD-style license that can be found
+// in the LICENSE file at the top level of the distribution and at
+// http://projectchrono.org/license-chrono.txt.
+//
+// =============================================================================
+
+#include "chrono/physics/ChContactContainerNSCpooled.h"
+#include "chrono/physics/ChSystem.h"
+
+namespace chrono {
+
+using namespace collision;
+using namespace geometry;
+
+// Register into the object factory, to enable run-time dynamic creation and persistence
+CH_FACTORY_REGISTER(ChContactContainerNSCpooled)
+
+void ChContactContainerNSCpooled::RemoveAllContacts() {
+    ChContactContainerNSC::RemoveAllContacts();
+
+    contactpool_6_6.Clear();
+    contactpool_6_3.Clear();
+    contactpool_3_3.Clear();
+    contactpool_333_3.Clear();
+    contactpool_333_6.Clear();
+    contactpool_333_333.Clear();
+    contactpool_666_3.Clear();
+    contactpool_666_6.Clear();
+    contactpool_666_333.Clear();
+    contactpool_666_666.Clear();
+    contactpool_6_6_rolling.Clear();
+}
+
+void ChContactContainerNSCpooled::BeginAddContact() {
+    ChContactContainerNSC::BeginAddContact();
+
+    contactpool_6_6.Rewind();
+    contactpool_6_3.Rewind();
+    contactpool_3_3.Rewind();
+    contactpool_333_3.Rewind();
+    contactpool_333_6.Rewind();
+    contactpool_333_333.Rewind();
+    contactpool_666_3.Rewind();
+    contactpool_666_6.Rewind();
+    contactpool_666_333.Rewind();
+    contactpool_666_666.Rewind();
+    contactpool_6_6_rolling.Rewind();
+}
+
+void ChContactContainerNSCpooled::EndAddContact() {
+    // unused contacts beyond the last one are kept in the pools, for reuse at the next step
+    n_added_6_6 = (int)contactpool_6_6.size();
+    n_added_6_3 = (int)contactpool_6_3.size();
+    n_added_3_3 = (int)contactpool_3_3.size();
+    n_added_333_3 = (int)contactpool_333_3.size();
+    n_added_333_6 = (int)contactpool_333_6.size();
+    n_added_333_333 = (int)contactpool_333_333.size();
+    n_added_666_3 = (int)contactpool_666_3.size();
+    n_added_666_6 = (int)contactpool_666_6.size();
+    n_added_666_333 = (int)contactpool_666_333.size();
+    n_added_666_666 = (int)contactpool_666_666.size();
+    n_added_6_6_rolling = (int)contactpool_6_6_rolling.size();
+}
+
+void ChContactContainerNSCpooled::InsertContact(ChContactable_1vars<6>* objA,
+                                                ChContactable_1vars<6>* objB,
+                                                const collision::ChCollisionInfo& cinfo) {
+    contactpool_6_6.Add(this, objA, objB, cinfo);
+}
+
+void ChContactContainerNSCpooled::InsertContact(ChContactable_1vars<6>* objA,
+                                                ChContactable_1vars<3>* objB,
+                                                const collision::ChCollisionInfo& cinfo) {
+    contactpool_6_3.Add(this, objA, objB, cinfo);
+}
+
+void ChContactContainerNSCpooled::InsertContact(ChContactable_1vars<3>* objA,
+                                                ChContactable_1vars<3>* objB,
+                                                const collision::ChCollisionInfo& cinfo) {
+    contactpool_3_3.Add(this, objA, objB, cinfo);
+}
+
+void ChContactContainerNSCpooled::InsertContact(ChContactable_3vars<3, 3, 3>* objA,
+                                                ChContactable_1vars<3>* objB,
+                                                const collision::ChCollisionInfo& cinfo) {
+    contactpool_333_3.Add(this, objA, objB, cinfo);
+}
+
+void ChContactContainerNSCpooled::InsertContact(ChContactable_3vars<3, 3, 3>* objA,
+                                                ChContactable_1vars<6>* objB,
+                                                const collision::ChCollisionInfo& cinfo) {
+    contactpool_333_6.Add(this, objA, objB, cinfo);
+}
+
+void ChContactContainerNSCpooled::InsertContact(ChContactable_3vars<3, 3, 3>* objA,
+                                                ChContactable_3vars<3, 3, 3>* objB,
+                                                const collision::ChCollisionInfo& cinfo) {
+    contactpool_333_333.Add(this, objA, objB, cinfo);
+}
+
+void ChContactContainerNSCpooled::InsertContact(ChContactable_3vars<6, 6, 6>* objA,
+                                                ChContactable_1vars<3>* objB,
+                                                const collision::ChCollisionInfo& cinfo) {
+    contactpool_666_3.Add(this, objA, objB, cinfo);
+}
+
+void ChContactContainerNSCpooled::InsertContact(ChContactable_3vars<6, 6, 6>* objA,
+                                                ChContactable_1vars<6>* objB,
+                                                const collision::ChCollisionInfo& cinfo) {
+    contactpool_666_6.Add(this, objA, objB, cinfo);
+}
+
+void ChContactContainerNSCpooled::InsertContact(ChContactable_3vars<6, 6, 6>* objA,
+                                                ChContactable_3vars<3, 3, 3>* objB,
+                                                const collision::ChCollisionInfo& cinfo) {
+    contactpool_666_333.Add(this, objA, objB, cinfo);
+}
+
+void ChContactContainerNSCpooled::InsertContact(ChContactable_3vars<6, 6, 6>* objA,
+                                                ChContactable_3vars<6, 6, 6>* objB,
+                                                const collision::ChCollisionInfo& cinfo) {
+    contactpool_666_666.Add(this, objA, objB, cinfo);
+}
+
+void ChContactContainerNSCpooled::InsertContactRolling(ChContactable_1vars<6>* objA,
+                                                       ChContactable_1vars<6>* objB,
+                                                       const collision::ChCollisionInfo& cinfo) {
+    contactpool_6_6_rolling.Add(this, objA, objB, cinfo);
+}
+
+template <class Tcont>
+void _VisitContacts(ChContactPool<Tcont>& contactpool, ChContactContainerNSC::ContactVisitor& visitor, int stride) {
+    for (size_t i = 0; i < contactpool.size(); i++)
+        visitor.Visit(contactpool[i], stride);
+}
+
+void ChContactContainerNSCpooled::VisitContacts(ContactVisitor& visitor) {
+    _VisitContacts(contactpool_6_6, visitor, 3);
+    _VisitContacts(contactpool_6_3, visitor, 3);
+    _VisitContacts(contactpool_3_3, visitor, 3);
+    _VisitContacts(contactpool_333_3, visitor, 3);
+    _VisitContacts(contactpool_333_6, visitor, 3);
+    _VisitContacts(contactpool_333_333, visitor, 3);
+    _VisitContacts(contactpool_666_3, visitor, 3);
+    _VisitContacts(contactpool_666_6, visitor, 3);
+    _VisitContacts(contactpool_666_333, visitor, 3);
+    _VisitContacts(contactpool_666_666, visitor, 3);
+    _VisitContacts(contactpool_6_6_rolling, visitor, 6);
+}
+
+void ChContactContainerNSCpooled::ArchiveOUT(ChArchiveOut& marchive) {
+    // version number
+    marchive.VersionWrite<ChContactContainerNSCpooled>();
+    // serialize parent class
+    ChContactContainerNSC::ArchiveOUT(marchive);
+    // serialize all member data:
+    // NO SERIALIZATION of contact pools because assume they are volatile and generated when needed
+}
+
+/// Method to allow de serialization of transient data from archives.
+void ChContactContainerNSCpooled::ArchiveIN(ChArchiveIn& marchive) {
+    // version number
+    int version = marchive.VersionRead<ChContactContainerNSCpooled>();
+    // deserialize parent class
+    ChContactContainerNSC::ArchiveIN(marchive);
+    // stream in all member data:
+    RemoveAllContacts();
+    // NO SERIALIZATION of contact pools because assume they are volatile and generated when needed
+}
+
+}  // end namespace chrono
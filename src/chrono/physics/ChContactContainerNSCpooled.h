@@ -0,0 +1,173 @@
+// =============================================================================
+// PROJECT CHRONO - http://projectchrono.org
+//
+// Copyright (c) 2014 projectchrono.org
+// All rights reserved.
+//
+// Use of this source code is governed by a BSD-style license that can be found
+// in the LICENSE file at the top level of the distribution and at
+// http://projectchrono.org/license-chrono.txt.
+//
+// =============================================================================
+
+#ifndef CH_CONTACTCONTAINER_NSC_POOLED_H
+#define CH_CONTACTCONTAINER_NSC_POOLED_H
+
+#include <new>
+#include <vector>
+
+#include "chrono/physics/ChContactContainerNSC.h"
+
+namespace chrono {
+
+/// Storage for contacts of a given type, allocated in contiguous blocks.
+/// Contact objects are constructed in place, reused (through Reset) at the following steps,
+/// and never moved, so that the constraints injected in the system descriptor remain valid.
+/// Memory is only released by Clear().
+template <class Tcont>
+class ChContactPool {
+  public:
+    ChContactPool() : n_used(0), n_constructed(0) {}
+    ~ChContactPool() { Clear(); }
+
+    ChContactPool(const ChContactPool&) = delete;
+    ChContactPool& operator=(const ChContactPool&) = delete;
+
+    /// Number of contacts currently in use.
+    size_t size() const { return n_used; }
+
+    /// Access the i-th contact in use.
+    Tcont& operator[](size_t i) { return blocks[i / block_size][i % block_size]; }
+    const Tcont& operator[](size_t i) const { return blocks[i / block_size][i % block_size]; }
+
+    /// Mark all contacts as unused (their storage is kept for reuse).
+    void Rewind() { n_used = 0; }
+
+    /// Add a contact, reusing a previously constructed object if possible.
+    template <class Ta, class Tb>
+    void Add(ChContactContainer* container, Ta* objA, Tb* objB, const collision::ChCollisionInfo& cinfo) {
+        if (n_used < n_constructed) {
+            (*this)[n_used].Reset(objA, objB, cinfo);
+        } else {
+            if (n_constructed == blocks.size() * block_size)
+                blocks.push_back(static_cast<Tcont*>(::operator new(block_size * sizeof(Tcont))));
+            new (&(*this)[n_constructed]) Tcont(container, objA, objB, cinfo);
+            n_constructed++;
+        }
+        n_used++;
+    }
+
+    /// Destroy all contacts and release the memory.
+    void Clear() {
+        for (size_t i = 0; i < n_constructed; i++)
+            (*this)[i].~Tcont();
+        for (auto block : blocks)
+            ::operator delete(block);
+        blocks.clear();
+        n_used = 0;
+        n_constructed = 0;
+    }
+
+  private:
+    static const size_t block_size = 256;
+
+    std::vector<Tcont*> blocks;
+    size_t n_used;
+    size_t n_constructed;
+};
+
+/// Class representing a container of many non-smooth contacts, stored in pooled contiguous arrays.
+/// This is an alternative to ChContactContainerNSC, which uses a linked list of individually
+/// allocated contacts per contactable-type pair: here, each contactable-type pair has its own
+/// ChContactPool, so that contacts are reused across steps without allocator traffic and are
+/// traversed linearly in memory. Only the storage differs: contact creation and the state and solver
+/// functions are those of ChContactContainerNSC, which reaches the pools through InsertContact() and
+/// VisitContacts() (one virtual call per contact, which the default container avoids). Contacts are
+/// processed in the same order, hence the results are identical.
+/// Use it with ChSystemNSC::SetContactContainer().
+class ChApi ChContactContainerNSCpooled : public ChContactContainerNSC {
+
+  protected:
+    ChContactPool<ChContactNSC_6_6> contactpool_6_6;
+    ChContactPool<ChContactNSC_6_3> contactpool_6_3;
+    ChContactPool<ChContactNSC_3_3> contactpool_3_3;
+    ChContactPool<ChContactNSC_333_3> contactpool_333_3;
+    ChContactPool<ChContactNSC_333_6> contactpool_333_6;
+    ChContactPool<ChContactNSC_333_333> contactpool_333_333;
+    ChContactPool<ChContactNSC_666_3> contactpool_666_3;
+    ChContactPool<ChContactNSC_666_6> contactpool_666_6;
+    ChContactPool<ChContactNSC_666_333> contactpool_666_333;
+    ChContactPool<ChContactNSC_666_666> contactpool_666_666;
+
+    ChContactPool<ChContactNSCrolling_6_6> contactpool_6_6_rolling;
+
+  public:
+    ChContactContainerNSCpooled() { custom_storage = true; }
+    ChContactContainerNSCpooled(const ChContactContainerNSCpooled& other) : ChContactContainerNSC(other) {}
+    virtual ~ChContactContainerNSCpooled() {}
+
+    /// "Virtual" copy constructor (covariant return type).
+    virtual ChContactContainerNSCpooled* Clone() const override { return new ChContactContainerNSCpooled(*this); }
+
+    /// Remove (delete) all contained contact data and release the pooled memory.
+    virtual void RemoveAllContacts() override;
+
+    /// Rewind all pools, so that contact objects from the previous step are reused.
+    virtual void BeginAddContact() override;
+
+    /// Update the number of contacts of each type (unused pooled contacts are kept for reuse).
+    virtual void EndAddContact() override;
+
+    //
+    // SERIALIZATION
+    //
+
+    /// Method to allow serialization of transient data to archives.
+    virtual void ArchiveOUT(ChArchiveOut& marchive) override;
+
+    /// Method to allow de-serialization of transient data from archives.
+    virtual void ArchiveIN(ChArchiveIn& marchive) override;
+
+  protected:
+    virtual void InsertContact(ChContactable_1vars<6>* objA,
+                               ChContactable_1vars<6>* objB,
+                               const collision::ChCollisionInfo& cinfo) override;
+    virtual void InsertContact(ChContactable_1vars<6>* objA,
+                               ChContactable_1vars<3>* objB,
+                               const collision::ChCollisionInfo& cinfo) override;
+    virtual void InsertContact(ChContactable_1vars<3>* objA,
+                               ChContactable_1vars<3>* objB,
+                               const collision::ChCollisionInfo& cinfo) override;
+    virtual void InsertContact(ChContactable_3vars<3, 3, 3>* objA,
+                               ChContactable_1vars<3>* objB,
+                               const collision::ChCollisionInfo& cinfo) override;
+    virtual void InsertContact(ChContactable_3vars<3, 3, 3>* objA,
+                               ChContactable_1vars<6>* objB,
+                               const collision::ChCollisionInfo& cinfo) override;
+    virtual void InsertContact(ChContactable_3vars<3, 3, 3>* objA,
+                               ChContactable_3vars<3, 3, 3>* objB,
+                               const collision::ChCollisionInfo& cinfo) override;
+    virtual void InsertContact(ChContactable_3vars<6, 6, 6>* objA,
+                               ChContactable_1vars<3>* objB,
+                               const collision::ChCollisionInfo& cinfo) override;
+    virtual void InsertContact(ChContactable_3vars<6, 6, 6>* objA,
+                               ChContactable_1vars<6>* objB,
+                               const collision::ChCollisionInfo& cinfo) override;
+    virtual void InsertContact(ChContactable_3vars<6, 6, 6>* objA,
+                               ChContactable_3vars<3, 3, 3>* objB,
+                               const collision::ChCollisionInfo& cinfo) override;
+    virtual void InsertContact(ChContactable_3vars<6, 6, 6>* objA,
+                               ChContactable_3vars<6, 6, 6>* objB,
+                               const collision::ChCollisionInfo& cinfo) override;
+    virtual void InsertContactRolling(ChContactable_1vars<6>* objA,
+                                      ChContactable_1vars<6>* objB,
+                                      const collision::ChCollisionInfo& cinfo) override;
+
+    virtual void VisitContacts(ContactVisitor& visitor) override;
+};
+
+CH_CLASS_VERSION(ChContactContainerNSCpooled, 0)
+
+}  // end namespace chrono
+
+#endif
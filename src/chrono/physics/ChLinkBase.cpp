@@ -14,6 +14,7 @@
 
 #include "chrono/physics/ChGlobal.h"
 #include "chrono/physics/ChLinkBase.h"
+#include "chrono/physics/ChSystem.h"
 
 namespace chrono {
 
@@ -26,6 +27,26 @@ ChLinkBase::ChLinkBase(const ChLinkBase& other) : ChPhysicsItem(other) {
     broken = other.broken;
 }
 
+// A change of the active status changes the topology of the system (see ChSystem::SetTopologyChanged).
+
+void ChLinkBase::SetValid(bool mon) {
+    if (mon != valid && system)
+        system->SetTopologyChanged();
+    valid = mon;
+}
+
+void ChLinkBase::SetDisabled(bool mdis) {
+    if (mdis != disabled && system)
+        system->SetTopologyChanged();
+    disabled = mdis;
+}
+
+void ChLinkBase::SetBroken(bool mon) {
+    if (mon != broken && system)
+        system->SetTopologyChanged();
+    broken = mon;
+}
+
 void ChLinkBase::ArchiveOUT(ChArchiveOut& marchive) {
     // version number
     marchive.VersionWrite<ChLinkBase>();
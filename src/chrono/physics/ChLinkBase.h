@@ -45,17 +45,17 @@ class ChApi ChLinkBase : public ChPhysicsItem {
     /// (i.e. pointers to other items are correct)
     bool IsValid() { return valid; }
     /// Set the status of link validity
-    void SetValid(bool mon) { valid = mon; }
+    void SetValid(bool mon);
 
     /// Tells if all constraints of this link are currently turned on or off by the user.
     bool IsDisabled() { return disabled; }
     /// User can use this to enable/disable all the constraint of the link as desired.
-    virtual void SetDisabled(bool mdis) { disabled = mdis; }
+    virtual void SetDisabled(bool mdis);
 
     /// Tells if the link is broken, for excess of pulling/pushing.
     bool IsBroken() { return broken; }
     /// Set the 'broken' status vof this link.
-    virtual void SetBroken(bool mon) { broken = mon; }
+    virtual void SetBroken(bool mon);
 
     /// An important function!
     /// Tells if the link is currently active, in general,
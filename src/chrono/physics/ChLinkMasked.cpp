@@ -124,6 +124,10 @@ void ChLinkMasked::BuildLink() {
         Cqw1 = 0;
         Cqw2 = 0;
     }
+
+    // the number of constraints may have changed
+    if (system)
+        system->SetTopologyChanged();
 }
 
 void ChLinkMasked::BuildLink(ChLinkMask* new_mask) {
@@ -123,6 +123,10 @@ void ChLinkMateGeneric::ChangedLinkMask() {
     ndoc = mask->GetMaskDoc();
     ndoc_c = mask->GetMaskDoc_c();
     ndoc_d = mask->GetMaskDoc_d();
+
+    // the number of constraints may have changed
+    if (system)
+        system->SetTopologyChanged();
 }
 
 void ChLinkMateGeneric::SetDisabled(bool mdis) {
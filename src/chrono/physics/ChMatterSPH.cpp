@@ -252,6 +252,9 @@ void ChMatterSPH::ResizeNnodes(int newsize) {
     }
 
     SetCollide(oldcoll);  // this will also add particle coll.models to coll.engine, if already in a ChSystem
+
+    if (system)
+        system->SetTopologyChanged();
 }
 
 void ChMatterSPH::AddNode(ChVector<double> initial_state) {
@@ -267,6 +270,9 @@ void ChMatterSPH::AddNode(ChVector<double> initial_state) {
 
     newp->collision_model->AddPoint(0.1);  //***TEST***
     newp->collision_model->BuildModel();   // will also add to system, if collision is on.
+
+    if (system)
+        system->SetTopologyChanged();
 }
 
 void ChMatterSPH::FillBox(const ChVector<> size,
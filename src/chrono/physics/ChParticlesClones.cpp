@@ -309,6 +309,9 @@ void ChParticlesClones::ResizeNparticles(int newsize) {
     }
 
     SetCollide(oldcoll);  // this will also add particle coll.models to coll.engine, if already in a ChSystem
+
+    if (system)
+        system->SetTopologyChanged();
 }
 
 void ChParticlesClones::AddParticle(ChCoordsys<double> initial_state) {
@@ -326,6 +329,9 @@ void ChParticlesClones::AddParticle(ChCoordsys<double> initial_state) {
     // newp->collision_model->ClearModel(); // wasn't already added to system, no need to remove
     newp->collision_model->AddCopyOfAnotherModel(particle_collision_model);
     newp->collision_model->BuildModel();  // will also add to system, if collision is on.
+
+    if (system)
+        system->SetTopologyChanged();
 }
 
 // STATE BOOKKEEPING FUNCTIONS
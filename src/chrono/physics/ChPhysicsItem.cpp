@@ -27,6 +27,8 @@ ChPhysicsItem::ChPhysicsItem(const ChPhysicsItem& other) : ChObj(other) {
     offset_x = other.offset_x;
     offset_w = other.offset_w;
     offset_L = other.offset_L;
+    allow_parallel_update = other.allow_parallel_update;
+    assembly_index = 0;
 }
 
 ChPhysicsItem::~ChPhysicsItem() {
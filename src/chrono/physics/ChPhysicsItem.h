@@ -33,6 +33,7 @@ class ChSystem;
 class ChApi ChPhysicsItem : public ChObj {
 
     friend class ChSystem;
+    friend class ChAssembly;
 
   protected:
     ChSystem* system;  ///< parent system
@@ -43,11 +44,16 @@ class ChApi ChPhysicsItem : public ChObj {
     unsigned int offset_w;  ///< offset in vector of state (speed part)
     unsigned int offset_L;  ///< offset in vector of lagrangian multipliers
 
+    bool allow_parallel_update;  ///< can be processed concurrently with other items of its assembly
+
   private:
+    unsigned int assembly_index;  ///< position in the item list of the parent assembly
+
     virtual void SetupInitial() {}
 
   public:
-    ChPhysicsItem() : system(NULL), offset_x(0), offset_w(0), offset_L(0) {}
+    ChPhysicsItem()
+        : system(NULL), offset_x(0), offset_w(0), offset_L(0), allow_parallel_update(true), assembly_index(0) {}
     ChPhysicsItem(const ChPhysicsItem& other);
     virtual ~ChPhysicsItem();
 
@@ -66,6 +72,15 @@ class ChApi ChPhysicsItem : public ChObj {
     /// creating his class inherited from ChAsset)
     void AddAsset(std::shared_ptr<ChAsset> masset) { assets.push_back(masset); }
 
+    /// Allow or not this item to be processed concurrently with other items of its assembly, when
+    /// the assembly uses the multithreaded update (see ChAssembly::SetUseParallelUpdate()).
+    /// Disable this for items which are not thread safe, for example items sharing loads or assets
+    /// whose update modifies shared data. Default: true.
+    void SetAllowParallelUpdate(bool val) { allow_parallel_update = val; }
+
+    /// Tell if this item can be processed concurrently with other items of its assembly.
+    bool GetAllowParallelUpdate() const { return allow_parallel_update; }
+
     /// Access to the list of optional assets.
     std::vector<std::shared_ptr<ChAsset> >& GetAssets() { return assets; }
 
@@ -13,6 +13,7 @@
 // =============================================================================
 
 #include <algorithm>
+#include <limits>
 
 #include "chrono/collision/ChCCollisionSystemBullet.h"
 #include "chrono/collision/ChCModelBullet.h"
@@ -26,6 +27,7 @@
 #include "chrono/solver/ChSolverPCG.h"
 #include "chrono/solver/ChSolverPMINRES.h"
 #include "chrono/solver/ChSolverSOR.h"
+#include "chrono/solver/ChSolverSORcolored.h"
 #include "chrono/solver/ChSolverSORmultithread.h"
 #include "chrono/solver/ChSolverSymmSOR.h"
 #include "chrono/timestepper/ChStaticAnalysis.h"
@@ -200,6 +202,14 @@ ChSystem::ChSystem()
       min_bounce_speed(0.15),
       max_penetration_recovery_speed(0.6),
       use_sleeping(false),
+      sleep_energy(std::numeric_limits<double>::infinity()),
+      nislands(0),
+      nislands_sleep(0),
+      use_incremental_setup(false),
+      setup_changed(true),
+      descriptor_changed(true),
+      other_containers(false),
+      injected_descriptor(nullptr),
       G_acc(ChVector<>(0, -9.8, 0)),
       stepcount(0),
       solvecount(0),
@@ -246,6 +256,14 @@ ChSystem::ChSystem(const ChSystem& other) : ChAssembly(other) {
     SetSolverType(GetSolverType());
     parallel_thread_number = other.parallel_thread_number;
     use_sleeping = other.use_sleeping;
+    sleep_energy = other.sleep_energy;
+    nislands = 0;
+    nislands_sleep = 0;
+    use_incremental_setup = other.use_incremental_setup;
+    setup_changed = true;
+    descriptor_changed = true;
+    other_containers = false;
+    injected_descriptor = nullptr;
 
     ncontacts = other.ncontacts;
 
@@ -291,6 +309,7 @@ void ChSystem::SetSolverType(ChSolver::Type type) {
 
     descriptor = std::make_shared<ChSystemDescriptor>();
     descriptor->SetNumThreads(parallel_thread_number);
+    descriptor_changed = true;
 
     switch (type) {
         case ChSolver::Type::SOR:
@@ -329,6 +348,10 @@ void ChSystem::SetSolverType(ChSolver::Type type) {
             solver_speed = std::make_shared<ChSolverMINRES>();
             solver_stab = std::make_shared<ChSolverMINRES>();
             break;
+        case ChSolver::Type::SOR_COLORED:
+            solver_speed = std::make_shared<ChSolverSORcolored>();
+            solver_stab = std::make_shared<ChSolverSORcolored>();
+            break;
         default:
             solver_speed = std::make_shared<ChSolverSymmSOR>();
             solver_stab = std::make_shared<ChSolverSymmSOR>();
@@ -427,6 +450,7 @@ void ChSystem::SetParallelThreadNumber(int mthreads) {
 void ChSystem::SetSystemDescriptor(std::shared_ptr<ChSystemDescriptor> newdescriptor) {
     assert(newdescriptor);
     descriptor = newdescriptor;
+    descriptor_changed = true;
 }
 void ChSystem::SetSolver(std::shared_ptr<ChSolver> newsolver) {
     assert(newsolver);
@@ -621,134 +645,201 @@ void ChSystem::SetTimestepperType(ChTimestepper::Type type) {
     }
 }
 
+// Union-find of simulation islands (with path halving)
+static int FindIsland(std::vector<int>& parent, int i) {
+    while (parent[i] != i) {
+        parent[i] = parent[parent[i]];
+        i = parent[i];
+    }
+    return i;
+}
+
+static void JoinIslands(std::vector<int>& parent, int i, int j) {
+    i = FindIsland(parent, i);
+    j = FindIsland(parent, j);
+    if (i != j)
+        parent[std::max(i, j)] = std::min(i, j);
+}
+
+int ChSystem::GetIslandBodyIndex(ChPhysicsItem* item) const {
+    if (!item)
+        return -1;
+    unsigned int index = item->assembly_index;
+    if (index >= bodylist.size() || bodylist[index].get() != item || bodylist[index]->GetBodyFixed())
+        return -1;
+    return (int)index;
+}
+
+void ChSystem::EraseSleepingBody(unsigned int index) {
+    // The body list was already shortened: its former last body is now at 'index'
+    size_t last = bodylist.size();
+    if (index < sleep_islands.size())
+        sleep_islands[index] = last < sleep_islands.size() ? sleep_islands[last] : -1;
+    if (sleep_islands.size() > last)
+        sleep_islands.resize(last);
+}
+
+void ChSystem::CompactSleepingBodies() {
+    size_t count = 0;
+    for (size_t ip = 0; ip < sleep_islands.size() && ip < bodylist.size(); ++ip) {
+        if (bodylist[ip])
+            sleep_islands[count++] = sleep_islands[ip];
+    }
+    sleep_islands.resize(count);
+}
+
 bool ChSystem::ManageSleepingBodies() {
     if (!GetUseSleeping())
         return 0;
 
+    CH_PROFILE("ManageSleepingBodies");
+
     // STEP 1:
-    // See if some body could change from no sleep-> sleep
+    // See which bodies could change from no sleep -> sleep,
+    // and keep the bodies of each sleeping island of the previous step together.
 
-    for (int ip = 0; ip < bodylist.size(); ++ip) {
+    int nb = (int)bodylist.size();
+    sleep_islands.resize(nb, -1);
+    island_parent.resize(nb);
+    island_first.assign(nb, -1);
+
+    for (int ip = 0; ip < nb; ++ip) {
+        ChBody* body = bodylist[ip].get();
         // mark as 'could sleep' candidate
-        bodylist[ip]->TrySleeping();
+        body->TrySleeping();
+        island_parent[ip] = ip;
+        if (body->GetBodyFixed())
+            continue;
+
+        // Bodies of a sleeping island have no contacts with each other: keep them together
+        int tag = sleep_islands[ip];
+        if (body->GetSleeping() && tag >= 0) {
+            if (tag >= (int)island_first.size())
+                island_first.resize(tag + 1, -1);
+            if (island_first[tag] < 0)
+                island_first[tag] = ip;
+            else
+                JoinIslands(island_parent, island_first[tag], ip);
+        }
     }
 
     // STEP 2:
-    // See if some sleeping or potential sleeping body is touching a non sleeping one,
-    // if so, set to no sleep.
-
-    // Make this class for iterating through contacts
+    // Build the simulation islands: connected components of the graph of bodies,
+    // with links and contacts as edges.
+
+    for (unsigned int ip = 0; ip < linklist.size(); ++ip) {
+        ChLink* link = linklist[ip].get();
+        if (!link->IsRequiringWaking())
+            continue;
+        ChBody* b1 = dynamic_cast<ChBody*>(link->GetBody1());
+        ChBody* b2 = dynamic_cast<ChBody*>(link->GetBody2());
+        if (!(b1 && b2))
+            continue;
+        int i1 = GetIslandBodyIndex(b1);
+        int i2 = GetIslandBodyIndex(b2);
+        if (i1 >= 0 && i2 >= 0)
+            JoinIslands(island_parent, i1, i2);
+    }
 
-    class _wakeup_reporter_class : public ChContactContainer::ReportContactCallback {
+    class _island_reporter_class : public ChContactContainer::ReportContactCallback {
       public:
+        _island_reporter_class(const ChSystem& system, std::vector<int>& parent) : m_system(system), m_parent(parent) {}
+
         // Callback, used to report contact points already added to the container.
         // If returns false, the contact scanning will be stopped.
-        virtual bool OnReportContact(
-            const ChVector<>& pA,             ///< get contact pA
-            const ChVector<>& pB,             ///< get contact pB
-            const ChMatrix33<>& plane_coord,  ///< get contact plane coordsystem (A column 'X' is contact normal)
-            const double& distance,           ///< get contact distance
-            const ChVector<>& react_forces,   ///< get react.forces (if already computed). In coordsystem 'plane_coord'
-            const ChVector<>& react_torques,  ///< get react.torques, if rolling friction (if already computed).
-            ChContactable* contactobjA,  ///< get model A (note: some containers may not support it and could be zero!)
-            ChContactable* contactobjB   ///< get model B (note: some containers may not support it and could be zero!)
-            ) override {
+        virtual bool OnReportContact(const ChVector<>& pA,
+                                     const ChVector<>& pB,
+                                     const ChMatrix33<>& plane_coord,
+                                     const double& distance,
+                                     const ChVector<>& react_forces,
+                                     const ChVector<>& react_torques,
+                                     ChContactable* contactobjA,
+                                     ChContactable* contactobjB) override {
             if (!(contactobjA && contactobjB))
                 return true;
-            ChBody* b1 = dynamic_cast<ChBody*>(contactobjA);
-            ChBody* b2 = dynamic_cast<ChBody*>(contactobjB);
-            if (!(b1 && b2))
+            int iA = m_system.GetIslandBodyIndex(contactobjA->GetPhysicsItem());
+            if (iA < 0)
                 return true;
-            bool sleep1 = b1->GetSleeping();
-            bool sleep2 = b2->GetSleeping();
-            bool could_sleep1 = b1->BFlagGet(ChBody::BodyFlag::COULDSLEEP);
-            bool could_sleep2 = b2->BFlagGet(ChBody::BodyFlag::COULDSLEEP);
-            bool ground1 = b1->GetBodyFixed();
-            bool ground2 = b2->GetBodyFixed();
-            if (sleep1 && !(sleep2 || could_sleep2) && !ground2) {
-                b1->SetSleeping(false);
-                need_Setup_A = true;
-            }
-            if (sleep2 && !(sleep1 || could_sleep1) && !ground1) {
-                b2->SetSleeping(false);
-                need_Setup_A = true;
-            }
-            if (could_sleep1 && !(sleep2 || could_sleep2) && !ground2) {
-                b1->BFlagSet(ChBody::BodyFlag::COULDSLEEP, false);
-            }
-            if (could_sleep2 && !(sleep1 || could_sleep1) && !ground1) {
-                b2->BFlagSet(ChBody::BodyFlag::COULDSLEEP, false);
-            }
-            someone_sleeps = sleep1 | sleep2 | someone_sleeps;
-
+            int iB = m_system.GetIslandBodyIndex(contactobjB->GetPhysicsItem());
+            if (iB < 0)
+                return true;
+            JoinIslands(m_parent, iA, iB);
             return true;  // to continue scanning contacts
         }
 
-        // Data
-        bool someone_sleeps;
-        bool need_Setup_A;
+      private:
+        const ChSystem& m_system;
+        std::vector<int>& m_parent;
     };
 
-    _wakeup_reporter_class my_waker;
-    my_waker.need_Setup_A = false;
-
-    bool need_Setup_L = false;
+    _island_reporter_class my_reporter(*this, island_parent);
+    contact_container->ReportAllContacts(&my_reporter);
+
+    // STEP 3:
+    // An island can sleep if all its bodies are sleeping or could sleep, and if its
+    // kinetic energy per unit mass is below the threshold. Otherwise it is awake.
+
+    island_rest.assign(nb, 1);
+    island_energy.assign(nb, 0.0);
+    island_mass.assign(nb, 0.0);
+
+    for (int ip = 0; ip < nb; ++ip) {
+        ChBody* body = bodylist[ip].get();
+        if (body->GetBodyFixed())
+            continue;
+        int root = FindIsland(island_parent, ip);
+        if (!body->GetSleeping()) {
+            if (!body->BFlagGet(ChBody::BodyFlag::COULDSLEEP))
+                island_rest[root] = 0;
+            ChVector<> wvel = body->GetWvel_loc();
+            island_energy[root] +=
+                0.5 * (body->GetMass() * body->GetPos_dt().Length2() + wvel.Dot(body->GetInertia() * wvel));
+        }
+        island_mass[root] += body->GetMass();
+    }
 
-    for (int i = 0; i < 1; i++)  //***TO DO*** reconfigurable number of wakeup cycles
-    {
-        my_waker.someone_sleeps = false;
+    bool need_Setup = false;
+    bool woken = false;
+    nislands = 0;
+    nislands_sleep = 0;
+
+    for (int ip = 0; ip < nb; ++ip) {
+        ChBody* body = bodylist[ip].get();
+        bool sleep = false;
+        if (!body->GetBodyFixed()) {
+            int root = FindIsland(island_parent, ip);
+            sleep = island_rest[root] && island_energy[root] <= sleep_energy * island_mass[root];
+
+            if (root == ip) {
+                nislands++;
+                if (sleep)
+                    nislands_sleep++;
+            }
 
-        // scan all links and wake connected bodies
-        for (unsigned int ip = 0; ip < linklist.size(); ++ip)  // ITERATE on links
-        {
-            std::shared_ptr<ChLink> Lpointer = linklist[ip];
-
-            if (Lpointer->IsRequiringWaking()) {
-                ChBody* b1 = dynamic_cast<ChBody*>(Lpointer->GetBody1());
-                ChBody* b2 = dynamic_cast<ChBody*>(Lpointer->GetBody2());
-                if (b1 && b2) {
-                    bool sleep1 = b1->GetSleeping();
-                    bool sleep2 = b2->GetSleeping();
-                    bool could_sleep1 = b1->BFlagGet(ChBody::BodyFlag::COULDSLEEP);
-                    bool could_sleep2 = b2->BFlagGet(ChBody::BodyFlag::COULDSLEEP);
-                    if (sleep1 && !(sleep2 || could_sleep2)) {
-                        b1->SetSleeping(false);
-                        need_Setup_L = true;
-                    }
-                    if (sleep2 && !(sleep1 || could_sleep1)) {
-                        b2->SetSleeping(false);
-                        need_Setup_L = true;
-                    }
-                    if (could_sleep1 && !(sleep2 || could_sleep2)) {
-                        b1->BFlagSet(ChBody::BodyFlag::COULDSLEEP, false);
-                    }
-                    if (could_sleep2 && !(sleep1 || could_sleep1)) {
-                        b2->BFlagSet(ChBody::BodyFlag::COULDSLEEP, false);
-                    }
-                }
+            if (sleep != body->GetSleeping()) {
+                woken |= !sleep;
+                body->SetSleeping(sleep);
+                need_Setup = true;
             }
+            body->BFlagSet(ChBody::BodyFlag::COULDSLEEP, false);
+            sleep_islands[ip] = sleep ? root : -1;
+        } else {
+            sleep_islands[ip] = -1;
         }
 
-        // scan all contacts and wake neighboring bodies
-        contact_container->ReportAllContacts(&my_waker);
-
-        // bailout wakeup cycle prematurely, if all bodies are not sleeping
-        if (!my_waker.someone_sleeps)
-            break;
+        // No narrow phase between two sleeping objects: the bodies of a sleeping island have no contacts
+        // with each other. All other pairs (including fixed ones) still reach the narrow phase callbacks.
+        if (auto model = dynamic_cast<ChModelBullet*>(body->GetCollisionModel().get()))
+            model->GetBulletModel()->forceActivationState(sleep ? ISLAND_SLEEPING : ACTIVE_TAG);
     }
 
-    /// If some body still must change from no sleep-> sleep, do it
-    int need_Setup_B = 0;
-    for (int ip = 0; ip < bodylist.size(); ++ip) {
-        if (bodylist[ip]->BFlagGet(ChBody::BodyFlag::COULDSLEEP)) {
-            bodylist[ip]->SetSleeping(true);
-            ++need_Setup_B;
-        }
-    }
+    // Contacts between sleeping bodies were not generated: find them for the islands just woken up
+    if (woken)
+        ComputeCollisions();
 
     // if some body has been activated/deactivated because of sleep state changes,
     // the offsets and DOF counts must be updated:
-    if (my_waker.need_Setup_A || need_Setup_B || need_Setup_L) {
+    if (need_Setup) {
         Setup();
         return true;
     }
@@ -760,11 +851,42 @@ bool ChSystem::ManageSleepingBodies() {
 // -----------------------------------------------------------------------------
 
 void ChSystem::DescriptorPrepareInject(ChSystemDescriptor& mdescriptor) {
-    mdescriptor.BeginInsertion();  // This resets the vectors of constr. and var. pointers.
+    // Contact and proximity containers among the other physics items change at each step, and with
+    // them the constraints of the assembly: rebuild the whole descriptor.
+    if (!use_incremental_setup || other_containers) {
+        descriptor_changed = true;
+        mdescriptor.BeginInsertion();  // This resets the vectors of constr. and var. pointers.
+
+        InjectConstraints(mdescriptor);
+        InjectVariables(mdescriptor);
+        InjectKRMmatrices(mdescriptor);
 
-    InjectConstraints(mdescriptor);
-    InjectVariables(mdescriptor);
-    InjectKRMmatrices(mdescriptor);
+        mdescriptor.EndInsertion();
+        return;
+    }
+
+    // Incremental setup: the items of the assembly are only injected if the topology changed.
+    // Otherwise, the contacts injected at the previous call are removed from the end of the lists.
+    if (descriptor_changed || injected_descriptor != &mdescriptor) {
+        mdescriptor.BeginInsertion();
+        ChAssembly::InjectConstraints(mdescriptor);
+        ChAssembly::InjectVariables(mdescriptor);
+        ChAssembly::InjectKRMmatrices(mdescriptor);
+
+        assembly_nconstraints = mdescriptor.GetConstraintsList().size();
+        assembly_nvariables = mdescriptor.GetVariablesList().size();
+        assembly_nkblocks = mdescriptor.GetKblocksList().size();
+        injected_descriptor = &mdescriptor;
+        descriptor_changed = false;
+    } else {
+        mdescriptor.GetConstraintsList().resize(assembly_nconstraints);
+        mdescriptor.GetVariablesList().resize(assembly_nvariables);
+        mdescriptor.GetKblocksList().resize(assembly_nkblocks);
+    }
+
+    contact_container->InjectConstraints(mdescriptor);
+    contact_container->InjectVariables(mdescriptor);
+    contact_container->InjectKRMmatrices(mdescriptor);
 
     mdescriptor.EndInsertion();
 }
@@ -781,8 +903,30 @@ void ChSystem::DescriptorPrepareInject(ChSystemDescriptor& mdescriptor) {
 
 void ChSystem::Setup() {
     CH_PROFILE( "Setup");
-    // inherit the parent class (compute offsets of bodies, links, etc.)
-    ChAssembly::Setup();
+    // Any item being queued for insertion in system's lists? add it.
+    FlushBatch();
+
+    if (!use_incremental_setup || setup_changed || other_containers) {
+        // inherit the parent class (compute offsets of bodies, links, etc.)
+        ChAssembly::Setup();
+        assembly_ndoc_w = ndoc_w;
+        assembly_ndoc_w_C = ndoc_w_C;
+        assembly_ndoc_w_D = ndoc_w_D;
+        setup_changed = false;
+
+        // Contact and proximity containers among the other physics items are refilled at each step,
+        // so their offsets and counts cannot be reused.
+        other_containers = std::any_of(otherphysicslist.begin(), otherphysicslist.end(),
+                                       [](const std::shared_ptr<ChPhysicsItem>& item) {
+                                           return std::dynamic_pointer_cast<ChContactContainer>(item) ||
+                                                  std::dynamic_pointer_cast<ChProximityContainer>(item);
+                                       });
+    } else {
+        // Same topology as at the last call: only the contacts may have changed.
+        ndoc_w = assembly_ndoc_w;
+        ndoc_w_C = assembly_ndoc_w_C;
+        ndoc_w_D = assembly_ndoc_w_D;
+    }
 
     // also compute offsets for contact container
     {
@@ -1532,7 +1676,12 @@ void ChSystem::DumpSystemMatrices(bool save_M, bool save_K, bool save_R, bool sa
 
 int ChSystem::DoStepDynamics(double m_step) {
     step = m_step;
-    return Integrate_Y();
+    bool success = Integrate_Y();
+
+    // Close the step record of the profiler (no-op if not enabled)
+    utils::ChProfileRecorder::EndStep(ChTime);
+
+    return success;
 }
 
 // -----------------------------------------------------------------------------
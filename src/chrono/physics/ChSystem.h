@@ -182,6 +182,7 @@ class ChApi ChSystem : public ChAssembly, public ChIntegrableIIorder {
     /// Choose the solver type, to be used for the simultaneous solution of the constraints
     /// in dynamical simulations (as well as in kinematics, statics, etc.)
     ///   - Suggested solver for speed, but lower precision: SOR
+    ///   - Multi-threaded variant for large contact problems: SOR_COLORED
     ///   - Suggested solver for higher precision: BARZILAIBORWEIN or APGD
     ///   - For problems that involve a stiffness matrix: MINRES
     ///
@@ -607,6 +608,46 @@ class ChApi ChSystem : public ChAssembly, public ChIntegrableIIorder {
     /// Tell if the system will put to sleep the bodies whose motion has almost come to a rest.
     bool GetUseSleeping() const { return use_sleeping; }
 
+    /// Set the maximum kinetic energy per unit mass of a simulation island that can be put to sleep.
+    /// An island is a set of bodies connected by links or contacts (fixed bodies do not connect
+    /// islands); it sleeps or wakes up as a whole, and only if all its bodies satisfy their own
+    /// sleeping conditions (see ChBody::SetSleepMinSpeed). By default there is no energy limit.
+    void SetSleepingEnergyThreshold(double energy) { sleep_energy = energy; }
+
+    /// Get the maximum kinetic energy per unit mass of a simulation island that can be put to sleep.
+    double GetSleepingEnergyThreshold() const { return sleep_energy; }
+
+    /// Get the number of simulation islands found at the last step (only if sleeping is enabled).
+    int GetNislands() const { return nislands; }
+
+    /// Get the number of sleeping simulation islands at the last step (only if sleeping is enabled).
+    int GetNislandsSleeping() const { return nislands_sleep; }
+
+    /// Turn on this feature to reuse the item offsets and the system descriptor from one step to the
+    /// next while the topology of the system does not change (default: false). At the other steps, the
+    /// offsets are recomputed, the descriptor is rebuilt, and only the contacts are re-injected.
+    /// Topology changes are tracked automatically when items are added or removed, when bodies are
+    /// fixed or released, put to sleep or woken up, when links are enabled, disabled, broken or
+    /// change their constraint mask, and when nodes or elements are added to a mesh. Any other change
+    /// of the number of coordinates, constraints or stiffness blocks of an item (e.g. ChLinkLock limits
+    /// turned on) must be reported with SetTopologyChanged().
+    /// Contact and proximity containers added to the system as other physics items are refilled at
+    /// each step, so the offsets and the descriptor are rebuilt at each step while any is present.
+    void SetUseIncrementalSetup(bool val) {
+        use_incremental_setup = val;
+        SetTopologyChanged();
+    }
+
+    /// Tell if the system reuses the offsets and the system descriptor while the topology does not change.
+    bool GetUseIncrementalSetup() const { return use_incremental_setup; }
+
+    /// Report a change of topology: the next Setup() recomputes all offsets and the system descriptor
+    /// is rebuilt at the next step. Only needed with SetUseIncrementalSetup(true).
+    void SetTopologyChanged() {
+        setup_changed = true;
+        descriptor_changed = true;
+    }
+
   private:
     /// Put bodies to sleep if possible. Also awakens sleeping bodies, if needed.
     /// Returns true if some body changed from sleep to no sleep or viceversa,
@@ -614,6 +655,17 @@ class ChApi ChSystem : public ChAssembly, public ChIntegrableIIorder {
     /// because the sleeping policy changed the totalDOFs and offsets.
     bool ManageSleepingBodies();
 
+    /// Position in the body list of a non-fixed body of this system, or -1 if the item is not such a body.
+    int GetIslandBodyIndex(ChPhysicsItem* item) const;
+
+    /// Keep the sleeping islands in step with the body list, after the body at the given position was
+    /// removed and replaced by the last body of the list (see ChAssembly::RemoveBody).
+    void EraseSleepingBody(unsigned int index);
+
+    /// Keep the sleeping islands in step with the body list, before its cleared entries are compacted
+    /// (see ChAssembly::FlushBatch).
+    void CompactSleepingBodies();
+
     /// Performs a single dynamical simulation step, according to
     /// current values of:  Y, time, step  (and other minor settings)
     /// Depending on the integration type, it switches to one of the following:
@@ -802,6 +854,27 @@ class ChApi ChSystem : public ChAssembly, public ChIntegrableIIorder {
     int maxiter;  ///< max iterations for nonlinear convergence in DoAssembly()
 
     bool use_sleeping;  ///< if true, put to sleep objects that come to rest
+    double sleep_energy;  ///< max kinetic energy per unit mass of a sleeping island
+    int nislands;         ///< number of simulation islands
+    int nislands_sleep;   ///< number of sleeping simulation islands
+    std::vector<int> sleep_islands;     ///< island of each body in the body list if sleeping, -1 otherwise
+    std::vector<int> island_parent;     ///< union-find of the simulation islands (work data)
+    std::vector<int> island_first;      ///< first body of each sleeping island of the last step (work data)
+    std::vector<char> island_rest;      ///< islands whose bodies are all at rest (work data)
+    std::vector<double> island_energy;  ///< kinetic energy of the awake bodies of each island (work data)
+    std::vector<double> island_mass;    ///< mass of each island (work data)
+
+    bool use_incremental_setup;  ///< if true, reuse offsets and descriptor while the topology does not change
+    bool setup_changed;          ///< topology changed since the last Setup()
+    bool descriptor_changed;     ///< topology changed since the last DescriptorPrepareInject()
+    bool other_containers;       ///< contact or proximity containers in the list of other physics items
+    ChSystemDescriptor* injected_descriptor;  ///< descriptor filled at the last DescriptorPrepareInject()
+    int assembly_ndoc_w;                      ///< constraints of the assembly items, without contacts
+    int assembly_ndoc_w_C;                    ///< bilateral constraints of the assembly items
+    int assembly_ndoc_w_D;                    ///< unilateral constraints of the assembly items
+    size_t assembly_nconstraints;             ///< descriptor constraints injected by the assembly items
+    size_t assembly_nvariables;               ///< descriptor variables injected by the assembly items
+    size_t assembly_nkblocks;                 ///< descriptor stiffness blocks injected by the assembly items
 
     std::shared_ptr<ChSystemDescriptor> descriptor;  ///< the system descriptor
     std::shared_ptr<ChSolver> solver_speed;          ///< the solver for speed problem
@@ -845,6 +918,8 @@ class ChApi ChSystem : public ChAssembly, public ChIntegrableIIorder {
 
     // Friend class declarations
 
+    friend class ChAssembly;
+
     template <class Ta, class Tb>
     friend class ChContactNSC;
 
@@ -0,0 +1,113 @@
+// =============================================================================
+// PROJECT CHRONO - http://projectchrono.org
+//
+// Copyright (c) 2014 projectchrono.org
+// All rights reserved.
+//
+// Use of this source code is governed by a BSD-style license that can be found
+// in the LICENSE file at the top level of the distribution and at
+// http://projectchrono.org/license-chrono.txt.
+//
+// =============================================================================
+//
+// Ensemble of independent systems (e.g. for design of experiments or Monte
+// Carlo studies), simulated concurrently.
+//
+// =============================================================================
+
+#include <sstream>
+
+#include "chrono/core/ChException.h"
+#include "chrono/core/ChLog.h"
+#include "chrono/parallel/ChOpenMP.h"
+#include "chrono/physics/ChSystemEnsemble.h"
+#include "chrono/utils/ChProfileRecorder.h"
+
+namespace chrono {
+
+// Logger collecting the messages of one run in a string.
+class ChLogString : public ChLog, public ChStreamOstreamWrapper {
+  public:
+    ChLogString() : ChStreamOstreamWrapper(&m_stream) {}
+
+    virtual void Output(const char* data, size_t n) override {
+        if (current_level != CHQUIET)
+            ChStreamOstreamWrapper::Write(data, n);
+    }
+
+    std::string GetString() const { return m_stream.str(); }
+
+  private:
+    std::ostringstream m_stream;
+};
+
+ChSystemEnsemble::ChSystemEnsemble(int num_runs, RunCallback* callback)
+    : m_callback(callback),
+      m_runs(num_runs),
+      m_nthreads(CHOMPfunctions::GetNumProcs()),
+      m_step(1e-3),
+      m_end_time(1),
+      m_keep_systems(false) {}
+
+int ChSystemEnsemble::Run() {
+    int num_runs = GetNumRuns();
+
+    // One task per run; tasks are assigned to threads as they become idle.
+#pragma omp parallel for num_threads(m_nthreads) schedule(dynamic, 1) if (m_nthreads > 1)
+    for (int index = 0; index < num_runs; ++index) {
+        Simulate(index);
+    }
+
+    int num_success = 0;
+    for (auto& run : m_runs) {
+        if (run.success)
+            num_success++;
+    }
+    return num_success;
+}
+
+void ChSystemEnsemble::Simulate(int index) {
+    RunInfo& run = m_runs[index];
+    run.system.reset();
+    run.num_steps = 0;
+    run.success = true;
+    run.error.clear();
+
+    // Redirect the log and suspend profiling on this thread, for the duration of the run.
+    ChLogString log;
+    SetThreadLog(&log);
+    utils::ChProfileRecorder::SuspendThread(true);
+
+    try {
+        {
+            std::lock_guard<std::mutex> lock(m_create_mutex);
+            run.system = m_callback->CreateSystem(index);
+        }
+        if (!run.system)
+            throw ChException("No system created for the run");
+        ChSystem& system = *run.system;
+        system.SetParallelThreadNumber(1);
+
+        while (system.GetChTime() + 1e-6 * m_step < m_end_time) {
+            system.DoStepDynamics(m_step);
+            run.num_steps++;
+            if (!m_callback->OnStep(index, system))
+                break;
+        }
+
+        m_callback->OnEnd(index, system);
+    } catch (const std::exception& e) {
+        run.success = false;
+        run.error = e.what();
+    }
+
+    // Release the system on the thread which created it.
+    if (!m_keep_systems)
+        run.system.reset();
+
+    utils::ChProfileRecorder::SuspendThread(false);
+    SetThreadLog(NULL);
+    run.log = log.GetString();
+}
+
+}  // end namespace chrono
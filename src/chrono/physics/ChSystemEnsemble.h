@@ -0,0 +1,131 @@
+// =============================================================================
+// PROJECT CHRONO - http://projectchrono.org
+//
+// Copyright (c) 2014 projectchrono.org
+// All rights reserved.
+//
+// Use of this source code is governed by a BSD-style license that can be found
+// in the LICENSE file at the top level of the distribution and at
+// http://projectchrono.org/license-chrono.txt.
+//
+// =============================================================================
+//
+// Ensemble of independent systems (e.g. for design of experiments or Monte
+// Carlo studies), simulated concurrently.
+//
+// =============================================================================
+
+#ifndef CH_SYSTEM_ENSEMBLE_H
+#define CH_SYSTEM_ENSEMBLE_H
+
+#include <memory>
+#include <mutex>
+#include <string>
+#include <vector>
+
+#include "chrono/physics/ChSystem.h"
+
+namespace chrono {
+
+/// Ensemble of independent systems, simulated concurrently.
+///
+/// The systems are created by a user-provided callback and simulated with one system per task: a task creates
+/// its system, steps it to the end time and collects its outputs, all on the same thread. Tasks are distributed
+/// dynamically over the threads, so that runs of different lengths are balanced. Each system is stepped with a
+/// single thread (see ChSystem::SetParallelThreadNumber).
+///
+/// While stepping, the tasks do not modify any process-wide state:
+/// - messages written to GetLog() are collected in the run information (see SetThreadLog);
+/// - profiling is suspended on the worker threads (see ChProfileRecorder::SuspendThread).
+/// The creation of the systems can set process-wide defaults (e.g. the ChSystem constructor sets the default
+/// collision envelope and margin), so the calls to RunCallback::CreateSystem are serialized. The memory of a
+/// system is still allocated and released on the thread which steps it.
+///
+/// Example:
+/// \code{.cpp}
+/// class MyRuns : public ChSystemEnsemble::RunCallback {
+///   public:
+///     MyRuns(int n) : max_height(n) {}
+///     virtual std::shared_ptr<ChSystem> CreateSystem(int index) override {...}
+///     virtual void OnEnd(int index, ChSystem& system) override { max_height[index] = ...; }
+///     std::vector<double> max_height;  // one slot per run, no locking needed
+/// };
+/// MyRuns runs(1000);
+/// ChSystemEnsemble ensemble(1000, &runs);
+/// ensemble.SetStepSize(1e-3);
+/// ensemble.SetEndTime(5);
+/// ensemble.Run();
+/// \endcode
+class ChApi ChSystemEnsemble {
+  public:
+    /// Class to be used as a callback interface for creating the systems and collecting their outputs.
+    /// Its methods are called concurrently, for different runs, from the worker threads. Outputs should be
+    /// stored in per-run slots (e.g. a vector indexed by the run index), which requires no locking.
+    class ChApi RunCallback {
+      public:
+        virtual ~RunCallback() {}
+
+        /// Create the system for the run with specified index.
+        virtual std::shared_ptr<ChSystem> CreateSystem(int index) = 0;
+
+        /// Called after each step of a run. Return false to end the run.
+        virtual bool OnStep(int index, ChSystem& system) { return true; }
+
+        /// Called at the end of a run, to collect its outputs.
+        virtual void OnEnd(int index, ChSystem& system) {}
+    };
+
+    /// Information on a run of the ensemble.
+    struct RunInfo {
+        RunInfo() : num_steps(0), success(false) {}
+
+        std::shared_ptr<ChSystem> system;  ///< simulated system (only kept if SetKeepSystems(true))
+        int num_steps;                     ///< number of steps taken
+        bool success;                      ///< false if the run was ended by an exception
+        std::string error;                 ///< exception message, if any
+        std::string log;                   ///< messages written to GetLog() during the run
+    };
+
+    /// Create an ensemble of the given number of runs, with systems created by the specified callback.
+    ChSystemEnsemble(int num_runs, RunCallback* callback);
+
+    ~ChSystemEnsemble() {}
+
+    /// Set the number of threads used to simulate the ensemble (default: number of processors).
+    void SetNumThreads(int nthreads) { m_nthreads = nthreads; }
+
+    /// Set the integration step size (default: 1e-3).
+    void SetStepSize(double step) { m_step = step; }
+
+    /// Set the end time of the runs (default: 1).
+    void SetEndTime(double end_time) { m_end_time = end_time; }
+
+    /// Keep the systems after the end of their run (default: false).
+    /// By default, a system is deleted after the call to RunCallback::OnEnd, which keeps the memory use of
+    /// large ensembles bounded.
+    void SetKeepSystems(bool val) { m_keep_systems = val; }
+
+    /// Simulate all runs of the ensemble. Return the number of successful runs.
+    int Run();
+
+    /// Return the number of runs.
+    int GetNumRuns() const { return (int)m_runs.size(); }
+
+    /// Return information on the run with specified index.
+    const RunInfo& GetRunInfo(int index) const { return m_runs[index]; }
+
+  private:
+    void Simulate(int index);
+
+    RunCallback* m_callback;
+    std::vector<RunInfo> m_runs;
+    int m_nthreads;
+    double m_step;
+    double m_end_time;
+    bool m_keep_systems;
+    std::mutex m_create_mutex;
+};
+
+}  // end namespace chrono
+
+#endif
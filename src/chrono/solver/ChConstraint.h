@@ -15,6 +15,8 @@
 #ifndef CHCONSTRAINT_H
 #define CHCONSTRAINT_H
 
+#include <vector>
+
 #include "chrono/core/ChApiCE.h"
 #include "chrono/core/ChClassFactory.h"
 #include "chrono/core/ChMatrix.h"
@@ -22,6 +24,9 @@
 
 namespace chrono {
 
+// Forward references
+class ChVariables;
+
 /// Modes for constraint
 enum eChConstraintMode {
     CONSTRAINT_FREE = 0,        ///< the constraint does not enforce anything
@@ -299,6 +304,12 @@ class ChApi ChConstraint {
     /// Same as Build_Cq, but puts the _transposed_ jacobian row as a column.
     virtual void Build_CqT(ChSparseMatrix& storage, int inscol) = 0;
 
+    /// Append to 'mvars' the ChVariables objects referenced by the jacobian of this constraint.
+    /// This is used by solvers that need the constraint-variable connectivity (for example,
+    /// to partition constraints in independent sets, as in ChSolverSORcolored).
+    /// Returns false if the connectivity is not known, which is the default behavior.
+    virtual bool GetConstrainedVariables(std::vector<ChVariables*>& mvars) const { return false; }
+
     /// Set offset in global q vector (set automatically by ChSystemDescriptor)
     void SetOffset(int moff) { offset = moff; }
 
@@ -74,6 +74,14 @@ class ChApi ChConstraintThree : public ChConstraint {
     /// automatically creating/resizing jacobians if needed.
     virtual void SetVariables(ChVariables* mvariables_a, ChVariables* mvariables_b, ChVariables* mvariables_c) = 0;
 
+    /// Append the three constrained ChVariables objects to the given list.
+    virtual bool GetConstrainedVariables(std::vector<ChVariables*>& mvars) const override {
+        mvars.push_back(variables_a);
+        mvars.push_back(variables_b);
+        mvars.push_back(variables_c);
+        return true;
+    }
+
     /// Method to allow serialization of transient data to archives.
     virtual void ArchiveOUT(ChArchiveOut& marchive);
 
@@ -67,6 +67,13 @@ class ChApi ChConstraintTwo : public ChConstraint {
     /// automatically creating/resizing jacobians if needed.
     virtual void SetVariables(ChVariables* mvariables_a, ChVariables* mvariables_b) = 0;
 
+    /// Append the two constrained ChVariables objects to the given list.
+    virtual bool GetConstrainedVariables(std::vector<ChVariables*>& mvars) const override {
+        mvars.push_back(variables_a);
+        mvars.push_back(variables_b);
+        return true;
+    }
+
     /// Method to allow serialization of transient data to archives.
     virtual void ArchiveOUT(ChArchiveOut& marchive);
 
@@ -123,6 +123,13 @@ class ChConstraintTwoTuples : public ChConstraint {
         tuple_a.Build_CqT(storage, inscol);
         tuple_b.Build_CqT(storage, inscol);
     }
+
+    /// Append the ChVariables objects of both tuples to the given list.
+    virtual bool GetConstrainedVariables(std::vector<ChVariables*>& mvars) const override {
+        tuple_a.GetConstrainedVariables(mvars);
+        tuple_b.GetConstrainedVariables(mvars);
+        return true;
+    }
 };
 
 }  // end namespace chrono
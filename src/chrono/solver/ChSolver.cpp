@@ -31,6 +31,7 @@ class my_enum_mappers : public ChSolver {
     CH_ENUM_VAL(Type::APGD);
     CH_ENUM_VAL(Type::MINRES);
     CH_ENUM_VAL(Type::SOLVER_SMC);
+    CH_ENUM_VAL(Type::SOR_COLORED);
     CH_ENUM_VAL(Type::CUSTOM);
     CH_ENUM_MAPPER_END(Type);
 };
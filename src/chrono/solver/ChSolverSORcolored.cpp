@@ -0,0 +1,330 @@
+// =============================================================================
+// PROJECT CHRONO - http://projectchrono.org
+//
+// Copyright (c) 2014 projectchrono.org
+// All rights reserved.
+//
+// Use of this source code is governed by a BSD-style license that can be found
+// in the LICENSE file at the top level of the distribution and at
+// http://projectchrono.org/license-chrono.txt.
+//
+// =============================================================================
+
+#include <cmath>
+#include <unordered_map>
+
+#include "chrono/parallel/ChOpenMP.h"
+#include "chrono/solver/ChSolverSORcolored.h"
+
+namespace chrono {
+
+// Register into the object factory, to enable run-time dynamic creation and persistence
+CH_FACTORY_REGISTER(ChSolverSORcolored)
+
+// Colors with fewer blocks than this are swept by a single thread.
+static const int min_parallel_blocks = 64;
+
+void ChSolverSORcolored::ColorConstraints(std::vector<ChConstraint*>& mconstraints,
+                                          std::vector<ChVariables*>& mvariables) {
+    // 1)  Group the active constraints in blocks: the N,U,V components of a frictional
+    //     contact must be processed together (cone projection), all others are processed alone.
+    block_start.clear();
+    block_size.clear();
+
+    int nc = (int)mconstraints.size();
+    int ic = 0;
+    while (ic < nc) {
+        int size = 1;
+        if (mconstraints[ic]->GetMode() == CONSTRAINT_FRIC && ic + 2 < nc &&
+            mconstraints[ic + 1]->GetMode() == CONSTRAINT_FRIC && mconstraints[ic + 2]->GetMode() == CONSTRAINT_FRIC)
+            size = 3;
+
+        bool active = true;
+        for (int k = 0; k < size; k++)
+            active = active && mconstraints[ic + k]->IsActive();
+
+        if (active) {
+            block_start.push_back(ic);
+            block_size.push_back(size);
+        }
+        ic += size;
+    }
+
+    // 2)  Only active variables couple the blocks (inactive ones, e.g. fixed bodies, are never written).
+    std::unordered_map<ChVariables*, int> var_index;
+    var_index.reserve(mvariables.size());
+    for (int iv = 0; iv < (int)mvariables.size(); iv++) {
+        if (mvariables[iv]->IsActive())
+            var_index[mvariables[iv]] = iv;
+    }
+
+    // 3)  Greedy coloring: assign to each block the smallest color not yet used by any of its variables.
+    int nblocks = (int)block_start.size();
+    std::vector<int> block_color(nblocks, -1);
+    std::vector<std::vector<int>> var_colors(mvariables.size());
+    std::vector<int> color_mark;
+    std::vector<int> color_count;
+    std::vector<ChVariables*> bvars;
+    std::vector<int> bvar_ids;
+
+    serial_blocks.clear();
+
+    for (int ib = 0; ib < nblocks; ib++) {
+        bvars.clear();
+        bool known = true;
+        for (int k = 0; k < block_size[ib]; k++)
+            known = mconstraints[block_start[ib] + k]->GetConstrainedVariables(bvars) && known;
+
+        if (!known) {
+            serial_blocks.push_back(ib);
+            continue;
+        }
+
+        bvar_ids.clear();
+        for (auto var : bvars) {
+            auto it = var_index.find(var);
+            if (it != var_index.end())
+                bvar_ids.push_back(it->second);
+        }
+
+        for (auto id : bvar_ids)
+            for (auto c : var_colors[id])
+                color_mark[c] = ib;
+
+        int color = 0;
+        while (color < (int)color_mark.size() && color_mark[color] == ib)
+            color++;
+        if (color == (int)color_mark.size()) {
+            color_mark.push_back(-1);
+            color_count.push_back(0);
+        }
+
+        block_color[ib] = color;
+        color_count[color]++;
+
+        for (auto id : bvar_ids)
+            if (var_colors[id].empty() || var_colors[id].back() != color)
+                var_colors[id].push_back(color);
+    }
+
+    // 4)  Sort the blocks by color (stable, so that the sweep order is reproducible).
+    int ncolors = (int)color_count.size();
+    color_offsets.assign(ncolors + 1, 0);
+    for (int c = 0; c < ncolors; c++)
+        color_offsets[c + 1] = color_offsets[c] + color_count[c];
+
+    color_blocks.resize(color_offsets[ncolors]);
+    std::vector<int> fill(color_offsets.begin(), color_offsets.end() - 1);
+    for (int ib = 0; ib < nblocks; ib++) {
+        if (block_color[ib] >= 0)
+            color_blocks[fill[block_color[ib]]++] = ib;
+    }
+}
+
+double ChSolverSORcolored::SolveBlock(std::vector<ChConstraint*>& mconstraints, int iblock, double& maxdeltalambda) {
+    int ic = block_start[iblock];
+
+    if (block_size[iblock] == 3) {
+        // Frictional contact: update the N,U,V multipliers, then project on the friction cone.
+        double old_lambda_friction[3];
+        double violation = 0;
+
+        for (int k = 0; k < 3; k++) {
+            ChConstraint* mc = mconstraints[ic + k];
+
+            // compute residual  c_i = [Cq_i]*q + b_i + cfm_i*l_i
+            double mresidual = mc->Compute_Cq_q() + mc->Get_b_i() + mc->Get_cfm_i() * mc->Get_l_i();
+
+            if (k == 0)
+                violation = fabs(ChMin(0.0, mresidual));
+
+            // compute:  delta_lambda = -(omega/g_i) * ([Cq_i]*q + b_i + cfm_i*l_i )
+            double deltal = (omega / mc->Get_g_i()) * (-mresidual);
+
+            // update:   lambda += delta_lambda;
+            old_lambda_friction[k] = mc->Get_l_i();
+            mc->Set_l_i(old_lambda_friction[k] + deltal);
+        }
+
+        mconstraints[ic]->Project();  // the N normal component will take care of N,U,V
+
+        for (int k = 0; k < 3; k++) {
+            ChConstraint* mc = mconstraints[ic + k];
+            double new_lambda = mc->Get_l_i();
+
+            // Apply the smoothing: lambda= sharpness*lambda_new_projected + (1-sharpness)*lambda_old
+            if (this->shlambda != 1.0) {
+                new_lambda = shlambda * new_lambda + (1.0 - shlambda) * old_lambda_friction[k];
+                mc->Set_l_i(new_lambda);
+            }
+
+            double true_delta = new_lambda - old_lambda_friction[k];
+            mc->Increment_q(true_delta);
+
+            if (this->record_violation_history)
+                maxdeltalambda = ChMax(maxdeltalambda, fabs(true_delta));
+        }
+
+        return violation;
+    }
+
+    ChConstraint* mc = mconstraints[ic];
+
+    // compute residual  c_i = [Cq_i]*q + b_i + cfm_i*l_i
+    double mresidual = mc->Compute_Cq_q() + mc->Get_b_i() + mc->Get_cfm_i() * mc->Get_l_i();
+
+    // true constraint violation may be different from 'mresidual' (ex:clamped if unilateral)
+    double violation = fabs(mc->Violation(mresidual));
+
+    // compute:  delta_lambda = -(omega/g_i) * ([Cq_i]*q + b_i + cfm_i*l_i )
+    double deltal = (omega / mc->Get_g_i()) * (-mresidual);
+
+    // update:   lambda += delta_lambda;
+    double old_lambda = mc->Get_l_i();
+    mc->Set_l_i(old_lambda + deltal);
+
+    // If new lagrangian multiplier does not satisfy inequalities, project
+    // it into an admissible orthant (or, in general, onto an admissible set)
+    mc->Project();
+
+    // After projection, the lambda may have changed a bit..
+    double new_lambda = mc->Get_l_i();
+
+    // Apply the smoothing: lambda= sharpness*lambda_new_projected + (1-sharpness)*lambda_old
+    if (this->shlambda != 1.0) {
+        new_lambda = shlambda * new_lambda + (1.0 - shlambda) * old_lambda;
+        mc->Set_l_i(new_lambda);
+    }
+
+    double true_delta = new_lambda - old_lambda;
+
+    // For all items with variables, add the effect of incremented
+    // (and projected) lagrangian reactions:
+    mc->Increment_q(true_delta);
+
+    if (this->record_violation_history)
+        maxdeltalambda = ChMax(maxdeltalambda, fabs(true_delta));
+
+    return violation;
+}
+
+double ChSolverSORcolored::Solve(ChSystemDescriptor& sysd  ///< system description with constraints and variables
+                                 ) {
+    std::vector<ChConstraint*>& mconstraints = sysd.GetConstraintsList();
+    std::vector<ChVariables*>& mvariables = sysd.GetVariablesList();
+
+    int nthreads = ChMax(1, sysd.GetNumThreads());
+
+    tot_iterations = 0;
+    double maxviolation = 0.;
+    double maxdeltalambda = 0.;
+
+    // 1)  Update auxiliary data in all constraints before starting,
+    //     that is: g_i=[Cq_i]*[invM_i]*[Cq_i]' and  [Eq_i]=[invM_i]*[Cq_i]'
+    //     Each constraint only writes its own data, so this can be done in parallel.
+#pragma omp parallel for num_threads(nthreads) schedule(static)
+    for (int ic = 0; ic < (int)mconstraints.size(); ic++)
+        mconstraints[ic]->Update_auxiliary();
+
+    // Average all g_i for the triplet of contact constraints n,u,v.
+    //
+    int j_friction_comp = 0;
+    double gi_values[3];
+    for (unsigned int ic = 0; ic < mconstraints.size(); ic++) {
+        if (mconstraints[ic]->GetMode() == CONSTRAINT_FRIC) {
+            gi_values[j_friction_comp] = mconstraints[ic]->Get_g_i();
+            j_friction_comp++;
+            if (j_friction_comp == 3) {
+                double average_g_i = (gi_values[0] + gi_values[1] + gi_values[2]) / 3.0;
+                mconstraints[ic - 2]->Set_g_i(average_g_i);
+                mconstraints[ic - 1]->Set_g_i(average_g_i);
+                mconstraints[ic - 0]->Set_g_i(average_g_i);
+                j_friction_comp = 0;
+            }
+        }
+    }
+
+    // 2)  Compute, for all items with variables, the initial guess for
+    //     still unconstrained system:
+#pragma omp parallel for num_threads(nthreads) schedule(static)
+    for (int iv = 0; iv < (int)mvariables.size(); iv++) {
+        if (mvariables[iv]->IsActive())
+            mvariables[iv]->Compute_invMb_v(mvariables[iv]->Get_qb(), mvariables[iv]->Get_fb());  // q = [M]'*fb
+    }
+
+    // 3)  Partition the constraints in independent sets.
+    ColorConstraints(mconstraints, mvariables);
+    int ncolors = GetNumColors();
+
+    // 4)  For all items with variables, add the effect of initial (guessed)
+    //     lagrangian reactions of constraints, if a warm start is desired.
+    //     Otherwise, if no warm start, simply resets initial lagrangians to zero.
+    if (warm_start) {
+        for (int color = 0; color < ncolors; color++) {
+            int start = color_offsets[color];
+            int end = color_offsets[color + 1];
+#pragma omp parallel for num_threads(nthreads) schedule(static) if (end - start > min_parallel_blocks)
+            for (int i = start; i < end; i++) {
+                int ib = color_blocks[i];
+                for (int k = 0; k < block_size[ib]; k++)
+                    mconstraints[block_start[ib] + k]->Increment_q(mconstraints[block_start[ib] + k]->Get_l_i());
+            }
+        }
+        for (auto ib : serial_blocks) {
+            for (int k = 0; k < block_size[ib]; k++)
+                mconstraints[block_start[ib] + k]->Increment_q(mconstraints[block_start[ib] + k]->Get_l_i());
+        }
+    } else {
+        for (unsigned int ic = 0; ic < mconstraints.size(); ic++)
+            mconstraints[ic]->Set_l_i(0.);
+    }
+
+    // 5)  Perform the iteration loops, sweeping colors in sequence and the blocks
+    //     of each color in parallel. Per-thread maxima are merged at the end of each iteration.
+    //
+    std::vector<double> thread_violation(nthreads);
+    std::vector<double> thread_deltalambda(nthreads);
+
+    for (int iter = 0; iter < max_iterations; iter++) {
+        std::fill(thread_violation.begin(), thread_violation.end(), 0.0);
+        std::fill(thread_deltalambda.begin(), thread_deltalambda.end(), 0.0);
+
+        for (int color = 0; color < ncolors; color++) {
+            int start = color_offsets[color];
+            int end = color_offsets[color + 1];
+#pragma omp parallel for num_threads(nthreads) schedule(static) if (end - start > min_parallel_blocks)
+            for (int i = start; i < end; i++) {
+                int tid = CHOMPfunctions::GetThreadNum();
+                double violation = SolveBlock(mconstraints, color_blocks[i], thread_deltalambda[tid]);
+                thread_violation[tid] = ChMax(thread_violation[tid], violation);
+            }
+        }
+
+        // Blocks with unknown connectivity may touch any variable: sweep them serially.
+        for (auto ib : serial_blocks) {
+            double violation = SolveBlock(mconstraints, ib, thread_deltalambda[0]);
+            thread_violation[0] = ChMax(thread_violation[0], violation);
+        }
+
+        maxviolation = 0;
+        maxdeltalambda = 0;
+        for (int t = 0; t < nthreads; t++) {
+            maxviolation = ChMax(maxviolation, thread_violation[t]);
+            maxdeltalambda = ChMax(maxdeltalambda, thread_deltalambda[t]);
+        }
+
+        // For recording into violation history, if debugging
+        if (this->record_violation_history)
+            AtIterationEnd(maxviolation, maxdeltalambda, iter);
+
+        tot_iterations++;
+        // Terminate the loop if violation in constraints has been successfully limited.
+        if (maxviolation < tolerance)
+            break;
+
+    }  // end iteration loop
+
+    return maxviolation;
+}
+
+}  // end namespace chrono
@@ -0,0 +1,75 @@
+// =============================================================================
+// PROJECT CHRONO - http://projectchrono.org
+//
+// Copyright (c) 2014 projectchrono.org
+// All rights reserved.
+//
+// Use of this source code is governed by a BSD-style license that can be found
+// in the LICENSE file at the top level of the distribution and at
+// http://projectchrono.org/license-chrono.txt.
+//
+// =============================================================================
+
+#ifndef CHSOLVERSORCOLORED_H
+#define CHSOLVERSORCOLORED_H
+
+#include <vector>
+
+#include "chrono/solver/ChIterativeSolver.h"
+
+namespace chrono {
+
+/// An iterative solver based on projective fixed point method, with overrelaxation
+/// and immediate variable update as in SOR methods. Multi-threaded with OpenMP.\n
+/// At the beginning of each Solve() the constraints are grouped in blocks (a single
+/// constraint, or the N,U,V triplet of a frictional contact) and the block-variable graph
+/// is colored so that blocks sharing an active ChVariables object never share a color.
+/// Each color is then swept in parallel; since blocks in the same color are independent,
+/// the result does not depend on the number of threads. Constraints that do not report
+/// their variables (see ChConstraint::GetConstrainedVariables) are swept serially after
+/// all colors.\n
+/// The friction-cone projection, overrelaxation, sharpness and warm start follow ChSolverSOR.
+/// The number of threads is taken from the ChSystemDescriptor (see ChSystem::SetParallelThreadNumber).\n
+/// See ChSystemDescriptor for more information about the problem formulation and the data structures
+/// passed to the solver.
+
+class ChApi ChSolverSORcolored : public ChIterativeSolver {
+
+  public:
+    ChSolverSORcolored(int mmax_iters = 50,       ///< max.number of iterations
+                       bool mwarm_start = false,  ///< uses warm start?
+                       double mtolerance = 0.0,   ///< tolerance for termination criterion
+                       double momega = 1.0        ///< overrelaxation criterion
+                       )
+        : ChIterativeSolver(mmax_iters, mwarm_start, mtolerance, momega) {}
+
+    virtual ~ChSolverSORcolored() {}
+
+    virtual Type GetType() const override { return Type::SOR_COLORED; }
+
+    /// Performs the solution of the problem.
+    /// \return  the maximum constraint violation after termination.
+    virtual double Solve(ChSystemDescriptor& sysd  ///< system description with constraints and variables
+                         ) override;
+
+    /// Return the number of colors used in the last call to Solve() (0 if Solve() was not called yet).
+    int GetNumColors() const { return color_offsets.empty() ? 0 : (int)color_offsets.size() - 1; }
+
+  private:
+    /// Group the constraints in blocks and color the block-variable graph.
+    void ColorConstraints(std::vector<ChConstraint*>& mconstraints, std::vector<ChVariables*>& mvariables);
+
+    /// Perform one projected SOR update on the given block.
+    /// Return the constraint violation; the maximum change in multipliers is accumulated in 'maxdeltalambda'.
+    double SolveBlock(std::vector<ChConstraint*>& mconstraints, int iblock, double& maxdeltalambda);
+
+    std::vector<int> block_start;    ///< index of the first constraint in each block
+    std::vector<int> block_size;     ///< number of constraints in each block (1, or 3 for friction)
+    std::vector<int> color_offsets;  ///< start of each color in 'color_blocks' (size = num. colors + 1)
+    std::vector<int> color_blocks;   ///< block indices, sorted by color
+    std::vector<int> serial_blocks;  ///< blocks with unknown connectivity, processed serially
+};
+
+}  // end namespace chrono
+
+#endif
@@ -0,0 +1,123 @@
+// =============================================================================
+// PROJECT CHRONO - http://projectchrono.org
+//
+// Copyright (c) 2014 projectchrono.org
+// All rights reserved.
+//
+// Use of this source code is governed by a BSD-style license that can be found
+// in the LICENSE file at the top level of the distribution and at
+// http://projectchrono.org/license-chrono.txt.
+//
+// =============================================================================
+
+#include "chrono/solver/ChSolverSparseLU.h"
+
+namespace chrono {
+
+// Register into the object factory, to enable run-time dynamic creation and persistence
+CH_FACTORY_REGISTER(ChSolverSparseLU)
+
+bool ChSolverSparseLU::Setup(ChSystemDescriptor& sysd) {
+    m_timer_setup_assembly.start();
+
+    int n_q = sysd.CountActiveVariables();
+    m_dim = n_q + sysd.CountActiveConstraints();
+
+    // Perform an initial resizing at the first call (or at each call, if the sparsity pattern is not locked).
+    if (!m_lock || m_setup_call == 0)
+        m_mat.Reset(m_dim, m_dim, static_cast<int>(m_dim * (m_dim * SPM_DEF_FULLNESS)));
+
+    sysd.ConvertToMatrixForm(&m_mat, nullptr);
+    m_mat.Compress();
+
+    m_timer_setup_assembly.stop();
+
+    // Symbolic analysis, only if the sparsity pattern changed.
+    // The system variables are grouped by ChVariables objects (contiguous in the assembled matrix).
+    m_timer_setup_analysis.start();
+    bool success = true;
+    if (!m_engine.IsAnalyzed(m_mat)) {
+        std::vector<int> block_ptr(1, 0);
+        for (auto var : sysd.GetVariablesList()) {
+            if (var->IsActive() && var->Get_ndof() > 0)
+                block_ptr.push_back(var->GetOffset() + var->Get_ndof());
+        }
+        success = m_engine.Analyze(m_mat, block_ptr, n_q);
+        m_analysis_call++;
+    }
+    m_timer_setup_analysis.stop();
+
+    // Numeric factorization.
+    m_timer_setup_factorization.start();
+    m_engine.SetNumThreads(sysd.GetNumThreads());
+    success = success && m_engine.Factorize(m_mat);
+    m_timer_setup_factorization.stop();
+
+    m_setup_call++;
+
+    if (verbose) {
+        GetLog() << " SparseLU setup n = " << m_dim << "  nnz = " << m_mat.GetNNZ()
+                 << "  nnz(L) = " << m_engine.GetNumNonZerosL() << "  levels = " << m_engine.GetNumLevels()
+                 << "\n";
+        GetLog() << "  assembly: " << m_timer_setup_assembly.GetTimeSecondsIntermediate() << "s"
+                 << "  analysis: " << m_timer_setup_analysis.GetTimeSecondsIntermediate() << "s"
+                 << "  factorization: " << m_timer_setup_factorization.GetTimeSecondsIntermediate() << "s\n";
+        if (m_engine.GetNumPerturbedPivots() > 0)
+            GetLog() << "  perturbed pivots: " << m_engine.GetNumPerturbedPivots() << "\n";
+    }
+
+    if (!success) {
+        GetLog() << "SparseLU factorization failed\n";
+        return false;
+    }
+
+    return true;
+}
+
+double ChSolverSparseLU::Solve(ChSystemDescriptor& sysd) {
+    // Assemble the problem right-hand side vector.
+    m_timer_solve_assembly.start();
+    sysd.ConvertToMatrixForm(nullptr, &m_rhs);
+    m_timer_solve_assembly.stop();
+
+    // Forward and backward substitutions.
+    m_timer_solve_solvercall.start();
+    m_engine.Solve(m_rhs, m_sol);
+    m_timer_solve_solvercall.stop();
+
+    m_solve_call++;
+
+    if (verbose) {
+        GetLog() << " SparseLU solve call " << m_solve_call << "\n";
+        GetLog() << "  assembly: " << m_timer_solve_assembly.GetTimeSecondsIntermediate() << "s"
+                 << "  solver_call: " << m_timer_solve_solvercall.GetTimeSecondsIntermediate() << "s\n";
+    }
+
+    // Scatter solution vector to the system descriptor.
+    m_timer_solve_assembly.start();
+    sysd.FromVectorToUnknowns(m_sol);
+    m_timer_solve_assembly.stop();
+
+    return 0.0;
+}
+
+void ChSolverSparseLU::ArchiveOUT(ChArchiveOut& marchive) {
+    // version number
+    marchive.VersionWrite<ChSolverSparseLU>();
+    // serialize parent class
+    ChSolver::ArchiveOUT(marchive);
+    // serialize all member data:
+    marchive << CHNVP(m_lock);
+}
+
+void ChSolverSparseLU::ArchiveIN(ChArchiveIn& marchive) {
+    // version number
+    int version = marchive.VersionRead<ChSolverSparseLU>();
+    // deserialize parent class
+    ChSolver::ArchiveIN(marchive);
+    // stream in all member data:
+    marchive >> CHNVP(m_lock);
+    SetSparsityPatternLock(m_lock);
+}
+
+}  // end namespace chrono
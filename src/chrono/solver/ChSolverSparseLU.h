@@ -0,0 +1,145 @@
+// =============================================================================
+// PROJECT CHRONO - http://projectchrono.org
+//
+// Copyright (c) 2014 projectchrono.org
+// All rights reserved.
+//
+// Use of this source code is governed by a BSD-style license that can be found
+// in the LICENSE file at the top level of the distribution and at
+// http://projectchrono.org/license-chrono.txt.
+//
+// =============================================================================
+
+#ifndef CHSOLVERSPARSELU_H
+#define CHSOLVERSPARSELU_H
+
+#include "chrono/core/ChCSMatrix.h"
+#include "chrono/core/ChMatrixDynamic.h"
+#include "chrono/core/ChTimer.h"
+#include "chrono/solver/ChSolver.h"
+#include "chrono/solver/ChSparseLUEngine.h"
+
+namespace chrono {
+
+/// @addtogroup chrono_solver
+/// @{
+
+/** \class ChSolverSparseLU
+\brief Native sparse direct solver.
+
+Sparse linear direct solver, based on the LDU (or LDL', for symmetric problems) factorization implemented in
+ChSparseLUEngine. It does not require any external library.
+Cannot handle VI and complementarity problems, so it cannot be used with NSC formulations.
+
+The system variables are ordered first (grouped by ChVariables objects, using a minimum degree ordering),
+followed by the constraint multipliers. The symbolic analysis is reused as long as the sparsity pattern of the
+system matrix does not change; enabling the sparsity pattern \e lock (see #SetSparsityPatternLock) also speeds up
+the assembly of the matrix. The numeric factorization uses the number of threads set in the ChSystemDescriptor
+(see ChSystem::SetParallelThreadNumber); results do not depend on the number of threads.
+
+Minimal usage example, to be put anywhere in the code, before starting the main simulation loop:
+\code{.cpp}
+auto lu_solver = std::make_shared<ChSolverSparseLU>();
+system.SetSolver(lu_solver);
+\endcode
+
+See ChSystemDescriptor for more information about the problem formulation and the data structures
+passed to the solver.
+*/
+class ChApi ChSolverSparseLU : public ChSolver {
+  public:
+    ChSolverSparseLU() {}
+
+    ~ChSolverSparseLU() override {}
+
+    /// Get a handle to the underlying factorization engine.
+    ChSparseLUEngine& GetEngine() { return m_engine; }
+
+    /// Get a handle to the underlying matrix.
+    ChCSMatrix& GetMatrix() { return m_mat; }
+
+    /// Enable/disable locking the sparsity pattern (default: false).\n
+    /// If \a val is set to true, then the sparsity pattern of the problem matrix is assumed
+    /// to be unchanged from call to call.
+    void SetSparsityPatternLock(bool val) {
+        m_lock = val;
+        m_mat.SetSparsityPatternLock(m_lock);
+    }
+
+    /// Enable/disable the symmetric mode (default: false).\n
+    /// If \a val is set to true, an LDL' factorization is used, which halves the work of the factorization.
+    /// Only use it if the system matrix is known to be symmetric.
+    void SetSymmetric(bool val) { m_engine.SetSymmetric(val); }
+
+    /// Set the relative tolerance for small pivots (default: 1e-10).
+    void SetPivotTolerance(double tol) { m_engine.SetPivotTolerance(tol); }
+
+    /// Reset timers for internal phases in Solve and Setup.
+    void ResetTimers() {
+        m_timer_setup_assembly.reset();
+        m_timer_setup_analysis.reset();
+        m_timer_setup_factorization.reset();
+        m_timer_solve_assembly.reset();
+        m_timer_solve_solvercall.reset();
+    }
+
+    /// Get cumulative time for assembly operations in Solve phase.
+    double GetTimeSolve_Assembly() const { return m_timer_solve_assembly(); }
+    /// Get cumulative time for forward/backward substitutions in Solve phase.
+    double GetTimeSolve_SolverCall() const { return m_timer_solve_solvercall(); }
+    /// Get cumulative time for assembly operations in Setup phase.
+    double GetTimeSetup_Assembly() const { return m_timer_setup_assembly(); }
+    /// Get cumulative time for symbolic analysis in Setup phase.
+    double GetTimeSetup_Analysis() const { return m_timer_setup_analysis(); }
+    /// Get cumulative time for numeric factorization in Setup phase.
+    double GetTimeSetup_Factorization() const { return m_timer_setup_factorization(); }
+    /// Return the number of calls to the solver's Setup function.
+    int GetNumSetupCalls() const { return m_setup_call; }
+    /// Return the number of calls to the solver's Solve function.
+    int GetNumSolveCalls() const { return m_solve_call; }
+    /// Return the number of symbolic analyses performed (at most one per Setup call).
+    int GetNumAnalysisCalls() const { return m_analysis_call; }
+
+    /// Indicate whether or not the #Solve() phase requires an up-to-date problem matrix.
+    /// As typical of direct solvers, this solver only requires the matrix for its #Setup() phase.
+    virtual bool SolveRequiresMatrix() const override { return false; }
+
+    /// Perform the solver setup operations.
+    /// This means assembling the system matrix, performing the symbolic analysis (if the sparsity pattern
+    /// changed) and the numeric factorization. Returns true if successful and false otherwise.
+    virtual bool Setup(ChSystemDescriptor& sysd) override;
+
+    /// Solve using the factorization obtained at the last call to Setup().
+    virtual double Solve(ChSystemDescriptor& sysd) override;
+
+    /// Method to allow serialization of transient data to archives.
+    virtual void ArchiveOUT(ChArchiveOut& marchive) override;
+
+    /// Method to allow de serialization of transient data from archives.
+    virtual void ArchiveIN(ChArchiveIn& marchive) override;
+
+  private:
+    ChSparseLUEngine m_engine;      ///< factorization engine
+    ChCSMatrix m_mat = {1, 1};      ///< problem matrix
+    ChMatrixDynamic<double> m_rhs;  ///< right-hand side vector
+    ChMatrixDynamic<double> m_sol;  ///< solution vector
+
+    int m_dim = 0;            ///< problem size
+    int m_solve_call = 0;     ///< counter for calls to Solve
+    int m_setup_call = 0;     ///< counter for calls to Setup
+    int m_analysis_call = 0;  ///< counter for symbolic analyses
+
+    bool m_lock = false;  ///< is the matrix sparsity pattern locked?
+
+    ChTimer<> m_timer_setup_assembly;       ///< timer for matrix assembly
+    ChTimer<> m_timer_setup_analysis;       ///< timer for symbolic analysis
+    ChTimer<> m_timer_setup_factorization;  ///< timer for numeric factorization
+    ChTimer<> m_timer_solve_assembly;       ///< timer for RHS assembly
+    ChTimer<> m_timer_solve_solvercall;     ///< timer for solution
+};
+
+/// @} chrono_solver
+
+}  // end namespace chrono
+
+#endif
@@ -0,0 +1,693 @@
+// =============================================================================
+// PROJECT CHRONO - http://projectchrono.org
+//
+// Copyright (c) 2014 projectchrono.org
+// All rights reserved.
+//
+// Use of this source code is governed by a BSD-style license that can be found
+// in the LICENSE file at the top level of the distribution and at
+// http://projectchrono.org/license-chrono.txt.
+//
+// =============================================================================
+
+#include <algorithm>
+#include <cmath>
+
+#include "chrono/parallel/ChOpenMP.h"
+#include "chrono/solver/ChSparseLUEngine.h"
+
+namespace chrono {
+
+ChSparseLUEngine::ChSparseLUEngine()
+    : m_symmetric(false),
+      m_nthreads(1),
+      m_pivot_tol(1e-10),
+      m_n(0),
+      m_nnz_L(0),
+      m_Ax(nullptr),
+      m_num_perturbed(0) {}
+
+// -----------------------------------------------------------------------------
+// Symbolic analysis
+// -----------------------------------------------------------------------------
+
+bool ChSparseLUEngine::Analyze(const ChCSMatrix& A, const std::vector<int>& block_ptr, int n_primary) {
+    if (!A.IsRowMajor() || !A.IsCompressed() || A.GetNumRows() != A.GetNumColumns())
+        return false;
+
+    m_n = A.GetNumRows();
+    const int* Ap = A.GetCS_LeadingIndexArray();
+    const int* Aj = A.GetCS_TrailingIndexArray();
+    m_A_lead.assign(Ap, Ap + m_n + 1);
+    m_A_trail.assign(Aj, Aj + Ap[m_n]);
+
+    // 1) Fill-reducing ordering
+    ComputeOrdering(A, block_ptr, n_primary < 0 ? m_n : std::min(n_primary, m_n));
+
+    // 2) Symmetrized pattern of the permuted matrix (adjacency lists, no diagonal)
+    std::vector<int> Sp(m_n + 1, 0);
+    for (int r = 0; r < m_n; r++) {
+        for (int k = Ap[r]; k < Ap[r + 1]; k++) {
+            if (Aj[k] != r) {
+                Sp[m_iperm[r] + 1]++;
+                Sp[m_iperm[Aj[k]] + 1]++;
+            }
+        }
+    }
+    for (int i = 0; i < m_n; i++)
+        Sp[i + 1] += Sp[i];
+    std::vector<int> Si(Sp[m_n]);
+    std::vector<int> next(Sp.begin(), Sp.end() - 1);
+    for (int r = 0; r < m_n; r++) {
+        for (int k = Ap[r]; k < Ap[r + 1]; k++) {
+            if (Aj[k] != r) {
+                int pr = m_iperm[r];
+                int pc = m_iperm[Aj[k]];
+                Si[next[pr]++] = pc;
+                Si[next[pc]++] = pr;
+            }
+        }
+    }
+
+    // 3) Elimination tree (Liu's algorithm, with path compression)
+    m_parent.assign(m_n, -1);
+    std::vector<int> ancestor(m_n, -1);
+    for (int j = 0; j < m_n; j++) {
+        for (int k = Sp[j]; k < Sp[j + 1]; k++) {
+            int r = Si[k];
+            if (r >= j)
+                continue;
+            while (ancestor[r] != -1 && ancestor[r] != j) {
+                int t = ancestor[r];
+                ancestor[r] = j;
+                r = t;
+            }
+            if (ancestor[r] == -1) {
+                ancestor[r] = j;
+                m_parent[r] = j;
+            }
+        }
+    }
+
+    // 4) Row structure of L: the pattern of row j is the set of nodes reached in the elimination tree,
+    //    starting from the non-zeros A(j,k), k<j, and stopping at j.
+    std::vector<int> mark(m_n, -1);
+    std::vector<int> Rp(m_n + 1, 0);
+    std::vector<int> Rj;
+    for (int j = 0; j < m_n; j++) {
+        mark[j] = j;
+        for (int k = Sp[j]; k < Sp[j + 1]; k++) {
+            for (int r = Si[k]; r < j && mark[r] != j; r = m_parent[r]) {
+                Rj.push_back(r);
+                mark[r] = j;
+            }
+        }
+        Rp[j + 1] = (int)Rj.size();
+    }
+
+    // 5) Column counts of L (strictly lower part) and last row entry of each column
+    std::vector<int> count(m_n, 0);
+    for (auto k : Rj)
+        count[k]++;
+
+    // 6) Supernodes: column j+1 joins the supernode of column j if it is the parent of j and the structure of
+    //    column j is that of column j+1, plus row j+1 (i.e. the counts differ by one).
+    m_sn_ptr.assign(1, 0);
+    std::vector<int> sn_of(m_n);
+    for (int j = 0; j < m_n; j++) {
+        if (j > 0 && !(m_parent[j - 1] == j && count[j - 1] == count[j] + 1))
+            m_sn_ptr.push_back(j);
+        sn_of[j] = (int)m_sn_ptr.size() - 1;
+    }
+    m_sn_ptr.push_back(m_n);
+    int num_sn = (int)m_sn_ptr.size() - 1;
+
+    // Row lists of the supernodes (the columns of the supernode, then the structure of its last column) and
+    // sizes of the dense panels
+    m_sn_rowp.assign(num_sn + 1, 0);
+    m_sn_xp.assign(num_sn + 1, 0);
+    m_nnz_L = 0;
+    for (int s = 0; s < num_sn; s++) {
+        int nc = m_sn_ptr[s + 1] - m_sn_ptr[s];
+        int m = nc + count[m_sn_ptr[s + 1] - 1];
+        m_sn_rowp[s + 1] = m_sn_rowp[s] + m;
+        m_sn_xp[s + 1] = m_sn_xp[s] + (size_t)m * nc;
+        m_nnz_L += (size_t)nc * (nc - 1) / 2 + (size_t)nc * (m - nc);
+    }
+    m_sn_rows.resize(m_sn_rowp[num_sn]);
+    next.assign(num_sn, 0);
+    for (int s = 0; s < num_sn; s++) {
+        next[s] = m_sn_rowp[s];
+        for (int j = m_sn_ptr[s]; j < m_sn_ptr[s + 1]; j++)
+            m_sn_rows[next[s]++] = j;
+    }
+    for (int j = 0; j < m_n; j++) {
+        // row j of L, restricted to the last columns of the supernodes (rows are visited in increasing order)
+        for (int q = Rp[j]; q < Rp[j + 1]; q++) {
+            int k = Rj[q];
+            int s = sn_of[k];
+            if (k == m_sn_ptr[s + 1] - 1)
+                m_sn_rows[next[s]++] = j;
+        }
+    }
+
+    // Supernodes updating each supernode: those owning a column k with L(j,k) != 0, for a column j of the supernode
+    m_upd_ptr.assign(num_sn + 1, 0);
+    m_upd.clear();
+    std::fill(mark.begin(), mark.end(), -1);
+    for (int s = 0; s < num_sn; s++) {
+        for (int j = m_sn_ptr[s]; j < m_sn_ptr[s + 1]; j++) {
+            for (int q = Rp[j]; q < Rp[j + 1]; q++) {
+                int t = sn_of[Rj[q]];
+                if (t != s && mark[t] != s) {
+                    mark[t] = s;
+                    m_upd.push_back(t);
+                }
+            }
+        }
+        std::sort(m_upd.begin() + m_upd_ptr[s], m_upd.end());
+        m_upd_ptr[s + 1] = (int)m_upd.size();
+    }
+
+    // Levels of the supernodal elimination tree (a supernode only depends on its descendants)
+    std::vector<int> level(num_sn, 0);
+    int num_levels = 0;
+    for (int s = 0; s < num_sn; s++) {
+        num_levels = std::max(num_levels, level[s] + 1);
+        int parent = m_parent[m_sn_ptr[s + 1] - 1];
+        if (parent != -1)
+            level[sn_of[parent]] = std::max(level[sn_of[parent]], level[s] + 1);
+    }
+    m_level_ptr.assign(num_levels + 1, 0);
+    for (int s = 0; s < num_sn; s++)
+        m_level_ptr[level[s] + 1]++;
+    for (int l = 0; l < num_levels; l++)
+        m_level_ptr[l + 1] += m_level_ptr[l];
+    m_level_sn.resize(num_sn);
+    next.assign(m_level_ptr.begin(), m_level_ptr.end() - 1);
+    for (int s = 0; s < num_sn; s++)
+        m_level_sn[next[level[s]]++] = s;
+
+    // 7) Map the entries of A to the permuted lower triangle (by columns) and strictly upper triangle (by rows)
+    m_Alp.assign(m_n + 1, 0);
+    m_Aup.assign(m_n + 1, 0);
+    for (int r = 0; r < m_n; r++) {
+        for (int k = Ap[r]; k < Ap[r + 1]; k++) {
+            int pr = m_iperm[r];
+            int pc = m_iperm[Aj[k]];
+            if (pr >= pc)
+                m_Alp[pc + 1]++;
+            else
+                m_Aup[pr + 1]++;
+        }
+    }
+    for (int j = 0; j < m_n; j++) {
+        m_Alp[j + 1] += m_Alp[j];
+        m_Aup[j + 1] += m_Aup[j];
+    }
+    m_Ali.resize(m_Alp[m_n]);
+    m_Als.resize(m_Alp[m_n]);
+    m_Auj.resize(m_Aup[m_n]);
+    m_Aus.resize(m_Aup[m_n]);
+    next.assign(m_Alp.begin(), m_Alp.end() - 1);
+    std::vector<int> next_u(m_Aup.begin(), m_Aup.end() - 1);
+    for (int r = 0; r < m_n; r++) {
+        for (int k = Ap[r]; k < Ap[r + 1]; k++) {
+            int pr = m_iperm[r];
+            int pc = m_iperm[Aj[k]];
+            if (pr >= pc) {
+                m_Ali[next[pc]] = pr;
+                m_Als[next[pc]++] = k;
+            } else {
+                m_Auj[next_u[pr]] = pc;
+                m_Aus[next_u[pr]++] = k;
+            }
+        }
+    }
+
+    m_Lx.resize(m_sn_xp[num_sn]);
+    m_D.resize(m_n);
+
+    return true;
+}
+
+bool ChSparseLUEngine::IsAnalyzed(const ChCSMatrix& A) const {
+    if (!A.IsCompressed() || A.GetNumRows() != m_n || (int)m_A_lead.size() != m_n + 1)
+        return false;
+    const int* Ap = A.GetCS_LeadingIndexArray();
+    const int* Aj = A.GetCS_TrailingIndexArray();
+    return std::equal(m_A_lead.begin(), m_A_lead.end(), Ap) && std::equal(m_A_trail.begin(), m_A_trail.end(), Aj);
+}
+
+// Minimum degree ordering of the graph of the primary blocks, followed by the remaining unknowns. Each of the
+// latter is placed after the last primary unknown it is coupled with.
+// The ordering works on the quotient graph: an eliminated block becomes an 'element', standing for the clique
+// formed by its neighbors, which is never built explicitly. Elements adjacent to the eliminated block are absorbed
+// in the new element. Degrees are weighted by the block sizes and are approximated as in the AMD algorithm
+// (Amestoy, Davis and Duff), from the sizes of the adjacent elements outside of the new element.
+void ChSparseLUEngine::ComputeOrdering(const ChCSMatrix& A, const std::vector<int>& block_ptr, int n_primary) {
+    const int* Ap = A.GetCS_LeadingIndexArray();
+    const int* Aj = A.GetCS_TrailingIndexArray();
+
+    // Map primary unknowns to blocks
+    bool valid = !block_ptr.empty() && block_ptr.front() == 0 && block_ptr.back() == n_primary &&
+                 std::is_sorted(block_ptr.begin(), block_ptr.end());
+    std::vector<int> bptr;
+    if (!valid) {
+        bptr.resize(n_primary + 1);
+        for (int i = 0; i <= n_primary; i++)
+            bptr[i] = i;
+    } else {
+        bptr = block_ptr;
+    }
+    int nb = (int)bptr.size() - 1;
+    std::vector<int> block(n_primary);
+    for (int b = 0; b < nb; b++)
+        for (int i = bptr[b]; i < bptr[b + 1]; i++)
+            block[i] = b;
+
+    // Block adjacency graph (sorted, no self loops): initial variable lists of the quotient graph
+    std::vector<std::vector<int>> vars(nb);
+    for (int r = 0; r < n_primary; r++) {
+        for (int k = Ap[r]; k < Ap[r + 1]; k++) {
+            int c = Aj[k];
+            if (c < n_primary && block[c] != block[r]) {
+                vars[block[r]].push_back(block[c]);
+                vars[block[c]].push_back(block[r]);
+            }
+        }
+    }
+
+    enum Status { VARIABLE, ELEMENT, ABSORBED };
+    std::vector<char> status(nb, VARIABLE);
+    std::vector<std::vector<int>> elems(nb);  // adjacent elements of each variable
+    std::vector<std::vector<int>> bound(nb);  // variables adjacent to each element
+    std::vector<int> esize(nb, 0);            // weighted size of each element
+    std::vector<int> weight(nb);
+    std::vector<int> degree(nb, 0);
+    for (int b = 0; b < nb; b++) {
+        std::sort(vars[b].begin(), vars[b].end());
+        vars[b].erase(std::unique(vars[b].begin(), vars[b].end()), vars[b].end());
+        weight[b] = bptr[b + 1] - bptr[b];
+    }
+
+    // Degree lists
+    int max_degree = n_primary;
+    std::vector<int> head(max_degree + 1, -1);
+    std::vector<int> dnext(nb, -1);
+    std::vector<int> dprev(nb, -1);
+    auto insert = [&](int b) {
+        int d = degree[b];
+        dprev[b] = -1;
+        dnext[b] = head[d];
+        if (head[d] != -1)
+            dprev[head[d]] = b;
+        head[d] = b;
+    };
+    auto remove = [&](int b) {
+        if (dprev[b] != -1)
+            dnext[dprev[b]] = dnext[b];
+        else
+            head[degree[b]] = dnext[b];
+        if (dnext[b] != -1)
+            dprev[dnext[b]] = dprev[b];
+    };
+    for (int b = nb - 1; b >= 0; b--) {
+        for (auto a : vars[b])
+            degree[b] += weight[a];
+        insert(b);
+    }
+
+    std::vector<int> border;
+    border.reserve(nb);
+    std::vector<int> mark(nb, -1);   // marks the variables of the new element
+    std::vector<int> wflag(nb, -1);  // marks the elements whose external size was computed
+    std::vector<int> wext(nb, 0);    // weighted size of an element, outside of the new element
+    std::vector<int> Lp;
+    int remaining = n_primary;
+    int min_degree = 0;
+    while ((int)border.size() < nb) {
+        while (head[min_degree] == -1)
+            min_degree++;
+        int p = head[min_degree];
+        remove(p);
+        border.push_back(p);
+        remaining -= weight[p];
+
+        // New element: adjacent variables of p and variables of the elements adjacent to p (which are absorbed)
+        Lp.clear();
+        int Lp_weight = 0;
+        mark[p] = p;
+        for (auto v : vars[p]) {
+            if (status[v] == VARIABLE && mark[v] != p) {
+                mark[v] = p;
+                Lp.push_back(v);
+                Lp_weight += weight[v];
+            }
+        }
+        for (auto e : elems[p]) {
+            if (status[e] != ELEMENT)
+                continue;
+            for (auto v : bound[e]) {
+                if (status[v] == VARIABLE && mark[v] != p) {
+                    mark[v] = p;
+                    Lp.push_back(v);
+                    Lp_weight += weight[v];
+                }
+            }
+            status[e] = ABSORBED;
+            std::vector<int>().swap(bound[e]);
+        }
+        status[p] = ELEMENT;
+        bound[p] = Lp;
+        esize[p] = Lp_weight;
+        std::vector<int>().swap(vars[p]);
+        std::vector<int>().swap(elems[p]);
+
+        // Sizes of the other elements adjacent to the new element, outside of it
+        for (auto i : Lp) {
+            for (auto e : elems[i]) {
+                if (status[e] != ELEMENT)
+                    continue;
+                if (wflag[e] != p) {
+                    wflag[e] = p;
+                    wext[e] = esize[e];
+                }
+                wext[e] -= weight[i];
+            }
+        }
+
+        // Update the variables of the new element
+        for (auto i : Lp) {
+            remove(i);
+
+            // Prune the element list; elements contained in the new element are absorbed
+            int ext_degree = 0;
+            size_t ne = 0;
+            for (auto e : elems[i]) {
+                if (status[e] != ELEMENT)
+                    continue;
+                if (wext[e] == 0) {
+                    status[e] = ABSORBED;
+                    continue;
+                }
+                ext_degree += wext[e];
+                elems[i][ne++] = e;
+            }
+            elems[i].resize(ne);
+            elems[i].push_back(p);
+
+            // Prune the variable list: variables of the new element are reached through it
+            size_t nv = 0;
+            for (auto v : vars[i]) {
+                if (status[v] != VARIABLE || mark[v] == p)
+                    continue;
+                ext_degree += weight[v];
+                vars[i][nv++] = v;
+            }
+            vars[i].resize(nv);
+
+            int d = ext_degree + Lp_weight - weight[i];
+            d = std::min(d, degree[i] + Lp_weight - weight[i]);
+            d = std::min(d, remaining - weight[i]);
+            degree[i] = std::max(d, 0);
+            insert(i);
+            min_degree = std::min(min_degree, degree[i]);
+        }
+    }
+
+    m_perm.clear();
+    m_perm.reserve(m_n);
+    m_iperm.assign(m_n, -1);
+    for (auto b : border) {
+        for (int i = bptr[b]; i < bptr[b + 1]; i++) {
+            m_iperm[i] = (int)m_perm.size();
+            m_perm.push_back(i);
+        }
+    }
+
+    // Order the remaining unknowns
+    std::vector<std::pair<int, int>> keys;
+    for (int r = n_primary; r < m_n; r++) {
+        int key = -1;
+        for (int k = Ap[r]; k < Ap[r + 1]; k++) {
+            if (Aj[k] < n_primary)
+                key = std::max(key, m_iperm[Aj[k]]);
+        }
+        keys.push_back(std::make_pair(key, r));
+    }
+    std::sort(keys.begin(), keys.end());
+    for (auto& k : keys) {
+        m_iperm[k.second] = (int)m_perm.size();
+        m_perm.push_back(k.second);
+    }
+}
+
+// -----------------------------------------------------------------------------
+// Numeric factorization
+// -----------------------------------------------------------------------------
+
+bool ChSparseLUEngine::Factorize(const ChCSMatrix& A) {
+    if (!IsAnalyzed(A))
+        return false;
+
+    m_Ax = A.GetCS_ValueArray();
+
+    // Threshold for small pivots
+    double anorm = 0;
+    for (int k = 0; k < m_A_lead[m_n]; k++)
+        anorm = std::max(anorm, std::abs(m_Ax[k]));
+    double eps = m_pivot_tol * (anorm > 0 ? anorm : 1.0);
+
+    m_Ux.resize(m_symmetric ? 0 : m_Lx.size());
+
+    int nthreads = std::max(1, m_nthreads);
+    m_work.resize(nthreads);
+    m_map.resize(nthreads);
+    for (auto& map : m_map)
+        map.resize(m_n);
+
+    int num_perturbed = 0;
+    for (int l = 0; l < GetNumLevels(); l++) {
+        int start = m_level_ptr[l];
+        int end = m_level_ptr[l + 1];
+#pragma omp parallel for num_threads(nthreads) schedule(dynamic, 1) reduction(+ : num_perturbed) if (end - start > 1)
+        for (int c = start; c < end; c++) {
+            int t = CHOMPfunctions::GetThreadNum();
+            ComputeSupernode(m_level_sn[c], m_work[t], m_map[t], eps, num_perturbed);
+        }
+    }
+    m_num_perturbed = num_perturbed;
+
+    return true;
+}
+
+// Compute the panels of L and U' and the pivots of supernode s (left-looking).
+// The panel of a supernode with nc columns and m rows is a dense column-major m x nc matrix, whose first nc rows
+// are the (lower, for L, or upper, for U') triangle of the diagonal block. Pivots are stored in D.
+void ChSparseLUEngine::ComputeSupernode(int s,
+                                        std::vector<double>& work,
+                                        std::vector<int>& map,
+                                        double eps,
+                                        int& num_perturbed) {
+    int f = m_sn_ptr[s];
+    int nc = m_sn_ptr[s + 1] - f;
+    int m = m_sn_rowp[s + 1] - m_sn_rowp[s];
+    const int* rows = &m_sn_rows[m_sn_rowp[s]];
+    double* L = &m_Lx[m_sn_xp[s]];
+    double* U = m_symmetric ? nullptr : &m_Ux[m_sn_xp[s]];
+
+    for (int i = 0; i < m; i++)
+        map[rows[i]] = i;
+
+    // Load the columns of the lower triangle and the rows of the upper triangle of A
+    std::fill(L, L + (size_t)m * nc, 0.0);
+    if (U)
+        std::fill(U, U + (size_t)m * nc, 0.0);
+    for (int c = 0; c < nc; c++) {
+        for (int k = m_Alp[f + c]; k < m_Alp[f + c + 1]; k++)
+            L[(size_t)c * m + map[m_Ali[k]]] += m_Ax[m_Als[k]];
+        if (U) {
+            for (int k = m_Aup[f + c]; k < m_Aup[f + c + 1]; k++)
+                U[(size_t)c * m + map[m_Auj[k]]] += m_Ax[m_Aus[k]];
+        }
+    }
+
+    // Apply the updates of the descendant supernodes. For a descendant t, the rows [p0,p1) of its panel are columns
+    // of s, and the rows [p0,mt) are rows of s. The update L(i,j) -= sum_k L(i,k)*D(k)*U(k,j) over the columns k
+    // of t is computed as a dense product in the work array, then scattered to the panel of s.
+    for (int q = m_upd_ptr[s]; q < m_upd_ptr[s + 1]; q++) {
+        int t = m_upd[q];
+        int ft = m_sn_ptr[t];
+        int nct = m_sn_ptr[t + 1] - ft;
+        int mt = m_sn_rowp[t + 1] - m_sn_rowp[t];
+        const int* rows_t = &m_sn_rows[m_sn_rowp[t]];
+        const double* Lt = &m_Lx[m_sn_xp[t]];
+        const double* Ut = m_symmetric ? Lt : &m_Ux[m_sn_xp[t]];
+
+        int p0 = (int)(std::lower_bound(rows_t + nct, rows_t + mt, f) - rows_t);
+        int p1 = (int)(std::lower_bound(rows_t + p0, rows_t + mt, f + nc) - rows_t);
+        int r = mt - p0;
+        int nq = p1 - p0;
+
+        size_t wsize = (size_t)r * nq;
+        work.assign(U ? 2 * wsize : wsize, 0.0);
+        double* WL = work.data();
+        double* WU = WL + wsize;
+
+        // Accumulate the products, four columns of t at a time
+        for (int a = 0; a < nq; a++) {
+            double* wl = WL + (size_t)a * r;
+            double* wu = WU + (size_t)a * r;
+            int k = 0;
+            for (; k + 3 < nct; k += 4) {
+                const double* l0 = Lt + (size_t)k * mt + p0;
+                const double* l1 = l0 + mt;
+                const double* l2 = l1 + mt;
+                const double* l3 = l2 + mt;
+                const double* u0 = Ut + (size_t)k * mt + p0;
+                const double* u1 = u0 + mt;
+                const double* u2 = u1 + mt;
+                const double* u3 = u2 + mt;
+                const double* d = &m_D[ft + k];
+                double s0 = d[0] * u0[a], s1 = d[1] * u1[a], s2 = d[2] * u2[a], s3 = d[3] * u3[a];
+                for (int i = a; i < r; i++)
+                    wl[i] += l0[i] * s0 + l1[i] * s1 + l2[i] * s2 + l3[i] * s3;
+                if (U) {
+                    s0 = d[0] * l0[a], s1 = d[1] * l1[a], s2 = d[2] * l2[a], s3 = d[3] * l3[a];
+                    for (int i = a + 1; i < r; i++)
+                        wu[i] += u0[i] * s0 + u1[i] * s1 + u2[i] * s2 + u3[i] * s3;
+                }
+            }
+            for (; k < nct; k++) {
+                const double* lk = Lt + (size_t)k * mt + p0;
+                const double* uk = Ut + (size_t)k * mt + p0;
+                double sl = m_D[ft + k] * uk[a];
+                for (int i = a; i < r; i++)
+                    wl[i] += lk[i] * sl;
+                if (U) {
+                    double su = m_D[ft + k] * lk[a];
+                    for (int i = a + 1; i < r; i++)
+                        wu[i] += uk[i] * su;
+                }
+            }
+        }
+
+        for (int a = 0; a < nq; a++) {
+            size_t col = (size_t)(rows_t[p0 + a] - f) * m;
+            const double* wl = WL + (size_t)a * r;
+            for (int i = a; i < r; i++)
+                L[col + map[rows_t[p0 + i]]] -= wl[i];
+            if (U) {
+                const double* wu = WU + (size_t)a * r;
+                for (int i = a + 1; i < r; i++)
+                    U[col + map[rows_t[p0 + i]]] -= wu[i];
+            }
+        }
+    }
+
+    // Dense factorization of the panel
+    for (int c = 0; c < nc; c++) {
+        double* Lc = L + (size_t)c * m;
+        double* Uc = U ? U + (size_t)c * m : Lc;
+
+        // Pivot (perturbed if too small)
+        double d = Lc[c];
+        if (std::abs(d) < eps) {
+            d = (d < 0) ? -eps : eps;
+            num_perturbed++;
+        }
+        m_D[f + c] = d;
+        Lc[c] = 1;
+
+        for (int i = c + 1; i < m; i++)
+            Lc[i] /= d;
+        if (U) {
+            for (int i = c + 1; i < m; i++)
+                Uc[i] /= d;
+        }
+
+        // Update the following columns of the panel
+        for (int c2 = c + 1; c2 < nc; c2++) {
+            double* Lc2 = L + (size_t)c2 * m;
+            double sl = d * Uc[c2];
+            for (int i = c2; i < m; i++)
+                Lc2[i] -= Lc[i] * sl;
+            if (U) {
+                double* Uc2 = U + (size_t)c2 * m;
+                double su = d * Lc[c2];
+                for (int i = c2 + 1; i < m; i++)
+                    Uc2[i] -= Uc[i] * su;
+            }
+        }
+    }
+}
+
+// -----------------------------------------------------------------------------
+// Solution
+// -----------------------------------------------------------------------------
+
+// Solve L*D*U*y = rhs in place (permuted ordering).
+void ChSparseLUEngine::SolveFactors(std::vector<double>& rhs) const {
+    const std::vector<double>& Ux = m_symmetric ? m_Lx : m_Ux;
+    int num_sn = GetNumSupernodes();
+
+    for (int s = 0; s < num_sn; s++) {
+        int f = m_sn_ptr[s];
+        int nc = m_sn_ptr[s + 1] - f;
+        int m = m_sn_rowp[s + 1] - m_sn_rowp[s];
+        const int* rows = &m_sn_rows[m_sn_rowp[s]];
+        for (int c = 0; c < nc; c++) {
+            const double* Lc = &m_Lx[m_sn_xp[s] + (size_t)c * m];
+            double yj = rhs[f + c];
+            for (int i = c + 1; i < m; i++)
+                rhs[rows[i]] -= Lc[i] * yj;
+        }
+    }
+    for (int j = 0; j < m_n; j++)
+        rhs[j] /= m_D[j];
+    for (int s = num_sn - 1; s >= 0; s--) {
+        int f = m_sn_ptr[s];
+        int nc = m_sn_ptr[s + 1] - f;
+        int m = m_sn_rowp[s + 1] - m_sn_rowp[s];
+        const int* rows = &m_sn_rows[m_sn_rowp[s]];
+        for (int c = nc - 1; c >= 0; c--) {
+            const double* Uc = &Ux[m_sn_xp[s] + (size_t)c * m];
+            double yj = rhs[f + c];
+            for (int i = c + 1; i < m; i++)
+                yj -= Uc[i] * rhs[rows[i]];
+            rhs[f + c] = yj;
+        }
+    }
+}
+
+void ChSparseLUEngine::Solve(const ChMatrix<>& b, ChMatrix<>& x) const {
+    x.Resize(m_n, 1);
+
+    std::vector<double> y(m_n);
+    for (int i = 0; i < m_n; i++)
+        y[i] = b.GetElementN(m_perm[i]);
+    SolveFactors(y);
+    for (int i = 0; i < m_n; i++)
+        x.SetElementN(m_perm[i], y[i]);
+
+    // Iterative refinement, if the factorization was perturbed
+    if (m_num_perturbed == 0)
+        return;
+
+    const int* Ap = m_A_lead.data();
+    const int* Aj = m_A_trail.data();
+    for (int iter = 0; iter < 2; iter++) {
+        for (int r = 0; r < m_n; r++) {
+            double res = b.GetElementN(r);
+            for (int k = Ap[r]; k < Ap[r + 1]; k++)
+                res -= m_Ax[k] * x.GetElementN(Aj[k]);
+            y[m_iperm[r]] = res;
+        }
+        SolveFactors(y);
+        for (int i = 0; i < m_n; i++)
+            x.SetElementN(m_perm[i], x.GetElementN(m_perm[i]) + y[i]);
+    }
+}
+
+}  // end namespace chrono
@@ -0,0 +1,142 @@
+// =============================================================================
+// PROJECT CHRONO - http://projectchrono.org
+//
+// Copyright (c) 2014 projectchrono.org
+// All rights reserved.
+//
+// Use of this source code is governed by a BSD-style license that can be found
+// in the LICENSE file at the top level of the distribution and at
+// http://projectchrono.org/license-chrono.txt.
+//
+// =============================================================================
+
+#ifndef CHSPARSELUENGINE_H
+#define CHSPARSELUENGINE_H
+
+#include <vector>
+
+#include "chrono/core/ChCSMatrix.h"
+#include "chrono/core/ChMatrixDynamic.h"
+
+namespace chrono {
+
+/// @addtogroup chrono_solver
+/// @{
+
+/// Native sparse direct factorization engine.
+/// Computes the factorization P*A*P' = L*D*U of a square sparse matrix A (given in compressed row format, see
+/// ChCSMatrix), where P is a fill-reducing permutation, L is unit lower triangular, D is diagonal and U is unit
+/// upper triangular. The structure of A is symmetrized, so that U has the same structure as L'. If the engine is
+/// set as symmetric, only the lower triangle of A is used and U = L' (i.e. an LDL' factorization is computed).
+///
+/// The work is split in three phases:
+/// - Analyze(): symbolic analysis (fill-reducing ordering, elimination tree, structure of the factors).
+///   It only depends on the sparsity pattern of A and can be reused as long as the pattern does not change.
+///   Consecutive columns of L with the same structure (below the diagonal) are grouped in supernodes.
+/// - Factorize(): supernodal numeric factorization. The columns of a supernode are stored as dense panels of L and
+///   U', which receive the updates of the descendant supernodes (left-looking, as dense products) and are then
+///   factorized as dense matrices. All supernodes at the same level of the supernodal elimination tree are
+///   independent and are processed concurrently. The results do not depend on the number of threads.
+/// - Solve(): forward and backward substitutions.
+///
+/// No dynamic pivoting is performed. Instead, the ordering eliminates the 'primary' unknowns (e.g. the system
+/// variables, with a positive definite mass/stiffness block) before the remaining ones (e.g. the Lagrange
+/// multipliers), which makes the factorization of the KKT matrices produced by ChSystemDescriptor stable.
+/// Pivots smaller than a given tolerance are perturbed; in that case, Solve() performs iterative refinement.
+class ChApi ChSparseLUEngine {
+  public:
+    ChSparseLUEngine();
+    ~ChSparseLUEngine() {}
+
+    /// Enable/disable the symmetric mode (LDL' factorization), default: false.
+    /// In symmetric mode, only the lower triangle of the matrix is used in the factorization (the matrix must still be
+    /// stored in full, as it is used for iterative refinement).
+    void SetSymmetric(bool val) { m_symmetric = val; }
+
+    /// Set the number of threads used in the numeric factorization (default: 1).
+    void SetNumThreads(int nthreads) { m_nthreads = nthreads; }
+
+    /// Set the relative tolerance for small pivots (default: 1e-10).
+    /// Pivots with magnitude smaller than tol * max|A(i,j)| are perturbed to this value.
+    void SetPivotTolerance(double tol) { m_pivot_tol = tol; }
+
+    /// Perform the symbolic analysis of the given matrix.
+    /// The unknowns in [0, n_primary) are grouped in the blocks specified by 'block_ptr' (block b spans the
+    /// unknowns in [block_ptr[b], block_ptr[b+1]) ) and are ordered first, using a minimum degree ordering of
+    /// the block graph. If 'block_ptr' is empty, each primary unknown is its own block. The unknowns in
+    /// [n_primary, n) are ordered last. A negative value of 'n_primary' marks all unknowns as primary.
+    bool Analyze(const ChCSMatrix& A, const std::vector<int>& block_ptr, int n_primary = -1);
+
+    /// Check whether the sparsity pattern of the given matrix matches that of the last analyzed matrix.
+    bool IsAnalyzed(const ChCSMatrix& A) const;
+
+    /// Perform the numeric factorization of the given matrix.
+    /// The matrix must have the same sparsity pattern of the last analyzed one. Its values must stay available
+    /// until the next call, as they are used in the iterative refinement performed by Solve().
+    bool Factorize(const ChCSMatrix& A);
+
+    /// Solve the system A*x = b, using the last factorization.
+    void Solve(const ChMatrix<>& b, ChMatrix<>& x) const;
+
+    /// Return the number of non-zeros in the strictly lower triangular factor L.
+    size_t GetNumNonZerosL() const { return m_nnz_L; }
+
+    /// Return the number of supernodes.
+    int GetNumSupernodes() const { return (int)m_sn_ptr.size() - 1; }
+
+    /// Return the number of levels of the supernodal elimination tree (i.e. the number of sequential steps).
+    int GetNumLevels() const { return (int)m_level_ptr.size() - 1; }
+
+    /// Return the number of pivots perturbed in the last factorization.
+    int GetNumPerturbedPivots() const { return m_num_perturbed; }
+
+  private:
+    void ComputeOrdering(const ChCSMatrix& A, const std::vector<int>& block_ptr, int n_primary);
+    void ComputeSupernode(int s, std::vector<double>& work, std::vector<int>& map, double eps, int& num_perturbed);
+    void SolveFactors(std::vector<double>& rhs) const;
+
+    bool m_symmetric;    ///< symmetric mode (LDL')
+    int m_nthreads;      ///< number of threads for numeric factorization
+    double m_pivot_tol;  ///< relative tolerance for small pivots
+
+    int m_n;                     ///< problem size
+    std::vector<int> m_A_lead;   ///< copy of the analyzed pattern (leading index)
+    std::vector<int> m_A_trail;  ///< copy of the analyzed pattern (trailing index)
+
+    std::vector<int> m_perm;    ///< fill-reducing permutation (new -> old)
+    std::vector<int> m_iperm;   ///< inverse permutation (old -> new)
+    std::vector<int> m_parent;  ///< elimination tree
+
+    std::vector<int> m_sn_ptr;      ///< first column of each supernode
+    std::vector<int> m_sn_rowp;     ///< start of the row list of each supernode in m_sn_rows
+    std::vector<int> m_sn_rows;     ///< rows of each supernode: its columns, then the (sorted) rows below them
+    std::vector<size_t> m_sn_xp;    ///< start of the dense panel of each supernode in m_Lx and m_Ux
+    std::vector<int> m_upd_ptr;     ///< start of the list of updating supernodes of each supernode in m_upd
+    std::vector<int> m_upd;         ///< descendant supernodes that update each supernode (increasing order)
+    std::vector<int> m_level_ptr;   ///< start of each supernodal elimination tree level in m_level_sn
+    std::vector<int> m_level_sn;    ///< supernodes, grouped by level
+    size_t m_nnz_L;                 ///< number of non-zeros in the strictly lower part of L
+
+    std::vector<int> m_Alp;   ///< permuted lower triangle of A, by columns: column pointers
+    std::vector<int> m_Ali;   ///< permuted lower triangle of A: row indices
+    std::vector<int> m_Als;   ///< permuted lower triangle of A: position in the values of A
+    std::vector<int> m_Aup;   ///< permuted strictly upper triangle of A, by rows: row pointers
+    std::vector<int> m_Auj;   ///< permuted strictly upper triangle of A: column indices
+    std::vector<int> m_Aus;   ///< permuted strictly upper triangle of A: position in the values of A
+
+    std::vector<double> m_Lx;  ///< values of L (dense column-major panel of each supernode)
+    std::vector<double> m_Ux;  ///< values of U' (same structure as L; unused in symmetric mode)
+    std::vector<double> m_D;   ///< diagonal factor
+
+    std::vector<std::vector<double>> m_work;  ///< per-thread work vectors (dense updates)
+    std::vector<std::vector<int>> m_map;      ///< per-thread maps from rows to panel positions
+
+    const double* m_Ax;   ///< values of the last factorized matrix
+    int m_num_perturbed;  ///< number of perturbed pivots in the last factorization
+};
+
+/// @} chrono_solver
+
+}  // end namespace chrono
+
+#endif
@@ -14,6 +14,9 @@
 #include "chrono/solver/ChConstraintTwoTuplesContactN.h"
 #include "chrono/solver/ChConstraintTwoTuplesFrictionT.h"
 #include "chrono/core/ChLinkedListMatrix.h"
+#include "chrono/solver/ChKblockGeneric.h"
+
+#include <algorithm>
 
 namespace chrono {
 
@@ -34,6 +37,8 @@ ChSystemDescriptor::ChSystemDescriptor() {
     n_c = 0;
     freeze_count = false;
 
+    kscatter_valid = false;
+
     this->num_threads = CHOMPfunctions::GetNumProcs();
 
     spinlocktable = new ChSpinlock[CH_SPINLOCK_HASHSIZE];
@@ -232,9 +237,12 @@ void ChSystemDescriptor::ConvertToMatrixForm(ChSparseMatrix* Z, ChMatrix<>* rhs)
 		}
 
 		// If present, add stiffness matrix K to upper-left block of Z.
-		int s_k = 0;
-		for (unsigned int ik = 0; ik < this->vstiffness.size(); ik++) {
-			this->vstiffness[ik]->Build_K(*Z, true);
+		// Use the parallel scatter into precomputed slots if possible, otherwise insert the K blocks one by one.
+		ChCSMatrix* Zcs = dynamic_cast<ChCSMatrix*>(Z);
+		if (!(Zcs && ScatterKblocks(*Zcs))) {
+			for (unsigned int ik = 0; ik < this->vstiffness.size(); ik++) {
+				this->vstiffness[ik]->Build_K(*Z, true);
+			}
 		}
 
 		// Fill Z by looping over constraints.
@@ -284,6 +292,120 @@ void ChSystemDescriptor::ConvertToMatrixForm(ChSparseMatrix* Z, ChMatrix<>* rhs)
 }
 
 
+void ChSystemDescriptor::GetKblocksSignature(std::vector<const void*>& kaddress, std::vector<int>& offsets) {
+    kaddress.clear();
+    offsets.clear();
+    for (auto kblock : vstiffness) {
+        auto kgen = dynamic_cast<ChKblockGeneric*>(kblock);
+        ChMatrix<double>* K = kgen ? kgen->Get_K() : nullptr;
+        kaddress.push_back(K ? K->GetAddress() : nullptr);
+        for (unsigned int iv = 0; iv < kblock->GetNvars(); iv++) {
+            ChVariables* var = kgen ? kgen->GetVariableN(iv) : nullptr;
+            offsets.push_back((var && var->IsActive()) ? var->GetOffset() : -1);
+        }
+    }
+}
+
+bool ChSystemDescriptor::ScatterKblocks(ChCSMatrix& Z) {
+    // The scatter can only be used if the sparsity pattern of Z was preserved from the previous assembly
+    // (i.e. a locked matrix, reset with the same size); otherwise the K entries must be inserted.
+    if (vstiffness.empty() || !Z.IsCompressed() || !Z.IsRowMajor())
+        return false;
+
+    int nrows = Z.GetNumRows();
+    const int* lead = Z.GetCS_LeadingIndexArray();
+    const int* trail = Z.GetCS_TrailingIndexArray();
+    double* values = Z.GetCS_ValueArray();
+    int nnz = lead[nrows];
+
+    // Check whether the precomputed scatter is still valid: same ChKblock matrices, same variable offsets,
+    // same sparsity pattern of Z.
+    std::vector<const void*> kaddress;
+    std::vector<int> offsets;
+    GetKblocksSignature(kaddress, offsets);
+
+    bool valid = kscatter_valid && kaddress == kscatter_kaddress && offsets == kscatter_offsets &&
+                 kscatter_lead.size() == static_cast<size_t>(nrows + 1) &&
+                 kscatter_trail.size() == static_cast<size_t>(nnz) &&
+                 std::equal(lead, lead + nrows + 1, kscatter_lead.begin()) &&
+                 std::equal(trail, trail + nnz, kscatter_trail.begin());
+
+    if (!valid) {
+        kscatter_valid = false;
+
+        // Collect the (slot, source) pairs, in the same order used by ChKblockGeneric::Build_K.
+        std::vector<std::pair<int, const double*>> contribs;
+        for (auto kblock : vstiffness) {
+            auto kgen = dynamic_cast<ChKblockGeneric*>(kblock);
+            if (!kgen)
+                return false;
+            ChMatrix<double>* K = kgen->Get_K();
+            if (!K)
+                continue;
+            int ncols = K->GetColumns();
+            int kio = 0;
+            for (unsigned int iv = 0; iv < kgen->GetNvars(); iv++) {
+                int io = kgen->GetVariableN(iv)->GetOffset();
+                int in = kgen->GetVariableN(iv)->Get_ndof();
+                if (kgen->GetVariableN(iv)->IsActive()) {
+                    int kjo = 0;
+                    for (unsigned int jv = 0; jv < kgen->GetNvars(); jv++) {
+                        int jo = kgen->GetVariableN(jv)->GetOffset();
+                        int jn = kgen->GetVariableN(jv)->Get_ndof();
+                        if (kgen->GetVariableN(jv)->IsActive()) {
+                            for (int r = 0; r < in; r++) {
+                                const int* row_begin = trail + lead[io + r];
+                                const int* row_end = trail + lead[io + r + 1];
+                                for (int c = 0; c < jn; c++) {
+                                    const int* slot = std::lower_bound(row_begin, row_end, jo + c);
+                                    if (slot == row_end || *slot != jo + c)
+                                        return false;
+                                    contribs.push_back(std::make_pair(
+                                        static_cast<int>(slot - trail),
+                                        K->GetAddress() + (kio + r) * ncols + (kjo + c)));
+                                }
+                            }
+                        }
+                        kjo += jn;
+                    }
+                }
+                kio += in;
+            }
+        }
+
+        // Group the contributions by slot (counting sort, preserving the insertion order within each slot).
+        kscatter_ptr.assign(nnz + 1, 0);
+        for (auto& contrib : contribs)
+            kscatter_ptr[contrib.first + 1]++;
+        for (int s = 0; s < nnz; s++)
+            kscatter_ptr[s + 1] += kscatter_ptr[s];
+        kscatter_src.resize(contribs.size());
+        std::vector<int> pos(kscatter_ptr.begin(), kscatter_ptr.end() - 1);
+        for (auto& contrib : contribs)
+            kscatter_src[pos[contrib.first]++] = contrib.second;
+
+        kscatter_lead.assign(lead, lead + nrows + 1);
+        kscatter_trail.assign(trail, trail + nnz);
+        kscatter_kaddress = kaddress;
+        kscatter_offsets = offsets;
+        kscatter_valid = true;
+    }
+
+    // Gather the K entries into the matrix slots. Each row is processed by a single thread, so no locking is
+    // needed; the summation order within each slot is the same as in the serial assembly.
+    const int* ptr = kscatter_ptr.data();
+    const double* const* src = kscatter_src.data();
+#pragma omp parallel for num_threads(num_threads) schedule(static)
+    for (int row = 0; row < nrows; row++) {
+        for (int s = lead[row]; s < lead[row + 1]; s++) {
+            for (int k = ptr[s]; k < ptr[s + 1]; k++)
+                values[s] += *src[k];
+        }
+    }
+
+    return true;
+}
+
 void ChSystemDescriptor::DumpLastMatrices(bool assembled, const char* path) {
     char filename[300];
     try {
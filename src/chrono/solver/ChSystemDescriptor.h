@@ -15,6 +15,7 @@
 
 #include <vector>
 
+#include "chrono/core/ChCSMatrix.h"
 #include "chrono/parallel/ChOpenMP.h"
 #include "chrono/parallel/ChThreadsSync.h"
 #include "chrono/solver/ChConstraint.h"
@@ -89,6 +90,23 @@ class ChApi ChSystemDescriptor {
     int n_c;            ///< number of active constraints
     bool freeze_count;  ///< for optimization: avoid to re-count the number of active variables and constraints
 
+    // Precomputed scatter of the ChKblock entries into a compressed ChCSMatrix (see ConvertToMatrixForm).
+    // For each non-zero slot of the matrix, the list of contributing K entries, in order of insertion.
+    bool kscatter_valid;                         ///< true if the scatter data matches the current problem
+    std::vector<int> kscatter_lead;              ///< matrix pattern when the scatter was built (leading index)
+    std::vector<int> kscatter_trail;             ///< matrix pattern when the scatter was built (trailing index)
+    std::vector<const void*> kscatter_kaddress;  ///< address of the K matrix data of each ChKblock
+    std::vector<int> kscatter_offsets;           ///< offsets of the variables of each ChKblock (-1 if inactive)
+    std::vector<int> kscatter_ptr;               ///< start of the contributions to each matrix slot
+    std::vector<const double*> kscatter_src;     ///< contributing K entries
+
+    /// Add all ChKblock matrices to Z, using the precomputed scatter (rebuilt if needed).
+    /// Returns false if the scatter cannot be used (e.g. if some K entry has no slot in Z).
+    bool ScatterKblocks(ChCSMatrix& Z);
+
+    /// Collect the signature of the current ChKblock set (K addresses and variable offsets).
+    void GetKblocksSignature(std::vector<const void*>& kaddress, std::vector<int>& offsets);
+
   public:
     /// Constructor
     ChSystemDescriptor();
@@ -354,6 +372,9 @@ class ChApi ChSystemDescriptor {
     );
 
     /// Create and return the assembled system matrix and RHS vector.
+    /// If Z is a compressed ChCSMatrix with a locked sparsity pattern (as in repeated calls from direct solvers),
+    /// the ChKblock matrices are scattered in parallel into precomputed slots of Z, which is much faster than
+    /// inserting their entries one by one. The result is identical in both cases.
     virtual void ConvertToMatrixForm(ChSparseMatrix* Z,  ///< [out] assembled system matrix
                                      ChMatrix<>* rhs     ///< [out] assembled RHS vector
     );
@@ -0,0 +1,424 @@
+// =============================================================================
+// PROJECT CHRONO - http://projectchrono.org
+//
+// Copyright (c) 2014 projectchrono.org
+// All rights reserved.
+//
+// Use of this source code is governed by a BSD-style license that can be found
+// in the LICENSE file at the top level of the distribution and at
+// http://projectchrono.org/license-chrono.txt.
+//
+// =============================================================================
+//
+// Thread-aware hierarchical profiler, with per-step records and export to
+// JSON, CSV and Chrome trace (chrome://tracing) formats.
+//
+// =============================================================================
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cstring>
+#include <iomanip>
+#include <iterator>
+#include <map>
+#include <memory>
+#include <mutex>
+
+#include "chrono/utils/ChProfileRecorder.h"
+
+namespace chrono {
+namespace utils {
+
+namespace {
+
+typedef std::chrono::steady_clock Clock;
+
+// Node in the zone hierarchy of a thread (node 0 is the root)
+struct ZoneNode {
+    std::string name;
+    std::string path;
+    std::vector<int> children;
+};
+
+// Zone execution (end < 0 while the zone is open)
+struct ZoneEvent {
+    int node;
+    double start;
+    double end;
+};
+
+// Per-thread data. Only accessed by the owner thread, except in EndStep and Reset.
+struct ThreadBuffer {
+    ThreadBuffer() : index(0), released(false) {}
+    int index;
+    bool released;  // the owner thread has exited
+    std::vector<ZoneNode> nodes;
+    std::vector<ZoneEvent> events;
+    std::vector<int> stack;  // indices of the open events
+};
+
+struct RecorderData {
+    RecorderData()
+        : enabled(false),
+          trace(false),
+          max_steps(10000),
+          max_events(1000000),
+          last_step_end(0),
+          num_steps(0),
+          num_threads(0) {
+        epoch = Clock::now();
+    }
+
+    std::atomic<bool> enabled;
+    bool trace;
+    size_t max_steps;
+    size_t max_events;
+    Clock::time_point epoch;
+    double last_step_end;
+    int num_steps;
+    int num_threads;  // number of thread buffers created since the start
+
+    std::mutex mutex;
+    std::vector<std::unique_ptr<ThreadBuffer>> buffers;
+    std::deque<ChProfileRecorder::StepRecord> steps;
+    std::deque<ChProfileRecorder::TraceEvent> trace_events;
+};
+
+RecorderData& GetData() {
+    static RecorderData data;
+    return data;
+}
+
+// Marks the buffer of a thread as released when the thread exits, so that it is freed at the next EndStep or Reset.
+struct ThreadBufferOwner {
+    ThreadBufferOwner() : buffer(nullptr) {}
+    ~ThreadBufferOwner() {
+        if (!buffer)
+            return;
+        RecorderData& data = GetData();
+        std::lock_guard<std::mutex> lock(data.mutex);
+        buffer->released = true;
+    }
+    ThreadBuffer* buffer;
+};
+
+thread_local ThreadBufferOwner tls_owner;
+thread_local ThreadBuffer* tls_buffer = nullptr;
+thread_local bool tls_suspended = false;
+
+double GetTime(const RecorderData& data) {
+    return std::chrono::duration<double>(Clock::now() - data.epoch).count();
+}
+
+ThreadBuffer* GetBuffer(RecorderData& data) {
+    if (!tls_buffer) {
+        std::lock_guard<std::mutex> lock(data.mutex);
+        data.buffers.push_back(std::unique_ptr<ThreadBuffer>(new ThreadBuffer));
+        tls_buffer = data.buffers.back().get();
+        tls_buffer->index = data.num_threads++;
+        tls_buffer->nodes.push_back(ZoneNode());
+        tls_owner.buffer = tls_buffer;
+    }
+    return tls_buffer;
+}
+
+// Remove the closed events of a thread buffer, keeping the open ones.
+void Compact(ThreadBuffer& buffer, double time_shift) {
+    std::vector<ZoneEvent> open_events;
+    for (auto& ie : buffer.stack) {
+        open_events.push_back(buffer.events[ie]);
+        open_events.back().start -= time_shift;
+        ie = static_cast<int>(open_events.size()) - 1;
+    }
+    buffer.events.swap(open_events);
+}
+
+// Free the buffers of the threads which have exited.
+void RemoveReleased(std::vector<std::unique_ptr<ThreadBuffer>>& buffers) {
+    buffers.erase(std::remove_if(buffers.begin(), buffers.end(),
+                                 [](const std::unique_ptr<ThreadBuffer>& buffer) { return buffer->released; }),
+                  buffers.end());
+}
+
+// Write a string, escaping the characters not allowed in JSON strings
+void WriteJSONString(std::ostream& stream, const std::string& str) {
+    stream << '"';
+    for (auto c : str) {
+        switch (c) {
+            case '"':
+                stream << "\\\"";
+                break;
+            case '\\':
+                stream << "\\\\";
+                break;
+            case '\b':
+                stream << "\\b";
+                break;
+            case '\f':
+                stream << "\\f";
+                break;
+            case '\n':
+                stream << "\\n";
+                break;
+            case '\r':
+                stream << "\\r";
+                break;
+            case '\t':
+                stream << "\\t";
+                break;
+            default:
+                if (static_cast<unsigned char>(c) < 0x20) {
+                    static const char* hex = "0123456789abcdef";
+                    stream << "\\u00" << hex[(c >> 4) & 0xf] << hex[c & 0xf];
+                } else {
+                    stream << c;
+                }
+        }
+    }
+    stream << '"';
+}
+
+// Write a quoted CSV field, doubling the embedded quotes (RFC 4180)
+void WriteCSVString(std::ostream& stream, const std::string& str) {
+    stream << '"';
+    for (auto c : str) {
+        if (c == '"')
+            stream << '"';
+        stream << c;
+    }
+    stream << '"';
+}
+
+}  // end anonymous namespace
+
+void ChProfileRecorder::Enable(bool val) {
+    GetData().enabled = val;
+}
+
+bool ChProfileRecorder::IsEnabled() {
+    return GetData().enabled;
+}
+
+void ChProfileRecorder::SuspendThread(bool val) {
+    tls_suspended = val;
+}
+
+bool ChProfileRecorder::IsThreadSuspended() {
+    return tls_suspended;
+}
+
+void ChProfileRecorder::EnableTrace(bool val) {
+    RecorderData& data = GetData();
+    std::lock_guard<std::mutex> lock(data.mutex);
+    data.trace = val;
+}
+
+void ChProfileRecorder::SetMaxRecords(size_t max_steps, size_t max_events) {
+    RecorderData& data = GetData();
+    std::lock_guard<std::mutex> lock(data.mutex);
+    data.max_steps = max_steps;
+    data.max_events = max_events;
+}
+
+void ChProfileRecorder::Reset() {
+    RecorderData& data = GetData();
+    std::lock_guard<std::mutex> lock(data.mutex);
+    Clock::time_point epoch = Clock::now();
+    double time_shift = std::chrono::duration<double>(epoch - data.epoch).count();
+    RemoveReleased(data.buffers);
+    for (auto& buffer : data.buffers)
+        Compact(*buffer, time_shift);
+    data.epoch = epoch;
+    data.last_step_end = 0;
+    data.num_steps = 0;
+    data.steps.clear();
+    data.trace_events.clear();
+}
+
+bool ChProfileRecorder::BeginZone(const char* name) {
+    RecorderData& data = GetData();
+    if (tls_suspended || !data.enabled.load(std::memory_order_relaxed))
+        return false;
+
+    ThreadBuffer* buffer = GetBuffer(data);
+
+    // Find the hierarchy node for this zone, or create it
+    int parent = buffer->stack.empty() ? 0 : buffer->events[buffer->stack.back()].node;
+    int node = -1;
+    for (auto child : buffer->nodes[parent].children) {
+        if (buffer->nodes[child].name == name) {
+            node = child;
+            break;
+        }
+    }
+    if (node < 0) {
+        ZoneNode new_node;
+        new_node.name = name;
+        new_node.path = (parent == 0) ? new_node.name : buffer->nodes[parent].path + "/" + new_node.name;
+        node = static_cast<int>(buffer->nodes.size());
+        buffer->nodes.push_back(new_node);
+        buffer->nodes[parent].children.push_back(node);
+    }
+
+    ZoneEvent event = {node, GetTime(data), -1};
+    buffer->stack.push_back(static_cast<int>(buffer->events.size()));
+    buffer->events.push_back(event);
+    return true;
+}
+
+void ChProfileRecorder::EndZone() {
+    // Do not test the enabled and suspended flags: only opened zones are closed, including those opened before
+    // disabling the recorder or suspending the thread.
+    ThreadBuffer* buffer = tls_buffer;
+    if (!buffer || buffer->stack.empty())
+        return;
+
+    buffer->events[buffer->stack.back()].end = GetTime(GetData());
+    buffer->stack.pop_back();
+}
+
+void ChProfileRecorder::EndZone(const char* name) {
+    ThreadBuffer* buffer = tls_buffer;
+    if (!buffer)
+        return;
+
+    for (auto is = buffer->stack.rbegin(); is != buffer->stack.rend(); ++is) {
+        ZoneEvent& event = buffer->events[*is];
+        if (buffer->nodes[event.node].name == name) {
+            event.end = GetTime(GetData());
+            buffer->stack.erase(std::next(is).base());
+            return;
+        }
+    }
+}
+
+void ChProfileRecorder::EndStep(double sim_time) {
+    RecorderData& data = GetData();
+    if (tls_suspended || !data.enabled.load(std::memory_order_relaxed))
+        return;
+
+    std::lock_guard<std::mutex> lock(data.mutex);
+    double now = GetTime(data);
+
+    // Merge the closed zones of all threads, by zone path
+    std::map<std::string, ZoneRecord> zones;
+    for (auto& buffer : data.buffers) {
+        std::map<int, std::pair<int, double>> thread_zones;  // calls and time for each node of this thread
+        for (auto& event : buffer->events) {
+            if (event.end < 0)
+                continue;
+            auto& tz = thread_zones[event.node];
+            tz.first++;
+            tz.second += event.end - event.start;
+            if (data.trace) {
+                TraceEvent trace_event = {buffer->nodes[event.node].name, buffer->index, event.start,
+                                          event.end - event.start};
+                data.trace_events.push_back(trace_event);
+            }
+        }
+        for (auto& tz : thread_zones) {
+            const std::string& path = buffer->nodes[tz.first].path;
+            auto iz = zones.find(path);
+            if (iz == zones.end()) {
+                ZoneRecord zone = {path, 0, 0, 0, 0};
+                iz = zones.insert(std::make_pair(path, zone)).first;
+            }
+            iz->second.calls += tz.second.first;
+            iz->second.threads++;
+            iz->second.total += tz.second.second;
+            iz->second.max = std::max(iz->second.max, tz.second.second);
+        }
+        Compact(*buffer, 0);
+    }
+    RemoveReleased(data.buffers);
+
+    StepRecord record;
+    record.step = data.num_steps++;
+    record.sim_time = sim_time;
+    record.wall_time = now - data.last_step_end;
+    for (auto& zone : zones)
+        record.zones.push_back(zone.second);
+    data.steps.push_back(record);
+    data.last_step_end = now;
+
+    // Discard the oldest records, if needed
+    while (data.max_steps > 0 && data.steps.size() > data.max_steps)
+        data.steps.pop_front();
+    while (data.max_events > 0 && data.trace_events.size() > data.max_events)
+        data.trace_events.pop_front();
+}
+
+const std::deque<ChProfileRecorder::StepRecord>& ChProfileRecorder::GetSteps() {
+    return GetData().steps;
+}
+
+const std::deque<ChProfileRecorder::TraceEvent>& ChProfileRecorder::GetTraceEvents() {
+    return GetData().trace_events;
+}
+
+void ChProfileRecorder::WriteJSON(std::ostream& stream) {
+    RecorderData& data = GetData();
+    std::lock_guard<std::mutex> lock(data.mutex);
+    std::streamsize precision = stream.precision(9);
+
+    stream << "{\"steps\": [";
+    for (size_t i = 0; i < data.steps.size(); i++) {
+        const StepRecord& step = data.steps[i];
+        stream << (i ? ",\n" : "\n") << "  {\"step\": " << step.step << ", \"sim_time\": " << step.sim_time
+               << ", \"wall_time\": " << step.wall_time << ", \"zones\": [";
+        for (size_t j = 0; j < step.zones.size(); j++) {
+            const ZoneRecord& zone = step.zones[j];
+            stream << (j ? ", " : "") << "{\"path\": ";
+            WriteJSONString(stream, zone.path);
+            stream << ", \"calls\": " << zone.calls << ", \"threads\": " << zone.threads
+                   << ", \"total\": " << zone.total << ", \"max\": " << zone.max << "}";
+        }
+        stream << "]}";
+    }
+    stream << "\n]}\n";
+
+    stream.precision(precision);
+}
+
+void ChProfileRecorder::WriteCSV(std::ostream& stream) {
+    RecorderData& data = GetData();
+    std::lock_guard<std::mutex> lock(data.mutex);
+    std::streamsize precision = stream.precision(9);
+
+    stream << "step,sim_time,wall_time,zone,calls,threads,total,max\n";
+    for (auto& step : data.steps) {
+        for (auto& zone : step.zones) {
+            stream << step.step << "," << step.sim_time << "," << step.wall_time << ",";
+            WriteCSVString(stream, zone.path);
+            stream << "," << zone.calls << "," << zone.threads << "," << zone.total << "," << zone.max << "\n";
+        }
+    }
+
+    stream.precision(precision);
+}
+
+void ChProfileRecorder::WriteChromeTrace(std::ostream& stream) {
+    RecorderData& data = GetData();
+    std::lock_guard<std::mutex> lock(data.mutex);
+    std::ios::fmtflags flags = stream.flags();
+    std::streamsize precision = stream.precision(3);
+    stream << std::fixed;
+
+    // Times in microseconds
+    stream << "{\"traceEvents\": [";
+    for (size_t i = 0; i < data.trace_events.size(); i++) {
+        const TraceEvent& event = data.trace_events[i];
+        stream << (i ? ",\n" : "\n") << "  {\"name\": ";
+        WriteJSONString(stream, event.name);
+        stream << ", \"cat\": \"chrono\", \"ph\": \"X\", \"pid\": 0, \"tid\": " << event.thread
+               << ", \"ts\": " << event.start * 1e6 << ", \"dur\": " << event.duration * 1e6 << "}";
+    }
+    stream << "\n], \"displayTimeUnit\": \"ms\"}\n";
+
+    stream.flags(flags);
+    stream.precision(precision);
+}
+
+}  // end namespace utils
+}  // end namespace chrono
@@ -0,0 +1,162 @@
+// =============================================================================
+// PROJECT CHRONO - http://projectchrono.org
+//
+// Copyright (c) 2014 projectchrono.org
+// All rights reserved.
+//
+// Use of this source code is governed by a BSD-style license that can be found
+// in the LICENSE file at the top level of the distribution and at
+// http://projectchrono.org/license-chrono.txt.
+//
+// =============================================================================
+//
+// Thread-aware hierarchical profiler, with per-step records and export to
+// JSON, CSV and Chrome trace (chrome://tracing) formats.
+//
+// =============================================================================
+
+#ifndef CHPROFILERECORDER_H
+#define CHPROFILERECORDER_H
+
+#include <deque>
+#include <ostream>
+#include <string>
+#include <vector>
+
+#include "chrono/core/ChApiCE.h"
+
+namespace chrono {
+namespace utils {
+
+/// @addtogroup chrono_utils
+/// @{
+
+/// Thread-aware hierarchical profiler, recording per-step timing information.
+///
+/// Zones are opened and closed with BeginZone() / EndZone(), usually through the CH_PROFILE or CH_PROFILE_ZONE
+/// macros (see ChProfiler.h). Each thread records its zones in its own buffer, without locking, so zones can
+/// also be used inside OpenMP parallel regions. Zones are organized hierarchically, based on the zones that are
+/// open on the same thread; the path of a zone is the list of names of its enclosing zones (e.g.
+/// "Integrate_Y/ComputeCollisions"). At the end of each step (ChSystem::DoStepDynamics calls EndStep()), the
+/// zones closed by all threads are merged in a step record.
+///
+/// The recorder is disabled by default, in which case the cost of a zone is a single test of a flag.
+/// Profiling can also be compiled out completely by defining CH_NO_PROFILE.
+///
+/// Example:
+/// \code{.cpp}
+/// utils::ChProfileRecorder::Enable(true);
+/// utils::ChProfileRecorder::EnableTrace(true);
+/// while (system.GetChTime() < 1)
+///     system.DoStepDynamics(1e-3);
+/// std::ofstream file("profile.json");
+/// utils::ChProfileRecorder::WriteChromeTrace(file);
+/// \endcode
+class ChApi ChProfileRecorder {
+  public:
+    /// Timing information for a zone, merged over all threads and all its calls during one step.
+    struct ZoneRecord {
+        std::string path;  ///< zone path (names of the enclosing zones and of this zone, separated by '/')
+        int calls;         ///< number of calls, over all threads
+        int threads;       ///< number of threads which executed the zone
+        double total;      ///< total time over all threads [s]
+        double max;        ///< maximum time over threads [s] (wall time, for zones executed in parallel)
+    };
+
+    /// Timing information for one step.
+    struct StepRecord {
+        int step;                       ///< step index (since the last Reset)
+        double sim_time;                ///< simulation time at the end of the step
+        double wall_time;               ///< wall clock time elapsed since the end of the previous step [s]
+        std::vector<ZoneRecord> zones;  ///< zones closed during the step, sorted by path
+    };
+
+    /// Single zone execution, used for the Chrome trace output.
+    struct TraceEvent {
+        std::string name;  ///< zone name
+        int thread;        ///< thread index
+        double start;      ///< start time, since the last Reset [s]
+        double duration;   ///< duration [s]
+    };
+
+    /// Enable/disable the recorder (default: false).
+    static void Enable(bool val);
+
+    /// Return true if the recorder is enabled.
+    static bool IsEnabled();
+
+    /// Enable/disable recording of individual zone executions, needed for the Chrome trace output (default: false).
+    /// Only step records are kept if disabled.
+    static void EnableTrace(bool val);
+
+    /// Set the maximum number of step records and trace events kept in memory (default: 10000 steps and
+    /// 1000000 events; 0 means no limit). If exceeded, the oldest records are discarded.
+    static void SetMaxRecords(size_t max_steps, size_t max_events);
+
+    /// Discard all records and restart the clock.
+    static void Reset();
+
+    /// Suspend/resume all profiling on the calling thread (default: false).
+    /// While suspended, CH_PROFILE and CH_PROFILE_ZONE zones opened on this thread are ignored (in the recorder
+    /// and in ChProfileManager) and EndStep() is a no-op, so that systems stepped concurrently on different
+    /// threads do not modify the process-wide profiling data (see ChSystemEnsemble).
+    static void SuspendThread(bool val);
+
+    /// Return true if profiling is suspended on the calling thread.
+    static bool IsThreadSuspended();
+
+    /// Open a zone on the calling thread.
+    /// The name is copied the first time it is used at a given place of the hierarchy.
+    /// Returns false if no zone was opened (recorder disabled or thread suspended); in that case the zone must
+    /// not be closed with EndZone(), even if the recorder was enabled in the meantime.
+    static bool BeginZone(const char* name);
+
+    /// Close the innermost open zone on the calling thread.
+    static void EndZone();
+
+    /// Close the innermost open zone with the given name on the calling thread.
+    /// Use this version if zones are not properly nested.
+    static void EndZone(const char* name);
+
+    /// Close the current step: merge the zones closed by all threads since the last call into a step record.
+    /// Zones still open are accounted for in the step in which they are closed.
+    /// Must not be called concurrently with zones on other threads (i.e. not inside a parallel region).
+    static void EndStep(double sim_time);
+
+    /// Get the recorded steps, oldest first.
+    static const std::deque<StepRecord>& GetSteps();
+
+    /// Get the recorded zone executions, oldest first.
+    static const std::deque<TraceEvent>& GetTraceEvents();
+
+    /// Write the step records in JSON format.
+    static void WriteJSON(std::ostream& stream);
+
+    /// Write the step records in CSV format (one line for each zone of each step).
+    static void WriteCSV(std::ostream& stream);
+
+    /// Write the recorded zone executions in the Chrome trace event format (load in chrome://tracing).
+    static void WriteChromeTrace(std::ostream& stream);
+};
+
+/// Helper class to profile a scope, using the thread-aware ChProfileRecorder.
+/// The zone is only closed if it was opened, so enabling or disabling the recorder within the scope keeps the
+/// zones balanced.
+class ChProfileZone {
+  public:
+    ChProfileZone(const char* name) : m_open(ChProfileRecorder::BeginZone(name)) {}
+    ~ChProfileZone() {
+        if (m_open)
+            ChProfileRecorder::EndZone();
+    }
+
+  private:
+    bool m_open;
+};
+
+/// @} chrono_utils
+
+}  // end namespace utils
+}  // end namespace chrono
+
+#endif
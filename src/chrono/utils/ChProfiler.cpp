@@ -251,6 +251,9 @@ unsigned long int			ChProfileManager::ResetTime = 0;
  *=============================================================================================*/
 void	ChProfileManager::Start_Profile( const char * name )
 {
+	if (ChProfileRecorder::IsThreadSuspended())
+		return;
+
 	if (name != CurrentNode->Get_Name()) {
 		CurrentNode = CurrentNode->Get_Sub_Node( name );
 	} 
@@ -264,6 +267,9 @@ void	ChProfileManager::Start_Profile( const char * name )
  *=============================================================================================*/
 void	ChProfileManager::Stop_Profile( void )
 {
+	if (ChProfileRecorder::IsThreadSuspended())
+		return;
+
 	// Return will indicate whether we should back up to our parent (we may
 	// be profiling a recursive function)
 	if (CurrentNode->Return()) {
@@ -36,6 +36,8 @@ CODE MODIFIED FROM:
 //To disable built-in profiling, please comment out next line
 //#define CH_NO_PROFILE 1
 
+#include "chrono/utils/ChProfileRecorder.h"
+
 #ifndef CH_NO_PROFILE
 
 #include <cstdio>
@@ -157,18 +159,26 @@ private:
 
 
 ///ProfileSampleClass is a simple way to profile a function's scope
-///Use the BT_PROFILE macro at the start of scope to time
+///Use the CH_PROFILE macro at the start of scope to time.
+///The scope is also recorded by the thread-aware ChProfileRecorder, if enabled.
+///Not thread-safe: use CH_PROFILE_ZONE in code that may run in parallel.
 class  ChApi  CProfileSample {
 public:
 	CProfileSample( const char * name )
 	{ 
 		ChProfileManager::Start_Profile( name ); 
+		zone_open = ChProfileRecorder::BeginZone( name );
 	}
 
 	~CProfileSample( void )					
 	{ 
+		if (zone_open)
+			ChProfileRecorder::EndZone();
 		ChProfileManager::Stop_Profile(); 
 	}
+
+private:
+	bool zone_open;
 };
 
 
@@ -179,9 +189,13 @@ public:
 
 #define	CH_PROFILE( name )			chrono::utils::CProfileSample __ch_profile( name )
 
+/// Profile the enclosing scope with the thread-aware ChProfileRecorder only (can be used in parallel regions).
+#define	CH_PROFILE_ZONE( name )		::chrono::utils::ChProfileZone __ch_profile_zone( name )
+
 #else
 
 #define	CH_PROFILE( name )
+#define	CH_PROFILE_ZONE( name )
 
 #endif //#ifndef CH_NO_PROFILE
 
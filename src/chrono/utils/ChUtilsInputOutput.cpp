@@ -14,6 +14,19 @@
 //
 // =============================================================================
 
+#include <cstdint>
+#include <cstring>
+#include <functional>
+#include <map>
+#include <tuple>
+
+#if !defined(_WIN32)
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
 #include "chrono/assets/ChColorAsset.h"
 #include "chrono/geometry/ChLineBezier.h"
 #include "chrono/utils/ChUtilsInputOutput.h"
@@ -297,6 +310,356 @@ void ReadCheckpoint(ChSystem* system, const std::string& filename) {
     }
 }
 
+// -----------------------------------------------------------------------------
+// WriteStateCheckpoint / ReadStateCheckpoint
+//
+// Binary checkpoint file (native byte order), with the following layout:
+//    header:  magic (8 chars), version, byte order mark, time, step,
+//             number of body records, number of item records, size of x, v, L
+//    body records:  identifier, flags, coord, coord_dt, coord_dtdt
+//    item records:  type, identifier, offset_x, ndof_x, offset_w, ndof_w, offset_L, ndoc
+//    state vectors: x, v, a, L
+// -----------------------------------------------------------------------------
+
+namespace {
+
+const char checkpoint_magic[8] = {'C', 'H', 'S', 'T', 'A', 'T', 'E', '\0'};
+const uint32_t checkpoint_version = 1;
+const uint32_t checkpoint_bom = 0x01020304;
+
+enum CheckpointFlags { CKPT_FIXED = 1, CKPT_SLEEPING = 2, CKPT_COLLIDE = 4 };
+enum CheckpointItemType { CKPT_BODY = 0, CKPT_OTHER = 1, CKPT_LINK = 2, CKPT_CONTACTS = 3 };
+
+struct CheckpointHeader {
+    char magic[8];
+    uint32_t version;
+    uint32_t bom;
+    double time;
+    double step;
+    uint64_t num_bodies;
+    uint64_t num_items;
+    uint64_t n_x;
+    uint64_t n_w;
+    uint64_t n_L;
+};
+
+struct CheckpointBody {
+    int32_t identifier;
+    int32_t flags;
+    double coord[7];
+    double coord_dt[7];
+    double coord_dtdt[7];
+};
+
+struct CheckpointItem {
+    int32_t type;
+    int32_t identifier;
+    uint32_t offset_x;
+    uint32_t ndof_x;
+    uint32_t offset_w;
+    uint32_t ndof_w;
+    uint32_t offset_L;
+    uint32_t ndoc;
+};
+
+void CoordsysToArray(const ChCoordsys<>& csys, double* a) {
+    a[0] = csys.pos.x();
+    a[1] = csys.pos.y();
+    a[2] = csys.pos.z();
+    a[3] = csys.rot.e0();
+    a[4] = csys.rot.e1();
+    a[5] = csys.rot.e2();
+    a[6] = csys.rot.e3();
+}
+
+ChCoordsys<> ArrayToCoordsys(const double* a) {
+    return ChCoordsys<>(ChVector<>(a[0], a[1], a[2]), ChQuaternion<>(a[3], a[4], a[5], a[6]));
+}
+
+// Collect the state ranges of the physics items of the system (the system must be set up).
+void CollectCheckpointItems(ChSystem* system, std::vector<CheckpointItem>& items) {
+    auto add_item = [&items](int type, ChPhysicsItem* item) {
+        CheckpointItem rec = {type,
+                              item->GetIdentifier(),
+                              item->GetOffset_x(),
+                              static_cast<uint32_t>(item->GetDOF()),
+                              item->GetOffset_w(),
+                              static_cast<uint32_t>(item->GetDOF_w()),
+                              item->GetOffset_L(),
+                              static_cast<uint32_t>(item->GetDOC())};
+        items.push_back(rec);
+    };
+
+    items.clear();
+    for (auto& body : *system->Get_bodylist()) {
+        if (!body->GetBodyFixed() && !body->GetSleeping())
+            add_item(CKPT_BODY, body.get());
+    }
+    for (auto& item : *system->Get_otherphysicslist())
+        add_item(CKPT_OTHER, item.get());
+    for (auto& link : *system->Get_linklist()) {
+        if (link->IsActive())
+            add_item(CKPT_LINK, link.get());
+    }
+    add_item(CKPT_CONTACTS, system->GetContactContainer().get());
+}
+
+// Key identifying an item: type, identifier, and number of previous items with the same type and identifier.
+typedef std::tuple<int, int, int> CheckpointKey;
+
+template <typename T>
+std::vector<CheckpointKey> GetCheckpointKeys(const std::vector<T>& records, std::function<int(const T&)> type) {
+    std::map<std::pair<int, int>, int> count;
+    std::vector<CheckpointKey> keys;
+    for (auto& rec : records) {
+        int n = count[std::make_pair(type(rec), rec.identifier)]++;
+        keys.push_back(std::make_tuple(type(rec), rec.identifier, n));
+    }
+    return keys;
+}
+
+// Read-only view of a file, memory-mapped if supported.
+class MappedFile {
+  public:
+    MappedFile(const std::string& filename) : m_data(nullptr), m_size(0) {
+#if defined(_WIN32)
+        std::ifstream ifile(filename.c_str(), std::ios::binary | std::ios::ate);
+        if (!ifile)
+            return;
+        m_buffer.resize(static_cast<size_t>(ifile.tellg()));
+        ifile.seekg(0);
+        if (ifile.read(m_buffer.data(), m_buffer.size())) {
+            m_data = m_buffer.data();
+            m_size = m_buffer.size();
+        }
+#else
+        int fd = open(filename.c_str(), O_RDONLY);
+        if (fd < 0)
+            return;
+        struct stat st;
+        if (fstat(fd, &st) == 0 && st.st_size > 0) {
+            void* addr = mmap(nullptr, st.st_size, PROT_READ, MAP_PRIVATE, fd, 0);
+            if (addr != MAP_FAILED) {
+                m_data = static_cast<const char*>(addr);
+                m_size = st.st_size;
+            }
+        }
+        close(fd);
+#endif
+    }
+
+    ~MappedFile() {
+#if !defined(_WIN32)
+        if (m_data)
+            munmap(const_cast<char*>(m_data), m_size);
+#endif
+    }
+
+    const char* data() const { return m_data; }
+    size_t size() const { return m_size; }
+
+  private:
+    const char* m_data;
+    size_t m_size;
+#if defined(_WIN32)
+    std::vector<char> m_buffer;
+#endif
+};
+
+}  // end anonymous namespace
+
+bool WriteStateCheckpoint(ChSystem* system, const std::string& filename) {
+    // Make sure the state offsets are up to date
+    system->Setup();
+
+    // Bodies (including fixed and sleeping bodies, which are not part of the state vectors)
+    std::vector<CheckpointBody> bodies;
+    for (auto& body : *system->Get_bodylist()) {
+        CheckpointBody rec;
+        rec.identifier = body->GetIdentifier();
+        rec.flags = (body->GetBodyFixed() ? CKPT_FIXED : 0) | (body->GetSleeping() ? CKPT_SLEEPING : 0) |
+                    (body->GetCollide() ? CKPT_COLLIDE : 0);
+        CoordsysToArray(body->GetCoord(), rec.coord);
+        CoordsysToArray(body->GetCoord_dt(), rec.coord_dt);
+        CoordsysToArray(body->GetCoord_dtdt(), rec.coord_dtdt);
+        bodies.push_back(rec);
+    }
+
+    // State ranges of all items
+    std::vector<CheckpointItem> items;
+    CollectCheckpointItems(system, items);
+
+    // State vectors
+    ChState x(system->GetNcoords_x(), system);
+    ChStateDelta v(system->GetNcoords_w(), system);
+    ChStateDelta a(system->GetNcoords_w(), system);
+    ChVectorDynamic<> L(system->GetNconstr());
+    double T;
+    system->StateGather(x, v, T);
+    system->StateGatherAcceleration(a);
+    system->StateGatherReactions(L);
+
+    CheckpointHeader header;
+    std::memcpy(header.magic, checkpoint_magic, sizeof(header.magic));
+    header.version = checkpoint_version;
+    header.bom = checkpoint_bom;
+    header.time = T;
+    header.step = system->GetStep();
+    header.num_bodies = bodies.size();
+    header.num_items = items.size();
+    header.n_x = x.GetRows();
+    header.n_w = v.GetRows();
+    header.n_L = L.GetRows();
+
+    std::ofstream ofile(filename.c_str(), std::ios::binary);
+    ofile.write(reinterpret_cast<const char*>(&header), sizeof(header));
+    ofile.write(reinterpret_cast<const char*>(bodies.data()), bodies.size() * sizeof(CheckpointBody));
+    ofile.write(reinterpret_cast<const char*>(items.data()), items.size() * sizeof(CheckpointItem));
+    ofile.write(reinterpret_cast<const char*>(x.GetAddress()), header.n_x * sizeof(double));
+    ofile.write(reinterpret_cast<const char*>(v.GetAddress()), header.n_w * sizeof(double));
+    ofile.write(reinterpret_cast<const char*>(a.GetAddress()), header.n_w * sizeof(double));
+    ofile.write(reinterpret_cast<const char*>(L.GetAddress()), header.n_L * sizeof(double));
+
+    return ofile.good();
+}
+
+bool ReadStateCheckpoint(ChSystem* system, const std::string& filename) {
+    MappedFile file(filename);
+    if (!file.data() || file.size() < sizeof(CheckpointHeader))
+        return false;
+
+    // Check the file header and size
+    CheckpointHeader header;
+    std::memcpy(&header, file.data(), sizeof(header));
+    if (std::memcmp(header.magic, checkpoint_magic, sizeof(header.magic)) != 0 ||
+        header.version != checkpoint_version || header.bom != checkpoint_bom)
+        return false;
+
+    size_t size_bodies = header.num_bodies * sizeof(CheckpointBody);
+    size_t size_items = header.num_items * sizeof(CheckpointItem);
+    size_t size_vectors = (header.n_x + 2 * header.n_w + header.n_L) * sizeof(double);
+    if (file.size() != sizeof(header) + size_bodies + size_items + size_vectors)
+        return false;
+
+    const char* ptr = file.data() + sizeof(header);
+    std::vector<CheckpointBody> bodies(header.num_bodies);
+    std::memcpy(bodies.data(), ptr, size_bodies);
+    ptr += size_bodies;
+    std::vector<CheckpointItem> items(header.num_items);
+    std::memcpy(items.data(), ptr, size_items);
+    ptr += size_items;
+    const double* file_x = reinterpret_cast<const double*>(ptr);
+    const double* file_v = file_x + header.n_x;
+    const double* file_a = file_v + header.n_w;
+    const double* file_L = file_a + header.n_w;
+
+    // Match the bodies of the system with the body records
+    auto& bodylist = *system->Get_bodylist();
+    if (bodylist.size() != bodies.size())
+        return false;
+    auto body_keys = GetCheckpointKeys<CheckpointBody>(bodies, [](const CheckpointBody&) { return CKPT_BODY; });
+    std::map<CheckpointKey, size_t> body_map;
+    for (size_t i = 0; i < body_keys.size(); i++)
+        body_map[body_keys[i]] = i;
+    std::vector<const CheckpointBody*> body_recs;
+    {
+        std::map<int, int> count;
+        for (auto& body : bodylist) {
+            auto it = body_map.find(std::make_tuple(static_cast<int>(CKPT_BODY), body->GetIdentifier(),
+                                                    count[body->GetIdentifier()]++));
+            if (it == body_map.end())
+                return false;
+            body_recs.push_back(&bodies[it->second]);
+        }
+    }
+
+    // Load the body data (this also sets the active bodies, hence the state layout).
+    // Keep the current body data, to restore it if the state vectors do not match the system.
+    auto load_bodies = [&bodylist](const std::vector<const CheckpointBody*>& recs) {
+        for (size_t i = 0; i < bodylist.size(); i++) {
+            auto& body = bodylist[i];
+            const CheckpointBody* rec = recs[i];
+            body->SetBodyFixed((rec->flags & CKPT_FIXED) != 0);
+            body->SetSleeping((rec->flags & CKPT_SLEEPING) != 0);
+            if (body->GetCollide() != ((rec->flags & CKPT_COLLIDE) != 0))
+                body->SetCollide((rec->flags & CKPT_COLLIDE) != 0);
+            body->SetCoord(ArrayToCoordsys(rec->coord));
+            body->SetCoord_dt(ArrayToCoordsys(rec->coord_dt));
+            body->SetCoord_dtdt(ArrayToCoordsys(rec->coord_dtdt));
+        }
+    };
+    std::vector<CheckpointBody> old_bodies(bodylist.size());
+    std::vector<const CheckpointBody*> old_recs;
+    for (size_t i = 0; i < bodylist.size(); i++) {
+        auto& body = bodylist[i];
+        old_bodies[i].flags = (body->GetBodyFixed() ? CKPT_FIXED : 0) | (body->GetSleeping() ? CKPT_SLEEPING : 0) |
+                              (body->GetCollide() ? CKPT_COLLIDE : 0);
+        CoordsysToArray(body->GetCoord(), old_bodies[i].coord);
+        CoordsysToArray(body->GetCoord_dt(), old_bodies[i].coord_dt);
+        CoordsysToArray(body->GetCoord_dtdt(), old_bodies[i].coord_dtdt);
+        old_recs.push_back(&old_bodies[i]);
+    }
+    auto fail = [&]() {
+        load_bodies(old_recs);
+        system->Setup();
+        return false;
+    };
+
+    load_bodies(body_recs);
+    system->Setup();
+
+    // Map the state ranges of the checkpoint items to the current items
+    std::vector<CheckpointItem> sys_items;
+    CollectCheckpointItems(system, sys_items);
+    auto item_type = [](const CheckpointItem& rec) { return static_cast<int>(rec.type); };
+    auto file_keys = GetCheckpointKeys<CheckpointItem>(items, item_type);
+    auto sys_keys = GetCheckpointKeys<CheckpointItem>(sys_items, item_type);
+    std::map<CheckpointKey, size_t> item_map;
+    for (size_t i = 0; i < file_keys.size(); i++)
+        item_map[file_keys[i]] = i;
+
+    ChState x(system->GetNcoords_x(), system);
+    ChStateDelta v(system->GetNcoords_w(), system);
+    ChStateDelta a(system->GetNcoords_w(), system);
+    ChVectorDynamic<> L(system->GetNconstr());
+    double T;
+    system->StateGather(x, v, T);
+    system->StateGatherAcceleration(a);
+    system->StateGatherReactions(L);
+
+    for (size_t i = 0; i < sys_items.size(); i++) {
+        const CheckpointItem& sys_rec = sys_items[i];
+        if (sys_rec.type == CKPT_CONTACTS)
+            continue;
+        auto it = item_map.find(sys_keys[i]);
+        if (it == item_map.end())
+            return fail();
+        const CheckpointItem& file_rec = items[it->second];
+        if (file_rec.ndof_x != sys_rec.ndof_x || file_rec.ndof_w != sys_rec.ndof_w || file_rec.ndoc != sys_rec.ndoc)
+            return fail();
+        if (file_rec.offset_x + file_rec.ndof_x > header.n_x || file_rec.offset_w + file_rec.ndof_w > header.n_w ||
+            file_rec.offset_L + file_rec.ndoc > header.n_L)
+            return fail();
+        std::memcpy(x.GetAddress() + sys_rec.offset_x, file_x + file_rec.offset_x, sys_rec.ndof_x * sizeof(double));
+        std::memcpy(v.GetAddress() + sys_rec.offset_w, file_v + file_rec.offset_w, sys_rec.ndof_w * sizeof(double));
+        std::memcpy(a.GetAddress() + sys_rec.offset_w, file_a + file_rec.offset_w, sys_rec.ndof_w * sizeof(double));
+        std::memcpy(L.GetAddress() + sys_rec.offset_L, file_L + file_rec.offset_L, sys_rec.ndoc * sizeof(double));
+    }
+
+    // Load the state into the system
+    system->SetStep(header.step);
+    system->StateScatter(x, v, header.time);
+    system->StateScatterAcceleration(a);
+    system->StateScatterReactions(L);
+    system->SetChTime(header.time);
+
+    // Reload the body coordinates, since the conversions between angular velocities and quaternion derivatives
+    // in the state vectors are not exact
+    load_bodies(body_recs);
+
+    return true;
+}
+
 // -----------------------------------------------------------------------------
 // WriteShapesPovray
 //
@@ -25,6 +25,10 @@
 //      contact geometry.
 //    - only a subset of contact shapes are currently supported
 //
+// WriteStateCheckpoint and ReadStateCheckpoint
+//  these functions write and read, respectively, a binary checkpoint of the
+//  state of an existing system (to restart a simulation of the same model).
+//
 // WriteShapesPovray
 //  this function writes a CSV file appropriate for processing with a POV-Ray
 //  script.
@@ -143,6 +147,28 @@ bool WriteCheckpoint(ChSystem* system, const std::string& filename);
 ChApi
 void ReadCheckpoint(ChSystem* system, const std::string& filename);
 
+// Write a binary checkpoint file with the full state of the given system:
+//   - simulation time and step size
+//   - position, velocity, acceleration, and fixed/sleeping/collide flags of all bodies
+//   - the state vectors x, v, a, and the reactions L, as obtained with StateGather, together with
+//     the range of each physics item (body, link, other physics item) in these vectors
+// Physics items are identified by their type, identifier, and order in the system's lists.
+// Return false if the file could not be written.
+ChApi
+bool WriteStateCheckpoint(ChSystem* system, const std::string& filename);
+
+// Read a binary checkpoint file created with WriteStateCheckpoint and load the state into the given system.
+// The system must contain the same physics items as the system used to create the checkpoint (for example,
+// constructed with the same code). The file is memory-mapped and the state vectors are copied in bulk.
+// Return false, without modifying the system, if the file is invalid or does not match the system.
+// Notes:
+//   - contacts are not restored; they are regenerated by the collision detection at the next step.
+//     Contact reactions are stored in the checkpoint, but not reloaded.
+//   - internal data of physics items not exposed through the state vectors (e.g. material history in
+//     FEA elements or persistent contact manifolds of the collision system) is not restored.
+ChApi
+bool ReadStateCheckpoint(ChSystem* system, const std::string& filename);
+
 // Write CSV output file for PovRay.
 // Each line contains information about one visualization asset shape, as
 // follows:
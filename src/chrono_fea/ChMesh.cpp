@@ -23,6 +23,7 @@
 #include "chrono/physics/ChLoad.h"
 #include "chrono/physics/ChObject.h"
 #include "chrono/physics/ChSystem.h"
+#include "chrono/utils/ChProfiler.h"
 
 #include "chrono_fea/ChElementTetra_4.h"
 #include "chrono_fea/ChMesh.h"
@@ -45,6 +46,7 @@ ChMesh::ChMesh(const ChMesh& other) : ChIndexedNodes(other) {
 
     automatic_gravity_load = other.automatic_gravity_load;
     num_points_gravity = other.num_points_gravity;
+    gravity_cache_valid = false;
 
     ncalls_internal_forces = 0;
     ncalls_KRMload = 0;
@@ -66,6 +68,8 @@ void ChMesh::SetupInitial() {
         //    - precompute matrices, such as the [Kl] local stiffness of each element, if needed, etc.
         velements[i]->SetupInitial(GetSystem());
     }
+
+    gravity_cache_valid = false;
 }
 
 void ChMesh::Relax() {
@@ -85,21 +89,32 @@ void ChMesh::SetNoSpeedNoAcceleration() {
 void ChMesh::AddNode(std::shared_ptr<ChNodeFEAbase> m_node) {
     m_node->SetIndex(vnodes.size() + 1);
     vnodes.push_back(m_node);
+    if (system)
+        system->SetTopologyChanged();
 }
 
 void ChMesh::AddElement(std::shared_ptr<ChElementBase> m_elem) {
     velements.push_back(m_elem);
+    gravity_cache_valid = false;
+    if (system)
+        system->SetTopologyChanged();
 }
 
 void ChMesh::ClearElements() {
     velements.clear();
     vcontactsurfaces.clear();
+    gravity_cache_valid = false;
+    if (system)
+        system->SetTopologyChanged();
 }
 
 void ChMesh::ClearNodes() {
     velements.clear();
     vnodes.clear();
     vcontactsurfaces.clear();
+    gravity_cache_valid = false;
+    if (system)
+        system->SetTopologyChanged();
 }
 
 void ChMesh::AddContactSurface(std::shared_ptr<ChContactSurface> m_surf) {
@@ -248,6 +263,8 @@ void ChMesh::IntLoadResidual_F(const unsigned int off,
                                ChVectorDynamic<>& R,   
                                const double c          
                                ) {
+    CH_PROFILE_ZONE("ChMesh::IntLoadResidual_F");
+
     // applied nodal forces
     unsigned int local_off_v = 0;
     for (unsigned int j = 0; j < vnodes.size(); j++) {
@@ -266,28 +283,67 @@ void ChMesh::IntLoadResidual_F(const unsigned int off,
     timer_internal_forces.stop();
     ncalls_internal_forces++;
 
-    // Apply gravity loads without the need of adding
-    // a ChLoad object to each element: just instance here a single ChLoad and reuse
-    // it for all 'volume' objects.
+    // Apply gravity loads without the need of adding a ChLoad object to each element.
+    // The generalized gravity forces of the 'volume' elements do not change with the deformation (the mass of
+    // each element is constant), so they are cached and recomputed only when the mesh or the gravity change.
     if (automatic_gravity_load) {
-        std::shared_ptr<ChLoadableUVW> mloadable;  // still null
-        auto common_gravity_loader = std::make_shared<ChLoad<ChLoaderGravity>>(mloadable);
-        common_gravity_loader->loader.Set_G_acc(GetSystem()->Get_G_acc());
-        common_gravity_loader->loader.SetNumIntPoints(num_points_gravity);
-
-        for (unsigned int ie = 0; ie < velements.size(); ie++) {
-            if ((mloadable = std::dynamic_pointer_cast<ChLoadableUVW>(velements[ie]))) {
-                if (mloadable->GetDensity()) {
-                    // temporary set loader target and compute generalized forces term
-                    common_gravity_loader->loader.loadable = mloadable;
-                    common_gravity_loader->ComputeQ(0, 0);
-                    common_gravity_loader->LoadIntLoadResidual_F(R, c);
+        if (!gravity_cache_valid || gravity_G_acc != GetSystem()->Get_G_acc())
+            UpdateGravityCache();
+
+        for (unsigned int ig = 0; ig < gravity_loadables.size(); ig++) {
+            ChLoadableUVW* mloadable = gravity_loadables[ig].get();
+            if (mloadable->GetDensity() != gravity_density[ig]) {
+                // the element density was changed: recompute its gravity force
+                ChLoaderGravity loader(gravity_loadables[ig]);
+                loader.Set_G_acc(gravity_G_acc);
+                loader.SetNumIntPoints(num_points_gravity);
+                loader.ComputeQ(nullptr, nullptr);
+                gravity_Q[ig] = loader.Q;
+                gravity_density[ig] = mloadable->GetDensity();
+            }
+            const ChVectorDynamic<>& Q = gravity_Q[ig];
+            unsigned int rowQ = 0;
+            for (int i = 0; i < mloadable->GetSubBlocks(); ++i) {
+                unsigned int moffset = mloadable->GetSubBlockOffset(i);
+                for (unsigned int row = 0; row < mloadable->GetSubBlockSize(i); ++row) {
+                    R(row + moffset) += Q(rowQ) * c;
+                    ++rowQ;
                 }
             }
         }
     }
 }
 
+void ChMesh::UpdateGravityCache() {
+    gravity_G_acc = GetSystem()->Get_G_acc();
+
+    // Collect the elements that support volume loads
+    gravity_loadables.clear();
+    for (unsigned int ie = 0; ie < velements.size(); ie++) {
+        if (auto mloadable = std::dynamic_pointer_cast<ChLoadableUVW>(velements[ie]))
+            gravity_loadables.push_back(mloadable);
+    }
+    gravity_Q.resize(gravity_loadables.size());
+    gravity_density.resize(gravity_loadables.size());
+
+    // Integrate the gravity load on each element
+#pragma omp parallel for schedule(dynamic, 4)
+    for (int ig = 0; ig < gravity_loadables.size(); ig++) {
+        gravity_density[ig] = gravity_loadables[ig]->GetDensity();
+        if (gravity_density[ig]) {
+            ChLoaderGravity loader(gravity_loadables[ig]);
+            loader.Set_G_acc(gravity_G_acc);
+            loader.SetNumIntPoints(num_points_gravity);
+            loader.ComputeQ(nullptr, nullptr);
+            gravity_Q[ig] = loader.Q;
+        } else {
+            gravity_Q[ig].Reset(gravity_loadables[ig]->LoadableGet_ndof_w());
+        }
+    }
+
+    gravity_cache_valid = true;
+}
+
 void ChMesh::ComputeMassProperties(double& mass,           // ChMesh object mass
                                    ChVector<>& com,        // ChMesh center of gravity
                                    ChMatrix33<>& inertia)  // ChMesh inertia tensor
@@ -365,6 +421,8 @@ void ChMesh::InjectKRMmatrices(ChSystemDescriptor& mdescriptor) {
 }
 
 void ChMesh::KRMmatricesLoad(double Kfactor, double Rfactor, double Mfactor) {
+    CH_PROFILE_ZONE("ChMesh::KRMmatricesLoad");
+
     timer_KRMload.start();
 #pragma omp parallel for
     for (int ie = 0; ie < velements.size(); ie++)
@@ -21,6 +21,7 @@
 #include "chrono/core/ChTimer.h"
 #include "chrono/physics/ChContinuumMaterial.h"
 #include "chrono/physics/ChIndexedNodes.h"
+#include "chrono/physics/ChLoadable.h"
 #include "chrono/physics/ChMaterialSurfaceNSC.h"
 #include "chrono_fea/ChContactSurface.h"
 #include "chrono_fea/ChElementBase.h"
@@ -51,6 +52,13 @@ class ChApiFea ChMesh : public ChIndexedNodes {
     bool automatic_gravity_load;
     int num_points_gravity;
 
+    // Cache of the generalized gravity forces of the elements, used for the automatic gravity load.
+    bool gravity_cache_valid;                                       ///< cache up to date with mesh, G and num. points
+    ChVector<> gravity_G_acc;                                       ///< gravity used to compute the cache
+    std::vector<std::shared_ptr<ChLoadableUVW>> gravity_loadables;  ///< volume-loadable elements, of any density
+    std::vector<ChVectorDynamic<>> gravity_Q;                       ///< generalized gravity force of each element
+    std::vector<double> gravity_density;                            ///< density used for each element
+
     ChTimer<> timer_internal_forces;
     ChTimer<> timer_KRMload;
     int ncalls_internal_forces;
@@ -62,6 +70,7 @@ class ChApiFea ChMesh : public ChIndexedNodes {
           n_dofs_w(0),
           automatic_gravity_load(true),
           num_points_gravity(1),
+          gravity_cache_valid(false),
           ncalls_internal_forces(0),
           ncalls_KRMload(0) {}
     ChMesh(const ChMesh& other);
@@ -165,13 +174,21 @@ class ChApiFea ChMesh : public ChIndexedNodes {
     /// If true, as by default, this mesh will add automatically a gravity load
     /// to all contained elements (that support gravity) using the G value from the ChSystem.
     /// So this saves you from adding many ChLoad<ChLoaderGravity> to all elements.
+    /// The generalized gravity forces of the elements are computed once and cached; they are recomputed
+    /// when the mesh, the gravity of the ChSystem, or the density of an element change.
     void SetAutomaticGravity(bool mg, int num_points = 1) {
         automatic_gravity_load = mg;
         num_points_gravity = num_points;
+        gravity_cache_valid = false;
     }
     /// Tell if this mesh will add automatically a gravity load to all contained elements.
     bool GetAutomaticGravity() { return automatic_gravity_load; }
 
+    /// Force the recomputation of the cached element gravity forces used by the automatic gravity load.
+    /// Only needed if the elements were modified in a way that changes their gravity load (other than
+    /// a change of density), for example after changing their reference configuration.
+    void ResetAutomaticGravityCache() { gravity_cache_valid = false; }
+
     /// Get ChMesh mass properties
     void ComputeMassProperties(double& mass,          ///< ChMesh object mass
                                ChVector<>& com,       ///< ChMesh center of gravity
@@ -269,6 +286,9 @@ class ChApiFea ChMesh : public ChIndexedNodes {
     virtual void InjectVariables(ChSystemDescriptor& mdescriptor) override;
 
   private:
+    /// Compute the generalized gravity forces of all elements, for the automatic gravity load.
+    void UpdateGravityCache();
+
     /// Initial setup (before analysis).
     /// This function is called from ChSystem::SetupInitial, marking a point where system
     /// construction is completed.
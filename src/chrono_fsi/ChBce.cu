@@ -340,8 +340,7 @@ void ChBce::Populate_RigidSPH_MeshPos_LRF(SphMarkerDataD *sphMarkersD,
   computeGridSize(numObjectsH->numRigid_SphMarkers, 256,
                   nBlocks_numRigid_SphMarkers, nThreads_SphMarkers);
 
-  Populate_RigidSPH_MeshPos_LRF_kernel<<<nBlocks_numRigid_SphMarkers,
-                                         nThreads_SphMarkers>>>(
+  CH_FSI_LAUNCH(Populate_RigidSPH_MeshPos_LRF_kernel, nBlocks_numRigid_SphMarkers, nThreads_SphMarkers)(
       mR3CAST(fsiGeneralData->rigidSPH_MeshPos_LRF_D),
       mR3CAST(sphMarkersD->posRadD), U1CAST(fsiGeneralData->rigidIdentifierD),
       mR3CAST(fsiBodiesD->posRigid_fsiBodies_D),
@@ -374,7 +373,7 @@ void ChBce::RecalcSortedVelocityPressure_BCE(
   uint numThreads, numBlocks;
   computeGridSize(updatePortion.y - updatePortion.x, 64, numBlocks, numThreads);
 
-  new_BCE_VelocityPressure<<<numBlocks, numThreads>>>(
+  CH_FSI_LAUNCH(new_BCE_VelocityPressure, numBlocks, numThreads)(
       mR3CAST(velMas_ModifiedBCE),
       mR4CAST(rhoPreMu_ModifiedBCE), // input: sorted velocities
       mR3CAST(sortedPosRad), mR3CAST(sortedVelMas), mR4CAST(sortedRhoPreMu),
@@ -407,7 +406,7 @@ void ChBce::CalcBceAcceleration(
   uint numThreads, numBlocks;
   computeGridSize(numRigid_SphMarkers, 64, numBlocks, numThreads);
 
-  calcBceAcceleration_kernel<<<numBlocks, numThreads>>>(
+  CH_FSI_LAUNCH(calcBceAcceleration_kernel, numBlocks, numThreads)(
       mR3CAST(bceAcc), mR4CAST(q_fsiBodies_D), mR3CAST(accRigid_fsiBodies_D),
       mR3CAST(omegaVelLRF_fsiBodies_D), mR3CAST(omegaAccLRF_fsiBodies_D),
       mR3CAST(rigidSPH_MeshPos_LRF_D), U1CAST(rigidIdentifierD));
@@ -513,7 +512,7 @@ void ChBce::Rigid_Forces_Torques(SphMarkerDataD *sphMarkersD,
   //** accumulated BCE forces at center are transformed to acceleration of rigid
   //body "rigid_FSI_ForcesD".
   //"rigid_FSI_ForcesD" gets built.
-  Calc_Rigid_FSI_ForcesD<<<nBlock_UpdateRigid, nThreads_rigidParticles>>>(
+  CH_FSI_LAUNCH(Calc_Rigid_FSI_ForcesD, nBlock_UpdateRigid, nThreads_rigidParticles)(
       mR3CAST(fsiGeneralData->rigid_FSI_ForcesD),
       mR4CAST(totalSurfaceInteractionRigid4));
   cudaThreadSynchronize();
@@ -528,7 +527,7 @@ void ChBce::Rigid_Forces_Torques(SphMarkerDataD *sphMarkersD,
   //** the current position of the rigid, 'posRigidD', is used to calculate the
   //moment of BCE acceleration at the rigid
   //*** body center (i.e. torque/mass). "torqueMarkersD" gets built.
-  Calc_Markers_TorquesD<<<nBlocks_numRigid_SphMarkers, nThreads_SphMarkers>>>(
+  CH_FSI_LAUNCH(Calc_Markers_TorquesD, nBlocks_numRigid_SphMarkers, nThreads_SphMarkers)(
       mR3CAST(torqueMarkersD), mR4CAST(fsiGeneralData->derivVelRhoD),
       mR3CAST(sphMarkersD->posRadD), U1CAST(fsiGeneralData->rigidIdentifierD),
       mR3CAST(fsiBodiesD->posRigid_fsiBodies_D));
@@ -560,8 +559,7 @@ void ChBce::UpdateRigidMarkersPositionVelocity(SphMarkerDataD *sphMarkersD,
   //** "posRadD2"/"velMasD2" associated to BCE markers are updated based on new
   //rigid body (position,
   // orientation)/(velocity, angular velocity)
-  UpdateRigidMarkersPositionVelocityD<<<nBlocks_numRigid_SphMarkers,
-                                        nThreads_SphMarkers>>>(
+  CH_FSI_LAUNCH(UpdateRigidMarkersPositionVelocityD, nBlocks_numRigid_SphMarkers, nThreads_SphMarkers)(
       mR3CAST(sphMarkersD->posRadD), mR3CAST(sphMarkersD->velMasD),
       mR3CAST(fsiGeneralData->rigidSPH_MeshPos_LRF_D),
       U1CAST(fsiGeneralData->rigidIdentifierD),
@@ -113,10 +113,17 @@ __global__ void reorderDataAndFindCellStartD(uint* cellStartD,      // output: c
                                              Real3* velMasD,             // input: sorted velocity array
                                              Real4* rhoPresMuD,
                                              uint numAllMarkers) {
-    extern __shared__ uint sharedHash[];  // blockSize + 1 elements
     /* Get the particle index the current thread is supposed to be looking at. */
     uint index = blockIdx.x * blockDim.x + threadIdx.x;
     uint hash;
+#ifdef CHRONO_FSI_USE_CPU
+    /* No shared memory on the host: the hash of the previous particle is read
+     * directly from the sorted hash array */
+    if (index < numAllMarkers) {
+        hash = gridMarkerHashD[index];
+    }
+#else
+    extern __shared__ uint sharedHash[];  // blockSize + 1 elements
     /* handle case when no. of particles not multiple of block size */
     if (index < numAllMarkers) {
         hash = gridMarkerHashD[index];
@@ -133,8 +140,14 @@ __global__ void reorderDataAndFindCellStartD(uint* cellStartD,      // output: c
     }
 
     __syncthreads();
+#endif
 
     if (index < numAllMarkers) {
+#ifdef CHRONO_FSI_USE_CPU
+        uint prevHash = (index > 0) ? gridMarkerHashD[index - 1] : 0;
+#else
+        uint prevHash = sharedHash[threadIdx.x];
+#endif
         /* If this particle has a different cell index to the previous particle then
          * it must be
          * the first particle in the cell, so store the index of this particle in
@@ -142,10 +155,10 @@ __global__ void reorderDataAndFindCellStartD(uint* cellStartD,      // output: c
          * isn't the first particle, it must also be the cell end of the previous
          * particle's cell
          */
-        if (index == 0 || hash != sharedHash[threadIdx.x]) {
+        if (index == 0 || hash != prevHash) {
             cellStartD[hash] = index;
             if (index > 0)
-                cellEndD[sharedHash[threadIdx.x]] = index;
+                cellEndD[prevHash] = index;
         }
 
         if (index == numAllMarkers - 1) {
@@ -231,7 +244,7 @@ void ChCollisionSystemFsi::calcHash() {
     computeGridSize(numObjectsH->numAllMarkers, 256, numBlocks, numThreads);
     /* Execute Kernel */
 
-    calcHashD<<<numBlocks, numThreads>>>(U1CAST(markersProximityD->gridMarkerHashD),
+    CH_FSI_LAUNCH(calcHashD, numBlocks, numThreads)(U1CAST(markersProximityD->gridMarkerHashD),
                                          U1CAST(markersProximityD->gridMarkerIndexD), mR3CAST(sphMarkersD->posRadD),
                                          numObjectsH->numAllMarkers, isErrorD);
 
@@ -266,7 +279,7 @@ void ChCollisionSystemFsi::reorderDataAndFindCellStart() {
     computeGridSize(numObjectsH->numAllMarkers, 256, numBlocks, numThreads);  //?$ 256 is blockSize
 
     uint smemSize = sizeof(uint) * (numThreads + 1);
-    reorderDataAndFindCellStartD<<<numBlocks, numThreads, smemSize>>>(
+    CH_FSI_LAUNCH(reorderDataAndFindCellStartD, numBlocks, numThreads, smemSize)(
         U1CAST(markersProximityD->cellStartD), U1CAST(markersProximityD->cellEndD), mR3CAST(sortedSphMarkersD->posRadD),
         mR3CAST(sortedSphMarkersD->velMasD), mR4CAST(sortedSphMarkersD->rhoPresMuD),
         U1CAST(markersProximityD->gridMarkerHashD), U1CAST(markersProximityD->gridMarkerIndexD),
@@ -0,0 +1,256 @@
+// =============================================================================
+// PROJECT CHRONO - http://projectchrono.org
+//
+// Copyright (c) 2014 projectchrono.org
+// All rights reserved.
+//
+// Use of this source code is governed by a BSD-style license that can be found
+// in the LICENSE file at the top level of the distribution and at
+// http://projectchrono.org/license-chrono.txt.
+//
+// =============================================================================
+//
+// Host emulation of the subset of the CUDA language and runtime used by the
+// Chrono::FSI module. Used in place of <cuda_runtime.h> when the module is
+// built for multicore CPUs (CHRONO_FSI_USE_CPU). The device system of thrust is
+// then OpenMP, TBB or sequential, and kernels are launched as thrust::for_each
+// over the threads of the CUDA grid.
+//
+// =============================================================================
+
+#ifndef CH_DEVICE_CPU_H
+#define CH_DEVICE_CPU_H
+
+#include <chrono>
+#include <cmath>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+
+#include <thrust/execution_policy.h>
+#include <thrust/for_each.h>
+#include <thrust/iterator/counting_iterator.h>
+
+// ----------------------------------------------------------------------------
+// Function and variable qualifiers
+// ----------------------------------------------------------------------------
+#ifndef __host__
+#define __host__
+#endif
+#ifndef __device__
+#define __device__
+#endif
+#ifndef __global__
+#define __global__
+#endif
+#ifndef __forceinline__
+#define __forceinline__ inline
+#endif
+// Constant memory symbols are defined in headers: one copy per translation unit, as with CUDA whole-program compilation.
+#define __constant__ static
+
+using std::isfinite;
+using std::isnan;
+
+// ----------------------------------------------------------------------------
+// Built-in vector types (same layout and alignment as the CUDA types)
+// ----------------------------------------------------------------------------
+struct alignas(8) int2 {
+    int x, y;
+};
+struct int3 {
+    int x, y, z;
+};
+struct alignas(16) int4 {
+    int x, y, z, w;
+};
+
+struct alignas(8) uint2 {
+    unsigned int x, y;
+};
+struct uint3 {
+    unsigned int x, y, z;
+};
+struct alignas(16) uint4 {
+    unsigned int x, y, z, w;
+};
+
+struct alignas(8) float2 {
+    float x, y;
+};
+struct float3 {
+    float x, y, z;
+};
+struct alignas(16) float4 {
+    float x, y, z, w;
+};
+
+struct alignas(16) double2 {
+    double x, y;
+};
+struct double3 {
+    double x, y, z;
+};
+struct alignas(16) double4 {
+    double x, y, z, w;
+};
+
+struct dim3 {
+    unsigned int x, y, z;
+    dim3(unsigned int vx = 1, unsigned int vy = 1, unsigned int vz = 1) : x(vx), y(vy), z(vz) {}
+};
+
+// ----------------------------------------------------------------------------
+// Runtime API
+// ----------------------------------------------------------------------------
+enum cudaError_t { cudaSuccess = 0, cudaErrorMemoryAllocation = 2 };
+
+enum cudaMemcpyKind {
+    cudaMemcpyHostToHost = 0,
+    cudaMemcpyHostToDevice = 1,
+    cudaMemcpyDeviceToHost = 2,
+    cudaMemcpyDeviceToDevice = 3,
+    cudaMemcpyDefault = 4
+};
+
+typedef struct CUstream_st* cudaStream_t;
+typedef std::chrono::high_resolution_clock::time_point* cudaEvent_t;
+
+inline cudaError_t cudaMalloc(void** ptr, size_t size) {
+    *ptr = std::malloc(size);
+    return (*ptr || size == 0) ? cudaSuccess : cudaErrorMemoryAllocation;
+}
+
+template <typename T>
+inline cudaError_t cudaMalloc(T** ptr, size_t size) {
+    return cudaMalloc(reinterpret_cast<void**>(ptr), size);
+}
+
+inline cudaError_t cudaFree(void* ptr) {
+    std::free(ptr);
+    return cudaSuccess;
+}
+
+inline cudaError_t cudaMemcpy(void* dst, const void* src, size_t count, cudaMemcpyKind kind) {
+    std::memcpy(dst, src, count);
+    return cudaSuccess;
+}
+
+template <typename T>
+inline cudaError_t cudaMemcpyToSymbol(T& symbol,
+                                      const void* src,
+                                      size_t count,
+                                      size_t offset = 0,
+                                      cudaMemcpyKind kind = cudaMemcpyHostToDevice) {
+    std::memcpy(reinterpret_cast<char*>(&symbol) + offset, src, count);
+    return cudaSuccess;
+}
+
+template <typename T>
+inline cudaError_t cudaMemcpyToSymbolAsync(T& symbol,
+                                           const void* src,
+                                           size_t count,
+                                           size_t offset = 0,
+                                           cudaMemcpyKind kind = cudaMemcpyHostToDevice,
+                                           cudaStream_t stream = 0) {
+    return cudaMemcpyToSymbol(symbol, src, count, offset, kind);
+}
+
+// Kernels are completed when the launch returns.
+inline cudaError_t cudaDeviceSynchronize() {
+    return cudaSuccess;
+}
+inline cudaError_t cudaThreadSynchronize() {
+    return cudaSuccess;
+}
+inline cudaError_t cudaGetLastError() {
+    return cudaSuccess;
+}
+inline const char* cudaGetErrorString(cudaError_t error) {
+    return error == cudaSuccess ? "no error" : "out of memory";
+}
+
+inline cudaError_t cudaEventCreate(cudaEvent_t* event) {
+    *event = new std::chrono::high_resolution_clock::time_point;
+    return cudaSuccess;
+}
+inline cudaError_t cudaEventDestroy(cudaEvent_t event) {
+    delete event;
+    return cudaSuccess;
+}
+inline cudaError_t cudaEventRecord(cudaEvent_t event, cudaStream_t stream = 0) {
+    *event = std::chrono::high_resolution_clock::now();
+    return cudaSuccess;
+}
+inline cudaError_t cudaEventSynchronize(cudaEvent_t event) {
+    return cudaSuccess;
+}
+inline cudaError_t cudaEventElapsedTime(float* ms, cudaEvent_t start, cudaEvent_t stop) {
+    *ms = std::chrono::duration<float, std::milli>(*stop - *start).count();
+    return cudaSuccess;
+}
+
+// ----------------------------------------------------------------------------
+// Device intrinsics
+// ----------------------------------------------------------------------------
+inline int __mul24(int a, int b) {
+    return a * b;
+}
+inline unsigned int __umul24(unsigned int a, unsigned int b) {
+    return a * b;
+}
+
+namespace chrono {
+namespace fsi {
+
+// ----------------------------------------------------------------------------
+// Kernel launch
+// ----------------------------------------------------------------------------
+
+/// Indices of the emulated CUDA thread executing a kernel on the calling host thread.
+extern thread_local uint3 threadIdx;
+extern thread_local uint3 blockIdx;
+extern thread_local uint3 blockDim;
+extern thread_local uint3 gridDim;
+
+/// Launch of a kernel over a (one-dimensional) CUDA grid.
+/// The threads of the grid are distributed by thrust::for_each over the host threads of the thrust device system.
+/// Kernels must not synchronize threads within a block (no __syncthreads and no shared memory).
+template <typename... Params>
+class ChKernelLaunch {
+  public:
+    ChKernelLaunch(void (*kernel)(Params...), dim3 grid, dim3 block) : m_kernel(kernel), m_grid(grid), m_block(block) {}
+
+    template <typename... Args>
+    void operator()(Args... args) const {
+        void (*kernel)(Params...) = m_kernel;
+        uint3 grid = {m_grid.x, 1, 1};
+        uint3 block = {m_block.x, 1, 1};
+        unsigned int num_threads = grid.x * block.x;
+        thrust::for_each(thrust::device, thrust::counting_iterator<unsigned int>(0),
+                         thrust::counting_iterator<unsigned int>(num_threads), [=](unsigned int i) {
+                             gridDim = grid;
+                             blockDim = block;
+                             blockIdx.x = i / block.x;
+                             threadIdx.x = i % block.x;
+                             kernel(args...);
+                         });
+    }
+
+  private:
+    void (*m_kernel)(Params...);
+    dim3 m_grid;
+    dim3 m_block;
+};
+
+/// Create the launch of a kernel with the given grid and block dimensions (see CH_FSI_LAUNCH).
+/// The size of the dynamic shared memory is ignored.
+template <typename... Params>
+ChKernelLaunch<Params...> ChLaunchKernel(void (*kernel)(Params...), dim3 grid, dim3 block, size_t shared_mem = 0) {
+    return ChKernelLaunch<Params...>(kernel, grid, block);
+}
+
+}  // end namespace fsi
+}  // end namespace chrono
+
+#endif
@@ -23,6 +23,13 @@
 namespace chrono {
 namespace fsi {
 
+#ifdef CHRONO_FSI_USE_CPU
+thread_local uint3 threadIdx = {0, 0, 0};
+thread_local uint3 blockIdx = {0, 0, 0};
+thread_local uint3 blockDim = {1, 1, 1};
+thread_local uint3 gridDim = {1, 1, 1};
+#endif
+
 void ChDeviceUtils::ResizeMyThrust3(thrust::device_vector<Real3> &mThrustVec,
                                     int mSize) {
   mThrustVec.resize(mSize);
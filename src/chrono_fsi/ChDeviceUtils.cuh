@@ -71,6 +71,19 @@ typedef unsigned int uint;
 #define CUDA_KERNEL_DIM(...) << <__VA_ARGS__>>>
 #endif
 
+// ----------------------------------------------------------------------------
+// Kernel launch
+//
+// CH_FSI_LAUNCH(kernel, numBlocks, numThreads[, sharedMem])(arguments)
+// is equivalent to kernel<<<numBlocks, numThreads[, sharedMem]>>>(arguments)
+// and launches the kernel on the thrust device system if compiled for CPU.
+// ----------------------------------------------------------------------------
+#ifdef CHRONO_FSI_USE_CPU
+#define CH_FSI_LAUNCH(kernel, ...) chrono::fsi::ChLaunchKernel(kernel, __VA_ARGS__)
+#else
+#define CH_FSI_LAUNCH(kernel, ...) kernel<<<__VA_ARGS__>>>
+#endif
+
 // ----------------------------------------------------------------------------
 // Values
 // ----------------------------------------------------------------------------
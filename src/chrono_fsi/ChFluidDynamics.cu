@@ -402,7 +402,7 @@ void ChFluidDynamics::UpdateFluid(SphMarkerDataD *sphMarkersD, Real dT) {
   uint nBlock_UpdateFluid, nThreads;
   computeGridSize(updatePortion.y - updatePortion.x, 128, nBlock_UpdateFluid,
                   nThreads);
-  UpdateFluidD<<<nBlock_UpdateFluid, nThreads>>>(
+  CH_FSI_LAUNCH(UpdateFluidD, nBlock_UpdateFluid, nThreads)(
       mR3CAST(sphMarkersD->posRadD), mR3CAST(sphMarkersD->velMasD),
       mR3CAST(fsiData->fsiGeneralData.vel_XSPH_D),
       mR4CAST(sphMarkersD->rhoPresMuD),
@@ -430,16 +430,16 @@ void ChFluidDynamics::ApplyBoundarySPH_Markers(SphMarkerDataD *sphMarkersD) {
   uint nBlock_NumSpheres, nThreads_SphMarkers;
   computeGridSize(numObjectsH->numAllMarkers, 256, nBlock_NumSpheres,
                   nThreads_SphMarkers);
-  ApplyPeriodicBoundaryXKernel<<<nBlock_NumSpheres, nThreads_SphMarkers>>>(
+  CH_FSI_LAUNCH(ApplyPeriodicBoundaryXKernel, nBlock_NumSpheres, nThreads_SphMarkers)(
       mR3CAST(sphMarkersD->posRadD), mR4CAST(sphMarkersD->rhoPresMuD));
   cudaThreadSynchronize();
   cudaCheckError();
   // these are useful anyway for out of bound particles
-  ApplyPeriodicBoundaryYKernel<<<nBlock_NumSpheres, nThreads_SphMarkers>>>(
+  CH_FSI_LAUNCH(ApplyPeriodicBoundaryYKernel, nBlock_NumSpheres, nThreads_SphMarkers)(
       mR3CAST(sphMarkersD->posRadD), mR4CAST(sphMarkersD->rhoPresMuD));
   cudaThreadSynchronize();
   cudaCheckError();
-  ApplyPeriodicBoundaryZKernel<<<nBlock_NumSpheres, nThreads_SphMarkers>>>(
+  CH_FSI_LAUNCH(ApplyPeriodicBoundaryZKernel, nBlock_NumSpheres, nThreads_SphMarkers)(
       mR3CAST(sphMarkersD->posRadD), mR4CAST(sphMarkersD->rhoPresMuD));
   cudaThreadSynchronize();
   cudaCheckError();
@@ -459,7 +459,7 @@ void ChFluidDynamics::DensityReinitialization() {
 
   thrust::device_vector<Real4> dummySortedRhoPreMu =
       fsiData->sortedSphMarkersD.rhoPresMuD;
-  ReCalcDensityD_F1<<<nBlock_NumSpheres, nThreads_SphMarkers>>>(
+  CH_FSI_LAUNCH(ReCalcDensityD_F1, nBlock_NumSpheres, nThreads_SphMarkers)(
       mR4CAST(dummySortedRhoPreMu), mR3CAST(fsiData->sortedSphMarkersD.posRadD),
       mR3CAST(fsiData->sortedSphMarkersD.velMasD),
       mR4CAST(fsiData->sortedSphMarkersD.rhoPresMuD),
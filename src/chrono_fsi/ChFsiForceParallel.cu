@@ -455,7 +455,7 @@ void ChFsiForceParallel::CalculateXSPH_velocity() {
   computeGridSize(numObjectsH->numAllMarkers, 64, numBlocks, numThreads);
 
   /* Execute the kernel */
-  newVel_XSPH_D<<<numBlocks, numThreads>>>(
+  CH_FSI_LAUNCH(newVel_XSPH_D, numBlocks, numThreads)(
       mR3CAST(vel_XSPH_Sorted_D), mR3CAST(sortedSphMarkersD->posRadD),
       mR3CAST(sortedSphMarkersD->velMasD),
       mR4CAST(sortedSphMarkersD->rhoPresMuD),
@@ -505,7 +505,7 @@ void ChFsiForceParallel::collide(
   computeGridSize(numObjectsH->numAllMarkers, 64, numBlocks, numThreads);
 
   // execute the kernel
-  collideD<<<numBlocks, numThreads>>>(
+  CH_FSI_LAUNCH(collideD, numBlocks, numThreads)(
       mR4CAST(sortedDerivVelRho_fsi_D), mR3CAST(sortedPosRad),
       mR3CAST(sortedVelMas), mR3CAST(vel_XSPH_Sorted_D),
       mR4CAST(sortedRhoPreMu), mR3CAST(velMas_ModifiedBCE),
@@ -20,8 +20,12 @@
 #ifndef CHFSI_CUSTOM_MATH_H
 #define CHFSI_CUSTOM_MATH_H
 
-#include <cuda_runtime.h>  // for __host__ __device__ flags
 #include "chrono_fsi/ChConfigFSI.h"
+#ifdef CHRONO_FSI_USE_CPU
+#include "chrono_fsi/ChDeviceCpu.h"  // host emulation of the CUDA types and flags
+#else
+#include <cuda_runtime.h>  // for __host__ __device__ flags
+#endif
 #ifndef __CUDACC__
 #include <cmath>
 #endif
@@ -36,6 +36,8 @@ ChParallelDataManager::ChParallelDataManager()
       num_fluid_contacts(0),
       num_rigid_shapes(0),
       num_rigid_bodies(0),
+      num_removed_shapes(0),
+      num_removed_bodies(0),
       num_fluid_bodies(0),
       num_unilaterals(0),
       num_bilaterals(0),
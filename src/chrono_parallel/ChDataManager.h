@@ -288,6 +288,18 @@ struct host_container {
     custom_vector<real3> ct_body_force;   ///< Total contact force on bodies
     custom_vector<real3> ct_body_torque;  ///< Total contact torque on these bodies
 
+    // Composite material properties (SMC)
+    // These vectors are precomputed at every timestep for all contacts in parallel,
+    // from the material properties of the two bodies in contact. The stiffness and
+    // damping coefficients do not include the factors which depend on the contact
+    // penetration (see ChIterativeSolverParallelSMC).
+    custom_vector<real> smc_mu;        ///< Composite coefficient of friction
+    custom_vector<real> smc_adhesion;  ///< Adhesion force
+    custom_vector<real> smc_kn;        ///< Normal stiffness coefficient
+    custom_vector<real> smc_kt;        ///< Tangential stiffness coefficient
+    custom_vector<real> smc_gn;        ///< Normal damping coefficient
+    custom_vector<real> smc_gt;        ///< Tangential damping coefficient
+
     // Contact shear history (SMC)
     custom_vector<vec3> shear_neigh;  ///< Neighbor list of contacting bodies and shapes
     custom_vector<real3> shear_disp;  ///< Accumulated shear displacement for each neighbor
@@ -438,6 +450,8 @@ class CH_PARALLEL_API ChParallelDataManager {
     uint num_shafts;                   ///< The number of shafts in a system
     uint num_dof;                      ///< The number of degrees of freedom in the system
     uint num_rigid_shapes;             ///< The number of collision models in a system
+    uint num_removed_bodies;           ///< The number of removed rigid bodies, not yet compacted
+    uint num_removed_shapes;           ///< The number of removed collision shapes, not yet compacted
     uint num_rigid_contacts;           ///< The number of contacts between rigid bodies in a system
     uint num_rigid_fluid_contacts;     ///< The number of contacts between rigid and fluid objects
     uint num_fluid_contacts;           ///< The number of contacts between fluid objects
@@ -103,6 +103,7 @@ class solver_settings {
         bilateral_clamp_speed = .6;
         clamp_bilaterals = true;
         compute_N = false;
+        use_shur_blocks = false;
         use_full_inertia_tensor = true;
         max_iteration = 100;
         max_iteration_normal = 0;
@@ -118,6 +119,7 @@ class solver_settings {
         adhesion_force_model = ChSystemSMC::Constant;
         tangential_displ_mode = ChSystemSMC::OneStep;
         use_material_properties = true;
+        use_simd_contact_forces = true;
         characteristic_vel = 1;
         min_slip_vel = 1e-4;
         cache_step_length = false;
@@ -161,6 +163,9 @@ class solver_settings {
     /// Experimental options that probably don't work for all solvers.
     bool update_rhs;
     bool compute_N;
+    /// Calculate the Shur product with dense per-contact blocks of D and M^-1 D, extracted at
+    /// each step (see ChShurProduct). Ignored if compute_N is enabled.
+    bool use_shur_blocks;
     bool test_objective;
     bool use_full_inertia_tensor;
     bool cache_step_length;
@@ -182,6 +187,10 @@ class solver_settings {
     /// physical material properties. Otherwise, the user specifies the coefficients
     /// directly.
     bool use_material_properties;
+    /// Evaluate the SMC contact forces of the Hooke and Hertz models without contact history in
+    /// SIMD batches (only if built with SSE or AVX support). If false, the scalar kernel is used
+    /// for all contacts. Both give the same forces, up to round-off.
+    bool use_simd_contact_forces;
     /// Characteristic velocity (Hooke contact force model).
     real characteristic_vel;
     /// Threshold tangential velocity.
@@ -234,6 +243,9 @@ class settings_container {
         perform_thread_tuning = ((min_threads == max_threads) ? false : true);
         system_type = SystemType::SYSTEM_NSC;
         step_size = .01;
+        lazy_body_update = false;
+        deterministic = false;
+        compaction_threshold = 0.1;
     }
 
     /// The settings for the collision detection.
@@ -260,6 +272,30 @@ class settings_container {
     /// The system type defines if the system is solving the NSC frictional contact
     /// problem or a SMC penalty based.
     SystemType system_type;
+    /// If set to true, the positions and rotations of the rigid bodies are advanced
+    /// directly in the system-wide state arrays at the end of each step. The ChBody
+    /// objects are only updated for the bodies which need it (bodies with assets,
+    /// markers or forces, bodies connected by links, bodies marked with
+    /// ChSystemParallel::SetBodySyncRequired). Call ChSystemParallel::SyncBodies
+    /// before accessing the state of the other bodies. Only used with the parallel
+    /// collision system.
+    /// Forces and torques accumulated with ChBody::Accumulate_force and
+    /// ChBody::Accumulate_torque in the body frame, or with an application point,
+    /// are converted using the ChBody frame at the time of the call, which is
+    /// outdated for a lazy body. Such bodies must be flagged with
+    /// ChSystemParallel::SetBodySyncRequired; this is not detected automatically.
+    bool lazy_body_update;
+    /// If set to true, the results of a step are bitwise reproducible for a given
+    /// input, independently of the number of threads: keys are sorted with stable
+    /// sorts, the potential contacts are ordered by shape pair and the SMC contact
+    /// history is updated in a fixed order. All floating point reductions are done
+    /// in a fixed order in any case. This has a cost (see benchmark_PAR_deterministic).
+    bool deterministic;
+    /// Bodies removed from the system are only marked as removed in the system-wide
+    /// arrays (see ChSystemParallel::RemoveBody). These arrays are compacted at the
+    /// beginning of a step when the fraction of removed bodies (or of removed collision
+    /// shapes) exceeds this threshold, so that the cost of a removal stays bounded.
+    real compaction_threshold;
 };
 
 /// @} parallel_module
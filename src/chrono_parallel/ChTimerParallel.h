@@ -23,6 +23,7 @@
 #include <string>
 
 #include "chrono/core/ChTimer.h"
+#include "chrono/utils/ChProfileRecorder.h"
 
 #include "chrono_parallel/ChParallelDefines.h"
 #include "chrono_parallel/math/ChParallelMath.h"
@@ -33,7 +34,7 @@ namespace chrono {
 /// @{
 
 struct TimerData {
-    TimerData() : runs(0) {}
+    TimerData() : runs(0), zone_open(false) {}
 
     void Reset() {
         runs = 0;
@@ -51,6 +52,7 @@ struct TimerData {
 
     ChTimer<double> timer;
     int runs;
+    bool zone_open;  ///< true if the running timer opened a ChProfileRecorder zone
 };
 
 class CH_PARALLEL_API ChTimerParallel {
@@ -70,9 +72,20 @@ class CH_PARALLEL_API ChTimerParallel {
         }
     }
 
-    void start(std::string name) { timer_list[name].start(); }
+    // Timers are also recorded as zones of the ChProfileRecorder (if enabled).
+    void start(std::string name) {
+        TimerData& timer = timer_list[name];
+        timer.zone_open = utils::ChProfileRecorder::BeginZone(name.c_str());
+        timer.start();
+    }
 
-    void stop(std::string name) { timer_list[name].stop(); }
+    void stop(std::string name) {
+        TimerData& timer = timer_list[name];
+        timer.stop();
+        if (timer.zone_open)
+            utils::ChProfileRecorder::EndZone(name.c_str());
+        timer.zone_open = false;
+    }
 
     // Returns the time associated with a specific timer
     double GetTime(std::string name) {
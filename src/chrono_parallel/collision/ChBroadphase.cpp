@@ -301,7 +301,10 @@ void ChCBroadphase::OneLevelBroadphase() {
                                       bin_aabb_number);
     }
 
-    Thrust_Sort_By_Key(bin_number, bin_aabb_number);
+    if (data_manager->settings.deterministic)
+        Thrust_Stable_Sort_By_Key(bin_number, bin_aabb_number);
+    else
+        Thrust_Sort_By_Key(bin_number, bin_aabb_number);
     number_of_bins_active = (int)(Run_Length_Encode(bin_number, bin_number_out, bin_start_index));
 
     if (number_of_bins_active <= 0) {
@@ -339,6 +342,11 @@ void ChCBroadphase::OneLevelBroadphase() {
 
     contact_pairs.resize(number_of_contacts_possible);
     LOG(TRACE) << "Number of unique collisions: " << number_of_contacts_possible;
+
+    // Order the potential contacts by shape pair, so that the contacts are generated in an order
+    // which does not depend on the bins.
+    if (data_manager->settings.deterministic)
+        Thrust_Sort(contact_pairs);
 }
 
 } // end namespace collision
@@ -27,6 +27,7 @@ namespace collision {
 
 ChCollisionModelParallel::ChCollisionModelParallel() : nObjects(0) {
     model_safe_margin = 0;
+    shape_index = -1;
 }
 
 ChCollisionModelParallel::~ChCollisionModelParallel() {
@@ -201,6 +201,10 @@ class CH_PARALLEL_API ChCollisionModelParallel : public ChCollisionModel {
     std::vector<ConvexModel> mData;
     std::vector<real3> local_convex_data;
 
+    /// Index of the first shape of this model in the system-wide shape arrays
+    /// (-1 if the model is not in the collision system).
+    int shape_index;
+
   protected:
     ChBody* mbody;
     unsigned int nObjects;
@@ -66,7 +66,6 @@ ChCollisionSystemBulletParallel::ChCollisionSystemBulletParallel(ChParallelDataM
     // register custom collision for GIMPACT mesh case too
     btGImpactCollisionAlgorithm::registerAlgorithm(bt_dispatcher);
 
-    counter = 0;
 }
 
 ChCollisionSystemBulletParallel::~ChCollisionSystemBulletParallel() {
@@ -92,10 +91,10 @@ void ChCollisionSystemBulletParallel::Add(ChCollisionModel* model) {
     ChModelBullet* bmodel = static_cast<ChModelBullet*>(model);
     if (bmodel->GetBulletModel()->getCollisionShape()) {
         bmodel->SyncPosition();
-        bmodel->GetBulletModel()->setCompanionId(counter);
+        // The companion ID identifies the body in the system-wide arrays
+        bmodel->GetBulletModel()->setCompanionId(static_cast<ChBody*>(bmodel->GetPhysicsItem())->GetId());
         bt_collision_world->addCollisionObject(bmodel->GetBulletModel(), bmodel->GetFamilyGroup(),
                                                bmodel->GetFamilyMask());
-        counter++;
         data_manager->num_rigid_shapes++;
     }
 }
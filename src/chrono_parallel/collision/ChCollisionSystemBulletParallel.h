@@ -116,8 +116,6 @@ class CH_PARALLEL_API ChCollisionSystemBulletParallel : public ChCollisionSystem
     btCollisionWorld* bt_collision_world;
 
     ChParallelDataManager* data_manager;
-
-    unsigned int counter;
 };
 
 /// @} parallel_colision
@@ -17,6 +17,8 @@
 //
 // =============================================================================
 
+#include <climits>
+
 #include "chrono_parallel/collision/ChCollisionSystemParallel.h"
 #include "chrono_parallel/collision/ChCollision.h"
 
@@ -35,6 +37,8 @@ void ChCollisionSystemParallel::Add(ChCollisionModel* model) {
         // The offset for this shape will the current total number of points in
         // the convex data list
         int convex_data_offset = (int)data_manager->shape_data.convex_rigid.size();
+        // The shapes of this model are stored contiguously, starting at the current number of shapes
+        pmodel->shape_index = pmodel->GetNObjects() > 0 ? (int)data_manager->num_rigid_shapes : -1;
         // Insert the points into the global convex list
         data_manager->shape_data.convex_rigid.insert(data_manager->shape_data.convex_rigid.end(),
                                                      pmodel->local_convex_data.begin(),
@@ -111,94 +115,149 @@ void ChCollisionSystemParallel::Add(ChCollisionModel* model) {
     }
 }
 
-#define ERASE_MACRO(x, y) x.erase(x.begin() + y);
-#define ERASE_MACRO_LEN(x, y, z) x.erase(x.begin() + y, x.begin() + y + z);
+// The shapes of the model are only marked as inactive (ID = UINT_MAX), so that they are
+// ignored by the collision detection. Their data is removed from the system-wide shape
+// arrays the next time these are compacted (see Compact).
+void ChCollisionSystemParallel::Remove(ChCollisionModel* model) {
+    ChCollisionModelParallel* pmodel = static_cast<ChCollisionModelParallel*>(model);
+    if (pmodel->shape_index < 0)
+        return;
+
+    custom_vector<uint>& id_rigid = data_manager->shape_data.id_rigid;
+    uint body_id = pmodel->GetBody()->GetId();
+    for (uint i = pmodel->shape_index; i < data_manager->num_rigid_shapes && id_rigid[i] == body_id; i++) {
+        id_rigid[i] = UINT_MAX;
+        data_manager->num_removed_shapes++;
+    }
+    pmodel->shape_index = -1;
+}
 
+void ChCollisionSystemParallel::Compact(const custom_vector<uint>& body_map, custom_vector<uint>& shape_map) {
+    shape_container& shape_data = data_manager->shape_data;
+    uint num_shapes = data_manager->num_rigid_shapes;
 
-void ChCollisionSystemParallel::Remove(ChCollisionModel* model) {
-#if 0
-	ChCollisionModelParallel* pmodel = static_cast<ChCollisionModelParallel*>(model);
-	int body_id = pmodel->GetBody()->GetId();
-	//loop over the models we nned to remove
-	//std::cout << "removing: " << pmodel->GetNObjects() << " objects" << std::endl;
-	for (int j = 0; j < pmodel->GetNObjects(); j++) {
-		//find a model to remove
-		bool removed = false;
-		for (int i = 0; i < data_manager->shape_data.id_rigid.size(); i++) {
-			if (data_manager->shape_data.id_rigid[i] == body_id) {
-				int index = i;
-				data_manager->num_rigid_shapes--;
-
-				int start = data_manager->shape_data.start_rigid[index];
-				int length = data_manager->shape_data.length_rigid[index];
-				int type = data_manager->shape_data.typ_rigid[index];
-
-				//std::cout << "removing: type " << type << " " << start<< " " <<j << std::endl;
-
-
-				switch (type) {
-				case chrono::collision::SPHERE:
-					ERASE_MACRO_LEN(data_manager->shape_data.sphere_rigid, start, length);
-					break;
-				case chrono::collision::ELLIPSOID:
-					ERASE_MACRO_LEN(data_manager->shape_data.box_like_rigid, start, length);
-					break;
-				case chrono::collision::BOX:
-					ERASE_MACRO_LEN(data_manager->shape_data.box_like_rigid, start, length);
-					break;
-				case chrono::collision::CYLINDER:
-					ERASE_MACRO_LEN(data_manager->shape_data.box_like_rigid, start, length);
-					break;
-				case chrono::collision::CONE:
-					ERASE_MACRO_LEN(data_manager->shape_data.box_like_rigid, start, length);
-					break;
-				case chrono::collision::CAPSULE:
-					ERASE_MACRO_LEN(data_manager->shape_data.capsule_rigid, start, length);
-					break;
-				case chrono::collision::ROUNDEDBOX:
-					ERASE_MACRO_LEN(data_manager->shape_data.rbox_like_rigid, start, length);
-					break;
-				case chrono::collision::ROUNDEDCYL:
-					ERASE_MACRO_LEN(data_manager->shape_data.rbox_like_rigid, start, length);
-					break;
-				case chrono::collision::ROUNDEDCONE:
-					ERASE_MACRO_LEN(data_manager->shape_data.rbox_like_rigid, start, length);
-					break;
-				case chrono::collision::CONVEX:
-					ERASE_MACRO_LEN(data_manager->shape_data.convex_rigid, start, length);
-					break;
-				case chrono::collision::TRIANGLEMESH:
-					ERASE_MACRO_LEN(data_manager->shape_data.convex_rigid, start, 3);
-					break;
-				}
-
-				ERASE_MACRO(data_manager->shape_data.ObA_rigid, index);
-				ERASE_MACRO(data_manager->shape_data.ObR_rigid, index);
-				ERASE_MACRO(data_manager->shape_data.start_rigid, index);
-				ERASE_MACRO(data_manager->shape_data.length_rigid, index);
-
-				ERASE_MACRO(data_manager->shape_data.fam_rigid, index);
-				ERASE_MACRO(data_manager->shape_data.typ_rigid, index);
-				ERASE_MACRO(data_manager->shape_data.id_rigid, index);
-				removed = true;
-				break;
-			}
-		}
-		//std::cout << "decrement start "<< std::endl;
-		if (removed) {
-			//we removed a model, all of the starts are off by one, decrement all starts before removing a second model
-			for (int i = 0; i < data_manager->shape_data.start_rigid.size(); i++) {
-				if (data_manager->shape_data.start_rigid[i] != 0) {
-					data_manager->shape_data.start_rigid[i] -= 1;
-				}
-			}
-		}
-
-	}
-#endif
+    // Calculate the new index of the remaining shapes and the new start of their geometry data
+    // (the data of the shapes of a given type is stored in the order of the shapes).
+    shape_map.resize(num_shapes);
+    custom_vector<int> new_start(num_shapes);
+    uint count = 0;
+    int num_sphere = 0, num_box_like = 0, num_capsule = 0, num_rbox_like = 0, num_triangle = 0, num_convex = 0;
+
+    for (uint i = 0; i < num_shapes; i++) {
+        uint id = shape_data.id_rigid[i];
+        if (id == UINT_MAX || body_map[id] == UINT_MAX) {
+            shape_map[i] = UINT_MAX;
+            continue;
+        }
+        shape_map[i] = count++;
+
+        switch (shape_data.typ_rigid[i]) {
+            case chrono::collision::SPHERE:
+                new_start[i] = num_sphere++;
+                break;
+            case chrono::collision::ELLIPSOID:
+            case chrono::collision::BOX:
+            case chrono::collision::CYLINDER:
+            case chrono::collision::CONE:
+                new_start[i] = num_box_like++;
+                break;
+            case chrono::collision::CAPSULE:
+                new_start[i] = num_capsule++;
+                break;
+            case chrono::collision::ROUNDEDBOX:
+            case chrono::collision::ROUNDEDCYL:
+            case chrono::collision::ROUNDEDCONE:
+                new_start[i] = num_rbox_like++;
+                break;
+            case chrono::collision::CONVEX:
+                new_start[i] = num_convex;
+                num_convex += shape_data.length_rigid[i];
+                break;
+            case chrono::collision::TRIANGLEMESH:
+                new_start[i] = num_triangle;
+                num_triangle += 3;
+                break;
+        }
+    }
+
+    shape_container compacted;
+    compacted.fam_rigid.resize(count);
+    compacted.id_rigid.resize(count);
+    compacted.typ_rigid.resize(count);
+    compacted.start_rigid.resize(count);
+    compacted.length_rigid.resize(count);
+    compacted.ObR_rigid.resize(count);
+    compacted.ObA_rigid.resize(count);
+    compacted.sphere_rigid.resize(num_sphere);
+    compacted.box_like_rigid.resize(num_box_like);
+    compacted.capsule_rigid.resize(num_capsule);
+    compacted.rbox_like_rigid.resize(num_rbox_like);
+    compacted.triangle_rigid.resize(num_triangle);
+    compacted.convex_rigid.resize(num_convex);
+
+#pragma omp parallel for
+    for (int i = 0; i < (signed)num_shapes; i++) {
+        uint index = shape_map[i];
+        if (index == UINT_MAX)
+            continue;
+
+        int start = shape_data.start_rigid[i];
+        int length = shape_data.length_rigid[i];
+
+        switch (shape_data.typ_rigid[i]) {
+            case chrono::collision::SPHERE:
+                compacted.sphere_rigid[new_start[i]] = shape_data.sphere_rigid[start];
+                break;
+            case chrono::collision::ELLIPSOID:
+            case chrono::collision::BOX:
+            case chrono::collision::CYLINDER:
+            case chrono::collision::CONE:
+                compacted.box_like_rigid[new_start[i]] = shape_data.box_like_rigid[start];
+                break;
+            case chrono::collision::CAPSULE:
+                compacted.capsule_rigid[new_start[i]] = shape_data.capsule_rigid[start];
+                break;
+            case chrono::collision::ROUNDEDBOX:
+            case chrono::collision::ROUNDEDCYL:
+            case chrono::collision::ROUNDEDCONE:
+                compacted.rbox_like_rigid[new_start[i]] = shape_data.rbox_like_rigid[start];
+                break;
+            case chrono::collision::CONVEX:
+                for (int j = 0; j < length; j++)
+                    compacted.convex_rigid[new_start[i] + j] = shape_data.convex_rigid[start + j];
+                break;
+            case chrono::collision::TRIANGLEMESH:
+                for (int j = 0; j < 3; j++)
+                    compacted.triangle_rigid[new_start[i] + j] = shape_data.triangle_rigid[start + j];
+                break;
+        }
+
+        compacted.fam_rigid[index] = shape_data.fam_rigid[i];
+        compacted.id_rigid[index] = body_map[shape_data.id_rigid[i]];
+        compacted.typ_rigid[index] = shape_data.typ_rigid[i];
+        compacted.start_rigid[index] = new_start[i];
+        compacted.length_rigid[index] = length;
+        compacted.ObR_rigid[index] = shape_data.ObR_rigid[i];
+        compacted.ObA_rigid[index] = shape_data.ObA_rigid[i];
+    }
+
+    shape_data.fam_rigid.swap(compacted.fam_rigid);
+    shape_data.id_rigid.swap(compacted.id_rigid);
+    shape_data.typ_rigid.swap(compacted.typ_rigid);
+    shape_data.start_rigid.swap(compacted.start_rigid);
+    shape_data.length_rigid.swap(compacted.length_rigid);
+    shape_data.ObR_rigid.swap(compacted.ObR_rigid);
+    shape_data.ObA_rigid.swap(compacted.ObA_rigid);
+    shape_data.sphere_rigid.swap(compacted.sphere_rigid);
+    shape_data.box_like_rigid.swap(compacted.box_like_rigid);
+    shape_data.capsule_rigid.swap(compacted.capsule_rigid);
+    shape_data.rbox_like_rigid.swap(compacted.rbox_like_rigid);
+    shape_data.triangle_rigid.swap(compacted.triangle_rigid);
+    shape_data.convex_rigid.swap(compacted.convex_rigid);
+
+    data_manager->num_rigid_shapes = count;
+    data_manager->num_removed_shapes = 0;
 }
-#undef ERASE_MACRO
-#undef ERASE_MACRO_LEN
 
 void ChCollisionSystemParallel::Run() {
     LOG(INFO) << "ChCollisionSystemParallel::Run()";
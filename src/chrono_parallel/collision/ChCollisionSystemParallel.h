@@ -55,8 +55,14 @@ class CH_PARALLEL_API ChCollisionSystemParallel : public ChCollisionSystem {
 
     /// Removes a collision model from the collision
     /// engine (custom data may be deallocated).
+    /// The shapes of the model are only marked as inactive until the next call to Compact().
     virtual void Remove(ChCollisionModel* model);
 
+    /// Remove the data of the inactive shapes from the system-wide shape arrays and renumber the
+    /// bodies of the remaining shapes. The new index of each body is given in body_map (UINT_MAX for
+    /// removed bodies). On return, shape_map holds the new index of each shape (UINT_MAX for removed shapes).
+    void Compact(const custom_vector<uint>& body_map, custom_vector<uint>& shape_map);
+
     /// Removes all collision models from the collision
     /// engine (custom data may be deallocated).
     // virtual void RemoveAll();
@@ -422,7 +422,10 @@ void ChCNarrowphaseDispatch::SphereSphereContact(const int num_fluid_bodies,
         particle_indices[i] = i;
     }
 
-    Thrust_Sort_By_Key(ff_bin_ids, particle_indices);
+    if (data_manager->settings.deterministic)
+        Thrust_Stable_Sort_By_Key(ff_bin_ids, particle_indices);
+    else
+        Thrust_Sort_By_Key(ff_bin_ids, particle_indices);
 
 #pragma omp parallel for
     for (int i = 0; i < num_fluid_bodies; i++) {
@@ -617,7 +620,10 @@ void ChCNarrowphaseDispatch::RigidSphereContact(const real sphere_radius,
         }
     }
     LOG(TRACE) << "ChCNarrowphaseDispatch::DispatchRigidSphere Hash";
-    Thrust_Sort_By_Key(f_bin_number, f_bin_fluid_number);
+    if (data_manager->settings.deterministic)
+        Thrust_Stable_Sort_By_Key(f_bin_number, f_bin_fluid_number);
+    else
+        Thrust_Sort_By_Key(f_bin_number, f_bin_fluid_number);
     f_number_of_bins_active = (int)(Run_Length_Encode(f_bin_number, f_bin_number_out, f_bin_start_index));
 
     f_bin_start_index.resize(f_number_of_bins_active + 1);
@@ -758,7 +764,10 @@ void ChCNarrowphaseDispatch::RigidTetContact(custom_vector<real3>& norm_rigid_te
             }
         }
     }
-    Thrust_Sort_By_Key(t_bin_number, t_bin_fluid_number);
+    if (data_manager->settings.deterministic)
+        Thrust_Stable_Sort_By_Key(t_bin_number, t_bin_fluid_number);
+    else
+        Thrust_Sort_By_Key(t_bin_number, t_bin_fluid_number);
     uint t_number_of_bins_active = (int)(Run_Length_Encode(t_bin_number, t_bin_number_out, t_bin_start_index));
 
     t_bin_start_index.resize(t_number_of_bins_active + 1);
@@ -906,7 +915,10 @@ void ChCNarrowphaseDispatch::MarkerTetContact(const real sphere_radius,
             }
         }
     }
-    Thrust_Sort_By_Key(t_bin_number, t_bin_fluid_number);
+    if (data_manager->settings.deterministic)
+        Thrust_Stable_Sort_By_Key(t_bin_number, t_bin_fluid_number);
+    else
+        Thrust_Sort_By_Key(t_bin_number, t_bin_fluid_number);
     uint t_number_of_bins_active = (int)(Run_Length_Encode(t_bin_number, t_bin_number_out, t_bin_start_index));
 
     t_bin_start_index.resize(t_number_of_bins_active + 1);
@@ -18,9 +18,10 @@
 #pragma once
 
 #include "chrono_parallel/ChCudaDefines.h"
+#include "chrono_parallel/math/vector_types.h"
+#include <cmath>
 #include <iostream>
 
-//#include "chrono_parallel/math/float.h"
 namespace chrono {
 
 #if !defined(_WIN32)
@@ -0,0 +1,60 @@
+// =============================================================================
+// PROJECT CHRONO - http://projectchrono.org
+//
+// Copyright (c) 2016 projectchrono.org
+// All rights reserved.
+//
+// Use of this source code is governed by a BSD-style license that can be found
+// in the LICENSE file at the top level of the distribution and at
+// http://projectchrono.org/license-chrono.txt.
+//
+// =============================================================================
+//
+// Description: host definitions of the CUDA vector types used by the single
+// precision math (matrixf.cuh, svd.h) when not compiled with nvcc, so that the
+// same functions can be used by the CPU implementation of the MPM solver.
+// =============================================================================
+
+#pragma once
+
+#if defined(__CUDACC__) || defined(__VECTOR_TYPES_H__)
+#include <vector_types.h>
+#include <vector_functions.h>
+#else
+
+struct float2 {
+    float x, y;
+};
+
+struct float3 {
+    float x, y, z;
+};
+
+struct int3 {
+    int x, y, z;
+};
+
+static inline float2 make_float2(float x, float y) {
+    float2 t;
+    t.x = x;
+    t.y = y;
+    return t;
+}
+
+static inline float3 make_float3(float x, float y, float z) {
+    float3 t;
+    t.x = x;
+    t.y = y;
+    t.z = z;
+    return t;
+}
+
+static inline int3 make_int3(int x, int y, int z) {
+    int3 t;
+    t.x = x;
+    t.y = y;
+    t.z = z;
+    return t;
+}
+
+#endif
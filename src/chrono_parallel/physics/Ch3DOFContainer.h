@@ -195,6 +195,7 @@ class CH_PARALLEL_API ChFluidContainer : public Ch3DOFContainer {
     real alpha_flip;
 
     int mpm_iterations;
+    bool mpm_verbose;  // print the MPM grid and solver statistics
     std::thread mpm_thread;
     bool mpm_init;
     MPM_Settings temp_settings;
@@ -310,6 +311,7 @@ class CH_PARALLEL_API ChParticleContainer : public Ch3DOFContainer {
     real alpha_flip;
 
     int mpm_iterations;
+    bool mpm_verbose;  // print the MPM grid and solver statistics
     custom_vector<float> mpm_pos, mpm_vel, mpm_jejp;
 
     std::thread mpm_thread;
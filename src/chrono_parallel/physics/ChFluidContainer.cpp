@@ -52,6 +52,7 @@ ChFluidContainer::ChFluidContainer() {
     artificial_pressure_n = 4;
     enable_viscosity = false;
     mpm_iterations = 0;
+    mpm_verbose = false;
     nu = .2;
     youngs_modulus = 1.4e5;
     hardening_coefficient = 10;
@@ -81,7 +82,6 @@ void ChFluidContainer::Update(double ChTime) {
     custom_vector<real3>& vel_fluid = data_manager->host_data.vel_3dof;
     real3 g_acc = data_manager->settings.gravity;
     real3 h_gravity = data_manager->settings.step_size * mass * g_acc;
-#ifdef CHRONO_PARALLEL_USE_CUDA
     if (mpm_init) {
         temp_settings.dt = (float)data_manager->settings.step_size;
         temp_settings.kernel_radius = (float)kernel_radius;
@@ -101,6 +101,7 @@ void ChFluidContainer::Update(double ChTime) {
         temp_settings.mass = (float)mass;
         temp_settings.yield_stress = (float)yield_stress;
         temp_settings.num_iterations = mpm_iterations;
+        temp_settings.verbose = mpm_verbose;
         if (mpm_iterations > 0) {
             mpm_pos.resize(data_manager->num_fluid_bodies * 3);
             mpm_vel.resize(data_manager->num_fluid_bodies * 3);
@@ -129,7 +130,6 @@ void ChFluidContainer::Update(double ChTime) {
             }
         }
     }
-#endif
 #pragma omp parallel for
     for (int i = 0; i < (signed)num_fluid_bodies; i++) {
         // This was moved to after fluid collision detection
@@ -293,7 +293,6 @@ void ChFluidContainer::Setup(int start_constraint) {
 }
 
 void ChFluidContainer::Initialize() {
-#ifdef CHRONO_PARALLEL_USE_CUDA
     temp_settings.dt = (float)data_manager->settings.step_size;
     temp_settings.kernel_radius = (float)kernel_radius;
     temp_settings.inv_radius = float(1.0 / kernel_radius);
@@ -312,6 +311,7 @@ void ChFluidContainer::Initialize() {
     temp_settings.mass = (float)mass;
     temp_settings.yield_stress = (float)yield_stress;
     temp_settings.num_iterations = mpm_iterations;
+    temp_settings.verbose = mpm_verbose;
     if (mpm_iterations > 0) {
         mpm_pos.resize(data_manager->num_fluid_bodies * 3);
 
@@ -324,7 +324,6 @@ void ChFluidContainer::Initialize() {
         MPM_Initialize(temp_settings, mpm_pos);
     }
     mpm_init = true;
-#endif
 }
 void ChFluidContainer::Density_FluidMPM() {
     custom_vector<real3>& sorted_pos = data_manager->host_data.sorted_pos_3dof;
@@ -651,7 +650,6 @@ void ChFluidContainer::GenerateSparsity() {
 }
 
 void ChFluidContainer::PreSolve() {
-#ifdef CHRONO_PARALLEL_USE_CUDA
     if (mpm_thread.joinable()) {
         mpm_thread.join();
 #pragma omp parallel for
@@ -662,7 +660,6 @@ void ChFluidContainer::PreSolve() {
             data_manager->host_data.v[body_offset + index * 3 + 2] = mpm_vel[p * 3 + 2];
         }
     }
-#endif
 
     if (gamma_old.size() > 0) {
         if (enable_viscosity) {
@@ -0,0 +1,776 @@
+// =============================================================================
+// PROJECT CHRONO - http://projectchrono.org
+//
+// Copyright (c) 2016 projectchrono.org
+// All rights reserved.
+//
+// Use of this source code is governed by a BSD-style license that can be found
+// in the LICENSE file at the top level of the distribution and at
+// http://projectchrono.org/license-chrono.txt.
+//
+// =============================================================================
+//
+// Description: multicore CPU implementation of the MPM solver (see ChMPM.cu),
+// used when Chrono::Parallel is built without CUDA.
+//
+// The grid is sparse: nodes are allocated in blocks of 4x4x4, only for the
+// blocks covered by the interpolation stencils of the markers. Markers are
+// sorted by the block containing their grid cell. The stencil of a marker
+// (5x5x5 nodes) only overlaps the neighboring blocks, so blocks of the same
+// color (parity of the block coordinates) can scatter to the grid in parallel
+// without atomics. Together with fixed-size partial sums in the reductions of
+// the solver, the results are independent of the number of threads.
+// =============================================================================
+
+#include <algorithm>
+#include <cstdio>
+#include <vector>
+
+#include "chrono/core/ChTimer.h"
+#include "chrono_parallel/physics/ChMPM.cuh"
+#include "chrono_parallel/physics/MPMUtils.h"
+
+//#define BOX_YIELD
+#define SPHERE_YIELD
+
+#define MPM_BLOCK_SHIFT 2
+#define MPM_BLOCK_EDGE (1 << MPM_BLOCK_SHIFT)
+#define MPM_BLOCK_NODES (MPM_BLOCK_EDGE * MPM_BLOCK_EDGE * MPM_BLOCK_EDGE)
+
+#define a_min 1e-13
+#define a_max 1e13
+#define neg_BB1_fallback 0.11
+#define neg_BB2_fallback 0.12
+
+namespace chrono {
+
+static MPM_Settings host_settings;
+
+static float3 min_bounding_point;
+static float3 max_bounding_point;
+
+// Sparse grid
+static int blocks_per_axis_x, blocks_per_axis_y, blocks_per_axis_z;
+static std::vector<int> block_index;      // active block index for each block of the bounding box (-1 if inactive)
+static int num_active_blocks;
+static std::vector<int> marker_start;     // range of sorted markers in each active block
+static std::vector<int> sorted_markers;   // marker indices, sorted by block
+static std::vector<int> color_start;      // range of colored blocks for each of the 8 colors
+static std::vector<int> colored_blocks;   // active blocks, sorted by color
+
+// Marker data (matrices are stored component-wise: entry k of marker p at [p + k * num_mpm_markers])
+static std::vector<float> pos, vel, JE_JP;
+static std::vector<float> marker_volume;
+static std::vector<float> marker_Fe, marker_Fe_hat, marker_Fp;
+static std::vector<float> PolarS, PolarR;
+static std::vector<float> marker_plasticity;
+
+// Node data
+static std::vector<float> node_mass;
+static std::vector<float> grid_vel, delta_v;
+static std::vector<float> rhs;
+static std::vector<float> old_vel_node_mpm;
+static std::vector<float> ml, mg, mg_p, ml_p;
+
+// Interpolation stencil of a marker: 5 nodes along each axis, with the weights
+// and weight derivatives of each of them, and their location in the sparse grid.
+struct MPM_Stencil {
+    float w[3][5];
+    float dw[3][5];
+    int block[3][5];  // block offset (0 or 1) from the first block of the stencil
+    int local[3][5];  // node offset within a block
+    int base[8];      // first node of each of the (up to) 2x2x2 blocks covered by the stencil
+
+    int Node(int a, int b, int c) const {
+        return base[block[0][a] + 2 * block[1][b] + 4 * block[2][c]] + local[0][a] + local[1][b] + local[2][c];
+    }
+};
+
+static inline int BlockHash(int bx, int by, int bz) {
+    return GridHash(bx, by, bz, blocks_per_axis_x, blocks_per_axis_y, blocks_per_axis_z);
+}
+
+static inline void CellCoords(const float* xi, int* cell) {
+    cell[0] = GridCoord(xi[0], host_settings.inv_bin_edge, min_bounding_point.x);
+    cell[1] = GridCoord(xi[1], host_settings.inv_bin_edge, min_bounding_point.y);
+    cell[2] = GridCoord(xi[2], host_settings.inv_bin_edge, min_bounding_point.z);
+}
+
+// Same node locations and weights as LOOP_TWO_RING_GPUSP in ChMPM.cu
+static inline void ComputeStencil(const float* xi, MPM_Stencil& s) {
+    const float bin_edge = host_settings.bin_edge;
+    const float inv_bin_edge = host_settings.inv_bin_edge;
+    const float minimum[3] = {min_bounding_point.x, min_bounding_point.y, min_bounding_point.z};
+
+    int cell[3];
+    CellCoords(xi, cell);
+
+    int first_block[3];
+    for (int d = 0; d < 3; d++) {
+        first_block[d] = (cell[d] - 2) >> MPM_BLOCK_SHIFT;
+        for (int a = 0; a < 5; a++) {
+            int i = cell[d] - 2 + a;
+            float current_node_location = i * bin_edge + minimum[d];
+            float T = (xi[d] - current_node_location) * inv_bin_edge;
+            s.w[d][a] = N(T);
+            s.dw[d][a] = dN(T);
+            s.block[d][a] = (i >> MPM_BLOCK_SHIFT) - first_block[d];
+            s.local[d][a] = (i & (MPM_BLOCK_EDGE - 1)) << (MPM_BLOCK_SHIFT * d);
+        }
+    }
+
+    for (int k = 0; k < 8; k++) {
+        int bx = first_block[0] + (k & 1);
+        int by = first_block[1] + ((k >> 1) & 1);
+        int bz = first_block[2] + (k >> 2);
+        bool valid = bx < blocks_per_axis_x && by < blocks_per_axis_y && bz < blocks_per_axis_z;
+        s.base[k] = valid ? block_index[BlockHash(bx, by, bz)] * MPM_BLOCK_NODES : -1;
+    }
+}
+
+// Weight gradient of node (a,b,c), in the same order of operations as ChMPM.cu
+#define STENCIL_GRADIENT(s, a, b, c, inv_bin_edge)                               \
+    float valx = s.dw[0][a] * inv_bin_edge * s.w[1][b] * s.w[2][c];              \
+    float valy = s.w[0][a] * s.dw[1][b] * inv_bin_edge * s.w[2][c];              \
+    float valz = s.w[0][a] * s.w[1][b] * s.dw[2][c] * inv_bin_edge;
+
+#define LOOP_STENCIL(X)                                   \
+    for (int a = 0; a < 5; a++) {                         \
+        for (int b = 0; b < 5; b++) {                     \
+            for (int c = 0; c < 5; c++) {                 \
+                const int current_node = s.Node(a, b, c); \
+                X                                         \
+            }                                             \
+        }                                                 \
+    }
+
+// Execute a marker kernel which scatters to the grid. Blocks of the same color
+// do not share nodes and are processed in parallel.
+template <typename Kernel>
+static void ScatterMarkers(Kernel kernel) {
+    for (int color = 0; color < 8; color++) {
+#pragma omp parallel for schedule(dynamic, 1)
+        for (int i = color_start[color]; i < color_start[color + 1]; i++) {
+            int block = colored_blocks[i];
+            for (int k = marker_start[block]; k < marker_start[block + 1]; k++) {
+                kernel(sorted_markers[k]);
+            }
+        }
+    }
+}
+
+// Execute a marker kernel which only reads from the grid.
+template <typename Kernel>
+static void GatherMarkers(Kernel kernel) {
+    const int num_markers = host_settings.num_mpm_markers;
+#pragma omp parallel for
+    for (int p = 0; p < num_markers; p++) {
+        kernel(p);
+    }
+}
+
+// Sum of the values of a kernel over [0, size). The partial sums are computed over
+// fixed ranges, so that the result does not depend on the number of threads.
+template <int N, typename Kernel>
+static void Reduce(int size, Kernel kernel, float* sum) {
+    const int chunk = 4096;
+    const int num_chunks = (size + chunk - 1) / chunk;
+    std::vector<float> partial(num_chunks * N, 0.0f);
+#pragma omp parallel for
+    for (int c = 0; c < num_chunks; c++) {
+        const int end = std::min(size, (c + 1) * chunk);
+        for (int i = c * chunk; i < end; i++) {
+            kernel(i, &partial[c * N]);
+        }
+    }
+    for (int k = 0; k < N; k++) {
+        sum[k] = 0;
+        for (int c = 0; c < num_chunks; c++) {
+            sum[k] += partial[c * N + k];
+        }
+    }
+}
+
+//////========================================================================================================================================================================
+
+// Compute the bounding box of the markers, the active blocks of the sparse grid, and the marker ordering.
+static void MPM_ComputeBounds() {
+    const int num_markers = host_settings.num_mpm_markers;
+
+    max_bounding_point = make_float3(-FLT_MAX, -FLT_MAX, -FLT_MAX);
+    min_bounding_point = make_float3(FLT_MAX, FLT_MAX, FLT_MAX);
+    for (int p = 0; p < num_markers; p++) {
+        min_bounding_point.x = std::min(min_bounding_point.x, pos[p * 3 + 0]);
+        min_bounding_point.y = std::min(min_bounding_point.y, pos[p * 3 + 1]);
+        min_bounding_point.z = std::min(min_bounding_point.z, pos[p * 3 + 2]);
+        max_bounding_point.x = std::max(max_bounding_point.x, pos[p * 3 + 0]);
+        max_bounding_point.y = std::max(max_bounding_point.y, pos[p * 3 + 1]);
+        max_bounding_point.z = std::max(max_bounding_point.z, pos[p * 3 + 2]);
+    }
+
+    min_bounding_point.x = host_settings.kernel_radius * roundf(min_bounding_point.x / host_settings.kernel_radius);
+    min_bounding_point.y = host_settings.kernel_radius * roundf(min_bounding_point.y / host_settings.kernel_radius);
+    min_bounding_point.z = host_settings.kernel_radius * roundf(min_bounding_point.z / host_settings.kernel_radius);
+
+    max_bounding_point.x = host_settings.kernel_radius * roundf(max_bounding_point.x / host_settings.kernel_radius);
+    max_bounding_point.y = host_settings.kernel_radius * roundf(max_bounding_point.y / host_settings.kernel_radius);
+    max_bounding_point.z = host_settings.kernel_radius * roundf(max_bounding_point.z / host_settings.kernel_radius);
+
+    max_bounding_point = max_bounding_point + host_settings.kernel_radius * 8;
+    min_bounding_point = min_bounding_point - host_settings.kernel_radius * 6;
+
+    host_settings.bin_edge = host_settings.kernel_radius * 2;
+    host_settings.inv_bin_edge = float(1.) / host_settings.bin_edge;
+
+    host_settings.bins_per_axis_x = (int)ceilf((max_bounding_point.x - min_bounding_point.x) * host_settings.inv_bin_edge);
+    host_settings.bins_per_axis_y = (int)ceilf((max_bounding_point.y - min_bounding_point.y) * host_settings.inv_bin_edge);
+    host_settings.bins_per_axis_z = (int)ceilf((max_bounding_point.z - min_bounding_point.z) * host_settings.inv_bin_edge);
+
+    blocks_per_axis_x = (host_settings.bins_per_axis_x >> MPM_BLOCK_SHIFT) + 2;
+    blocks_per_axis_y = (host_settings.bins_per_axis_y >> MPM_BLOCK_SHIFT) + 2;
+    blocks_per_axis_z = (host_settings.bins_per_axis_z >> MPM_BLOCK_SHIFT) + 2;
+
+    // Activate the blocks covered by the stencil of each marker and count the markers in each block
+    block_index.assign(blocks_per_axis_x * blocks_per_axis_y * blocks_per_axis_z, -1);
+    std::vector<int> marker_block(num_markers);
+    std::vector<int> active_blocks;
+    for (int p = 0; p < num_markers; p++) {
+        int cell[3];
+        CellCoords(&pos[p * 3], cell);
+        for (int bx = (cell[0] - 2) >> MPM_BLOCK_SHIFT; bx <= (cell[0] + 2) >> MPM_BLOCK_SHIFT; bx++) {
+            for (int by = (cell[1] - 2) >> MPM_BLOCK_SHIFT; by <= (cell[1] + 2) >> MPM_BLOCK_SHIFT; by++) {
+                for (int bz = (cell[2] - 2) >> MPM_BLOCK_SHIFT; bz <= (cell[2] + 2) >> MPM_BLOCK_SHIFT; bz++) {
+                    int hash = BlockHash(bx, by, bz);
+                    if (block_index[hash] < 0) {
+                        block_index[hash] = (int)active_blocks.size();
+                        active_blocks.push_back(hash);
+                    }
+                }
+            }
+        }
+        marker_block[p] = block_index[BlockHash(cell[0] >> MPM_BLOCK_SHIFT, cell[1] >> MPM_BLOCK_SHIFT,
+                                                cell[2] >> MPM_BLOCK_SHIFT)];
+    }
+    num_active_blocks = (int)active_blocks.size();
+
+    // Sort the markers by block (counting sort, stable)
+    marker_start.assign(num_active_blocks + 1, 0);
+    for (int p = 0; p < num_markers; p++) {
+        marker_start[marker_block[p] + 1]++;
+    }
+    for (int b = 0; b < num_active_blocks; b++) {
+        marker_start[b + 1] += marker_start[b];
+    }
+    sorted_markers.resize(num_markers);
+    std::vector<int> offset(marker_start.begin(), marker_start.end() - 1);
+    for (int p = 0; p < num_markers; p++) {
+        sorted_markers[offset[marker_block[p]]++] = p;
+    }
+
+    // Color the blocks which contain markers
+    std::vector<int> block_color(num_active_blocks);
+    color_start.assign(9, 0);
+    for (int b = 0; b < num_active_blocks; b++) {
+        if (marker_start[b + 1] == marker_start[b])
+            continue;
+        int hash = active_blocks[b];
+        int bx = hash % blocks_per_axis_x;
+        int by = (hash / blocks_per_axis_x) % blocks_per_axis_y;
+        int bz = hash / (blocks_per_axis_x * blocks_per_axis_y);
+        block_color[b] = (bx & 1) + 2 * (by & 1) + 4 * (bz & 1);
+        color_start[block_color[b] + 1]++;
+    }
+    for (int c = 0; c < 8; c++) {
+        color_start[c + 1] += color_start[c];
+    }
+    colored_blocks.resize(color_start[8]);
+    offset.assign(color_start.begin(), color_start.end() - 1);
+    for (int b = 0; b < num_active_blocks; b++) {
+        if (marker_start[b + 1] > marker_start[b])
+            colored_blocks[offset[block_color[b]]++] = b;
+    }
+
+    host_settings.num_mpm_nodes = num_active_blocks * MPM_BLOCK_NODES;
+
+    if (host_settings.verbose) {
+        printf("max_bounding_point [%f %f %f]\n", max_bounding_point.x, max_bounding_point.y, max_bounding_point.z);
+        printf("min_bounding_point [%f %f %f]\n", min_bounding_point.x, min_bounding_point.y, min_bounding_point.z);
+        printf("Compute DOF [%d %d %d] [%f] %d %d (%d blocks)\n", host_settings.bins_per_axis_x,
+               host_settings.bins_per_axis_y, host_settings.bins_per_axis_z, host_settings.bin_edge,
+               host_settings.num_mpm_nodes, host_settings.num_mpm_markers, num_active_blocks);
+    }
+}
+
+//////========================================================================================================================================================================
+
+static void MPM_Rasterize(bool with_velocity) {
+    const float mass = host_settings.mass;
+    ScatterMarkers([&](int p) {
+        MPM_Stencil s;
+        ComputeStencil(&pos[p * 3], s);
+        const float vix = vel.empty() ? 0 : vel[p * 3 + 0];
+        const float viy = vel.empty() ? 0 : vel[p * 3 + 1];
+        const float viz = vel.empty() ? 0 : vel[p * 3 + 2];
+
+        LOOP_STENCIL(                                                   //
+            float weight = s.w[0][a] * s.w[1][b] * s.w[2][c] * mass;    //
+            node_mass[current_node] += weight;                          //
+            if (with_velocity) {                                        //
+                grid_vel[current_node * 3 + 0] += weight * vix;         //
+                grid_vel[current_node * 3 + 1] += weight * viy;         //
+                grid_vel[current_node * 3 + 2] += weight * viz;         //
+            })
+    });
+}
+
+static void MPM_NormalizeWeights() {
+    const int num_nodes = host_settings.num_mpm_nodes;
+#pragma omp parallel for
+    for (int i = 0; i < num_nodes; i++) {
+        float n_mass = node_mass[i];
+        if (n_mass > FLT_EPSILON) {
+            grid_vel[i * 3 + 0] /= n_mass;
+            grid_vel[i * 3 + 1] /= n_mass;
+            grid_vel[i * 3 + 2] /= n_mass;
+        }
+    }
+}
+
+static void MPM_ComputeParticleVolumes() {
+    const float bin_edge = host_settings.bin_edge;
+    GatherMarkers([&](int p) {
+        MPM_Stencil s;
+        ComputeStencil(&pos[p * 3], s);
+        float particle_density = 0;
+        LOOP_STENCIL(                                           //
+            float weight = s.w[0][a] * s.w[1][b] * s.w[2][c];   //
+            particle_density += node_mass[current_node] * weight;)
+        // Inverse density to remove division
+        particle_density = (bin_edge * bin_edge * bin_edge) / particle_density;
+        marker_volume[p] = host_settings.mass * particle_density;
+    });
+}
+
+static void MPM_FeHat() {
+    const int n = host_settings.num_mpm_markers;
+    const float inv_bin_edge = host_settings.inv_bin_edge;
+    GatherMarkers([&](int p) {
+        MPM_Stencil s;
+        ComputeStencil(&pos[p * 3], s);
+        Mat33f Fe_hat_t(0.0);
+        LOOP_STENCIL(                                          //
+            float vnx = grid_vel[current_node * 3 + 0];        //
+            float vny = grid_vel[current_node * 3 + 1];        //
+            float vnz = grid_vel[current_node * 3 + 2];        //
+            STENCIL_GRADIENT(s, a, b, c, inv_bin_edge)         //
+            Fe_hat_t[0] += vnx * valx; Fe_hat_t[1] += vny * valx; Fe_hat_t[2] += vnz * valx;  //
+            Fe_hat_t[3] += vnx * valy; Fe_hat_t[4] += vny * valy; Fe_hat_t[5] += vnz * valy;  //
+            Fe_hat_t[6] += vnx * valz; Fe_hat_t[7] += vny * valz; Fe_hat_t[8] += vnz * valz;)
+        Mat33f m_Fe(marker_Fe.data(), p, n);
+        Mat33f m_Fe_hat = (Mat33f(1.0) + host_settings.dt * Fe_hat_t) * m_Fe;
+        m_Fe_hat.Store(marker_Fe_hat.data(), p, n);
+    });
+}
+
+static void MPM_ApplyForces() {
+    const int n = host_settings.num_mpm_markers;
+    const float inv_bin_edge = host_settings.inv_bin_edge;
+    ScatterMarkers([&](int p) {
+        const Mat33f FE(marker_Fe.data(), p, n);
+        const Mat33f FE_hat(marker_Fe_hat.data(), p, n);
+
+        const float a = -one_third;
+        const float J = Determinant(FE_hat);
+        const float Ja = powf(J, a);
+
+#if defined(BOX_YIELD) || defined(SPHERE_YIELD)
+        const float current_mu = host_settings.mu * expf(host_settings.hardening_coefficient * (marker_plasticity[p]));
+#else
+        const float current_mu = host_settings.mu;
+#endif
+
+        Mat33f JaFE = Ja * FE;
+        Mat33f UE, VE;
+        float3 EE;
+        SVD(JaFE, UE, EE, VE); /* Perform a polar decomposition, FE=RE*SE, RE is the Unitary part*/
+        Mat33f RE = MultTranspose(UE, VE);
+        Mat33f SE = VE * MultTranspose(EE, VE);
+        RE.Store(PolarR.data(), p, n);
+
+        PolarS[p + 0 * n] = SE[0];
+        PolarS[p + 1 * n] = SE[1];
+        PolarS[p + 2 * n] = SE[2];
+        PolarS[p + 3 * n] = SE[4];
+        PolarS[p + 4 * n] = SE[5];
+        PolarS[p + 5 * n] = SE[8];
+
+        const Mat33f H = AdjointTranspose(FE_hat) * (1.0f / J);
+        const Mat33f A = 2.f * current_mu * (JaFE - RE);
+        const Mat33f Z_B = Z__B(A, FE_hat, Ja, a, H);
+        const Mat33f vPEDFepT = host_settings.dt * marker_volume[p] * MultTranspose(Z_B, FE);
+
+        MPM_Stencil s;
+        ComputeStencil(&pos[p * 3], s);
+        LOOP_STENCIL(                                                                  //
+            STENCIL_GRADIENT(s, a, b, c, inv_bin_edge)                                 //
+            float fx = vPEDFepT[0] * valx + vPEDFepT[3] * valy + vPEDFepT[6] * valz;   //
+            float fy = vPEDFepT[1] * valx + vPEDFepT[4] * valy + vPEDFepT[7] * valz;   //
+            float fz = vPEDFepT[2] * valx + vPEDFepT[5] * valy + vPEDFepT[8] * valz;   //
+            float mass = node_mass[current_node];                                      //
+            if (mass > 0) {                                                            //
+                grid_vel[current_node * 3 + 0] += -fx / mass;                          //
+                grid_vel[current_node * 3 + 1] += -fy / mass;                          //
+                grid_vel[current_node * 3 + 2] += -fz / mass;                          //
+            })
+    });
+}
+
+static void MPM_Rhs() {
+    const int num_nodes = host_settings.num_mpm_nodes;
+#pragma omp parallel for
+    for (int i = 0; i < num_nodes; i++) {
+        float mass = node_mass[i];
+        rhs[i * 3 + 0] = mass > 0 ? mass * grid_vel[i * 3 + 0] : 0;
+        rhs[i * 3 + 1] = mass > 0 ? mass * grid_vel[i * 3 + 1] : 0;
+        rhs[i * 3 + 2] = mass > 0 ? mass * grid_vel[i * 3 + 2] : 0;
+    }
+}
+
+// output += A * input (see kMultiplyA and kMultiplyB in ChMPM.cu)
+static void Multiply(const std::vector<float>& v_array, std::vector<float>& result_array) {
+    const int n = host_settings.num_mpm_markers;
+    const float inv_bin_edge = host_settings.inv_bin_edge;
+
+    ScatterMarkers([&](int p) {
+        MPM_Stencil s;
+        ComputeStencil(&pos[p * 3], s);
+
+        Mat33f delta_F(0.0f);
+        LOOP_STENCIL(                                      //
+            float vnx = v_array[current_node * 3 + 0];     //
+            float vny = v_array[current_node * 3 + 1];     //
+            float vnz = v_array[current_node * 3 + 2];     //
+            STENCIL_GRADIENT(s, a, b, c, inv_bin_edge)     //
+            delta_F[0] += vnx * valx; delta_F[1] += vny * valx; delta_F[2] += vnz * valx;  //
+            delta_F[3] += vnx * valy; delta_F[4] += vny * valy; delta_F[5] += vnz * valy;  //
+            delta_F[6] += vnx * valz; delta_F[7] += vny * valz; delta_F[8] += vnz * valz;)
+
+        const Mat33f m_FE(marker_Fe.data(), p, n);
+        delta_F = delta_F * m_FE;
+
+#if defined(BOX_YIELD) || defined(SPHERE_YIELD)
+        const float current_mu =
+            2.0f * host_settings.mu * expf(host_settings.hardening_coefficient * (marker_plasticity[p]));
+#else
+        const float current_mu = 2.0f * host_settings.mu;
+#endif
+
+        Mat33f RE(PolarR.data(), p, n);
+
+        const Mat33f F(marker_Fe_hat.data(), p, n);
+        const float a = -one_third;
+        const float J = Determinant(F);
+        const float Ja = powf(J, a);
+        const Mat33f H = AdjointTranspose(F) * (1.0f / J);
+
+        const Mat33f B_Z = B__Z(delta_F, F, Ja, a, H);
+        const Mat33f WE = TransposeMult(RE, B_Z);
+        SymMat33f SE;
+        SE[0] = PolarS[p + n * 0];
+        SE[1] = PolarS[p + n * 1];
+        SE[2] = PolarS[p + n * 2];
+        SE[3] = PolarS[p + n * 3];
+        SE[4] = PolarS[p + n * 4];
+        SE[5] = PolarS[p + n * 5];
+        const Mat33f C_B_Z = current_mu * (B_Z - Solve_dR(RE, SE, WE));
+
+        const Mat33f FE = Ja * F;
+        const Mat33f A = current_mu * (FE - RE);
+        const Mat33f P1 = Z__B(C_B_Z, F, Ja, a, H);
+        const Mat33f P2 = (a * DoubleDot(H, delta_F)) * Z__B(A, F, Ja, a, H);
+        const Mat33f P3 = (a * Ja * DoubleDot(A, delta_F)) * H;
+        const Mat33f P4 = (-a * Ja * DoubleDot(A, F)) * H * TransposeMult(delta_F, H);
+
+        const Mat33f VAP = marker_volume[p] * MultTranspose(P1 + P2 + P3 + P4, m_FE);
+
+        LOOP_STENCIL(                                                          //
+            STENCIL_GRADIENT(s, a, b, c, inv_bin_edge)                         //
+            result_array[current_node * 3 + 0] += VAP[0] * valx + VAP[3] * valy + VAP[6] * valz;  //
+            result_array[current_node * 3 + 1] += VAP[1] * valx + VAP[4] * valy + VAP[7] * valz;  //
+            result_array[current_node * 3 + 2] += VAP[2] * valx + VAP[5] * valy + VAP[8] * valz;)
+    });
+
+    const int num_nodes = host_settings.num_mpm_nodes;
+#pragma omp parallel for
+    for (int i = 0; i < num_nodes; i++) {
+        float mass = node_mass[i];
+        if (mass > 0) {
+            result_array[i * 3 + 0] += mass * (v_array[i * 3 + 0]);
+            result_array[i * 3 + 1] += mass * (v_array[i * 3 + 1]);
+            result_array[i * 3 + 2] += mass * (v_array[i * 3 + 2]);
+        }
+    }
+}
+
+// Barzilai-Borwein solver (see MPM_BBSolver in ChMPM.cu)
+static void MPM_BBSolver(std::vector<float>& r, std::vector<float>& delta_v) {
+    ChTimer<double> timer_shur, timer_no_shur;
+    timer_shur.reset();
+    timer_no_shur.reset();
+
+    const int size = (int)r.size();
+    float lastgoodres = 10e30f;
+    float alpha = 0.0001f;
+
+    timer_no_shur.start();
+    ml = delta_v;
+    mg.assign(size, 0);
+    mg_p.resize(size);
+    ml_p.resize(size);
+    timer_no_shur.stop();
+
+    timer_shur.start();
+    Multiply(ml, mg);
+    timer_shur.stop();
+
+    timer_no_shur.start();
+#pragma omp parallel for
+    for (int i = 0; i < size; i++) {
+        mg[i] = mg[i] - r[i];
+    }
+    mg_p = mg;
+    timer_no_shur.stop();
+
+    for (int current_iteration = 0; current_iteration < host_settings.num_iterations; current_iteration++) {
+        timer_no_shur.start();
+#pragma omp parallel for
+        for (int i = 0; i < size; i++) {
+            ml_p[i] = ml[i] - alpha * mg[i];
+            mg_p[i] = 0;
+        }
+        timer_no_shur.stop();
+
+        timer_shur.start();
+        Multiply(ml_p, mg_p);
+        timer_shur.stop();
+
+        timer_no_shur.start();
+        float dots[3];
+        Reduce<3>(size,
+                  [&](int i, float* dot) {
+                      mg_p[i] = mg_p[i] - r[i];
+                      float ms = ml_p[i] - ml[i];
+                      float my = mg_p[i] - mg[i];
+                      dot[0] += ms * ms;
+                      dot[1] += ms * my;
+                      dot[2] += my * my;
+                  },
+                  dots);
+        const float dot_ms_ms = dots[0];
+        const float dot_ms_my = dots[1];
+        const float dot_my_my = dots[2];
+
+        if (current_iteration % 2 == 0) {
+            alpha = (dot_ms_my <= 0) ? (float)neg_BB1_fallback
+                                     : fminf((float)a_max, fmaxf((float)a_min, dot_ms_ms / dot_ms_my));
+        } else {
+            alpha = (dot_ms_my <= 0) ? (float)neg_BB2_fallback
+                                     : fminf((float)a_max, fmaxf((float)a_min, dot_ms_my / dot_my_my));
+        }
+
+        ml.swap(ml_p);
+        mg.swap(mg_p);
+
+        float dot_g_proj_norm;
+        Reduce<1>(size, [&](int i, float* dot) { dot[0] += mg[i] * mg[i]; }, &dot_g_proj_norm);
+        float g_proj_norm = sqrtf(dot_g_proj_norm);
+
+        if (g_proj_norm < lastgoodres) {
+            lastgoodres = g_proj_norm;
+            delta_v = ml;
+        }
+        timer_no_shur.stop();
+    }
+    if (host_settings.verbose) {
+        printf("MPM Solver: [%f, %f %f] \n", 1e3 * timer_no_shur.GetTimeSeconds(),
+               1e3 * timer_shur.GetTimeSeconds(), lastgoodres);
+    }
+}
+
+static void MPM_UpdateParticleVelocity() {
+    const float alpha = host_settings.alpha_flip;
+    GatherMarkers([&](int p) {
+        MPM_Stencil s;
+        ComputeStencil(&pos[p * 3], s);
+        float3 V_flip = make_float3(vel[p * 3 + 0], vel[p * 3 + 1], vel[p * 3 + 2]);
+        float3 V_pic = make_float3(0.0, 0.0, 0.0);
+
+        LOOP_STENCIL(                                                             //
+            float weight = s.w[0][a] * s.w[1][b] * s.w[2][c];                     //
+            float vnx = grid_vel[current_node * 3 + 0];                           //
+            float vny = grid_vel[current_node * 3 + 1];                           //
+            float vnz = grid_vel[current_node * 3 + 2];                           //
+            V_pic.x += vnx * weight;                                              //
+            V_pic.y += vny * weight;                                              //
+            V_pic.z += vnz * weight;                                              //
+            V_flip.x += (vnx - old_vel_node_mpm[current_node * 3 + 0]) * weight;  //
+            V_flip.y += (vny - old_vel_node_mpm[current_node * 3 + 1]) * weight;  //
+            V_flip.z += (vnz - old_vel_node_mpm[current_node * 3 + 2]) * weight;)
+        float3 new_vel = (1.0f - alpha) * V_pic + alpha * V_flip;
+
+        float speed = Length(new_vel);
+        if (speed > host_settings.max_velocity) {
+            new_vel = new_vel * host_settings.max_velocity / speed;
+        }
+        vel[p * 3 + 0] = new_vel.x;
+        vel[p * 3 + 1] = new_vel.y;
+        vel[p * 3 + 2] = new_vel.z;
+    });
+}
+
+static void MPM_UpdateMarkerDeformationGradient() {
+    const int n = host_settings.num_mpm_markers;
+    const float inv_bin_edge = host_settings.inv_bin_edge;
+    GatherMarkers([&](int p) {
+        MPM_Stencil s;
+        ComputeStencil(&pos[p * 3], s);
+        Mat33f vel_grad(0.0);
+        LOOP_STENCIL(                                          //
+            float vnx = grid_vel[current_node * 3 + 0];        //
+            float vny = grid_vel[current_node * 3 + 1];        //
+            float vnz = grid_vel[current_node * 3 + 2];        //
+            STENCIL_GRADIENT(s, a, b, c, inv_bin_edge)         //
+            vel_grad[0] += vnx * valx; vel_grad[1] += vny * valx; vel_grad[2] += vnz * valx;  //
+            vel_grad[3] += vnx * valy; vel_grad[4] += vny * valy; vel_grad[5] += vnz * valy;  //
+            vel_grad[6] += vnx * valz; vel_grad[7] += vny * valz; vel_grad[8] += vnz * valz;)
+
+        Mat33f delta_F = (Mat33f(1.0) + host_settings.dt * vel_grad);
+        Mat33f m_FE(marker_Fe.data(), p, n);
+        Mat33f m_FPpre(marker_Fp.data(), p, n);
+
+        Mat33f Fe_tmp = delta_F * m_FE;
+        Mat33f F_tmp = Fe_tmp * m_FPpre;
+        Mat33f U, V;
+        float3 E;
+        SVD(Fe_tmp, U, E, V);
+        float3 E_clamped = E;
+
+#if defined(BOX_YIELD)
+        // Simple box clamp
+        E_clamped.x = Clamp(E.x, 1.0 - host_settings.theta_c, 1.0 + host_settings.theta_s);
+        E_clamped.y = Clamp(E.y, 1.0 - host_settings.theta_c, 1.0 + host_settings.theta_s);
+        E_clamped.z = Clamp(E.z, 1.0 - host_settings.theta_c, 1.0 + host_settings.theta_s);
+        marker_plasticity[p] = fabsf(E.x * E.y * E.z - E_clamped.x * E_clamped.y * E_clamped.z);
+#elif defined(SPHERE_YIELD)
+        // Clamp to sphere (better)
+        float center = 1.0f + (host_settings.theta_s - host_settings.theta_c) * .5f;
+        float radius = (host_settings.theta_s + host_settings.theta_c) * .5f;
+        float3 offset = E - center;
+        float lent = Length(offset);
+        if (lent > radius) {
+            offset = offset * radius / lent;
+        }
+        E_clamped = offset + center;
+        marker_plasticity[p] = fabsf(E.x * E.y * E.z - E_clamped.x * E_clamped.y * E_clamped.z);
+#endif
+
+        // Inverse of Diagonal E_clamped matrix is 1/E_clamped
+        Mat33f m_FP = V * MultTranspose(Mat33f(1.0f / E_clamped), U) * F_tmp;
+        float JP_new = Determinant(m_FP);
+        // Ensure that F_p is purely deviatoric
+        Mat33f T1 = powf(JP_new, 1.0f / 3.0f) * U * MultTranspose(Mat33f(E_clamped), V);
+        Mat33f T2 = powf(JP_new, -1.0f / 3.0f) * m_FP;
+
+        JE_JP[p * 2 + 0] = Determinant(T1);
+        JE_JP[p * 2 + 1] = Determinant(T2);
+
+        T1.Store(marker_Fe.data(), p, n);
+        T2.Store(marker_Fp.data(), p, n);
+    });
+}
+
+//////========================================================================================================================================================================
+
+void MPM_UpdateDeformationGradient(MPM_Settings& settings,
+                                   std::vector<float>& positions,
+                                   std::vector<float>& velocities,
+                                   std::vector<float>& jejp) {
+    host_settings = settings;
+
+    pos = positions;
+    vel = velocities;
+
+    MPM_ComputeBounds();
+
+    node_mass.assign(host_settings.num_mpm_nodes, 0);
+    grid_vel.assign(host_settings.num_mpm_nodes * 3, 0);
+
+    MPM_Rasterize(true);
+    MPM_NormalizeWeights();
+    MPM_UpdateMarkerDeformationGradient();
+
+    jejp = JE_JP;
+}
+
+void MPM_Solve(MPM_Settings& settings, std::vector<float>& positions, std::vector<float>& velocities) {
+    old_vel_node_mpm = grid_vel;
+    rhs.resize(host_settings.num_mpm_nodes * 3);
+
+    MPM_FeHat();
+    MPM_ApplyForces();
+    MPM_Rhs();
+
+    delta_v = old_vel_node_mpm;
+    MPM_BBSolver(rhs, delta_v);
+
+    const int size = (int)grid_vel.size();
+#pragma omp parallel for
+    for (int i = 0; i < size; i++) {
+        grid_vel[i] += delta_v[i] - old_vel_node_mpm[i];
+    }
+
+    MPM_UpdateParticleVelocity();
+
+    velocities = vel;
+}
+
+void MPM_Initialize(MPM_Settings& settings, std::vector<float>& positions) {
+    host_settings = settings;
+
+    pos = positions;
+    vel.clear();
+
+    MPM_ComputeBounds();
+
+    const int n = host_settings.num_mpm_markers;
+    marker_volume.resize(n);
+    node_mass.assign(host_settings.num_mpm_nodes, 0);
+
+    MPM_Rasterize(false);
+    MPM_ComputeParticleVolumes();
+
+    marker_Fe.resize(n * 9);
+    marker_Fe_hat.resize(n * 9);
+    marker_Fp.resize(n * 9);
+    PolarR.resize(n * 9);
+    PolarS.resize(n * 6);
+    JE_JP.resize(n * 2);
+    marker_plasticity.assign(n * 2, 0);
+
+#pragma omp parallel for
+    for (int i = 0; i < n; i++) {
+        Mat33f T(1.0f);
+        T.Store(marker_Fe.data(), i, n);
+        T.Store(marker_Fp.data(), i, n);
+        T.Store(PolarR.data(), i, n);
+
+        PolarS[i + n * 0] = 1.0f;
+        PolarS[i + n * 1] = 0.0f;
+        PolarS[i + n * 2] = 0.0f;
+        PolarS[i + n * 3] = 1.0f;
+        PolarS[i + n * 4] = 0.0f;
+        PolarS[i + n * 5] = 1.0f;
+    }
+}
+
+}  // end namespace chrono
@@ -38,6 +38,7 @@ struct MPM_Settings {
     int bins_per_axis_x;
     int bins_per_axis_y;
     int bins_per_axis_z;
+    bool verbose;  // print the grid and solver statistics
 };
 
 /// @} parallel_physics
@@ -43,6 +43,7 @@ ChParticleContainer::ChParticleContainer() {
     start_boundary = 0;
     start_contact = 0;
     mpm_iterations = 0;
+    mpm_verbose = false;
 
     nu = .2;
     youngs_modulus = 1.4e5;
@@ -70,7 +71,6 @@ void ChParticleContainer::Update(double ChTime) {
     uint num_rigid_bodies = data_manager->num_rigid_bodies;
     uint num_shafts = data_manager->num_shafts;
     real3 h_gravity = data_manager->settings.step_size * mass * data_manager->settings.gravity;
-#ifdef CHRONO_PARALLEL_USE_CUDA
     if (mpm_init) {
         temp_settings.dt = (float)data_manager->settings.step_size;
         temp_settings.kernel_radius = (float)kernel_radius;
@@ -90,6 +90,7 @@ void ChParticleContainer::Update(double ChTime) {
         temp_settings.mass = (float)mass;
         temp_settings.yield_stress = (float)yield_stress;
         temp_settings.num_iterations = mpm_iterations;
+        temp_settings.verbose = mpm_verbose;
 
         if (mpm_iterations > 0) {
             mpm_pos.resize(data_manager->num_fluid_bodies * 3);
@@ -118,7 +119,6 @@ void ChParticleContainer::Update(double ChTime) {
             //            }
         }
     }
-#endif
 
 #pragma omp parallel for
     for (int i = 0; i < (signed)num_fluid_bodies; i++) {
@@ -290,7 +290,6 @@ void ChParticleContainer::Setup(int start_constraint) {
 }
 
 void ChParticleContainer::Initialize() {
-#ifdef CHRONO_PARALLEL_USE_CUDA
     temp_settings.dt = (float)data_manager->settings.step_size;
     temp_settings.kernel_radius = (float)kernel_radius;
     temp_settings.inv_radius = float(1.0 / kernel_radius);
@@ -309,6 +308,7 @@ void ChParticleContainer::Initialize() {
     temp_settings.mass = (float)mass;
     temp_settings.yield_stress = (float)yield_stress;
     temp_settings.num_iterations = mpm_iterations;
+    temp_settings.verbose = mpm_verbose;
     if (mpm_iterations > 0) {
         mpm_pos.resize(data_manager->num_fluid_bodies * 3);
 
@@ -321,7 +321,6 @@ void ChParticleContainer::Initialize() {
         MPM_Initialize(temp_settings, mpm_pos);
     }
     mpm_init = true;
-#endif
 }
 
 void ChParticleContainer::Build_D() {
@@ -541,7 +540,6 @@ real3 ChParticleContainer::GetBodyContactTorque(uint body_id) {
 }
 
 void ChParticleContainer::PreSolve() {
-#ifdef CHRONO_PARALLEL_USE_CUDA
     if (mpm_thread.joinable()) {
         mpm_thread.join();
 #pragma omp parallel for
@@ -552,7 +550,6 @@ void ChParticleContainer::PreSolve() {
             data_manager->host_data.v[body_offset + index * 3 + 2] = mpm_vel[p * 3 + 2];
         }
     }
-#endif
 }
 
 void ChParticleContainer::PostSolve() {}
@@ -23,6 +23,7 @@
 #include "chrono/physics/ChShaftsGearboxAngled.h"
 #include "chrono/physics/ChShaftsPlanetary.h"
 #include "chrono/physics/ChShaftsBody.h"
+#include "chrono/collision/ChCModelBullet.h"
 
 #include "chrono_parallel/ChDataManager.h"
 #include "chrono_parallel/physics/ChSystemParallel.h"
@@ -40,8 +41,23 @@
 
 #include <numeric>
 
+#include <thrust/scan.h>
+
+#if defined(CHRONO_OPENMP_ENABLED)
+#include <thrust/system/omp/execution_policy.h>
+#elif defined(CHRONO_TBB_ENABLED)
+#include <thrust/system/tbb/execution_policy.h>
+#endif
+
 using namespace chrono;
 using namespace chrono::collision;
+
+// Reasons for which the ChBody object of a body must be updated at each step.
+enum BodySyncFlag {
+    SYNC_USER = 1,   // requested by the user (SetBodySyncRequired)
+    SYNC_AUXREF = 2  // ChBodyAuxRef, whose reference frame is calculated in Update
+};
+
 #ifdef LOGGINGENABLED
 INITIALIZE_EASYLOGGINGPP
 #endif
@@ -65,6 +81,9 @@ ChSystemParallel::ChSystemParallel() : ChSystem() {
     detect_optimal_bins = false;
     current_threads = 2;
 
+    removed_body = std::make_shared<ChBody>();
+    removed_body->SetBodyFixed(true);
+
     data_manager->system_timer.AddTimer("step");
     data_manager->system_timer.AddTimer("update");
     data_manager->system_timer.AddTimer("collision");
@@ -151,7 +170,7 @@ bool ChSystemParallel::Integrate_Y() {
 
 #pragma omp parallel for
     for (int i = 0; i < bodylist.size(); i++) {
-        if (data_manager->host_data.active_rigid[i] != 0) {
+        if (data_manager->host_data.active_rigid[i] != 0 && body_sync[i]) {
             bodylist[i]->Variables().Get_qb().SetElement(0, 0, velocities[i * 6 + 0]);
             bodylist[i]->Variables().Get_qb().SetElement(1, 0, velocities[i * 6 + 1]);
             bodylist[i]->Variables().Get_qb().SetElement(2, 0, velocities[i * 6 + 2]);
@@ -171,6 +190,9 @@ bool ChSystemParallel::Integrate_Y() {
         }
     }
 
+    // Advance the states of the other bodies directly in the system-wide vectors.
+    IntegrateLazyBodies();
+
     ////#pragma omp parallel for
     for (int i = 0; i < (signed)data_manager->num_shafts; i++) {
         if (!data_manager->host_data.shaft_active[i])
@@ -212,7 +234,7 @@ void ChSystemParallel::AddBody(std::shared_ptr<ChBody> newbody) {
     // refer to. Not used by contacts
     newbody->SetId(data_manager->num_rigid_bodies);
 
-    bodylist.push_back(newbody);
+    AppendItem(bodylist, newbody);
     data_manager->num_rigid_bodies++;
 
     // Set the system for the body.  Note that this will also add the body's
@@ -226,10 +248,154 @@ void ChSystemParallel::AddBody(std::shared_ptr<ChBody> newbody) {
     data_manager->host_data.active_rigid.push_back(true);
     data_manager->host_data.collide_rigid.push_back(true);
 
+    body_sync_required.push_back(std::dynamic_pointer_cast<ChBodyAuxRef>(newbody) ? SYNC_AUXREF : 0);
+    body_sync.push_back(true);
+    body_stale.push_back(false);
+    body_removed.push_back(false);
+
     // Let derived classes reserve space for specific material surface data
     AddMaterialSurfaceData(newbody);
 }
 
+//
+// Remove the specified body from the system, in constant time.
+// The entries of the body in the system-wide vectors are kept (and ignored)
+// until the next compaction, so that the IDs of the other bodies do not change.
+// Note that this also marks the collision shapes of the body as inactive.
+//
+
+void ChSystemParallel::RemoveBody(std::shared_ptr<ChBody> body) {
+    uint index = body->GetId();
+    assert(body->GetSystem() == this && index < bodylist.size() && bodylist[index] == body);
+
+    body->SetSystem(nullptr);
+    bodylist[index] = removed_body;
+
+    data_manager->host_data.active_rigid[index] = false;
+    data_manager->host_data.collide_rigid[index] = false;
+
+    body_sync_required[index] = 0;
+    body_sync[index] = false;
+    body_stale[index] = false;
+    body_removed[index] = true;
+    data_manager->num_removed_bodies++;
+}
+
+std::vector<std::shared_ptr<ChBody>> ChSystemParallel::GetBodies() const {
+    std::vector<std::shared_ptr<ChBody>> bodies;
+    bodies.reserve(bodylist.size() - data_manager->num_removed_bodies);
+    for (auto& body : bodylist) {
+        if (body != removed_body)
+            bodies.push_back(body);
+    }
+    return bodies;
+}
+
+void ChSystemParallel::FlushBatch() {
+    // Items which are not (or no longer) in the system are ignored
+    for (auto& item : batch_to_remove) {
+        if (item->GetSystem() == this)
+            Remove(item);
+    }
+    batch_to_remove.clear();
+
+    for (auto& item : batch_to_insert) {
+        Add(item);
+    }
+    batch_to_insert.clear();
+}
+
+//
+// Compact all system-wide vectors with per-body and per-shape data, removing the
+// entries of the removed bodies and shapes. The order of the remaining bodies is
+// preserved; their IDs are set to their new index in the body list.
+//
+
+void ChSystemParallel::CompactBodies() {
+    if (data_manager->num_removed_bodies == 0 && data_manager->num_removed_shapes == 0)
+        return;
+
+    LOG(INFO) << "ChSystemParallel::CompactBodies()";
+
+    uint num_bodies = data_manager->num_rigid_bodies;
+    uint num_remaining = num_bodies - data_manager->num_removed_bodies;
+
+    // Map from old to new body indices.
+    custom_vector<uint> body_map(num_bodies);
+#pragma omp parallel for
+    for (int i = 0; i < (signed)num_bodies; i++) {
+        body_map[i] = body_removed[i] ? 0 : 1;
+    }
+    Thrust_Exclusive_Scan(body_map);
+#pragma omp parallel for
+    for (int i = 0; i < (signed)num_bodies; i++) {
+        if (body_removed[i])
+            body_map[i] = UINT_MAX;
+    }
+
+    // Collision shapes
+    custom_vector<uint> shape_map;
+    if (collision_system_type == CollisionSystemType::COLLSYS_PARALLEL) {
+        std::static_pointer_cast<ChCollisionSystemParallel>(collision_system)->Compact(body_map, shape_map);
+    }
+
+    // Per-body vectors. Note that the velocities of the rigid bodies are followed by those of
+    // the shafts, fluid and FEA nodes.
+    host_container& host_data = data_manager->host_data;
+    CompactBodyData(host_data.pos_rigid, body_map, num_remaining);
+    CompactBodyData(host_data.rot_rigid, body_map, num_remaining);
+    CompactBodyData(host_data.active_rigid, body_map, num_remaining);
+    CompactBodyData(host_data.collide_rigid, body_map, num_remaining);
+    CompactBodyData(body_sync_required, body_map, num_remaining);
+    CompactBodyData(body_sync, body_map, num_remaining);
+    CompactBodyData(body_stale, body_map, num_remaining);
+
+    if (host_data.v.size() >= num_bodies * 6) {
+        uint shift = (num_bodies - num_remaining) * 6;
+        DynamicVector<real> v(host_data.v.size() - shift);
+#pragma omp parallel for
+        for (int i = 0; i < (signed)num_bodies; i++) {
+            if (body_map[i] == UINT_MAX)
+                continue;
+            for (int j = 0; j < 6; j++)
+                v[body_map[i] * 6 + j] = host_data.v[i * 6 + j];
+        }
+        for (size_t i = num_bodies * 6; i < host_data.v.size(); i++) {
+            v[i - shift] = host_data.v[i];
+        }
+        swap(host_data.v, v);
+    }
+
+    // Body list and body IDs
+    for (uint i = 0; i < num_bodies; i++) {
+        if (body_removed[i])
+            bodylist[i].reset();
+    }
+    CompactItems(bodylist);
+    body_removed.assign(num_remaining, false);
+
+    data_manager->num_rigid_bodies = num_remaining;
+    data_manager->num_removed_bodies = 0;
+    data_manager->Fc_current = false;
+
+    // Let derived classes compact their specific material surface data
+    CompactMaterialSurfaceData(body_map, shape_map);
+
+#pragma omp parallel for
+    for (int i = 0; i < (signed)num_remaining; i++) {
+        ChBody* body = bodylist[i].get();
+        body->SetId(i);
+        if (collision_system_type == CollisionSystemType::COLLSYS_PARALLEL) {
+            auto model = static_cast<ChCollisionModelParallel*>(body->GetCollisionModel().get());
+            if (model->shape_index >= 0)
+                model->shape_index = shape_map[model->shape_index];
+        } else {
+            auto model = static_cast<ChModelBullet*>(body->GetCollisionModel().get());
+            model->GetBulletModel()->setCompanionId(i);
+        }
+    }
+}
+
 //
 // Add physics items, other than bodies or links, to the system.
 // We keep track separately of ChShaft elements which are maintained in their
@@ -252,7 +418,7 @@ void ChSystemParallel::AddOtherPhysicsItem(std::shared_ptr<ChPhysicsItem> newite
 #endif
     } else {
         newitem->SetSystem(this);
-        otherphysicslist.push_back(newitem);
+        AppendItem(otherphysicslist, newitem);
 
         if (newitem->GetCollide()) {
             newitem->AddCollisionModelsToSystem();
@@ -357,7 +523,8 @@ void ChSystemParallel::AddMesh(std::shared_ptr<fea::ChMesh> mesh) {
 void ChSystemParallel::ClearForceVariables() {
 #pragma omp parallel for
     for (int i = 0; i < (signed)data_manager->num_rigid_bodies; i++) {
-        bodylist[i]->VariablesFbReset();
+        if (body_sync[i])
+            bodylist[i]->VariablesFbReset();
     }
 
     ////#pragma omp parallel for
@@ -377,6 +544,9 @@ void ChSystemParallel::ClearForceVariables() {
 //
 void ChSystemParallel::Update() {
     LOG(INFO) << "ChSystemParallel::Update()";
+    // Decide which ChBody objects are updated at this step
+    UpdateBodySyncFlags();
+
     // Clear the forces for all variables
     ClearForceVariables();
 
@@ -403,6 +573,12 @@ void ChSystemParallel::Update() {
 // Update all bodies in the system and populate system-wide state and force
 // vectors. Note that visualization assets are not updated.
 //
+// The entries of the removed bodies (see RemoveBody) are kept inactive.
+//
+// The ChBody objects which are not updated at this step (see UpdateBodySyncFlags)
+// only provide the applied forces; if their state is outdated, the current state
+// is the one in the system-wide vectors.
+//
 void ChSystemParallel::UpdateRigidBodies() {
     custom_vector<real3>& position = data_manager->host_data.pos_rigid;
     custom_vector<quaternion>& rotation = data_manager->host_data.rot_rigid;
@@ -411,6 +587,64 @@ void ChSystemParallel::UpdateRigidBodies() {
 
 #pragma omp parallel for
     for (int i = 0; i < bodylist.size(); i++) {
+        // Removed bodies are inactive, without forces.
+        if (body_removed[i]) {
+            for (int j = 0; j < 6; j++) {
+                data_manager->host_data.v[i * 6 + j] = 0;
+                data_manager->host_data.hf[i * 6 + j] = 0;
+            }
+            continue;
+        }
+
+        if (!body_sync[i]) {
+            ChBody* body = bodylist[i].get();
+
+            if (!body_stale[i]) {
+                const ChVector<>& body_pos = body->GetPos();
+                const ChQuaternion<>& body_rot = body->GetRot();
+                const ChVector<>& body_vel = body->GetPos_dt();
+                ChVector<> body_wvel = body->GetWvel_loc();
+
+                data_manager->host_data.v[i * 6 + 0] = body_vel.x();
+                data_manager->host_data.v[i * 6 + 1] = body_vel.y();
+                data_manager->host_data.v[i * 6 + 2] = body_vel.z();
+                data_manager->host_data.v[i * 6 + 3] = body_wvel.x();
+                data_manager->host_data.v[i * 6 + 4] = body_wvel.y();
+                data_manager->host_data.v[i * 6 + 5] = body_wvel.z();
+
+                position[i] = real3(body_pos.x(), body_pos.y(), body_pos.z());
+                rotation[i] = quaternion(body_rot.e0(), body_rot.e1(), body_rot.e2(), body_rot.e3());
+            }
+
+            // Applied forces, as in ChBody::UpdateForces (the body has no markers and no forces).
+            // The accumulated force and torque are in the absolute frame; bodies loaded in their own
+            // frame must be flagged with SetBodySyncRequired (see settings_container::lazy_body_update).
+            ChVector<> force = body->Get_accumulated_force() + body->Get_Scr_force() + G_acc * body->GetMass();
+            ChVector<> torque_abs = body->Get_accumulated_torque() + body->Get_Scr_torque();
+            real3 torque = RotateT(real3(torque_abs.x(), torque_abs.y(), torque_abs.z()), rotation[i]);
+
+            // Gyroscopic torque, as in ChBody::ComputeGyro.
+            if (!body->GetNoGyroTorque()) {
+                ChVector<> wvel(data_manager->host_data.v[i * 6 + 3], data_manager->host_data.v[i * 6 + 4],
+                                data_manager->host_data.v[i * 6 + 5]);
+                ChVector<> gyro = Vcross(wvel, body->GetInertia().Matr_x_Vect(wvel));
+                torque = torque - real3(gyro.x(), gyro.y(), gyro.z());
+            }
+
+            data_manager->host_data.hf[i * 6 + 0] = force.x() * step;
+            data_manager->host_data.hf[i * 6 + 1] = force.y() * step;
+            data_manager->host_data.hf[i * 6 + 2] = force.z() * step;
+            data_manager->host_data.hf[i * 6 + 3] = torque.x * step;
+            data_manager->host_data.hf[i * 6 + 4] = torque.y * step;
+            data_manager->host_data.hf[i * 6 + 5] = torque.z * step;
+
+            active[i] = body->IsActive();
+            collide[i] = body->GetCollide();
+
+            UpdateMaterialSurfaceData(i, body);
+            continue;
+        }
+
         bodylist[i]->Update(ChTime, false);
         bodylist[i]->VariablesFbLoadForces(GetStep());
         bodylist[i]->VariablesQbLoadSpeed();
@@ -610,6 +844,17 @@ void ChSystemParallel::UpdateBilaterals() {
 //
 void ChSystemParallel::Setup() {
     LOG(INFO) << "ChSystemParallel::Setup()";
+    // Process the queued additions and removals, then compact the system-wide vectors if
+    // the removed bodies or shapes make up a large enough fraction of their entries (so that
+    // the cost of the compaction, linear in the number of entries, is amortized).
+    FlushBatch();
+
+    real threshold = data_manager->settings.compaction_threshold;
+    if (data_manager->num_removed_bodies > threshold * data_manager->num_rigid_bodies ||
+        data_manager->num_removed_shapes > threshold * data_manager->num_rigid_shapes) {
+        CompactBodies();
+    }
+
     // Cache the integration step size and calculate the tolerance at impulse level.
     data_manager->settings.step_size = step;
     data_manager->settings.solver.tol_speed = step * data_manager->settings.solver.tolerance;
@@ -621,7 +866,7 @@ void ChSystemParallel::Setup() {
                             data_manager->num_fluid_bodies * 3 + data_manager->num_fea_nodes * 3;
 
     // Set variables that are stored in the ChSystem class
-    nbodies = data_manager->num_rigid_bodies;
+    nbodies = data_manager->num_rigid_bodies - data_manager->num_removed_bodies;
     nlinks = 0;
     nphysicsitems = 0;
     ncoords = 0;
@@ -639,6 +884,117 @@ void ChSystemParallel::Setup() {
     nbodies_fixed = 0;
 }
 
+//
+// Decide which ChBody objects are updated at the current step. If lazy body
+// updates are disabled, all of them are. Otherwise, only the bodies whose ChBody
+// object is accessed during the step (links, other physics items, assets,
+// markers and forces) and those flagged by the user. The ChBody objects with an
+// outdated state which need to be updated are synchronized here, before they are
+// accessed by the links.
+//
+void ChSystemParallel::UpdateBodySyncFlags() {
+    bool lazy = data_manager->settings.lazy_body_update &&
+                collision_system_type == CollisionSystemType::COLLSYS_PARALLEL;
+
+#pragma omp parallel for
+    for (int i = 0; i < bodylist.size(); i++) {
+        ChBody* body = bodylist[i].get();
+        body_sync[i] = !body_removed[i] &&
+                       (!lazy || body_sync_required[i] || !body->IsActive() || body->GetLimitSpeed() ||
+                        !body->GetAssets().empty() || !body->GetMarkerList().empty() ||
+                        !body->GetForceList().empty());
+    }
+
+    if (lazy) {
+        for (int i = 0; i < linklist.size(); i++) {
+            if (auto body = dynamic_cast<ChBody*>(linklist[i]->GetBody1()))
+                body_sync[body->GetId()] = true;
+            if (auto body = dynamic_cast<ChBody*>(linklist[i]->GetBody2()))
+                body_sync[body->GetId()] = true;
+        }
+        for (int i = 0; i < otherphysicslist.size(); i++) {
+            if (auto shaft_body = std::dynamic_pointer_cast<ChShaftsBody>(otherphysicslist[i])) {
+                if (auto body = dynamic_cast<ChBody*>(shaft_body->GetBody()))
+                    body_sync[body->GetId()] = true;
+            }
+        }
+    }
+
+#pragma omp parallel for
+    for (int i = 0; i < bodylist.size(); i++) {
+        if (body_sync[i] && body_stale[i])
+            SyncBody(i);
+    }
+}
+
+//
+// Advance the positions and rotations of the active bodies whose ChBody object
+// is not updated at this step, directly in the system-wide vectors (same
+// integration as in ChBody::VariablesQbIncrementPosition). The ChBody objects
+// of these bodies have an outdated state until the next call to SyncBody.
+//
+void ChSystemParallel::IntegrateLazyBodies() {
+    const real* v = data_manager->host_data.v.data();
+    const char* active = data_manager->host_data.active_rigid.data();
+    real3* pos = data_manager->host_data.pos_rigid.data();
+    quaternion* rot = data_manager->host_data.rot_rigid.data();
+    real step_size = step;
+
+#pragma omp parallel for
+    for (int i = 0; i < (signed)data_manager->num_rigid_bodies; i++) {
+        if (body_sync[i] || !active[i])
+            continue;
+
+        real3 vel(v[i * 6 + 0], v[i * 6 + 1], v[i * 6 + 2]);
+        real3 wvel_abs = Rotate(real3(v[i * 6 + 3], v[i * 6 + 4], v[i * 6 + 5]), rot[i]);
+
+        pos[i] = pos[i] + vel * step_size;
+
+        real wvel_norm = Length(wvel_abs);
+        if (wvel_norm > 0) {
+            real halfang = 0.5 * wvel_norm * step_size;
+            real3 axis = wvel_abs * (Sin(halfang) / wvel_norm);
+            rot[i] = Mult(quaternion(Cos(halfang), axis.x, axis.y, axis.z), rot[i]);
+        }
+
+        body_stale[i] = true;
+    }
+}
+
+//
+// Update the ChBody object of the specified body with the state in the
+// system-wide vectors.
+//
+void ChSystemParallel::SyncBody(int index) {
+    ChBody* body = bodylist[index].get();
+    const real3& pos = data_manager->host_data.pos_rigid[index];
+    const quaternion& rot = data_manager->host_data.rot_rigid[index];
+    const DynamicVector<real>& v = data_manager->host_data.v;
+
+    body->SetCoord(ChVector<>(pos.x, pos.y, pos.z), ChQuaternion<>(rot.w, rot.x, rot.y, rot.z));
+    body->SetPos_dt(ChVector<>(v[index * 6 + 0], v[index * 6 + 1], v[index * 6 + 2]));
+    body->SetWvel_loc(ChVector<>(v[index * 6 + 3], v[index * 6 + 4], v[index * 6 + 5]));
+    body->Update(ChTime);
+
+    body_stale[index] = false;
+}
+
+void ChSystemParallel::SyncBodies() {
+#pragma omp parallel for
+    for (int i = 0; i < bodylist.size(); i++) {
+        if (body_stale[i])
+            SyncBody(i);
+    }
+}
+
+void ChSystemParallel::SetBodySyncRequired(std::shared_ptr<ChBody> body, bool val) {
+    assert(body->GetSystem() == this);
+    if (val)
+        body_sync_required[body->GetId()] |= SYNC_USER;
+    else
+        body_sync_required[body->GetId()] &= ~SYNC_USER;
+}
+
 void ChSystemParallel::RecomputeThreads() {
 #ifdef CHRONO_OMP_FOUND
     timer_accumulator.insert(timer_accumulator.begin(), data_manager->system_timer.GetTime("step"));
@@ -746,7 +1102,7 @@ void ChSystemParallel::PrintStepStats() {
 }
 
 unsigned int ChSystemParallel::GetNumBodies() {
-    return data_manager->num_rigid_bodies + data_manager->num_fluid_bodies;
+    return data_manager->num_rigid_bodies - data_manager->num_removed_bodies + data_manager->num_fluid_bodies;
 }
 
 unsigned int ChSystemParallel::GetNumShafts() {
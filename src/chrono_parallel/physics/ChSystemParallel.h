@@ -22,6 +22,7 @@
 
 #include <cstdlib>
 #include <cfloat>
+#include <climits>
 #include <memory>
 #include <algorithm>
 
@@ -63,6 +64,28 @@ class CH_PARALLEL_API ChSystemParallel : public ChSystem {
     virtual void AddBody(std::shared_ptr<ChBody> newbody) override;
     virtual void AddOtherPhysicsItem(std::shared_ptr<ChPhysicsItem> newitem) override;
 
+    /// Remove a body from the system.
+    /// The body is detached from the system (its collision shapes are disabled), but its entries in the
+    /// system-wide arrays are only marked as removed and its slot in the body list is taken by an inert
+    /// placeholder (a fixed body which does not belong to any system). These entries are removed when the
+    /// arrays are compacted (see CompactBodies), which changes the IDs of the remaining bodies.
+    /// Until then, the body list returned by Get_bodylist() (and scanned by the body iterators) still
+    /// includes the placeholders, and its size counts them. Use GetBodies() to get only the bodies in the
+    /// system, or call CompactBodies() first.
+    virtual void RemoveBody(std::shared_ptr<ChBody> body) override;
+
+    /// Get the bodies in the system, in the order of the body list, without the placeholders of the
+    /// bodies removed since the last compaction (see RemoveBody).
+    std::vector<std::shared_ptr<ChBody>> GetBodies() const;
+
+    /// Process the items queued with AddBatch() and RemoveBatch(). Called automatically at each Setup().
+    virtual void FlushBatch() override;
+
+    /// Remove the entries of the removed bodies and collision shapes from all system-wide arrays and renumber
+    /// the remaining bodies, preserving their order. Called automatically at the beginning of a step when the
+    /// fraction of removed bodies or shapes exceeds settings_container::compaction_threshold.
+    void CompactBodies();
+
     void ClearForceVariables();
     virtual void Update();
     virtual void UpdateBilaterals();
@@ -75,6 +98,11 @@ class CH_PARALLEL_API ChSystemParallel : public ChSystem {
 
     virtual void AddMaterialSurfaceData(std::shared_ptr<ChBody> newbody) = 0;
     virtual void UpdateMaterialSurfaceData(int index, ChBody* body) = 0;
+    /// Compact the body-specific contact data of derived classes (see CompactBodies).
+    /// The map from old to new body indices is provided, as well as the map from old to new shape
+    /// indices (empty if the collision system does not use the system-wide shape arrays).
+    virtual void CompactMaterialSurfaceData(const custom_vector<uint>& body_map,
+                                            const custom_vector<uint>& shape_map) = 0;
     virtual void Setup() override;
     virtual void ChangeCollisionSystem(CollisionSystemType type);
 
@@ -116,6 +144,16 @@ class CH_PARALLEL_API ChSystemParallel : public ChSystem {
 
     settings_container* GetSettings();
 
+    /// Specify whether the ChBody object of the given body must be updated at each step.
+    /// Only relevant if lazy body updates are enabled (see settings_container::lazy_body_update).
+    /// Required for bodies loaded with forces or torques in the body frame, or with an application point.
+    void SetBodySyncRequired(std::shared_ptr<ChBody> body, bool val);
+
+    /// Update all ChBody objects with the current body states (positions and velocities).
+    /// Only needed if lazy body updates are enabled (see settings_container::lazy_body_update), before accessing
+    /// the state of bodies which are not updated at each step. Body accelerations are not updated.
+    void SyncBodies();
+
     // Based on the specified logging level and the state of that level, enable or
     // disable logging level.
     void SetLoggingLevel(LoggingLevel level, bool state = true);
@@ -139,7 +177,36 @@ class CH_PARALLEL_API ChSystemParallel : public ChSystem {
 
     CollisionSystemType collision_system_type;
 
+    std::vector<char> body_sync_required;  ///< bodies which always need an update of the ChBody object
+    std::vector<char> body_sync;           ///< bodies whose ChBody object is updated at the current step
+    std::vector<char> body_stale;          ///< bodies whose ChBody object has an outdated state
+    std::vector<char> body_removed;        ///< bodies removed from the system, until the next compaction
+
+    std::shared_ptr<ChBody> removed_body;  ///< placeholder for the removed bodies in the body list
+
+    /// Gather the entries of the remaining bodies in a system-wide vector with 'stride' entries per body,
+    /// given the map from old to new body indices (UINT_MAX for removed bodies). Empty vectors are skipped.
+    template <typename V>
+    static void CompactBodyData(V& data, const custom_vector<uint>& body_map, uint num_bodies, int stride = 1) {
+        if (data.empty())
+            return;
+        assert(data.size() == body_map.size() * stride);
+        V compacted(num_bodies * stride);
+#pragma omp parallel for
+        for (int i = 0; i < (signed)body_map.size(); i++) {
+            if (body_map[i] == UINT_MAX)
+                continue;
+            for (int j = 0; j < stride; j++)
+                compacted[body_map[i] * stride + j] = data[i * stride + j];
+        }
+        data.swap(compacted);
+    }
+
   private:
+    void UpdateBodySyncFlags();
+    void SyncBody(int index);
+    void IntegrateLazyBodies();
+
     void AddShaft(std::shared_ptr<ChShaft> shaft);
 #ifdef CHRONO_FEA
     void AddMesh(std::shared_ptr<fea::ChMesh> mesh);
@@ -168,6 +235,8 @@ class CH_PARALLEL_API ChSystemParallelNSC : public ChSystemParallel {
     virtual ChBodyAuxRef* NewBodyAuxRef() override;
     virtual void AddMaterialSurfaceData(std::shared_ptr<ChBody> newbody) override;
     virtual void UpdateMaterialSurfaceData(int index, ChBody* body) override;
+    virtual void CompactMaterialSurfaceData(const custom_vector<uint>& body_map,
+                                            const custom_vector<uint>& shape_map) override;
 
     void Add3DOFContainer(std::shared_ptr<Ch3DOFContainer> container);
 
@@ -201,6 +270,8 @@ class CH_PARALLEL_API ChSystemParallelSMC : public ChSystemParallel {
     virtual ChBodyAuxRef* NewBodyAuxRef() override;
     virtual void AddMaterialSurfaceData(std::shared_ptr<ChBody> newbody) override;
     virtual void UpdateMaterialSurfaceData(int index, ChBody* body) override;
+    virtual void CompactMaterialSurfaceData(const custom_vector<uint>& body_map,
+                                            const custom_vector<uint>& shape_map) override;
 
     virtual void Setup() override;
     virtual void ChangeCollisionSystem(CollisionSystemType type) override;
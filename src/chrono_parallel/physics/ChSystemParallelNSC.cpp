@@ -103,6 +103,15 @@ void ChSystemParallelNSC::UpdateMaterialSurfaceData(int index, ChBody* body) {
                               mat_ptr->GetComplianceSpinning());
 }
 
+void ChSystemParallelNSC::CompactMaterialSurfaceData(const custom_vector<uint>& body_map,
+                                                     const custom_vector<uint>& shape_map) {
+    uint num_bodies = data_manager->num_rigid_bodies;
+
+    CompactBodyData(data_manager->host_data.fric_data, body_map, num_bodies);
+    CompactBodyData(data_manager->host_data.cohesion_data, body_map, num_bodies);
+    CompactBodyData(data_manager->host_data.compliance_data, body_map, num_bodies);
+}
+
 void ChSystemParallelNSC::CalculateContactForces() {
     uint num_contacts = data_manager->num_rigid_contacts;
     DynamicVector<real>& Fc = data_manager->host_data.Fc;
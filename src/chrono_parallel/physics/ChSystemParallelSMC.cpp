@@ -102,6 +102,40 @@ void ChSystemParallelSMC::UpdateMaterialSurfaceData(int index, ChBody* body) {
     }
 }
 
+void ChSystemParallelSMC::CompactMaterialSurfaceData(const custom_vector<uint>& body_map,
+                                                     const custom_vector<uint>& shape_map) {
+    host_container& host_data = data_manager->host_data;
+    uint num_bodies = data_manager->num_rigid_bodies;
+
+    CompactBodyData(host_data.mu, body_map, num_bodies);
+    CompactBodyData(host_data.cohesion_data, body_map, num_bodies);
+    CompactBodyData(host_data.adhesionMultDMT_data, body_map, num_bodies);
+    CompactBodyData(host_data.mass_rigid, body_map, num_bodies);
+    CompactBodyData(host_data.elastic_moduli, body_map, num_bodies);
+    CompactBodyData(host_data.cr, body_map, num_bodies);
+    CompactBodyData(host_data.smc_coeffs, body_map, num_bodies);
+
+    // The contact history of the remaining bodies is kept, with the IDs of the other body and
+    // of the two shapes in contact renumbered. Entries involving a removed body or shape are freed.
+    CompactBodyData(host_data.shear_neigh, body_map, num_bodies, max_shear);
+    CompactBodyData(host_data.shear_disp, body_map, num_bodies, max_shear);
+
+#pragma omp parallel for
+    for (int i = 0; i < (signed)host_data.shear_neigh.size(); i++) {
+        vec3& neigh = host_data.shear_neigh[i];
+        if (neigh.x == -1)
+            continue;
+
+        uint body = body_map[neigh.x];
+        uint shape1 = shape_map.empty() ? neigh.y : shape_map[neigh.y];
+        uint shape2 = shape_map.empty() ? neigh.z : shape_map[neigh.z];
+        if (body == UINT_MAX || shape1 == UINT_MAX || shape2 == UINT_MAX)
+            neigh = vec3(-1, -1, -1);
+        else
+            neigh = vec3((int)body, (int)shape1, (int)shape2);
+    }
+}
+
 void ChSystemParallelSMC::Setup() {
     // First, invoke the base class method
     ChSystemParallel::Setup();
@@ -113,12 +113,19 @@ class CH_PARALLEL_API ChIterativeSolverParallelSMC : public ChIterativeSolverPar
     void ProcessContacts();
 
   private:
-    void host_CalcContactForces(custom_vector<int>& ext_body_id,
-                                custom_vector<real3>& ext_body_force,
-                                custom_vector<real3>& ext_body_torque,
+    void host_CalcCompositeMaterial();
+
+    void host_CalcContactForces(custom_vector<real3>& ct_force,
+                                custom_vector<real3>& ct_torque1,
+                                custom_vector<real3>& ct_torque2,
                                 custom_vector<vec2>& shape_pairs,
                                 custom_vector<char>& shear_touch);
 
+    uint host_ReduceContactForces(const custom_vector<real3>& ct_force,
+                                  const custom_vector<real3>& ct_torque1,
+                                  const custom_vector<real3>& ct_torque2,
+                                  custom_vector<int>& ct_body_id);
+
     void host_AddContactForces(uint ct_body_count, const custom_vector<int>& ct_body_id);
 
     void host_SetContactForcesMap(uint ct_body_count, const custom_vector<int>& ct_body_id);
@@ -22,64 +22,181 @@
 //
 // =============================================================================
 
+#include <algorithm>
+
 #include "chrono/physics/ChSystemSMC.h"
 #include "chrono_parallel/solver/ChIterativeSolverParallel.h"
+#include "chrono_parallel/math/sse.h"
 
-#include <thrust/sort.h>
-
-#if defined(CHRONO_OPENMP_ENABLED)
-#include <thrust/system/omp/execution_policy.h>
-#elif defined(CHRONO_TBB_ENABLED)
-#include <thrust/system/tbb/execution_policy.h>
+#if defined(USE_AVX)
+#include "chrono_parallel/math/simd_avx.h"
+#elif defined(USE_SSE)
+#include "chrono_parallel/math/simd_sse.h"
 #endif
 
-#if defined _WIN32
-#include <cstdint>
-#endif
+using namespace chrono;
 
+// -----------------------------------------------------------------------------
+// Calculate the composite material properties for the contact pair identified
+// by 'index'. The stiffness and damping coefficients are stored without the
+// factors which depend on the penetration depth delta_n:
+//   Hooke:        the coefficients are constant over the contact;
+//   Hertz:        kn and kt scale with sqrt(delta_n), gn and gt scale with
+//                 delta_n^(1/4) (material properties) or with sqrt(delta_n)
+//                 (user-specified coefficients);
+//   PlainCoulomb: as Hertz, with kt = gt = 0.
+// The adhesion force is fully evaluated here, based on the adhesion model.
+// -----------------------------------------------------------------------------
+void function_CalcCompositeMaterial(
+    int index,                                       // index of this contact pair
+    ChSystemSMC::ContactForceModel contact_model,    // contact force model
+    ChSystemSMC::AdhesionForceModel adhesion_model,  // contact force model
+    ChMaterialCompositionStrategy<real>* strategy,   // material composition strategy
+    bool use_mat_props,                              // flag specifying how coefficients are obtained
+    real char_vel,                                   // characteristic velocity (Hooke)
+    real* mass,                                      // body masses
+    real2* elastic_moduli,                           // Young's modulus (per body)
+    real* cr,                                        // coefficient of restitution (per body)
+    real4* smc_coeffs,                               // stiffness and damping coefficients (per body)
+    real* mu,                                        // coefficient of friction (per body)
+    real* adhesion,                                  // constant force (per body)
+    real* adhesionMultDMT,                           // Adhesion force multiplier (per body), in DMT model.
+    vec2* body_id,                                   // body IDs (per contact)
+    real* eff_radius,                                // effective contact radius (per contact)
+    real* mu_eff,                                    // [output] coefficient of friction (per contact)
+    real* adhesion_eff,                              // [output] adhesion force (per contact)
+    real* kn,                                        // [output] normal stiffness coefficient (per contact)
+    real* kt,                                        // [output] tangential stiffness coefficient (per contact)
+    real* gn,                                        // [output] normal damping coefficient (per contact)
+    real* gt                                         // [output] tangential damping coefficient (per contact)
+    ) {
+    // Identify the two bodies in contact.
+    int body1 = body_id[index].x;
+    int body2 = body_id[index].y;
 
-using namespace chrono;
+    real m_eff = mass[body1] * mass[body2] / (mass[body1] + mass[body2]);
+
+    mu_eff[index] = strategy->CombineFriction(mu[body1], mu[body2]);
+
+    switch (adhesion_model) {
+        case ChSystemSMC::AdhesionForceModel::Constant:
+            adhesion_eff[index] = strategy->CombineCohesion(adhesion[body1], adhesion[body2]);
+            break;
+        case ChSystemSMC::AdhesionForceModel::DMT:
+            // Derjaguin, Muller and Toporov (DMT) adhesion force
+            adhesion_eff[index] = strategy->CombineAdhesionMultiplier(adhesionMultDMT[body1], adhesionMultDMT[body2]) *
+                                  Sqrt(eff_radius[index]);
+            break;
+    }
+
+    if (use_mat_props) {
+        real Y1 = elastic_moduli[body1].x;
+        real Y2 = elastic_moduli[body2].x;
+        real nu1 = elastic_moduli[body1].y;
+        real nu2 = elastic_moduli[body2].y;
+        real inv_E = (1 - nu1 * nu1) / Y1 + (1 - nu2 * nu2) / Y2;
+        real inv_G = 2 * (2 - nu1) * (1 + nu1) / Y1 + 2 * (2 - nu2) * (1 + nu2) / Y2;
+
+        real E_eff = 1 / inv_E;
+        real G_eff = 1 / inv_G;
+        real cr_eff = strategy->CombineRestitution(cr[body1], cr[body2]);
+        real loge = (cr_eff < CH_MICROTOL) ? Log(CH_MICROTOL) : Log(cr_eff);
+
+        switch (contact_model) {
+            case ChSystemSMC::ContactForceModel::Hooke: {
+                real tmp_k = (16.0 / 15) * Sqrt(eff_radius[index]) * E_eff;
+                real v2 = char_vel * char_vel;
+                loge = (cr_eff > 1 - CH_MICROTOL) ? Log(1 - CH_MICROTOL) : loge;
+                real tmp_g = 1 + Pow(CH_C_PI / loge, 2);
+                kn[index] = tmp_k * Pow(m_eff * v2 / tmp_k, 1.0 / 5);
+                kt[index] = kn[index];
+                gn[index] = Sqrt(4 * m_eff * kn[index] / tmp_g);
+                gt[index] = gn[index];
+                break;
+            }
+            case ChSystemSMC::ContactForceModel::Hertz:
+            case ChSystemSMC::ContactForceModel::PlainCoulomb: {
+                // Sn = 2 * E_eff * sqrt(R * delta_n) and St = 8 * G_eff * sqrt(R * delta_n),
+                // where the effective radius R is not used by the PlainCoulomb model.
+                real sqrt_R = (contact_model == ChSystemSMC::ContactForceModel::Hertz) ? Sqrt(eff_radius[index]) : 1;
+                real Sn = 2 * E_eff * sqrt_R;
+                real St = 8 * G_eff * sqrt_R;
+                real beta = loge / Sqrt(loge * loge + CH_C_PI * CH_C_PI);
+                kn[index] = (2.0 / 3) * Sn;
+                gn[index] = -2 * Sqrt(5.0 / 6) * beta * Sqrt(Sn * m_eff);
+                if (contact_model == ChSystemSMC::ContactForceModel::Hertz) {
+                    kt[index] = St;
+                    gt[index] = -2 * Sqrt(5.0 / 6) * beta * Sqrt(St * m_eff);
+                } else {
+                    kt[index] = 0;
+                    gt[index] = 0;
+                }
+                break;
+            }
+        }
+    } else {
+        real user_kn = strategy->CombineStiffnessCoefficient(smc_coeffs[body1].x, smc_coeffs[body2].x);
+        real user_kt = strategy->CombineStiffnessCoefficient(smc_coeffs[body1].y, smc_coeffs[body2].y);
+        real user_gn = strategy->CombineDampingCoefficient(smc_coeffs[body1].z, smc_coeffs[body2].z);
+        real user_gt = strategy->CombineDampingCoefficient(smc_coeffs[body1].w, smc_coeffs[body2].w);
+
+        switch (contact_model) {
+            case ChSystemSMC::ContactForceModel::Hooke:
+                kn[index] = user_kn;
+                kt[index] = user_kt;
+                gn[index] = m_eff * user_gn;
+                gt[index] = m_eff * user_gt;
+                break;
+            case ChSystemSMC::ContactForceModel::Hertz:
+                kn[index] = eff_radius[index] * user_kn;
+                kt[index] = eff_radius[index] * user_kt;
+                gn[index] = eff_radius[index] * m_eff * user_gn;
+                gt[index] = eff_radius[index] * m_eff * user_gt;
+                break;
+            case ChSystemSMC::ContactForceModel::PlainCoulomb:
+                kn[index] = user_kn;
+                kt[index] = 0;
+                gn[index] = user_gn;
+                gt[index] = 0;
+                break;
+        }
+    }
+}
 
 // -----------------------------------------------------------------------------
 // Main worker function for calculating contact forces. Calculates the contact
-// force and torque for the contact pair identified by 'index' and stores them
-// in the 'extended' output arrays. The calculated force and torque vectors are
-// therefore duplicated in the output arrays, once for each body involved in the
-// contact (with opposite signs for the two bodies).
+// force and torques for the contact pair identified by 'index' and stores them
+// in the per-contact output arrays: 'ct_force' is the force acting on body2 (the
+// force on body1 has the opposite sign), while 'ct_torque1' and 'ct_torque2' are
+// the torques acting on the two bodies.
 // -----------------------------------------------------------------------------
 void function_CalcContactForces(
     int index,                                            // index of this contact pair
     ChSystemSMC::ContactForceModel contact_model,         // contact force model
-    ChSystemSMC::AdhesionForceModel adhesion_model,       // contact force model
     ChSystemSMC::TangentialDisplacementModel displ_mode,  // type of tangential displacement history
-    ChMaterialCompositionStrategy<real>* strategy,        // material composition strategy
     bool use_mat_props,                                   // flag specifying how coefficients are obtained
-    real char_vel,                                        // characteristic velocity (Hooke)
-    real min_slip_vel,                                    // threshold tangential velocity
     real dT,                                              // integration time step
-    real* mass,                                           // body masses
     real3* pos,                                           // body positions
     quaternion* rot,                                      // body orientations
     real* vel,                                            // body linear and angular velocities
-    real2* elastic_moduli,                                // Young's modulus (per body)
-    real* cr,                                             // coefficient of restitution (per body)
-    real4* smc_coeffs,                                    // stiffness and damping coefficients (per body)
-    real* mu,                                             // coefficient of friction (per body)
-    real* adhesion,                                       // constant force (per body)
-    real* adhesionMultDMT,                                // Adhesion force multiplier (per body), in DMT model.
+    real* mu_eff,                                         // coefficient of friction (per contact)
+    real* adhesion_eff,                                   // adhesion force (per contact)
+    real* kn_coef,                                        // normal stiffness coefficient (per contact)
+    real* kt_coef,                                        // tangential stiffness coefficient (per contact)
+    real* gn_coef,                                        // normal damping coefficient (per contact)
+    real* gt_coef,                                        // tangential damping coefficient (per contact)
     vec2* body_id,                                        // body IDs (per contact)
     vec2* shape_id,                                       // shape IDs (per contact)
     real3* pt1,                                           // point on shape 1 (per contact)
     real3* pt2,                                           // point on shape 2 (per contact)
     real3* normal,                                        // contact normal (per contact)
     real* depth,                                          // penetration depth (per contact)
-    real* eff_radius,                                     // effective contact radius (per contact)
-    vec3* shear_neigh,      // neighbor list of contacting bodies and shapes (max_shear per body)
-    char* shear_touch,      // flag if contact in neighbor list is persistent (max_shear per body)
-    real3* shear_disp,      // accumulated shear displacement for each neighbor (max_shear per body)
-    int* ext_body_id,       // [output] body IDs (two per contact)
-    real3* ext_body_force,  // [output] body force (two per contact)
-    real3* ext_body_torque  // [output] body torque (two per contact)
+    vec3* shear_neigh,   // neighbor list of contacting bodies and shapes (max_shear per body)
+    char* shear_touch,   // flag if contact in neighbor list is persistent (max_shear per body)
+    real3* shear_disp,   // accumulated shear displacement for each neighbor (max_shear per body)
+    real3* ct_force,     // [output] force on body2 (per contact)
+    real3* ct_torque1,   // [output] torque on body1 (per contact)
+    real3* ct_torque2    // [output] torque on body2 (per contact)
     ) {
     // Identify the two bodies in contact.
     int body1 = body_id[index].x;
@@ -87,12 +204,9 @@ void function_CalcContactForces(
 
     // If the two contact shapes are actually separated, set zero forces and torques.
     if (depth[index] >= 0) {
-        ext_body_id[2 * index] = body1;
-        ext_body_id[2 * index + 1] = body2;
-        ext_body_force[2 * index] = real3(0);
-        ext_body_force[2 * index + 1] = real3(0);
-        ext_body_torque[2 * index] = real3(0);
-        ext_body_torque[2 * index + 1] = real3(0);
+        ct_force[index] = real3(0);
+        ct_torque1[index] = real3(0);
+        ct_torque2[index] = real3(0);
 
         return;
     }
@@ -125,52 +239,31 @@ void function_CalcContactForces(
     real3 relvel_t = relvel - relvel_n;
     real relvel_t_mag = Length(relvel_t);
 
-    // Calculate composite material properties
-    // ---------------------------------------
-
-    real m_eff = mass[body1] * mass[body2] / (mass[body1] + mass[body2]);
-
-    real mu_eff = strategy->CombineFriction(mu[body1], mu[body2]);
-    real adhesion_eff = strategy->CombineCohesion(adhesion[body1], adhesion[body2]);
-    real adhesionMultDMT_eff = strategy->CombineAdhesionMultiplier(adhesionMultDMT[body1], adhesionMultDMT[body2]);
-
-    real E_eff, G_eff, cr_eff;
-    real user_kn, user_kt, user_gn, user_gt;
-
-    if (use_mat_props) {
-        real Y1 = elastic_moduli[body1].x;
-        real Y2 = elastic_moduli[body2].x;
-        real nu1 = elastic_moduli[body1].y;
-        real nu2 = elastic_moduli[body2].y;
-        real inv_E = (1 - nu1 * nu1) / Y1 + (1 - nu2 * nu2) / Y2;
-        real inv_G = 2 * (2 - nu1) * (1 + nu1) / Y1 + 2 * (2 - nu2) * (1 + nu2) / Y2;
-
-        E_eff = 1 / inv_E;
-        G_eff = 1 / inv_G;
-        cr_eff = strategy->CombineRestitution(cr[body1], cr[body2]);
-    } else {
-        user_kn = strategy->CombineStiffnessCoefficient(smc_coeffs[body1].x, smc_coeffs[body2].x);
-        user_kt = strategy->CombineStiffnessCoefficient(smc_coeffs[body1].y, smc_coeffs[body2].y);
-        user_gn = strategy->CombineDampingCoefficient(smc_coeffs[body1].z, smc_coeffs[body2].z);
-        user_gt = strategy->CombineDampingCoefficient(smc_coeffs[body1].w, smc_coeffs[body2].w);
-    }
-
     // Contact force
     // -------------
 
     // All models use the following formulas for normal and tangential forces:
     //     Fn = kn * delta_n - gn * v_n
     //     Ft = kt * delta_t - gt * v_t
-    // The stiffness and damping coefficients are obtained differently, based
-    // on the force model and on how coefficients are specified.
-    real kn;
-    real kt;
-    real gn;
-    real gt;
-
+    // The stiffness and damping coefficients are obtained from the composite
+    // material properties, scaled based on the force model.
     real delta_n = -depth[index];
     real3 delta_t = real3(0);
 
+    real kn = kn_coef[index];
+    real kt = kt_coef[index];
+    real gn = gn_coef[index];
+    real gt = gt_coef[index];
+
+    if (contact_model != ChSystemSMC::ContactForceModel::Hooke) {
+        real sqrt_delta_n = Sqrt(delta_n);
+        real g_scale = use_mat_props ? Sqrt(sqrt_delta_n) : sqrt_delta_n;
+        kn *= sqrt_delta_n;
+        kt *= sqrt_delta_n;
+        gn *= g_scale;
+        gt *= g_scale;
+    }
+
     int i;
     int contact_id;
     int shear_body1;
@@ -243,95 +336,21 @@ void function_CalcContactForces(
         }
     }
 
-    switch (contact_model) {
-        case ChSystemSMC::ContactForceModel::Hooke:
-            if (use_mat_props) {
-                real tmp_k = (16.0 / 15) * Sqrt(eff_radius[index]) * E_eff;
-                real v2 = char_vel * char_vel;
-                real loge = (cr_eff < CH_MICROTOL) ? Log(CH_MICROTOL) : Log(cr_eff);
-                loge = (cr_eff > 1 - CH_MICROTOL) ? Log(1 - CH_MICROTOL) : loge;
-                real tmp_g = 1 + Pow(CH_C_PI / loge, 2);
-                kn = tmp_k * Pow(m_eff * v2 / tmp_k, 1.0 / 5);
-                kt = kn;
-                gn = Sqrt(4 * m_eff * kn / tmp_g);
-                gt = gn;
-            } else {
-                kn = user_kn;
-                kt = user_kt;
-                gn = m_eff * user_gn;
-                gt = m_eff * user_gt;
-            }
-
-            break;
-
-        case ChSystemSMC::ContactForceModel::Hertz:
-            if (use_mat_props) {
-                real sqrt_Rd = Sqrt(eff_radius[index] * delta_n);
-                real Sn = 2 * E_eff * sqrt_Rd;
-                real St = 8 * G_eff * sqrt_Rd;
-                real loge = (cr_eff < CH_MICROTOL) ? Log(CH_MICROTOL) : Log(cr_eff);
-                real beta = loge / Sqrt(loge * loge + CH_C_PI * CH_C_PI);
-                kn = (2.0 / 3) * Sn;
-                kt = St;
-                gn = -2 * Sqrt(5.0 / 6) * beta * Sqrt(Sn * m_eff);
-                gt = -2 * Sqrt(5.0 / 6) * beta * Sqrt(St * m_eff);
-            } else {
-                real tmp = eff_radius[index] * Sqrt(delta_n);
-                kn = tmp * user_kn;
-                kt = tmp * user_kt;
-                gn = tmp * m_eff * user_gn;
-                gt = tmp * m_eff * user_gt;
-            }
+    if (contact_model == ChSystemSMC::ContactForceModel::PlainCoulomb) {
+        real forceN_mag = kn * delta_n - gn * relvel_n_mag;
+        if (forceN_mag < 0)
+            forceN_mag = 0;
+        real forceT_mag = mu_eff[index] * Tanh(5.0 * relvel_t_mag) * forceN_mag;
+        forceN_mag -= adhesion_eff[index];
+        real3 force = forceN_mag * normal[index];
+        if (relvel_t_mag >= (real)1e-4)
+            force -= (forceT_mag / relvel_t_mag) * relvel_t;
 
-            break;
+        ct_force[index] = force;
+        ct_torque1[index] = -Cross(pt1_loc, RotateT(force, rot[body1]));
+        ct_torque2[index] = Cross(pt2_loc, RotateT(force, rot[body2]));
 
-        case ChSystemSMC::ContactForceModel::PlainCoulomb:
-            if (use_mat_props) {
-                real sqrt_Rd = Sqrt(delta_n);
-                real Sn = 2 * E_eff * sqrt_Rd;
-                real St = 8 * G_eff * sqrt_Rd;
-                real loge = (cr_eff < CH_MICROTOL) ? Log(CH_MICROTOL) : Log(cr_eff);
-                real beta = loge / Sqrt(loge * loge + CH_C_PI * CH_C_PI);
-                kn = (2.0 / 3) * Sn;
-                gn = -2 * Sqrt(5.0 / 6) * beta * Sqrt(Sn * m_eff);
-            } else {
-                real tmp = Sqrt(delta_n);
-                kn = tmp * user_kn;
-                gn = tmp * user_gn;
-            }
-
-            kt = 0;
-            gt = 0;
-
-            {
-                real forceN_mag = kn * delta_n - gn * relvel_n_mag;
-                if (forceN_mag < 0)
-                    forceN_mag = 0;
-                real forceT_mag = mu_eff * Tanh(5.0 * relvel_t_mag) * forceN_mag;
-                switch (adhesion_model) {
-                    case ChSystemSMC::AdhesionForceModel::Constant:
-                        forceN_mag -= adhesion_eff;
-                        break;
-                    case ChSystemSMC::AdhesionForceModel::DMT:
-                        forceN_mag -= adhesionMultDMT_eff * Sqrt(eff_radius[index]);
-                        break;
-                }
-                real3 force = forceN_mag * normal[index];
-                if (relvel_t_mag >= (real)1e-4)
-                    force -= (forceT_mag / relvel_t_mag) * relvel_t;
-
-                real3 torque1_loc = Cross(pt1_loc, RotateT(force, rot[body1]));
-                real3 torque2_loc = Cross(pt2_loc, RotateT(force, rot[body2]));
-
-                ext_body_id[2 * index] = body1;
-                ext_body_id[2 * index + 1] = body2;
-                ext_body_force[2 * index] = -force;
-                ext_body_force[2 * index + 1] = force;
-                ext_body_torque[2 * index] = -torque1_loc;
-                ext_body_torque[2 * index + 1] = torque2_loc;
-            }
-
-            return;
+        return;
     }
 
     // Calculate the the normal and tangential contact forces.
@@ -357,16 +376,7 @@ void function_CalcContactForces(
     }
 
     // Include adhesion force.
-    switch (adhesion_model) {
-        case ChSystemSMC::AdhesionForceModel::Constant:
-            // (This is a very simple model, which can perhaps be improved later.)
-            forceN_mag -= adhesion_eff;
-            break;
-        case ChSystemSMC::AdhesionForceModel::DMT:
-            // Derjaguin, Muller and Toporov (DMT) adhesion force,
-            forceN_mag -= adhesionMultDMT_eff * Sqrt(eff_radius[index]);
-            break;
-    }
+    forceN_mag -= adhesion_eff[index];
 
     // Apply Coulomb friction law.
     // We must enforce force_T_mag <= mu_eff * |forceN_mag|.
@@ -379,7 +389,7 @@ void function_CalcContactForces(
     //  real forceT_mag = Length(forceT_stiff + forceT_damp);  // This seems correct
     real forceT_stiff_mag = Length(forceT_stiff);  // This is what LAMMPS/LIGGGHTS does
     real delta_t_mag = Length(delta_t);
-    real forceT_slide = mu_eff * Abs(forceN_mag);
+    real forceT_slide = mu_eff[index] * Abs(forceN_mag);
     if (forceT_stiff_mag > forceT_slide) {
         if (delta_t_mag > CH_MICROTOL) {
             real ratio = forceT_slide / forceT_stiff_mag;
@@ -414,45 +424,491 @@ void function_CalcContactForces(
     real3 torque1_loc = Cross(pt1_loc, RotateT(force, rot[body1]));
     real3 torque2_loc = Cross(pt2_loc, RotateT(force, rot[body2]));
 
-    // Store body forces and torques, duplicated for the two bodies.
-    ext_body_id[2 * index] = body1;
-    ext_body_id[2 * index + 1] = body2;
-    ext_body_force[2 * index] = -force;
-    ext_body_force[2 * index + 1] = force;
-    ext_body_torque[2 * index] = -torque1_loc;
-    ext_body_torque[2 * index + 1] = torque2_loc;
+    // Store the contact force and the body torques (with opposite signs for the two bodies).
+    ct_force[index] = force;
+    ct_torque1[index] = -torque1_loc;
+    ct_torque2[index] = torque2_loc;
 }
 
+#if defined(USE_AVX) || defined(USE_SSE)
+
 // -----------------------------------------------------------------------------
-// Calculate contact forces and torques for all contact pairs.
+// Vectorized version of function_CalcContactForces, for the Hooke and Hertz
+// models without contact history. The contacts are processed in batches: each
+// lane of a SIMD register holds the same quantity for a different contact. The
+// data of a batch is first gathered in structure-of-arrays form, then all the
+// calculations are done with SIMD arithmetic (using masks instead of branches),
+// and finally the results are scattered to the per-contact output arrays.
 // -----------------------------------------------------------------------------
 
-void ChIterativeSolverParallelSMC::host_CalcContactForces(custom_vector<int>& ext_body_id,
-                                                          custom_vector<real3>& ext_body_force,
-                                                          custom_vector<real3>& ext_body_torque,
-                                                          custom_vector<vec2>& shape_pairs,
-                                                          custom_vector<char>& shear_touch) {
+#if defined(USE_AVX)
+typedef __m256d vreal;
+static inline vreal VSet(real a) {
+    return _mm256_set1_pd(a);
+}
+static inline vreal VLoad(const real* a) {
+    return _mm256_loadu_pd(a);
+}
+static inline void VStore(real* a, vreal v) {
+    _mm256_storeu_pd(a, v);
+}
+static inline vreal VGreater(vreal a, vreal b) {
+    return _mm256_cmp_pd(a, b, _CMP_GT_OQ);
+}
+static inline vreal VSelect(vreal mask, vreal a, vreal b) {
+    return _mm256_blendv_pd(b, a, mask);
+}
+#else
+typedef __m128 vreal;
+static inline vreal VSet(real a) {
+    return _mm_set1_ps(a);
+}
+static inline vreal VLoad(const real* a) {
+    return _mm_loadu_ps(a);
+}
+static inline void VStore(real* a, vreal v) {
+    _mm_storeu_ps(a, v);
+}
+static inline vreal VGreater(vreal a, vreal b) {
+    return _mm_cmpgt_ps(a, b);
+}
+static inline vreal VSelect(vreal mask, vreal a, vreal b) {
+    return _mm_or_ps(_mm_and_ps(mask, a), _mm_andnot_ps(mask, b));
+}
+#endif
+
+// Number of contacts in a batch
+static const int batch_size = sizeof(vreal) / sizeof(real);
+
+// Batch of 3D vectors and of quaternions
+struct vreal3 {
+    vreal x, y, z;
+};
+struct vquat {
+    vreal w, x, y, z;
+};
+
+static inline vreal3 VAdd(const vreal3& a, const vreal3& b) {
+    return {simd::Add(a.x, b.x), simd::Add(a.y, b.y), simd::Add(a.z, b.z)};
+}
+static inline vreal3 VSub(const vreal3& a, const vreal3& b) {
+    return {simd::Sub(a.x, b.x), simd::Sub(a.y, b.y), simd::Sub(a.z, b.z)};
+}
+static inline vreal3 VMul(const vreal3& a, vreal b) {
+    return {simd::Mul(a.x, b), simd::Mul(a.y, b), simd::Mul(a.z, b)};
+}
+static inline vreal3 VSelect(vreal mask, const vreal3& a, const vreal3& b) {
+    return {VSelect(mask, a.x, b.x), VSelect(mask, a.y, b.y), VSelect(mask, a.z, b.z)};
+}
+static inline vreal VDot(const vreal3& a, const vreal3& b) {
+    return simd::Add(simd::Add(simd::Mul(a.x, b.x), simd::Mul(a.y, b.y)), simd::Mul(a.z, b.z));
+}
+static inline vreal3 VCross(const vreal3& a, const vreal3& b) {
+    return {simd::Sub(simd::Mul(a.y, b.z), simd::Mul(a.z, b.y)), simd::Sub(simd::Mul(a.z, b.x), simd::Mul(a.x, b.z)),
+            simd::Sub(simd::Mul(a.x, b.y), simd::Mul(a.y, b.x))};
+}
+
+// Same as Rotate(const real3&, const quaternion&): v + q.w * t + q.v x t, with t = 2 * q.v x v
+static inline vreal3 VRotate(const vreal3& v, const vquat& q) {
+    vreal3 qv = {q.x, q.y, q.z};
+    vreal3 t = VCross(qv, v);
+    t = VAdd(t, t);
+    return VAdd(VAdd(v, VMul(t, q.w)), VCross(qv, t));
+}
+
+// Same as RotateT(const real3&, const quaternion&)
+static inline vreal3 VRotateT(const vreal3& v, const vquat& q) {
+    vquat qc = {q.w, simd::Negate(q.x), simd::Negate(q.y), simd::Negate(q.z)};
+    return VRotate(v, qc);
+}
+
+// Layout of the gathered data of a batch (one row of 'batch_size' values per field)
+enum BatchField {
+    F_PT1 = 0,      // pt1 - pos[body1] (3 rows)
+    F_PT2 = 3,      // pt2 - pos[body2] (3 rows)
+    F_ROT1 = 6,     // rot[body1] (4 rows)
+    F_ROT2 = 10,    // rot[body2] (4 rows)
+    F_VEL1 = 14,    // linear velocity of body1 (3 rows)
+    F_OMG1 = 17,    // angular velocity of body1 (3 rows)
+    F_VEL2 = 20,    // linear velocity of body2 (3 rows)
+    F_OMG2 = 23,    // angular velocity of body2 (3 rows)
+    F_NORMAL = 26,  // contact normal (3 rows)
+    F_DELTA = 29,   // penetration (negated depth)
+    F_MU = 30,      // composite material (6 rows)
+    F_ADH = 31,
+    F_KN = 32,
+    F_KT = 33,
+    F_GN = 34,
+    F_GT = 35,
+    F_NUM = 36
+};
+
+static inline void Gather(real (*data)[batch_size], int field, int lane, const real3& v) {
+    data[field][lane] = v.x;
+    data[field + 1][lane] = v.y;
+    data[field + 2][lane] = v.z;
+}
+static inline void Gather(real (*data)[batch_size], int field, int lane, const quaternion& q) {
+    data[field][lane] = q.w;
+    data[field + 1][lane] = q.x;
+    data[field + 2][lane] = q.y;
+    data[field + 3][lane] = q.z;
+}
+static inline vreal3 Load3(real (*data)[batch_size], int field) {
+    return {VLoad(data[field]), VLoad(data[field + 1]), VLoad(data[field + 2])};
+}
+static inline vquat LoadQuat(real (*data)[batch_size], int field) {
+    return {VLoad(data[field]), VLoad(data[field + 1]), VLoad(data[field + 2]), VLoad(data[field + 3])};
+}
+static inline void Scatter(const vreal3& v, real3* out, int start) {
+    real x[batch_size], y[batch_size], z[batch_size];
+    VStore(x, v.x);
+    VStore(y, v.y);
+    VStore(z, v.z);
+    for (int lane = 0; lane < batch_size; lane++)
+        out[start + lane] = real3(x[lane], y[lane], z[lane]);
+}
+
+void function_CalcContactForcesBatch(
+    int start,                                            // index of the first contact pair in this batch
+    ChSystemSMC::ContactForceModel contact_model,         // contact force model (Hooke or Hertz)
+    ChSystemSMC::TangentialDisplacementModel displ_mode,  // type of tangential displacement (None or OneStep)
+    bool use_mat_props,                                   // flag specifying how coefficients are obtained
+    real dT,                                              // integration time step
+    real3* pos,                                           // body positions
+    quaternion* rot,                                      // body orientations
+    real* vel,                                            // body linear and angular velocities
+    real* mu_eff,                                         // coefficient of friction (per contact)
+    real* adhesion_eff,                                   // adhesion force (per contact)
+    real* kn_coef,                                        // normal stiffness coefficient (per contact)
+    real* kt_coef,                                        // tangential stiffness coefficient (per contact)
+    real* gn_coef,                                        // normal damping coefficient (per contact)
+    real* gt_coef,                                        // tangential damping coefficient (per contact)
+    vec2* body_id,                                        // body IDs (per contact)
+    real3* pt1,                                           // point on shape 1 (per contact)
+    real3* pt2,                                           // point on shape 2 (per contact)
+    real3* normal,                                        // contact normal (per contact)
+    real* depth,                                          // penetration depth (per contact)
+    real3* ct_force,                                      // [output] force on body2 (per contact)
+    real3* ct_torque1,                                    // [output] torque on body1 (per contact)
+    real3* ct_torque2                                     // [output] torque on body2 (per contact)
+    ) {
+    // Gather the data of the contacts in the batch
+    real data[F_NUM][batch_size];
+    for (int lane = 0; lane < batch_size; lane++) {
+        int index = start + lane;
+        int body1 = body_id[index].x;
+        int body2 = body_id[index].y;
+        Gather(data, F_PT1, lane, pt1[index] - pos[body1]);
+        Gather(data, F_PT2, lane, pt2[index] - pos[body2]);
+        Gather(data, F_ROT1, lane, rot[body1]);
+        Gather(data, F_ROT2, lane, rot[body2]);
+        Gather(data, F_VEL1, lane, real3(vel[body1 * 6 + 0], vel[body1 * 6 + 1], vel[body1 * 6 + 2]));
+        Gather(data, F_OMG1, lane, real3(vel[body1 * 6 + 3], vel[body1 * 6 + 4], vel[body1 * 6 + 5]));
+        Gather(data, F_VEL2, lane, real3(vel[body2 * 6 + 0], vel[body2 * 6 + 1], vel[body2 * 6 + 2]));
+        Gather(data, F_OMG2, lane, real3(vel[body2 * 6 + 3], vel[body2 * 6 + 4], vel[body2 * 6 + 5]));
+        Gather(data, F_NORMAL, lane, normal[index]);
+        data[F_DELTA][lane] = -depth[index];
+        data[F_MU][lane] = mu_eff[index];
+        data[F_ADH][lane] = adhesion_eff[index];
+        data[F_KN][lane] = kn_coef[index];
+        data[F_KT][lane] = kt_coef[index];
+        data[F_GN][lane] = gn_coef[index];
+        data[F_GT][lane] = gt_coef[index];
+    }
+
+    const vreal zero = VSet(0);
+    const vreal3 zero3 = {zero, zero, zero};
+
+    // Kinematic information (see function_CalcContactForces)
+    vquat q1 = LoadQuat(data, F_ROT1);
+    vquat q2 = LoadQuat(data, F_ROT2);
+    vreal3 pt1_loc = VRotateT(Load3(data, F_PT1), q1);
+    vreal3 pt2_loc = VRotateT(Load3(data, F_PT2), q2);
+
+    vreal3 vel1 = VAdd(Load3(data, F_VEL1), VRotate(VCross(Load3(data, F_OMG1), pt1_loc), q1));
+    vreal3 vel2 = VAdd(Load3(data, F_VEL2), VRotate(VCross(Load3(data, F_OMG2), pt2_loc), q2));
+
+    vreal3 n = Load3(data, F_NORMAL);
+    vreal3 relvel = VSub(vel2, vel1);
+    vreal relvel_n_mag = VDot(relvel, n);
+    vreal3 relvel_t = VSub(relvel, VMul(n, relvel_n_mag));
+
+    // Contacts with separated shapes are masked out (and the penetration is
+    // clamped to zero, so that the calculations below remain finite).
+    vreal delta_n = VLoad(data[F_DELTA]);
+    vreal active = VGreater(delta_n, zero);
+    delta_n = simd::Max(delta_n, zero);
+
+    // Stiffness and damping coefficients
+    vreal kn = VLoad(data[F_KN]);
+    vreal kt = VLoad(data[F_KT]);
+    vreal gn = VLoad(data[F_GN]);
+    vreal gt = VLoad(data[F_GT]);
+    if (contact_model == ChSystemSMC::ContactForceModel::Hertz) {
+        vreal sqrt_delta_n = simd::SquareRoot(delta_n);
+        vreal g_scale = use_mat_props ? simd::SquareRoot(sqrt_delta_n) : sqrt_delta_n;
+        kn = simd::Mul(kn, sqrt_delta_n);
+        kt = simd::Mul(kt, sqrt_delta_n);
+        gn = simd::Mul(gn, g_scale);
+        gt = simd::Mul(gt, g_scale);
+    }
+
+    vreal3 delta_t = zero3;
+    if (displ_mode == ChSystemSMC::TangentialDisplacementModel::OneStep)
+        delta_t = VMul(relvel_t, VSet(dT));
+
+    // Normal and tangential contact forces, with no force if the shapes are moving apart
+    vreal forceN_mag = simd::Sub(simd::Mul(kn, delta_n), simd::Mul(gn, relvel_n_mag));
+    vreal3 forceT_stiff = VMul(delta_t, kt);
+    vreal3 forceT_damp = VMul(relvel_t, gt);
+
+    vreal separating = VGreater(zero, forceN_mag);
+    forceN_mag = VSelect(separating, zero, forceN_mag);
+    forceT_stiff = VSelect(separating, zero3, forceT_stiff);
+    forceT_damp = VSelect(separating, zero3, forceT_damp);
+
+    // Adhesion force
+    forceN_mag = simd::Sub(forceN_mag, VLoad(data[F_ADH]));
+
+    // Coulomb friction law
+    vreal forceT_stiff_mag = simd::SquareRoot(VDot(forceT_stiff, forceT_stiff));
+    vreal delta_t_mag = simd::SquareRoot(VDot(delta_t, delta_t));
+    vreal forceT_slide = simd::Mul(VLoad(data[F_MU]), simd::Abs(forceN_mag));
+    vreal sliding = VGreater(forceT_stiff_mag, forceT_slide);
+    vreal ratio = VSelect(VGreater(delta_t_mag, VSet(CH_MICROTOL)), simd::Div(forceT_slide, forceT_stiff_mag), zero);
+    forceT_stiff = VMul(forceT_stiff, VSelect(sliding, ratio, VSet(1)));
+    forceT_damp = VSelect(sliding, zero3, forceT_damp);
+
+    // Accumulate normal and tangential forces
+    vreal3 force = VSub(VSub(VMul(n, forceN_mag), forceT_stiff), forceT_damp);
+    force = VSelect(active, force, zero3);
+
+    // Induced torques (in local frames), with opposite signs for the two bodies
+    vreal3 torque1_loc = VCross(VRotateT(force, q1), pt1_loc);
+    vreal3 torque2_loc = VCross(pt2_loc, VRotateT(force, q2));
+
+    Scatter(force, ct_force, start);
+    Scatter(torque1_loc, ct_torque1, start);
+    Scatter(torque2_loc, ct_torque2, start);
+}
+
+#endif
+
+// -----------------------------------------------------------------------------
+// Calculate the composite material properties for all contact pairs.
+// -----------------------------------------------------------------------------
+void ChIterativeSolverParallelSMC::host_CalcCompositeMaterial() {
+    uint num_contacts = data_manager->num_rigid_contacts;
+    data_manager->host_data.smc_mu.resize(num_contacts);
+    data_manager->host_data.smc_adhesion.resize(num_contacts);
+    data_manager->host_data.smc_kn.resize(num_contacts);
+    data_manager->host_data.smc_kt.resize(num_contacts);
+    data_manager->host_data.smc_gn.resize(num_contacts);
+    data_manager->host_data.smc_gt.resize(num_contacts);
+
 #pragma omp parallel for
-    for (int index = 0; index < (signed)data_manager->num_rigid_contacts; index++) {
-        function_CalcContactForces(
+    for (int index = 0; index < (signed)num_contacts; index++) {
+        function_CalcCompositeMaterial(
             index, data_manager->settings.solver.contact_force_model,
-            data_manager->settings.solver.adhesion_force_model, data_manager->settings.solver.tangential_displ_mode,
-            data_manager->composition_strategy.get(), data_manager->settings.solver.use_material_properties,
-            data_manager->settings.solver.characteristic_vel, data_manager->settings.solver.min_slip_vel,
-            data_manager->settings.step_size, data_manager->host_data.mass_rigid.data(),
-            data_manager->host_data.pos_rigid.data(), data_manager->host_data.rot_rigid.data(),
-            data_manager->host_data.v.data(), data_manager->host_data.elastic_moduli.data(),
+            data_manager->settings.solver.adhesion_force_model, data_manager->composition_strategy.get(),
+            data_manager->settings.solver.use_material_properties, data_manager->settings.solver.characteristic_vel,
+            data_manager->host_data.mass_rigid.data(), data_manager->host_data.elastic_moduli.data(),
             data_manager->host_data.cr.data(), data_manager->host_data.smc_coeffs.data(),
             data_manager->host_data.mu.data(), data_manager->host_data.cohesion_data.data(),
             data_manager->host_data.adhesionMultDMT_data.data(), data_manager->host_data.bids_rigid_rigid.data(),
-            shape_pairs.data(), data_manager->host_data.cpta_rigid_rigid.data(),
-            data_manager->host_data.cptb_rigid_rigid.data(), data_manager->host_data.norm_rigid_rigid.data(),
-            data_manager->host_data.dpth_rigid_rigid.data(), data_manager->host_data.erad_rigid_rigid.data(),
+            data_manager->host_data.erad_rigid_rigid.data(), data_manager->host_data.smc_mu.data(),
+            data_manager->host_data.smc_adhesion.data(), data_manager->host_data.smc_kn.data(),
+            data_manager->host_data.smc_kt.data(), data_manager->host_data.smc_gn.data(),
+            data_manager->host_data.smc_gt.data());
+    }
+}
+
+// -----------------------------------------------------------------------------
+// Calculate contact forces and torques for all contact pairs.
+// Without contact history, the Hooke and Hertz models are evaluated by the
+// vectorized kernel (if SIMD is enabled), except for the last incomplete batch.
+// -----------------------------------------------------------------------------
+void ChIterativeSolverParallelSMC::host_CalcContactForces(custom_vector<real3>& ct_force,
+                                                          custom_vector<real3>& ct_torque1,
+                                                          custom_vector<real3>& ct_torque2,
+                                                          custom_vector<vec2>& shape_pairs,
+                                                          custom_vector<char>& shear_touch) {
+    ChSystemSMC::ContactForceModel contact_model = data_manager->settings.solver.contact_force_model;
+    ChSystemSMC::TangentialDisplacementModel displ_mode = data_manager->settings.solver.tangential_displ_mode;
+    int num_contacts = (signed)data_manager->num_rigid_contacts;
+    int num_batched = 0;
+
+#if defined(USE_AVX) || defined(USE_SSE)
+    if (data_manager->settings.solver.use_simd_contact_forces &&
+        contact_model != ChSystemSMC::ContactForceModel::PlainCoulomb &&
+        displ_mode != ChSystemSMC::TangentialDisplacementModel::MultiStep) {
+        num_batched = num_contacts - num_contacts % batch_size;
+#pragma omp parallel for
+        for (int start = 0; start < num_batched; start += batch_size) {
+            function_CalcContactForcesBatch(
+                start, contact_model, displ_mode, data_manager->settings.solver.use_material_properties,
+                data_manager->settings.step_size, data_manager->host_data.pos_rigid.data(),
+                data_manager->host_data.rot_rigid.data(), data_manager->host_data.v.data(),
+                data_manager->host_data.smc_mu.data(), data_manager->host_data.smc_adhesion.data(),
+                data_manager->host_data.smc_kn.data(), data_manager->host_data.smc_kt.data(),
+                data_manager->host_data.smc_gn.data(), data_manager->host_data.smc_gt.data(),
+                data_manager->host_data.bids_rigid_rigid.data(), data_manager->host_data.cpta_rigid_rigid.data(),
+                data_manager->host_data.cptb_rigid_rigid.data(), data_manager->host_data.norm_rigid_rigid.data(),
+                data_manager->host_data.dpth_rigid_rigid.data(), ct_force.data(), ct_torque1.data(),
+                ct_torque2.data());
+        }
+    }
+#endif
+
+    auto calc_contact_force = [&](int index) {
+        function_CalcContactForces(
+            index, contact_model, displ_mode, data_manager->settings.solver.use_material_properties,
+            data_manager->settings.step_size, data_manager->host_data.pos_rigid.data(),
+            data_manager->host_data.rot_rigid.data(), data_manager->host_data.v.data(),
+            data_manager->host_data.smc_mu.data(), data_manager->host_data.smc_adhesion.data(),
+            data_manager->host_data.smc_kn.data(), data_manager->host_data.smc_kt.data(),
+            data_manager->host_data.smc_gn.data(), data_manager->host_data.smc_gt.data(),
+            data_manager->host_data.bids_rigid_rigid.data(), shape_pairs.data(),
+            data_manager->host_data.cpta_rigid_rigid.data(), data_manager->host_data.cptb_rigid_rigid.data(),
+            data_manager->host_data.norm_rigid_rigid.data(), data_manager->host_data.dpth_rigid_rigid.data(),
             data_manager->host_data.shear_neigh.data(), shear_touch.data(), data_manager->host_data.shear_disp.data(),
-            ext_body_id.data(), ext_body_force.data(), ext_body_torque.data());
+            ct_force.data(), ct_torque1.data(), ct_torque2.data());
+    };
+
+    // With contact history, the first contact processed claims a free slot in the
+    // history of its body. In deterministic mode, the contacts are grouped by the
+    // body owning their history, in increasing order of the contact index, and the
+    // contacts of each body are processed in this order.
+    if (data_manager->settings.deterministic && displ_mode == ChSystemSMC::TangentialDisplacementModel::MultiStep) {
+        int num_bodies = (signed)data_manager->num_rigid_bodies;
+        const custom_vector<vec2>& body_id = data_manager->host_data.bids_rigid_rigid;
+
+        custom_vector<int> ct_offset(num_bodies + 1, 0);
+        custom_vector<int> ct_index(num_contacts);
+        for (int index = 0; index < num_contacts; index++)
+            ct_offset[Max(body_id[index].x, body_id[index].y) + 1]++;
+        for (int i = 0; i < num_bodies; i++)
+            ct_offset[i + 1] += ct_offset[i];
+        custom_vector<int> ct_next(ct_offset.begin(), ct_offset.end() - 1);
+        for (int index = 0; index < num_contacts; index++)
+            ct_index[ct_next[Max(body_id[index].x, body_id[index].y)]++] = index;
+
+#pragma omp parallel for
+        for (int i = 0; i < num_bodies; i++) {
+            for (int k = ct_offset[i]; k < ct_offset[i + 1]; k++)
+                calc_contact_force(ct_index[k]);
+        }
+        return;
+    }
+
+#pragma omp parallel for
+    for (int index = num_batched; index < num_contacts; index++) {
+        calc_contact_force(index);
     }
 }
 
+// -----------------------------------------------------------------------------
+// Accumulate the contact forces and torques for all bodies that are involved
+// in at least one contact (segmented reduction). The contacts of each body are
+// first grouped with a counting sort, in increasing order of the contact index,
+// then each group is summed independently. The results therefore do not depend
+// on the number of threads. Returns the number of bodies in contact.
+//
+// The counting sort is split in contiguous chunks of contacts, one per thread:
+// each chunk counts the contacts of each body, a scan over the chunks and the
+// bodies gives the position of the first contact of each (chunk, body) pair,
+// then each chunk scatters its contacts. The chunk count is limited so that the
+// per-chunk counters do not outnumber the contacts.
+// -----------------------------------------------------------------------------
+uint ChIterativeSolverParallelSMC::host_ReduceContactForces(const custom_vector<real3>& ct_force,
+                                                            const custom_vector<real3>& ct_torque1,
+                                                            const custom_vector<real3>& ct_torque2,
+                                                            custom_vector<int>& ct_body_id) {
+    int num_bodies = (signed)data_manager->num_rigid_bodies;
+    int num_contacts = (signed)data_manager->num_rigid_contacts;
+    const custom_vector<vec2>& body_id = data_manager->host_data.bids_rigid_rigid;
+
+    int num_chunks = std::min(CHOMPfunctions::GetMaxThreads(), 2 * num_contacts / std::max(num_bodies, 1));
+    num_chunks = std::max(num_chunks, 1);
+    int chunk_size = (num_contacts + num_chunks - 1) / num_chunks;
+
+    // Count the contacts of each body in each chunk.
+    custom_vector<int> ct_count(num_chunks * num_bodies, 0);
+#pragma omp parallel for
+    for (int chunk = 0; chunk < num_chunks; chunk++) {
+        int* count = ct_count.data() + chunk * num_bodies;
+        int end = std::min(num_contacts, (chunk + 1) * chunk_size);
+        for (int index = chunk * chunk_size; index < end; index++) {
+            count[body_id[index].x]++;
+            count[body_id[index].y]++;
+        }
+    }
+
+    // Scan the counts of each body over the chunks, then over the bodies. List
+    // the bodies in contact and calculate the offsets of their groups of contacts.
+    custom_vector<int> ct_offset(num_bodies + 1, 0);
+#pragma omp parallel for
+    for (int body = 0; body < num_bodies; body++) {
+        int total = 0;
+        for (int chunk = 0; chunk < num_chunks; chunk++) {
+            int count = ct_count[chunk * num_bodies + body];
+            ct_count[chunk * num_bodies + body] = total;
+            total += count;
+        }
+        ct_offset[body + 1] = total;
+    }
+
+    uint ct_body_count = 0;
+    for (int body = 0; body < num_bodies; body++) {
+        if (ct_offset[body + 1] > 0)
+            ct_body_id[ct_body_count++] = body;
+        ct_offset[body + 1] += ct_offset[body];
+    }
+
+    // Group the contacts by body. An entry 2 * index refers to the first body
+    // of the contact pair, an entry 2 * index + 1 to the second body.
+    custom_vector<int> ct_entry(2 * num_contacts);
+#pragma omp parallel for
+    for (int chunk = 0; chunk < num_chunks; chunk++) {
+        int* next = ct_count.data() + chunk * num_bodies;
+        int end = std::min(num_contacts, (chunk + 1) * chunk_size);
+        for (int index = chunk * chunk_size; index < end; index++) {
+            int body1 = body_id[index].x;
+            int body2 = body_id[index].y;
+            ct_entry[ct_offset[body1] + next[body1]++] = 2 * index;
+            ct_entry[ct_offset[body2] + next[body2]++] = 2 * index + 1;
+        }
+    }
+
+    custom_vector<real3>& ct_body_force = data_manager->host_data.ct_body_force;
+    custom_vector<real3>& ct_body_torque = data_manager->host_data.ct_body_torque;
+
+    ct_body_force.resize(ct_body_count);
+    ct_body_torque.resize(ct_body_count);
+
+#pragma omp parallel for
+    for (int i = 0; i < (signed)ct_body_count; i++) {
+        int body = ct_body_id[i];
+        real3 force(0);
+        real3 torque(0);
+        for (int k = ct_offset[body]; k < ct_offset[body + 1]; k++) {
+            int index = ct_entry[k] / 2;
+            if (ct_entry[k] % 2 == 0) {
+                force -= ct_force[index];
+                torque += ct_torque1[index];
+            } else {
+                force += ct_force[index];
+                torque += ct_torque2[index];
+            }
+        }
+        ct_body_force[i] = force;
+        ct_body_torque[i] = torque;
+    }
+
+    return ct_body_count;
+}
+
 // -----------------------------------------------------------------------------
 // Include contact impulses (linear and rotational) for all bodies that are
 // involved in at least one contact. For each such body, the corresponding
@@ -488,15 +944,6 @@ void ChIterativeSolverParallelSMC::host_SetContactForcesMap(uint ct_body_count,
     }
 }
 
-// Binary operation for adding two-object tuples
-struct sum_tuples {
-    thrust::tuple<real3, real3> operator()(const thrust::tuple<real3, real3>& a,
-                                           const thrust::tuple<real3, real3>& b) const {
-        return thrust::tuple<real3, real3>(thrust::get<0>(a) + thrust::get<0>(b),
-                                           thrust::get<1>(a) + thrust::get<1>(b));
-    }
-};
-
 // -----------------------------------------------------------------------------
 // Process contact information reported by the narrowphase collision detection,
 // generate contact forces, and update the (linear and rotational) impulses for
@@ -504,12 +951,12 @@ struct sum_tuples {
 // -----------------------------------------------------------------------------
 void ChIterativeSolverParallelSMC::ProcessContacts() {
     // 1. Calculate contact forces and torques - per contact basis
-    //    For each pair of contact shapes that overlap, we calculate and store the
-    //    IDs of the two corresponding bodies and the resulting contact forces and
-    //    torques on the two bodies.
-    custom_vector<int> ext_body_id(2 * data_manager->num_rigid_contacts);
-    custom_vector<real3> ext_body_force(2 * data_manager->num_rigid_contacts);
-    custom_vector<real3> ext_body_torque(2 * data_manager->num_rigid_contacts);
+    //    For each pair of contact shapes that overlap, we calculate the composite
+    //    material properties, then the contact force and the resulting torques on
+    //    the two bodies.
+    custom_vector<real3> ct_force(data_manager->num_rigid_contacts);
+    custom_vector<real3> ct_torque1(data_manager->num_rigid_contacts);
+    custom_vector<real3> ct_torque2(data_manager->num_rigid_contacts);
     custom_vector<vec2> shape_pairs;
     custom_vector<char> shear_touch;
 
@@ -525,7 +972,8 @@ void ChIterativeSolverParallelSMC::ProcessContacts() {
         }
     }
 
-    host_CalcContactForces(ext_body_id, ext_body_force, ext_body_torque, shape_pairs, shear_touch);
+    host_CalcCompositeMaterial();
+    host_CalcContactForces(ct_force, ct_torque1, ct_torque2, shape_pairs, shear_touch);
 
     if (data_manager->settings.solver.tangential_displ_mode == ChSystemSMC::TangentialDisplacementModel::MultiStep) {
 #pragma omp parallel for
@@ -542,36 +990,8 @@ void ChIterativeSolverParallelSMC::ProcessContacts() {
     //    involved in at least one contact, by reducing the contact forces and
     //    torques from all contacts these bodies are involved in. The number of
     //    bodies that experience at least one contact is 'ct_body_count'.
-    thrust::sort_by_key(THRUST_PAR ext_body_id.begin(), ext_body_id.end(),
-                        thrust::make_zip_iterator(thrust::make_tuple(ext_body_force.begin(), ext_body_torque.begin())));
-
     custom_vector<int> ct_body_id(data_manager->num_rigid_bodies);
-    custom_vector<real3>& ct_body_force = data_manager->host_data.ct_body_force;
-    custom_vector<real3>& ct_body_torque = data_manager->host_data.ct_body_torque;
-
-    ct_body_force.resize(data_manager->num_rigid_bodies);
-    ct_body_torque.resize(data_manager->num_rigid_bodies);
-
-    // Reduce contact forces from all contacts and count bodies currently involved
-    // in contact. We do this simultaneously for contact forces and torques, using
-    // zip iterators.
-    uint ct_body_count =
-        (uint)(thrust::reduce_by_key(
-            THRUST_PAR ext_body_id.begin(), ext_body_id.end(),
-            thrust::make_zip_iterator(thrust::make_tuple(ext_body_force.begin(), ext_body_torque.begin())),
-            ct_body_id.begin(),
-            thrust::make_zip_iterator(thrust::make_tuple(ct_body_force.begin(), ct_body_torque.begin())),
-            #if defined _WIN32
-            // Windows compilers require an explicit-width type
-                thrust::equal_to<int64_t>(), sum_tuples()
-            #else
-                thrust::equal_to<int>(), sum_tuples()
-            #endif
-            ).first -
-        ct_body_id.begin());
-
-    ct_body_force.resize(ct_body_count);
-    ct_body_torque.resize(ct_body_count);
+    uint ct_body_count = host_ReduceContactForces(ct_force, ct_torque1, ct_torque2, ct_body_id);
 
     // 3. Add contact forces and torques to existing forces (impulses):
     //    For all bodies involved in a contact, update the body forces and torques
@@ -12,16 +12,208 @@
 // Authors: Hammad Mazhar
 // =============================================================================
 
+#include <algorithm>
+
 #include "chrono_parallel/solver/ChSolverParallel.h"
 
 using namespace chrono;
 
 ChShurProduct::ChShurProduct() {
     data_manager = 0;
+    use_blocks = false;
+    num_block_rows = 0;
+}
+
+// Number of rows of a rigid-rigid contact for the given solver mode.
+static uint NumContactRows(SolverMode mode) {
+    switch (mode) {
+        case SolverMode::NORMAL:
+            return 1;
+        case SolverMode::SLIDING:
+            return 3;
+        case SolverMode::SPINNING:
+            return 6;
+        default:
+            return 0;
+    }
+}
+
+// Row of D^T for the j-th constraint of the rigid-rigid contact with given index:
+// normal, then the two sliding rows, then the three spinning/rolling rows.
+static inline uint ContactRow(uint num_contacts, uint index, uint j) {
+    if (j == 0)
+        return index;
+    if (j < 3)
+        return num_contacts + index * 2 + (j - 1);
+    return 3 * num_contacts + index * 3 + (j - 3);
+}
+
+void ChShurProduct::Setup(ChParallelDataManager* data_container_) {
+    data_manager = data_container_;
+
+    uint num_constraints = data_manager->num_constraints;
+    uint num_rigid_constraints = data_manager->num_unilaterals + data_manager->num_bilaterals;
+
+    use_blocks = data_manager->settings.solver.use_shur_blocks && !data_manager->settings.solver.compute_N &&
+                 data_manager->num_rigid_contacts > 0 && num_constraints == num_rigid_constraints &&
+                 NumContactRows(data_manager->settings.solver.solver_mode) > 0;
+
+    if (use_blocks) {
+        data_manager->system_timer.start("ShurProduct");
+        SetupBlocks();
+        data_manager->system_timer.stop("ShurProduct");
+    }
+}
+
+// Extract the blocks of D and M^-1 D for all rigid-rigid contacts. For contact i, row j of the contact and
+// body s of the pair (0 or 1), the 6 entries of the block start at ((i * num_block_rows + j) * 2 + s) * 6.
+// The entries of M^-1 D are calculated from the 6x6 block of M^-1 of the body, so that the product can be
+// evaluated without accessing the sparse matrices. The contacts of each body are also grouped, to accumulate
+// M^-1 D x body by body.
+void ChShurProduct::SetupBlocks() {
+    uint num_contacts = data_manager->num_rigid_contacts;
+    uint num_bodies = data_manager->num_rigid_bodies;
+    const CompressedMatrix<real>& D_T = data_manager->host_data.D_T;
+    const CompressedMatrix<real>& M_inv = data_manager->host_data.M_inv;
+    const vec2* ids = data_manager->host_data.bids_rigid_rigid.data();
+
+    num_block_rows = NumContactRows(data_manager->settings.solver.solver_mode);
+    D_blocks.assign(num_contacts * num_block_rows * 12, 0);
+    M_invD_blocks.assign(num_contacts * num_block_rows * 12, 0);
+
+#pragma omp parallel for
+    for (int index = 0; index < (signed)num_contacts; index++) {
+        int body[2] = {ids[index].x, ids[index].y};
+
+        // Blocks of M^-1 for the two bodies
+        real M_inv_body[2][36] = {};
+        for (int s = 0; s < 2; s++) {
+            for (int d = 0; d < 6; d++) {
+                for (auto it = M_inv.begin(body[s] * 6 + d); it != M_inv.end(body[s] * 6 + d); ++it) {
+                    int col = (int)it->index() - body[s] * 6;
+                    if (col >= 0 && col < 6)
+                        M_inv_body[s][d * 6 + col] = it->value();
+                }
+            }
+        }
+
+        for (uint j = 0; j < num_block_rows; j++) {
+            uint row = ContactRow(num_contacts, index, j);
+            real* D_row = &D_blocks[(index * num_block_rows + j) * 12];
+            real* M_invD_row = &M_invD_blocks[(index * num_block_rows + j) * 12];
+
+            for (auto it = D_T.begin(row); it != D_T.end(row); ++it) {
+                int col = (int)it->index();
+                if (col / 6 == body[0])
+                    D_row[col % 6] = it->value();
+                else if (col / 6 == body[1])
+                    D_row[6 + col % 6] = it->value();
+            }
+
+            for (int s = 0; s < 2; s++) {
+                for (int d = 0; d < 6; d++) {
+                    real sum = 0;
+                    for (int e = 0; e < 6; e++)
+                        sum += M_inv_body[s][d * 6 + e] * D_row[s * 6 + e];
+                    M_invD_row[s * 6 + d] = sum;
+                }
+            }
+        }
+    }
+
+    // Group the contacts by body (counting sort, in increasing order of the contact index)
+    body_offset.assign(num_bodies + 1, 0);
+    for (uint index = 0; index < num_contacts; index++) {
+        body_offset[ids[index].x + 1]++;
+        body_offset[ids[index].y + 1]++;
+    }
+    for (uint body = 0; body < num_bodies; body++)
+        body_offset[body + 1] += body_offset[body];
+
+    body_contacts.resize(2 * num_contacts);
+    custom_vector<int> next(body_offset.begin(), body_offset.end() - 1);
+    for (uint index = 0; index < num_contacts; index++) {
+        body_contacts[next[ids[index].x]++] = 2 * index;
+        body_contacts[next[ids[index].y]++] = 2 * index + 1;
+    }
 }
+
+// Shur product using the blocks of the rigid-rigid contacts. Only the rows of the current local solver
+// mode are used. The product M^-1 D x is accumulated body by body (first pass), then the contact rows of
+// D^T M^-1 D x are calculated contact by contact (second pass). The bilateral constraints are still
+// treated with the sparse matrices.
+void ChShurProduct::BlockProduct(const DynamicVector<real>& x, DynamicVector<real>& output) {
+    const DynamicVector<real>& E = data_manager->host_data.E;
+
+    uint num_contacts = data_manager->num_rigid_contacts;
+    uint num_bodies = data_manager->num_rigid_bodies;
+    uint num_unilaterals = data_manager->num_unilaterals;
+    uint num_bilaterals = data_manager->num_bilaterals;
+    uint num_rows = std::min(NumContactRows(data_manager->settings.solver.local_solver_mode), num_block_rows);
+    uint stride = num_block_rows * 12;
+
+    output.reset();
+
+    ConstSubVectorType x_b = subvector(x, num_unilaterals, num_bilaterals);
+
+    if (num_bilaterals > 0) {
+        MinvDx = _MINVDB_ * x_b;
+    } else {
+        MinvDx.resize(num_bodies * 6 + data_manager->num_shafts);
+        MinvDx.reset();
+    }
+
+    if (num_rows > 0) {
+#pragma omp parallel for
+        for (int body = 0; body < (signed)num_bodies; body++) {
+            real v[6] = {0, 0, 0, 0, 0, 0};
+            for (int k = body_offset[body]; k < body_offset[body + 1]; k++) {
+                int index = body_contacts[k] / 2;
+                int s = body_contacts[k] % 2;
+                const real* M_invD_c = &M_invD_blocks[index * stride + s * 6];
+                for (uint j = 0; j < num_rows; j++) {
+                    real x_j = x[ContactRow(num_contacts, index, j)];
+                    for (int d = 0; d < 6; d++)
+                        v[d] += M_invD_c[j * 12 + d] * x_j;
+                }
+            }
+            for (int d = 0; d < 6; d++)
+                MinvDx[body * 6 + d] += v[d];
+        }
+    }
+
+    if (num_bilaterals > 0) {
+        SubVectorType o_b = subvector(output, num_unilaterals, num_bilaterals);
+        ConstSubVectorType E_b = subvector(E, num_unilaterals, num_bilaterals);
+        o_b = _DBT_ * MinvDx + E_b * x_b;
+    }
+
+    if (num_rows > 0) {
+#pragma omp parallel for
+        for (int index = 0; index < (signed)num_contacts; index++) {
+            const real* v1 = &MinvDx[data_manager->host_data.bids_rigid_rigid[index].x * 6];
+            const real* v2 = &MinvDx[data_manager->host_data.bids_rigid_rigid[index].y * 6];
+            const real* D_c = &D_blocks[index * stride];
+            for (uint j = 0; j < num_rows; j++) {
+                uint row = ContactRow(num_contacts, index, j);
+                real sum = E[row] * x[row];
+                for (int d = 0; d < 6; d++)
+                    sum += D_c[j * 12 + d] * v1[d] + D_c[j * 12 + 6 + d] * v2[d];
+                output[row] = sum;
+            }
+        }
+    }
+}
+
 void ChShurProduct::operator()(const DynamicVector<real>& x, DynamicVector<real>& output) {
     data_manager->system_timer.start("ShurProduct");
 
+    if (use_blocks) {
+        BlockProduct(x, output);
+        data_manager->system_timer.stop("ShurProduct");
+        return;
+    }
+
     const DynamicVector<real>& E = data_manager->host_data.E;
 
     uint num_rigid_contacts = data_manager->num_rigid_contacts;
@@ -105,7 +297,7 @@ void ChShurProduct::operator()(const DynamicVector<real>& x, DynamicVector<real>
 }
 
 void ChShurProductBilateral::Setup(ChParallelDataManager* data_container_) {
-    ChShurProduct::Setup(data_container_);
+    data_manager = data_container_;
     if (data_manager->num_bilaterals == 0) {
         return;
     }
@@ -117,7 +309,7 @@ void ChShurProductBilateral::operator()(const DynamicVector<real>& x, DynamicVec
 }
 
 void ChShurProductFEM::Setup(ChParallelDataManager* data_container_) {
-    ChShurProduct::Setup(data_container_);
+    data_manager = data_container_;
     //    if (data_manager->num_fea_tets == 0) {
     //        return;
     //    }
@@ -56,17 +56,35 @@ class CH_PARALLEL_API ChProjectNone : public ChProjectConstraints {
 };
 
 /// Functor class for calculating the Shur product of the matrix of unilateral constraints.
+/// If solver_settings::use_shur_blocks is enabled, the blocks of D and M^-1 D of each rigid-rigid contact are
+/// extracted in Setup and the contact rows of the product are calculated with two passes (one over the bodies, one
+/// over the contacts) on these dense blocks, instead of sparse matrix products. This requires no 3DOF or FEA
+/// constraints; otherwise (or if compute_N is enabled) the sparse matrices are used.
 class CH_PARALLEL_API ChShurProduct {
   public:
     ChShurProduct();
     virtual ~ChShurProduct() {}
 
-    virtual void Setup(ChParallelDataManager* data_container_) { data_manager = data_container_; }
+    virtual void Setup(ChParallelDataManager* data_container_);
 
     //. Perform the Shur Product.
     virtual void operator()(const DynamicVector<real>& x, DynamicVector<real>& AX);
 
     ChParallelDataManager* data_manager;  ///< Pointer to the system's data manager
+
+  protected:
+    /// Extract the blocks of D and M^-1 D of all rigid-rigid contacts.
+    void SetupBlocks();
+    /// Perform the Shur product using the blocks of the rigid-rigid contacts.
+    void BlockProduct(const DynamicVector<real>& x, DynamicVector<real>& AX);
+
+    bool use_blocks;                    ///< true if the blocks are set up for the current step
+    uint num_block_rows;                ///< number of rows of each contact in the blocks
+    custom_vector<real> D_blocks;       ///< blocks of D (6 entries per row and body, for each contact)
+    custom_vector<real> M_invD_blocks;  ///< blocks of M^-1 D (same layout as D_blocks)
+    custom_vector<int> body_offset;     ///< offset of the contacts of each body in body_contacts
+    custom_vector<int> body_contacts;   ///< contacts grouped by body (2 * contact + index of the body in the pair)
+    DynamicVector<real> MinvDx;         ///< temporary vector for M^-1 D x
 };
 
 /// Functor class for performing the Shur product of the matrix of bilateral constraints.
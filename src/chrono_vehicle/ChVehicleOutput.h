@@ -44,9 +44,10 @@ namespace vehicle {
 class CH_VEHICLE_API ChVehicleOutput {
   public:
     enum Type {
-        ASCII,  ///< ASCII text
-        JSON,   ///< JSON
-        HDF5    ///< HDF-5
+        ASCII,       ///< ASCII text
+        JSON,        ///< JSON
+        HDF5,        ///< HDF-5, one group per output frame
+        HDF5_SERIES  ///< HDF-5, one extendible dataset per component type, written in the background
     };
 
     ChVehicleOutput() {}
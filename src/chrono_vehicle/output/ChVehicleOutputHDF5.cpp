@@ -16,10 +16,13 @@
 //
 // =============================================================================
 
+#include <cassert>
+#include <iomanip>
 #include <iostream>
 #include <sstream>
 #include <fstream>
 
+#include "chrono/core/ChException.h"
 #include "chrono/physics/ChLinkMasked.h"
 #include "chrono/physics/ChLinkUniversal.h"
 
@@ -100,192 +103,220 @@ struct bodyload_info {
     double tx, ty, tz;  // joint reaction torque
 };
 
-H5::CompType* ChVehicleOutputHDF5::m_body_type = nullptr;
-H5::CompType* ChVehicleOutputHDF5::m_bodyaux_type = nullptr;
-H5::CompType* ChVehicleOutputHDF5::m_shaft_type = nullptr;
-H5::CompType* ChVehicleOutputHDF5::m_marker_type = nullptr;
-H5::CompType* ChVehicleOutputHDF5::m_joint_type = nullptr;
-H5::CompType* ChVehicleOutputHDF5::m_couple_type = nullptr;
-H5::CompType* ChVehicleOutputHDF5::m_linspring_type = nullptr;
-H5::CompType* ChVehicleOutputHDF5::m_rotspring_type = nullptr;
-H5::CompType* ChVehicleOutputHDF5::m_bodyload_type = nullptr;
-
-const H5::CompType& ChVehicleOutputHDF5::getBodyType() {
-    if (!m_body_type) {
-        struct Initializer {
-            Initializer() {
-                m_body_type = new H5::CompType(sizeof(body_info));
-                m_body_type->insertMember("id", HOFFSET(body_info, id), H5::PredType::NATIVE_INT);
-                m_body_type->insertMember("x", HOFFSET(body_info, x), H5::PredType::NATIVE_DOUBLE);
-                m_body_type->insertMember("y", HOFFSET(body_info, y), H5::PredType::NATIVE_DOUBLE);
-                m_body_type->insertMember("z", HOFFSET(body_info, z), H5::PredType::NATIVE_DOUBLE);
-                m_body_type->insertMember("e0", HOFFSET(body_info, e0), H5::PredType::NATIVE_DOUBLE);
-                m_body_type->insertMember("e1", HOFFSET(body_info, e1), H5::PredType::NATIVE_DOUBLE);
-                m_body_type->insertMember("e2", HOFFSET(body_info, e2), H5::PredType::NATIVE_DOUBLE);
-                m_body_type->insertMember("e3", HOFFSET(body_info, e3), H5::PredType::NATIVE_DOUBLE);
-            }
-        };
-        static Initializer ListInitializationGuard;
-    }
-    return *m_body_type;
-}
-
-const H5::CompType& ChVehicleOutputHDF5::getBodyAuxType() {
-    if (!m_bodyaux_type) {
-        struct Initializer {
-            Initializer() {
-                m_bodyaux_type = new H5::CompType(sizeof(bodyaux_info));
-                m_bodyaux_type->insertMember("id", HOFFSET(bodyaux_info, id), H5::PredType::NATIVE_INT);
-                m_bodyaux_type->insertMember("x", HOFFSET(bodyaux_info, x), H5::PredType::NATIVE_DOUBLE);
-                m_bodyaux_type->insertMember("y", HOFFSET(bodyaux_info, y), H5::PredType::NATIVE_DOUBLE);
-                m_bodyaux_type->insertMember("z", HOFFSET(bodyaux_info, z), H5::PredType::NATIVE_DOUBLE);
-                m_bodyaux_type->insertMember("e0", HOFFSET(bodyaux_info, e0), H5::PredType::NATIVE_DOUBLE);
-                m_bodyaux_type->insertMember("e1", HOFFSET(bodyaux_info, e1), H5::PredType::NATIVE_DOUBLE);
-                m_bodyaux_type->insertMember("e2", HOFFSET(bodyaux_info, e2), H5::PredType::NATIVE_DOUBLE);
-                m_bodyaux_type->insertMember("e3", HOFFSET(bodyaux_info, e3), H5::PredType::NATIVE_DOUBLE);
-            }
-        };
-        static Initializer ListInitializationGuard;
-    }
-    return *m_bodyaux_type;
-}
-
-const H5::CompType& ChVehicleOutputHDF5::getShaftType() {
-    if (!m_shaft_type) {
-        struct Initializer {
-            Initializer() {
-                m_shaft_type = new H5::CompType(sizeof(shaft_info));
-                m_shaft_type->insertMember("id", HOFFSET(shaft_info, id), H5::PredType::NATIVE_INT);
-                m_shaft_type->insertMember("x", HOFFSET(shaft_info, x), H5::PredType::NATIVE_DOUBLE);
-                m_shaft_type->insertMember("xd", HOFFSET(shaft_info, xd), H5::PredType::NATIVE_DOUBLE);
-                m_shaft_type->insertMember("xdd", HOFFSET(shaft_info, xdd), H5::PredType::NATIVE_DOUBLE);
-                m_shaft_type->insertMember("torque", HOFFSET(shaft_info, t), H5::PredType::NATIVE_DOUBLE);
-            }
-        };
-        static Initializer ListInitializationGuard;
-    }
-    return *m_shaft_type;
-}
-
-const H5::CompType& ChVehicleOutputHDF5::getMarkerType() {
-    if (!m_marker_type) {
-        struct Initializer {
-            Initializer() {
-                m_marker_type = new H5::CompType(sizeof(marker_info));
-                m_marker_type->insertMember("id", HOFFSET(marker_info, id), H5::PredType::NATIVE_INT);
-                m_marker_type->insertMember("x", HOFFSET(marker_info, x), H5::PredType::NATIVE_DOUBLE);
-                m_marker_type->insertMember("y", HOFFSET(marker_info, y), H5::PredType::NATIVE_DOUBLE);
-                m_marker_type->insertMember("z", HOFFSET(marker_info, z), H5::PredType::NATIVE_DOUBLE);
-                m_marker_type->insertMember("xd", HOFFSET(marker_info, xd), H5::PredType::NATIVE_DOUBLE);
-                m_marker_type->insertMember("yd", HOFFSET(marker_info, yd), H5::PredType::NATIVE_DOUBLE);
-                m_marker_type->insertMember("zd", HOFFSET(marker_info, zd), H5::PredType::NATIVE_DOUBLE);
-                m_marker_type->insertMember("xdd", HOFFSET(marker_info, xdd), H5::PredType::NATIVE_DOUBLE);
-                m_marker_type->insertMember("ydd", HOFFSET(marker_info, ydd), H5::PredType::NATIVE_DOUBLE);
-                m_marker_type->insertMember("zdd", HOFFSET(marker_info, zdd), H5::PredType::NATIVE_DOUBLE);
-            }
-        };
-        static Initializer ListInitializationGuard;
-    }
-    return *m_marker_type;
-}
-
-const H5::CompType& ChVehicleOutputHDF5::getJointType() {
-    if (!m_joint_type) {
-        struct Initializer {
-            Initializer() {
-                m_joint_type = new H5::CompType(sizeof(joint_info));
-                m_joint_type->insertMember("id", HOFFSET(joint_info, id), H5::PredType::NATIVE_INT);
-                m_joint_type->insertMember("Fx", HOFFSET(joint_info, fx), H5::PredType::NATIVE_DOUBLE);
-                m_joint_type->insertMember("Fy", HOFFSET(joint_info, fy), H5::PredType::NATIVE_DOUBLE);
-                m_joint_type->insertMember("Fz", HOFFSET(joint_info, fz), H5::PredType::NATIVE_DOUBLE);
-                m_joint_type->insertMember("Tx", HOFFSET(joint_info, tx), H5::PredType::NATIVE_DOUBLE);
-                m_joint_type->insertMember("Ty", HOFFSET(joint_info, ty), H5::PredType::NATIVE_DOUBLE);
-                m_joint_type->insertMember("Tz", HOFFSET(joint_info, tz), H5::PredType::NATIVE_DOUBLE);
-            }
-        };
-        static Initializer ListInitializationGuard;
-    }
-    return *m_joint_type;
-}
-
-const H5::CompType& ChVehicleOutputHDF5::getCoupleType() {
-    if (!m_couple_type) {
-        struct Initializer {
-            Initializer() {
-                m_couple_type = new H5::CompType(sizeof(couple_info));
-                m_couple_type->insertMember("id", HOFFSET(couple_info, id), H5::PredType::NATIVE_INT);
-                m_couple_type->insertMember("x", HOFFSET(couple_info, x), H5::PredType::NATIVE_DOUBLE);
-                m_couple_type->insertMember("xd", HOFFSET(couple_info, xd), H5::PredType::NATIVE_DOUBLE);
-                m_couple_type->insertMember("xdd", HOFFSET(couple_info, xdd), H5::PredType::NATIVE_DOUBLE);
-                m_couple_type->insertMember("torque1", HOFFSET(couple_info, t1), H5::PredType::NATIVE_DOUBLE);
-                m_couple_type->insertMember("torque2", HOFFSET(couple_info, t1), H5::PredType::NATIVE_DOUBLE);
-            }
-        };
-        static Initializer ListInitializationGuard;
-    }
-    return *m_couple_type;
-}
-
-const H5::CompType& ChVehicleOutputHDF5::getLinSpringType() {
-    if (!m_linspring_type) {
-        struct Initializer {
-            Initializer() {
-                m_linspring_type = new H5::CompType(sizeof(linspring_info));
-                m_linspring_type->insertMember("id", HOFFSET(linspring_info, id), H5::PredType::NATIVE_INT);
-                m_linspring_type->insertMember("x", HOFFSET(linspring_info, x), H5::PredType::NATIVE_DOUBLE);
-                m_linspring_type->insertMember("xd", HOFFSET(linspring_info, xd), H5::PredType::NATIVE_DOUBLE);
-                m_linspring_type->insertMember("force", HOFFSET(linspring_info, f), H5::PredType::NATIVE_DOUBLE);
-            }
-        };
-        static Initializer ListInitializationGuard;
-    }
-    return *m_linspring_type;
-}
-
-const H5::CompType& ChVehicleOutputHDF5::getRotSpringType() {
-    if (!m_rotspring_type) {
-        struct Initializer {
-            Initializer() {
-                m_rotspring_type = new H5::CompType(sizeof(rotspring_info));
-                m_rotspring_type->insertMember("id", HOFFSET(rotspring_info, id), H5::PredType::NATIVE_INT);
-                m_rotspring_type->insertMember("x", HOFFSET(rotspring_info, x), H5::PredType::NATIVE_DOUBLE);
-                m_rotspring_type->insertMember("xd", HOFFSET(rotspring_info, xd), H5::PredType::NATIVE_DOUBLE);
-                m_rotspring_type->insertMember("force", HOFFSET(rotspring_info, t), H5::PredType::NATIVE_DOUBLE);
-            }
-        };
-        static Initializer ListInitializationGuard;
-    }
-    return *m_rotspring_type;
-}
-
-const H5::CompType& ChVehicleOutputHDF5::getBodyLoadType() {
-    if (!m_bodyload_type) {
-        struct Initializer {
-            Initializer() {
-                m_bodyload_type = new H5::CompType(sizeof(bodyload_info));
-                m_bodyload_type->insertMember("id", HOFFSET(bodyload_info, id), H5::PredType::NATIVE_INT);
-                m_bodyload_type->insertMember("Fx", HOFFSET(bodyload_info, fx), H5::PredType::NATIVE_DOUBLE);
-                m_bodyload_type->insertMember("Fy", HOFFSET(bodyload_info, fy), H5::PredType::NATIVE_DOUBLE);
-                m_bodyload_type->insertMember("Fz", HOFFSET(bodyload_info, fz), H5::PredType::NATIVE_DOUBLE);
-                m_bodyload_type->insertMember("Tx", HOFFSET(bodyload_info, tx), H5::PredType::NATIVE_DOUBLE);
-                m_bodyload_type->insertMember("Ty", HOFFSET(bodyload_info, ty), H5::PredType::NATIVE_DOUBLE);
-                m_bodyload_type->insertMember("Tz", HOFFSET(bodyload_info, tz), H5::PredType::NATIVE_DOUBLE);
-            }
-        };
-        static Initializer ListInitializationGuard;
-    }
-    return *m_bodyload_type;
+struct time_info {
+    int frame;    // output frame
+    double time;  // simulation time
+};
+
+// Dataset names, indexed by component type
+static const char* component_names[] = {"Bodies", "Bodies AuxRef", "Markers",    "Shafts",         "Joints",
+                                        "Couples", "Lin Springs",  "Rot Springs", "Body-body Loads"};
+
+H5::CompType ChVehicleOutputHDF5::createBodyType() {
+    H5::CompType type(sizeof(body_info));
+    type.insertMember("id", HOFFSET(body_info, id), H5::PredType::NATIVE_INT);
+    type.insertMember("x", HOFFSET(body_info, x), H5::PredType::NATIVE_DOUBLE);
+    type.insertMember("y", HOFFSET(body_info, y), H5::PredType::NATIVE_DOUBLE);
+    type.insertMember("z", HOFFSET(body_info, z), H5::PredType::NATIVE_DOUBLE);
+    type.insertMember("e0", HOFFSET(body_info, e0), H5::PredType::NATIVE_DOUBLE);
+    type.insertMember("e1", HOFFSET(body_info, e1), H5::PredType::NATIVE_DOUBLE);
+    type.insertMember("e2", HOFFSET(body_info, e2), H5::PredType::NATIVE_DOUBLE);
+    type.insertMember("e3", HOFFSET(body_info, e3), H5::PredType::NATIVE_DOUBLE);
+    return type;
+}
+
+H5::CompType ChVehicleOutputHDF5::createBodyAuxType() {
+    H5::CompType type(sizeof(bodyaux_info));
+    type.insertMember("id", HOFFSET(bodyaux_info, id), H5::PredType::NATIVE_INT);
+    type.insertMember("x", HOFFSET(bodyaux_info, x), H5::PredType::NATIVE_DOUBLE);
+    type.insertMember("y", HOFFSET(bodyaux_info, y), H5::PredType::NATIVE_DOUBLE);
+    type.insertMember("z", HOFFSET(bodyaux_info, z), H5::PredType::NATIVE_DOUBLE);
+    type.insertMember("e0", HOFFSET(bodyaux_info, e0), H5::PredType::NATIVE_DOUBLE);
+    type.insertMember("e1", HOFFSET(bodyaux_info, e1), H5::PredType::NATIVE_DOUBLE);
+    type.insertMember("e2", HOFFSET(bodyaux_info, e2), H5::PredType::NATIVE_DOUBLE);
+    type.insertMember("e3", HOFFSET(bodyaux_info, e3), H5::PredType::NATIVE_DOUBLE);
+    return type;
+}
+
+H5::CompType ChVehicleOutputHDF5::createShaftType() {
+    H5::CompType type(sizeof(shaft_info));
+    type.insertMember("id", HOFFSET(shaft_info, id), H5::PredType::NATIVE_INT);
+    type.insertMember("x", HOFFSET(shaft_info, x), H5::PredType::NATIVE_DOUBLE);
+    type.insertMember("xd", HOFFSET(shaft_info, xd), H5::PredType::NATIVE_DOUBLE);
+    type.insertMember("xdd", HOFFSET(shaft_info, xdd), H5::PredType::NATIVE_DOUBLE);
+    type.insertMember("torque", HOFFSET(shaft_info, t), H5::PredType::NATIVE_DOUBLE);
+    return type;
+}
+
+H5::CompType ChVehicleOutputHDF5::createMarkerType() {
+    H5::CompType type(sizeof(marker_info));
+    type.insertMember("id", HOFFSET(marker_info, id), H5::PredType::NATIVE_INT);
+    type.insertMember("x", HOFFSET(marker_info, x), H5::PredType::NATIVE_DOUBLE);
+    type.insertMember("y", HOFFSET(marker_info, y), H5::PredType::NATIVE_DOUBLE);
+    type.insertMember("z", HOFFSET(marker_info, z), H5::PredType::NATIVE_DOUBLE);
+    type.insertMember("xd", HOFFSET(marker_info, xd), H5::PredType::NATIVE_DOUBLE);
+    type.insertMember("yd", HOFFSET(marker_info, yd), H5::PredType::NATIVE_DOUBLE);
+    type.insertMember("zd", HOFFSET(marker_info, zd), H5::PredType::NATIVE_DOUBLE);
+    type.insertMember("xdd", HOFFSET(marker_info, xdd), H5::PredType::NATIVE_DOUBLE);
+    type.insertMember("ydd", HOFFSET(marker_info, ydd), H5::PredType::NATIVE_DOUBLE);
+    type.insertMember("zdd", HOFFSET(marker_info, zdd), H5::PredType::NATIVE_DOUBLE);
+    return type;
+}
+
+H5::CompType ChVehicleOutputHDF5::createJointType() {
+    H5::CompType type(sizeof(joint_info));
+    type.insertMember("id", HOFFSET(joint_info, id), H5::PredType::NATIVE_INT);
+    type.insertMember("Fx", HOFFSET(joint_info, fx), H5::PredType::NATIVE_DOUBLE);
+    type.insertMember("Fy", HOFFSET(joint_info, fy), H5::PredType::NATIVE_DOUBLE);
+    type.insertMember("Fz", HOFFSET(joint_info, fz), H5::PredType::NATIVE_DOUBLE);
+    type.insertMember("Tx", HOFFSET(joint_info, tx), H5::PredType::NATIVE_DOUBLE);
+    type.insertMember("Ty", HOFFSET(joint_info, ty), H5::PredType::NATIVE_DOUBLE);
+    type.insertMember("Tz", HOFFSET(joint_info, tz), H5::PredType::NATIVE_DOUBLE);
+    return type;
+}
+
+H5::CompType ChVehicleOutputHDF5::createCoupleType() {
+    H5::CompType type(sizeof(couple_info));
+    type.insertMember("id", HOFFSET(couple_info, id), H5::PredType::NATIVE_INT);
+    type.insertMember("x", HOFFSET(couple_info, x), H5::PredType::NATIVE_DOUBLE);
+    type.insertMember("xd", HOFFSET(couple_info, xd), H5::PredType::NATIVE_DOUBLE);
+    type.insertMember("xdd", HOFFSET(couple_info, xdd), H5::PredType::NATIVE_DOUBLE);
+    type.insertMember("torque1", HOFFSET(couple_info, t1), H5::PredType::NATIVE_DOUBLE);
+    type.insertMember("torque2", HOFFSET(couple_info, t2), H5::PredType::NATIVE_DOUBLE);
+    return type;
+}
+
+H5::CompType ChVehicleOutputHDF5::createLinSpringType() {
+    H5::CompType type(sizeof(linspring_info));
+    type.insertMember("id", HOFFSET(linspring_info, id), H5::PredType::NATIVE_INT);
+    type.insertMember("x", HOFFSET(linspring_info, x), H5::PredType::NATIVE_DOUBLE);
+    type.insertMember("xd", HOFFSET(linspring_info, xd), H5::PredType::NATIVE_DOUBLE);
+    type.insertMember("force", HOFFSET(linspring_info, f), H5::PredType::NATIVE_DOUBLE);
+    return type;
+}
+
+H5::CompType ChVehicleOutputHDF5::createRotSpringType() {
+    H5::CompType type(sizeof(rotspring_info));
+    type.insertMember("id", HOFFSET(rotspring_info, id), H5::PredType::NATIVE_INT);
+    type.insertMember("x", HOFFSET(rotspring_info, x), H5::PredType::NATIVE_DOUBLE);
+    type.insertMember("xd", HOFFSET(rotspring_info, xd), H5::PredType::NATIVE_DOUBLE);
+    type.insertMember("force", HOFFSET(rotspring_info, t), H5::PredType::NATIVE_DOUBLE);
+    return type;
+}
+
+H5::CompType ChVehicleOutputHDF5::createBodyLoadType() {
+    H5::CompType type(sizeof(bodyload_info));
+    type.insertMember("id", HOFFSET(bodyload_info, id), H5::PredType::NATIVE_INT);
+    type.insertMember("Fx", HOFFSET(bodyload_info, fx), H5::PredType::NATIVE_DOUBLE);
+    type.insertMember("Fy", HOFFSET(bodyload_info, fy), H5::PredType::NATIVE_DOUBLE);
+    type.insertMember("Fz", HOFFSET(bodyload_info, fz), H5::PredType::NATIVE_DOUBLE);
+    type.insertMember("Tx", HOFFSET(bodyload_info, tx), H5::PredType::NATIVE_DOUBLE);
+    type.insertMember("Ty", HOFFSET(bodyload_info, ty), H5::PredType::NATIVE_DOUBLE);
+    type.insertMember("Tz", HOFFSET(bodyload_info, tz), H5::PredType::NATIVE_DOUBLE);
+    return type;
+}
+
+H5::CompType ChVehicleOutputHDF5::createTimeType() {
+    H5::CompType type(sizeof(time_info));
+    type.insertMember("frame", HOFFSET(time_info, frame), H5::PredType::NATIVE_INT);
+    type.insertMember("time", HOFFSET(time_info, time), H5::PredType::NATIVE_DOUBLE);
+    return type;
+}
+
+const H5::DataType& ChVehicleOutputHDF5::getType(Component type) const {
+    return m_types[type];
+}
+
+// The HDF5 library is only safe to call from several threads if it was built thread-safe: all calls made
+// by the output databases (simulation threads and writer threads) are serialized with this lock.
+std::mutex& ChVehicleOutputHDF5::getLock() {
+    static std::mutex lock;
+    return lock;
 }
 
 // -----------------------------------------------------------------------------
 
-ChVehicleOutputHDF5::ChVehicleOutputHDF5(const std::string& filename)
-    : m_frame_group(nullptr), m_section_group(nullptr) {
+ChVehicleOutputHDF5::ChVehicleOutputHDF5(const std::string& filename,
+                                         Layout layout,
+                                         int compression,
+                                         unsigned int chunk_frames)
+    : m_layout(layout),
+      m_frame_group(nullptr),
+      m_section_group(nullptr),
+      m_compression(compression),
+      m_chunk_frames(chunk_frames > 0 ? chunk_frames : 1),
+      m_fill(0),
+      m_frame_open(false),
+      m_pending(false),
+      m_stop(false),
+      m_sections_group(nullptr),
+      m_time_set(nullptr) {
+    std::lock_guard<std::mutex> lock(getLock());
+
+    // The compound types are owned by this database, so that they are closed (in the destructor) while the
+    // HDF5 library is still open.
+    m_types[BODIES] = createBodyType();
+    m_types[AUXREF_BODIES] = createBodyAuxType();
+    m_types[MARKERS] = createMarkerType();
+    m_types[SHAFTS] = createShaftType();
+    m_types[JOINTS] = createJointType();
+    m_types[COUPLES] = createCoupleType();
+    m_types[LIN_SPRINGS] = createLinSpringType();
+    m_types[ROT_SPRINGS] = createRotSpringType();
+    m_types[BODY_LOADS] = createBodyLoadType();
+    m_time_type = createTimeType();
+
     m_fileHDF5 = new H5::H5File(filename, H5F_ACC_TRUNC);
-    H5::Group frames_group(m_fileHDF5->createGroup("/Frames"));
+
+    if (m_layout == Layout::FRAMES) {
+        H5::Group frames_group(m_fileHDF5->createGroup("/Frames"));
+        return;
+    }
+
+    H5::Group root_group = m_fileHDF5->openGroup("/");
+    m_sections_group = new H5::Group(m_fileHDF5->createGroup("/Sections"));
+    m_time_set = new SeriesSet(CreateSeries(root_group, "Time", m_time_type, 1, 1, 0));
+
+    m_writer = std::thread(&ChVehicleOutputHDF5::WriteFrames, this);
 }
 
 ChVehicleOutputHDF5::~ChVehicleOutputHDF5() {
+    if (m_layout == Layout::TIME_SERIES) {
+        // Hand over the last frame and let the writer thread finish.
+        {
+            std::unique_lock<std::mutex> lock(m_mutex);
+            m_cv.wait(lock, [this] { return !m_pending; });
+            if (m_frame_open) {
+                m_fill = 1 - m_fill;
+                m_pending = true;
+            }
+            m_stop = true;
+        }
+        m_cv.notify_all();
+        m_writer.join();
+    }
+
+    std::lock_guard<std::mutex> lock(getLock());
+
+    if (m_layout == Layout::TIME_SERIES) {
+        if (m_error.empty()) {
+            try {
+                TrimSeries();
+            } catch (const H5::Exception& e) {
+                m_error = e.getDetailMsg();
+            }
+        }
+
+        if (!m_error.empty())
+            GetLog() << "Error writing HDF5 output: " << m_error << "\n";
+
+        m_series.clear();
+        m_time_set->set.close();
+        m_sections_group->close();
+        delete m_time_set;
+        delete m_sections_group;
+    }
+
     if (m_section_group)
         m_section_group->close();
     if (m_frame_group)
@@ -295,15 +326,10 @@ ChVehicleOutputHDF5::~ChVehicleOutputHDF5() {
     delete m_section_group;
     delete m_frame_group;
     delete m_fileHDF5;
-    
-    delete m_body_type;
-    delete m_bodyaux_type;
-    delete m_shaft_type;
-    delete m_marker_type;
-    delete m_joint_type;
-    delete m_couple_type;
-    delete m_linspring_type;
-    delete m_rotspring_type;
+
+    for (auto& type : m_types)
+        type.close();
+    m_time_type.close();
 
     GetLog() << "Closing output HDF5 file.\n";
 }
@@ -316,9 +342,214 @@ std::string format_number(int num, int precision) {
     return out.str();
 }
 
+// -----------------------------------------------------------------------------
+// Record buffers
+// -----------------------------------------------------------------------------
+
+template <typename T>
+T* ChVehicleOutputHDF5::NewRecords(Component type, size_t count) {
+    std::vector<char>* data = &m_records;
+
+    if (m_layout == Layout::TIME_SERIES) {
+        Frame& buffer = m_frames[m_fill];
+        assert(buffer.num_sections > 0);
+        Section& section = buffer.sections[buffer.num_sections - 1];
+        if (section.num_blocks == section.blocks.size())
+            section.blocks.emplace_back();
+        Block& block = section.blocks[section.num_blocks++];
+        block.type = type;
+        block.count = count;
+        data = &block.data;
+    }
+
+    data->resize(count * sizeof(T));
+    return reinterpret_cast<T*>(data->data());
+}
+
+void ChVehicleOutputHDF5::CommitRecords(Component type, size_t count) {
+    // With the TIME_SERIES layout, the records are written with the rest of the frame.
+    if (m_layout == Layout::TIME_SERIES)
+        return;
+
+    std::lock_guard<std::mutex> lock(getLock());
+
+    hsize_t dim[] = {count};
+    H5::DataSpace dataspace(1, dim);
+    H5::DataSet set = m_section_group->createDataSet(component_names[type], getType(type), dataspace);
+    set.write(m_records.data(), getType(type));
+}
+
+// -----------------------------------------------------------------------------
+// Background writer for the TIME_SERIES layout.
+// The simulation thread fills one frame buffer while the writer thread writes
+// the other one. The simulation thread only waits if the writer thread has not
+// finished the previous frame by the time the current one is complete.
+// -----------------------------------------------------------------------------
+
+void ChVehicleOutputHDF5::SubmitFrame() {
+    std::unique_lock<std::mutex> lock(m_mutex);
+    m_cv.wait(lock, [this] { return !m_pending; });
+    if (!m_error.empty())
+        throw ChException("Error writing HDF5 output: " + m_error);
+    m_fill = 1 - m_fill;
+    m_pending = true;
+    lock.unlock();
+    m_cv.notify_all();
+}
+
+void ChVehicleOutputHDF5::WriteFrames() {
+    while (true) {
+        int index;
+        {
+            std::unique_lock<std::mutex> lock(m_mutex);
+            m_cv.wait(lock, [this] { return m_pending || m_stop; });
+            if (!m_pending)
+                break;
+            index = 1 - m_fill;
+        }
+
+        // After an error, keep consuming frames so that the simulation thread does not block.
+        if (m_error.empty()) {
+            std::lock_guard<std::mutex> lock(getLock());
+            try {
+                WriteFrame(m_frames[index]);
+            } catch (const H5::Exception& e) {
+                m_error = e.getDetailMsg();
+            } catch (const std::exception& e) {
+                m_error = e.what();
+            }
+        }
+
+        {
+            std::lock_guard<std::mutex> lock(m_mutex);
+            m_pending = false;
+        }
+        m_cv.notify_all();
+    }
+}
+
+ChVehicleOutputHDF5::SeriesSet ChVehicleOutputHDF5::CreateSeries(H5::Group& group,
+                                                                const std::string& name,
+                                                                const H5::DataType& type,
+                                                                int rank,
+                                                                hsize_t count,
+                                                                hsize_t rows) {
+    hsize_t dims[] = {rows, count};
+    hsize_t max_dims[] = {H5S_UNLIMITED, count};
+    hsize_t chunk_dims[] = {m_chunk_frames, count};
+    H5::DataSpace dataspace(rank, dims, max_dims);
+
+    H5::DSetCreatPropList props;
+    props.setChunk(rank, chunk_dims);
+    if (m_compression > 0)
+        props.setDeflate(m_compression);
+
+    SeriesSet series;
+    series.set = group.createDataSet(name, type, dataspace, props);
+    series.count = count;
+    series.rows = rows;
+    series.capacity = rows;
+    return series;
+}
+
+void ChVehicleOutputHDF5::WriteRow(SeriesSet& series,
+                                   int rank,
+                                   hsize_t row,
+                                   const void* data,
+                                   const H5::DataType& type) {
+    // Extend the dataset to the end of the chunk holding this row, rather than by one row per frame.
+    if (row >= series.capacity) {
+        series.capacity = (row / m_chunk_frames + 1) * m_chunk_frames;
+        hsize_t size[] = {series.capacity, series.count};
+        series.set.extend(size);
+    }
+
+    hsize_t offset[] = {row, 0};
+    hsize_t dims[] = {1, series.count};
+    H5::DataSpace filespace = series.set.getSpace();
+    filespace.selectHyperslab(H5S_SELECT_SET, dims, offset);
+    H5::DataSpace memspace(rank, dims);
+    series.set.write(data, type, memspace, filespace);
+    series.rows = row + 1;
+}
+
+// Set the extent of a dataset to the specified number of rows.
+static void Trim(H5::DataSet& set, hsize_t& capacity, hsize_t rows, hsize_t count) {
+    if (capacity == rows)
+        return;
+    hsize_t size[] = {rows, count};
+    set.extend(size);
+    capacity = rows;
+}
+
+void ChVehicleOutputHDF5::TrimSeries() {
+    Trim(m_time_set->set, m_time_set->capacity, m_time_set->rows, 1);
+
+    // All datasets of a section have as many rows as its Frames dataset; rows of frames in which a
+    // component type was not written hold fill values.
+    for (auto& it : m_series) {
+        SeriesSection& series = it.second;
+        hsize_t rows = series.frames.rows;
+        Trim(series.frames.set, series.frames.capacity, rows, 1);
+        for (auto& set : series.sets)
+            Trim(set.second.set, set.second.capacity, rows, set.second.count);
+    }
+}
+
+void ChVehicleOutputHDF5::WriteFrame(const Frame& frame) {
+    time_info time = {frame.frame, frame.time};
+    WriteRow(*m_time_set, 1, m_time_set->rows, &time, m_time_type);
+
+    for (size_t is = 0; is < frame.num_sections; is++) {
+        const Section& section = frame.sections[is];
+
+        auto it = m_series.find(section.name);
+        if (it == m_series.end()) {
+            SeriesSection series;
+            series.group = m_sections_group->createGroup(section.name);
+            series.frames = CreateSeries(series.group, "Frames", H5::PredType::NATIVE_INT, 1, 1, 0);
+            it = m_series.insert(std::make_pair(section.name, series)).first;
+        }
+        SeriesSection& series = it->second;
+        hsize_t row = series.frames.rows;
+
+        for (size_t ib = 0; ib < section.num_blocks; ib++) {
+            const Block& block = section.blocks[ib];
+            const H5::DataType& type = getType(block.type);
+
+            auto it_set = series.sets.find(block.type);
+            if (it_set == series.sets.end()) {
+                // A dataset first written at a later frame starts with rows of fill values.
+                SeriesSet data = CreateSeries(series.group, component_names[block.type], type, 2, block.count, row);
+                it_set = series.sets.insert(std::make_pair(block.type, data)).first;
+            } else if (it_set->second.count != block.count) {
+                throw ChException("Number of " + std::string(component_names[block.type]) + " in section \"" +
+                                  section.name + "\" changed");
+            }
+
+            WriteRow(it_set->second, 2, row, block.data.data(), type);
+        }
+
+        WriteRow(series.frames, 1, row, &frame.frame, H5::PredType::NATIVE_INT);
+    }
+}
+
 // -----------------------------------------------------------------------------
 
 void ChVehicleOutputHDF5::WriteTime(int frame, double time) {
+    if (m_layout == Layout::TIME_SERIES) {
+        if (m_frame_open)
+            SubmitFrame();
+        Frame& buffer = m_frames[m_fill];
+        buffer.frame = frame;
+        buffer.time = time;
+        buffer.num_sections = 0;
+        m_frame_open = true;
+        return;
+    }
+
+    std::lock_guard<std::mutex> lock(getLock());
+
     // Close the currently open section group
     if (m_section_group) {
         m_section_group->close();
@@ -347,6 +578,18 @@ void ChVehicleOutputHDF5::WriteTime(int frame, double time) {
 }
 
 void ChVehicleOutputHDF5::WriteSection(const std::string& name) {
+    if (m_layout == Layout::TIME_SERIES) {
+        Frame& buffer = m_frames[m_fill];
+        if (buffer.num_sections == buffer.sections.size())
+            buffer.sections.emplace_back();
+        Section& section = buffer.sections[buffer.num_sections++];
+        section.name = name;
+        section.num_blocks = 0;
+        return;
+    }
+
+    std::lock_guard<std::mutex> lock(getLock());
+
     // Close the currently open section group
     if (m_section_group) {
         m_section_group->close();
@@ -363,17 +606,14 @@ void ChVehicleOutputHDF5::WriteBodies(const std::vector<std::shared_ptr<ChBody>>
         return;
 
     auto nbodies = bodies.size();
-    hsize_t dim[] = {nbodies};
-    H5::DataSpace dataspace(1, dim);
-    std::vector<body_info> info(nbodies);
+    auto info = NewRecords<body_info>(BODIES, nbodies);
     for (auto i = 0; i < nbodies; i++) {
         const ChVector<>& p = bodies[i]->GetPos();
         const ChQuaternion<>& q = bodies[i]->GetRot();
         info[i] = {bodies[i]->GetIdentifier(), p.x(), p.y(), p.z(), q.e0(), q.e1(), q.e2(), q.e3()};
     }
 
-    H5::DataSet set = m_section_group->createDataSet("Bodies", getBodyType(), dataspace);
-    set.write(info.data(), getBodyType());
+    CommitRecords(BODIES, nbodies);
 }
 
 void ChVehicleOutputHDF5::WriteAuxRefBodies(const std::vector<std::shared_ptr<ChBodyAuxRef>>& bodies) {
@@ -381,17 +621,14 @@ void ChVehicleOutputHDF5::WriteAuxRefBodies(const std::vector<std::shared_ptr<Ch
         return;
 
     auto nbodies = bodies.size();
-    hsize_t dim[] = { nbodies };
-    H5::DataSpace dataspace(1, dim);
-    std::vector<bodyaux_info> info(nbodies);
+    auto info = NewRecords<bodyaux_info>(AUXREF_BODIES, nbodies);
     for (auto i = 0; i < nbodies; i++) {
         const ChVector<>& p = bodies[i]->GetPos();
         const ChQuaternion<>& q = bodies[i]->GetRot();
         info[i] = { bodies[i]->GetIdentifier(), p.x(), p.y(), p.z(), q.e0(), q.e1(), q.e2(), q.e3() };
     }
 
-    H5::DataSet set = m_section_group->createDataSet("Bodies AuxRef", getBodyAuxType(), dataspace);
-    set.write(info.data(), getBodyAuxType());
+    CommitRecords(AUXREF_BODIES, nbodies);
 }
 
 void ChVehicleOutputHDF5::WriteMarkers(const std::vector<std::shared_ptr<ChMarker>>& markers) {
@@ -399,9 +636,7 @@ void ChVehicleOutputHDF5::WriteMarkers(const std::vector<std::shared_ptr<ChMarke
         return;
 
     auto nmarkers = markers.size();
-    hsize_t dim[] = {nmarkers};
-    H5::DataSpace dataspace(1, dim);
-    std::vector<marker_info> info(nmarkers);
+    auto info = NewRecords<marker_info>(MARKERS, nmarkers);
     for (auto i = 0; i < nmarkers; i++) {
         const ChVector<>& p = markers[i]->GetAbsCoord().pos;
         const ChVector<>& pd = markers[i]->GetAbsCoord_dt().pos;
@@ -409,8 +644,7 @@ void ChVehicleOutputHDF5::WriteMarkers(const std::vector<std::shared_ptr<ChMarke
         info[i] = {markers[i]->GetIdentifier(), p.x(), p.y(), p.z(), pd.x(), pd.y(), pd.z(), pdd.x(), pdd.y(), pdd.z()};
     }
 
-    H5::DataSet set = m_section_group->createDataSet("Markers", getMarkerType(), dataspace);
-    set.write(info.data(), getMarkerType());
+    CommitRecords(MARKERS, nmarkers);
 }
 
 void ChVehicleOutputHDF5::WriteShafts(const std::vector<std::shared_ptr<ChShaft>>& shafts) {
@@ -418,16 +652,13 @@ void ChVehicleOutputHDF5::WriteShafts(const std::vector<std::shared_ptr<ChShaft>
         return;
 
     auto nshafts = shafts.size();
-    hsize_t dim[] = {nshafts};
-    H5::DataSpace dataspace(1, dim);
-    std::vector<shaft_info> info(nshafts);
+    auto info = NewRecords<shaft_info>(SHAFTS, nshafts);
     for (auto i = 0; i < nshafts; i++) {
         info[i] = {shafts[i]->GetIdentifier(), shafts[i]->GetPos(), shafts[i]->GetPos_dt(), shafts[i]->GetPos_dtdt(),
                    shafts[i]->GetAppliedTorque()};
     }
 
-    H5::DataSet set = m_section_group->createDataSet("Shafts", getShaftType(), dataspace);
-    set.write(info.data(), getShaftType());
+    CommitRecords(SHAFTS, nshafts);
 }
 
 void ChVehicleOutputHDF5::WriteJoints(const std::vector<std::shared_ptr<ChLink>>& joints) {
@@ -435,17 +666,14 @@ void ChVehicleOutputHDF5::WriteJoints(const std::vector<std::shared_ptr<ChLink>>
         return;
 
     auto njoints = joints.size();
-    hsize_t dim[] = { njoints };
-    H5::DataSpace dataspace(1, dim);
-    std::vector<joint_info> info(njoints);
+    auto info = NewRecords<joint_info>(JOINTS, njoints);
     for (auto i = 0; i < njoints; i++) {
         const ChVector<>& f = joints[i]->Get_react_force();
         const ChVector<>& t = joints[i]->Get_react_torque();
         info[i] = { joints[i]->GetIdentifier(), f.x(), f.y(), f.z(), t.x(), t.y(), t.z() };
     }
 
-    H5::DataSet set = m_section_group->createDataSet("Joints", getJointType(), dataspace);
-    set.write(info.data(), getJointType());
+    CommitRecords(JOINTS, njoints);
 }
 
 void ChVehicleOutputHDF5::WriteCouples(const std::vector<std::shared_ptr<ChShaftsCouple>>& couples) {
@@ -453,17 +681,14 @@ void ChVehicleOutputHDF5::WriteCouples(const std::vector<std::shared_ptr<ChShaft
         return;
 
     auto ncouples = couples.size();
-    hsize_t dim[] = {ncouples};
-    H5::DataSpace dataspace(1, dim);
-    std::vector<couple_info> info(ncouples);
+    auto info = NewRecords<couple_info>(COUPLES, ncouples);
     for (auto i = 0; i < ncouples; i++) {
         info[i] = {couples[i]->GetIdentifier(),          couples[i]->GetRelativeRotation(),
                    couples[i]->GetRelativeRotation_dt(), couples[i]->GetRelativeRotation_dtdt(),
                    couples[i]->GetTorqueReactionOn1(),   couples[i]->GetTorqueReactionOn2()};
     }
 
-    H5::DataSet set = m_section_group->createDataSet("Couples", getCoupleType(), dataspace);
-    set.write(info.data(), getCoupleType());
+    CommitRecords(COUPLES, ncouples);
 }
 
 void ChVehicleOutputHDF5::WriteLinSprings(const std::vector<std::shared_ptr<ChLinkSpringCB>>& springs) {
@@ -471,16 +696,13 @@ void ChVehicleOutputHDF5::WriteLinSprings(const std::vector<std::shared_ptr<ChLi
         return;
 
     auto nsprings = springs.size();
-    hsize_t dim[] = {nsprings};
-    H5::DataSpace dataspace(1, dim);
-    std::vector<linspring_info> info(nsprings);
+    auto info = NewRecords<linspring_info>(LIN_SPRINGS, nsprings);
     for (auto i = 0; i < nsprings; i++) {
         info[i] = {springs[i]->GetIdentifier(), springs[i]->GetSpringLength(), springs[i]->GetSpringVelocity(),
                    springs[i]->GetSpringReact()};
     }
 
-    H5::DataSet set = m_section_group->createDataSet("Lin Springs", getLinSpringType(), dataspace);
-    set.write(info.data(), getLinSpringType());
+    CommitRecords(LIN_SPRINGS, nsprings);
 }
 
 void ChVehicleOutputHDF5::WriteRotSprings(const std::vector<std::shared_ptr<ChLinkRotSpringCB>>& springs) {
@@ -488,16 +710,13 @@ void ChVehicleOutputHDF5::WriteRotSprings(const std::vector<std::shared_ptr<ChLi
         return;
 
     auto nsprings = springs.size();
-    hsize_t dim[] = {nsprings};
-    H5::DataSpace dataspace(1, dim);
-    std::vector<rotspring_info> info(nsprings);
+    auto info = NewRecords<rotspring_info>(ROT_SPRINGS, nsprings);
     for (auto i = 0; i < nsprings; i++) {
         info[i] = {springs[i]->GetIdentifier(), springs[i]->GetRotSpringAngle(), springs[i]->GetRotSpringSpeed(),
                    springs[i]->GetRotSpringTorque()};
     }
 
-    H5::DataSet set = m_section_group->createDataSet("Rot Springs", getRotSpringType(), dataspace);
-    set.write(info.data(), getRotSpringType());
+    CommitRecords(ROT_SPRINGS, nsprings);
 }
 
 void ChVehicleOutputHDF5::WriteBodyLoads(const std::vector<std::shared_ptr<ChLoadBodyBody>>& loads) {
@@ -505,17 +724,14 @@ void ChVehicleOutputHDF5::WriteBodyLoads(const std::vector<std::shared_ptr<ChLoa
         return;
 
     auto nloads = loads.size();
-    hsize_t dim[] = { nloads };
-    H5::DataSpace dataspace(1, dim);
-    std::vector<bodyload_info> info(nloads);
+    auto info = NewRecords<bodyload_info>(BODY_LOADS, nloads);
     for (auto i = 0; i < nloads; i++) {
         ChVector<> f = loads[i]->GetForce();
         ChVector<> t = loads[i]->GetTorque();
         info[i] = { loads[i]->GetIdentifier(), f.x(), f.y(), f.z(), t.x(), t.y(), t.z() };
     }
 
-    H5::DataSet set = m_section_group->createDataSet("Body-body Loads", getBodyLoadType(), dataspace);
-    set.write(info.data(), getBodyLoadType());
+    CommitRecords(BODY_LOADS, nloads);
 }
 
 }  // end namespace vehicle
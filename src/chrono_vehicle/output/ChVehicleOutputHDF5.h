@@ -12,15 +12,19 @@
 // Authors: Radu Serban
 // =============================================================================
 //
-// ASCII text vehicle output database.
+// HDF5 vehicle output database.
 //
 // =============================================================================
 
 #ifndef CH_VEHICLE_OUTPUT_HDF5_H
 #define CH_VEHICLE_OUTPUT_HDF5_H
 
-#include <string>
+#include <condition_variable>
 #include <fstream>
+#include <map>
+#include <mutex>
+#include <string>
+#include <thread>
 
 #include "chrono_vehicle/ChVehicleOutput.h"
 
@@ -33,12 +37,86 @@ namespace vehicle {
 /// @{
 
 /// HDF5 vehicle output database.
+/// Two file layouts are supported:
+/// - FRAMES: one group per output frame (/Frames/Frame_xxxxxx), with a group for each section and one
+///   dataset for each component type in that section. Simple to browse, but the number of HDF5 objects
+///   grows with the number of output frames.
+/// - TIME_SERIES: one chunked, extendible dataset per section and component type
+///   (/Sections/<section>/<type>), with one row per output frame and one column per component.
+///   The dataset /Sections/<section>/Frames holds the output frame of each row and /Time holds the
+///   frame number and time of all output frames. Frames are collected in a buffer and written by a
+///   background thread, while the next frame is being collected. Datasets are extended by whole chunks
+///   and trimmed to the number of frames written when the file is closed.
+/// All HDF5 calls made by ChVehicleOutputHDF5 objects, from the simulation or the writer threads, are
+/// serialized with one lock, so that the HDF5 library need not be built thread-safe (other HDF5 users
+/// in the same process must not call the library concurrently with a vehicle output database).
 class CH_VEHICLE_API ChVehicleOutputHDF5 : public ChVehicleOutput {
   public:
-    ChVehicleOutputHDF5(const std::string& filename);
+    /// Layout of the HDF5 output file.
+    enum class Layout {
+        FRAMES,      ///< one group per frame, one dataset per section and component type in each frame
+        TIME_SERIES  ///< one extendible dataset per section and component type, one row per frame
+    };
+
+    ChVehicleOutputHDF5(const std::string& filename,     ///< [in] name of the output file
+                        Layout layout = Layout::FRAMES,  ///< [in] file layout
+                        int compression = 0,             ///< [in] deflate level for TIME_SERIES (0: none)
+                        unsigned int chunk_frames = 256  ///< [in] number of frames per chunk for TIME_SERIES
+                        );
     ~ChVehicleOutputHDF5();
 
   private:
+    /// Component types, one dataset per section for each of them.
+    enum Component {
+        BODIES,
+        AUXREF_BODIES,
+        MARKERS,
+        SHAFTS,
+        JOINTS,
+        COUPLES,
+        LIN_SPRINGS,
+        ROT_SPRINGS,
+        BODY_LOADS
+    };
+
+    /// Output records of one component type in a section, for one frame.
+    struct Block {
+        Component type;
+        size_t count;
+        std::vector<char> data;
+    };
+
+    /// Output data of one section, for one frame.
+    struct Section {
+        std::string name;
+        std::vector<Block> blocks;
+        size_t num_blocks;
+    };
+
+    /// Output data for one frame.
+    /// Buffers are reused from frame to frame, so only the first num_sections (num_blocks) entries are valid.
+    struct Frame {
+        int frame;
+        double time;
+        std::vector<Section> sections;
+        size_t num_sections;
+    };
+
+    /// Extendible dataset for one component type in a section.
+    struct SeriesSet {
+        H5::DataSet set;
+        hsize_t count;     ///< number of components (columns)
+        hsize_t rows;      ///< number of rows written
+        hsize_t capacity;  ///< current extent of the dataset (number of rows)
+    };
+
+    /// Datasets for one section.
+    struct SeriesSection {
+        H5::Group group;
+        SeriesSet frames;
+        std::map<Component, SeriesSet> sets;
+    };
+
     virtual void WriteTime(int frame, double time) override;
     virtual void WriteSection(const std::string& name) override;
 
@@ -52,29 +130,77 @@ class CH_VEHICLE_API ChVehicleOutputHDF5 : public ChVehicleOutput {
     virtual void WriteRotSprings(const std::vector<std::shared_ptr<ChLinkRotSpringCB>>& springs) override;
     virtual void WriteBodyLoads(const std::vector<std::shared_ptr<ChLoadBodyBody>>& loads) override;
 
+    /// Return storage for the records of the specified component type in the current section.
+    template <typename T>
+    T* NewRecords(Component type, size_t count);
+
+    /// Write the records returned by the last call to NewRecords (FRAMES layout only).
+    void CommitRecords(Component type, size_t count);
+
+    /// Hand the current frame to the writer thread and switch buffers.
+    void SubmitFrame();
+
+    /// Writer thread loop (TIME_SERIES layout).
+    void WriteFrames();
+
+    /// Append one frame to the TIME_SERIES datasets.
+    void WriteFrame(const Frame& frame);
+
+    /// Write one row of an extendible dataset, extending it by a whole chunk if needed.
+    void WriteRow(SeriesSet& series, int rank, hsize_t row, const void* data, const H5::DataType& type);
+
+    /// Set the extent of all TIME_SERIES datasets to the number of rows written.
+    void TrimSeries();
+
+    /// Create an extendible dataset with the specified number of components per row.
+    SeriesSet CreateSeries(H5::Group& group,
+                           const std::string& name,
+                           const H5::DataType& type,
+                           int rank,
+                           hsize_t count,
+                           hsize_t rows);
+
+    const H5::DataType& getType(Component type) const;
+
+    Layout m_layout;
+
     H5::H5File* m_fileHDF5;
     H5::Group* m_frame_group;
     H5::Group* m_section_group;
+    std::vector<char> m_records;  ///< record buffer (FRAMES layout)
+
+    int m_compression;
+    hsize_t m_chunk_frames;
+
+    Frame m_frames[2];     ///< frame buffers (TIME_SERIES layout)
+    int m_fill;            ///< index of the buffer being filled
+    bool m_frame_open;     ///< true if the buffer being filled holds a frame
+    bool m_pending;        ///< true if the other buffer holds a frame not yet written
+    bool m_stop;           ///< request for the writer thread to terminate
+    std::string m_error;   ///< message of an error in the writer thread
+    std::thread m_writer;  ///< writer thread (TIME_SERIES layout)
+    std::mutex m_mutex;    ///< protects m_fill, m_pending and m_stop
+    std::condition_variable m_cv;
+
+    H5::Group* m_sections_group;                    ///< /Sections group (TIME_SERIES layout)
+    SeriesSet* m_time_set;                          ///< /Time dataset (TIME_SERIES layout)
+    std::map<std::string, SeriesSection> m_series;  ///< datasets of all sections
+
+    static std::mutex& getLock();
+
+    H5::CompType m_types[BODY_LOADS + 1];  ///< compound types of the records, indexed by component type
+    H5::CompType m_time_type;              ///< compound type of the /Time records (TIME_SERIES layout)
 
-    static H5::CompType* m_body_type;
-    static H5::CompType* m_bodyaux_type;
-    static H5::CompType* m_shaft_type;
-    static H5::CompType* m_marker_type;
-    static H5::CompType* m_joint_type;
-    static H5::CompType* m_couple_type;
-    static H5::CompType* m_linspring_type;
-    static H5::CompType* m_rotspring_type;
-    static H5::CompType* m_bodyload_type;
-
-    static const H5::CompType& getBodyType();
-    static const H5::CompType& getBodyAuxType();
-    static const H5::CompType& getShaftType();
-    static const H5::CompType& getMarkerType();
-    static const H5::CompType& getJointType();
-    static const H5::CompType& getCoupleType();
-    static const H5::CompType& getLinSpringType();
-    static const H5::CompType& getRotSpringType();
-    static const H5::CompType& getBodyLoadType();
+    static H5::CompType createBodyType();
+    static H5::CompType createBodyAuxType();
+    static H5::CompType createShaftType();
+    static H5::CompType createMarkerType();
+    static H5::CompType createJointType();
+    static H5::CompType createCoupleType();
+    static H5::CompType createLinSpringType();
+    static H5::CompType createRotSpringType();
+    static H5::CompType createBodyLoadType();
+    static H5::CompType createTimeType();
 };
 
 /// @} vehicle
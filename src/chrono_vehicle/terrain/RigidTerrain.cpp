@@ -17,6 +17,7 @@
 // =============================================================================
 
 #include <cmath>
+#include <algorithm>
 #include <cstdio>
 
 #include "chrono/assets/ChBoxShape.h"
@@ -163,6 +164,11 @@ std::shared_ptr<RigidTerrain::Patch> RigidTerrain::AddPatch(const ChCoordsys<>&
     patch->m_body->SetCollide(true);
     m_system->AddBody(patch->m_body);
 
+    // Height-field query index is built at initialization
+    patch->m_indexed = false;
+    patch->m_radius = 0;
+    patch->m_margin = 0;
+
     // Initialize contact material properties
     patch->m_friction = 0.7f;
     switch (m_system->GetContactMethod()) {
@@ -224,6 +230,8 @@ std::shared_ptr<RigidTerrain::Patch> RigidTerrain::AddPatch(const ChCoordsys<>&
         patch->m_body->AddAsset(box);
     }
 
+    patch->m_size = size;
+
     patch->m_type = BOX;
 
     return patch;
@@ -256,6 +264,7 @@ std::shared_ptr<RigidTerrain::Patch> RigidTerrain::AddPatch(const ChCoordsys<>&
     }
 
     patch->m_mesh_name = mesh_name;
+    patch->m_radius = sweep_sphere_radius;
     patch->m_type = MESH;
 
     return patch;
@@ -482,14 +491,284 @@ std::shared_ptr<ChBody> RigidTerrain::Patch::GetGroundBody() const {
 // Initialize all terrain patches
 // -----------------------------------------------------------------------------
 void RigidTerrain::Initialize() {
-    // Nothing to do here.
-    // Kept for consistency and possible future extensions.
+    for (auto patch : m_patches) {
+        patch->BuildIndex();
+    }
+}
+
+// -----------------------------------------------------------------------------
+// Build the height-field query index for a patch.
+// Box patches are queried analytically and require no additional data.
+// For mesh patches, store all faces in absolute frame and bin their XY projections
+// (enlarged by the collision margin) in a uniform grid with approximately one face
+// per cell.
+// The collision model inflates box dimensions by the envelope, and sweeps mesh faces
+// with a sphere of radius equal to the envelope plus the mesh sweep radius.
+// -----------------------------------------------------------------------------
+void RigidTerrain::Patch::BuildIndex() {
+    m_indexed = false;
+    m_faces.clear();
+    m_normals.clear();
+    m_cell_start.clear();
+    m_cell_faces.clear();
+
+    double envelope = m_body->GetCollisionModel()->GetEnvelope();
+
+    if (m_type == BOX) {
+        m_margin = envelope;
+        m_indexed = true;
+        return;
+    }
+
+    m_margin = envelope + m_radius;
+
+    const std::vector<ChVector<>>& vertices = m_trimesh.getCoordsVertices();
+    const std::vector<ChVector<int>>& idx_vertices = m_trimesh.getIndicesVertexes();
+    const ChFrame<>& frame = m_body->GetFrame_REF_to_abs();
+
+    ChVector2<> bbmin(1e30, 1e30);
+    ChVector2<> bbmax(-1e30, -1e30);
+    for (const auto& face : idx_vertices) {
+        ChVector<> A = frame.TransformPointLocalToParent(vertices[face[0]]);
+        ChVector<> B = frame.TransformPointLocalToParent(vertices[face[1]]);
+        ChVector<> C = frame.TransformPointLocalToParent(vertices[face[2]]);
+        ChVector<> nrm = Vcross(B - A, C - A);
+        double len = nrm.Length();
+        // Skip degenerate faces
+        if (len == 0)
+            continue;
+        nrm /= (nrm.z() >= 0) ? len : -len;
+        m_faces.push_back(A);
+        m_faces.push_back(B);
+        m_faces.push_back(C);
+        m_normals.push_back(nrm);
+        bbmin.x() = std::min(bbmin.x(), std::min(A.x(), std::min(B.x(), C.x())));
+        bbmin.y() = std::min(bbmin.y(), std::min(A.y(), std::min(B.y(), C.y())));
+        bbmax.x() = std::max(bbmax.x(), std::max(A.x(), std::max(B.x(), C.x())));
+        bbmax.y() = std::max(bbmax.y(), std::max(A.y(), std::max(B.y(), C.y())));
+    }
+    bbmin -= ChVector2<>(m_margin, m_margin);
+    bbmax += ChVector2<>(m_margin, m_margin);
+
+    int num_faces = (int)m_normals.size();
+    if (num_faces == 0) {
+        m_grid_min = ChVector2<>(0, 0);
+        m_grid_delta = ChVector2<>(1, 1);
+        m_grid_nx = 0;
+        m_grid_ny = 0;
+        m_indexed = true;
+        return;
+    }
+
+    // Set grid dimensions
+    double lx = std::max(bbmax.x() - bbmin.x(), 1e-6);
+    double ly = std::max(bbmax.y() - bbmin.y(), 1e-6);
+    double delta = std::sqrt(lx * ly / num_faces);
+    m_grid_nx = std::max(1, std::min(4096, (int)std::ceil(lx / delta)));
+    m_grid_ny = std::max(1, std::min(4096, (int)std::ceil(ly / delta)));
+    m_grid_min = bbmin;
+    m_grid_delta = ChVector2<>(lx / m_grid_nx, ly / m_grid_ny);
+
+    // Range of grid cells overlapped by the XY projection of a face
+    auto cell_range = [this](int f, int& ix0, int& ix1, int& iy0, int& iy1) {
+        const ChVector<>& A = m_faces[3 * f + 0];
+        const ChVector<>& B = m_faces[3 * f + 1];
+        const ChVector<>& C = m_faces[3 * f + 2];
+        double xmin = std::min(A.x(), std::min(B.x(), C.x())) - m_margin;
+        double xmax = std::max(A.x(), std::max(B.x(), C.x())) + m_margin;
+        double ymin = std::min(A.y(), std::min(B.y(), C.y())) - m_margin;
+        double ymax = std::max(A.y(), std::max(B.y(), C.y())) + m_margin;
+        ix0 = std::max(0, (int)std::floor((xmin - m_grid_min.x()) / m_grid_delta.x()));
+        ix1 = std::min(m_grid_nx - 1, (int)std::floor((xmax - m_grid_min.x()) / m_grid_delta.x()));
+        iy0 = std::max(0, (int)std::floor((ymin - m_grid_min.y()) / m_grid_delta.y()));
+        iy1 = std::min(m_grid_ny - 1, (int)std::floor((ymax - m_grid_min.y()) / m_grid_delta.y()));
+    };
+
+    // Count faces in each cell, then fill the cell lists
+    m_cell_start.assign(m_grid_nx * m_grid_ny + 1, 0);
+    int ix0, ix1, iy0, iy1;
+    for (int f = 0; f < num_faces; f++) {
+        cell_range(f, ix0, ix1, iy0, iy1);
+        for (int iy = iy0; iy <= iy1; iy++)
+            for (int ix = ix0; ix <= ix1; ix++)
+                m_cell_start[iy * m_grid_nx + ix + 1]++;
+    }
+    for (int ic = 0; ic < m_grid_nx * m_grid_ny; ic++)
+        m_cell_start[ic + 1] += m_cell_start[ic];
+
+    m_cell_faces.resize(m_cell_start.back());
+    std::vector<int> cell_fill(m_cell_start.begin(), m_cell_start.end() - 1);
+    for (int f = 0; f < num_faces; f++) {
+        cell_range(f, ix0, ix1, iy0, iy1);
+        for (int iy = iy0; iy <= iy1; iy++)
+            for (int ix = ix0; ix <= ix1; ix++)
+                m_cell_faces[cell_fill[iy * m_grid_nx + ix]++] = f;
+    }
+
+    m_indexed = true;
+}
+
+// -----------------------------------------------------------------------------
+// Find the highest intersection of the vertical line through (x,y) with the
+// capsule of radius r around the segment P0-P1. Return false if there is none.
+// -----------------------------------------------------------------------------
+static bool CapsuleTop(const ChVector<>& P0,
+                       const ChVector<>& P1,
+                       double r,
+                       double x,
+                       double y,
+                       double& z,
+                       ChVector<>& normal) {
+    bool hit = false;
+
+    // End spheres
+    for (const ChVector<>* P : {&P0, &P1}) {
+        double dx = x - P->x();
+        double dy = y - P->y();
+        double d2 = dx * dx + dy * dy;
+        if (d2 > r * r)
+            continue;
+        double zs = P->z() + std::sqrt(r * r - d2);
+        if (!hit || zs > z) {
+            hit = true;
+            z = zs;
+            normal = ChVector<>(dx, dy, zs - P->z()) / r;
+        }
+    }
+
+    // Cylinder around the segment (the end spheres cover vertical segments).
+    // With w = Q - P0 for a point Q = (x,y,P0z+t) on the line, solve |w|^2 - (w.u)^2 = r^2 for the largest t,
+    // and accept it if the projection of Q on the axis is within the segment.
+    ChVector<> d = P1 - P0;
+    double len = d.Length();
+    if (len == 0)
+        return hit;
+    ChVector<> u = d / len;
+    double qa = 1 - u.z() * u.z();
+    if (qa < 1e-10)
+        return hit;
+    double a = x - P0.x();
+    double b = y - P0.y();
+    double c = a * u.x() + b * u.y();
+    double disc = c * c * u.z() * u.z() - qa * (a * a + b * b - c * c - r * r);
+    if (disc < 0)
+        return hit;
+    double t = (c * u.z() + std::sqrt(disc)) / qa;
+    double s = c + t * u.z();
+    if (s < 0 || s > len)
+        return hit;
+    double zc = P0.z() + t;
+    if (!hit || zc > z) {
+        hit = true;
+        z = zc;
+        normal = (ChVector<>(a, b, t) - s * u) / r;
+    }
+
+    return hit;
+}
+
+// -----------------------------------------------------------------------------
+// Find the highest intersection of the vertical segment from (x,y,1000) to
+// (x,y,-1000) with the patch, using the query index.
+// -----------------------------------------------------------------------------
+bool RigidTerrain::Patch::FindPoint(double x, double y, double& height, ChVector<>& normal) const {
+    if (m_type == BOX) {
+        // Slab intersection test in the patch frame
+        const ChFrame<>& frame = m_body->GetFrame_REF_to_abs();
+        ChVector<> from = frame.TransformPointParentToLocal(ChVector<>(x, y, 1000));
+        ChVector<> dir = frame.TransformDirectionParentToLocal(ChVector<>(0, 0, -1));
+        double tmin = 0;
+        double tmax = 2000;
+        int axis = -1;
+        for (unsigned int i = 0; i < 3; i++) {
+            double hsize = 0.5 * m_size[i] + m_margin;
+            if (std::abs(dir[i]) < 1e-12) {
+                if (std::abs(from[i]) > hsize)
+                    return false;
+                continue;
+            }
+            double t1 = (-hsize - from[i]) / dir[i];
+            double t2 = (hsize - from[i]) / dir[i];
+            if (t1 > t2)
+                std::swap(t1, t2);
+            if (t1 > tmin) {
+                tmin = t1;
+                axis = i;
+            }
+            tmax = std::min(tmax, t2);
+            if (tmin > tmax)
+                return false;
+        }
+        // No hit if the segment starts inside the box
+        if (axis == -1)
+            return false;
+        ChVector<> nrm(0, 0, 0);
+        nrm[axis] = (dir[axis] > 0) ? -1 : 1;
+        height = 1000 - tmin;
+        normal = frame.TransformDirectionLocalToParent(nrm);
+        return true;
+    }
+
+    // Locate grid cell
+    int ix = (int)std::floor((x - m_grid_min.x()) / m_grid_delta.x());
+    int iy = (int)std::floor((y - m_grid_min.y()) / m_grid_delta.y());
+    if (ix == m_grid_nx && x <= m_grid_min.x() + m_grid_nx * m_grid_delta.x())
+        ix--;
+    if (iy == m_grid_ny && y <= m_grid_min.y() + m_grid_ny * m_grid_delta.y())
+        iy--;
+    if (ix < 0 || ix >= m_grid_nx || iy < 0 || iy >= m_grid_ny)
+        return false;
+
+    // Intersect the vertical line with all (sphere-swept) faces in the cell. A swept face is the union of the
+    // face offset along its normal, and of the capsules around its edges.
+    bool hit = false;
+    auto update = [&](double z, const ChVector<>& nrm) {
+        if (z > 1000 || z < -1000)
+            return;
+        if (!hit || z > height) {
+            hit = true;
+            height = z;
+            normal = nrm;
+        }
+    };
+
+    double z;
+    ChVector<> nrm;
+    int cell = iy * m_grid_nx + ix;
+    for (int k = m_cell_start[cell]; k < m_cell_start[cell + 1]; k++) {
+        int f = m_cell_faces[k];
+        const ChVector<>& n = m_normals[f];
+        const ChVector<> A = m_faces[3 * f + 0] + m_margin * n;
+        const ChVector<> B = m_faces[3 * f + 1] + m_margin * n;
+        const ChVector<> C = m_faces[3 * f + 2] + m_margin * n;
+
+        // Offset face (barycentric coordinates of XY projection)
+        if (n.z() > 1e-10) {
+            double det = (B.y() - C.y()) * (A.x() - C.x()) + (C.x() - B.x()) * (A.y() - C.y());
+            double l1 = ((B.y() - C.y()) * (x - C.x()) + (C.x() - B.x()) * (y - C.y())) / det;
+            double l2 = ((C.y() - A.y()) * (x - C.x()) + (A.x() - C.x()) * (y - C.y())) / det;
+            double l3 = 1 - l1 - l2;
+            if (l1 >= -1e-12 && l2 >= -1e-12 && l3 >= -1e-12)
+                update(l1 * A.z() + l2 * B.z() + l3 * C.z(), n);
+        }
+
+        // Edge capsules
+        if (m_margin > 0) {
+            for (int i = 0; i < 3; i++) {
+                if (CapsuleTop(m_faces[3 * f + i], m_faces[3 * f + (i + 1) % 3], m_margin, x, y, z, nrm))
+                    update(z, nrm);
+            }
+        }
+    }
+
+    return hit;
 }
 
 // -----------------------------------------------------------------------------
 // Functions for obtaining the terrain height, normal, and coefficient of
 // friction  at the specified location.
-// This is done by casting vertical rays into each patch collision model.
+// Indexed patches are queried directly; for all other patches, this is done by
+// casting vertical rays into the patch collision model.
 // -----------------------------------------------------------------------------
 bool RigidTerrain::FindPoint(double x, double y, double& height, ChVector<>& normal, float& friction) const {
     bool hit = false;
@@ -501,12 +780,22 @@ bool RigidTerrain::FindPoint(double x, double y, double& height, ChVector<>& nor
     ChVector<> to(x, y, -1000);
 
     for (auto patch : m_patches) {
-        collision::ChCollisionSystem::ChRayhitResult result;
-        m_system->GetCollisionSystem()->RayHit(from, to, patch->m_body->GetCollisionModel().get(), result);
-        if (result.hit && result.abs_hitPoint.z() > height) {
+        double patch_height;
+        ChVector<> patch_normal;
+        bool patch_hit;
+        if (patch->m_indexed) {
+            patch_hit = patch->FindPoint(x, y, patch_height, patch_normal);
+        } else {
+            collision::ChCollisionSystem::ChRayhitResult result;
+            m_system->GetCollisionSystem()->RayHit(from, to, patch->m_body->GetCollisionModel().get(), result);
+            patch_hit = result.hit;
+            patch_height = result.abs_hitPoint.z();
+            patch_normal = result.abs_hitNormal;
+        }
+        if (patch_hit && patch_height > height) {
             hit = true;
-            height = result.abs_hitPoint.z();
-            normal = result.abs_hitNormal;
+            height = patch_height;
+            normal = patch_normal;
             friction = patch->m_friction;
         }
     }
@@ -547,6 +836,23 @@ float RigidTerrain::GetCoefficientFriction(double x, double y) const {
     return friction;
 }
 
+void RigidTerrain::GetProperties(const std::vector<ChVector2<>>& loc,
+                                 std::vector<double>& height,
+                                 std::vector<ChVector<>>& normal,
+                                 std::vector<float>& friction) const {
+    height.resize(loc.size());
+    normal.resize(loc.size());
+    friction.resize(loc.size());
+
+    for (size_t i = 0; i < loc.size(); i++) {
+        bool hit = FindPoint(loc[i].x(), loc[i].y(), height[i], normal[i], friction[i]);
+        if (!hit)
+            height[i] = 0.0;
+        if (m_friction_fun)
+            friction[i] = (*m_friction_fun)(loc[i].x(), loc[i].y());
+    }
+}
+
 // -----------------------------------------------------------------------------
 // Export all patch meshes as macros in PovRay include files.
 // -----------------------------------------------------------------------------
@@ -24,6 +24,7 @@
 
 #include "chrono/assets/ChColor.h"
 #include "chrono/assets/ChColorAsset.h"
+#include "chrono/core/ChVector2.h"
 #include "chrono/geometry/ChTriangleMeshConnected.h"
 #include "chrono/physics/ChBody.h"
 #include "chrono/physics/ChSystem.h"
@@ -94,12 +95,36 @@ class CH_VEHICLE_API RigidTerrain : public ChTerrain {
         std::shared_ptr<ChBody> GetGroundBody() const;
 
       private:
+        /// Build the height-field query index for this patch.
+        void BuildIndex();
+
+        /// Find the highest intersection of the vertical line at (x,y) with this patch, using the query index.
+        bool FindPoint(double x, double y, double& height, ChVector<>& normal) const;
+
         Type m_type;
         std::shared_ptr<ChBody> m_body;
         geometry::ChTriangleMeshConnected m_trimesh;
         std::string m_mesh_name;
         float m_friction;
 
+        // Height-field query index.
+        // BOX patches are queried analytically (in the patch frame), MESH and HEIGHT_MAP patches through a
+        // uniform 2D grid over the XY projection of the mesh faces (in absolute frame, with faces stored per
+        // cell in compressed row format). As with ray casts into the collision model, the patch geometry is
+        // inflated by the collision margin: boxes are enlarged and mesh faces are sphere-swept.
+        bool m_indexed;                     ///< true if the query index was built
+        ChVector<> m_size;                  ///< BOX patch dimensions
+        double m_radius;                    ///< sweep sphere radius (MESH patches)
+        double m_margin;                    ///< thickness added to the patch geometry by the collision model
+        std::vector<ChVector<>> m_faces;    ///< face vertices in absolute frame (3 per face)
+        std::vector<ChVector<>> m_normals;  ///< upward face normals in absolute frame
+        ChVector2<> m_grid_min;             ///< lower-left corner of grid
+        ChVector2<> m_grid_delta;           ///< grid cell dimensions
+        int m_grid_nx;                      ///< number of grid cells in X direction
+        int m_grid_ny;                      ///< number of grid cells in Y direction
+        std::vector<int> m_cell_start;      ///< start index of each cell in m_cell_faces
+        std::vector<int> m_cell_faces;      ///< indices of faces overlapping each cell
+
         friend class RigidTerrain;
     };
 
@@ -149,6 +174,10 @@ class CH_VEHICLE_API RigidTerrain : public ChTerrain {
     );
 
     /// Initialize all defined terrain patches.
+    /// This also builds the height-field query index used by GetHeight, GetNormal, and GetCoefficientFriction,
+    /// so that these queries do not require ray casting through the collision system. The index of mesh patches
+    /// reflects their positions at the time of this call; patches added later are queried through ray casting
+    /// until Initialize is called again.
     void Initialize();
 
     /// Get the terrain height at the specified (x,y) location.
@@ -166,6 +195,15 @@ class CH_VEHICLE_API RigidTerrain : public ChTerrain {
     /// value from the appropriate patch, as specified through SetContactFrictionCoefficient.
     virtual float GetCoefficientFriction(double x, double y) const override;
 
+    /// Get the terrain height, normal, and coefficient of friction at multiple (x,y) locations.
+    /// The output vectors are resized to the number of query points. Results for each point are identical to
+    /// those returned by GetHeight, GetNormal, and GetCoefficientFriction.
+    void GetProperties(const std::vector<ChVector2<>>& loc,  ///< [in] query locations (x,y)
+                       std::vector<double>& height,          ///< [out] terrain heights
+                       std::vector<ChVector<>>& normal,      ///< [out] terrain normals
+                       std::vector<float>& friction          ///< [out] coefficients of friction
+                       ) const;
+
     /// Export all patch meshes as macros in PovRay include files.
     void ExportMeshPovray(const std::string& out_dir  ///< [in] output directory
     );
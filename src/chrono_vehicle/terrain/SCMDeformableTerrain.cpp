@@ -20,12 +20,14 @@
 #include <cstdio>
 #include <cmath>
 #include <queue>
+#include <algorithm>
 
 #include "chrono/physics/ChMaterialSurfaceNSC.h"
 #include "chrono/physics/ChMaterialSurfaceSMC.h"
 #include "chrono/assets/ChTexture.h"
 #include "chrono/assets/ChBoxShape.h"
 #include "chrono/utils/ChConvexHull.h"
+#include "chrono/utils/ChProfiler.h"
 
 #include "chrono_vehicle/ChVehicleModelData.h"
 #include "chrono_vehicle/terrain/SCMDeformableTerrain.h"
@@ -502,8 +504,45 @@ void SCMDeformableSoil::SetupAuxData() {
     m_trimesh_shape->GetMesh().ComputeNeighbouringTriangleMap(this->tri_map);
 }
 
+// Collect the AABBs of the collision-enabled items of an assembly (recursively) that overlap the given region.
+// An item without a bounding box (infinite AABB) sets 'unbounded' instead of adding a box that overlaps every
+// ray; bounded items, however large, only affect the rays that cross them.
+static void CollectCollisionAABBs(ChAssembly& assembly,
+                                  const ChVector<>& region_min,
+                                  const ChVector<>& region_max,
+                                  std::vector<std::pair<ChVector<>, ChVector<>>>& aabbs,
+                                  bool& unbounded) {
+    auto add = [&](ChPhysicsItem& item) {
+        ChVector<> bbmin, bbmax;
+        item.GetTotalAABB(bbmin, bbmax);
+        if (bbmin.x() <= -1e100 || bbmin.y() <= -1e100 || bbmin.z() <= -1e100 ||  //
+            bbmax.x() >= 1e100 || bbmax.y() >= 1e100 || bbmax.z() >= 1e100) {
+            unbounded = true;
+            return;
+        }
+        if (bbmax.x() >= region_min.x() && bbmin.x() <= region_max.x() &&  //
+            bbmax.y() >= region_min.y() && bbmin.y() <= region_max.y() &&  //
+            bbmax.z() >= region_min.z() && bbmin.z() <= region_max.z()) {
+            aabbs.push_back(std::make_pair(bbmin, bbmax));
+        }
+    };
+
+    for (const auto& body : *assembly.Get_bodylist()) {
+        if (body->GetCollide())
+            add(*body);
+    }
+    for (const auto& item : *assembly.Get_otherphysicslist()) {
+        if (auto sub_assembly = std::dynamic_pointer_cast<ChAssembly>(item))
+            CollectCollisionAABBs(*sub_assembly, region_min, region_max, aabbs, unbounded);
+        else if (item->GetCollide())
+            add(*item);
+    }
+}
+
 // Reset the list of forces, and fills it with forces from a soil contact model.
 void SCMDeformableSoil::ComputeInternalForces() {
+    CH_PROFILE_ZONE("SCMDeformableSoil::ComputeInternalForces");
+
     m_timer_calc_areas.reset();
     m_timer_ray_casting.reset();
     m_timer_refinement.reset();
@@ -572,24 +611,41 @@ void SCMDeformableSoil::ComputeInternalForces() {
         patch_max.y() = center.y() + m_patch_dim.y() / 2;
     }
 
-    // Loop through all vertices.
+    // Region swept by the rays of all vertices
+    ChVector<> region_min(1e200, 1e200, 1e200);
+    ChVector<> region_max(-1e200, -1e200, -1e200);
+    for (const auto& v : vertices) {
+        for (const auto& p : {v + N * test_high_offset, v + N * (test_high_offset - test_low_offset)}) {
+            region_min.Set(std::min(region_min.x(), p.x()), std::min(region_min.y(), p.y()),
+                           std::min(region_min.z(), p.z()));
+            region_max.Set(std::max(region_max.x(), p.x()), std::max(region_max.y(), p.y()),
+                           std::max(region_max.z(), p.z()));
+        }
+    }
+
+    // Collect the AABBs of the collision-enabled items that overlap this region. A vertex whose ray does not
+    // intersect any of these boxes cannot register a hit, so no ray test is needed.
+    std::vector<std::pair<ChVector<>, ChVector<>>> aabbs;
+    bool cast_all = false;
+    CollectCollisionAABBs(*GetSystem(), region_min, region_max, aabbs, cast_all);
+
+    // Loop through all vertices (multithreaded).
     // - set default SCM quantities (in case no ray-hit)
     // - skip vertices outside moving patch (if option enabled)
-    // - cast ray and record result in a map (key: vertex index)
-    // - initialize patch id to -1 (not set)
-    struct HitRecord {
-        ChContactable* contactable;  // pointer to hit object
-        ChVector<> abs_point;        // hit point, expressed in global frame
-        int patch_id;                // index of associated patch id
-    };
-    std::unordered_map<int, HitRecord> hits;
+    // - skip vertices whose ray does not intersect any collision AABB
+    // - flag the vertices whose ray must be cast
+    int num_vertices = (int)vertices.size();
+    std::vector<char> ray_cast(num_vertices, 0);
 
-    for (int i = 0; i < vertices.size(); ++i) {
+    // (erosion flags are packed bits, reset them outside the parallel loop)
+    std::fill(p_erosion.begin(), p_erosion.end(), false);
+
+#pragma omp parallel for num_threads(GetSystem()->GetParallelThreadNumber()) schedule(static)
+    for (int i = 0; i < num_vertices; ++i) {
         // Initialize SCM quantities at current vertex
         p_sigma[i] = 0;
         p_sinkage_elastic[i] = 0;
         p_step_plastic_flow[i] = 0;
-        p_erosion[i] = false;
         p_level[i] = plane.TransformParentToLocal(vertices[i]).y();
         p_hit_level[i] = 1e9;
 
@@ -601,15 +657,55 @@ void SCMDeformableSoil::ComputeInternalForces() {
             }
         }
 
-        // Perform ray casting from current vertex
-        collision::ChCollisionSystem::ChRayhitResult mrayhit_result;
+        // Skip vertices that no collision model can touch
         ChVector<> to = vertices[i] + N * test_high_offset;
         ChVector<> from = to - N * test_low_offset;
-        this->GetSystem()->GetCollisionSystem()->RayHit(from, to, mrayhit_result);
-        m_num_ray_casts++;
-        if (mrayhit_result.hit) {
-            HitRecord record = { mrayhit_result.hitModel->GetContactable(), mrayhit_result.abs_hitPoint, -1 };
-            hits.insert(std::make_pair(i, record));
+        ChVector<> ray_min(std::min(from.x(), to.x()), std::min(from.y(), to.y()), std::min(from.z(), to.z()));
+        ChVector<> ray_max(std::max(from.x(), to.x()), std::max(from.y(), to.y()), std::max(from.z(), to.z()));
+        bool overlap = cast_all;
+        for (const auto& aabb : aabbs) {
+            if (ray_max.x() >= aabb.first.x() && ray_min.x() <= aabb.second.x() &&  //
+                ray_max.y() >= aabb.first.y() && ray_min.y() <= aabb.second.y() &&  //
+                ray_max.z() >= aabb.first.z() && ray_min.z() <= aabb.second.z()) {
+                overlap = true;
+                break;
+            }
+        }
+        ray_cast[i] = overlap;
+    }
+
+    // Collect the rays to be cast
+    std::vector<int> ray_vertices;
+    std::vector<ChVector<>> ray_from;
+    std::vector<ChVector<>> ray_to;
+
+    for (int i = 0; i < num_vertices; ++i) {
+        if (!ray_cast[i])
+            continue;
+        ChVector<> to = vertices[i] + N * test_high_offset;
+        ray_vertices.push_back(i);
+        ray_from.push_back(to - N * test_low_offset);
+        ray_to.push_back(to);
+    }
+
+    // Cast all rays (multithreaded, if supported by the collision system) and record the
+    // results in a map (key: vertex index). Initialize patch id to -1 (not set).
+    struct HitRecord {
+        ChContactable* contactable;  // pointer to hit object
+        ChVector<> abs_point;        // hit point, expressed in global frame
+        int patch_id;                // index of associated patch id
+    };
+    std::unordered_map<int, HitRecord> hits;
+
+    std::vector<collision::ChCollisionSystem::ChRayhitResult> ray_results;
+    GetSystem()->GetCollisionSystem()->RayHitBatch(ray_from, ray_to, ray_results,
+                                                   GetSystem()->GetParallelThreadNumber());
+    m_num_ray_casts = ray_vertices.size();
+
+    for (size_t k = 0; k < ray_vertices.size(); ++k) {
+        if (ray_results[k].hit) {
+            HitRecord record = {ray_results[k].hitModel->GetContactable(), ray_results[k].abs_hitPoint, -1};
+            hits.insert(std::make_pair(ray_vertices[k], record));
         }
     }
 
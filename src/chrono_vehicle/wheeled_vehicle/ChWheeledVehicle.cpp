@@ -18,6 +18,8 @@
 
 #include <fstream>
 
+#include "chrono/utils/ChProfiler.h"
+
 #include "chrono_vehicle/wheeled_vehicle/ChWheeledVehicle.h"
 
 #include "chrono_thirdparty/rapidjson/document.h"
@@ -58,6 +60,8 @@ void ChWheeledVehicle::Synchronize(double time,
                                    double braking,
                                    double powertrain_torque,
                                    const TerrainForces& tire_forces) {
+    CH_PROFILE_ZONE("ChWheeledVehicle::Synchronize");
+
     // Apply powertrain torque to the driveline's input shaft.
     m_driveline->Synchronize(powertrain_torque);
 
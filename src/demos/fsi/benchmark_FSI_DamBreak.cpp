@@ -0,0 +1,169 @@
+// =============================================================================
+// PROJECT CHRONO - http://projectchrono.org
+//
+// Copyright (c) 2014 projectchrono.org
+// All rights reserved.
+//
+// Use of this source code is governed by a BSD-style license that can be found
+// in the LICENSE file at the top level of the distribution and at
+// http://projectchrono.org/license-chrono.txt.
+//
+// =============================================================================
+//
+// Chrono::FSI benchmark program: the dam break case of demo_FSI_DamBreak is
+// simulated for a fixed number of steps, without output, and the time spent per
+// step is reported, for either the CUDA or the CPU (USE_FSI_CPU) build of the
+// module. The position of the fluid center of mass is printed at the end, for
+// comparison of the results of the different builds.
+//
+// Usage: benchmark_FSI_DamBreak [num_steps [num_threads]]
+// (the number of threads is only used by the CPU build with OpenMP)
+//
+// =============================================================================
+
+#include <cstdio>
+#include <cstdlib>
+#include <iostream>
+#include <vector>
+
+#include "chrono/core/ChTimer.h"
+#include "chrono/parallel/ChOpenMP.h"
+#include "chrono/utils/ChUtilsCreators.h"
+#include "chrono/utils/ChUtilsGenerators.h"
+
+#include "chrono_parallel/physics/ChSystemParallel.h"
+
+#include "chrono_fsi/ChDeviceUtils.cuh"
+#include "chrono_fsi/ChFsiTypeConvert.h"
+#include "chrono_fsi/ChSystemFsi.h"
+#include "chrono_fsi/utils/ChUtilsGeneratorFsi.h"
+
+#include "demos/fsi/demo_FSI_DamBreak.h"
+
+using namespace chrono;
+using namespace chrono::collision;
+
+using std::cout;
+using std::endl;
+
+typedef fsi::Real Real;
+
+// Dimension of the domain
+Real bxDim = 5;
+Real byDim = 0.5;
+Real bzDim = 2.5;
+
+// Dimension of the fluid domain
+Real fxDim = 2;
+Real fyDim = byDim;
+Real fzDim = 2;
+
+// Ground body with the container walls and their BCE markers (as in demo_FSI_DamBreak)
+void CreateContainer(ChSystemParallelNSC& mphysicalSystem, fsi::ChSystemFsi& myFsiSystem, fsi::SimParams* paramsH) {
+    auto ground = std::make_shared<ChBody>(std::make_shared<ChCollisionModelParallel>());
+    ground->SetIdentifier(-1);
+    ground->SetBodyFixed(true);
+    ground->SetCollide(true);
+    ground->GetCollisionModel()->ClearModel();
+
+    ChVector<> sizeBottom(bxDim / 2 + 3 * paramsH->HSML, byDim / 2 + 3 * paramsH->HSML, 2 * paramsH->HSML);
+    ChVector<> posBottom(0, 0, -2 * paramsH->HSML);
+    ChVector<> posTop(0, 0, bzDim + 2 * paramsH->HSML);
+
+    ChVector<> size_YZ(2 * paramsH->HSML, byDim / 2 + 3 * paramsH->HSML, bzDim / 2);
+    ChVector<> pos_xp(bxDim / 2 + paramsH->HSML, 0.0, bzDim / 2 + 1 * paramsH->HSML);
+    ChVector<> pos_xn(-bxDim / 2 - 3 * paramsH->HSML, 0.0, bzDim / 2 + 1 * paramsH->HSML);
+
+    chrono::utils::AddBoxGeometry(ground.get(), sizeBottom, posBottom, chrono::QUNIT, true);
+    chrono::utils::AddBoxGeometry(ground.get(), size_YZ, pos_xp, chrono::QUNIT, true);
+    chrono::utils::AddBoxGeometry(ground.get(), size_YZ, pos_xn, chrono::QUNIT, true);
+    ground->GetCollisionModel()->BuildModel();
+    mphysicalSystem.AddBody(ground);
+
+    fsi::utils::AddBoxBce(myFsiSystem.GetDataManager(), paramsH, ground, posBottom, chrono::QUNIT, sizeBottom);
+    fsi::utils::AddBoxBce(myFsiSystem.GetDataManager(), paramsH, ground, posTop, chrono::QUNIT, sizeBottom);
+    fsi::utils::AddBoxBce(myFsiSystem.GetDataManager(), paramsH, ground, pos_xp, chrono::QUNIT, size_YZ, 23);
+    fsi::utils::AddBoxBce(myFsiSystem.GetDataManager(), paramsH, ground, pos_xn, chrono::QUNIT, size_YZ, 23);
+}
+
+// Center of mass of the fluid markers
+ChVector<> FluidCenter(fsi::ChSystemFsi& myFsiSystem, int numFluid) {
+    thrust::host_vector<fsi::Real3> posRadH = myFsiSystem.GetDataManager()->sphMarkersD2.posRadD;
+    ChVector<> center(0, 0, 0);
+    for (int i = 0; i < numFluid; i++)
+        center += fsi::ChFsiTypeConvert::Real3ToChVector(posRadH[i]);
+    return center / numFluid;
+}
+
+int main(int argc, char* argv[]) {
+    int num_steps = 500;
+    int num_threads = CHOMPfunctions::GetNumProcs();
+    if (argc > 1)
+        num_steps = std::atoi(argv[1]);
+    if (argc > 2)
+        num_threads = std::atoi(argv[2]);
+
+    CHOMPfunctions::SetNumThreads(num_threads);
+
+    ChSystemParallelNSC mphysicalSystem;
+    mphysicalSystem.GetSettings()->max_threads = num_threads;
+    fsi::ChSystemFsi myFsiSystem(&mphysicalSystem, true);
+    fsi::SimParams* paramsH = myFsiSystem.GetSimParams();
+    fsi::SetupParamsH(paramsH, bxDim, byDim, bzDim, fxDim, fyDim, fzDim);
+
+    // Fluid markers
+    Real initSpace0 = paramsH->MULT_INITSPACE * paramsH->HSML;
+    chrono::utils::GridSampler<> sampler(initSpace0);
+    fsi::Real3 boxCenter = fsi::mR3(-bxDim / 2 + fxDim / 2, 0, fzDim / 2 + 1 * paramsH->HSML);
+    fsi::Real3 boxHalfDim = fsi::mR3(fxDim / 2, fyDim / 2 + 3 * paramsH->HSML, fzDim / 2);
+    chrono::utils::Generator::PointVector points = sampler.SampleBox(
+        fsi::ChFsiTypeConvert::Real3ToChVector(boxCenter), fsi::ChFsiTypeConvert::Real3ToChVector(boxHalfDim));
+    int numFluid = (int)points.size();
+    for (int i = 0; i < numFluid; i++) {
+        myFsiSystem.GetDataManager()->AddSphMarker(fsi::mR3(points[i].x(), points[i].y(), points[i].z()), fsi::mR3(0),
+                                                   fsi::mR4(paramsH->rho0, paramsH->BASEPRES, paramsH->mu0, -1));
+    }
+    myFsiSystem.GetDataManager()->fsiGeneralData.referenceArray.push_back(fsi::mI4(0, numFluid, -1, -1));
+    myFsiSystem.GetDataManager()->fsiGeneralData.referenceArray.push_back(fsi::mI4(numFluid, numFluid, 0, 0));
+
+    CreateContainer(mphysicalSystem, myFsiSystem, paramsH);
+    myFsiSystem.Finalize();
+
+    int numMarkers = myFsiSystem.GetDataManager()->numObjects.numAllMarkers;
+
+#ifdef CHRONO_FSI_USE_CPU
+    cout << "Chrono::FSI CPU build, " << num_threads << " threads" << endl;
+#else
+    cout << "Chrono::FSI CUDA build" << endl;
+#endif
+#ifdef CHRONO_FSI_USE_DOUBLE
+    cout << "Double precision" << endl;
+#else
+    cout << "Single precision" << endl;
+#endif
+    cout << "Markers: " << numMarkers << " (fluid: " << numFluid << ")" << endl;
+    cout << "Steps:   " << num_steps << endl;
+
+    // Warm up (allocations of the first steps are not timed)
+    int num_warmup = 10;
+    for (int i = 0; i < num_warmup; i++)
+        myFsiSystem.DoStepDynamics_FSI();
+
+    ChTimer<double> timer;
+    timer.start();
+    for (int i = 0; i < num_steps; i++)
+        myFsiSystem.DoStepDynamics_FSI();
+    timer.stop();
+
+    double time = timer.GetTimeSeconds();
+    ChVector<> center = FluidCenter(myFsiSystem, numFluid);
+
+    cout << endl;
+    cout << "Simulation time:   " << (num_warmup + num_steps) * paramsH->dT << " s" << endl;
+    cout << "Total time:        " << time << " s" << endl;
+    cout << "Time per step:     " << 1e3 * time / num_steps << " ms" << endl;
+    cout << "Marker updates/s:  " << numMarkers * (double)num_steps / time << endl;
+    cout << "Fluid center:      " << center.x() << "  " << center.y() << "  " << center.z() << endl;
+
+    return 0;
+}
@@ -0,0 +1,177 @@
+// =============================================================================
+// PROJECT CHRONO - http://projectchrono.org
+//
+// Copyright (c) 2016 projectchrono.org
+// All rights reserved.
+//
+// Use of this source code is governed by a BSD-style license that can be found
+// in the LICENSE file at the top level of the distribution and at
+// http://projectchrono.org/license-chrono.txt.
+//
+// =============================================================================
+//
+// ChronoParallel benchmark for the cost of the deterministic mode
+// (settings.deterministic).
+//
+// A pile of spheres settling in a box is simulated with the NSC and SMC (with
+// contact history) formulations, with and without the deterministic mode, for
+// an increasing number of threads. The average step time and the collision
+// detection time are reported for each configuration.
+//
+// The global reference frame has Z up.
+// =============================================================================
+
+#include <cstdio>
+#include <vector>
+
+#include "chrono/core/ChTimer.h"
+#include "chrono/utils/ChUtilsCreators.h"
+
+#include "chrono_parallel/physics/ChSystemParallel.h"
+
+using namespace chrono;
+using namespace chrono::collision;
+
+// Number of spheres: (2 * count_X + 1) * (2 * count_Y + 1) * count_Z
+int count_X = 15;
+int count_Y = 15;
+int count_Z = 8;
+
+double time_step = 1e-3;
+int num_settling_steps = 200;
+int num_timed_steps = 200;
+
+// -----------------------------------------------------------------------------
+// Create the container and the spheres.
+// -----------------------------------------------------------------------------
+void CreateModel(ChSystemParallel* sys, std::shared_ptr<ChMaterialSurface> mat) {
+    ChMaterialSurface::ContactMethod method = mat->GetContactMethod();
+    double radius = 0.05;
+    double spacing = 2.1 * radius;
+    ChVector<> hdim((count_X + 1) * spacing, (count_Y + 1) * spacing, count_Z * spacing);
+    double hthick = 0.1;
+
+    auto bin = std::make_shared<ChBody>(std::make_shared<ChCollisionModelParallel>(), method);
+    bin->SetMaterialSurface(mat);
+    bin->SetBodyFixed(true);
+    bin->SetCollide(true);
+    bin->GetCollisionModel()->ClearModel();
+    utils::AddBoxGeometry(bin.get(), ChVector<>(hdim.x(), hdim.y(), hthick), ChVector<>(0, 0, -hthick));
+    utils::AddBoxGeometry(bin.get(), ChVector<>(hthick, hdim.y(), hdim.z()), ChVector<>(-hdim.x() - hthick, 0, hdim.z()));
+    utils::AddBoxGeometry(bin.get(), ChVector<>(hthick, hdim.y(), hdim.z()), ChVector<>(hdim.x() + hthick, 0, hdim.z()));
+    utils::AddBoxGeometry(bin.get(), ChVector<>(hdim.x(), hthick, hdim.z()), ChVector<>(0, -hdim.y() - hthick, hdim.z()));
+    utils::AddBoxGeometry(bin.get(), ChVector<>(hdim.x(), hthick, hdim.z()), ChVector<>(0, hdim.y() + hthick, hdim.z()));
+    bin->GetCollisionModel()->BuildModel();
+    sys->AddBody(bin);
+
+    int id = 0;
+    for (int iz = 0; iz < count_Z; iz++) {
+        for (int ix = -count_X; ix <= count_X; ix++) {
+            for (int iy = -count_Y; iy <= count_Y; iy++) {
+                double offset = 0.2 * radius * ((id++ % 7) - 3) / 3;
+                auto ball = std::make_shared<ChBody>(std::make_shared<ChCollisionModelParallel>(), method);
+                ball->SetMaterialSurface(mat);
+                ball->SetMass(1);
+                ball->SetInertiaXX(0.4 * radius * radius * ChVector<>(1, 1, 1));
+                ball->SetPos(ChVector<>(spacing * ix + offset, spacing * iy - offset, radius + spacing * iz));
+                ball->SetCollide(true);
+                ball->GetCollisionModel()->ClearModel();
+                utils::AddSphereGeometry(ball.get(), radius);
+                ball->GetCollisionModel()->BuildModel();
+                sys->AddBody(ball);
+            }
+        }
+    }
+}
+
+// -----------------------------------------------------------------------------
+// Settle the pile, then time the following steps. Return the average step time
+// and the average collision detection time (in ms).
+// -----------------------------------------------------------------------------
+void Run(ChSystemParallel* sys, int nthreads, bool deterministic, double& step_time, double& cd_time) {
+    sys->Set_G_acc(ChVector<>(0, 0, -9.81));
+    sys->GetSettings()->deterministic = deterministic;
+    sys->GetSettings()->perform_thread_tuning = false;
+    sys->GetSettings()->max_threads = nthreads;
+    sys->GetSettings()->solver.max_iteration_bilateral = 0;
+    sys->GetSettings()->collision.bins_per_axis = vec3(20, 20, 10);
+    sys->SetParallelThreadNumber(nthreads);
+    CHOMPfunctions::SetNumThreads(nthreads);
+
+    for (int i = 0; i < num_settling_steps; i++)
+        sys->DoStepDynamics(time_step);
+
+    ChTimer<double> timer;
+    timer.reset();
+    cd_time = 0;
+    for (int i = 0; i < num_timed_steps; i++) {
+        timer.start();
+        sys->DoStepDynamics(time_step);
+        timer.stop();
+        cd_time += sys->GetTimerCollision();
+    }
+
+    step_time = 1e3 * timer() / num_timed_steps;
+    cd_time = 1e3 * cd_time / num_timed_steps;
+}
+
+void RunNSC(int nthreads, bool deterministic, double& step_time, double& cd_time) {
+    ChSystemParallelNSC sys;
+    sys.GetSettings()->solver.solver_mode = SolverMode::SLIDING;
+    sys.GetSettings()->solver.max_iteration_normal = 0;
+    sys.GetSettings()->solver.max_iteration_sliding = 50;
+    sys.GetSettings()->solver.max_iteration_spinning = 0;
+    sys.GetSettings()->collision.collision_envelope = 0.0025;
+    sys.ChangeSolverType(SolverType::APGD);
+
+    auto mat = std::make_shared<ChMaterialSurfaceNSC>();
+    mat->SetFriction(0.4f);
+    CreateModel(&sys, mat);
+
+    Run(&sys, nthreads, deterministic, step_time, cd_time);
+}
+
+void RunSMC(int nthreads, bool deterministic, double& step_time, double& cd_time) {
+    ChSystemParallelSMC sys;
+    sys.GetSettings()->solver.contact_force_model = ChSystemSMC::ContactForceModel::Hertz;
+    sys.GetSettings()->solver.tangential_displ_mode = ChSystemSMC::TangentialDisplacementModel::MultiStep;
+
+    auto mat = std::make_shared<ChMaterialSurfaceSMC>();
+    mat->SetYoungModulus(1e7f);
+    mat->SetFriction(0.4f);
+    mat->SetRestitution(0.1f);
+    CreateModel(&sys, mat);
+
+    Run(&sys, nthreads, deterministic, step_time, cd_time);
+}
+
+// -----------------------------------------------------------------------------
+// -----------------------------------------------------------------------------
+int main(int argc, char* argv[]) {
+    int max_threads = CHOMPfunctions::GetNumProcs();
+    std::vector<int> threads;
+    for (int nthreads = 1; nthreads < max_threads; nthreads *= 2)
+        threads.push_back(nthreads);
+    threads.push_back(max_threads);
+
+    printf("Spheres: %d   timed steps: %d\n", (2 * count_X + 1) * (2 * count_Y + 1) * count_Z, num_timed_steps);
+    printf("Average times per step [ms] (total / collision detection)\n\n");
+    printf("       threads |      default      |   deterministic   | overhead\n");
+
+    for (int method = 0; method < 2; method++) {
+        for (auto nthreads : threads) {
+            double step_def, cd_def, step_det, cd_det;
+            if (method == 0) {
+                RunNSC(nthreads, false, step_def, cd_def);
+                RunNSC(nthreads, true, step_det, cd_det);
+            } else {
+                RunSMC(nthreads, false, step_def, cd_def);
+                RunSMC(nthreads, true, step_det, cd_det);
+            }
+            printf("  %s  %6d | %8.3f %8.3f | %8.3f %8.3f | %6.1f%%\n", method == 0 ? "NSC" : "SMC", nthreads,
+                   step_def, cd_def, step_det, cd_det, 100 * (step_det - step_def) / step_def);
+        }
+    }
+
+    return 0;
+}
@@ -0,0 +1,174 @@
+// =============================================================================
+// PROJECT CHRONO - http://projectchrono.org
+//
+// Copyright (c) 2016 projectchrono.org
+// All rights reserved.
+//
+// Use of this source code is governed by a BSD-style license that can be found
+// in the LICENSE file at the top level of the distribution and at
+// http://projectchrono.org/license-chrono.txt.
+//
+// =============================================================================
+//
+// ChronoParallel benchmark for the SIMD evaluation of the SMC contact forces
+// (settings.solver.use_simd_contact_forces).
+//
+// A pile of spheres settling in a box is simulated with the Hooke and Hertz
+// contact force models (without contact history), with the SIMD kernel and with
+// the scalar kernel, for an increasing number of threads. The average step time
+// and the contact processing time (contact forces and their reduction per body)
+// are reported for each configuration.
+//
+// The SIMD kernel is only available if Chrono::Parallel is built with SSE or
+// AVX support. Otherwise both configurations use the scalar kernel.
+//
+// The global reference frame has Z up.
+// =============================================================================
+
+#include <cstdio>
+#include <vector>
+
+#include "chrono/core/ChTimer.h"
+#include "chrono/utils/ChUtilsCreators.h"
+
+#include "chrono_parallel/physics/ChSystemParallel.h"
+
+using namespace chrono;
+using namespace chrono::collision;
+
+// Number of spheres: (2 * count_X + 1) * (2 * count_Y + 1) * count_Z
+int count_X = 20;
+int count_Y = 20;
+int count_Z = 10;
+
+double time_step = 1e-4;
+int num_settling_steps = 500;
+int num_timed_steps = 200;
+
+// -----------------------------------------------------------------------------
+// Create the container and the spheres.
+// -----------------------------------------------------------------------------
+void CreateModel(ChSystemParallelSMC* sys) {
+    auto mat = std::make_shared<ChMaterialSurfaceSMC>();
+    mat->SetYoungModulus(1e7f);
+    mat->SetFriction(0.4f);
+    mat->SetRestitution(0.1f);
+
+    double radius = 0.05;
+    double spacing = 2.1 * radius;
+    ChVector<> hdim((count_X + 1) * spacing, (count_Y + 1) * spacing, count_Z * spacing);
+    double hthick = 0.1;
+
+    auto bin = std::make_shared<ChBody>(std::make_shared<ChCollisionModelParallel>(), ChMaterialSurface::SMC);
+    bin->SetMaterialSurface(mat);
+    bin->SetBodyFixed(true);
+    bin->SetCollide(true);
+    bin->GetCollisionModel()->ClearModel();
+    utils::AddBoxGeometry(bin.get(), ChVector<>(hdim.x(), hdim.y(), hthick), ChVector<>(0, 0, -hthick));
+    utils::AddBoxGeometry(bin.get(), ChVector<>(hthick, hdim.y(), hdim.z()), ChVector<>(-hdim.x() - hthick, 0, hdim.z()));
+    utils::AddBoxGeometry(bin.get(), ChVector<>(hthick, hdim.y(), hdim.z()), ChVector<>(hdim.x() + hthick, 0, hdim.z()));
+    utils::AddBoxGeometry(bin.get(), ChVector<>(hdim.x(), hthick, hdim.z()), ChVector<>(0, -hdim.y() - hthick, hdim.z()));
+    utils::AddBoxGeometry(bin.get(), ChVector<>(hdim.x(), hthick, hdim.z()), ChVector<>(0, hdim.y() + hthick, hdim.z()));
+    bin->GetCollisionModel()->BuildModel();
+    sys->AddBody(bin);
+
+    int id = 0;
+    for (int iz = 0; iz < count_Z; iz++) {
+        for (int ix = -count_X; ix <= count_X; ix++) {
+            for (int iy = -count_Y; iy <= count_Y; iy++) {
+                double offset = 0.2 * radius * ((id++ % 7) - 3) / 3;
+                auto ball = std::make_shared<ChBody>(std::make_shared<ChCollisionModelParallel>(), ChMaterialSurface::SMC);
+                ball->SetMaterialSurface(mat);
+                ball->SetMass(1);
+                ball->SetInertiaXX(0.4 * radius * radius * ChVector<>(1, 1, 1));
+                ball->SetPos(ChVector<>(spacing * ix + offset, spacing * iy - offset, radius + spacing * iz));
+                ball->SetCollide(true);
+                ball->GetCollisionModel()->ClearModel();
+                utils::AddSphereGeometry(ball.get(), radius);
+                ball->GetCollisionModel()->BuildModel();
+                sys->AddBody(ball);
+            }
+        }
+    }
+}
+
+// -----------------------------------------------------------------------------
+// Settle the pile, then time the following steps. Return the average step time,
+// the average contact processing time (in ms) and the average number of contacts.
+// -----------------------------------------------------------------------------
+void Run(ChSystemSMC::ContactForceModel model,
+         int nthreads,
+         bool use_simd,
+         double& step_time,
+         double& contact_time,
+         int& num_contacts) {
+    ChSystemParallelSMC sys;
+    sys.Set_G_acc(ChVector<>(0, 0, -9.81));
+    sys.GetSettings()->solver.contact_force_model = model;
+    sys.GetSettings()->solver.tangential_displ_mode = ChSystemSMC::TangentialDisplacementModel::OneStep;
+    sys.GetSettings()->solver.use_simd_contact_forces = use_simd;
+    sys.GetSettings()->perform_thread_tuning = false;
+    sys.GetSettings()->max_threads = nthreads;
+    sys.GetSettings()->solver.max_iteration_bilateral = 0;
+    sys.GetSettings()->collision.bins_per_axis = vec3(20, 20, 10);
+    sys.SetParallelThreadNumber(nthreads);
+    CHOMPfunctions::SetNumThreads(nthreads);
+
+    CreateModel(&sys);
+
+    for (int i = 0; i < num_settling_steps; i++)
+        sys.DoStepDynamics(time_step);
+
+    ChTimer<double> timer;
+    timer.reset();
+    contact_time = 0;
+    double contacts = 0;
+    for (int i = 0; i < num_timed_steps; i++) {
+        timer.start();
+        sys.DoStepDynamics(time_step);
+        timer.stop();
+        contact_time += sys.GetTimerProcessContact();
+        contacts += sys.GetNcontacts();
+    }
+
+    step_time = 1e3 * timer() / num_timed_steps;
+    contact_time = 1e3 * contact_time / num_timed_steps;
+    num_contacts = (int)(contacts / num_timed_steps);
+}
+
+// -----------------------------------------------------------------------------
+// -----------------------------------------------------------------------------
+int main(int argc, char* argv[]) {
+    int max_threads = CHOMPfunctions::GetNumProcs();
+    std::vector<int> threads;
+    for (int nthreads = 1; nthreads < max_threads; nthreads *= 2)
+        threads.push_back(nthreads);
+    threads.push_back(max_threads);
+
+#if defined(USE_AVX)
+    const char* simd = "AVX";
+#elif defined(USE_SSE)
+    const char* simd = "SSE";
+#else
+    const char* simd = "none";
+#endif
+
+    printf("Spheres: %d   timed steps: %d   SIMD: %s\n", (2 * count_X + 1) * (2 * count_Y + 1) * count_Z,
+           num_timed_steps, simd);
+    printf("Average times per step [ms] (total / contact processing)\n\n");
+    printf("         threads | contacts |      scalar       |       SIMD        | speedup\n");
+
+    for (auto model : {ChSystemSMC::ContactForceModel::Hooke, ChSystemSMC::ContactForceModel::Hertz}) {
+        for (auto nthreads : threads) {
+            double step_scalar, ct_scalar, step_simd, ct_simd;
+            int num_contacts;
+            Run(model, nthreads, false, step_scalar, ct_scalar, num_contacts);
+            Run(model, nthreads, true, step_simd, ct_simd, num_contacts);
+            printf("  %s  %6d | %8d | %8.3f %8.3f | %8.3f %8.3f | %6.2fx\n",
+                   model == ChSystemSMC::ContactForceModel::Hooke ? "Hooke" : "Hertz", nthreads, num_contacts,
+                   step_scalar, ct_scalar, step_simd, ct_simd, ct_scalar / ct_simd);
+        }
+    }
+
+    return 0;
+}
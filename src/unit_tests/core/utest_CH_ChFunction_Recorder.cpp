@@ -0,0 +1,119 @@
+// =============================================================================
+// PROJECT CHRONO - http://projectchrono.org
+//
+// Copyright (c) 2014 projectchrono.org
+// All rights reserved.
+//
+// Use of this source code is governed by a BSD-style license that can be found
+// in the LICENSE file at the top level of the distribution and at
+// http://projectchrono.org/license-chrono.txt.
+//
+// =============================================================================
+//
+// Unit test for ChFunction_Recorder
+//
+// =============================================================================
+
+#include <cmath>
+#include <iostream>
+#include <thread>
+#include <vector>
+
+#include "chrono/motion_functions/ChFunction_Recorder.h"
+
+using namespace chrono;
+
+// Reference linear interpolation (linear search)
+double Reference(const std::vector<double>& x, const std::vector<double>& y, double t) {
+    if (t <= x.front())
+        return y.front();
+    if (t >= x.back())
+        return y.back();
+    for (size_t i = 1; i < x.size(); i++) {
+        if (t <= x[i])
+            return y[i - 1] + (y[i] - y[i - 1]) * (t - x[i - 1]) / (x[i] - x[i - 1]);
+    }
+    return 0;
+}
+
+bool Check(const ChFunction_Recorder& f, const std::vector<double>& x, const std::vector<double>& y) {
+    bool passed = true;
+    double tol = 1e-12;
+    for (int k = -10; k <= 1010; k++) {
+        double t = x.front() + (x.back() - x.front()) * k / 1000.0;
+        if (std::abs(f.Get_y(t) - Reference(x, y, t)) > tol)
+            passed = false;
+    }
+    // Queries at the points themselves
+    for (size_t i = 0; i < x.size(); i++) {
+        if (std::abs(f.Get_y(x[i]) - y[i]) > tol)
+            passed = false;
+    }
+    return passed;
+}
+
+int main() {
+    bool passed = true, temp = true;
+
+    // Test 1: uniform points, added in order
+    std::vector<double> x, y;
+    ChFunction_Recorder F1;
+    for (int i = 0; i <= 100; i++) {
+        x.push_back(-1 + 0.1 * i);
+        y.push_back(std::sin(x.back()));
+        F1.AddPoint(x.back(), y.back());
+    }
+    temp = F1.IsUniform() && F1.GetPoints().size() == 101 && Check(F1, x, y);
+    if (!temp)
+        std::cerr << "ChFunction_Recorder Error: Test 1 not passed\n";
+    passed &= temp;
+
+    // Test 2: non-uniform points, added in random order, with an overwritten point
+    ChFunction_Recorder F2;
+    std::vector<int> order = {5, 2, 7, 0, 9, 1, 8, 3, 6, 4};
+    x.assign(10, 0);
+    y.assign(10, 0);
+    for (int i = 0; i < 10; i++) {
+        x[i] = i * i * 0.5;
+        y[i] = std::cos(x[i]);
+    }
+    F2.AddPoint(x[3], 100);
+    for (int i : order)
+        F2.AddPoint(x[i], y[i]);
+    temp = !F2.IsUniform() && F2.GetPoints().size() == 10 && Check(F2, x, y);
+    if (!temp)
+        std::cerr << "ChFunction_Recorder Error: Test 2 not passed\n";
+    passed &= temp;
+
+    // Test 3: derivatives (slopes of the linear interpolation, zero outside the range)
+    ChFunction_Recorder F3;
+    F3.AddPoint(0, 0);
+    F3.AddPoint(1, 2);
+    F3.AddPoint(3, 1);
+    temp = F3.Get_y_dx(0.5) == 2 && F3.Get_y_dx(2) == -0.5 && F3.Get_y_dx(-1) == 0 && F3.Get_y_dx(4) == 0 &&
+           F3.Get_y_dxdx(0.5) == 0;
+    if (!temp)
+        std::cerr << "ChFunction_Recorder Error: Test 3 not passed\n";
+    passed &= temp;
+
+    // Test 4: concurrent evaluation (no shared state modified by Get_y)
+    std::vector<int> errors(4, 0);
+    std::vector<std::thread> threads;
+    for (int t = 0; t < 4; t++) {
+        threads.push_back(std::thread([&F2, &x, &y, &errors, t]() {
+            for (int k = 0; k < 20000; k++) {
+                double s = x.front() + (x.back() - x.front()) * ((k * 7919 + t * 104729) % 10007) / 10007.0;
+                if (std::abs(F2.Get_y(s) - Reference(x, y, s)) > 1e-12)
+                    errors[t]++;
+            }
+        }));
+    }
+    for (auto& thread : threads)
+        thread.join();
+    temp = errors[0] + errors[1] + errors[2] + errors[3] == 0;
+    if (!temp)
+        std::cerr << "ChFunction_Recorder Error: Test 4 not passed\n";
+    passed &= temp;
+
+    return !passed;
+}
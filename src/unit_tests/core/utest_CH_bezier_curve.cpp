@@ -0,0 +1,146 @@
+// =============================================================================
+// PROJECT CHRONO - http://projectchrono.org
+//
+// Copyright (c) 2014 projectchrono.org
+// All rights reserved.
+//
+// Use of this source code is governed by a BSD-style license that can be found
+// in the LICENSE file at the top level of the distribution and at
+// http://projectchrono.org/license-chrono.txt.
+//
+// =============================================================================
+//
+// Unit test for the queries on an entire ChBezierCurve (arc length and closest
+// point), checked against brute-force sampling of the curve.
+//
+// =============================================================================
+
+#include <cmath>
+#include <iostream>
+#include <vector>
+
+#include "chrono/core/ChBezierCurve.h"
+
+using namespace chrono;
+
+// Dense sampling of the curve (samples per interval)
+const int num_samples = 1000;
+
+// Arc length of the curve, approximated by the length of the dense polyline
+double PolylineLength(const ChBezierCurve& path) {
+    double length = 0;
+    for (size_t i = 0; i < path.getNumPoints() - 1; i++) {
+        for (int k = 0; k < num_samples; k++)
+            length += (path.eval(i, (k + 1.0) / num_samples) - path.eval(i, double(k) / num_samples)).Length();
+    }
+    return length;
+}
+
+// Distance from a location to the curve, approximated with the dense sampling
+double SampledDistance(const ChBezierCurve& path, const ChVector<>& loc) {
+    double dist = 1e30;
+    for (size_t i = 0; i < path.getNumPoints() - 1; i++) {
+        for (int k = 0; k <= num_samples; k++)
+            dist = std::min(dist, (path.eval(i, double(k) / num_samples) - loc).Length());
+    }
+    return dist;
+}
+
+int main() {
+    bool passed = true, temp = true;
+
+    // Planar path with varying curvature and knot spacing
+    std::vector<ChVector<>> knots;
+    for (int i = 0; i <= 40; i++) {
+        double x = 2.0 * i + 0.05 * i * i;
+        knots.push_back(ChVector<>(x, 10 * std::sin(0.15 * x), 0.5 * std::cos(0.3 * x)));
+    }
+    ChBezierCurve path(knots);
+
+    // Test 1: total arc length
+    double length = PolylineLength(path);
+    temp = std::abs(path.getLength() - length) < 1e-6 * length;
+    if (!temp)
+        std::cerr << "ChBezierCurve Error: Test 1 not passed (" << path.getLength() << " vs " << length << ")\n";
+    passed &= temp;
+
+    // Test 2: arc length -> point -> arc length round trip
+    temp = true;
+    for (int k = 0; k <= 1000; k++) {
+        double s = path.getLength() * k / 1000.0;
+        size_t i;
+        double t;
+        ChVector<> P = path.evalArcLength(s, i, t);
+        if (std::abs(path.calcArcLength(i, t) - s) > 1e-8 || (path.eval(i, t) - P).Length() > 1e-10)
+            temp = false;
+    }
+    if (!temp)
+        std::cerr << "ChBezierCurve Error: Test 2 not passed\n";
+    passed &= temp;
+
+    // Test 3: closest points on the entire curve, with no initial guess
+    std::vector<ChVector<>> locs;
+    for (int k = 0; k < 200; k++) {
+        double x = -5 + 0.8 * k;
+        locs.push_back(ChVector<>(x, 15 * std::sin(0.37 * k), 3 * std::cos(0.11 * k)));
+    }
+    temp = true;
+    for (size_t k = 0; k < locs.size(); k += 4) {
+        const ChVector<>& loc = locs[k];
+        size_t i;
+        double t;
+        ChVector<> P = path.findClosestPoint(loc, i, t);
+        if (std::abs((P - loc).Length() - SampledDistance(path, loc)) > 1e-3 || (path.eval(i, t) - P).Length() > 1e-10)
+            temp = false;
+    }
+    if (!temp)
+        std::cerr << "ChBezierCurve Error: Test 3 not passed\n";
+    passed &= temp;
+
+    // Test 4: batched queries must match the single queries, for any number of threads
+    std::vector<double> s;
+    for (int k = 0; k < 500; k++)
+        s.push_back(path.getLength() * ((k * 7919) % 500) / 499.0);
+    temp = true;
+    for (int nthreads : {1, 4}) {
+        std::vector<ChVector<>> points;
+        std::vector<size_t> intervals;
+        std::vector<double> params;
+        path.findClosestPoints(locs, points, intervals, params, nthreads);
+        for (size_t k = 0; k < locs.size(); k++) {
+            size_t i;
+            double t;
+            ChVector<> P = path.findClosestPoint(locs[k], i, t);
+            if (!(P == points[k]) || i != intervals[k] || t != params[k])
+                temp = false;
+        }
+        path.evalArcLengths(s, points, nthreads);
+        for (size_t k = 0; k < s.size(); k++) {
+            if (!(path.evalArcLength(s[k]) == points[k]))
+                temp = false;
+        }
+    }
+    if (!temp)
+        std::cerr << "ChBezierCurve Error: Test 4 not passed\n";
+    passed &= temp;
+
+    // Test 5: tracker reset and look-ahead point along a closed path
+    std::vector<ChVector<>> loop;
+    for (int i = 0; i <= 32; i++)
+        loop.push_back(ChVector<>(20 * std::cos(i * CH_C_2PI / 32), 20 * std::sin(i * CH_C_2PI / 32), 0));
+    auto circle = std::make_shared<ChBezierCurve>(loop);
+    ChBezierCurveTracker tracker(circle, true);
+    ChVector<> loc(-21, 0, 0);
+    ChVector<> P;
+    tracker.reset(loc);
+    tracker.calcClosestPoint(loc, P);
+    double s0 = tracker.getArcLength();
+    ChVector<> A = tracker.calcLookAheadPoint(0.75 * circle->getLength());
+    temp = std::abs(P.Length() - 20) < 1e-3 && std::abs(s0 - 0.5 * circle->getLength()) < 0.05 &&
+           (A - circle->evalArcLength(std::fmod(s0 + 0.75 * circle->getLength(), circle->getLength()))).Length() < 1e-10;
+    if (!temp)
+        std::cerr << "ChBezierCurve Error: Test 5 not passed\n";
+    passed &= temp;
+
+    return !passed;
+}
@@ -0,0 +1,130 @@
+// =============================================================================
+// PROJECT CHRONO - http://projectchrono.org
+//
+// Copyright (c) 2014 projectchrono.org
+// All rights reserved.
+//
+// Use of this source code is governed by a BSD-style license that can be found
+// in the LICENSE file at the top level of the distribution and at
+// http://projectchrono.org/license-chrono.txt.
+//
+// =============================================================================
+//
+// Test for the assembly of stiffness blocks (ChKblockGeneric) in the system
+// matrix. When assembling into a compressed ChCSMatrix with locked sparsity
+// pattern, ChSystemDescriptor scatters the K blocks in parallel into
+// precomputed slots. The test checks that the result is identical to the
+// serial insertion into an unlocked matrix.
+//
+// =============================================================================
+
+#include <iostream>
+#include <vector>
+
+#include "chrono/core/ChCSMatrix.h"
+#include "chrono/solver/ChKblockGeneric.h"
+#include "chrono/solver/ChSystemDescriptor.h"
+#include "chrono/solver/ChVariablesGeneric.h"
+
+using namespace chrono;
+
+using std::cout;
+using std::endl;
+
+const int num_vars = 60;    // number of variable blocks
+const int num_elems = 100;  // number of stiffness blocks
+
+// Simple deterministic pseudo-random generator, in [0,1)
+double rnd() {
+    static unsigned int seed = 4321;
+    seed = seed * 1103515245u + 12345u;
+    return ((seed >> 8) & 0xFFFF) / 65536.0;
+}
+
+// Fill the stiffness matrices with new values
+void UpdateK(std::vector<ChKblockGeneric*>& kblocks) {
+    for (auto kb : kblocks) {
+        ChMatrix<>* K = kb->Get_K();
+        for (int i = 0; i < K->GetRows(); i++)
+            for (int j = 0; j < K->GetColumns(); j++)
+                (*K)(i, j) = rnd() - 0.5;
+    }
+}
+
+// Check that the two matrices have identical entries
+bool Compare(const ChCSMatrix& A, const ChCSMatrix& B) {
+    if (A.GetNumRows() != B.GetNumRows() || A.GetNumColumns() != B.GetNumColumns())
+        return false;
+    for (int i = 0; i < A.GetNumRows(); i++)
+        for (int j = 0; j < A.GetNumColumns(); j++)
+            if (A.GetElement(i, j) != B.GetElement(i, j))
+                return false;
+    return true;
+}
+
+int main(int argc, char* argv[]) {
+    ChSystemDescriptor descriptor;
+
+    // Variables, with different sizes; one of them is inactive
+    std::vector<ChVariablesGeneric*> vars;
+    for (int i = 0; i < num_vars; i++) {
+        auto var = new ChVariablesGeneric(2 + i % 3);
+        var->GetMass().FillDiag(1.0 + rnd());
+        vars.push_back(var);
+    }
+    vars[7]->SetDisabled(true);
+
+    // Stiffness blocks, each connecting two or three variables
+    std::vector<ChKblockGeneric*> kblocks;
+    for (int e = 0; e < num_elems; e++) {
+        std::vector<ChVariables*> evars;
+        evars.push_back(vars[e % num_vars]);
+        evars.push_back(vars[(e * 7 + 3) % num_vars]);
+        if (e % 2)
+            evars.push_back(vars[(e * 13 + 5) % num_vars]);
+        kblocks.push_back(new ChKblockGeneric(evars));
+    }
+
+    descriptor.BeginInsertion();
+    for (auto var : vars)
+        descriptor.InsertVariables(var);
+    for (auto kb : kblocks)
+        descriptor.InsertKblock(kb);
+    descriptor.EndInsertion();
+
+    ChCSMatrix Z_ref(1, 1);
+    ChCSMatrix Z(1, 1);
+    Z.SetSparsityPatternLock(true);
+
+    bool passed = true;
+
+    for (int step = 0; step < 4; step++) {
+        UpdateK(kblocks);
+        descriptor.SetNumThreads(step < 2 ? 1 : 4);
+
+        // Reference assembly, with serial insertion
+        descriptor.ConvertToMatrixForm(&Z_ref, nullptr);
+        Z_ref.Compress();
+
+        // Assembly in a matrix with locked sparsity pattern (parallel scatter after the first step)
+        if (step == 0)
+            Z.Reset(Z_ref.GetNumRows(), Z_ref.GetNumColumns(), Z_ref.GetNNZ());
+        descriptor.ConvertToMatrixForm(&Z, nullptr);
+        Z.Compress();
+
+        bool identical = Compare(Z_ref, Z);
+        cout << "  step " << step << "  n = " << Z.GetNumRows() << "  nnz = " << Z.GetNNZ()
+             << (identical ? "  identical" : "  DIFFERENT") << endl;
+        passed &= identical;
+    }
+
+    for (auto kb : kblocks)
+        delete kb;
+    for (auto var : vars)
+        delete var;
+
+    cout << "Test " << (passed ? "PASSED" : "FAILED") << endl;
+
+    // Return 0 if all tests passed.
+    return !passed;
+}
@@ -0,0 +1,227 @@
+// =============================================================================
+// PROJECT CHRONO - http://projectchrono.org
+//
+// Copyright (c) 2014 projectchrono.org
+// All rights reserved.
+//
+// Use of this source code is governed by a BSD-style license that can be found
+// in the LICENSE file at the top level of the distribution and at
+// http://projectchrono.org/license-chrono.txt.
+//
+// =============================================================================
+//
+// Test for the thread-aware profiler (ChProfileRecorder).
+// Nested zones, and zones executed in an OpenMP parallel loop, are merged in
+// per-step records. Enabling or disabling the recorder while zones are open
+// must keep the zone hierarchy balanced. Only the most recent records are kept,
+// up to the set maximum.
+//
+// =============================================================================
+
+#include <iostream>
+#include <sstream>
+
+#include "chrono/utils/ChProfiler.h"
+
+using namespace chrono;
+using namespace chrono::utils;
+
+using std::cout;
+using std::endl;
+
+const int num_steps = 3;
+const int num_tasks = 16;
+
+void Work(int n) {
+    volatile double sum = 0;
+    for (int i = 0; i < n; i++)
+        sum = sum + 1e-3 * i;
+}
+
+void Step() {
+    CH_PROFILE_ZONE("step");
+    {
+        CH_PROFILE_ZONE("serial");
+        Work(10000);
+    }
+#pragma omp parallel for num_threads(4)
+    for (int i = 0; i < num_tasks; i++) {
+        CH_PROFILE_ZONE("task");
+        Work(10000);
+    }
+}
+
+const ChProfileRecorder::ZoneRecord* FindZone(const ChProfileRecorder::StepRecord& step, const std::string& path) {
+    for (auto& zone : step.zones) {
+        if (zone.path == path)
+            return &zone;
+    }
+    return nullptr;
+}
+
+int main(int argc, char* argv[]) {
+    bool passed = true;
+
+    // Zones are ignored if the recorder is disabled
+    Step();
+    ChProfileRecorder::EndStep(0);
+    if (!ChProfileRecorder::GetSteps().empty()) {
+        cout << "Records created with disabled recorder" << endl;
+        passed = false;
+    }
+
+    ChProfileRecorder::Enable(true);
+    ChProfileRecorder::EnableTrace(true);
+    for (int i = 0; i < num_steps; i++) {
+        Step();
+        ChProfileRecorder::EndStep(0.1 * (i + 1));
+    }
+    ChProfileRecorder::Enable(false);
+
+    const auto& steps = ChProfileRecorder::GetSteps();
+    if (steps.size() != num_steps) {
+        cout << "Wrong number of steps: " << steps.size() << endl;
+        return 1;
+    }
+
+    for (auto& step : steps) {
+        auto zone_step = FindZone(step, "step");
+        auto zone_serial = FindZone(step, "step/serial");
+        auto zone_task = FindZone(step, "task");
+        auto zone_task_main = FindZone(step, "step/task");
+
+        // Tasks executed by the main thread are nested in "step"; the other threads have their own hierarchy.
+        int task_calls = (zone_task ? zone_task->calls : 0) + (zone_task_main ? zone_task_main->calls : 0);
+
+        cout << "Step " << step.step << "  time: " << step.sim_time << "  wall time: " << step.wall_time << endl;
+        for (auto& zone : step.zones)
+            cout << "   " << zone.path << "  calls: " << zone.calls << "  threads: " << zone.threads
+                 << "  total: " << zone.total << "  max: " << zone.max << endl;
+
+        if (!zone_step || zone_step->calls != 1 || !zone_serial || zone_serial->calls != 1) {
+            cout << "Missing serial zones" << endl;
+            passed = false;
+        }
+        if (task_calls != num_tasks) {
+            cout << "Wrong number of task calls: " << task_calls << endl;
+            passed = false;
+        }
+        if (zone_step && zone_serial && zone_serial->total > zone_step->total) {
+            cout << "Inconsistent nested zone times" << endl;
+            passed = false;
+        }
+    }
+
+    // Each zone execution is recorded in the trace
+    size_t num_events = ChProfileRecorder::GetTraceEvents().size();
+    if (num_events != num_steps * (2 + num_tasks)) {
+        cout << "Wrong number of trace events: " << num_events << endl;
+        passed = false;
+    }
+
+    // Exports
+    std::stringstream json;
+    std::stringstream csv;
+    std::stringstream trace;
+    ChProfileRecorder::WriteJSON(json);
+    ChProfileRecorder::WriteCSV(csv);
+    ChProfileRecorder::WriteChromeTrace(trace);
+    if (json.str().find("\"path\": \"step/serial\"") == std::string::npos ||
+        csv.str().find(",\"step/serial\",1,1,") == std::string::npos ||
+        trace.str().find("\"name\": \"task\"") == std::string::npos) {
+        cout << "Unexpected export output" << endl;
+        passed = false;
+    }
+
+    ChProfileRecorder::Reset();
+    if (!ChProfileRecorder::GetSteps().empty() || !ChProfileRecorder::GetTraceEvents().empty()) {
+        cout << "Records not cleared" << endl;
+        passed = false;
+    }
+
+    // Special characters in zone names are escaped in the exports
+    ChProfileRecorder::Enable(true);
+    {
+        CH_PROFILE_ZONE("a \"b\"\n\t\x01");
+    }
+    ChProfileRecorder::EndStep(0);
+    ChProfileRecorder::Enable(false);
+
+    json.str("");
+    csv.str("");
+    trace.str("");
+    ChProfileRecorder::WriteJSON(json);
+    ChProfileRecorder::WriteCSV(csv);
+    ChProfileRecorder::WriteChromeTrace(trace);
+    if (json.str().find("\"path\": \"a \\\"b\\\"\\n\\t\\u0001\"") == std::string::npos ||
+        trace.str().find("\"name\": \"a \\\"b\\\"\\n\\t\\u0001\"") == std::string::npos ||
+        csv.str().find(",\"a \"\"b\"\"\n\t\x01\",1,1,") == std::string::npos) {
+        cout << "Special characters not escaped" << endl;
+        passed = false;
+    }
+    ChProfileRecorder::Reset();
+
+    // Toggle the recorder inside open zones: "middle" starts while the recorder is disabled, so leaving its scope
+    // must not close "outer"; "after" must still be nested in "outer" and "top" must not be nested at all.
+    ChProfileRecorder::Enable(true);
+    {
+        CH_PROFILE_ZONE("outer");
+        {
+            ChProfileRecorder::Enable(false);
+            CH_PROFILE_ZONE("middle");
+            ChProfileRecorder::Enable(true);
+            {
+                CH_PROFILE_ZONE("inner");
+                ChProfileRecorder::Enable(false);
+            }
+        }
+        ChProfileRecorder::Enable(true);
+        {
+            CH_PROFILE_ZONE("after");
+        }
+    }
+    {
+        CH_PROFILE_ZONE("top");
+    }
+    ChProfileRecorder::EndStep(0);
+    ChProfileRecorder::Enable(false);
+
+    const auto& toggle_step = ChProfileRecorder::GetSteps().back();
+    for (auto& zone : toggle_step.zones)
+        cout << "   " << zone.path << "  calls: " << zone.calls << endl;
+    if (toggle_step.zones.size() != 4 || !FindZone(toggle_step, "outer") || !FindZone(toggle_step, "outer/inner") ||
+        !FindZone(toggle_step, "outer/after") || !FindZone(toggle_step, "top")) {
+        cout << "Unbalanced zones after toggling the recorder" << endl;
+        passed = false;
+    }
+    ChProfileRecorder::Reset();
+
+    // Only the most recent steps and zone executions are kept
+    ChProfileRecorder::SetMaxRecords(2, 5);
+    ChProfileRecorder::Enable(true);
+    for (int i = 0; i < 4; i++) {
+        {
+            CH_PROFILE_ZONE("outer");
+            {
+                CH_PROFILE_ZONE("inner");
+            }
+        }
+        ChProfileRecorder::EndStep(0.1 * (i + 1));
+    }
+    ChProfileRecorder::Enable(false);
+
+    const auto& last_steps = ChProfileRecorder::GetSteps();
+    const auto& last_events = ChProfileRecorder::GetTraceEvents();
+    if (last_steps.size() != 2 || last_steps.front().step != 2 || last_steps.back().step != 3 ||
+        last_events.size() != 5) {
+        cout << "Wrong number of records kept: " << last_steps.size() << " steps, " << last_events.size()
+             << " events" << endl;
+        passed = false;
+    }
+    ChProfileRecorder::Reset();
+
+    cout << "Test " << (passed ? "PASSED" : "FAILED") << endl;
+
+    // Return 0 if all tests passed.
+    return !passed;
+}
@@ -0,0 +1,159 @@
+// =============================================================================
+// PROJECT CHRONO - http://projectchrono.org
+//
+// Copyright (c) 2014 projectchrono.org
+// All rights reserved.
+//
+// Use of this source code is governed by a BSD-style license that can be found
+// in the LICENSE file at the top level of the distribution and at
+// http://projectchrono.org/license-chrono.txt.
+//
+// =============================================================================
+//
+// Tests for the native sparse direct solver engine (ChSparseLUEngine).
+// A KKT matrix, with a block "stiffness" part and a set of constraints (zero
+// diagonal block), is factorized in unsymmetric and symmetric mode. The test
+// checks the accuracy of the solution, that columns are grouped in supernodes,
+// and that the factorization results are identical when using 1 or 4 threads.
+//
+// =============================================================================
+
+#include <cmath>
+#include <iostream>
+#include <vector>
+
+#include "chrono/core/ChCSMatrix.h"
+#include "chrono/core/ChMatrixDynamic.h"
+#include "chrono/solver/ChSparseLUEngine.h"
+
+using namespace chrono;
+
+using std::cout;
+using std::endl;
+
+const int num_blocks = 200;  // number of 3x3 variable blocks
+const int num_constr = 40;   // number of constraints
+const int n_q = 3 * num_blocks;
+const int n = n_q + num_constr;
+
+// Simple deterministic pseudo-random generator, in [0,1)
+double rnd() {
+    static unsigned int seed = 12345;
+    seed = seed * 1103515245u + 12345u;
+    return ((seed >> 8) & 0xFFFF) / 65536.0;
+}
+
+// Assemble the test matrix. If 'skew' is non-zero, the stiffness part is made unsymmetric.
+void BuildMatrix(ChCSMatrix& A, double skew) {
+    A.Reset(n, n);
+
+    // Block-diagonal mass plus a spring network between blocks (each block connected to a few others)
+    for (int b = 0; b < num_blocks; b++) {
+        for (int i = 0; i < 3; i++)
+            A.SetElement(3 * b + i, 3 * b + i, 10.0 + rnd(), false);
+        int nbrs[3] = {(b + 1) % num_blocks, (b + 7) % num_blocks, (b * 13 + 5) % num_blocks};
+        for (auto c : nbrs) {
+            if (c == b)
+                continue;
+            double k = 1.0 + rnd();
+            for (int i = 0; i < 3; i++) {
+                A.SetElement(3 * b + i, 3 * b + i, k, false);
+                A.SetElement(3 * c + i, 3 * c + i, k, false);
+                A.SetElement(3 * b + i, 3 * c + i, -k + skew, false);
+                A.SetElement(3 * c + i, 3 * b + i, -k - skew, false);
+            }
+        }
+    }
+
+    // Constraints, each acting on two variable blocks
+    for (int ic = 0; ic < num_constr; ic++) {
+        int b1 = (ic * 5) % num_blocks;
+        int b2 = (ic * 11 + 3) % num_blocks;
+        for (int i = 0; i < 3; i++) {
+            double c1 = rnd() - 0.5;
+            double c2 = rnd() - 0.5;
+            A.SetElement(n_q + ic, 3 * b1 + i, c1, false);
+            A.SetElement(3 * b1 + i, n_q + ic, c1, false);
+            A.SetElement(n_q + ic, 3 * b2 + i, c2, false);
+            A.SetElement(3 * b2 + i, n_q + ic, c2, false);
+        }
+        A.SetElement(n_q + ic, n_q + ic, 0.0);
+    }
+
+    A.Compress();
+}
+
+bool TestSolve(bool symmetric, double skew) {
+    ChCSMatrix A(n, n);
+    BuildMatrix(A, skew);
+
+    ChMatrixDynamic<> x_ref(n, 1);
+    for (int i = 0; i < n; i++)
+        x_ref(i, 0) = rnd() - 0.5;
+    ChMatrixDynamic<> b(n, 1);
+    A.MatrMultiply(x_ref, b);
+
+    std::vector<int> block_ptr;
+    for (int i = 0; i <= num_blocks; i++)
+        block_ptr.push_back(3 * i);
+
+    ChMatrixDynamic<> x1;
+    ChMatrixDynamic<> x4;
+
+    ChSparseLUEngine engine;
+    engine.SetSymmetric(symmetric);
+    if (!engine.Analyze(A, block_ptr, n_q)) {
+        cout << "  analysis failed" << endl;
+        return false;
+    }
+
+    engine.SetNumThreads(1);
+    engine.Factorize(A);
+    engine.Solve(b, x1);
+
+    engine.SetNumThreads(4);
+    engine.Factorize(A);
+    engine.Solve(b, x4);
+
+    double err = 0;
+    bool identical = true;
+    for (int i = 0; i < n; i++) {
+        err = std::max(err, std::abs(x1(i, 0) - x_ref(i, 0)));
+        identical = identical && (x1(i, 0) == x4(i, 0));
+    }
+
+    cout << "  symmetric: " << symmetric << "  skew: " << skew << "  nnz(L): " << engine.GetNumNonZerosL()
+         << "  supernodes: " << engine.GetNumSupernodes() << "  levels: " << engine.GetNumLevels()
+         << "  perturbed: " << engine.GetNumPerturbedPivots() << "  error: " << err << endl;
+
+    if (engine.GetNumSupernodes() >= n) {
+        cout << "  no supernode found" << endl;
+        return false;
+    }
+    if (err > 1e-9) {
+        cout << "  inaccurate solution" << endl;
+        return false;
+    }
+    if (!identical) {
+        cout << "  results depend on the number of threads" << endl;
+        return false;
+    }
+
+    return true;
+}
+
+int main(int argc, char* argv[]) {
+    bool passed = true;
+
+    cout << "Unsymmetric mode" << endl;
+    passed &= TestSolve(false, 0.0);
+    passed &= TestSolve(false, 0.3);
+
+    cout << "Symmetric mode" << endl;
+    passed &= TestSolve(true, 0.0);
+
+    cout << "Test " << (passed ? "PASSED" : "FAILED") << endl;
+
+    // Return 0 if all tests passed.
+    return !passed;
+}
@@ -0,0 +1,154 @@
+// =============================================================================
+// PROJECT CHRONO - http://projectchrono.org
+//
+// Copyright (c) 2014 projectchrono.org
+// All rights reserved.
+//
+// Use of this source code is governed by a BSD-style license that can be found
+// in the LICENSE file at the top level of the distribution and at
+// http://projectchrono.org/license-chrono.txt.
+//
+// =============================================================================
+//
+// Test for the cache of the automatic gravity load of a ChMesh.
+// The gravity forces applied by the mesh (computed from cached element forces)
+// must match those computed from scratch for each element with ChLoaderGravity,
+// after changing the density of a material, the gravity of the system, adding
+// an element, and removing all elements.
+//
+// =============================================================================
+
+#include <algorithm>
+#include <cmath>
+#include <iostream>
+#include <string>
+#include <vector>
+
+#include "chrono/physics/ChLoaderUVW.h"
+#include "chrono/physics/ChSystemNSC.h"
+
+#include "chrono_fea/ChElementHexa_8.h"
+#include "chrono_fea/ChMesh.h"
+#include "chrono_fea/ChNodeFEAxyz.h"
+
+using namespace chrono;
+using namespace chrono::fea;
+
+using std::cout;
+using std::endl;
+
+const double size = 0.1;
+
+// Add a square layer of 4 nodes at the specified height.
+std::vector<std::shared_ptr<ChNodeFEAxyz>> AddLayer(std::shared_ptr<ChMesh> mesh, double y) {
+    std::vector<std::shared_ptr<ChNodeFEAxyz>> nodes;
+    nodes.push_back(std::make_shared<ChNodeFEAxyz>(ChVector<>(0, y, 0)));
+    nodes.push_back(std::make_shared<ChNodeFEAxyz>(ChVector<>(0, y, size)));
+    nodes.push_back(std::make_shared<ChNodeFEAxyz>(ChVector<>(size, y, size)));
+    nodes.push_back(std::make_shared<ChNodeFEAxyz>(ChVector<>(size, y, 0)));
+    for (auto& node : nodes)
+        mesh->AddNode(node);
+    return nodes;
+}
+
+// Add a brick element between two layers of nodes.
+std::shared_ptr<ChElementHexa_8> AddBrick(std::shared_ptr<ChMesh> mesh,
+                                          const std::vector<std::shared_ptr<ChNodeFEAxyz>>& bottom,
+                                          const std::vector<std::shared_ptr<ChNodeFEAxyz>>& top,
+                                          std::shared_ptr<ChContinuumElastic> material) {
+    auto element = std::make_shared<ChElementHexa_8>();
+    element->SetNodes(bottom[0], bottom[1], bottom[2], bottom[3], top[0], top[1], top[2], top[3]);
+    element->SetMaterial(material);
+    mesh->AddElement(element);
+    return element;
+}
+
+// Gravity forces applied by the mesh: its residual, less the internal forces of the elements.
+ChVectorDynamic<> MeshGravity(ChSystem& system, std::shared_ptr<ChMesh> mesh) {
+    ChVectorDynamic<> R(system.GetNcoords_w());
+    mesh->IntLoadResidual_F(mesh->GetOffset_w(), R, 1.0);
+    for (auto& element : mesh->GetElements())
+        element->EleIntLoadResidual_F(R, -1.0);
+    return R;
+}
+
+// Gravity forces computed from scratch for each element.
+ChVectorDynamic<> ElementGravity(ChSystem& system, std::shared_ptr<ChMesh> mesh) {
+    ChVectorDynamic<> R(system.GetNcoords_w());
+    for (auto& element : mesh->GetElements()) {
+        auto loadable = std::dynamic_pointer_cast<ChLoadableUVW>(element);
+        if (!loadable)
+            continue;
+        ChLoaderGravity loader(loadable);
+        loader.Set_G_acc(system.Get_G_acc());
+        loader.SetNumIntPoints(1);
+        loader.ComputeQ(nullptr, nullptr);
+        int rowQ = 0;
+        for (int i = 0; i < loadable->GetSubBlocks(); i++) {
+            for (unsigned int row = 0; row < loadable->GetSubBlockSize(i); row++)
+                R(loadable->GetSubBlockOffset(i) + row) += loader.Q(rowQ++);
+        }
+    }
+    return R;
+}
+
+bool Check(const std::string& label, ChSystem& system, std::shared_ptr<ChMesh> mesh, bool zero = false) {
+    system.Setup();
+    system.Update();
+
+    ChVectorDynamic<> cached = MeshGravity(system, mesh);
+    ChVectorDynamic<> expected = ElementGravity(system, mesh);
+
+    double norm = expected.NormTwo();
+    double err = 0;
+    for (int i = 0; i < expected.GetRows(); i++)
+        err = std::max(err, std::abs(cached(i) - expected(i)));
+
+    bool passed = err <= 1e-10 * std::max(norm, 1.0) && (zero ? norm == 0 : norm > 0);
+    cout << label << ":  |Q| = " << norm << "  max error = " << err << (passed ? "" : "  FAILED") << endl;
+    return passed;
+}
+
+int main(int argc, char* argv[]) {
+    ChSystemNSC system;
+    auto mesh = std::make_shared<ChMesh>();
+
+    auto steel = std::make_shared<ChContinuumElastic>(2e11, 0.3, 7800);
+    auto rubber = std::make_shared<ChContinuumElastic>(1e7, 0.45, 1100);
+
+    std::vector<std::vector<std::shared_ptr<ChNodeFEAxyz>>> layers;
+    for (int i = 0; i < 4; i++)
+        layers.push_back(AddLayer(mesh, i * size));
+    AddBrick(mesh, layers[0], layers[1], steel);
+    AddBrick(mesh, layers[1], layers[2], rubber);
+    AddBrick(mesh, layers[2], layers[3], steel);
+
+    system.Add(mesh);
+    system.SetupInitial();
+
+    bool passed = true;
+    passed &= Check("initial mesh", system, mesh);
+
+    // Change of the mass of some elements
+    rubber->Set_density(2000);
+    passed &= Check("density changed", system, mesh);
+
+    // Change of gravity
+    system.Set_G_acc(ChVector<>(1, -3, 0.5));
+    passed &= Check("gravity changed", system, mesh);
+
+    // A new element must be included (the mesh is not set up again)
+    layers.push_back(AddLayer(mesh, 4 * size));
+    auto element = AddBrick(mesh, layers[3], layers[4], rubber);
+    element->SetupInitial(&system);
+    passed &= Check("element added", system, mesh);
+
+    // No element left
+    mesh->ClearElements();
+    passed &= Check("elements removed", system, mesh, true);
+
+    cout << "Test " << (passed ? "PASSED" : "FAILED") << endl;
+
+    // Return 0 if all tests passed.
+    return !passed;
+}
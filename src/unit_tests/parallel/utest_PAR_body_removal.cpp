@@ -0,0 +1,243 @@
+// =============================================================================
+// PROJECT CHRONO - http://projectchrono.org
+//
+// Copyright (c) 2016 projectchrono.org
+// All rights reserved.
+//
+// Use of this source code is governed by a BSD-style license that can be found
+// in the LICENSE file at the top level of the distribution and at
+// http://projectchrono.org/license-chrono.txt.
+//
+// =============================================================================
+//
+// ChronoParallel unit test for the removal of bodies (ChSystemParallel::RemoveBody
+// and RemoveBatch) and the compaction of the system-wide arrays.
+// Spheres rest on the ground and on a plate above it. The plate and some of the
+// spheres on the ground are removed; the spheres on the plate must fall on the
+// ground. The body list, the body IDs and the collision shape arrays are checked
+// after the compaction. The test is run with the NSC and SMC (with contact
+// history) formulations.
+//
+// The global reference frame has Z up.
+// =============================================================================
+
+#include <climits>
+#include <iostream>
+#include <vector>
+
+#include "chrono/utils/ChUtilsCreators.h"
+
+#include "chrono_parallel/physics/ChSystemParallel.h"
+
+using namespace chrono;
+using namespace chrono::collision;
+
+using std::cout;
+using std::endl;
+
+double radius = 0.1;
+
+std::shared_ptr<ChBody> CreateBox(ChSystemParallel& system,
+                                  std::shared_ptr<ChMaterialSurface> mat,
+                                  const ChVector<>& hdim,
+                                  const ChVector<>& pos) {
+    auto box = std::make_shared<ChBody>(std::make_shared<ChCollisionModelParallel>(), mat->GetContactMethod());
+    box->SetMaterialSurface(mat);
+    box->SetPos(pos);
+    box->SetBodyFixed(true);
+    box->SetCollide(true);
+    box->GetCollisionModel()->ClearModel();
+    utils::AddBoxGeometry(box.get(), hdim);
+    box->GetCollisionModel()->BuildModel();
+    system.AddBody(box);
+    return box;
+}
+
+std::vector<std::shared_ptr<ChBody>> CreateLayer(ChSystemParallel& system,
+                                                 std::shared_ptr<ChMaterialSurface> mat,
+                                                 double height) {
+    std::vector<std::shared_ptr<ChBody>> spheres;
+    for (int ix = -2; ix <= 2; ix++) {
+        for (int iy = -2; iy <= 2; iy++) {
+            auto ball = std::make_shared<ChBody>(std::make_shared<ChCollisionModelParallel>(), mat->GetContactMethod());
+            ball->SetMaterialSurface(mat);
+            ball->SetMass(1);
+            ball->SetInertiaXX(0.4 * radius * radius * ChVector<>(1, 1, 1));
+            ball->SetPos(ChVector<>(0.3 * ix, 0.3 * iy, height + radius));
+            ball->SetCollide(true);
+            ball->GetCollisionModel()->ClearModel();
+            utils::AddSphereGeometry(ball.get(), radius);
+            ball->GetCollisionModel()->BuildModel();
+            system.AddBody(ball);
+            spheres.push_back(ball);
+        }
+    }
+    return spheres;
+}
+
+// Check the body list, the body IDs and the collision shape arrays.
+bool CheckArrays(const std::string& name, ChSystemParallel& system, const std::vector<ChBody*>& expected) {
+    const auto& bodies = *system.Get_bodylist();
+    ChParallelDataManager* data_manager = system.data_manager;
+
+    if (data_manager->num_removed_bodies != 0 || data_manager->num_removed_shapes != 0) {
+        cout << name << ": system-wide arrays not compacted" << endl;
+        return false;
+    }
+    if (bodies.size() != expected.size() || data_manager->num_rigid_bodies != expected.size() ||
+        data_manager->host_data.pos_rigid.size() != expected.size()) {
+        cout << name << ": unexpected number of bodies" << endl;
+        return false;
+    }
+    for (size_t i = 0; i < bodies.size(); i++) {
+        if (bodies[i].get() != expected[i] || bodies[i]->GetId() != i) {
+            cout << name << ": unexpected body " << i << endl;
+            return false;
+        }
+    }
+
+    // One shape per body, stored in the order of the bodies
+    const shape_container& shape_data = data_manager->shape_data;
+    if (data_manager->num_rigid_shapes != bodies.size() || shape_data.id_rigid.size() != bodies.size()) {
+        cout << name << ": unexpected number of shapes" << endl;
+        return false;
+    }
+    for (size_t i = 0; i < bodies.size(); i++) {
+        auto model = std::static_pointer_cast<ChCollisionModelParallel>(bodies[i]->GetCollisionModel());
+        if (shape_data.id_rigid[i] != i || model->shape_index != (int)i) {
+            cout << name << ": unexpected shape " << i << endl;
+            return false;
+        }
+    }
+
+    return true;
+}
+
+bool Run(ChSystemParallel& system, std::shared_ptr<ChMaterialSurface> mat) {
+    bool passed = true;
+
+    system.Set_G_acc(ChVector<>(0, 0, -9.81));
+    system.GetSettings()->perform_thread_tuning = false;
+    system.GetSettings()->solver.max_iteration_bilateral = 0;
+    system.GetSettings()->collision.bins_per_axis = vec3(5, 5, 5);
+
+    auto ground = CreateBox(system, mat, ChVector<>(1, 1, 0.1), ChVector<>(0, 0, -0.1));
+    auto bottom = CreateLayer(system, mat, 0);
+    auto plate = CreateBox(system, mat, ChVector<>(1, 1, 0.1), ChVector<>(0, 0, 0.9));
+    auto top = CreateLayer(system, mat, 1);
+
+    for (int i = 0; i < 200; i++)
+        system.DoStepDynamics(1e-3);
+
+    // Remove the plate and every other sphere of the bottom layer, some of them with deferred removal.
+    // Bodies queued with RemoveBatch are only removed at the next step.
+    system.RemoveBody(plate);
+    size_t num_batch = 0;
+    for (size_t i = 0; i < bottom.size(); i += 2) {
+        if (i % 4 == 0) {
+            system.RemoveBody(bottom[i]);
+        } else {
+            system.RemoveBatch(bottom[i]);
+            num_batch++;
+        }
+    }
+
+    if (system.GetNumBodies() != 1 + bottom.size() / 2 + top.size() + num_batch) {
+        cout << "unexpected number of bodies after removal: " << system.GetNumBodies() << endl;
+        passed = false;
+    }
+
+    // Until the next compaction, the body list keeps placeholders in the slots of the removed bodies.
+    // GetBodies skips them (the bodies queued with RemoveBatch are still in the system).
+    std::vector<ChBody*> remaining;
+    remaining.push_back(ground.get());
+    for (size_t i = 0; i < bottom.size(); i++) {
+        if (i % 4 != 0)
+            remaining.push_back(bottom[i].get());
+    }
+    for (auto sphere : top)
+        remaining.push_back(sphere.get());
+
+    auto bodies = system.GetBodies();
+    bool same = bodies.size() == remaining.size();
+    for (size_t i = 0; same && i < bodies.size(); i++)
+        same = bodies[i].get() == remaining[i];
+    if (!same) {
+        cout << "unexpected list of bodies before compaction" << endl;
+        passed = false;
+    }
+
+    std::vector<ChBody*> expected;
+    expected.push_back(ground.get());
+    for (size_t i = 1; i < bottom.size(); i += 2)
+        expected.push_back(bottom[i].get());
+    for (auto sphere : top)
+        expected.push_back(sphere.get());
+
+    system.DoStepDynamics(1e-3);
+    passed &= CheckArrays("after removal", system, expected);
+
+    for (int i = 0; i < 600; i++)
+        system.DoStepDynamics(1e-3);
+    passed &= CheckArrays("after fall", system, expected);
+
+    // The spheres of the top layer fell on the ground or on the remaining spheres
+    // of the bottom layer. Both layers rest above the ground.
+    for (auto sphere : top) {
+        double z = sphere->GetPos().z();
+        if (z > 0.5 || z < 0.5 * radius) {
+            cout << "unexpected sphere height: " << z << endl;
+            passed = false;
+            break;
+        }
+    }
+    for (size_t i = 1; i < bottom.size(); i += 2) {
+        double z = bottom[i]->GetPos().z();
+        if (z < 0.5 * radius) {
+            cout << "sphere fell through the ground: " << z << endl;
+            passed = false;
+            break;
+        }
+    }
+
+    return passed;
+}
+
+int main(int argc, char* argv[]) {
+    bool passed = true;
+
+    {
+        ChSystemParallelNSC system;
+        system.GetSettings()->solver.solver_mode = SolverMode::SLIDING;
+        system.GetSettings()->solver.max_iteration_normal = 0;
+        system.GetSettings()->solver.max_iteration_sliding = 50;
+        system.GetSettings()->solver.max_iteration_spinning = 0;
+        system.GetSettings()->collision.collision_envelope = 0.005;
+        system.ChangeSolverType(SolverType::APGD);
+
+        auto mat = std::make_shared<ChMaterialSurfaceNSC>();
+        mat->SetFriction(0.4f);
+
+        cout << "NSC" << endl;
+        passed &= Run(system, mat);
+    }
+
+    {
+        ChSystemParallelSMC system;
+        system.GetSettings()->solver.contact_force_model = ChSystemSMC::ContactForceModel::Hertz;
+        system.GetSettings()->solver.tangential_displ_mode = ChSystemSMC::TangentialDisplacementModel::MultiStep;
+
+        auto mat = std::make_shared<ChMaterialSurfaceSMC>();
+        mat->SetYoungModulus(1e6f);
+        mat->SetFriction(0.4f);
+        mat->SetRestitution(0.1f);
+
+        cout << "SMC" << endl;
+        passed &= Run(system, mat);
+    }
+
+    cout << "Test " << (passed ? "PASSED" : "FAILED") << endl;
+
+    // Return 0 if all tests passed.
+    return !passed;
+}
@@ -89,7 +89,7 @@ double bin_length = 20;
 double bin_thickness = 0.1;
 
 // Forward declaration
-bool test_computecontact(ChMaterialSurface::ContactMethod method);
+bool test_computecontact(ChMaterialSurface::ContactMethod method, bool shur_blocks = false);
 
 // ====================================================================================
 
@@ -98,6 +98,7 @@ int main(int argc, char* argv[]) {
     bool passed = true;
     passed &= test_computecontact(ChMaterialSurface::SMC);
     passed &= test_computecontact(ChMaterialSurface::NSC);
+    passed &= test_computecontact(ChMaterialSurface::NSC, true);
 
     // Return 0 if all tests passed.
     return !passed;
@@ -105,7 +106,7 @@ int main(int argc, char* argv[]) {
 
 // ====================================================================================
 
-bool test_computecontact(ChMaterialSurface::ContactMethod method) {
+bool test_computecontact(ChMaterialSurface::ContactMethod method, bool shur_blocks) {
     // Create system and contact material.
     char title[100];
     ChSystemParallel* system;
@@ -139,7 +140,7 @@ bool test_computecontact(ChMaterialSurface::ContactMethod method) {
             break;
         }
         case ChMaterialSurface::NSC: {
-            std::cout << "Using COMPLEMENTARITY method." << std::endl;
+            std::cout << "Using COMPLEMENTARITY method" << (shur_blocks ? " (Shur product blocks)." : ".") << std::endl;
             sprintf(title, "Contact Force test (NSC)");
 
             ChSystemParallelNSC* sys = new ChSystemParallelNSC;
@@ -147,6 +148,7 @@ bool test_computecontact(ChMaterialSurface::ContactMethod method) {
             sys->GetSettings()->solver.max_iteration_normal = 0;
             sys->GetSettings()->solver.max_iteration_sliding = 100;
             sys->GetSettings()->solver.max_iteration_spinning = 0;
+            sys->GetSettings()->solver.use_shur_blocks = shur_blocks;
             sys->ChangeSolverType(SolverType::APGD);
             system = sys;
 
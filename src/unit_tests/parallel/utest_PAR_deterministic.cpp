@@ -0,0 +1,184 @@
+// =============================================================================
+// PROJECT CHRONO - http://projectchrono.org
+//
+// Copyright (c) 2016 projectchrono.org
+// All rights reserved.
+//
+// Use of this source code is governed by a BSD-style license that can be found
+// in the LICENSE file at the top level of the distribution and at
+// http://projectchrono.org/license-chrono.txt.
+//
+// =============================================================================
+//
+// ChronoParallel unit test for the deterministic mode (settings.deterministic).
+// The order in which the broadphase finds the contacts depends on the number of
+// threads and on the bin grid. A pile of spheres settling in a box is simulated
+// with different thread counts and bin grids, to permute that order. In
+// deterministic mode, the contact list must be sorted by shape pair at each step
+// and identical in all runs, and the final states must be bitwise identical.
+// This is checked with the NSC and SMC (with contact history) formulations.
+// =============================================================================
+
+#include <algorithm>
+#include <iostream>
+#include <string>
+#include <vector>
+
+#include "chrono/utils/ChUtilsCreators.h"
+
+#include "chrono_parallel/physics/ChSystemParallel.h"
+
+using namespace chrono;
+using namespace chrono::collision;
+
+using std::cout;
+using std::endl;
+
+const int num_steps = 200;
+
+// Contact lists at each step and final body states of one run.
+struct RunResult {
+    std::vector<std::vector<long long>> contacts;
+    std::vector<ChVector<>> state;
+    bool sorted;
+};
+
+// Create a box container and a pile of spheres.
+void CreateModel(ChSystemParallel& system, std::shared_ptr<ChMaterialSurface> mat) {
+    ChMaterialSurface::ContactMethod method = mat->GetContactMethod();
+
+    auto bin = std::make_shared<ChBody>(std::make_shared<ChCollisionModelParallel>(), method);
+    bin->SetMaterialSurface(mat);
+    bin->SetBodyFixed(true);
+    bin->SetCollide(true);
+    bin->GetCollisionModel()->ClearModel();
+    utils::AddBoxGeometry(bin.get(), ChVector<>(1, 1, 0.1), ChVector<>(0, 0, -0.1));
+    utils::AddBoxGeometry(bin.get(), ChVector<>(0.1, 1, 1), ChVector<>(-1.1, 0, 1));
+    utils::AddBoxGeometry(bin.get(), ChVector<>(0.1, 1, 1), ChVector<>(1.1, 0, 1));
+    utils::AddBoxGeometry(bin.get(), ChVector<>(1, 0.1, 1), ChVector<>(0, -1.1, 1));
+    utils::AddBoxGeometry(bin.get(), ChVector<>(1, 0.1, 1), ChVector<>(0, 1.1, 1));
+    bin->GetCollisionModel()->BuildModel();
+    system.AddBody(bin);
+
+    double radius = 0.1;
+    int id = 0;
+    for (int iz = 0; iz < 4; iz++) {
+        for (int ix = -4; ix <= 4; ix++) {
+            for (int iy = -4; iy <= 4; iy++) {
+                // Offset the layers, so that the spheres do not stack up exactly
+                double offset = 0.02 * ((id++ % 7) - 3);
+                auto ball = std::make_shared<ChBody>(std::make_shared<ChCollisionModelParallel>(), method);
+                ball->SetMaterialSurface(mat);
+                ball->SetMass(1);
+                ball->SetInertiaXX(0.4 * radius * radius * ChVector<>(1, 1, 1));
+                ball->SetPos(ChVector<>(0.21 * ix + offset, 0.21 * iy - offset, radius + 0.22 * iz));
+                ball->SetCollide(true);
+                ball->GetCollisionModel()->ClearModel();
+                utils::AddSphereGeometry(ball.get(), radius);
+                ball->GetCollisionModel()->BuildModel();
+                system.AddBody(ball);
+            }
+        }
+    }
+}
+
+// Simulate with the specified number of threads and bin grid, recording the
+// contact list after each step.
+RunResult Simulate(ChSystemParallel& system, int nthreads, const vec3& bins) {
+    system.Set_G_acc(ChVector<>(0, 0, -9.81));
+    system.GetSettings()->deterministic = true;
+    system.GetSettings()->perform_thread_tuning = false;
+    system.GetSettings()->max_threads = nthreads;
+    system.GetSettings()->solver.max_iteration_bilateral = 0;
+    system.GetSettings()->collision.bins_per_axis = bins;
+    system.SetParallelThreadNumber(nthreads);
+    CHOMPfunctions::SetNumThreads(nthreads);
+
+    RunResult result;
+    result.sorted = true;
+    for (int i = 0; i < num_steps; i++) {
+        system.DoStepDynamics(1e-3);
+        const custom_vector<long long>& pairs = system.data_manager->host_data.contact_pairs;
+        std::vector<long long> contacts(pairs.begin(), pairs.begin() + system.data_manager->num_rigid_contacts);
+        result.sorted &= std::is_sorted(contacts.begin(), contacts.end());
+        result.contacts.push_back(contacts);
+    }
+
+    for (auto body : *system.Get_bodylist()) {
+        result.state.push_back(body->GetPos());
+        result.state.push_back(body->GetPos_dt());
+        result.state.push_back(body->GetWvel_par());
+    }
+    return result;
+}
+
+RunResult SimulateNSC(int nthreads, const vec3& bins) {
+    ChSystemParallelNSC system;
+    system.GetSettings()->solver.solver_mode = SolverMode::SLIDING;
+    system.GetSettings()->solver.max_iteration_normal = 0;
+    system.GetSettings()->solver.max_iteration_sliding = 50;
+    system.GetSettings()->solver.max_iteration_spinning = 0;
+    system.GetSettings()->collision.collision_envelope = 0.005;
+    system.ChangeSolverType(SolverType::APGD);
+
+    auto mat = std::make_shared<ChMaterialSurfaceNSC>();
+    mat->SetFriction(0.4f);
+    CreateModel(system, mat);
+
+    return Simulate(system, nthreads, bins);
+}
+
+RunResult SimulateSMC(int nthreads, const vec3& bins) {
+    ChSystemParallelSMC system;
+    system.GetSettings()->solver.contact_force_model = ChSystemSMC::ContactForceModel::Hertz;
+    system.GetSettings()->solver.tangential_displ_mode = ChSystemSMC::TangentialDisplacementModel::MultiStep;
+
+    auto mat = std::make_shared<ChMaterialSurfaceSMC>();
+    mat->SetYoungModulus(1e6f);
+    mat->SetFriction(0.4f);
+    mat->SetRestitution(0.1f);
+    CreateModel(system, mat);
+
+    return Simulate(system, nthreads, bins);
+}
+
+// Check a run against the reference run (1 thread, 5x5x5 bins).
+bool Check(const std::string& name, const RunResult& ref, const RunResult& run) {
+    if (!ref.sorted || !run.sorted) {
+        cout << name << ": contact list not sorted" << endl;
+        return false;
+    }
+    for (int i = 0; i < num_steps; i++) {
+        if (run.contacts[i] != ref.contacts[i]) {
+            cout << name << ": different contact list at step " << i << " (" << run.contacts[i].size() << " vs. "
+                 << ref.contacts[i].size() << " contacts)" << endl;
+            return false;
+        }
+    }
+    for (size_t i = 0; i < ref.state.size(); i++) {
+        if (!(run.state[i] == ref.state[i])) {
+            cout << name << ": different final state (body " << i / 3 << ")" << endl;
+            return false;
+        }
+    }
+    return true;
+}
+
+int main(int argc, char* argv[]) {
+    bool passed = true;
+
+    RunResult nsc = SimulateNSC(1, vec3(5, 5, 5));
+    passed &= Check("NSC, 1 thread, 2x3x7 bins", nsc, SimulateNSC(1, vec3(2, 3, 7)));
+    passed &= Check("NSC, 4 threads", nsc, SimulateNSC(4, vec3(5, 5, 5)));
+    passed &= Check("NSC, 4 threads, 2x3x7 bins", nsc, SimulateNSC(4, vec3(2, 3, 7)));
+
+    RunResult smc = SimulateSMC(1, vec3(5, 5, 5));
+    passed &= Check("SMC, 1 thread, 2x3x7 bins", smc, SimulateSMC(1, vec3(2, 3, 7)));
+    passed &= Check("SMC, 4 threads", smc, SimulateSMC(4, vec3(5, 5, 5)));
+    passed &= Check("SMC, 4 threads, 2x3x7 bins", smc, SimulateSMC(4, vec3(2, 3, 7)));
+
+    cout << "Test " << (passed ? "PASSED" : "FAILED") << endl;
+
+    // Return 0 if all tests passed.
+    return !passed;
+}
@@ -0,0 +1,104 @@
+// =============================================================================
+// PROJECT CHRONO - http://projectchrono.org
+//
+// Copyright (c) 2014 projectchrono.org
+// All rights reserved.
+//
+// Use of this source code is governed by a BSD-style license that can be found
+// in the LICENSE file at the top level of the distribution and at
+// http://projectchrono.org/license-chrono.txt.
+//
+// =============================================================================
+//
+// ChronoParallel unit test for lazy body updates (settings.lazy_body_update).
+// The same bodies are simulated with and without lazy updates; bodies with
+// assets or flagged by the user must be up to date at each step, the other ones
+// after a call to SyncBodies. A body loaded at each step with a force at a point
+// and a torque in its local frame (computed with the ChBody frame) is flagged by
+// the user and must match the reference.
+// =============================================================================
+
+#include <vector>
+
+#include "chrono/assets/ChSphereShape.h"
+
+#include "chrono_parallel/physics/ChSystemParallel.h"
+
+#include "unit_testing.h"
+
+using namespace chrono;
+using namespace chrono::collision;
+
+// Create the bodies: a free spinning body, a body with an asset, a body
+// flagged by the user, a fixed body, and a flagged body loaded with local forces.
+std::vector<std::shared_ptr<ChBody>> CreateBodies(ChSystemParallelNSC& system, bool lazy) {
+    system.Set_G_acc(ChVector<>(0, -9.80665, 0));
+    system.GetSettings()->max_threads = 1;
+    system.GetSettings()->perform_thread_tuning = false;
+    system.GetSettings()->lazy_body_update = lazy;
+
+    std::vector<std::shared_ptr<ChBody>> bodies;
+    for (int i = 0; i < 5; i++) {
+        auto body = std::make_shared<ChBody>(std::make_shared<ChCollisionModelParallel>());
+        body->SetMass(1 + i);
+        body->SetInertiaXX(ChVector<>(0.1, 0.2, 0.3));
+        body->SetPos(ChVector<>(i, 0, 0));
+        body->SetPos_dt(ChVector<>(1, 2, 0));
+        body->SetWvel_loc(ChVector<>(1, 2, 3));
+        body->SetCollide(false);
+        system.AddBody(body);
+        bodies.push_back(body);
+    }
+
+    bodies[1]->AddAsset(std::make_shared<ChSphereShape>());
+    system.SetBodySyncRequired(bodies[2], true);
+    bodies[3]->SetBodyFixed(true);
+    system.SetBodySyncRequired(bodies[4], true);
+
+    return bodies;
+}
+
+// Apply a force at a point and a torque, both expressed in the body frame.
+void LoadBody(std::shared_ptr<ChBody> body) {
+    body->Empty_forces_accumulators();
+    body->Accumulate_force(ChVector<>(0, 0, 5), ChVector<>(0.5, 0, 0), true);
+    body->Accumulate_torque(ChVector<>(1, 0, 0), true);
+}
+
+void CompareBodies(std::shared_ptr<ChBody> a, std::shared_ptr<ChBody> b) {
+    WeakEqual(ToReal3(a->GetPos()), ToReal3(b->GetPos()), 1e-10);
+    WeakEqual(ToQuaternion(a->GetRot()), ToQuaternion(b->GetRot()), 1e-10);
+    WeakEqual(ToReal3(a->GetPos_dt()), ToReal3(b->GetPos_dt()), 1e-10);
+    WeakEqual(ToReal3(a->GetWvel_loc()), ToReal3(b->GetWvel_loc()), 1e-10);
+}
+
+int main(int argc, char* argv[]) {
+    double time_step = 1e-3;
+    CHOMPfunctions::SetNumThreads(1);
+
+    ChSystemParallelNSC system_ref;
+    ChSystemParallelNSC system_lazy;
+    auto bodies_ref = CreateBodies(system_ref, false);
+    auto bodies_lazy = CreateBodies(system_lazy, true);
+
+    for (int i = 0; i < 500; i++) {
+        LoadBody(bodies_ref[4]);
+        LoadBody(bodies_lazy[4]);
+        system_ref.DoStepDynamics(time_step);
+        system_lazy.DoStepDynamics(time_step);
+
+        // Bodies with assets and bodies flagged by the user are updated at each step
+        CompareBodies(bodies_ref[1], bodies_lazy[1]);
+        CompareBodies(bodies_ref[2], bodies_lazy[2]);
+        CompareBodies(bodies_ref[4], bodies_lazy[4]);
+
+        // All bodies are up to date after synchronization
+        if (i % 100 == 99) {
+            system_lazy.SyncBodies();
+            for (int j = 0; j < 5; j++)
+                CompareBodies(bodies_ref[j], bodies_lazy[j]);
+        }
+    }
+
+    return 0;
+}
@@ -12,130 +12,303 @@
 // Authors: Hammad Mazhar
 // =============================================================================
 //
-// ChronoParallel unit test for MPR collision detection
+// ChronoParallel unit test for MPM
+// - grid utility functions (grid coordinates, node locations, weights)
+// - MPM solver (MPM_Initialize, MPM_Solve and MPM_UpdateDeformationGradient):
+//   a block of markers at rest must stay at rest with an undeformed deformation
+//   gradient; without elastic forces, a velocity step must match a reference
+//   particle-grid-particle transfer evaluated directly on a dense grid; the
+//   results must not depend on the number of threads.
 // =============================================================================
 
+#include <algorithm>
+#include <cfloat>
+#include <cmath>
 #include <cstdio>
+#include <map>
+#include <tuple>
 #include <vector>
-#include <cmath>
-
-#include "unit_testing.h"
 
+#include "chrono/core/ChVector.h"
+#include "chrono/parallel/ChOpenMP.h"
+#include "chrono_parallel/physics/ChMPM.cuh"
 #include "chrono_parallel/physics/MPMUtils.h"
 
 using namespace chrono;
 
-int main(int argc, char* argv[]) {
-    real3 min_bounding_point(-1, -1, -1);
-    real3 max_bounding_point(1, 1, 1);
+bool WeakEqual(float x, float y, float eps, const char* label) {
+    if (std::abs(x - y) > eps) {
+        printf("%s: %f does not equal %f\n", label, x, y);
+        return false;
+    }
+    return true;
+}
 
-    real radius = 0.25;
+// -----------------------------------------------------------------------------
+// Grid utility functions
+// -----------------------------------------------------------------------------
 
-    max_bounding_point = real3(Max(Ceil(max_bounding_point.x), Ceil(max_bounding_point.x + radius * 6)),
-                               Max(Ceil(max_bounding_point.y), Ceil(max_bounding_point.y + radius * 6)),
-                               Max(Ceil(max_bounding_point.z), Ceil(max_bounding_point.z + radius * 6)));
+bool TestGrid() {
+    float3 min_bounding_point = make_float3(-3, -3, -3);
 
-    min_bounding_point = real3(Min(Floor(min_bounding_point.x), Floor(min_bounding_point.x - radius * 6)),
-                               Min(Floor(min_bounding_point.y), Floor(min_bounding_point.y - radius * 6)),
-                               Min(Floor(min_bounding_point.z), Floor(min_bounding_point.z - radius * 6)));
+    const float radius = 0.25f;
+    const float bin_edge = radius * 2;
+    const float inv_bin_edge = 1.0f / bin_edge;
 
-    real3 diag = max_bounding_point - min_bounding_point;
+    int3 bins_per_axis = make_int3(12, 12, 12);
 
-    vec3 bins_per_axis = vec3(diag / (radius * 2));
+    float3 point_a = make_float3(0.44236f, 0.65093f, 0.24482f);
 
-    real3 point_a = real3(0.44236, 0.65093, 0.24482);
-    real3 point_b = real3(0.63257, 0.83347, 0.74071);
-    real3 point_c = real3(0.82623, 0.92491, 0.92109);
+    bool passed = true;
 
-    const real bin_edge = radius * 2;
-    const real inv_bin_edge = real(1) / bin_edge;
+    // Grid coordinates
+    passed &= WeakEqual((float)GridCoord(point_a.x, inv_bin_edge, min_bounding_point.x), 7, 0, "GridCoord x");
+    passed &= WeakEqual((float)GridCoord(point_a.y, inv_bin_edge, min_bounding_point.y), 7, 0, "GridCoord y");
+    passed &= WeakEqual((float)GridCoord(point_a.z, inv_bin_edge, min_bounding_point.z), 6, 0, "GridCoord z");
+
+    // Node locations
+    float3 node_a = NodeLocation(5, 5, 4, bin_edge, min_bounding_point);
+    float3 node_b = NodeLocation(9, 9, 8, bin_edge, min_bounding_point);
+    passed &= WeakEqual(node_a.x, -0.5f, 1e-6f, "NodeLocation") && WeakEqual(node_a.y, -0.5f, 1e-6f, "NodeLocation") &&
+              WeakEqual(node_a.z, -1, 1e-6f, "NodeLocation");
+    passed &= WeakEqual(node_b.x, 1.5f, 1e-6f, "NodeLocation") && WeakEqual(node_b.y, 1.5f, 1e-6f, "NodeLocation") &&
+              WeakEqual(node_b.z, 1, 1e-6f, "NodeLocation");
+
+    // Weights
+    passed &= WeakEqual(N(point_a - NodeLocation(5, 5, 4, bin_edge, min_bounding_point), inv_bin_edge), 0, 1e-6f, "N");
+    passed &= WeakEqual(N(point_a - NodeLocation(7, 7, 7, bin_edge, min_bounding_point), inv_bin_edge),
+                        0.1822061256f, 1e-6f, "N");
+
+    // Each marker has 125 surrounding nodes, with weights summing to 1
+    int count = 0;
+    float sum = 0;
+    float3 xi = point_a;
+    LOOPOVERNODES(                                                   //
+        sum += N(xi - current_node_location, inv_bin_edge);         //
+        count++;                                                     //
+        )
+    passed &= WeakEqual((float)count, 125, 0, "Stencil size");
+    passed &= WeakEqual(sum, 1, 1e-6f, "Sum of weights");
+
+    return passed;
+}
 
-    printf("bins_per_axis [%d %d %d]\n", bins_per_axis.x, bins_per_axis.y, bins_per_axis.z);
-    printf("max_bounding_point [%f %f %f]\n", max_bounding_point.x, max_bounding_point.y, max_bounding_point.z);
-    printf("min_bounding_point [%f %f %f]\n", min_bounding_point.x, min_bounding_point.y, min_bounding_point.z);
+// -----------------------------------------------------------------------------
+// MPM solver
+// -----------------------------------------------------------------------------
 
-    {
-        printf("Grid Coord\n");
-        int x = GridCoord(point_a.x, inv_bin_edge, min_bounding_point.x);
-        int y = GridCoord(point_a.y, inv_bin_edge, min_bounding_point.y);
-        int z = GridCoord(point_a.z, inv_bin_edge, min_bounding_point.z);
+MPM_Settings CreateSettings(int num_markers, float youngs_modulus) {
+    float kernel_radius = 0.05f;
+    float nu = 0.2f;
 
-        WeakEqual(x, 7);
-        WeakEqual(y, 7);
-        WeakEqual(z, 6);
+    MPM_Settings settings;
+    settings.dt = 1e-3f;
+    settings.kernel_radius = kernel_radius;
+    settings.inv_radius = 1.0f / kernel_radius;
+    settings.bin_edge = kernel_radius * 2;
+    settings.inv_bin_edge = 1.0f / (kernel_radius * 2);
+    settings.max_velocity = 20;
+    settings.mu = youngs_modulus / (2 * (1 + nu));
+    settings.lambda = youngs_modulus * nu / ((1 + nu) * (1 - 2 * nu));
+    settings.hardening_coefficient = 10;
+    settings.theta_c = 2.5e-2f;
+    settings.theta_s = 7.5e-3f;
+    settings.alpha_flip = 0.95f;
+    settings.youngs_modulus = youngs_modulus;
+    settings.poissons_ratio = nu;
+    settings.num_mpm_markers = num_markers;
+    settings.mass = 0.037037f;
+    settings.yield_stress = 0;
+    settings.num_iterations = 20;
+    settings.verbose = false;
+    return settings;
+}
+
+// Block of 8x8x8 markers, with velocity (vx + shear * z, 0, -shear * x).
+void CreateBlock(float vx, float shear, std::vector<float>& pos, std::vector<float>& vel) {
+    int n = 8;
+    float spacing = 0.05f;
+    pos.clear();
+    vel.clear();
+    for (int i = 0; i < n; i++) {
+        for (int j = 0; j < n; j++) {
+            for (int k = 0; k < n; k++) {
+                pos.push_back(i * spacing);
+                pos.push_back(j * spacing);
+                pos.push_back(k * spacing);
+                vel.push_back(vx + shear * k * spacing);
+                vel.push_back(0);
+                vel.push_back(-shear * i * spacing);
+            }
+        }
     }
-    {
-        printf("Current Node\n");
-        WeakEqual(NodeLocation(5, 5, 4, bin_edge, min_bounding_point), real3(-.5, -.5, -1));
-        WeakEqual(NodeLocation(9, 9, 8, bin_edge, min_bounding_point), real3(1.5, 1.5, 1));
+}
+
+// Simulate the block for a few steps, return the final marker velocities and
+// deformation gradient determinants.
+void Simulate(int num_threads, float vx, std::vector<float>& vel, std::vector<float>& jejp) {
+    CHOMPfunctions::SetNumThreads(num_threads);
+
+    std::vector<float> pos;
+    CreateBlock(vx, 0, pos, vel);
+    int num_markers = (int)pos.size() / 3;
+    jejp.resize(num_markers * 2);
+
+    MPM_Settings settings = CreateSettings(num_markers, 1.4e5f);
+    MPM_Initialize(settings, pos);
+    for (int step = 0; step < 3; step++) {
+        MPM_UpdateDeformationGradient(settings, pos, vel, jejp);
+        MPM_Solve(settings, pos, vel);
+        for (int p = 0; p < num_markers; p++) {
+            for (int d = 0; d < 3; d++)
+                pos[p * 3 + d] += settings.dt * vel[p * 3 + d];
+        }
     }
-    {
-        printf("N\n");
-        WeakEqual(N(point_a - NodeLocation(5, 5, 4, bin_edge, min_bounding_point), inv_bin_edge), 0);
-        WeakEqual(N(point_a - NodeLocation(7, 7, 7, bin_edge, min_bounding_point), inv_bin_edge), 0.1822061256, C_EPSILON);
+}
+
+bool CheckRest(const std::vector<float>& vel, const std::vector<float>& jejp) {
+    bool passed = true;
+    int num_markers = (int)jejp.size() / 2;
+    for (int p = 0; p < num_markers; p++) {
+        if (std::abs(vel[p * 3 + 0]) > 1e-6f || std::abs(vel[p * 3 + 1]) > 1e-6f || std::abs(vel[p * 3 + 2]) > 1e-6f) {
+            printf("Marker %d: velocity [%g %g %g], expected 0\n", p, vel[p * 3 + 0], vel[p * 3 + 1], vel[p * 3 + 2]);
+            passed = false;
+        }
+        if (std::abs(jejp[p * 2 + 0] - 1) > 1e-4f || std::abs(jejp[p * 2 + 1] - 1) > 1e-4f) {
+            printf("Marker %d: JE = %g, JP = %g, expected 1\n", p, jejp[p * 2 + 0], jejp[p * 2 + 1]);
+            passed = false;
+        }
     }
-    {  // Each node should have 125 surrounding nodes
-        int ind = 0;
-        real3 xi = point_a;
-        printf("Grid Hash Count\n");
-        LOOPOVERNODES(real3 p = point_a - current_node_location;
-                      // printf("[%d %d %d][%d %d] N:%f\n", i, j, k, current_node, ind, N(p, inv_bin_edge));  //
-                      ind++;  //
-                      )
-        WeakEqual(ind, 125);
+    return passed;
+}
+
+// Reference velocity step without elastic forces: rasterize the marker momenta
+// to a dense map of grid nodes, then blend the interpolated grid velocity (PIC)
+// with the marker velocity (FLIP, unchanged since the grid velocity is not
+// updated). The grid origin is computed as in the solver.
+std::vector<float> ReferenceStep(const MPM_Settings& settings,
+                                 const std::vector<float>& pos,
+                                 const std::vector<float>& vel) {
+    const int num_markers = (int)pos.size() / 3;
+    const float kernel_radius = settings.kernel_radius;
+    const float bin_edge = kernel_radius * 2;
+    const float inv_bin_edge = 1.0f / bin_edge;
+
+    float minimum[3] = {FLT_MAX, FLT_MAX, FLT_MAX};
+    for (int p = 0; p < num_markers; p++) {
+        for (int d = 0; d < 3; d++)
+            minimum[d] = std::min(minimum[d], pos[p * 3 + d]);
+    }
+    for (int d = 0; d < 3; d++)
+        minimum[d] = kernel_radius * roundf(minimum[d] / kernel_radius) - kernel_radius * 6;
+
+    typedef std::tuple<int, int, int> Node;
+    std::map<Node, double> node_mass;
+    std::map<Node, ChVector<double>> node_momentum;
+
+    auto weights = [&](int p, int* cell, double w[3][5]) {
+        for (int d = 0; d < 3; d++) {
+            cell[d] = GridCoord(pos[p * 3 + d], inv_bin_edge, minimum[d]);
+            for (int a = 0; a < 5; a++) {
+                float node_location = (cell[d] - 2 + a) * bin_edge + minimum[d];
+                w[d][a] = N((pos[p * 3 + d] - node_location) * inv_bin_edge);
+            }
+        }
+    };
+
+    for (int p = 0; p < num_markers; p++) {
+        int cell[3];
+        double w[3][5];
+        weights(p, cell, w);
+        for (int a = 0; a < 5; a++) {
+            for (int b = 0; b < 5; b++) {
+                for (int c = 0; c < 5; c++) {
+                    Node node(cell[0] - 2 + a, cell[1] - 2 + b, cell[2] - 2 + c);
+                    double weight = w[0][a] * w[1][b] * w[2][c] * settings.mass;
+                    node_mass[node] += weight;
+                    node_momentum[node] += weight * ChVector<double>(vel[p * 3 + 0], vel[p * 3 + 1], vel[p * 3 + 2]);
+                }
+            }
+        }
+    }
+
+    std::vector<float> new_vel(vel.size());
+    for (int p = 0; p < num_markers; p++) {
+        int cell[3];
+        double w[3][5];
+        weights(p, cell, w);
+        ChVector<double> v_pic(0, 0, 0);
+        for (int a = 0; a < 5; a++) {
+            for (int b = 0; b < 5; b++) {
+                for (int c = 0; c < 5; c++) {
+                    Node node(cell[0] - 2 + a, cell[1] - 2 + b, cell[2] - 2 + c);
+                    double weight = w[0][a] * w[1][b] * w[2][c];
+                    if (weight > 0)
+                        v_pic += weight * node_momentum[node] / node_mass[node];
+                }
+            }
+        }
+        for (int d = 0; d < 3; d++)
+            new_vel[p * 3 + d] = (float)((1 - settings.alpha_flip) * v_pic[d] + settings.alpha_flip * vel[p * 3 + d]);
+    }
+    return new_vel;
+}
+
+bool TestReference(int num_threads) {
+    CHOMPfunctions::SetNumThreads(num_threads);
+
+    std::vector<float> pos, vel;
+    CreateBlock(0.5f, 2.0f, pos, vel);
+    int num_markers = (int)pos.size() / 3;
+    std::vector<float> jejp(num_markers * 2);
+
+    MPM_Settings settings = CreateSettings(num_markers, 0);
+    std::vector<float> expected = ReferenceStep(settings, pos, vel);
+
+    MPM_Initialize(settings, pos);
+    MPM_UpdateDeformationGradient(settings, pos, vel, jejp);
+    MPM_Solve(settings, pos, vel);
+
+    bool passed = true;
+    for (int i = 0; i < (int)vel.size(); i++) {
+        if (std::abs(vel[i] - expected[i]) > 1e-5f) {
+            printf("Marker %d: velocity component %d = %g, reference %g\n", i / 3, i % 3, vel[i], expected[i]);
+            passed = false;
+            break;
+        }
     }
+    return passed;
+}
 
-    real youngs_modulus = (real)1.4e5;
-    real poissons_ratio = (real).2;
-    real theta_c = (real)2.5e-2;
-    real theta_s = (real)7.5e-3;
-    real lambda =
-        youngs_modulus * poissons_ratio / (((real)1. + poissons_ratio) * ((real)1. - (real)2. * poissons_ratio));
-    real mu = youngs_modulus / ((real)2. * ((real)1. + poissons_ratio));
-    real initial_density = (real)4e2;
-    real alpha = (real).95;
-    real hardening_coefficient = (real)10.;
-
-    {
-        printf("Potential_Energy_Derivative\n");
-        const Mat33 FE = Mat33(0.8147, 0.9058, 0.1270, 0.9134, 0.6324, .0975, 0.2785, 0.5469, 0.9575) * 100;
-        const Mat33 FP = Mat33(1, 0, 5, 2, 1, 6, 3, 4, 0) * (.001);
-        Mat33 PED = Potential_Energy_Derivative(FE, FP, mu, lambda, hardening_coefficient);
-        // Print(PED, "PED");
+int main(int argc, char* argv[]) {
+    bool passed = true;
+
+    if (!TestGrid()) {
+        printf("Grid utility functions failed\n");
+        passed = false;
     }
 
-    {
-        printf("Rotational_Derivative\n");
-        const Mat33 FE = Mat33(0.8147, 0.9058, 0.1270, 0.9134, 0.6324, .0975, 0.2785, 0.5469, 0.9575);
-        const Mat33 FP = Mat33(1, 0, 5, 2, 1, 6, 3, 4, 0);
-        Mat33 RD = Rotational_Derivative(FE, FP);
-
-        // Print(RD, "RD");
-        WeakEqual(RD, Mat33(-0.4388320607360907121829996, -2.5644905725011524211254255, 2.6523953516380869288582289,
-                            3.3403002881859262807040523, -0.3555579545919572703738254, -0.1151537247848418710205465,
-                            -1.6067063031830095543028847, 0.5767590099191256536315109, -0.3543936405970238290308316),
-                  1e-6);
+    for (int num_threads : {1, 4}) {
+        if (!TestReference(num_threads)) {
+            printf("Solver does not match the reference transfer (%d threads)\n", num_threads);
+            passed = false;
+        }
     }
-    {
-        printf("Rotational_Derivative_Simple\n");
-        const Mat33 FE = Mat33(0.8147, 0.9058, 0.1270, 0.9134, 0.6324, .0975, 0.2785, 0.5469, 0.9575);
-        const Mat33 FP = Mat33(1, 0, 5, 2, 1, 6, 3, 4, 0);
-        Mat33 U, V, R, S, W;
-        real3 E;
-        SVD(FE, U, E, V);
-        // Perform polar decomposition F = R*S
-        R = MultTranspose(U, V);
-        S = V * MultTranspose(Mat33(E), V);
-        // See tech report end of page 2
-        W = TransposeMult(R, FP);
-
-        Mat33 RD1 = Rotational_Derivative_Simple(R, S, FP);
-
-        Mat33 RD2 = Rotational_Derivative(FE, FP);
-
-//        Print(RD1,"RD1");
-//        Print(RD2,"RD2");
-
-        WeakEqual(RD1, RD2, 1e-6);
+
+    for (float vx : {0.0f, 0.5f}) {
+        std::vector<float> vel_1, jejp_1;
+        std::vector<float> vel_n, jejp_n;
+        Simulate(1, vx, vel_1, jejp_1);
+        Simulate(4, vx, vel_n, jejp_n);
+
+        if (vx == 0 && !CheckRest(vel_1, jejp_1))
+            passed = false;
+        if (vel_1 != vel_n || jejp_1 != jejp_n) {
+            printf("Results with 1 and 4 threads differ (vx = %g)\n", vx);
+            passed = false;
+        }
     }
+
+    printf(passed ? "Test PASSED\n" : "Test FAILED\n");
+    return passed ? 0 : 1;
 }
@@ -0,0 +1,167 @@
+// =============================================================================
+// PROJECT CHRONO - http://projectchrono.org
+//
+// Copyright (c) 2016 projectchrono.org
+// All rights reserved.
+//
+// Use of this source code is governed by a BSD-style license that can be found
+// in the LICENSE file at the top level of the distribution and at
+// http://projectchrono.org/license-chrono.txt.
+//
+// =============================================================================
+//
+// ChronoParallel unit test for the vectorized SMC contact force kernel
+// (settings.solver.use_simd_contact_forces). A row of overlapping spheres, with
+// different materials and initial velocities, rests on a fixed box. One step is
+// taken with the SIMD and with the scalar kernel, for the Hooke and Hertz models
+// without contact history. The number of contacts is not a multiple of the SIMD
+// width, so the last contacts are processed after the last full batch. The
+// contact forces and torques on all bodies must agree up to round-off.
+// =============================================================================
+
+#include <algorithm>
+#include <cmath>
+#include <iostream>
+#include <limits>
+#include <vector>
+
+#include "chrono/utils/ChUtilsCreators.h"
+
+#include "chrono_parallel/physics/ChSystemParallel.h"
+
+using namespace chrono;
+using namespace chrono::collision;
+
+using std::cout;
+using std::endl;
+
+const int num_balls = 7;  // 7 ball-box and 6 ball-ball contacts
+
+// Take one step and return the contact force and torque on each body.
+std::vector<real3> ContactForces(ChSystemSMC::ContactForceModel model,
+                                 ChSystemSMC::TangentialDisplacementModel displ_mode,
+                                 bool use_mat_props,
+                                 bool use_simd,
+                                 int& num_contacts) {
+    ChSystemParallelSMC system;
+    system.Set_G_acc(ChVector<>(0, 0, -9.81));
+    system.GetSettings()->solver.contact_force_model = model;
+    system.GetSettings()->solver.tangential_displ_mode = displ_mode;
+    system.GetSettings()->solver.use_material_properties = use_mat_props;
+    system.GetSettings()->solver.use_simd_contact_forces = use_simd;
+    system.GetSettings()->solver.max_iteration_bilateral = 0;
+    system.GetSettings()->collision.bins_per_axis = vec3(4, 4, 4);
+
+    auto ground_mat = std::make_shared<ChMaterialSurfaceSMC>();
+    ground_mat->SetYoungModulus(2e6f);
+    ground_mat->SetFriction(0.6f);
+    ground_mat->SetRestitution(0.2f);
+    ground_mat->SetAdhesion(5);
+    ground_mat->SetKn(2e5f);
+    ground_mat->SetGn(40);
+    ground_mat->SetKt(1e5f);
+    ground_mat->SetGt(20);
+
+    auto ground = std::make_shared<ChBody>(std::make_shared<ChCollisionModelParallel>(), ChMaterialSurface::SMC);
+    ground->SetMaterialSurface(ground_mat);
+    ground->SetBodyFixed(true);
+    ground->SetCollide(true);
+    ground->GetCollisionModel()->ClearModel();
+    utils::AddBoxGeometry(ground.get(), ChVector<>(1, 1, 0.1), ChVector<>(0, 0, -0.1));
+    ground->GetCollisionModel()->BuildModel();
+    system.AddBody(ground);
+
+    double radius = 0.1;
+    for (int i = 0; i < num_balls; i++) {
+        auto mat = std::make_shared<ChMaterialSurfaceSMC>();
+        mat->SetYoungModulus(1e6f * (1 + 0.5f * i));
+        mat->SetFriction(0.2f + 0.05f * i);
+        mat->SetRestitution(0.1f * (i % 3));
+        mat->SetAdhesion(2.0f * (i % 2));
+        mat->SetKn(1e5f * (1 + i));
+        mat->SetGn(20.0f + 5 * i);
+        mat->SetKt(5e4f * (1 + i));
+        mat->SetGt(10.0f + 2 * i);
+
+        // Overlap 0.01 with the neighbors and 0.004 + 0.001 * i with the box
+        auto ball = std::make_shared<ChBody>(std::make_shared<ChCollisionModelParallel>(), ChMaterialSurface::SMC);
+        ball->SetMaterialSurface(mat);
+        ball->SetMass(1 + 0.1 * i);
+        ball->SetInertiaXX(0.4 * radius * radius * ChVector<>(1, 1, 1));
+        ball->SetPos(ChVector<>(0.19 * (i - num_balls / 2), 0.002 * i, radius - 0.004 - 0.001 * i));
+        ball->SetPos_dt(ChVector<>(0.1 * (i - 3), 0.05 * (i % 3), -0.02 * i));
+        ball->SetWvel_par(ChVector<>(0.5 * (i % 2), -0.3 * i, 0.2));
+        ball->SetCollide(true);
+        ball->GetCollisionModel()->ClearModel();
+        utils::AddSphereGeometry(ball.get(), radius);
+        ball->GetCollisionModel()->BuildModel();
+        system.AddBody(ball);
+    }
+
+    system.DoStepDynamics(1e-4);
+    num_contacts = system.GetNcontacts();
+
+    std::vector<real3> forces;
+    for (auto body : *system.Get_bodylist()) {
+        forces.push_back(system.GetBodyContactForce(body));
+        forces.push_back(system.GetBodyContactTorque(body));
+    }
+    return forces;
+}
+
+bool Compare(ChSystemSMC::ContactForceModel model,
+             ChSystemSMC::TangentialDisplacementModel displ_mode,
+             bool use_mat_props) {
+    int num_contacts_simd;
+    int num_contacts_scalar;
+    auto simd = ContactForces(model, displ_mode, use_mat_props, true, num_contacts_simd);
+    auto scalar = ContactForces(model, displ_mode, use_mat_props, false, num_contacts_scalar);
+
+    cout << "model: " << model << "  displ. mode: " << displ_mode << "  mat. props: " << use_mat_props
+         << "  contacts: " << num_contacts_simd << endl;
+
+    if (num_contacts_simd != 2 * num_balls - 1 || num_contacts_scalar != num_contacts_simd) {
+        cout << "   unexpected number of contacts: " << num_contacts_simd << " " << num_contacts_scalar << endl;
+        return false;
+    }
+
+    real scale = 1;
+    for (auto& f : scalar)
+        scale = std::max(scale, Length(f));
+    real tol = 1000 * std::numeric_limits<real>::epsilon() * scale;
+
+    bool passed = true;
+    for (size_t i = 0; i < simd.size(); i++) {
+        real err = Length(simd[i] - scalar[i]);
+        if (err > tol) {
+            cout << "   body " << i / 2 << (i % 2 ? " torque" : " force") << ": " << simd[i].x << " " << simd[i].y
+                 << " " << simd[i].z << "  (scalar: " << scalar[i].x << " " << scalar[i].y << " " << scalar[i].z
+                 << ")" << endl;
+            passed = false;
+        }
+        if (i >= 2 && i % 2 == 0 && Length(scalar[i]) == 0) {
+            cout << "   no contact force on body " << i / 2 << endl;
+            passed = false;
+        }
+    }
+    return passed;
+}
+
+int main(int argc, char* argv[]) {
+#if !defined(USE_AVX) && !defined(USE_SSE)
+    cout << "Built without SIMD support: the scalar kernel is used in both cases" << endl;
+#endif
+
+    bool passed = true;
+    for (auto model : {ChSystemSMC::Hooke, ChSystemSMC::Hertz}) {
+        for (auto displ_mode : {ChSystemSMC::None, ChSystemSMC::OneStep}) {
+            passed &= Compare(model, displ_mode, true);
+            passed &= Compare(model, displ_mode, false);
+        }
+    }
+
+    cout << "Test " << (passed ? "PASSED" : "FAILED") << endl;
+
+    // Return 0 if all tests passed.
+    return !passed;
+}
@@ -0,0 +1,174 @@
+// =============================================================================
+// PROJECT CHRONO - http://projectchrono.org
+//
+// Copyright (c) 2014 projectchrono.org
+// All rights reserved.
+//
+// Use of this source code is governed by a BSD-style license that can be found
+// in the LICENSE file at the top level of the distribution and at
+// http://projectchrono.org/license-chrono.txt.
+//
+// =============================================================================
+//
+// Test for the removal of bodies from an assembly: constant-time removal with
+// RemoveBody() and deferred removal with RemoveBatch(). A layer of spheres rests
+// on the ground; some are removed, and the body list and the objects in the
+// Bullet collision world are checked. Removing a body that is not in the system
+// must have no effect.
+//
+// =============================================================================
+
+#include <algorithm>
+#include <iostream>
+#include <set>
+#include <vector>
+
+#include "chrono/collision/ChCCollisionSystemBullet.h"
+#include "chrono/physics/ChSystemNSC.h"
+
+using namespace chrono;
+using namespace chrono::collision;
+
+using std::cout;
+using std::endl;
+
+// Create the ground and a layer of n x n spheres on it.
+std::vector<std::shared_ptr<ChBody>> CreateModel(ChSystem& system, int n) {
+    auto ground = std::make_shared<ChBody>();
+    ground->SetBodyFixed(true);
+    ground->GetCollisionModel()->ClearModel();
+    ground->GetCollisionModel()->AddBox(n, 0.1, n, ChVector<>(0, -0.1, 0));
+    ground->GetCollisionModel()->BuildModel();
+    ground->SetCollide(true);
+    system.AddBody(ground);
+
+    std::vector<std::shared_ptr<ChBody>> spheres;
+    for (int ix = 0; ix < n; ix++) {
+        for (int iz = 0; iz < n; iz++) {
+            auto sphere = std::make_shared<ChBody>();
+            sphere->SetPos(ChVector<>(0.3 * ix, 0.1, 0.3 * iz));
+            sphere->GetCollisionModel()->ClearModel();
+            sphere->GetCollisionModel()->AddSphere(0.1);
+            sphere->GetCollisionModel()->BuildModel();
+            sphere->SetCollide(true);
+            system.AddBody(sphere);
+            spheres.push_back(sphere);
+        }
+    }
+
+    return spheres;
+}
+
+// Check that the body list of the system contains exactly the expected bodies, and that the
+// Bullet collision world contains one object per body.
+bool Check(const std::string& name, ChSystem& system, const std::set<ChBody*>& expected) {
+    const auto& bodies = *system.Get_bodylist();
+    std::set<ChBody*> actual;
+    for (auto body : bodies)
+        actual.insert(body.get());
+
+    if (bodies.size() != expected.size() || actual != expected) {
+        cout << name << ": unexpected bodies in the system" << endl;
+        return false;
+    }
+
+    auto collision_system = std::static_pointer_cast<ChCollisionSystemBullet>(system.GetCollisionSystem());
+    int num_objects = collision_system->GetBulletCollisionWorld()->getNumCollisionObjects();
+    if (num_objects != (int)bodies.size()) {
+        cout << name << ": " << num_objects << " collision objects for " << bodies.size() << " bodies" << endl;
+        return false;
+    }
+
+    return true;
+}
+
+int main(int argc, char* argv[]) {
+    bool passed = true;
+
+    ChSystemNSC system;
+    auto spheres = CreateModel(system, 20);
+
+    std::set<ChBody*> expected;
+    for (auto body : *system.Get_bodylist())
+        expected.insert(body.get());
+
+    for (int i = 0; i < 10; i++)
+        system.DoStepDynamics(1e-3);
+    passed &= system.GetNcontacts() > 0;
+
+    // Constant-time removal of single bodies
+    for (int i = 0; i < 100; i++) {
+        auto sphere = spheres[(i * 37) % spheres.size()];
+        if (!sphere->GetSystem())
+            continue;
+        system.RemoveBody(sphere);
+        expected.erase(sphere.get());
+    }
+    passed &= Check("RemoveBody", system, expected);
+
+    for (int i = 0; i < 10; i++)
+        system.DoStepDynamics(1e-3);
+    passed &= Check("RemoveBody (after steps)", system, expected);
+
+    // Deferred removal: nothing changes until the next step. Queue some bodies twice, and some
+    // that were already removed.
+    std::vector<ChBody*> order;
+    for (auto body : *system.Get_bodylist())
+        order.push_back(body.get());
+
+    for (int i = 0; i < (int)spheres.size(); i += 3) {
+        system.RemoveBatch(spheres[i]);
+        system.RemoveBatch(spheres[i]);
+    }
+    passed &= Check("RemoveBatch (before step)", system, expected);
+
+    for (int i = 0; i < (int)spheres.size(); i += 3)
+        expected.erase(spheres[i].get());
+    system.DoStepDynamics(1e-3);
+    passed &= Check("RemoveBatch", system, expected);
+
+    // The order of the remaining bodies is preserved
+    order.erase(std::remove_if(order.begin(), order.end(), [&](ChBody* body) { return !expected.count(body); }),
+                order.end());
+    const auto& bodies = *system.Get_bodylist();
+    for (size_t i = 0; i < bodies.size(); i++) {
+        if (bodies[i].get() != order[i]) {
+            cout << "RemoveBatch: order of the bodies not preserved" << endl;
+            passed = false;
+            break;
+        }
+    }
+
+    for (int i = 0; i < 10; i++)
+        system.DoStepDynamics(1e-3);
+    passed &= Check("RemoveBatch (after steps)", system, expected);
+    passed &= system.GetNcontacts() > 0;
+
+    // Removing a body twice, or removing a body of another system, has no effect
+    auto body = system.Get_bodylist()->back();
+    system.RemoveBody(body);
+    system.RemoveBody(body);
+    expected.erase(body.get());
+    passed &= Check("RemoveBody (twice)", system, expected);
+
+    ChSystemNSC other;
+    auto other_spheres = CreateModel(other, 2);
+    system.RemoveBody(other_spheres[0]);
+    passed &= Check("RemoveBody (other system)", system, expected);
+    if (other_spheres[0]->GetSystem() != &other || other.Get_bodylist()->size() != 5) {
+        cout << "RemoveBody (other system): body removed from its own system" << endl;
+        passed = false;
+    }
+
+    // A removed body can be added again
+    system.AddBody(spheres[0]);
+    expected.insert(spheres[0].get());
+    system.DoStepDynamics(1e-3);
+    passed &= Check("AddBody", system, expected);
+
+    cout << "Bodies: " << system.Get_bodylist()->size() << "  Contacts: " << system.GetNcontacts() << endl;
+    cout << "Test " << (passed ? "PASSED" : "FAILED") << endl;
+
+    // Return 0 if all tests passed.
+    return !passed;
+}
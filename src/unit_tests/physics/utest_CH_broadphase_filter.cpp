@@ -0,0 +1,119 @@
+// =============================================================================
+// PROJECT CHRONO - http://projectchrono.org
+//
+// Copyright (c) 2014 projectchrono.org
+// All rights reserved.
+//
+// Use of this source code is governed by a BSD-style license that can be found
+// in the LICENSE file at the top level of the distribution and at
+// http://projectchrono.org/license-chrono.txt.
+//
+// =============================================================================
+//
+// Test for the filtering of broadphase pairs in the Bullet collision system.
+// A row of overlapping spheres is split in groups of two; pairs of spheres in
+// the same group are rejected by a per-pair or by a batched callback, before
+// the narrow phase (no contact manifolds are created for them).
+//
+// =============================================================================
+
+#include <iostream>
+
+#include "chrono/collision/ChCCollisionSystemBullet.h"
+#include "chrono/physics/ChSystemNSC.h"
+
+using namespace chrono;
+using namespace chrono::collision;
+
+using std::cout;
+using std::endl;
+
+const int num_spheres = 6;
+
+// Group of the body owning a collision model
+int GetGroup(ChCollisionModel* model) {
+    return static_cast<ChBody*>(model->GetContactable())->GetIdentifier() / 2;
+}
+
+class PairCallback : public ChCollisionSystem::BroadphaseCallback {
+  public:
+    PairCallback() : num_calls(0) {}
+    virtual bool OnBroadphase(ChCollisionModel* modelA, ChCollisionModel* modelB) override {
+        num_calls++;
+        return GetGroup(modelA) != GetGroup(modelB);
+    }
+    int num_calls;
+};
+
+class BatchCallback : public ChCollisionSystem::BroadphaseBatchCallback {
+  public:
+    BatchCallback() : num_calls(0) {}
+    virtual void OnBroadphase(int num_pairs,
+                              ChCollisionModel* const* modelsA,
+                              ChCollisionModel* const* modelsB,
+                              char* keep) override {
+        num_calls++;
+        for (int i = 0; i < num_pairs; i++)
+            keep[i] = GetGroup(modelsA[i]) != GetGroup(modelsB[i]);
+    }
+    int num_calls;
+};
+
+// Perform the collision detection and check the number of contacts and manifolds
+bool Check(ChSystemNSC& system, int num_contacts, const std::string& label) {
+    system.ComputeCollisions();
+    auto collision_system = std::static_pointer_cast<ChCollisionSystemBullet>(system.GetCollisionSystem());
+    int num_manifolds = collision_system->GetBulletCollisionWorld()->getDispatcher()->getNumManifolds();
+
+    cout << label << "  contacts: " << system.GetNcontacts() << "  manifolds: " << num_manifolds << endl;
+    return system.GetNcontacts() == num_contacts && num_manifolds == num_contacts;
+}
+
+int main(int argc, char* argv[]) {
+    ChSystemNSC system;
+    system.Set_G_acc(ChVector<>(0, 0, 0));
+
+    // Row of spheres, each overlapping with its neighbors
+    for (int i = 0; i < num_spheres; i++) {
+        auto body = std::make_shared<ChBody>();
+        body->SetIdentifier(i);
+        body->SetPos(ChVector<>(0.8 * i, 0, 0));
+        body->GetCollisionModel()->ClearModel();
+        body->GetCollisionModel()->AddSphere(0.5);
+        body->GetCollisionModel()->BuildModel();
+        body->SetCollide(true);
+        system.AddBody(body);
+    }
+
+    bool passed = true;
+
+    // No filtering
+    passed &= Check(system, num_spheres - 1, "No filter   ");
+
+    // Per-pair callback: reject pairs in the same group
+    PairCallback pair_callback;
+    system.GetCollisionSystem()->RegisterBroadphaseCallback(&pair_callback);
+    passed &= Check(system, num_spheres / 2 - 1, "Pair filter ");
+    passed &= pair_callback.num_calls == num_spheres - 1;
+    system.GetCollisionSystem()->RegisterBroadphaseCallback(nullptr);
+
+    // Filtered pairs are processed again once the callback is removed
+    passed &= Check(system, num_spheres - 1, "No filter   ");
+
+    // Batched callback
+    BatchCallback batch_callback;
+    system.GetCollisionSystem()->RegisterBroadphaseBatchCallback(&batch_callback);
+    passed &= Check(system, num_spheres / 2 - 1, "Batch filter");
+    passed &= batch_callback.num_calls == 1;
+
+    // Both callbacks: the per-pair callback only sees the pairs accepted by the batched callback
+    pair_callback.num_calls = 0;
+    system.GetCollisionSystem()->RegisterBroadphaseCallback(&pair_callback);
+    passed &= Check(system, num_spheres / 2 - 1, "Both filters");
+    passed &= pair_callback.num_calls == num_spheres / 2 - 1;
+
+    cout << "Test " << (passed ? "PASSED" : "FAILED") << endl;
+
+    // Return 0 if all tests passed.
+    return !passed;
+}
@@ -0,0 +1,131 @@
+// =============================================================================
+// PROJECT CHRONO - http://projectchrono.org
+//
+// Copyright (c) 2014 projectchrono.org
+// All rights reserved.
+//
+// Use of this source code is governed by a BSD-style license that can be found
+// in the LICENSE file at the top level of the distribution and at
+// http://projectchrono.org/license-chrono.txt.
+//
+// =============================================================================
+//
+// Unit test for the pooled NSC contact container (ChContactContainerNSCpooled).
+// A pile of balls (with and without rolling friction) falls in a box. The same
+// simulation is run with the default list-based container and with the pooled
+// container, and the results are checked to be bitwise identical.
+//
+// =============================================================================
+
+#include <vector>
+
+#include "chrono/physics/ChContactContainerNSCpooled.h"
+#include "chrono/physics/ChSystemNSC.h"
+#include "chrono/utils/ChUtilsCreators.h"
+
+using namespace chrono;
+
+double end_time = 0.5;    // total simulation time
+double time_step = 5e-3;  // integration step size
+
+int num_layers = 4;
+int num_balls_x = 4;
+int num_balls_z = 4;
+double radius = 0.05;
+double mass = 1;
+
+// Count contacts and accumulate the reported forces, to compare the two containers.
+class ContactReporter : public ChContactContainer::ReportContactCallback {
+  public:
+    ContactReporter() : num_contacts(0), total_force(VNULL) {}
+
+    virtual bool OnReportContact(const ChVector<>& pA,
+                                 const ChVector<>& pB,
+                                 const ChMatrix33<>& plane_coord,
+                                 const double& distance,
+                                 const ChVector<>& cforce,
+                                 const ChVector<>& ctorque,
+                                 ChContactable* modA,
+                                 ChContactable* modB) override {
+        num_contacts++;
+        total_force += plane_coord.Matr_x_Vect(cforce);
+        return true;
+    }
+
+    int num_contacts;
+    ChVector<> total_force;
+};
+
+void run_simulation(bool pooled, std::vector<ChVector<>>& positions, ContactReporter& reporter) {
+    ChSystemNSC system;
+    system.Set_G_acc(ChVector<>(0, -9.81, 0));
+    system.SetMaxItersSolverSpeed(50);
+    if (pooled)
+        system.SetContactContainer(std::make_shared<ChContactContainerNSCpooled>());
+
+    auto material = std::make_shared<ChMaterialSurfaceNSC>();
+    material->SetFriction(0.4f);
+
+    auto material_rolling = std::make_shared<ChMaterialSurfaceNSC>();
+    material_rolling->SetFriction(0.4f);
+    material_rolling->SetRollingFriction(0.01f);
+
+    std::vector<std::shared_ptr<ChBody>> balls;
+    for (int iy = 0; iy < num_layers; iy++) {
+        for (int ix = 0; ix < num_balls_x; ix++) {
+            for (int iz = 0; iz < num_balls_z; iz++) {
+                auto ball = std::shared_ptr<ChBody>(system.NewBody());
+                ball->SetIdentifier((int)balls.size() + 1);
+                ball->SetMass(mass);
+                ball->SetInertiaXX(0.4 * mass * radius * radius * ChVector<>(1, 1, 1));
+                ball->SetPos(ChVector<>(ix * 2.1 * radius + 0.01 * iy, radius + iy * 2.1 * radius, iz * 2.1 * radius));
+                ball->SetCollide(true);
+                ball->SetMaterialSurface((ix + iz) % 2 ? material : material_rolling);
+
+                ball->GetCollisionModel()->ClearModel();
+                ball->GetCollisionModel()->AddSphere(radius);
+                ball->GetCollisionModel()->BuildModel();
+
+                system.AddBody(ball);
+                balls.push_back(ball);
+            }
+        }
+    }
+
+    utils::CreateBoxContainer(&system, 0, material, ChVector<>(0.5, 0.5, 0.5), 0.1, ChVector<>(0.2, 0, 0.2),
+                              ChQuaternion<>(1, 0, 0, 0), true, true, false, false);
+
+    while (system.GetChTime() < end_time) {
+        system.DoStepDynamics(time_step);
+    }
+
+    system.GetContactContainer()->ReportAllContacts(&reporter);
+
+    positions.clear();
+    for (auto ball : balls)
+        positions.push_back(ball->GetPos());
+}
+
+int main(int argc, char* argv[]) {
+    std::vector<ChVector<>> pos_list;
+    std::vector<ChVector<>> pos_pool;
+    ContactReporter report_list;
+    ContactReporter report_pool;
+
+    run_simulation(false, pos_list, report_list);
+    run_simulation(true, pos_pool, report_pool);
+
+    GetLog() << "Contacts (list):   " << report_list.num_contacts << "  force: " << report_list.total_force << "\n";
+    GetLog() << "Contacts (pooled): " << report_pool.num_contacts << "  force: " << report_pool.total_force << "\n";
+
+    bool passed = report_list.num_contacts > 0;
+    passed &= report_list.num_contacts == report_pool.num_contacts;
+    passed &= report_list.total_force == report_pool.total_force;
+    for (size_t i = 0; i < pos_list.size(); i++)
+        passed &= pos_list[i] == pos_pool[i];
+
+    GetLog() << "Test " << (passed ? "PASSED" : "FAILED") << "\n";
+
+    // Return 0 if all tests passed.
+    return !passed;
+}
@@ -0,0 +1,131 @@
+// =============================================================================
+// PROJECT CHRONO - http://projectchrono.org
+//
+// Copyright (c) 2014 projectchrono.org
+// All rights reserved.
+//
+// Use of this source code is governed by a BSD-style license that can be found
+// in the LICENSE file at the top level of the distribution and at
+// http://projectchrono.org/license-chrono.txt.
+//
+// =============================================================================
+//
+// Test for ChSystemEnsemble. An ensemble of boxes sliding down ramps with
+// different friction coefficients is simulated with 1 and 4 threads: the
+// results must be identical, the messages of each run must be collected in its
+// run information, and the process-wide profiler must not record anything.
+//
+// =============================================================================
+
+#include <iostream>
+#include <vector>
+
+#include "chrono/physics/ChSystemEnsemble.h"
+#include "chrono/physics/ChSystemNSC.h"
+#include "chrono/utils/ChProfileRecorder.h"
+
+using namespace chrono;
+
+using std::cout;
+using std::endl;
+
+class RampRuns : public ChSystemEnsemble::RunCallback {
+  public:
+    RampRuns(int num_runs) : m_final_pos(num_runs), m_max_contacts(num_runs, 0) {}
+
+    virtual std::shared_ptr<ChSystem> CreateSystem(int index) override {
+        if (index == 5)
+            throw ChException("Invalid parameters");
+
+        auto system = std::make_shared<ChSystemNSC>();
+        auto material = std::make_shared<ChMaterialSurfaceNSC>();
+        material->SetFriction(0.05f + 0.05f * index);
+
+        auto ramp = std::make_shared<ChBody>();
+        ramp->SetBodyFixed(true);
+        ramp->SetRot(Q_from_AngZ(-0.4));
+        ramp->SetMaterialSurface(material);
+        ramp->GetCollisionModel()->ClearModel();
+        ramp->GetCollisionModel()->AddBox(5, 0.1, 1);
+        ramp->GetCollisionModel()->BuildModel();
+        ramp->SetCollide(true);
+        system->AddBody(ramp);
+
+        auto box = std::make_shared<ChBody>();
+        box->SetPos(ChVector<>(0, 0.35, 0));
+        box->SetRot(Q_from_AngZ(-0.4));
+        box->SetMaterialSurface(material);
+        box->GetCollisionModel()->ClearModel();
+        box->GetCollisionModel()->AddBox(0.25, 0.25, 0.25);
+        box->GetCollisionModel()->BuildModel();
+        box->SetCollide(true);
+        system->AddBody(box);
+
+        return system;
+    }
+
+    virtual bool OnStep(int index, ChSystem& system) override {
+        m_max_contacts[index] = std::max(m_max_contacts[index], system.GetNcontacts());
+        return true;
+    }
+
+    virtual void OnEnd(int index, ChSystem& system) override {
+        m_final_pos[index] = (*system.Get_bodylist())[1]->GetPos();
+        GetLog() << "run " << index << " done\n";
+    }
+
+    std::vector<ChVector<>> m_final_pos;
+    std::vector<int> m_max_contacts;
+};
+
+int main(int argc, char* argv[]) {
+    int num_runs = 12;
+    bool passed = true;
+
+    utils::ChProfileRecorder::Enable(true);
+    utils::ChProfileRecorder::Reset();
+
+    std::vector<RampRuns> results;
+    for (int nthreads : {1, 4}) {
+        RampRuns runs(num_runs);
+        ChSystemEnsemble ensemble(num_runs, &runs);
+        ensemble.SetNumThreads(nthreads);
+        ensemble.SetStepSize(0.005);
+        ensemble.SetEndTime(0.5);
+        int num_success = ensemble.Run();
+
+        passed &= (num_success == num_runs - 1);
+        for (int i = 0; i < num_runs; i++) {
+            const ChSystemEnsemble::RunInfo& run = ensemble.GetRunInfo(i);
+            if (i == 5) {
+                passed &= !run.success && run.error == "Invalid parameters" && run.num_steps == 0;
+                continue;
+            }
+            passed &= run.success && run.num_steps == 100 && !run.system;
+            passed &= (run.log == "run " + std::to_string(i) + " done\n");
+            passed &= runs.m_max_contacts[i] > 0;
+        }
+        results.push_back(runs);
+    }
+
+    // Results must not depend on the number of threads
+    for (int i = 0; i < num_runs; i++) {
+        if (!(results[0].m_final_pos[i] == results[1].m_final_pos[i])) {
+            cout << "Run " << i << ": different results with 1 and 4 threads" << endl;
+            passed = false;
+        }
+    }
+
+    // Higher friction, shorter sliding distance
+    cout << "Final x:  " << results[0].m_final_pos[0].x() << "  " << results[0].m_final_pos[11].x() << endl;
+    passed &= results[0].m_final_pos[0].x() > results[0].m_final_pos[11].x();
+
+    // Nothing recorded by the process-wide profiler
+    passed &= utils::ChProfileRecorder::GetSteps().empty();
+    utils::ChProfileRecorder::Enable(false);
+
+    cout << "Test " << (passed ? "PASSED" : "FAILED") << endl;
+
+    // Return 0 if all tests passed.
+    return !passed;
+}
@@ -0,0 +1,147 @@
+// =============================================================================
+// PROJECT CHRONO - http://projectchrono.org
+//
+// Copyright (c) 2014 projectchrono.org
+// All rights reserved.
+//
+// Use of this source code is governed by a BSD-style license that can be found
+// in the LICENSE file at the top level of the distribution and at
+// http://projectchrono.org/license-chrono.txt.
+//
+// =============================================================================
+//
+// Test for the incremental setup (ChSystem::SetUseIncrementalSetup). The same
+// model (a chain of pendulums above a box resting on the ground) is simulated
+// with and without incremental setup, while its topology is changed during the
+// simulation: a body is added, a contact container is added as an other physics
+// item, a link is disabled, a body is fixed and a body is removed. The results
+// must be identical.
+//
+// =============================================================================
+
+#include <iostream>
+#include <vector>
+
+#include "chrono/physics/ChContactContainerNSC.h"
+#include "chrono/physics/ChLinkLock.h"
+#include "chrono/physics/ChSystemNSC.h"
+
+using namespace chrono;
+
+using std::cout;
+using std::endl;
+
+struct Model {
+    ChSystemNSC system;
+    std::shared_ptr<ChBody> ground;
+    std::shared_ptr<ChBody> box;
+    std::vector<std::shared_ptr<ChBody>> links;
+    std::vector<std::shared_ptr<ChLinkLockRevolute>> joints;
+};
+
+std::shared_ptr<ChBody> CreateBox(ChSystem& system, const ChVector<>& pos, bool collide) {
+    auto body = std::make_shared<ChBody>();
+    body->SetPos(pos);
+    body->GetCollisionModel()->ClearModel();
+    body->GetCollisionModel()->AddBox(0.2, 0.2, 0.2);
+    body->GetCollisionModel()->BuildModel();
+    body->SetCollide(collide);
+    system.AddBody(body);
+    return body;
+}
+
+void CreateModel(Model& model, bool incremental) {
+    model.system.SetUseIncrementalSetup(incremental);
+
+    model.ground = std::make_shared<ChBody>();
+    model.ground->SetBodyFixed(true);
+    model.ground->GetCollisionModel()->ClearModel();
+    model.ground->GetCollisionModel()->AddBox(5, 0.1, 5, ChVector<>(0, -0.1, 0));
+    model.ground->GetCollisionModel()->BuildModel();
+    model.ground->SetCollide(true);
+    model.system.AddBody(model.ground);
+
+    model.box = CreateBox(model.system, ChVector<>(0, 0.19, 0), true);
+
+    std::shared_ptr<ChBody> prev = model.ground;
+    for (int i = 0; i < 5; i++) {
+        auto link = CreateBox(model.system, ChVector<>(0.5 + i, 3, 0), false);
+        auto joint = std::make_shared<ChLinkLockRevolute>();
+        joint->Initialize(link, prev, ChCoordsys<>(ChVector<>(i, 3, 0)));
+        model.system.AddLink(joint);
+        model.links.push_back(link);
+        model.joints.push_back(joint);
+        prev = link;
+    }
+}
+
+int main(int argc, char* argv[]) {
+    bool passed = true;
+
+    Model ref;
+    Model inc;
+    CreateModel(ref, false);
+    CreateModel(inc, true);
+
+    for (int step = 0; step < 400; step++) {
+        switch (step) {
+            case 100:
+                CreateBox(ref.system, ChVector<>(0.1, 1, 0), true);
+                CreateBox(inc.system, ChVector<>(0.1, 1, 0), true);
+                break;
+            case 150:
+                // Filled with the same contacts as the system contact container at each step
+                ref.system.AddOtherPhysicsItem(std::make_shared<ChContactContainerNSC>());
+                inc.system.AddOtherPhysicsItem(std::make_shared<ChContactContainerNSC>());
+                break;
+            case 200:
+                ref.joints[4]->SetDisabled(true);
+                inc.joints[4]->SetDisabled(true);
+                break;
+            case 250:
+                ref.links[1]->SetBodyFixed(true);
+                inc.links[1]->SetBodyFixed(true);
+                break;
+            case 300:
+                ref.system.RemoveLink(ref.joints[3]);
+                inc.system.RemoveLink(inc.joints[3]);
+                ref.system.RemoveBody(ref.links[4]);
+                inc.system.RemoveBody(inc.links[4]);
+                break;
+        }
+
+        ref.system.DoStepDynamics(1e-3);
+        inc.system.DoStepDynamics(1e-3);
+
+        if (ref.system.GetNcoords_w() != inc.system.GetNcoords_w() ||
+            ref.system.GetNdoc_w() != inc.system.GetNdoc_w() ||
+            ref.system.GetNcontacts() != inc.system.GetNcontacts()) {
+            cout << "Step " << step << ": different counts" << endl;
+            passed = false;
+            break;
+        }
+
+        const auto& bodies_ref = *ref.system.Get_bodylist();
+        const auto& bodies_inc = *inc.system.Get_bodylist();
+        for (size_t i = 0; i < bodies_ref.size(); i++) {
+            if (!(bodies_ref[i]->GetPos() == bodies_inc[i]->GetPos()) ||
+                !(bodies_ref[i]->GetPos_dt() == bodies_inc[i]->GetPos_dt())) {
+                cout << "Step " << step << ": different states for body " << i << endl;
+                passed = false;
+                break;
+            }
+        }
+        if (!passed)
+            break;
+    }
+
+    // The box rests on the ground, and the chain is still moving
+    cout << "Contacts: " << inc.system.GetNcontacts() << "  Constraints: " << inc.system.GetNdoc_w() << endl;
+    passed &= inc.system.GetNcontacts() > 0;
+    passed &= inc.links[0]->GetPos_dt().Length() > 0;
+
+    cout << "Test " << (passed ? "PASSED" : "FAILED") << endl;
+
+    // Return 0 if all tests passed.
+    return !passed;
+}
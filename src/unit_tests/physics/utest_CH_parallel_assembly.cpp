@@ -0,0 +1,109 @@
+// =============================================================================
+// PROJECT CHRONO - http://projectchrono.org
+//
+// Copyright (c) 2014 projectchrono.org
+// All rights reserved.
+//
+// Use of this source code is governed by a BSD-style license that can be found
+// in the LICENSE file at the top level of the distribution and at
+// http://projectchrono.org/license-chrono.txt.
+//
+// =============================================================================
+//
+// Test for the multithreaded assembly update (ChAssembly::SetUseParallelUpdate).
+// A set of pendulum chains is simulated serially and with 4 threads, with the
+// Euler implicit linearized and the HHT integrators. Some of the bodies and links
+// opt out of the parallel update. The results must be identical.
+//
+// =============================================================================
+
+#include <iostream>
+#include <vector>
+
+#include "chrono/physics/ChLinkLock.h"
+#include "chrono/physics/ChSystemNSC.h"
+#include "chrono/timestepper/ChTimestepperHHT.h"
+
+using namespace chrono;
+
+using std::cout;
+using std::endl;
+
+// Create the pendulum chains, simulate, and return the final states of all bodies.
+std::vector<ChVector<>> Simulate(ChTimestepper::Type integrator, bool parallel, int num_steps) {
+    ChSystemNSC system;
+    system.SetParallelThreadNumber(parallel ? 4 : 1);
+    system.SetUseParallelUpdate(parallel);
+    system.SetTimestepperType(integrator);
+    if (integrator == ChTimestepper::Type::HHT) {
+        auto hht = std::static_pointer_cast<ChTimestepperHHT>(system.GetTimestepper());
+        hht->SetAlpha(-0.2);
+        hht->SetMaxiters(20);
+        hht->SetAbsTolerances(1e-6);
+    }
+
+    auto ground = std::make_shared<ChBody>();
+    ground->SetBodyFixed(true);
+    system.AddBody(ground);
+
+    for (int ic = 0; ic < 6; ic++) {
+        std::shared_ptr<ChBody> prev = ground;
+        for (int i = 0; i < 6; i++) {
+            auto body = std::make_shared<ChBody>();
+            body->SetPos(ChVector<>(0.5 + i, 0, ic));
+            body->SetBodyFixed(false);
+            body->SetAllowParallelUpdate(i % 3 != 0);
+            system.AddBody(body);
+
+            auto joint = std::make_shared<ChLinkLockRevolute>();
+            joint->Initialize(body, prev, ChCoordsys<>(ChVector<>(i, 0, ic)));
+            joint->SetAllowParallelUpdate(i % 4 != 0);
+            system.AddLink(joint);
+
+            prev = body;
+        }
+    }
+
+    for (int step = 0; step < num_steps; step++)
+        system.DoStepDynamics(1e-3);
+
+    std::vector<ChVector<>> state;
+    for (auto body : *system.Get_bodylist()) {
+        state.push_back(body->GetPos());
+        state.push_back(body->GetPos_dt());
+        state.push_back(body->GetWvel_par());
+    }
+    return state;
+}
+
+bool Compare(const std::string& name, const std::vector<ChVector<>>& a, const std::vector<ChVector<>>& b) {
+    for (size_t i = 0; i < a.size(); i++) {
+        if (!(a[i] == b[i])) {
+            cout << name << ": different results with serial and parallel update (body " << i / 3 << ")" << endl;
+            return false;
+        }
+    }
+    // The chains must have moved
+    if (a[4].Length() == 0) {
+        cout << name << ": chains did not move" << endl;
+        return false;
+    }
+    return true;
+}
+
+int main(int argc, char* argv[]) {
+    bool passed = true;
+
+    auto euler_ser = Simulate(ChTimestepper::Type::EULER_IMPLICIT_LINEARIZED, false, 100);
+    auto euler_par = Simulate(ChTimestepper::Type::EULER_IMPLICIT_LINEARIZED, true, 100);
+    passed &= Compare("Euler", euler_ser, euler_par);
+
+    auto hht_ser = Simulate(ChTimestepper::Type::HHT, false, 20);
+    auto hht_par = Simulate(ChTimestepper::Type::HHT, true, 20);
+    passed &= Compare("HHT", hht_ser, hht_par);
+
+    cout << "Test " << (passed ? "PASSED" : "FAILED") << endl;
+
+    // Return 0 if all tests passed.
+    return !passed;
+}
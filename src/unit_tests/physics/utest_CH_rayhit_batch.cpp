@@ -0,0 +1,158 @@
+// =============================================================================
+// PROJECT CHRONO - http://projectchrono.org
+//
+// Copyright (c) 2014 projectchrono.org
+// All rights reserved.
+//
+// Use of this source code is governed by a BSD-style license that can be found
+// in the LICENSE file at the top level of the distribution and at
+// http://projectchrono.org/license-chrono.txt.
+//
+// =============================================================================
+//
+// Test for batched ray-hit queries (ChCollisionSystem::RayHitBatch).
+// A grid of vertical rays is cast on a small triangle mesh (a pyramid), a box,
+// a sphere and a smaller sphere above the pyramid, in batches processed with one
+// and with several threads. The results must be the same as those of individual
+// RayHit queries. The test is run with a static mesh, and with a moving (GIMPACT)
+// mesh and a connected mesh (compound of triangle shapes), which are only tested
+// sequentially, by the rays that cross their bounding box.
+//
+// =============================================================================
+
+#include <iostream>
+#include <string>
+#include <vector>
+
+#include "chrono/collision/ChCCollisionSystem.h"
+#include "chrono/geometry/ChTriangleMeshConnected.h"
+#include "chrono/geometry/ChTriangleMeshSoup.h"
+#include "chrono/physics/ChBodyEasy.h"
+#include "chrono/physics/ChSystemNSC.h"
+
+using namespace chrono;
+using namespace chrono::collision;
+using namespace chrono::geometry;
+
+using std::cout;
+using std::endl;
+
+const int grid_size = 25;
+
+enum class MeshType { STATIC, MOVING, CONNECTED };
+
+bool SameResult(const ChCollisionSystem::ChRayhitResult& a, const ChCollisionSystem::ChRayhitResult& b) {
+    if (a.hit != b.hit)
+        return false;
+    if (!a.hit)
+        return true;
+    return a.hitModel == b.hitModel && a.abs_hitPoint == b.abs_hitPoint && a.abs_hitNormal == b.abs_hitNormal &&
+           a.dist_factor == b.dist_factor;
+}
+
+bool Run(MeshType mesh_type, const std::string& name) {
+    ChSystemNSC system;
+
+    // Pyramid with a square base of side 1 and unit height, centered at (-0.75, 0, 0)
+    ChTriangleMeshSoup soup;
+    ChTriangleMeshConnected connected;
+    ChTriangleMesh* pyramid = (mesh_type == MeshType::CONNECTED) ? static_cast<ChTriangleMesh*>(&connected) : &soup;
+    ChVector<> apex(0, 0, 1);
+    ChVector<> base[4] = {ChVector<>(-0.5, -0.5, 0), ChVector<>(0.5, -0.5, 0), ChVector<>(0.5, 0.5, 0),
+                          ChVector<>(-0.5, 0.5, 0)};
+    for (int i = 0; i < 4; i++)
+        pyramid->addTriangle(base[i], base[(i + 1) % 4], apex);
+
+    auto mesh_body = std::make_shared<ChBody>();
+    mesh_body->SetPos(ChVector<>(-0.75, 0, 0));
+    mesh_body->SetBodyFixed(true);
+    mesh_body->GetCollisionModel()->ClearModel();
+    mesh_body->GetCollisionModel()->AddTriangleMesh(*pyramid, mesh_type == MeshType::STATIC, false);
+    mesh_body->GetCollisionModel()->BuildModel();
+    mesh_body->SetCollide(true);
+    system.AddBody(mesh_body);
+
+    auto box = std::make_shared<ChBodyEasyBox>(0.5, 0.5, 0.5, 1000, true);
+    box->SetPos(ChVector<>(0.6, -0.5, 0.25));
+    box->SetBodyFixed(true);
+    system.AddBody(box);
+
+    auto sphere = std::make_shared<ChBodyEasySphere>(0.3, 1000, true);
+    sphere->SetPos(ChVector<>(0.6, 0.5, 0.3));
+    sphere->SetBodyFixed(true);
+    system.AddBody(sphere);
+
+    auto ball = std::make_shared<ChBodyEasySphere>(0.2, 1000, true);
+    ball->SetPos(ChVector<>(-0.75, 0, 1.5));
+    ball->SetBodyFixed(true);
+    system.AddBody(ball);
+
+    // Update the collision models
+    system.DoStepDynamics(1e-3);
+
+    std::vector<ChVector<>> from;
+    std::vector<ChVector<>> to;
+    for (int ix = 0; ix < grid_size; ix++) {
+        for (int iy = 0; iy < grid_size; iy++) {
+            double x = -1.5 + 3.0 * ix / (grid_size - 1);
+            double y = -1.0 + 2.0 * iy / (grid_size - 1);
+            from.push_back(ChVector<>(x, y, 2));
+            to.push_back(ChVector<>(x, y, -1));
+        }
+    }
+
+    const ChCollisionSystem* collision_system = system.GetCollisionSystem().get();
+
+    std::vector<ChCollisionSystem::ChRayhitResult> expected(from.size());
+    int expected_hits = 0;
+    for (size_t i = 0; i < from.size(); i++) {
+        if (collision_system->RayHit(from[i], to[i], expected[i]))
+            expected_hits++;
+    }
+
+    bool passed = true;
+    for (int nthreads : {1, 4}) {
+        std::vector<ChCollisionSystem::ChRayhitResult> results;
+        int hits = collision_system->RayHitBatch(from, to, results, nthreads);
+        cout << name << " mesh, " << nthreads << " threads: " << hits << " hits (" << expected_hits << " expected)"
+             << endl;
+
+        if (hits != expected_hits || results.size() != from.size()) {
+            cout << "   wrong number of hits or results" << endl;
+            passed = false;
+            continue;
+        }
+        for (size_t i = 0; i < from.size(); i++) {
+            if (!SameResult(results[i], expected[i])) {
+                cout << "   different result for ray " << i << endl;
+                passed = false;
+                break;
+            }
+        }
+    }
+
+    // Every object is hit by some ray
+    for (auto body : *system.Get_bodylist()) {
+        bool hit = false;
+        for (auto& result : expected)
+            hit |= result.hit && result.hitModel == body->GetCollisionModel().get();
+        if (!hit) {
+            cout << "   no hits on body " << body->GetId() << endl;
+            passed = false;
+        }
+    }
+
+    return passed;
+}
+
+int main(int argc, char* argv[]) {
+    bool passed = true;
+    passed &= Run(MeshType::STATIC, "static");
+    passed &= Run(MeshType::MOVING, "moving");
+    passed &= Run(MeshType::CONNECTED, "connected");
+
+    cout << "Test " << (passed ? "PASSED" : "FAILED") << endl;
+
+    // Return 0 if all tests passed.
+    return !passed;
+}
@@ -0,0 +1,132 @@
+// =============================================================================
+// PROJECT CHRONO - http://projectchrono.org
+//
+// Copyright (c) 2014 projectchrono.org
+// All rights reserved.
+//
+// Use of this source code is governed by a BSD-style license that can be found
+// in the LICENSE file at the top level of the distribution and at
+// http://projectchrono.org/license-chrono.txt.
+//
+// =============================================================================
+//
+// Test for island-based sleeping. A stack of boxes and a separate box rest on a
+// fixed ground: they form two islands (the ground does not connect them), which
+// fall asleep. Waking up the separate box must not wake the stack; a ball
+// dropped on the stack must wake the whole stack. Contacts between two fixed
+// bodies must still be reported to the narrow phase callback.
+//
+// =============================================================================
+
+#include <iostream>
+#include <vector>
+
+#include "chrono/physics/ChSystemNSC.h"
+
+using namespace chrono;
+
+using std::cout;
+using std::endl;
+
+std::shared_ptr<ChBody> AddBox(ChSystemNSC& system, const ChVector<>& pos, const ChVector<>& hdim, bool fixed) {
+    auto body = std::make_shared<ChBody>();
+    body->SetPos(pos);
+    body->SetBodyFixed(fixed);
+    body->GetCollisionModel()->ClearModel();
+    body->GetCollisionModel()->AddBox(hdim.x(), hdim.y(), hdim.z());
+    body->GetCollisionModel()->BuildModel();
+    body->SetCollide(true);
+    body->SetUseSleeping(true);
+    body->SetSleepTime(0.1f);
+    system.AddBody(body);
+    return body;
+}
+
+bool AllSleeping(const std::vector<std::shared_ptr<ChBody>>& bodies) {
+    for (auto& body : bodies) {
+        if (!body->GetSleeping())
+            return false;
+    }
+    return true;
+}
+
+bool AnySleeping(const std::vector<std::shared_ptr<ChBody>>& bodies) {
+    for (auto& body : bodies) {
+        if (body->GetSleeping())
+            return true;
+    }
+    return false;
+}
+
+// Count the narrow phase contacts between two fixed bodies
+class FixedPairCounter : public collision::ChCollisionSystem::NarrowphaseCallback {
+  public:
+    FixedPairCounter() : count(0) {}
+    virtual void OnNarrowphase(collision::ChCollisionInfo& contactinfo) override {
+        auto bodyA = dynamic_cast<ChBody*>(contactinfo.modelA->GetContactable());
+        auto bodyB = dynamic_cast<ChBody*>(contactinfo.modelB->GetContactable());
+        if (bodyA && bodyB && bodyA->GetBodyFixed() && bodyB->GetBodyFixed())
+            count++;
+    }
+    int count;
+};
+
+int main(int argc, char* argv[]) {
+    ChSystemNSC system;
+    system.SetUseSleeping(true);
+    double step = 0.005;
+
+    AddBox(system, ChVector<>(0, -0.5, 0), ChVector<>(10, 0.5, 10), true);
+    AddBox(system, ChVector<>(-5, 0, 0), ChVector<>(0.5, 0.5, 0.5), true);
+
+    FixedPairCounter counter;
+    system.GetCollisionSystem()->RegisterNarrowphaseCallback(&counter);
+
+    std::vector<std::shared_ptr<ChBody>> stack;
+    for (int i = 0; i < 3; i++)
+        stack.push_back(AddBox(system, ChVector<>(0, 0.25 + 0.5 * i, 0), ChVector<>(0.25, 0.25, 0.25), false));
+    auto single = AddBox(system, ChVector<>(3, 0.25, 0), ChVector<>(0.25, 0.25, 0.25), false);
+
+    bool passed = true;
+
+    // Let the bodies come to rest and fall asleep
+    while (system.GetChTime() < 2)
+        system.DoStepDynamics(step);
+
+    cout << "Islands: " << system.GetNislands() << "  sleeping: " << system.GetNislandsSleeping() << endl;
+    passed &= system.GetNislands() == 2 && system.GetNislandsSleeping() == 2;
+    passed &= AllSleeping(stack) && single->GetSleeping();
+
+    cout << "Fixed-fixed narrow phase contacts: " << counter.count << endl;
+    passed &= counter.count > 0;
+
+    // Wake up the separate box: the stack must stay asleep
+    single->SetSleeping(false);
+    single->SetPos_dt(ChVector<>(0, 1, 0));
+    system.DoStepDynamics(step);
+    cout << "Separate box awake, stack sleeping: " << !single->GetSleeping() << " " << AllSleeping(stack) << endl;
+    passed &= !single->GetSleeping() && AllSleeping(stack);
+
+    // Throw a ball on the stack: the whole stack must wake up
+    auto ball = std::make_shared<ChBody>();
+    ball->SetPos(ChVector<>(0, 2, 0));
+    ball->SetPos_dt(ChVector<>(0, -2, 0));
+    ball->GetCollisionModel()->ClearModel();
+    ball->GetCollisionModel()->AddSphere(0.2);
+    ball->GetCollisionModel()->BuildModel();
+    ball->SetCollide(true);
+    system.AddBody(ball);
+
+    bool stack_woken = false;
+    for (int i = 0; i < 200 && !stack_woken; i++) {
+        system.DoStepDynamics(step);
+        stack_woken = !AnySleeping(stack);
+    }
+    cout << "Stack woken up: " << stack_woken << endl;
+    passed &= stack_woken;
+
+    cout << "Test " << (passed ? "PASSED" : "FAILED") << endl;
+
+    // Return 0 if all tests passed.
+    return !passed;
+}
@@ -0,0 +1,129 @@
+// =============================================================================
+// PROJECT CHRONO - http://projectchrono.org
+//
+// Copyright (c) 2014 projectchrono.org
+// All rights reserved.
+//
+// Use of this source code is governed by a BSD-style license that can be found
+// in the LICENSE file at the top level of the distribution and at
+// http://projectchrono.org/license-chrono.txt.
+//
+// =============================================================================
+//
+// Unit test for the graph-colored SOR solver (ChSolverSORcolored).
+// A layer of balls settles on a fixed box. The test checks that:
+// - the total contact force on the box balances the weight of the balls;
+// - the results are bitwise identical when using 1 or 4 threads.
+//
+// =============================================================================
+
+#include <vector>
+
+#include "chrono/physics/ChSystemNSC.h"
+#include "chrono/solver/ChSolverSORcolored.h"
+#include "chrono/utils/ChUtilsCreators.h"
+
+using namespace chrono;
+
+double end_time = 1.0;     // total simulation time
+double start_time = 0.5;   // start check after this period
+double time_step = 5e-3;   // integration step size
+double gravity = -9.81;    // gravitational acceleration
+double rtol = 1e-3;        // validation relative error
+
+int num_balls_x = 6;
+int num_balls_z = 6;
+double radius = 0.05;
+double mass = 5;
+
+// Run the simulation with the given number of threads and return the final ball positions.
+bool run_simulation(int nthreads, std::vector<ChVector<>>& positions) {
+    ChSystemNSC system;
+    system.Set_G_acc(ChVector<>(0, gravity, 0));
+    system.SetParallelThreadNumber(nthreads);
+    system.SetSolverType(ChSolver::Type::SOR_COLORED);
+    system.SetMaxItersSolverSpeed(100);
+    system.SetTolForce(1e-6);
+
+    auto material = std::make_shared<ChMaterialSurfaceNSC>();
+    material->SetFriction(0.4f);
+
+    std::vector<std::shared_ptr<ChBody>> balls;
+    double total_weight = 0;
+
+    for (int ix = 0; ix < num_balls_x; ix++) {
+        for (int iz = 0; iz < num_balls_z; iz++) {
+            auto ball = std::shared_ptr<ChBody>(system.NewBody());
+            ball->SetIdentifier((int)balls.size() + 1);
+            ball->SetMass(mass);
+            ball->SetInertiaXX(0.4 * mass * radius * radius * ChVector<>(1, 1, 1));
+            ball->SetPos(ChVector<>(ix * 2.01 * radius, radius + 0.01, iz * 2.01 * radius));
+            ball->SetCollide(true);
+            ball->SetMaterialSurface(material);
+
+            ball->GetCollisionModel()->ClearModel();
+            ball->GetCollisionModel()->AddSphere(radius);
+            ball->GetCollisionModel()->BuildModel();
+
+            system.AddBody(ball);
+            balls.push_back(ball);
+            total_weight += mass * gravity;
+        }
+    }
+
+    auto ground = utils::CreateBoxContainer(&system, 0, material, ChVector<>(2, 2, 2 * radius), 0.1, ChVector<>(0, 0, 0),
+                                            ChQuaternion<>(1, 0, 0, 0), true, true, false, false);
+
+    bool passed = true;
+    while (system.GetChTime() < end_time) {
+        system.DoStepDynamics(time_step);
+
+        if (system.GetChTime() > start_time) {
+            system.GetContactContainer()->ComputeContactForces();
+            ChVector<> contact_force = ground->GetContactForce();
+            if (std::abs(1 - contact_force.y() / total_weight) > rtol) {
+                GetLog() << "t = " << system.GetChTime() << "  force =  " << contact_force.y() << "\n";
+                passed = false;
+                break;
+            }
+        }
+    }
+
+    auto solver = std::static_pointer_cast<ChSolverSORcolored>(system.GetSolver());
+    GetLog() << "Threads: " << nthreads << "  colors: " << solver->GetNumColors() << "\n";
+
+    positions.clear();
+    for (auto ball : balls)
+        positions.push_back(ball->GetPos());
+
+    return passed;
+}
+
+int main(int argc, char* argv[]) {
+    std::vector<ChVector<>> pos1;
+    std::vector<ChVector<>> pos4;
+
+    bool passed = true;
+
+    ChSolverSORcolored solver;
+    if (solver.GetNumColors() != 0) {
+        GetLog() << "Colors reported before the first solve\n";
+        passed = false;
+    }
+
+    passed &= run_simulation(1, pos1);
+    passed &= run_simulation(4, pos4);
+
+    for (size_t i = 0; i < pos1.size(); i++) {
+        if (!(pos1[i] == pos4[i])) {
+            GetLog() << "Ball " << (int)i << ": results depend on the number of threads\n";
+            passed = false;
+            break;
+        }
+    }
+
+    GetLog() << "Test " << (passed ? "PASSED" : "FAILED") << "\n";
+
+    // Return 0 if all tests passed.
+    return !passed;
+}
@@ -0,0 +1,136 @@
+// =============================================================================
+// PROJECT CHRONO - http://projectchrono.org
+//
+// Copyright (c) 2014 projectchrono.org
+// All rights reserved.
+//
+// Use of this source code is governed by a BSD-style license that can be found
+// in the LICENSE file at the top level of the distribution and at
+// http://projectchrono.org/license-chrono.txt.
+//
+// =============================================================================
+//
+// Test for the binary state checkpoint (WriteStateCheckpoint/ReadStateCheckpoint).
+//
+// A double pendulum and a free body are simulated; the state is saved halfway
+// through the simulation and loaded in a second copy of the model. The test
+// checks that the continuation of the simulation is identical.
+//
+// =============================================================================
+
+#include <cstdio>
+#include <iostream>
+
+#include "chrono/physics/ChLinkLock.h"
+#include "chrono/physics/ChSystemNSC.h"
+#include "chrono/utils/ChUtilsInputOutput.h"
+
+using namespace chrono;
+
+using std::cout;
+using std::endl;
+
+const double step = 1e-3;
+const int num_steps = 500;
+
+// Create the model (two pendulum links, a free body, and a fixed body)
+void CreateModel(ChSystemNSC& system, bool extra_body) {
+    system.Set_G_acc(ChVector<>(0, -9.81, 0));
+
+    auto ground = std::make_shared<ChBody>();
+    ground->SetIdentifier(-1);
+    ground->SetBodyFixed(true);
+    system.AddBody(ground);
+
+    auto pend1 = std::make_shared<ChBody>();
+    pend1->SetIdentifier(1);
+    pend1->SetPos(ChVector<>(1, 0, 0));
+    system.AddBody(pend1);
+
+    auto pend2 = std::make_shared<ChBody>();
+    pend2->SetIdentifier(2);
+    pend2->SetPos(ChVector<>(3, 0, 0));
+    system.AddBody(pend2);
+
+    auto free = std::make_shared<ChBody>();
+    free->SetIdentifier(3);
+    free->SetPos(ChVector<>(0, 5, 0));
+    free->SetWvel_loc(ChVector<>(1, 2, 3));
+    system.AddBody(free);
+
+    if (extra_body) {
+        auto extra = std::make_shared<ChBody>();
+        extra->SetIdentifier(4);
+        system.AddBody(extra);
+    }
+
+    auto rev1 = std::make_shared<ChLinkLockRevolute>();
+    rev1->SetIdentifier(1);
+    rev1->Initialize(ground, pend1, ChCoordsys<>(ChVector<>(0, 0, 0)));
+    system.AddLink(rev1);
+
+    auto rev2 = std::make_shared<ChLinkLockRevolute>();
+    rev2->SetIdentifier(2);
+    rev2->Initialize(pend1, pend2, ChCoordsys<>(ChVector<>(2, 0, 0)));
+    system.AddLink(rev2);
+}
+
+int main(int argc, char* argv[]) {
+    std::string filename = "state_checkpoint.dat";
+
+    // Reference simulation, with checkpoint halfway
+    ChSystemNSC system1;
+    CreateModel(system1, false);
+    for (int i = 0; i < num_steps; i++) {
+        if (i == num_steps / 2 && !utils::WriteStateCheckpoint(&system1, filename)) {
+            cout << "Cannot write checkpoint" << endl;
+            return 1;
+        }
+        system1.DoStepDynamics(step);
+    }
+
+    // A different model cannot load the checkpoint
+    ChSystemNSC system_other;
+    CreateModel(system_other, true);
+    bool passed = true;
+    if (utils::ReadStateCheckpoint(&system_other, filename)) {
+        cout << "Checkpoint loaded in a different model" << endl;
+        passed = false;
+    }
+
+    // Restart from the checkpoint
+    ChSystemNSC system2;
+    CreateModel(system2, false);
+    if (!utils::ReadStateCheckpoint(&system2, filename)) {
+        cout << "Cannot read checkpoint" << endl;
+        return 1;
+    }
+    for (int i = num_steps / 2; i < num_steps; i++)
+        system2.DoStepDynamics(step);
+
+    std::remove(filename.c_str());
+
+    cout << "Time: " << system1.GetChTime() << "  " << system2.GetChTime() << endl;
+    if (system1.GetChTime() != system2.GetChTime())
+        passed = false;
+
+    auto& bodies1 = *system1.Get_bodylist();
+    auto& bodies2 = *system2.Get_bodylist();
+    for (size_t i = 0; i < bodies1.size(); i++) {
+        bool identical = bodies1[i]->GetCoord() == bodies2[i]->GetCoord() &&
+                         bodies1[i]->GetCoord_dt() == bodies2[i]->GetCoord_dt();
+        cout << "Body " << bodies1[i]->GetIdentifier() << "  pos: " << bodies1[i]->GetPos().x() << " "
+             << bodies1[i]->GetPos().y() << "  " << (identical ? "identical" : "DIFFERENT") << endl;
+        passed &= identical;
+    }
+
+    auto& links1 = *system1.Get_linklist();
+    auto& links2 = *system2.Get_linklist();
+    for (size_t i = 0; i < links1.size(); i++)
+        passed &= links1[i]->Get_react_force() == links2[i]->Get_react_force();
+
+    cout << "Test " << (passed ? "PASSED" : "FAILED") << endl;
+
+    // Return 0 if all tests passed.
+    return !passed;
+}
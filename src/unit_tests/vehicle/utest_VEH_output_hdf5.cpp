@@ -0,0 +1,236 @@
+// =============================================================================
+// PROJECT CHRONO - http://projectchrono.org
+//
+// Copyright (c) 2014 projectchrono.org
+// All rights reserved.
+//
+// Use of this source code is governed by a BSD-style license that can be found
+// in the LICENSE file at the top level of the distribution and at
+// http://projectchrono.org/license-chrono.txt.
+//
+// =============================================================================
+//
+// Test for the HDF5 vehicle output database.
+// A TIME_SERIES database (written by its background thread) and a FRAMES
+// database are filled concurrently from two threads. The files are then read
+// back: the time series must have one row per frame (datasets are extended by
+// whole chunks and trimmed on close), a component type first written at a later
+// frame must start with fill rows, and the FRAMES file must hold the same data.
+//
+// =============================================================================
+
+#include <cmath>
+#include <cstdio>
+#include <iostream>
+#include <thread>
+#include <vector>
+
+#include "chrono/physics/ChBody.h"
+#include "chrono/physics/ChShaft.h"
+
+#include "chrono_vehicle/output/ChVehicleOutputHDF5.h"
+
+using namespace chrono;
+using namespace chrono::vehicle;
+
+using std::cout;
+using std::endl;
+
+const int num_frames = 10;
+const int shaft_frame = 5;  // first frame with shaft output
+
+struct body_record {
+    int id;
+    double x, y, z;
+};
+
+struct shaft_record {
+    int id;
+    double x;
+};
+
+struct time_record {
+    int frame;
+    double time;
+};
+
+void SetState(int frame, std::vector<std::shared_ptr<ChBody>>& bodies, std::vector<std::shared_ptr<ChShaft>>& shafts) {
+    for (int i = 0; i < bodies.size(); i++)
+        bodies[i]->SetPos(ChVector<>(frame, i, 0.5 * frame * i));
+    shafts[0]->SetPos(0.1 * frame);
+}
+
+void WriteFrame(ChVehicleOutput& db,
+                int frame,
+                const std::vector<std::shared_ptr<ChBody>>& bodies,
+                const std::vector<std::shared_ptr<ChShaft>>& shafts) {
+    db.WriteTime(frame, 0.01 * frame);
+    db.WriteSection("chassis");
+    db.WriteBodies(bodies);
+    if (frame >= shaft_frame)
+        db.WriteShafts(shafts);
+}
+
+// Write all frames, with a separate set of bodies for each database (positions are set while writing).
+void WriteDatabase(ChVehicleOutputHDF5::Layout layout, const std::string& filename) {
+    std::vector<std::shared_ptr<ChBody>> bodies;
+    for (int i = 0; i < 3; i++) {
+        bodies.push_back(std::make_shared<ChBody>());
+        bodies.back()->SetIdentifier(10 + i);
+    }
+    std::vector<std::shared_ptr<ChShaft>> shafts(1, std::make_shared<ChShaft>());
+    shafts[0]->SetIdentifier(20);
+
+    ChVehicleOutputHDF5 db(filename, layout, 1, 4);
+    for (int frame = 0; frame < num_frames; frame++) {
+        SetState(frame, bodies, shafts);
+        WriteFrame(db, frame, bodies, shafts);
+    }
+}
+
+H5::CompType BodyType() {
+    H5::CompType type(sizeof(body_record));
+    type.insertMember("id", HOFFSET(body_record, id), H5::PredType::NATIVE_INT);
+    type.insertMember("x", HOFFSET(body_record, x), H5::PredType::NATIVE_DOUBLE);
+    type.insertMember("y", HOFFSET(body_record, y), H5::PredType::NATIVE_DOUBLE);
+    type.insertMember("z", HOFFSET(body_record, z), H5::PredType::NATIVE_DOUBLE);
+    return type;
+}
+
+H5::CompType ShaftType() {
+    H5::CompType type(sizeof(shaft_record));
+    type.insertMember("id", HOFFSET(shaft_record, id), H5::PredType::NATIVE_INT);
+    type.insertMember("x", HOFFSET(shaft_record, x), H5::PredType::NATIVE_DOUBLE);
+    return type;
+}
+
+H5::CompType TimeType() {
+    H5::CompType type(sizeof(time_record));
+    type.insertMember("frame", HOFFSET(time_record, frame), H5::PredType::NATIVE_INT);
+    type.insertMember("time", HOFFSET(time_record, time), H5::PredType::NATIVE_DOUBLE);
+    return type;
+}
+
+// Read a whole dataset and check its dimensions.
+template <typename T>
+bool ReadSet(H5::H5File& file, const std::string& name, const H5::DataType& type, hsize_t rows, hsize_t cols,
+             std::vector<T>& data) {
+    H5::DataSet set = file.openDataSet(name);
+    hsize_t dims[2] = {0, 1};
+    int rank = set.getSpace().getSimpleExtentDims(dims);
+    if (dims[0] != rows || (rank == 2 && dims[1] != cols)) {
+        cout << name << ": " << dims[0] << " x " << dims[1] << " instead of " << rows << " x " << cols << endl;
+        return false;
+    }
+    data.resize(rows * cols);
+    set.read(data.data(), type);
+    return true;
+}
+
+bool CheckBody(const body_record& rec, int frame, int i) {
+    if (rec.id == 10 + i && rec.x == frame && rec.y == i && rec.z == 0.5 * frame * i)
+        return true;
+    cout << "body " << i << " at frame " << frame << ": id " << rec.id << "  pos (" << rec.x << ", " << rec.y
+         << ", " << rec.z << ")" << endl;
+    return false;
+}
+
+bool CheckSeries(const std::string& filename) {
+    H5::H5File file(filename, H5F_ACC_RDONLY);
+    bool passed = true;
+
+    std::vector<time_record> time;
+    if (ReadSet(file, "/Time", TimeType(), num_frames, 1, time)) {
+        for (int frame = 0; frame < num_frames; frame++)
+            passed &= time[frame].frame == frame && time[frame].time == 0.01 * frame;
+    } else {
+        passed = false;
+    }
+
+    std::vector<int> frames;
+    if (ReadSet(file, "/Sections/chassis/Frames", H5::PredType::NATIVE_INT, num_frames, 1, frames)) {
+        for (int frame = 0; frame < num_frames; frame++)
+            passed &= frames[frame] == frame;
+    } else {
+        passed = false;
+    }
+
+    std::vector<body_record> bodies;
+    if (ReadSet(file, "/Sections/chassis/Bodies", BodyType(), num_frames, 3, bodies)) {
+        for (int frame = 0; frame < num_frames; frame++)
+            for (int i = 0; i < 3; i++)
+                passed &= CheckBody(bodies[3 * frame + i], frame, i);
+    } else {
+        passed = false;
+    }
+
+    // Shafts are only written from shaft_frame on: the first rows hold fill values
+    std::vector<shaft_record> shafts;
+    if (ReadSet(file, "/Sections/chassis/Shafts", ShaftType(), num_frames, 1, shafts)) {
+        for (int frame = 0; frame < num_frames; frame++) {
+            bool ok = frame < shaft_frame ? (shafts[frame].id == 0 && shafts[frame].x == 0)
+                                          : (shafts[frame].id == 20 && shafts[frame].x == 0.1 * frame);
+            if (!ok)
+                cout << "shaft at frame " << frame << ": id " << shafts[frame].id << "  x " << shafts[frame].x << endl;
+            passed &= ok;
+        }
+    } else {
+        passed = false;
+    }
+
+    return passed;
+}
+
+bool CheckFrames(const std::string& filename) {
+    H5::H5File file(filename, H5F_ACC_RDONLY);
+    bool passed = true;
+
+    for (int frame = 0; frame < num_frames; frame++) {
+        char group[64];
+        sprintf(group, "/Frames/Frame_%06d/chassis/", frame);
+        std::vector<body_record> bodies;
+        if (ReadSet(file, std::string(group) + "Bodies", BodyType(), 3, 1, bodies)) {
+            for (int i = 0; i < 3; i++)
+                passed &= CheckBody(bodies[i], frame, i);
+        } else {
+            passed = false;
+        }
+        if (frame >= shaft_frame) {
+            std::vector<shaft_record> shafts;
+            passed &= ReadSet(file, std::string(group) + "Shafts", ShaftType(), 1, 1, shafts) &&
+                      shafts[0].id == 20 && shafts[0].x == 0.1 * frame;
+        }
+    }
+
+    return passed;
+}
+
+int main(int argc, char* argv[]) {
+    std::string series_file = "utest_VEH_output_series.h5";
+    std::string frames_file = "utest_VEH_output_frames.h5";
+
+    // Fill both databases at the same time
+    std::thread series_thread(WriteDatabase, ChVehicleOutputHDF5::Layout::TIME_SERIES, series_file);
+    WriteDatabase(ChVehicleOutputHDF5::Layout::FRAMES, frames_file);
+    series_thread.join();
+
+    bool passed = true;
+    try {
+        bool series = CheckSeries(series_file);
+        bool frames = CheckFrames(frames_file);
+        cout << "TIME_SERIES layout: " << (series ? "OK" : "FAILED") << endl;
+        cout << "FRAMES layout:      " << (frames ? "OK" : "FAILED") << endl;
+        passed = series && frames;
+    } catch (const H5::Exception& e) {
+        cout << "HDF5 error: " << e.getDetailMsg() << endl;
+        passed = false;
+    }
+
+    std::remove(series_file.c_str());
+    std::remove(frames_file.c_str());
+
+    cout << "Test " << (passed ? "PASSED" : "FAILED") << endl;
+
+    // Return 0 if all tests passed.
+    return !passed;
+}
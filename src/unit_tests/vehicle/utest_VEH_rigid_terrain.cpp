@@ -0,0 +1,385 @@
+// =============================================================================
+// PROJECT CHRONO - http://projectchrono.org
+//
+// Copyright (c) 2014 projectchrono.org
+// All rights reserved.
+//
+// Use of this source code is governed by a BSD-style license that can be found
+// in the LICENSE file at the top level of the distribution and at
+// http://projectchrono.org/license-chrono.txt.
+//
+// =============================================================================
+//
+// Test for the height-field query index of RigidTerrain.
+// The terrain consists of overlapping patches: a base box, a tiled box, a tilted
+// box, a rotated height map, a mesh and a sphere-swept copy of that mesh.
+// GetHeight, GetNormal and GetCoefficientFriction, evaluated with the index on a
+// grid of locations, are compared with an exact reference: the top of the patch
+// geometry inflated by the collision margin (boxes enlarged, mesh faces swept by
+// a sphere), found by sphere tracing along the vertical line. Only locations on
+// a crease of the terrain surface (an edge, or a seam between patches), where
+// the normal or the patch changes within a tiny distance, are skipped; all the
+// other locations must match. The batched GetProperties query must return the
+// same results as the individual queries.
+//
+// =============================================================================
+
+#include <algorithm>
+#include <cmath>
+#include <cstdio>
+#include <fstream>
+#include <iostream>
+#include <vector>
+
+#include "chrono/assets/ChTriangleMeshShape.h"
+#include "chrono/geometry/ChTriangle.h"
+#include "chrono/physics/ChSystemNSC.h"
+
+#include "chrono_vehicle/ChVehicleModelData.h"
+#include "chrono_vehicle/terrain/RigidTerrain.h"
+
+using namespace chrono;
+using namespace chrono::vehicle;
+
+using std::cout;
+using std::endl;
+
+const int grid_size = 80;
+
+// Tolerances on heights and normals
+const double height_tol = 1e-4;
+const double normal_tol = 1e-2;
+
+// Distance of the points used to detect creases of the terrain surface
+const double crease_dist = 1e-5;
+
+struct Result {
+    double height;
+    ChVector<> normal;
+    float friction;
+};
+
+// Write a bumpy square surface of side 8, centered at the origin, as a Wavefront OBJ file.
+void WriteMesh(const std::string& filename) {
+    const int n = 16;
+    std::ofstream obj(filename);
+    for (int iy = 0; iy <= n; iy++) {
+        for (int ix = 0; ix <= n; ix++) {
+            double x = -4 + 8.0 * ix / n;
+            double y = -4 + 8.0 * iy / n;
+            obj << "v " << x << " " << y << " " << 0.4 * std::sin(x) * std::cos(0.7 * y) << "\n";
+        }
+    }
+    for (int iy = 0; iy < n; iy++) {
+        for (int ix = 0; ix < n; ix++) {
+            int v0 = iy * (n + 1) + ix + 1;
+            obj << "f " << v0 << " " << v0 + 1 << " " << v0 + n + 2 << "\n";
+            obj << "f " << v0 << " " << v0 + n + 2 << " " << v0 + n + 1 << "\n";
+        }
+    }
+}
+
+// Exact reference geometry of a patch: a box enlarged by the margin, or the set of points within the margin of
+// the mesh faces.
+struct RefPatch {
+    bool box;
+    ChFrame<> frame;                 ///< box frame
+    ChVector<> hsize;                ///< box half-dimensions, including the margin
+    double margin;                   ///< mesh margin
+    std::vector<ChVector<>> faces;   ///< mesh face vertices, in absolute frame (3 per face)
+    std::vector<ChVector<>> bounds;  ///< mesh face bounding boxes, enlarged by the margin (min and max per face)
+    float friction;
+};
+
+RefPatch BoxPatch(std::shared_ptr<RigidTerrain::Patch> patch, const ChVector<>& size, float friction) {
+    auto body = patch->GetGroundBody();
+    RefPatch ref;
+    ref.box = true;
+    ref.frame = body->GetFrame_REF_to_abs();
+    ref.hsize = 0.5 * size + ChVector<>((double)body->GetCollisionModel()->GetEnvelope());
+    ref.margin = 0;
+    ref.friction = friction;
+    return ref;
+}
+
+RefPatch MeshPatch(std::shared_ptr<RigidTerrain::Patch> patch, double radius, float friction) {
+    auto body = patch->GetGroundBody();
+    RefPatch ref;
+    ref.box = false;
+    ref.frame = body->GetFrame_REF_to_abs();
+    ref.margin = body->GetCollisionModel()->GetEnvelope() + radius;
+    ref.friction = friction;
+    for (auto asset : body->GetAssets()) {
+        auto shape = std::dynamic_pointer_cast<ChTriangleMeshShape>(asset);
+        if (!shape)
+            continue;
+        auto& mesh = shape->GetMesh();
+        for (auto& face : mesh.getIndicesVertexes()) {
+            ChVector<> bmin(1e30, 1e30, 1e30);
+            ChVector<> bmax(-1e30, -1e30, -1e30);
+            for (int i = 0; i < 3; i++) {
+                ChVector<> v = ref.frame.TransformPointLocalToParent(mesh.getCoordsVertices()[face[i]]);
+                ref.faces.push_back(v);
+                for (int k = 0; k < 3; k++) {
+                    bmin[k] = std::min(bmin[k], v[k] - ref.margin);
+                    bmax[k] = std::max(bmax[k], v[k] + ref.margin);
+                }
+            }
+            ref.bounds.push_back(bmin);
+            ref.bounds.push_back(bmax);
+        }
+    }
+    return ref;
+}
+
+// Closest point to P on the triangle ABC.
+ChVector<> ClosestPoint(ChVector<> P, ChVector<> A, ChVector<> B, ChVector<> C) {
+    double mu, mv;
+    bool inside;
+    ChVector<> Q;
+    geometry::ChTriangle::PointTriangleDistance(P, A, B, C, mu, mv, inside, Q);
+    if (inside)
+        return Q;
+
+    ChVector<> closest = A;
+    for (const ChVector<>* V : {&B, &C}) {
+        if ((*V - P).Length2() < (closest - P).Length2())
+            closest = *V;
+    }
+    ChVector<>* edges[3][2] = {{&A, &B}, {&B, &C}, {&C, &A}};
+    for (auto& edge : edges) {
+        double t;
+        bool in_segment;
+        geometry::ChTriangle::PointLineDistance(P, *edge[0], *edge[1], t, in_segment);
+        ChVector<> E = *edge[0] + t * (*edge[1] - *edge[0]);
+        if (in_segment && (E - P).Length2() < (closest - P).Length2())
+            closest = E;
+    }
+    return closest;
+}
+
+// Signed distance from P to the patch surface, and outward surface normal at the closest point.
+double Distance(const RefPatch& ref, const std::vector<int>& faces, const ChVector<>& P, ChVector<>& normal) {
+    if (ref.box) {
+        ChVector<> loc = ref.frame.TransformPointParentToLocal(P);
+        ChVector<> q(std::abs(loc.x()) - ref.hsize.x(), std::abs(loc.y()) - ref.hsize.y(),
+                     std::abs(loc.z()) - ref.hsize.z());
+        int axis = (q.x() >= q.y() && q.x() >= q.z()) ? 0 : (q.y() >= q.z() ? 1 : 2);
+        ChVector<> nrm(0, 0, 0);
+        nrm[axis] = loc[axis] > 0 ? 1 : -1;
+        normal = ref.frame.TransformDirectionLocalToParent(nrm);
+        ChVector<> out(std::max(q.x(), 0.0), std::max(q.y(), 0.0), std::max(q.z(), 0.0));
+        return out.Length() + std::min(q[axis], 0.0);
+    }
+
+    double dist = 1e30;
+    for (int f : faces) {
+        ChVector<> Q = ClosestPoint(P, ref.faces[3 * f], ref.faces[3 * f + 1], ref.faces[3 * f + 2]);
+        double d = (P - Q).Length();
+        if (d < dist) {
+            dist = d;
+            normal = (P - Q) / d;
+        }
+    }
+    return dist - ref.margin;
+}
+
+// Find the top of the patch along the vertical line through (x,y), by sphere tracing from above.
+// Return 1 if found, 0 if the line misses the patch, and -1 if the tracing does not converge (the line grazes
+// the patch surface).
+int TopPoint(const RefPatch& ref, double x, double y, double& height, ChVector<>& normal) {
+    double ztop = 1000;
+    double zbot = -1000;
+    std::vector<int> faces;
+    if (!ref.box) {
+        ztop = -1e30;
+        zbot = 1e30;
+        for (int f = 0; f < (int)ref.bounds.size() / 2; f++) {
+            const ChVector<>& bmin = ref.bounds[2 * f];
+            const ChVector<>& bmax = ref.bounds[2 * f + 1];
+            if (x < bmin.x() || x > bmax.x() || y < bmin.y() || y > bmax.y())
+                continue;
+            faces.push_back(f);
+            ztop = std::max(ztop, bmax.z() + 1);
+            zbot = std::min(zbot, bmin.z() - 1);
+        }
+        if (faces.empty())
+            return 0;
+    }
+
+    double z = ztop;
+    for (int it = 0; it < 100000; it++) {
+        double d = Distance(ref, faces, ChVector<>(x, y, z), normal);
+        if (d < 1e-10) {
+            height = z;
+            return 1;
+        }
+        z -= d;
+        if (z < zbot)
+            return 0;
+    }
+    return -1;
+}
+
+// Exact terrain height, normal and friction at (x,y): top of the highest patch (the first one, for equal heights).
+// Return false if not resolved.
+bool Reference(const std::vector<RefPatch>& patches, double x, double y, Result& result) {
+    result.height = -1000;
+    result.normal = ChVector<>(0, 0, 1);
+    result.friction = 0.8f;
+    for (auto& ref : patches) {
+        double height;
+        ChVector<> normal;
+        int found = TopPoint(ref, x, y, height, normal);
+        if (found < 0)
+            return false;
+        if (found && height > result.height) {
+            result.height = height;
+            result.normal = normal;
+            result.friction = ref.friction;
+        }
+    }
+    return true;
+}
+
+bool Differ(const Result& a, const Result& b) {
+    return std::abs(a.height - b.height) > height_tol || (a.normal - b.normal).Length() > normal_tol ||
+           a.friction != b.friction;
+}
+
+// Check if (x,y) is on a crease of the terrain surface: the reference differs at nearby locations.
+bool OnCrease(const std::vector<RefPatch>& patches, double x, double y, const Result& result) {
+    for (int i = 0; i < 4; i++) {
+        Result other;
+        double dx = (i == 0) ? crease_dist : ((i == 1) ? -crease_dist : 0);
+        double dy = (i == 2) ? crease_dist : ((i == 3) ? -crease_dist : 0);
+        if (!Reference(patches, x + dx, y + dy, other) || Differ(result, other))
+            return true;
+    }
+    return false;
+}
+
+void Print(const char* label, const Result& result) {
+    cout << "   " << label << "  height: " << result.height << "  normal: (" << result.normal.x() << ", "
+         << result.normal.y() << ", " << result.normal.z() << ")  friction: " << result.friction << endl;
+}
+
+std::vector<Result> Query(const RigidTerrain& terrain, const std::vector<ChVector2<>>& loc) {
+    std::vector<Result> results(loc.size());
+    for (size_t i = 0; i < loc.size(); i++) {
+        results[i].height = terrain.GetHeight(loc[i].x(), loc[i].y());
+        results[i].normal = terrain.GetNormal(loc[i].x(), loc[i].y());
+        results[i].friction = terrain.GetCoefficientFriction(loc[i].x(), loc[i].y());
+    }
+    return results;
+}
+
+int main(int argc, char* argv[]) {
+    ChSystemNSC system;
+    RigidTerrain terrain(&system);
+
+    auto base = terrain.AddPatch(ChCoordsys<>(ChVector<>(0, 0, -0.5), QUNIT), ChVector<>(24, 24, 1));
+    base->SetContactFrictionCoefficient(0.9f);
+
+    auto tiled = terrain.AddPatch(ChCoordsys<>(ChVector<>(6, -5, 0), Q_from_AngZ(0.2)), ChVector<>(6, 4, 0.6), true,
+                                  1.5);
+    tiled->SetContactFrictionCoefficient(0.8f);
+
+    auto tilted = terrain.AddPatch(ChCoordsys<>(ChVector<>(-5, 5, 0), Q_from_AngX(0.15) * Q_from_AngZ(0.5)),
+                                   ChVector<>(6, 6, 1));
+    tilted->SetContactFrictionCoefficient(0.7f);
+
+    auto hmap = terrain.AddPatch(ChCoordsys<>(ChVector<>(1, 1, -0.6), Q_from_AngZ(0.5)),
+                                 GetDataFile("terrain/height_maps/test64.bmp"), "hmap", 12, 12, 0, 1.5);
+    hmap->SetContactFrictionCoefficient(0.6f);
+
+    std::string mesh_file = "utest_VEH_rigid_terrain.obj";
+    WriteMesh(mesh_file);
+
+    auto mesh = terrain.AddPatch(ChCoordsys<>(ChVector<>(5, 4, 0.1), Q_from_AngZ(-0.3)), mesh_file, "mesh");
+    mesh->SetContactFrictionCoefficient(0.5f);
+
+    auto swept = terrain.AddPatch(ChCoordsys<>(ChVector<>(-3, -5, 0), QUNIT), mesh_file, "swept", 0.05);
+    swept->SetContactFrictionCoefficient(0.4f);
+
+    // Update the collision models
+    system.DoStepDynamics(1e-3);
+
+    // Exact reference geometry of the patches
+    std::vector<RefPatch> ref_patches;
+    ref_patches.push_back(BoxPatch(base, ChVector<>(24, 24, 1), 0.9f));
+    ref_patches.push_back(BoxPatch(tiled, ChVector<>(6, 4, 0.6), 0.8f));
+    ref_patches.push_back(BoxPatch(tilted, ChVector<>(6, 6, 1), 0.7f));
+    ref_patches.push_back(MeshPatch(hmap, 0, 0.6f));
+    ref_patches.push_back(MeshPatch(mesh, 0, 0.5f));
+    ref_patches.push_back(MeshPatch(swept, 0.05, 0.4f));
+
+    // Query locations (offset so that they do not fall on mesh edges or patch boundaries)
+    std::vector<ChVector2<>> loc;
+    for (int ix = 0; ix < grid_size; ix++) {
+        for (int iy = 0; iy < grid_size; iy++) {
+            double x = -11 + 22 * (ix + 0.3711) / grid_size;
+            double y = -11 + 22 * (iy + 0.6183) / grid_size;
+            loc.push_back(ChVector2<>(x, y));
+        }
+    }
+
+    // Height-field query index
+    terrain.Initialize();
+    std::vector<Result> results = Query(terrain, loc);
+
+    bool passed = true;
+    int num_mismatch = 0;
+    int num_crease = 0;
+    std::vector<Result> expected(loc.size());
+    for (size_t i = 0; i < loc.size(); i++) {
+        bool resolved = Reference(ref_patches, loc[i].x(), loc[i].y(), expected[i]);
+        if (!resolved || OnCrease(ref_patches, loc[i].x(), loc[i].y(), expected[i])) {
+            num_crease++;
+            continue;
+        }
+        if (Differ(results[i], expected[i])) {
+            if (num_mismatch++ < 5) {
+                cout << "mismatch at (" << loc[i].x() << ", " << loc[i].y() << ")" << endl;
+                Print("expected", expected[i]);
+                Print("indexed", results[i]);
+            }
+        }
+    }
+    cout << "mismatches: " << num_mismatch << " / " << loc.size() - num_crease << "  (" << num_crease
+         << " locations on creases)" << endl;
+    if (num_mismatch > 0 || num_crease > loc.size() / 100) {
+        passed = false;
+    }
+
+    // Every patch is the top surface at some location
+    for (float friction : {0.9f, 0.8f, 0.7f, 0.6f, 0.5f, 0.4f}) {
+        bool found = false;
+        for (auto& result : expected)
+            found |= result.friction == friction;
+        if (!found) {
+            cout << "no query location on patch with friction " << friction << endl;
+            passed = false;
+        }
+    }
+
+    // Batched query
+    std::vector<double> height;
+    std::vector<ChVector<>> normal;
+    std::vector<float> friction;
+    terrain.GetProperties(loc, height, normal, friction);
+    for (size_t i = 0; i < loc.size(); i++) {
+        if (height[i] != results[i].height || normal[i] != results[i].normal || friction[i] != results[i].friction) {
+            cout << "GetProperties differs at (" << loc[i].x() << ", " << loc[i].y() << ")" << endl;
+            passed = false;
+            break;
+        }
+    }
+
+    std::remove(mesh_file.c_str());
+
+    cout << "Test " << (passed ? "PASSED" : "FAILED") << endl;
+
+    // Return 0 if all tests passed.
+    return !passed;
+}